@@ -170,20 +170,40 @@ endif()
 #triSYCL options
 option(TRISYCL_OPENMP "triSYCL multi-threading with OpenMP" ON)
 option(TRISYCL_TBB "triSYCL multi-threading with TBB" OFF)
+option(TRISYCL_WORK_STEALING "triSYCL multi-threading with work stealing on the task fibers" OFF)
 option(TRISYCL_OPENCL "triSYCL OpenCL interoperability mode" OFF)
+option(TRISYCL_OMP_TARGET "triSYCL offload of the parallel_for to an OpenMP device" OFF)
+set(TRISYCL_OMP_TARGET_FLAGS "" CACHE STRING
+  "The options to compile for the OpenMP devices, such as -fopenmp-targets=nvptx64")
+option(TRISYCL_MPI "triSYCL distributed buffers over MPI" OFF)
+option(TRISYCL_BLAS "triSYCL dense linear algebra with the BLAS of the host" OFF)
 option(TRISYCL_NO_ASYNC "triSYCL use synchronous kernel execution" OFF)
+option(TRISYCL_FIBER_TASKS "triSYCL run the tasks as Boost.Fiber" OFF)
+option(TRISYCL_WORK_ITEM_FIBERS "triSYCL run the work-items as fibers" OFF)
 option(TRISYCL_DEBUG "triSYCL use debug mode" OFF)
 option(TRISYCL_DEBUG_STRUCTORS "triSYCL trace of object lifetimes" OFF)
+option(TRISYCL_EVENT_LOG "triSYCL binary log of the debug events" OFF)
 option(TRISYCL_TRACE_KERNEL "triSYCL trace of kernel execution" OFF)
+option(TRISYCL_TIMELINE "triSYCL timeline of the execution in Chrome trace format" OFF)
+option(TRISYCL_PRECOMPILED_HEADERS "triSYCL precompile the third-party headers" OFF)
 option(TRISYCL_INCLUDE_DIR  "triSYCL include directory" OFF)
 
 mark_as_advanced(TRISYCL_OPENMP)
 mark_as_advanced(TRISYCL_TBB)
+mark_as_advanced(TRISYCL_WORK_STEALING)
 mark_as_advanced(TRISYCL_OPENCL)
+mark_as_advanced(TRISYCL_OMP_TARGET)
+mark_as_advanced(TRISYCL_MPI)
+mark_as_advanced(TRISYCL_BLAS)
 mark_as_advanced(TRISYCL_NO_ASYNC)
+mark_as_advanced(TRISYCL_FIBER_TASKS)
+mark_as_advanced(TRISYCL_WORK_ITEM_FIBERS)
 mark_as_advanced(TRISYCL_DEBUG)
 mark_as_advanced(TRISYCL_DEBUG_STRUCTORS)
+mark_as_advanced(TRISYCL_EVENT_LOG)
 mark_as_advanced(TRISYCL_TRACE_KERNEL)
+mark_as_advanced(TRISYCL_TIMELINE)
+mark_as_advanced(TRISYCL_PRECOMPILED_HEADERS)
 mark_as_advanced(TRISYCL_INCLUDE_DIR)
 
 #triSYCL definitions
@@ -223,11 +243,31 @@ if(TRISYCL_OPENMP)
   find_package(OpenMP REQUIRED)
 endif()
 
+# The offload uses the OpenMP of the host compiler
+if(TRISYCL_OMP_TARGET AND NOT TRISYCL_OPENMP)
+  message(FATAL_ERROR "TRISYCL_OMP_TARGET requires TRISYCL_OPENMP")
+endif()
+
+# Find MPI package for the distributed buffers
+if(TRISYCL_MPI)
+  find_package(MPI REQUIRED COMPONENTS CXX)
+endif()
+
+# Find a BLAS with its CBLAS interface for the linear algebra
+if(TRISYCL_BLAS)
+  find_package(BLAS REQUIRED)
+endif()
+
 # Find TBB package
 if(TRISYCL_TBB)
   find_package(TBB REQUIRED)
 endif()
 
+# The work stealing steals the fibers running the tasks
+if(TRISYCL_WORK_STEALING)
+  set(TRISYCL_FIBER_TASKS ON)
+endif()
+
 # Find specifically the non pure header Boost library packages
 set(BOOST_REQUIRED_COMPONENTS context fiber log thread)
 
@@ -246,11 +286,20 @@ endif()
 
 message(STATUS "triSYCL OpenMP:                   ${TRISYCL_OPENMP}")
 message(STATUS "triSYCL TBB:                      ${TRISYCL_TBB}")
+message(STATUS "triSYCL work stealing:            ${TRISYCL_WORK_STEALING}")
 message(STATUS "triSYCL OpenCL:                   ${TRISYCL_OPENCL}")
+message(STATUS "triSYCL OpenMP offload:           ${TRISYCL_OMP_TARGET}")
+message(STATUS "triSYCL MPI:                      ${TRISYCL_MPI}")
+message(STATUS "triSYCL BLAS:                     ${TRISYCL_BLAS}")
 message(STATUS "triSYCL synchronous execution:    ${TRISYCL_NO_ASYNC}")
+message(STATUS "triSYCL tasks as fibers:          ${TRISYCL_FIBER_TASKS}")
+message(STATUS "triSYCL work-items as fibers:     ${TRISYCL_WORK_ITEM_FIBERS}")
 message(STATUS "triSYCL debug mode:               ${TRISYCL_DEBUG}")
 message(STATUS "triSYCL object trace:             ${TRISYCL_DEBUG_STRUCTORS}")
+message(STATUS "triSYCL binary event log:         ${TRISYCL_EVENT_LOG}")
 message(STATUS "triSYCL kernel trace:             ${TRISYCL_TRACE_KERNEL}")
+message(STATUS "triSYCL execution timeline:       ${TRISYCL_TIMELINE}")
+message(STATUS "triSYCL precompiled headers:      ${TRISYCL_PRECOMPILED_HEADERS}")
 
 find_package(Threads REQUIRED)
 
@@ -320,17 +369,26 @@ function(add_sycl_to_target targetName)
     std::mdspan
     #Required by BOOST_COMPUTE_USE_OFFLINE_CACHE:
     $<$<BOOL:${TRISYCL_OPENCL}>:Boost::filesystem>
+    $<$<BOOL:${TRISYCL_MPI}>:MPI::MPI_CXX>
+    $<$<BOOL:${TRISYCL_BLAS}>:BLAS::BLAS>
     range-v3::range-v3
   )
 
   # Compile definitions
   target_compile_definitions(${targetName} PUBLIC
     $<$<BOOL:${TRISYCL_NO_ASYNC}>:TRISYCL_NO_ASYNC>
+    $<$<BOOL:${TRISYCL_FIBER_TASKS}>:TRISYCL_FIBER_TASKS>
+    $<$<BOOL:${TRISYCL_WORK_STEALING}>:TRISYCL_WORK_STEALING>
+    $<$<BOOL:${TRISYCL_WORK_ITEM_FIBERS}>:TRISYCL_WORK_ITEM_FIBERS>
     $<$<BOOL:${TRISYCL_OPENCL}>:TRISYCL_OPENCL>
+    $<$<BOOL:${TRISYCL_OMP_TARGET}>:TRISYCL_OMP_TARGET>
+    $<$<BOOL:${TRISYCL_BLAS}>:TRISYCL_BLAS>
     $<$<BOOL:${TRISYCL_OPENCL}>:BOOST_COMPUTE_USE_OFFLINE_CACHE>
     $<$<BOOL:${TRISYCL_DEBUG}>:TRISYCL_DEBUG>
     $<$<BOOL:${TRISYCL_DEBUG_STRUCTORS}>:TRISYCL_DEBUG_STRUCTORS>
+    $<$<BOOL:${TRISYCL_EVENT_LOG}>:TRISYCL_EVENT_LOG>
     $<$<BOOL:${TRISYCL_TRACE_KERNEL}>:TRISYCL_TRACE_KERNEL>
+    $<$<BOOL:${TRISYCL_TIMELINE}>:TRISYCL_TIMELINE>
     $<$<BOOL:${LOG_NEEDED}>:BOOST_LOG_DYN_LINK>)
 
   # C++ and OpenMP requirements
@@ -344,6 +402,14 @@ function(add_sycl_to_target targetName)
       LINK_FLAGS ${OpenMP_CXX_FLAGS})
   endif(${TRISYCL_OPENMP})
 
+  # The device code is compiled and linked with the host code
+  if(${TRISYCL_OMP_TARGET})
+    separate_arguments(omp_target_flags UNIX_COMMAND
+      "${TRISYCL_OMP_TARGET_FLAGS}")
+    target_compile_options(${targetName} PUBLIC ${omp_target_flags})
+    target_link_options(${targetName} PUBLIC ${omp_target_flags})
+  endif(${TRISYCL_OMP_TARGET})
+
   # C++ and TBB requirements
   if(${TRISYCL_TBB})
     target_compile_definitions(${targetName} PUBLIC -DTRISYCL_TBB)
@@ -352,4 +418,10 @@ function(add_sycl_to_target targetName)
     target_link_libraries(${targetName} PUBLIC ${TBB_LIBRARIES})
   endif(${TRISYCL_TBB})
 
+  # Parse the heavy third-party headers only once per target
+  if(${TRISYCL_PRECOMPILED_HEADERS})
+    target_precompile_headers(${targetName} PRIVATE
+      ${TRISYCL_INCLUDE_DIR}/triSYCL/detail/precompiled_dependencies.hpp)
+  endif(${TRISYCL_PRECOMPILED_HEADERS})
+
 endfunction(add_sycl_to_target)
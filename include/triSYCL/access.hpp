@@ -53,7 +53,8 @@ namespace access {
     host_image,
     image_array,
     pipe,
-    blocking_pipe
+    blocking_pipe,
+    host_task ///< Host memory used by a handler::host_task
   };
 
 
@@ -10,12 +10,16 @@
 */
 
 #include <cstddef>
+#include <memory>
 #include <type_traits>
 
 #include "triSYCL/access.hpp"
+#include "triSYCL/accessor/detail/accessor_view.hpp"
+#include "triSYCL/atomic_ref.hpp"
 #include "triSYCL/accessor/detail/local_accessor.hpp"
 #include "triSYCL/buffer/detail/accessor.hpp"
 #include "triSYCL/detail/container_element_aspect.hpp"
+#include "triSYCL/detail/prefetch.hpp"
 #include "triSYCL/detail/shared_ptr_implementation.hpp"
 #include "triSYCL/id.hpp"
 #include "triSYCL/item.hpp"
@@ -75,7 +79,33 @@ class accessor
   // Allows the comparison operation to access the implementation
   friend implementation_t;
 
+  /** Give an element to the user, through an atomic reference in the
+      atomic mode
+
+      The proxies of a partial [i1][i2] indexing are returned by value
+      since they are temporaries.
+  */
+  static decltype(auto) element(auto &&e) {
+    using type = decltype(e);
+    if constexpr (!std::is_lvalue_reference_v<type>)
+      return std::remove_cvref_t<type> { std::move(e) };
+    else if constexpr (AccessMode == access::mode::atomic
+                       && std::is_same_v<std::remove_cvref_t<type>,
+                                         std::remove_cv_t<DataType>>)
+      return atomic_reference { e };
+    else
+      return static_cast<type>(e);
+  }
+
  public:
+  /** The atomic reference to the elements given by an atomic accessor,
+      with the relaxed ordering of the SYCL 1.2.1 atomics by default
+  */
+  using atomic_reference = atomic_ref<std::remove_cv_t<DataType>,
+                                      memory_order::relaxed,
+                                      memory_scope::device,
+                                      access::address_space::global_space>;
+
   /// Introspect the \c access_mode
   auto static constexpr access_mode() { return AccessMode; }
 
@@ -85,6 +115,15 @@ class accessor
   // Make the implementation member directly accessible in this class
   using implementation_t::implementation;
 
+  /** The iterators are plain pointers, so they are contiguous
+      iterators allowing the vectorization of the algorithms
+  */
+  using iterator = typename accessor_detail::iterator;
+  using const_iterator = typename accessor_detail::const_iterator;
+  using reverse_iterator = typename accessor_detail::reverse_iterator;
+  using const_reverse_iterator =
+    typename accessor_detail::const_reverse_iterator;
+
   /** Construct a buffer accessor from a buffer using a command group
       handler object from the command group scope
 
@@ -107,9 +146,10 @@ class accessor
       target_buffer.implementation->implementation, command_group_handler }
   } {
     static_assert(Target == access::target::global_buffer
-                  || Target == access::target::constant_buffer,
-                  "access target should be global_buffer or constant_buffer "
-                  "when a handler is used");
+                  || Target == access::target::constant_buffer
+                  || Target == access::target::host_task,
+                  "access target should be global_buffer, constant_buffer "
+                  "or host_task when a handler is used");
     // Now the implementation is created, register it
     implementation->register_accessor();
   }
@@ -148,13 +188,47 @@ class accessor
       This accessor is recommended for discard-write and discard read
       write access modes, when the unaffected parts of the processing
       should be retained.
+
+      The elements are still indexed from the start of the buffer. Only
+      the elements of the access range are considered as written, so
+      they are the only ones written back or transferred to the host.
   */
   template <typename Allocator>
   accessor(buffer<DataType, Dimensions, Allocator> &target_buffer,
            handler &command_group_handler,
-           const range<Dimensions> &offset,
-           const range<Dimensions> &range) {
-    TRISYCL_UNIMPL;
+           const range<Dimensions> &access_range,
+           const id<Dimensions> &access_offset = {}) : implementation_t {
+    new detail::accessor<DataType, Dimensions, AccessMode, Target> {
+      target_buffer.implementation->implementation, command_group_handler,
+      target_buffer.implementation->implementation
+        ->linear_window(access_offset, access_range) }
+  } {
+    static_assert(Target == access::target::global_buffer
+                  || Target == access::target::constant_buffer
+                  || Target == access::target::host_task,
+                  "access target should be global_buffer, constant_buffer "
+                  "or host_task when a handler is used");
+    implementation->register_accessor();
+  }
+
+
+  /** Construct a host accessor from a buffer given a specific range for
+      access permissions and an offset that provides the starting point
+      for the access range
+
+      The elements are still indexed from the start of the buffer.
+  */
+  template <typename Allocator>
+  accessor(buffer<DataType, Dimensions, Allocator> &target_buffer,
+           const range<Dimensions> &access_range,
+           const id<Dimensions> &access_offset = {}) : implementation_t {
+    new detail::accessor<DataType, Dimensions, AccessMode, Target> {
+      target_buffer.implementation->implementation,
+      target_buffer.implementation->implementation
+        ->linear_window(access_offset, access_range) }
+  } {
+    static_assert(Target == access::target::host_buffer,
+                  "without a handler, access target should be host_buffer");
   }
 
 
@@ -227,13 +301,27 @@ class accessor
     return implementation->get_size();
   }
 
+
+  /** Get the number of elements from a row, along the last dimension,
+      to the next one in the storage
+
+      It is larger than the row length for a buffer created with the
+      property::buffer::row_pitch property. The pointer and the
+      iterators of the accessor then see the padding of the rows too.
+
+      This is a triSYCL extension.
+  */
+  std::size_t get_row_pitch() const {
+    return implementation->get_row_pitch();
+  }
+
   /** Use the accessor with integers à la [i1][i2][i3] or C++23 [i1, i2,...]
 
       \return decltype(auto) to return either a reference to the final
       element when the indexing has been fully resolved or a proxy
       object to handle the remaining [] */
   template <std::integral... T> decltype(auto) operator[](T... indices) {
-    return (*implementation)[indices...];
+    return element((*implementation)[indices...]);
   }
 
   /** Use the accessor with integers à la [i1][i2][i3] or C++23 [i1, i2,...]
@@ -242,28 +330,28 @@ class accessor
       element when the indexing has been fully resolved or a proxy
       object to handle the remaining [] */
   template <std::integral... T> decltype(auto) operator[](T... indices) const {
-    return (*implementation)[indices...];
+    return element((*implementation)[indices...]);
   }
 
   /// To use the accessor with [id<>]
-  auto& operator[](const id<dimensionality>& index) {
-    return (*implementation)[index];
+  decltype(auto) operator[](const id<dimensionality>& index) {
+    return element((*implementation)[index]);
   }
 
   /// To use the accessor with [id<>]
-  auto& operator[](const id<dimensionality>& index) const {
-    return (*implementation)[index];
+  decltype(auto) operator[](const id<dimensionality>& index) const {
+    return element((*implementation)[index]);
   }
 
 
   /// To use an accessor with [item<>]
-  auto& operator[](const item<dimensionality>& index) {
+  decltype(auto) operator[](const item<dimensionality>& index) {
     return (*this)[index.get_id()];
   }
 
 
   /// To use an accessor with [item<>]
-  auto& operator[](const item<dimensionality>& index) const {
+  decltype(auto) operator[](const item<dimensionality>& index) const {
     return (*this)[index.get_id()];
   }
 
@@ -272,7 +360,7 @@ class accessor
 
       \todo Add in the specification because used by HPC-GPU slide 22
   */
-  auto& operator[](const nd_item<dimensionality>& index) {
+  decltype(auto) operator[](const nd_item<dimensionality>& index) {
     return (*this)[index.get_global_id()];
   }
 
@@ -280,7 +368,7 @@ class accessor
 
       \todo Add in the specification because used by HPC-GPU slide 22
   */
-  auto& operator[](const nd_item<dimensionality>& index) const {
+  decltype(auto) operator[](const nd_item<dimensionality>& index) const {
     return (*this)[index.get_global_id()];
   }
 
@@ -319,6 +407,70 @@ class accessor
     return implementation->get_pointer();
   }
 
+
+  /** Get the pointer to the start of the data, as for a contiguous
+      range
+
+      With begin() and end() being pointers too, the accessor is a
+      \c std::ranges::contiguous_range usable with \c std::span and
+      with the algorithms which vectorize on contiguous memory.
+  */
+  auto data() const {
+    return get_pointer();
+  }
+
+
+  /** Hint that the \p count elements from the element \p index, in
+      row-major order, are going to be read soon
+
+      It is a prefetch into the cache, not a copy, so it does not
+      change the semantics of the kernel.
+  */
+  void prefetch(const id<dimensionality> &index, std::size_t count = 1) const {
+    detail::prefetch<Target != access::target::local>(
+      std::addressof((*implementation)[index]), count);
+  }
+
+
+  /** Get the number of elements between begin() and end(), as for a
+      sized range
+
+      It includes the padding of the rows of a buffer created with
+      the property::buffer::row_pitch property, so it is larger than
+      get_count() in this case.
+  */
+  std::size_t size() const {
+    return end() - begin();
+  }
+
+
+  /// Test whether there is no element, as for a range
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /** The type of the lightweight view of the elements, read-only for
+      a read accessor
+  */
+  using view_type = detail::accessor_view<
+    std::conditional_t<AccessMode == access::mode::read,
+                       const DataType, DataType>,
+    Dimensions>;
+
+
+  /** Get a lightweight view of the elements to capture in a kernel
+      instead of the accessor itself
+
+      It is just a pointer and the extents of the storage, so it is
+      cheap to copy in each worker and its indexing reduces to an
+      address computation.
+
+      This is a triSYCL extension for the kernels running on the host.
+  */
+  view_type get_view() const {
+    return { get_pointer(), get_range(), get_row_pitch() };
+  }
+
   /** Forward all the iterator functions to the implementation
 
       \todo Add these functions to the specification
@@ -0,0 +1,194 @@
+#ifndef TRISYCL_SYCL_ACCESSOR_DETAIL_ACCESSOR_VIEW_HPP
+#define TRISYCL_SYCL_ACCESSOR_DETAIL_ACCESSOR_VIEW_HPP
+
+/** \file A lightweight view of the elements of an accessor for the
+    kernels
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "triSYCL/id.hpp"
+#include "triSYCL/item.hpp"
+#include "triSYCL/nd_item.hpp"
+#include "triSYCL/range.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** A view of the elements of an accessor made only of the address of
+    the first element, of the extents of the row-major storage and of
+    the pitch of its rows
+
+    It is trivially copyable, so it is copied into each worker thread
+    without touching any reference counter, and indexing it is just an
+    address computation the compiler can vectorize:
+    \code
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for(r, [v = a.get_view()] (id<2> i) {
+            v[i] += v[i[0]][0];
+          });
+      });
+    \endcode
+
+    This is a triSYCL extension for the kernels running on the host.
+*/
+template <typename T, int Dimensions>
+class accessor_view {
+
+  /// The first element
+  T *p = nullptr;
+
+  /// The number of elements in each dimension
+  std::array<std::size_t, Dimensions> extents {};
+
+  /// The number of elements from a row to the next one
+  std::size_t pitch = 0;
+
+  /// Compute the linear position of an element in the row-major storage
+  std::size_t linear(const auto &indices) const {
+    std::size_t l = indices[0];
+    for (int d = 1; d < Dimensions - 1; ++d)
+      l = l*extents[d] + indices[d];
+    if constexpr (Dimensions > 1)
+      l = l*pitch + indices[Dimensions - 1];
+    return l;
+  }
+
+public:
+
+  using value_type = std::remove_cv_t<T>;
+  using reference = T&;
+  using pointer = T*;
+
+  accessor_view() = default;
+
+
+  /** Create a view of the elements from \p p with range \p r, with
+      rows \p pitch elements apart or contiguous if \p pitch is 0
+  */
+  accessor_view(T *p, const range<Dimensions> &r, std::size_t pitch = 0)
+    : p { p }
+    , pitch { pitch ? pitch : r[Dimensions - 1] } {
+    for (int d = 0; d < Dimensions; ++d)
+      extents[d] = r[d];
+  }
+
+
+  /// Create a view of the elements from \p p with some extents
+  accessor_view(T *p, const std::array<std::size_t, Dimensions> &extents,
+                std::size_t pitch = 0)
+    : p { p }
+    , extents { extents }
+    , pitch { pitch ? pitch : extents[Dimensions - 1] } {}
+
+
+  /** Access to an element of a 1D view or to a sub-view of lower
+      dimension, so that v[i][j] indexes a 2D view
+  */
+  decltype(auto) operator[](std::size_t index) const {
+    if constexpr (Dimensions == 1)
+      return p[index];
+    else {
+      std::array<std::size_t, Dimensions - 1> tail;
+      auto stride = pitch;
+      for (int d = 1; d < Dimensions; ++d) {
+        tail[d - 1] = extents[d];
+        if (d < Dimensions - 1)
+          stride *= extents[d];
+      }
+      return accessor_view<T, Dimensions - 1> { p + index*stride, tail,
+                                                pitch };
+    }
+  }
+
+
+  /// Access to an element with the C++23 [i1, i2,...] syntax
+  template <std::integral... Index>
+  requires (sizeof...(Index) == Dimensions && Dimensions > 1)
+  T& operator[](Index... indices) const {
+    return p[linear(std::array<std::size_t, Dimensions> {
+          static_cast<std::size_t>(indices)... })];
+  }
+
+
+  /// Access to an element with an id<>
+  T& operator[](const id<Dimensions> &index) const {
+    return p[linear(index)];
+  }
+
+
+  /// Access to an element with an item<>
+  T& operator[](const item<Dimensions> &index) const {
+    return (*this)[index.get_id()];
+  }
+
+
+  /// Access to an element with the global id of an nd_item<>
+  T& operator[](const nd_item<Dimensions> &index) const {
+    return (*this)[index.get_global_id()];
+  }
+
+
+  /// Get the first element
+  T* get_pointer() const { return p; }
+
+
+  /// Get the number of elements in each dimension
+  range<Dimensions> get_range() const {
+    range<Dimensions> r;
+    for (int d = 0; d < Dimensions; ++d)
+      r[d] = extents[d];
+    return r;
+  }
+
+
+  /// Get the total number of elements
+  std::size_t get_count() const {
+    std::size_t c = 1;
+    for (auto e : extents)
+      c *= e;
+    return c;
+  }
+
+
+  /// Get the number of elements from a row to the next one
+  std::size_t get_row_pitch() const { return pitch; }
+
+
+  /** Iterate on all the elements in the storage order, including the
+      padding between the rows if any
+  */
+  T* begin() const { return p; }
+
+
+  T* end() const {
+    if (get_count() == 0)
+      return p;
+    return p + get_count()/extents[Dimensions - 1]*pitch;
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_ACCESSOR_DETAIL_ACCESSOR_VIEW_HPP
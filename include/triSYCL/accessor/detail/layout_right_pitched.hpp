@@ -0,0 +1,166 @@
+#ifndef TRISYCL_SYCL_ACCESSOR_DETAIL_LAYOUT_RIGHT_PITCHED_HPP
+#define TRISYCL_SYCL_ACCESSOR_DETAIL_LAYOUT_RIGHT_PITCHED_HPP
+
+/** \file A row-major mdspan layout whose rows may be padded
+
+    The elements of a row, along the last dimension, are contiguous
+    but 2 consecutive rows are a row pitch apart, which may be larger
+    than the row length. Without padding this is just
+    std::experimental::layout_right, and indexing costs the same since
+    the pitch only replaces the last extent in the address computation.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/// A row-major layout policy for mdspan with a row pitch
+struct layout_right_pitched {
+
+  /// The mapping from the indices to the position in the storage
+  template <typename Extents>
+  class mapping {
+
+  public:
+
+    using extents_type = Extents;
+    using index_type = typename Extents::index_type;
+    using size_type = typename Extents::size_type;
+    using rank_type = typename Extents::rank_type;
+    using layout_type = layout_right_pitched;
+
+  private:
+
+    static_assert(Extents::rank() > 0, "A pitch needs some rows");
+
+    /// The dimension of the rows
+    static constexpr rank_type last = Extents::rank() - 1;
+
+    extents_type ext;
+
+    /// The number of elements from a row to the next one
+    index_type pitch = 0;
+
+  public:
+
+    mapping() = default;
+
+
+    /// Create a mapping without padding
+    constexpr mapping(const extents_type &e)
+      : ext { e }
+      , pitch { e.extent(last) } {}
+
+
+    /// Create a mapping with rows \p pitch elements apart
+    constexpr mapping(const extents_type &e, index_type pitch)
+      : ext { e }
+      , pitch { pitch } {}
+
+
+    constexpr const extents_type &extents() const { return ext; }
+
+
+    /// Get the number of elements from a row to the next one
+    constexpr index_type row_pitch() const { return pitch; }
+
+
+    /// Get the number of rows, across all the dimensions but the last one
+    constexpr index_type rows() const {
+      index_type r = 1;
+      for (rank_type d = 0; d != last; ++d)
+        r *= ext.extent(d);
+      return r;
+    }
+
+
+    constexpr index_type required_span_size() const {
+      auto r = rows();
+      if (r == 0 || ext.extent(last) == 0)
+        return 0;
+      return (r - 1)*pitch + ext.extent(last);
+    }
+
+
+    /// Get the position of the element at some indices
+    template <typename... Indices>
+    constexpr index_type operator()(Indices... indices) const {
+      const index_type i[] = { static_cast<index_type>(indices)... };
+      index_type row = 0;
+      for (rank_type d = 0; d != last; ++d)
+        row = row*ext.extent(d) + i[d];
+      return row*pitch + i[last];
+    }
+
+
+    static constexpr bool is_always_unique() { return true; }
+    static constexpr bool is_always_exhaustive() { return false; }
+    static constexpr bool is_always_strided() { return true; }
+    static constexpr bool is_unique() { return true; }
+    static constexpr bool is_strided() { return true; }
+
+
+    /// The storage has no hole when the rows are not padded
+    constexpr bool is_exhaustive() const {
+      return pitch == ext.extent(last);
+    }
+
+
+    constexpr index_type stride(rank_type r) const {
+      if (r == last)
+        return 1;
+      index_type s = pitch;
+      for (auto d = last - 1; d != r; --d)
+        s *= ext.extent(d);
+      return s;
+    }
+
+
+    friend constexpr bool operator==(const mapping &a, const mapping &b) {
+      return a.ext == b.ext && a.pitch == b.pitch;
+    }
+
+  };
+
+};
+
+
+/** Get a row pitch in elements for some rows of \p row elements of
+    \p element_size bytes, so that the columns do not alias in the
+    caches
+
+    When the rows span a multiple of 8 cache lines, walking down a
+    column visits at most 1/8 of the sets of a cache, and with a
+    multiple of 4 KiB the loads of a column also falsely depend on the
+    stores in flight to the previous rows. Adding a cache line to such
+    rows makes the consecutive rows start on different sets.
+*/
+inline std::size_t padded_row_pitch(std::size_t row,
+                                    std::size_t element_size) {
+  constexpr std::size_t line = 64;
+  auto bytes = row*element_size;
+  if (bytes == 0 || bytes % (8*line))
+    return row;
+  return row + (line + element_size - 1)/element_size;
+}
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_ACCESSOR_DETAIL_LAYOUT_RIGHT_PITCHED_HPP
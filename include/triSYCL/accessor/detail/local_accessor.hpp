@@ -10,12 +10,18 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <concepts>
 #include <cstddef>
+#include <iterator>
 #include <memory>
 
 #include "triSYCL/access.hpp"
 #include "triSYCL/buffer/detail/accessor.hpp"
 #include "triSYCL/detail/debug.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/item.hpp"
+#include "triSYCL/nd_item.hpp"
+#include "triSYCL/parallelism/detail/local_memory_arena.hpp"
 #include "triSYCL/range.hpp"
 
 namespace trisycl {
@@ -32,15 +38,29 @@ class accessor;
     @{
 */
 
+/** Register the use of some local memory by a command group
+
+    \return the offset of the \p size bytes in the local memory of a
+    work-group
+
+    Defined in handler.hpp to avoid complicated type recursion.
+*/
+inline std::size_t register_local_memory(handler &command_group_handler,
+                                         std::size_t size);
+
 /** The local accessor specialization abstracts the way local memory
     is allocated to a kernel to be shared between work-items of the
     same work-group.
 
-    Since this a pure library implementation, implement it as a
-    host_accessor using its own local buffer.
+    The local accessors of a command group are laid out one after the
+    other in the local memory of each work-group, which is provided by
+    the thread executing the work-group, so the work-groups can run in
+    parallel.
 
-    \todo Implement a real local accessor handling several work-group
-    running in parallel
+    Outside of a work-group, for example in a kernel on a range<>
+    without any work-group, the accessor falls back to its own
+    storage, implemented as a host_accessor using its own local
+    buffer.
 */
 template <typename T, int Dimensions, access::mode Mode>
 class accessor<T, Dimensions, Mode, access::target::local>
@@ -49,16 +69,105 @@ class accessor<T, Dimensions, Mode, access::target::local>
           accessor<T, Dimensions, Mode, access::target::local>> {
   using hb = accessor<T, Dimensions, Mode, access::target::host_buffer>;
 
-  // Storage used by this local accessor instance
+  // Storage used by this local accessor instance outside of a work-group
   std::shared_ptr<buffer<T, Dimensions>> buf;
 
+  /// The position of the storage in the local memory of a work-group
+  std::size_t offset;
+
+  /// Get the elements in the local memory of the current work-group
+  typename hb::mdspan local_access() const {
+    if (auto base = local_memory_arena::current())
+      return { reinterpret_cast<T*>(base + offset), hb::access.extents() };
+    return hb::access;
+  }
+
  public:
+  using typename hb::iterator;
+  using typename hb::const_iterator;
+  using typename hb::reverse_iterator;
+  using typename hb::const_reverse_iterator;
+
   /// Construct a local accessor of the right size
   accessor(const range<Dimensions>& allocation_size,
            handler& command_group_handler)
       : buf { std::make_shared<buffer<T, Dimensions>>(allocation_size) } {
     this->set_buffer(buf);
+    buf->host_storage();
     this->set_access(buf->access);
+    offset = register_local_memory(command_group_handler, hb::get_size());
+  }
+
+
+  /** Use the accessor with integers à la [i1][i2][i3] or C++23 [i1, i2,...]
+
+      \return decltype(auto) to return either a reference to the final
+      element when the indexing has been fully resolved or a proxy
+      object to handle the remaining [] */
+  template <std::integral... I> decltype(auto) operator[](I... indices) const {
+    if constexpr (sizeof...(I) == 1)
+      return typename hb::template track_index<1> { local_access() }
+        [indices...];
+    else
+      return local_access()[indices...];
+  }
+
+
+  /// To use the accessor with [id<>]
+  decltype(auto) operator[](const id<Dimensions>& index) const {
+    return hb::tuple_indexed_mdspan_access(local_access(), index);
+  }
+
+
+  /// To use an accessor with [item<>]
+  decltype(auto) operator[](const item<Dimensions>& index) const {
+    return (*this)[index.get()];
+  }
+
+
+  /// To use an accessor with an [nd_item<>]
+  decltype(auto) operator[](const nd_item<Dimensions>& index) const {
+    return (*this)[index.get_global()];
+  }
+
+
+  /// Get the first element of the accessor
+  typename hb::reference operator*() const { return *data(); }
+
+
+  /// Get the storage in the current work-group
+  auto data() const { return local_access().data_handle(); }
+
+
+  /// Return the pointer to the data
+  auto get_pointer() const { return data(); }
+
+
+  iterator begin() const { return data(); }
+
+
+  iterator end() const { return data() + hb::get_count(); }
+
+
+  const_iterator cbegin() const { return begin(); }
+
+
+  const_iterator cend() const { return end(); }
+
+
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+
+
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(cend());
+  }
+
+
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(cbegin());
   }
 };
 
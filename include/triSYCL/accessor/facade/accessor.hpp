@@ -150,15 +150,17 @@ template <typename AccessorMixIn> class accessor : public AccessorMixIn {
       \todo Factor out these in a template helper
 
       \todo Do we need this in detail::accessor too or only in accessor?
+
+      The iterators go through the padding of the rows too, if any.
   */
 
   iterator begin() { return mixin::data(); }
 
-  iterator end() { return mixin::data() + mixin::get_count(); }
+  iterator end() { return mixin::data() + mixin::get_storage_count(); }
 
   const_iterator cbegin() { return mixin::data(); }
 
-  const_iterator cend() { return mixin::data() + mixin::get_count(); }
+  const_iterator cend() { return mixin::data() + mixin::get_storage_count(); }
 
   reverse_iterator rbegin() { return std::reverse_iterator(end()); }
 
@@ -14,6 +14,7 @@
 #include <utility>
 
 #include "triSYCL/range.hpp"
+#include "triSYCL/accessor/detail/layout_right_pitched.hpp"
 #include "triSYCL/detail/small_array.hpp"
 
 namespace trisycl::mixin {
@@ -43,9 +44,16 @@ template <typename T, int Dimensions> class accessor {
   static auto constexpr rank() { return Dimensions; }
 
  protected:
-  /// The memory lay-out of a buffer is a dynamic multidimensional array
+  /** The memory lay-out of a buffer is a dynamic multidimensional
+      array, in row-major order with possibly some padding at the end
+      of the rows
+  */
   using mdspan = std::experimental::mdspan<
-      element_type, std::experimental::dextents<std::size_t, Dimensions>>;
+      element_type, std::experimental::dextents<std::size_t, Dimensions>,
+      detail::layout_right_pitched>;
+
+  /// The mapping of the indices to the storage
+  using mapping = typename mdspan::mapping_type;
 
   /** This is the multi-dimensional interface to the data that may point
       to either allocation in the case of storage managed by SYCL itself
@@ -88,11 +96,31 @@ template <typename T, int Dimensions> class accessor {
   accessor(const mdspan& m)
       : access { m } {}
 
-  /// Update the accessor to target somewhere else
+  /** Update the accessor to target somewhere else, keeping the row
+      pitch when the row length does not change
+  */
   void update(pointer data, const range<rank()>& r) {
-    access = mdspan { data, extents_cast(r) };
+    typename mdspan::extents_type e { extents_cast(r) };
+    if (e.extent(rank() - 1) == access.extent(rank() - 1))
+      access = mdspan { data, mapping { e, get_row_pitch() } };
+    else
+      access = mdspan { data, e };
   }
 
+  /** Set the number of elements from a row to the next one in the
+      storage, the rows being along the last dimension
+  */
+  void set_row_pitch(std::size_t pitch) {
+    access = mdspan { access.data_handle(),
+                      mapping { access.extents(), pitch } };
+  }
+
+  /// Get the number of elements from a row to the next one
+  std::size_t get_row_pitch() const { return access.mapping().row_pitch(); }
+
+  /// Test whether the rows have some padding
+  bool is_padded() const { return !access.mapping().is_exhaustive(); }
+
   /** Return a range object representing the size of the buffer in
        terms of number of elements in each dimension as passed to the
        constructor
@@ -116,7 +144,14 @@ template <typename T, int Dimensions> class accessor {
       \todo Cache it since it is const?
   */
   std::size_t get_count() const {
-    return access.mapping().required_span_size();
+    return access.size();
+  }
+
+  /** Returns the number of elements of the storage, including the
+      padding of the rows
+  */
+  std::size_t get_storage_count() const {
+    return access.mapping().rows()*get_row_pitch();
   }
 
   /** Returns the size of the buffer storage in bytes
@@ -129,6 +164,11 @@ template <typename T, int Dimensions> class accessor {
   */
   std::size_t get_size() const { return get_count() * sizeof(value_type); }
 
+  /// Returns the size of the storage in bytes, including the padding
+  std::size_t get_storage_size() const {
+    return get_storage_count() * sizeof(value_type);
+  }
+
   /// Get the underlying storage
   auto data() { return access.data_handle(); }
 
@@ -172,9 +212,9 @@ template <typename T, int Dimensions> class accessor {
       this proxy
   */
   template <std::size_t N> struct track_index {
-    /// Keep a reference to the mdspan to eventually resolve the
-    /// indexing
-    mdspan& mds;
+    /** Keep a copy of the mdspan to eventually resolve the indexing,
+        which is cheap since it is only a view of the data */
+    mdspan mds;
 
     /// The list of indices in the order of [i1][i2][i3]...
     std::array<std::size_t, N> indices;
@@ -185,7 +225,7 @@ template <typename T, int Dimensions> class accessor {
 
     /// Create a tracking object from an mdspan and a list of indices
     template <typename... Index>
-    track_index(mdspan& m, Index&&... inds)
+    track_index(const mdspan& m, Index&&... inds)
         : mds { m }
         // Typically there will be N - 1 indices in the array of size N
         , indices { std::forward<Index>(inds)... } {}
@@ -11,6 +11,10 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <cstddef>
+
+#include "triSYCL/detail/prefetch.hpp"
+
 
 /* Use macros for address spaces to be able to retarget more easily to
    different runtimes & compilers.
@@ -304,6 +308,15 @@ struct address_space_ptr : public address_space_fundamental<T, AS> {
 
   /// Put back the default constructors canceled by the previous definition
   address_space_ptr() = default;
+
+
+  /** Hint that the \p num_elements elements from the pointed address
+      are going to be read soon, to bring them into the cache
+  */
+  void prefetch(std::size_t num_elements) const {
+    detail::prefetch<AS == access::address_space::global_space>(
+      super::variable, num_elements);
+  }
 };
 
 
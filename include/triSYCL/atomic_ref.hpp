@@ -0,0 +1,317 @@
+#ifndef TRISYCL_SYCL_ATOMIC_REF_HPP
+#define TRISYCL_SYCL_ATOMIC_REF_HPP
+
+/** \file The SYCL 2020 atomic references
+
+    They are implemented with std::atomic_ref, since all the kernels
+    running on the host share a coherent memory. For the same reason
+    the memory scopes make no difference.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+
+#include "triSYCL/address_space.hpp"
+
+namespace trisycl {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/// The memory orderings of the atomic operations
+enum class memory_order {
+  relaxed,
+  acquire,
+  release,
+  acq_rel,
+  seq_cst
+};
+
+
+/// The sets of work-items an atomic operation is atomic with respect to
+enum class memory_scope {
+  work_item,
+  sub_group,
+  work_group,
+  device,
+  system
+};
+
+
+namespace detail {
+
+/// Get the C++ memory ordering matching a SYCL one
+constexpr std::memory_order to_std(memory_order o) {
+  switch (o) {
+  case memory_order::relaxed: return std::memory_order_relaxed;
+  case memory_order::acquire: return std::memory_order_acquire;
+  case memory_order::release: return std::memory_order_release;
+  case memory_order::acq_rel: return std::memory_order_acq_rel;
+  default: return std::memory_order_seq_cst;
+  }
+}
+
+}
+
+
+/** An atomic view of an object, like std::atomic_ref
+
+    \param DefaultOrder is the memory ordering used by the operations
+    without an explicit one
+
+    \param DefaultScope is the memory scope used by the operations
+    without an explicit one, which makes no difference on the host
+
+    Only the arithmetic types are supported, not the pointers.
+*/
+template <typename T, memory_order DefaultOrder, memory_scope DefaultScope,
+          access::address_space Space = access::address_space::generic_space>
+class atomic_ref {
+  static_assert(std::is_arithmetic_v<T>,
+                "atomic_ref is only implemented on arithmetic types");
+
+  std::atomic_ref<T> ref;
+
+public:
+
+  using value_type = T;
+  using difference_type = T;
+
+  static constexpr std::size_t required_alignment =
+    std::atomic_ref<T>::required_alignment;
+
+  static constexpr bool is_always_lock_free =
+    std::atomic_ref<T>::is_always_lock_free;
+
+  /// The ordering of the loads when there is none given
+  static constexpr memory_order default_read_order =
+    DefaultOrder == memory_order::acq_rel ? memory_order::acquire
+    : DefaultOrder == memory_order::release ? memory_order::relaxed
+    : DefaultOrder;
+
+  /// The ordering of the stores when there is none given
+  static constexpr memory_order default_write_order =
+    DefaultOrder == memory_order::acq_rel ? memory_order::release
+    : DefaultOrder == memory_order::acquire ? memory_order::relaxed
+    : DefaultOrder;
+
+  static constexpr memory_order default_read_modify_write_order =
+    DefaultOrder;
+
+  static constexpr memory_scope default_scope = DefaultScope;
+
+  static constexpr access::address_space address_space = Space;
+
+
+  /// Make an atomic view of \p r
+  explicit atomic_ref(T &r) : ref { r } {}
+
+  atomic_ref(const atomic_ref &) noexcept = default;
+
+  atomic_ref &operator=(const atomic_ref &) = delete;
+
+
+  bool is_lock_free() const noexcept {
+    return ref.is_lock_free();
+  }
+
+
+  void store(T operand, memory_order order = default_write_order,
+             memory_scope = default_scope) const noexcept {
+    ref.store(operand, detail::to_std(order));
+  }
+
+
+  T operator=(T desired) const noexcept {
+    store(desired);
+    return desired;
+  }
+
+
+  T load(memory_order order = default_read_order,
+         memory_scope = default_scope) const noexcept {
+    return ref.load(detail::to_std(order));
+  }
+
+
+  operator T() const noexcept {
+    return load();
+  }
+
+
+  T exchange(T operand, memory_order order = default_read_modify_write_order,
+             memory_scope = default_scope) const noexcept {
+    return ref.exchange(operand, detail::to_std(order));
+  }
+
+
+  bool compare_exchange_weak(T &expected, T desired,
+                             memory_order success, memory_order failure,
+                             memory_scope = default_scope) const noexcept {
+    return ref.compare_exchange_weak(expected, desired,
+                                     detail::to_std(success),
+                                     detail::to_std(failure));
+  }
+
+
+  bool compare_exchange_weak(T &expected, T desired,
+                             memory_order order =
+                               default_read_modify_write_order,
+                             memory_scope = default_scope) const noexcept {
+    return ref.compare_exchange_weak(expected, desired,
+                                     detail::to_std(order));
+  }
+
+
+  bool compare_exchange_strong(T &expected, T desired,
+                               memory_order success, memory_order failure,
+                               memory_scope = default_scope) const noexcept {
+    return ref.compare_exchange_strong(expected, desired,
+                                       detail::to_std(success),
+                                       detail::to_std(failure));
+  }
+
+
+  bool compare_exchange_strong(T &expected, T desired,
+                               memory_order order =
+                                 default_read_modify_write_order,
+                               memory_scope = default_scope) const noexcept {
+    return ref.compare_exchange_strong(expected, desired,
+                                       detail::to_std(order));
+  }
+
+
+  T fetch_add(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept {
+    return ref.fetch_add(operand, detail::to_std(order));
+  }
+
+
+  T fetch_sub(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept {
+    return ref.fetch_sub(operand, detail::to_std(order));
+  }
+
+
+  T fetch_and(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept
+    requires std::integral<T> {
+    return ref.fetch_and(operand, detail::to_std(order));
+  }
+
+
+  T fetch_or(T operand,
+             memory_order order = default_read_modify_write_order,
+             memory_scope = default_scope) const noexcept
+    requires std::integral<T> {
+    return ref.fetch_or(operand, detail::to_std(order));
+  }
+
+
+  T fetch_xor(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept
+    requires std::integral<T> {
+    return ref.fetch_xor(operand, detail::to_std(order));
+  }
+
+
+  /** Replace the value by the minimum of it and \p operand
+
+      \return the previous value
+  */
+  T fetch_min(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept {
+    auto old = ref.load(std::memory_order_relaxed);
+    // Only write when it changes the value
+    while (operand < old
+           && !ref.compare_exchange_weak(old, operand, detail::to_std(order),
+                                         std::memory_order_relaxed));
+    return old;
+  }
+
+
+  /** Replace the value by the maximum of it and \p operand
+
+      \return the previous value
+  */
+  T fetch_max(T operand,
+              memory_order order = default_read_modify_write_order,
+              memory_scope = default_scope) const noexcept {
+    auto old = ref.load(std::memory_order_relaxed);
+    while (old < operand
+           && !ref.compare_exchange_weak(old, operand, detail::to_std(order),
+                                         std::memory_order_relaxed));
+    return old;
+  }
+
+
+  T operator++(int) const noexcept {
+    return fetch_add(1);
+  }
+
+
+  T operator--(int) const noexcept {
+    return fetch_sub(1);
+  }
+
+
+  T operator++() const noexcept {
+    return fetch_add(1) + 1;
+  }
+
+
+  T operator--() const noexcept {
+    return fetch_sub(1) - 1;
+  }
+
+
+  T operator+=(T operand) const noexcept {
+    return fetch_add(operand) + operand;
+  }
+
+
+  T operator-=(T operand) const noexcept {
+    return fetch_sub(operand) - operand;
+  }
+
+
+  T operator&=(T operand) const noexcept requires std::integral<T> {
+    return fetch_and(operand) & operand;
+  }
+
+
+  T operator|=(T operand) const noexcept requires std::integral<T> {
+    return fetch_or(operand) | operand;
+  }
+
+
+  T operator^=(T operand) const noexcept requires std::integral<T> {
+    return fetch_xor(operand) ^ operand;
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_ATOMIC_REF_HPP
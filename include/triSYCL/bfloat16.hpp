@@ -0,0 +1,253 @@
+#ifndef TRISYCL_SYCL_BFLOAT16_HPP
+#define TRISYCL_SYCL_BFLOAT16_HPP
+
+/** \file The bfloat16 floating-point type
+
+    A bfloat16 is stored as the 16 most significant bits of a float,
+    keeping its 8-bit exponent with only 7 bits of mantissa, and
+    computes in float, rounding the result back to the nearest even
+    bfloat16. So storing some weights as bfloat16 halves their
+    bandwidth, while the arithmetic keeps the range of float.
+
+    The widening to float is just a shift. The rounding uses the __bf16
+    type of the compiler when available and a software version
+    otherwise.
+
+    This is a triSYCL extension, like SYCL_EXT_ONEAPI_BFLOAT16.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace trisycl {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+namespace detail {
+
+/// Round a float to the nearest even bfloat16 number, in software
+inline std::uint16_t float_to_bfloat16_bits(float f) {
+  auto x = std::bit_cast<std::uint32_t>(f);
+  // Keep a NaN quiet, since its rounding could give an infinity
+  if ((x & 0x7fffffff) > 0x7f800000)
+    return (x >> 16) | 0x40;
+  // The carry of the mantissa rounding may go up to the exponent
+  return (x + 0x7fff + ((x >> 16) & 1)) >> 16;
+}
+
+
+/// Widen a bfloat16 number to a float, which is exact
+inline float bfloat16_bits_to_float(std::uint16_t b) {
+  return std::bit_cast<float>(static_cast<std::uint32_t>(b) << 16);
+}
+
+}
+
+/// The bfloat16 floating-point type
+class bfloat16 {
+
+  std::uint16_t bits;
+
+
+  /// Convert a float with the fastest way available
+  static std::uint16_t from_float(float f) {
+#if defined(__BFLT16_MAX__)
+    return std::bit_cast<std::uint16_t>(static_cast<__bf16>(f));
+#else
+    return detail::float_to_bfloat16_bits(f);
+#endif
+  }
+
+
+  /** The type of a mixed operation: the floating-point type of the
+      other operand, or bfloat16 with an integer
+  */
+  template <typename T>
+  using mixed = std::conditional_t<std::is_floating_point_v<T>, T, bfloat16>;
+
+public:
+
+  /// An uninitialized bfloat16, as a float would be
+  bfloat16() = default;
+
+  bfloat16(float f) : bits { from_float(f) } {}
+
+  /// Construct from any other arithmetic type, through a float
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  bfloat16(T v) : bfloat16 { static_cast<float>(v) } {}
+
+
+  /// Get a bfloat16 from its representation
+  static bfloat16 from_bits(std::uint16_t b) {
+    bfloat16 h;
+    h.bits = b;
+    return h;
+  }
+
+
+  /// Get the representation, the 16 most significant bits of a float
+  std::uint16_t get_bits() const {
+    return bits;
+  }
+
+
+  operator float() const {
+    return detail::bfloat16_bits_to_float(bits);
+  }
+
+
+  bfloat16 operator+() const {
+    return *this;
+  }
+
+
+  bfloat16 operator-() const {
+    return from_bits(bits ^ 0x8000);
+  }
+
+
+#define TRISYCL_BFLOAT16_OPERATOR(op)                                   \
+  bfloat16 &operator op##=(bfloat16 rhs) {                              \
+    return *this = float(*this) op float(rhs);                          \
+  }                                                                     \
+                                                                        \
+  friend bfloat16 operator op(bfloat16 lhs, bfloat16 rhs) {             \
+    return float(lhs) op float(rhs);                                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend mixed<T> operator op(bfloat16 lhs, T rhs) {                    \
+    return static_cast<mixed<T>>(float(lhs) op rhs);                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend mixed<T> operator op(T lhs, bfloat16 rhs) {                    \
+    return static_cast<mixed<T>>(lhs op float(rhs));                    \
+  }
+
+  TRISYCL_BFLOAT16_OPERATOR(+)
+  TRISYCL_BFLOAT16_OPERATOR(-)
+  TRISYCL_BFLOAT16_OPERATOR(*)
+  TRISYCL_BFLOAT16_OPERATOR(/)
+
+#undef TRISYCL_BFLOAT16_OPERATOR
+
+
+#define TRISYCL_BFLOAT16_COMPARISON(op)                                 \
+  friend bool operator op(bfloat16 lhs, bfloat16 rhs) {                 \
+    return float(lhs) op float(rhs);                                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend bool operator op(bfloat16 lhs, T rhs) {                        \
+    return float(lhs) op rhs;                                           \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend bool operator op(T lhs, bfloat16 rhs) {                        \
+    return lhs op float(rhs);                                           \
+  }
+
+  TRISYCL_BFLOAT16_COMPARISON(==)
+  TRISYCL_BFLOAT16_COMPARISON(!=)
+  TRISYCL_BFLOAT16_COMPARISON(<)
+  TRISYCL_BFLOAT16_COMPARISON(>)
+  TRISYCL_BFLOAT16_COMPARISON(<=)
+  TRISYCL_BFLOAT16_COMPARISON(>=)
+
+#undef TRISYCL_BFLOAT16_COMPARISON
+
+
+  bfloat16 &operator++() {
+    return *this += 1.0f;
+  }
+
+
+  bfloat16 operator++(int) {
+    auto old = *this;
+    ++*this;
+    return old;
+  }
+
+
+  bfloat16 &operator--() {
+    return *this -= 1.0f;
+  }
+
+
+  bfloat16 operator--(int) {
+    auto old = *this;
+    --*this;
+    return old;
+  }
+
+};
+
+static_assert(sizeof(bfloat16) == 2, "A bfloat16 has the size of 16 bits");
+
+/// @} End the data Doxygen group
+
+}
+
+
+namespace std {
+
+/// The characteristics of the bfloat16 format
+template <>
+class numeric_limits<trisycl::bfloat16> {
+  using bfloat16 = trisycl::bfloat16;
+
+public:
+
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = true;
+  static constexpr bool is_iec559 = false;
+  static constexpr bool is_bounded = true;
+  static constexpr int digits = 8;
+  static constexpr int digits10 = 2;
+  static constexpr int max_digits10 = 4;
+  static constexpr int radix = 2;
+  static constexpr int min_exponent = -125;
+  static constexpr int min_exponent10 = -37;
+  static constexpr int max_exponent = 128;
+  static constexpr int max_exponent10 = 38;
+
+  static bfloat16 min() { return bfloat16::from_bits(0x0080); }
+  static bfloat16 lowest() { return bfloat16::from_bits(0xff7f); }
+  static bfloat16 max() { return bfloat16::from_bits(0x7f7f); }
+  static bfloat16 epsilon() { return bfloat16::from_bits(0x3c00); }
+  static bfloat16 round_error() { return bfloat16::from_bits(0x3f00); }
+  static bfloat16 infinity() { return bfloat16::from_bits(0x7f80); }
+  static bfloat16 quiet_NaN() { return bfloat16::from_bits(0x7fc0); }
+  static bfloat16 signaling_NaN() { return bfloat16::from_bits(0x7fa0); }
+  static bfloat16 denorm_min() { return bfloat16::from_bits(0x0001); }
+};
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_BFLOAT16_HPP
@@ -11,6 +11,8 @@
 
 #include <concepts>
 #include <cstddef>
+#include <exception>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <ranges>
@@ -23,9 +25,11 @@
 #include "triSYCL/buffer_allocator.hpp"
 #include "triSYCL/detail/global_config.hpp"
 #include "triSYCL/detail/shared_ptr_implementation.hpp"
+#include "triSYCL/detail/task_executor.hpp"
 #include "triSYCL/event.hpp"
 #include "triSYCL/handler.hpp"
 #include "triSYCL/id.hpp"
+#include "triSYCL/property_list.hpp"
 #include "triSYCL/queue.hpp"
 #include "triSYCL/range.hpp"
 
@@ -35,6 +39,15 @@ namespace trisycl {
     @{
 */
 
+namespace detail {
+
+/// To construct a buffer owning a reinterpreted view
+struct buffer_view_tag {
+  explicit buffer_view_tag() = default;
+};
+
+}
+
 /** A SYCL buffer is a multidimensional variable length array (à la C99
     VLA or even Fortran before) that is used to store data to work on.
 
@@ -66,6 +79,7 @@ class buffer
   : public detail::shared_ptr_implementation<
                          buffer<T, Dimensions, Allocator>,
                          detail::buffer_waiter<T, Dimensions, Allocator>>,
+    public property_list,
     detail::debug<buffer<T, Dimensions, Allocator>> {
 public:
 
@@ -89,6 +103,10 @@ private:
   // Allows the comparison operation to access the implementation
   friend implementation_t;
 
+  // To create the reinterpreted views with another element type
+  template <typename, int, typename>
+  friend class buffer;
+
 public:
 
   // Make the implementation member directly accessible in this class
@@ -116,11 +134,21 @@ public:
       \param[in] r defines the size
 
       \param[in] allocator is to be used by the SYCL runtime
+
+      \param[in] propList is the list of properties of the buffer
   */
-  buffer(const range<Dimensions> &r, Allocator allocator = {})
+  buffer(const range<Dimensions> &r, Allocator allocator = {},
+         const property_list &propList = {})
     : implementation_t { detail::waiter<T, Dimensions, Allocator>(
-                         new detail::buffer<T, Dimensions> { r }) }
-      {}
+                         new detail::buffer<T, Dimensions> { r, allocator }) }
+    , property_list { propList } {
+    apply_properties();
+  }
+
+
+  /// Create a new buffer of the given size with some properties
+  buffer(const range<Dimensions> &r, const property_list &propList)
+    : buffer { r, Allocator {}, propList } {}
 
 
   /** Create a new buffer with associated host memory
@@ -152,10 +180,25 @@ public:
             typename = std::enable_if_t<!std::is_const<Dependent>::value>>
   buffer(const T *host_data,
          const range<Dimensions> &r,
-         Allocator allocator = {})
-    : implementation_t { detail::waiter(new detail::buffer<T, Dimensions>
-                         { host_data, r }) }
-  {}
+         Allocator allocator = {},
+         const property_list &propList = {})
+    : implementation_t { detail::waiter<T, Dimensions, Allocator>(
+                         new detail::buffer<T, Dimensions>
+                         { host_data, r, allocator }) }
+    , property_list { propList } {
+    apply_properties();
+  }
+
+
+  /** Create a new buffer with associated read-only host memory and
+      some properties
+  */
+  template <typename Dependent = T,
+            typename = std::enable_if_t<!std::is_const<Dependent>::value>>
+  buffer(const T *host_data,
+         const range<Dimensions> &r,
+         const property_list &propList)
+    : buffer { host_data, r, Allocator {}, propList } {}
 
 
   /** Create a new buffer with associated host memory
@@ -176,10 +219,21 @@ public:
   */
   buffer(T *host_data,
          const range<Dimensions> &r,
-         Allocator allocator = {})
-    : implementation_t { detail::waiter(new detail::buffer<T, Dimensions>
-                         { host_data, r }) }
-  {}
+         Allocator allocator = {},
+         const property_list &propList = {})
+    : implementation_t { detail::waiter<T, Dimensions, Allocator>(
+                         new detail::buffer<T, Dimensions>
+                         { host_data, r, allocator }) }
+    , property_list { propList } {
+    apply_properties();
+  }
+
+
+  /// Create a new buffer with associated host memory and some properties
+  buffer(T *host_data,
+         const range<Dimensions> &r,
+         const property_list &propList)
+    : buffer { host_data, r, Allocator {}, propList } {}
 
 
   /** Create a new buffer with associated host memory from a range
@@ -207,7 +261,7 @@ public:
   buffer(Range /* auto std::continuous_range */& host_data,
          Allocator allocator = {})
       : buffer { host_data.begin(),
-                 range { std::ranges::distance(host_data) } } {}
+                 range { std::ranges::distance(host_data) }, allocator } {}
 
   /** Create a new buffer with associated memory, using the data in
       host_data
@@ -258,10 +312,21 @@ public:
   */
   buffer(shared_ptr_class<T> host_data,
          const range<Dimensions> &buffer_range,
-         Allocator allocator = {})
-    : implementation_t { detail::waiter(new detail::buffer<T, Dimensions>
-                         { host_data, buffer_range }) }
-  {}
+         Allocator allocator = {},
+         const property_list &propList = {})
+    : implementation_t { detail::waiter<T, Dimensions, Allocator>(
+                         new detail::buffer<T, Dimensions>
+                         { host_data, buffer_range, allocator }) }
+    , property_list { propList } {
+    apply_properties();
+  }
+
+
+  /// Create a new buffer sharing some host memory, with some properties
+  buffer(shared_ptr_class<T> host_data,
+         const range<Dimensions> &buffer_range,
+         const property_list &propList)
+    : buffer { std::move(host_data), buffer_range, Allocator {}, propList } {}
 
 
   /** Create a new allocated 1D buffer initialized from the given
@@ -303,30 +368,45 @@ public:
             typename std::iterator_traits<InputIterator>::value_type>
   buffer(InputIterator start_iterator,
          InputIterator end_iterator,
-         Allocator allocator = {}) :
-    implementation_t { detail::waiter(new detail::buffer<T, Dimensions>
-                       { start_iterator, end_iterator }) }
-  {}
+         Allocator allocator = {},
+         const property_list &propList = {}) :
+    implementation_t { detail::waiter<T, Dimensions, Allocator>(
+                       new detail::buffer<T, Dimensions>
+                       { start_iterator, end_iterator, allocator }) }
+    , property_list { propList } {
+    apply_properties();
+  }
 
 
   /** Create a new sub-buffer without allocation to have separate
       accessors later
 
-      \param[inout] b is the buffer with the real data
+      The sub-buffer aliases the storage of \p b and has its own
+      dependency tracking: the kernels using disjoint sub-buffers can
+      run concurrently, while an access to \p b waits for all of them.
+
+      \param[inout] b is the buffer with the real data, which cannot be
+      a sub-buffer
 
       \param[in] base_index specifies the origin of the sub-buffer inside the
       buffer b
 
-      \param[in] sub_range specifies the size of the sub-buffer
-
-      \todo To be implemented
+      \param[in] sub_range specifies the size of the sub-buffer, which
+      has to be contiguous in the storage of \p b, otherwise an
+      invalid_object_error is thrown
 
       \todo Update the specification to replace index by id
   */
   buffer(buffer<T, Dimensions, Allocator> &b,
          const id<Dimensions> &base_index,
          const range<Dimensions> &sub_range,
-         Allocator allocator = {}) { TRISYCL_UNIMPL; }
+         Allocator allocator = {})
+    : implementation_t { detail::waiter<T, Dimensions, Allocator>(
+                         new detail::buffer<T, Dimensions>
+                         { b.implementation->implementation,
+                           base_index, sub_range }) } {
+    implementation->implementation->attach_to_parent();
+  }
 
 
 #ifdef TRISYCL_OPENCL
@@ -378,15 +458,32 @@ public:
   accessor<T, Dimensions, Mode, Target>
   get_access(handler &command_group_handler) {
     static_assert(Target == access::target::global_buffer
-                  || Target == access::target::constant_buffer,
+                  || Target == access::target::constant_buffer
+                  || Target == access::target::host_task,
                   "get_access(handler) can only deal with access::global_buffer"
-                  " or access::constant_buffer (for host_buffer accessor"
-                  " do not use a command group handler");
-    implementation->implementation->template track_access_mode<Mode, Target>();
+                  ", access::constant_buffer or access::host_task (for"
+                  " host_buffer accessor do not use a command group handler");
     return { *this, command_group_handler };
   }
 
 
+  /** Get an accessor to the elements of range \p access_range starting
+      at \p access_offset of the buffer, with the required mode and
+      target
+
+      The elements are still indexed from the start of the buffer, but
+      only the ones of the range are considered as written.
+  */
+  template <access::mode Mode,
+            access::target Target = access::target::global_buffer>
+  accessor<T, Dimensions, Mode, Target>
+  get_access(handler &command_group_handler,
+             const range<Dimensions> &access_range,
+             const id<Dimensions> &access_offset = {}) {
+    return { *this, command_group_handler, access_range, access_offset };
+  }
+
+
   /** Force the buffer to behave like if we had created
       an accessor in write mode.
    */
@@ -395,6 +492,20 @@ public:
   }
 
 
+  /** Force the buffer to behave like if we had written the elements of
+      range \p r starting at \p offset
+
+      Only the elements marked as written, by this or by the accessors
+      with write access, are written back or transferred to the host.
+  */
+  void mark_as_written(const range<Dimensions> &r,
+                       const id<Dimensions> &offset = {}) {
+    auto [first, last] =
+      implementation->implementation->linear_window(offset, r);
+    implementation->implementation->mark_as_written(first, last);
+  }
+
+
   /** Get a host accessor to the buffer with the required mode
 
       \param Mode is the requested access mode
@@ -406,11 +517,70 @@ public:
   template <access::mode Mode>
   accessor<T, Dimensions, Mode, access::target::host_buffer>
   get_access() {
-    implementation->implementation->template track_access_mode<Mode, access::target::host_buffer>();
     return { *this };
   }
 
 
+  /// Get a host accessor to the elements of a range of the buffer
+  template <access::mode Mode>
+  accessor<T, Dimensions, Mode, access::target::host_buffer>
+  get_access(const range<Dimensions> &access_range,
+             const id<Dimensions> &access_offset = {}) {
+    return { *this, access_range, access_offset };
+  }
+
+
+  /** Call \p f with a host accessor to the buffer with the required
+      mode once the kernels using the buffer are done, without blocking
+      the caller
+
+      \p f is called on a thread of the task executor, so for example
+      an event loop can ask for the result of some kernels without
+      stalling.
+
+      This is a triSYCL extension.
+  */
+  template <access::mode Mode, typename F>
+    requires std::invocable<F &, accessor<T, Dimensions, Mode,
+                                          access::target::host_buffer>>
+  void get_host_access_async(F f) {
+    implementation->implementation->when_ready(
+      [b = *this, f = std::move(f)] () mutable {
+        // Do not run the host code on the thread releasing the buffer
+        detail::task_executor::default_pool()->submit(
+          [b = std::move(b), f = std::move(f)] () mutable {
+            f(b.template get_access<Mode>());
+          });
+      });
+  }
+
+
+  /** Get a future of a host accessor to the buffer with the required
+      mode, ready once the kernels using the buffer are done
+
+      This is a triSYCL extension.
+  */
+  template <access::mode Mode>
+  std::future<accessor<T, Dimensions, Mode, access::target::host_buffer>>
+  get_host_access_async() {
+    using host_accessor =
+      accessor<T, Dimensions, Mode, access::target::host_buffer>;
+    auto p = std::make_shared<std::promise<host_accessor>>();
+    auto f = p->get_future();
+    implementation->implementation->when_ready([b = *this, p] () mutable {
+        detail::task_executor::default_pool()->submit(
+          [b = std::move(b), p] () mutable {
+            try {
+              p->set_value(b.template get_access<Mode>());
+            } catch (...) {
+              p->set_exception(std::current_exception());
+            }
+          });
+      });
+    return f;
+  }
+
+
   /** Return a range object representing the size of the buffer in
       terms of number of elements in each dimension as passed to the
       constructor
@@ -468,6 +638,57 @@ public:
   }
 
 
+  /// Test whether this buffer is a sub-buffer of another one
+  bool is_sub_buffer() const {
+    return implementation->implementation->parent != nullptr;
+  }
+
+
+  /** Get a view of the same storage with the element type
+      ReinterpretT and the range \p reinterpretRange, without any
+      allocation or copy
+
+      The view shares the coherence and the dependency tracking of
+      this buffer, so a kernel can for example access a buffer of
+      float as some vec or as bytes for free.
+
+      \throw invalid_object_error if the view does not have the same
+      size in bytes as this buffer, or if its elements are not
+      aligned for ReinterpretT
+  */
+  template <typename ReinterpretT, int ReinterpretDim>
+  buffer<ReinterpretT, ReinterpretDim,
+         typename std::allocator_traits<Allocator>::template
+         rebind_alloc<std::remove_const_t<ReinterpretT>>>
+  reinterpret(range<ReinterpretDim> reinterpretRange) const {
+    if (reinterpretRange.size()*sizeof(ReinterpretT) != get_size())
+      throw invalid_object_error {
+        "A reinterpreted buffer has to keep the same size in bytes"
+      };
+    return { detail::buffer_view_tag {}, implementation->implementation->template
+             reinterpret<ReinterpretT>(reinterpretRange) };
+  }
+
+
+  /** Get a view of the same storage with the element type
+      ReinterpretT, with the same range for an element of the same
+      size, otherwise as a 1D buffer
+  */
+  template <typename ReinterpretT, int ReinterpretDim = Dimensions>
+  auto reinterpret() const {
+    if constexpr (ReinterpretDim == Dimensions
+                  && sizeof(ReinterpretT) == sizeof(T))
+      return reinterpret<ReinterpretT>(get_range());
+    else {
+      static_assert(ReinterpretDim == 1, "Without a range, a buffer can "
+                    "only be reinterpreted to 1 dimension or to an "
+                    "element type of the same size");
+      return reinterpret<ReinterpretT>(
+        range<1> { get_size()/sizeof(ReinterpretT) });
+    }
+  }
+
+
   /** Ask for read-only status of the buffer
 
       \todo Add to specification
@@ -537,6 +758,66 @@ public:
       std::forward<Iterator>(finalData));
   }
 
+
+  /** Get a future ready once the buffer storage is destroyed, so after
+      the end of the kernels using it and after the final write-back
+
+      This is mainly useful with the
+      property::buffer::detach_on_destruction property, to wait later
+      for the write-back of a buffer which has been destroyed.
+
+      This is a triSYCL extension.
+  */
+  std::shared_future<void> get_destruction_future() const {
+    return implementation->implementation->get_destruction_future();
+  }
+
+
+  /** Check if the buffer was constructed with the specified
+      property.
+  */
+  template <typename propertyT>
+  bool has_property() const {
+    return property_list::has_property<propertyT>();
+  }
+
+
+  /** Return a copy of the property that the buffer was
+      constructed with.
+  */
+  template <typename propertyT>
+  propertyT get_property() const {
+    return property_list::get_property<propertyT>();
+  }
+
+private:
+
+  /** Own a new reinterpreted view of the storage of another buffer
+
+      The tag keeps a null pointer or an integer from selecting this
+      constructor.
+  */
+  buffer(detail::buffer_view_tag, detail::buffer<T, Dimensions> *view)
+    : implementation_t { detail::waiter<T, Dimensions, Allocator>(view) } {
+    implementation->implementation->attach_to_parent();
+  }
+
+
+  /// Forward to the implementation the properties changing its behavior
+  void apply_properties() {
+    if (has_property<property::buffer::detach_on_destruction>())
+      implementation->implementation->detached = true;
+#ifdef TRISYCL_OPENCL
+    if (has_property<property::buffer::use_host_ptr>())
+      implementation->implementation->zero_copy = true;
+#endif
+    // A 1D buffer has a single row, so there is nothing to pad
+    if constexpr (Dimensions > 1)
+      if (has_property<property::buffer::row_pitch>())
+        implementation->implementation->set_row_pitch(
+          get_property<property::buffer::row_pitch>().get_pitch());
+  }
+
 };
 
 /** A deduction guide to infer the buffer type from the read-write
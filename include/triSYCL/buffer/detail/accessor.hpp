@@ -9,7 +9,9 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
 #include <cstddef>
+#include <limits>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -65,6 +67,9 @@ class accessor
   */
   std::shared_ptr<detail::buffer<T, Dimensions>> buf;
 
+  /// The interval of linear positions which may be accessed
+  std::pair<std::size_t, std::size_t> window = whole_buffer;
+
   /// Where most of the user-facing interface dwells
   using facade = facade::accessor<mixin::accessor<T, Dimensions>>;
 
@@ -83,15 +88,26 @@ class accessor
   /// Used by the local accessor hack on top of host accessor
   accessor() = default;
 
+  /// The interval of linear positions of a whole buffer
+  static constexpr std::pair<std::size_t, std::size_t> whole_buffer {
+    0, std::numeric_limits<std::size_t>::max()
+  };
+
   /** Construct a host accessor from an existing buffer
 
+      \param[in] window is the interval of linear positions which may
+      be accessed, to track the written elements
+
       \todo fix the specification to rename target that shadows
       template parm
   */
-  accessor(std::shared_ptr<detail::buffer<T, Dimensions>> target_buffer)
-      : facade { target_buffer->access }
-      , buf { target_buffer } {
-    target_buffer->template track_access_mode<Mode>();
+  accessor(std::shared_ptr<detail::buffer<T, Dimensions>> target_buffer,
+           std::pair<std::size_t, std::size_t> window = whole_buffer)
+      : buf { target_buffer }, window { window } {
+    target_buffer->template track_access_mode<Mode>(window.first,
+                                                    window.second);
+    // Only look at the storage once it is allocated or copied on write
+    facade::access = target_buffer->access;
     TRISYCL_DUMP_T("Create a host accessor write = " << is_write_access());
     static_assert(Target == access::target::host_buffer,
                   "without a handler, access target should be host_buffer");
@@ -106,27 +122,51 @@ class accessor
        host accessors are blocking
      */
     trisycl::context ctx;
-    buf->update_buffer_state(ctx, Mode, facade::get_size(), facade::data());
+    buf->update_buffer_state(ctx, Mode, facade::get_storage_size(),
+                             facade::data());
 #endif
   }
 
   /** Construct a device accessor from an existing buffer
 
+      \param[in] window is the interval of linear positions which may
+      be accessed, to track the written elements
+
       \todo fix the specification to rename target that shadows
       template parm
   */
   accessor(std::shared_ptr<detail::buffer<T, Dimensions>> target_buffer,
-           handler& command_group_handler)
-      : facade { target_buffer->access }
-      , buf { target_buffer } {
-    target_buffer->template track_access_mode<Mode>();
+           handler& command_group_handler,
+           std::pair<std::size_t, std::size_t> window = whole_buffer)
+      : buf { target_buffer }, window { window } {
+    target_buffer->template track_access_mode<Mode, Target>(window.first,
+                                                            window.second);
     TRISYCL_DUMP_T("Create a kernel accessor write = " << is_write_access());
     static_assert(Target == access::target::global_buffer ||
-                      Target == access::target::constant_buffer,
-                  "access target should be global_buffer or constant_buffer "
-                  "when a handler is used");
+                      Target == access::target::constant_buffer ||
+                      Target == access::target::host_task,
+                  "access target should be global_buffer, constant_buffer "
+                  "or host_task when a handler is used");
     // Register the buffer to the task dependencies
-    task = buffer_add_to_task(buf, &command_group_handler, is_write_access());
+    task = buffer_add_to_task(buf, &command_group_handler, is_write_access(),
+                              window.first, window.second);
+    if (is_read_access())
+      task->reads_in_use.push_back(target_buffer.get());
+    // The bytes of the window are both read and written by some modes
+    task->accessed_bytes +=
+      (std::min(window.second, target_buffer->get_storage_count())
+       - window.first)
+      *sizeof(T)*(Mode == access::mode::atomic
+                  ? 2 : is_read_access() + is_write_access());
+    // The temporaries of a recording share the slabs of the graph
+    if (task->recording)
+      target_buffer->use_graph_storage(*task->recording->storage);
+#ifdef TRISYCL_OPENCL
+    // A kernel running on an OpenCL device does not use the host memory
+    if (task->get_queue()->is_host() || Target == access::target::host_task)
+#endif
+      target_buffer->host_storage();
+    facade::access = target_buffer->access;
   }
 
   /** Register the accessor once a \c std::shared_ptr is created on it
@@ -139,6 +179,18 @@ class accessor
       \todo Double-check with the C++ committee on this issue.
   */
   void register_accessor() {
+    if constexpr (Target == access::target::host_task) {
+#ifdef TRISYCL_OPENCL
+      if constexpr (!std::is_const_v<T>) {
+        auto acc = this->shared_from_this();
+        /* The host task uses the host memory like a host accessor,
+           so bring back the data a device may have produced, once
+           the producers are done */
+        task->add_prelude([=] { acc->copy_in_host(); });
+      }
+#endif
+      return;
+    }
     if (!task->get_queue()->is_host()) {
       // To keep alive this accessor in the following lambdas
       auto acc = this->shared_from_this();
@@ -163,6 +215,14 @@ class accessor
   /// Get the buffer used to create the accessor
   detail::buffer<T, Dimensions>& get_buffer() { return *buf; }
 
+  /** Get the interval of linear positions which may be accessed,
+      within the buffer
+  */
+  std::pair<std::size_t, std::size_t> get_window() const {
+    return { window.first,
+             std::min(window.second, buf->get_storage_count()) };
+  }
+
   /** Test if the accessor has a read access right
 
       \todo Strangely, it is not really constexpr because it is not a
@@ -210,7 +270,24 @@ class accessor
        the buffer doesn't already exists or if the data is not up to date
     */
     auto ctx = task->get_queue()->get_context();
-    buf->update_buffer_state(ctx, Mode, facade::get_size(), facade::data());
+    // The host memory is only allocated if the data have to go through it
+    auto data = buf->needs_host_data(ctx, Mode) ? buf->host_storage()
+                                                : facade::data();
+    /* Only the bytes of the accessed window need to be up-to-date. The
+       device memory has the same padded rows as the host memory */
+    auto size = facade::get_storage_size();
+    auto elements = size/sizeof(T);
+    buf->update_buffer_state(ctx, Mode, size, data,
+                             std::min(window.first, elements)*sizeof(T),
+                             std::min(window.second, elements)*sizeof(T),
+                             &task->transfers);
+  }
+
+  /// Make the host memory up-to-date for a host task
+  void copy_in_host() {
+    trisycl::context host_context;
+    buf->update_buffer_state(host_context, Mode, facade::get_storage_size(),
+                             facade::data());
   }
 
   /// Does nothing
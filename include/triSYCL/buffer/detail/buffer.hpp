@@ -9,20 +9,33 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <type_traits>
+#include <utility>
 
 // \todo Use C++17 optional when it is mainstream
 #include <boost/optional.hpp>
 
 #include "triSYCL/access.hpp"
 #include "triSYCL/accessor/mixin/accessor.hpp"
+#include "triSYCL/buffer_allocator.hpp"
 #include "triSYCL/buffer/detail/accessor.hpp"
 #include "triSYCL/buffer/detail/buffer_base.hpp"
 #include "triSYCL/buffer/detail/buffer_waiter.hpp"
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/placement.hpp"
+#include "triSYCL/exception.hpp"
+#include "triSYCL/id.hpp"
 #include "triSYCL/range.hpp"
+#include "triSYCL/vendor/triSYCL/buffer_pool.hpp"
 
 namespace trisycl::detail {
 
@@ -50,9 +63,13 @@ class buffer
 
   /** The allocator to be used when some memory is needed
 
-      \todo Implement user-provided allocator
+      Its type is erased so that the accessors do not depend on it
   */
-  std::allocator<typename mixin::value_type> alloc;
+  std::function<typename mixin::non_const_pointer(std::size_t)> allocate;
+
+  /// Give back to the allocator the memory of some elements
+  std::function<void(typename mixin::non_const_pointer, std::size_t)>
+  deallocate;
 
   /** If some allocation is requested on the host for the buffer
       memory, this is where the memory is attached to.
@@ -80,26 +97,56 @@ class buffer
   // Track if data have been modified
   bool modified = false;
 
+  /** Set for a buffer without initial data, whose host memory is only
+      allocated when the host needs it */
+  bool lazy_host_storage = false;
+
+  /// To allocate the lazy host memory only once
+  std::once_flag host_storage_allocated;
+
+  /** Set for a buffer without initial data and with the default
+      allocator, whose storage may come from a recorded task_graph */
+  bool may_use_graph_storage = false;
+
+  /** For a reinterpreted view, the offset in bytes of its first element
+      in the storage of its parent, which has another element type
+  */
+  boost::optional<std::size_t> view_offset;
+
+#ifdef TRISYCL_OPENCL
   /// Track the host context
   trisycl::context host_context { trisycl::device {} };
+#endif
 
  public:
   /// Create a new read-write buffer of size \param r
-  buffer(const range<Dimensions>& r)
-      /// \todo Lazily allocate memory since it might not be used on host
-      : mixin { allocate_buffer(r), r } {}
+  template <typename Allocator = buffer_allocator<typename mixin::value_type>>
+  buffer(const range<Dimensions>& r, const Allocator& a = {})
+      : detail::buffer_base { false }
+      , mixin { nullptr, r }
+      , lazy_host_storage { true }
+      , may_use_graph_storage { std::is_same_v<Allocator, buffer_allocator<
+                                  typename mixin::value_type>> } {
+    use_allocator(a);
+  }
 
   /** Create a new read-write buffer from \param host_data of size
       \param r without further allocation */
-  buffer(T* host_data, const range<Dimensions>& r)
+  template <typename Allocator = buffer_allocator<typename mixin::value_type>>
+  buffer(T* host_data, const range<Dimensions>& r, const Allocator& a = {})
       : mixin { host_data, r }
-      , data_host { true } {}
+      , data_host { true } {
+    use_allocator(a);
+  }
 
   /** Create a new read-only buffer from \param host_data of size \param r
       without further allocation
 
       If the buffer is non const, use a copy-on-write mechanism with
-      internal writable memory.
+      internal writable memory. The whole data are copied at the first
+      write accessor, except in a discard mode. For a copy-on-write
+      page by page of some data in a file, use a
+      vendor::trisycl::mapped_file instead.
 
       \todo Clarify the semantics in the spec. What happens if the
       host change the host_data after buffer creation?
@@ -108,8 +155,10 @@ class buffer
       because if it is constant, the buffer is constant too.
   */
   template <typename Dependent = T,
-            typename = std::enable_if_t<!std::is_const<Dependent>::value>>
-  buffer(const T* host_data, const range<Dimensions>& r)
+            typename = std::enable_if_t<!std::is_const<Dependent>::value>,
+            typename Allocator = buffer_allocator<typename mixin::value_type>>
+  buffer(const T* host_data, const range<Dimensions>& r,
+         const Allocator& a = {})
       : /* The buffer is read-only, even if the internal multidimensional
            wrapper is not. If a write accessor is requested, there should
            be a copy on write. So this pointer should not be written and
@@ -119,7 +168,9 @@ class buffer
       ,
       /* Set copy_if_modified to true, so that if an accessor with write
          access is created, data are copied before to be modified. */
-      copy_if_modified { true } {}
+      copy_if_modified { true } {
+    use_allocator(a);
+  }
 
   /** Create a new buffer with associated memory, using the data in
       host_data
@@ -129,28 +180,77 @@ class buffer
       runtime to use the same pointer, a trisycl::mutex_class is
       used.
   */
-  buffer(shared_ptr_class<T>& host_data, const range<Dimensions>& r)
+  template <typename Allocator = buffer_allocator<typename mixin::value_type>>
+  buffer(shared_ptr_class<T>& host_data, const range<Dimensions>& r,
+         const Allocator& a = {})
       : mixin { host_data.get(), r }
       , input_shared_pointer { host_data }
-      , data_host { true } {}
+      , data_host { true } {
+    use_allocator(a);
+  }
 
   /// Create a new allocated 1D buffer from the given elements
-  template <typename Iterator>
-  buffer(Iterator start_iterator, Iterator end_iterator)
-      : mixin { allocate_buffer(std::distance(start_iterator, end_iterator)),
-                range<1> { static_cast<std::size_t>(
+  template <typename Iterator,
+            typename Allocator = buffer_allocator<typename mixin::value_type>>
+  buffer(Iterator start_iterator, Iterator end_iterator,
+         const Allocator& a = {})
+      : mixin { nullptr, range<1> { static_cast<std::size_t>(
                     std::distance(start_iterator, end_iterator)) } } {
+    use_allocator(a);
+    mixin::update(allocate_buffer(), mixin::get_range());
     assign(start_iterator, end_iterator);
   }
 
-  /** Create a new sub-buffer without allocation to have separate
-      accessors later
+  /** Create a sub-buffer aliasing a part of the storage of another
+      buffer, without any allocation or copy
 
-      \todo To implement and deal with reference counting
-  buffer(buffer<T, Dimensions> b,
-         index<Dimensions> base_index,
-         range<Dimensions> sub_range)
+      The sub-buffer has its own dependency tracking, so the kernels
+      on disjoint sub-buffers can run concurrently.
+
+      \param[in] parent is the buffer with the real data, which cannot
+      be a sub-buffer itself
+
+      \param[in] offset is the origin of the sub-buffer in the parent
+
+      \param[in] r is the size of the sub-buffer, which has to be
+      contiguous in the parent storage
   */
+  buffer(const std::shared_ptr<buffer>& parent,
+         const id<Dimensions>& offset,
+         const range<Dimensions>& r)
+      : detail::buffer_base { parent, sub_buffer_begin(*parent, offset, r),
+                              sub_buffer_begin(*parent, offset, r)
+                              + r.size() }
+      , mixin { parent->host_storage() + begin, r } {}
+
+  /** Create a reinterpreted view of the storage of another buffer with
+      another element type, without any allocation or copy
+
+      The view is a sub-buffer of the buffer owning the storage, so it
+      shares its coherence and dependency tracking.
+
+      \param[in] owner is the buffer owning the storage
+
+      \param[in] begin and \p end delimit the elements of \p owner
+      covered by the view
+
+      \param[in] offset is the offset in bytes of the view in the
+      storage of \p owner
+
+      \param[in] r is the range of the view, covering the same bytes
+  */
+  buffer(const std::shared_ptr<buffer_base>& owner,
+         std::size_t begin, std::size_t end, std::size_t offset,
+         const range<Dimensions>& r)
+      : detail::buffer_base { owner, begin, end }
+      , mixin { reinterpret_cast<typename mixin::pointer>(
+                  owner->host_bytes() + offset), r }
+      , view_offset { offset } {
+    if (reinterpret_cast<std::uintptr_t>(mixin::data()) % alignof(T))
+      throw trisycl::invalid_object_error {
+        "The reinterpreted buffer is not aligned for its element type"
+      };
+  }
 
   /// \todo Allow CLHPP objects too?
   ///
@@ -163,19 +263,25 @@ class buffer
   /** The buffer content may be copied back on destruction to some
       final location */
   ~buffer() {
+    auto write_back = modified && final_write_back;
 #ifdef TRISYCL_OPENCL
     /* We ensure that the host has the most up-to-date version of the data
        before the buffer is destroyed. This is necessary because we do not
        systematically transfer the data back from a device with
        \c copy_back_cl_buffer any more.
+
+       A buffer used only on the devices has no host memory to update.
        \todo Optimize for the case the buffer is not based on host memory
     */
-    call_update_buffer_state(host_context, access::mode::read,
-                             mixin::get_size(), mixin::data());
+    if (write_back || mixin::data())
+      call_update_buffer_state(host_context, access::mode::read,
+                               mixin::get_storage_size(), host_storage());
 
 #endif
-    if (modified && final_write_back)
+    if (write_back) {
+      host_storage();
       (*final_write_back)();
+    }
     // Allocate explicitly allocated memory if required
     deallocate_buffer();
   }
@@ -183,7 +289,113 @@ class buffer
   /** Enforce the buffer to be considered as being modified.
       Same as creating an accessor with write access.
    */
-  void mark_as_written() { modified = true; }
+  void mark_as_written() { mark_as_written(0, all); }
+
+  /** Consider the elements from \p first up to one before \p last as
+      modified, so they are the only ones written back
+  */
+  void mark_as_written(std::size_t first, std::size_t last) {
+    modified = true;
+    last = std::min(last, mixin::get_storage_count());
+    written.add(first*sizeof(T), last*sizeof(T));
+    // The parent storage is modified too
+    if (view_offset)
+      parent->mark_bytes_as_written(*view_offset + first*sizeof(T),
+                                    *view_offset + last*sizeof(T));
+    else if (parent)
+      std::static_pointer_cast<buffer>(parent)->mark_as_written(begin + first,
+                                                                begin + last);
+  }
+
+  /** Get the interval of linear positions covering the box of elements
+      of range \p r starting at \p offset
+  */
+  std::pair<std::size_t, std::size_t>
+  linear_window(const id<Dimensions>& offset,
+                const range<Dimensions>& r) const {
+    if (r.size() == 0)
+      return { 0, 0 };
+    auto whole = mixin::get_range();
+    // The storage is in row-major order, with some padded rows
+    whole[Dimensions - 1] = mixin::get_row_pitch();
+    std::size_t first = 0;
+    std::size_t last = 0;
+    for (int d = 0; d < Dimensions; ++d) {
+      first = first*whole[d] + offset[d];
+      last = last*whole[d] + offset[d] + r[d] - 1;
+    }
+    return { first, last + 1 };
+  }
+
+  /** Get the host memory of the buffer, allocating it if this is the
+      first time the host needs it
+  */
+  typename mixin::pointer host_storage() {
+    if (lazy_host_storage)
+      std::call_once(host_storage_allocated, [&] {
+        auto r = mixin::get_range();
+        mixin::update(allocate_buffer(), r);
+      });
+    return mixin::data();
+  }
+
+
+  /** Pad the rows of a buffer without initial data up to \p pitch
+      elements, or up to a pitch avoiding the cache aliasing of the
+      columns if \p pitch is 0
+
+      This has to be done before the storage is used and has no effect
+      on a buffer of 1 dimension or on a buffer using some memory
+      given at construction.
+  */
+  void set_row_pitch(std::size_t pitch) {
+    auto row = mixin::get_range()[Dimensions - 1];
+    if (pitch == 0)
+      pitch = padded_row_pitch(row, sizeof(T));
+    else if (pitch < row)
+      throw trisycl::invalid_object_error {
+        "The row pitch of a buffer cannot be smaller than its rows"
+      };
+    if (Dimensions > 1 && lazy_host_storage && !mixin::data())
+      mixin::set_row_pitch(pitch);
+  }
+
+
+  /** Take the storage from a slab of the storage plan \p p of a
+      recorded graph, if this is the first time the storage is needed
+
+      The buffer is then a temporary of the graph.
+  */
+  void use_graph_storage(detail::storage_plan &p) {
+    if (may_use_graph_storage)
+      std::call_once(host_storage_allocated, [&] {
+        auto r = mixin::get_range();
+        slab = p.acquire(mixin::get_storage_size());
+        mixin::update(static_cast<typename mixin::non_const_pointer>(
+                        slab->storage), r);
+      });
+  }
+
+
+  /** Give back the slab of a temporary of a recorded graph once the
+      user can no longer access the buffer, so the temporaries of the
+      next command groups of the recording can reuse it
+  */
+  void release_graph_storage() {
+    if (slab && !final_write_back)
+      if (auto p = slab->plan.lock())
+        p->release(slab);
+  }
+
+#ifdef TRISYCL_OPENCL
+  /// Get the host memory to write back a device copy to evict
+  void* host_memory() override {
+    if constexpr (std::is_const_v<T>)
+      return nullptr;
+    else
+      return host_storage();
+  }
+#endif
 
   /** This method is to be called whenever an accessor is created
 
@@ -192,13 +404,49 @@ class buffer
    */
   template <access::mode Mode,
             access::target Target = access::target::host_buffer>
-  void track_access_mode() {
+  void track_access_mode(std::size_t first = 0, std::size_t last = all) {
+    track_access(Target == access::target::host_buffer,
+                 Mode == access::mode::write
+                 || Mode == access::mode::read_write
+                 || Mode == access::mode::discard_write
+                 || Mode == access::mode::discard_read_write
+                 || Mode == access::mode::atomic,
+                 Mode == access::mode::discard_write
+                 || Mode == access::mode::discard_read_write,
+                 first, last);
+  }
+
+  /** Track an access to the elements from \p first up to one before
+      \p last, by the host if \p host, writing if \p write and
+      without reading the previous content if \p discard
+  */
+  void track_access(bool host, bool write, bool discard,
+                    std::size_t first, std::size_t last) {
+    last = std::min(last, mixin::get_storage_count());
+    if (view_offset) {
+      // The parent with the other element type tracks the same bytes
+      parent->track_bytes_access(host, write, discard,
+                                 *view_offset + first*sizeof(T),
+                                 *view_offset + last*sizeof(T));
+      mixin::update(reinterpret_cast<typename mixin::pointer>(
+                      parent->host_bytes() + *view_offset),
+                    mixin::get_range());
+    }
+    else if (parent) {
+      /* Writing through a sub-buffer modifies the parent, which may
+         have to do its copy-on-write first */
+      auto p = std::static_pointer_cast<buffer>(parent);
+      p->track_access(host, write, discard, begin + first, begin + last);
+      mixin::update(p->data() + begin, mixin::get_range());
+    }
+    // The host uses the memory directly
+    if (host)
+      host_storage();
     // test if write access is required
-    if (Mode == access::mode::write || Mode == access::mode::read_write ||
-        Mode == access::mode::discard_write ||
-        Mode == access::mode::discard_read_write ||
-        Mode == access::mode::atomic) {
+    if (write) {
       modified = true;
+      written.add(first*sizeof(T), last*sizeof(T));
+      version.fetch_add(1, std::memory_order_relaxed);
       if (copy_if_modified) {
         // Implement the allocate & copy-on-write optimization
         copy_if_modified = false;
@@ -207,13 +455,19 @@ class buffer
         /* The range is actually computed from \c access itself, so
            save it */
         auto current_range = mixin::get_range();
-        allocate_buffer(current_range);
+        allocate_buffer();
         /* Update the mixin accessor to point to the new allocated
            memory instead */
         mixin::update(allocation, current_range);
-        // Then copy the read-only data to the new allocated place
-        std::uninitialized_copy_n(current_access.data_handle(), mixin::get_count(),
-                                  mixin::data());
+        /* Then copy the read-only data to the new allocated place,
+           unless they are all discarded. The window of a ranged
+           accessor is only the interval enclosing its elements, so
+           the data are kept for any partial discard */
+        if (!discard || first != 0 || last < mixin::get_count())
+          in_parallel(mixin::get_count(), [&](auto b, auto n) {
+            std::uninitialized_copy_n(current_access.data_handle() + b, n,
+                                      allocation + b);
+          });
         /* Now the data of the buffer is no longer backed-up by host
            user provided memory */
         data_host = false;
@@ -221,6 +475,48 @@ class buffer
     }
   }
 
+  /// Get the host storage as bytes, for the reinterpreted views
+  std::byte* host_bytes() override {
+    return reinterpret_cast<std::byte*>(
+      const_cast<typename mixin::non_const_pointer>(host_storage()));
+  }
+
+  /** Track an access through a reinterpreted view to the elements
+      containing the bytes from \p first up to one before \p last
+
+      The previous content of an element only partly covered is kept.
+  */
+  void track_bytes_access(bool host, bool write, bool discard,
+                          std::size_t first, std::size_t last) override {
+    discard = discard && first % sizeof(T) == 0 && last % sizeof(T) == 0;
+    track_access(host, write, discard, first/sizeof(T),
+                 (last + sizeof(T) - 1)/sizeof(T));
+  }
+
+  /// Consider the elements containing some bytes as modified
+  void mark_bytes_as_written(std::size_t first, std::size_t last) override {
+    mark_as_written(first/sizeof(T), (last + sizeof(T) - 1)/sizeof(T));
+  }
+
+  /** Create a reinterpreted view of the elements of this buffer, with
+      the element type NewT and the range \p r covering the same bytes
+
+      A reinterpreted view of a sub-buffer or of another view is made
+      directly on the buffer owning the storage.
+
+      \return the new view, owned by the caller
+  */
+  template <typename NewT, int NewDimensions>
+  buffer<NewT, NewDimensions>* reinterpret(const range<NewDimensions>& r) {
+    if (mixin::is_padded())
+      throw trisycl::invalid_object_error {
+        "A buffer with padded rows cannot be reinterpreted"
+      };
+    return new buffer<NewT, NewDimensions> {
+      storage_owner(), begin, parent ? end : mixin::get_count(),
+      view_offset ? *view_offset : begin*sizeof(T), r };
+  }
+
   /** Set the weak pointer as destination for write-back on buffer
       destruction
   */
@@ -228,7 +524,7 @@ class buffer
     // Capture this by reference is enough since the buffer will still exist
     final_write_back = [this, final_data = std::move(final_data)] {
       if (auto sptr = final_data.lock()) {
-        std::copy_n(mixin::data(), mixin::get_count(), sptr.get());
+        write_back_to(sptr.get());
       }
     };
   }
@@ -250,33 +546,181 @@ class buffer
                        "const iterator is not allowed");*/
     // Capture this by reference is enough since the buffer will still exist
     final_write_back = [this, final_data = std::move(final_data)] {
-      std::copy_n(mixin::data(), mixin::get_count(), final_data);
+      if constexpr (std::random_access_iterator<Iterator>)
+        write_back_to(final_data);
+      else if (mixin::is_padded())
+        for (std::size_t r = 0; r != rows(); ++r)
+          final_data = std::copy_n(mixin::data() + r*mixin::get_row_pitch(),
+                                   row_length(), final_data);
+      else
+        std::copy_n(mixin::data(), mixin::get_count(), final_data);
     };
   }
 
  private:
-  /// Allocate uninitialized buffer memory
-  auto allocate_buffer(const range<Dimensions>& r) {
-    auto count = r.size();
+  /** Get the linear position of a sub-buffer in the storage of its
+      parent, after checking it is valid
+  */
+  static std::size_t sub_buffer_begin(const buffer& parent,
+                                      const id<Dimensions>& offset,
+                                      const range<Dimensions>& r) {
+    if (parent.parent)
+      throw trisycl::invalid_object_error {
+        "A sub-buffer cannot be created from another sub-buffer"
+      };
+    if (parent.is_padded())
+      throw trisycl::invalid_object_error {
+        "A sub-buffer cannot be created in a buffer with padded rows"
+      };
+    auto whole = parent.get_range();
+    for (int d = 0; d < Dimensions; ++d)
+      if (offset[d] + r[d] > whole[d])
+        throw trisycl::invalid_object_error {
+          "The sub-buffer exceeds the bounds of its parent buffer"
+        };
+    /* With the last dimension varying fastest, the elements are
+       contiguous when all the dimensions after the first one larger
+       than 1 are complete */
+    int d = 0;
+    while (d < Dimensions - 1 && r[d] == 1)
+      ++d;
+    for (++d; d < Dimensions; ++d)
+      if (r[d] != whole[d])
+        throw trisycl::invalid_object_error {
+          "A sub-buffer has to be contiguous in its parent buffer"
+        };
+    std::size_t begin = 0;
+    for (int i = 0; i < Dimensions; ++i)
+      begin = begin*whole[i] + offset[i];
+    return begin;
+  }
+
+  /** Erase the type of the allocator used by this buffer
+
+      The default allocator is replaced by the buffer pool when it is
+      enabled.
+  */
+  template <typename Allocator>
+  void use_allocator(const Allocator& a) {
+    if constexpr (std::is_same_v<Allocator, std::allocator<
+                                   typename Allocator::value_type>>)
+      if (vendor::trisycl::buffer_pool::instance().is_enabled()) {
+        use_allocator(vendor::trisycl::pooled_allocator<
+                        typename mixin::value_type> {});
+        return;
+      }
+    using traits = typename std::allocator_traits<Allocator>::template
+      rebind_traits<typename mixin::value_type>;
+    typename traits::allocator_type alloc { a };
+    allocate = [=](std::size_t n) mutable {
+      return traits::allocate(alloc, n);
+    };
+    deallocate = [=](typename mixin::non_const_pointer p,
+                     std::size_t n) mutable {
+      traits::deallocate(alloc, p, n);
+    };
+  }
+
+  /// Allocate uninitialized buffer memory, with the padding of the rows
+  auto allocate_buffer() {
+    auto count = mixin::get_storage_count();
     // Allocate uninitialized memory
-    allocation = alloc.allocate(count);
+    allocation = allocate(count);
+    // Put the pages on the nodes where the kernels will process them
+    if (auto where = detail::placement::global())
+      where->first_touch(allocation,
+                         count*sizeof(typename mixin::value_type));
     return allocation;
   }
 
+  /** Process some elements split into contiguous slices
+
+      The slices are processed by the OpenMP threads, as in a \c
+      parallel_for, so a large copy does not wait for a single thread.
+
+      \param[in] count is the number of elements
+
+      \param[in] f is called with the first element and the number of
+      elements of each slice
+  */
+  template <typename Slice>
+  static void in_parallel(std::size_t count, Slice&& f) {
+#ifdef _OPENMP
+    if (concurrency_governor::is_worth_parallelizing(count)) {
+      // Do not oversubscribe the cores with the running kernels
+      auto share = concurrency_governor::instance().acquire();
+#pragma omp parallel num_threads(share.get_threads())
+      {
+        std::size_t t = omp_get_thread_num();
+        std::size_t n = omp_get_num_threads();
+        auto begin = count*t/n;
+        f(begin, count*(t + 1)/n - begin);
+      }
+      return;
+    }
+#endif
+    f(std::size_t { 0 }, count);
+  }
+
+  /// Get the number of elements of a row, along the last dimension
+  std::size_t row_length() const {
+    return mixin::get_range()[Dimensions - 1];
+  }
+
+
+  /// Get the number of rows, across all the dimensions but the last one
+  std::size_t rows() const {
+    auto l = row_length();
+    return l ? mixin::get_count()/l : 0;
+  }
+
+
+  /// Copy the elements written in the buffer to the final data
+  template <typename Iterator>
+  void write_back_to(Iterator final_data) {
+    if (mixin::is_padded()) {
+      // The final data are dense, so copy all the rows
+      in_parallel(rows(), [&](auto b, auto n) {
+        for (auto r = b; r != b + n; ++r)
+          std::copy_n(mixin::data() + r*mixin::get_row_pitch(), row_length(),
+                      std::next(final_data, r*row_length()));
+      });
+      return;
+    }
+    for (auto [first, last] : written.get()) {
+      first /= sizeof(T);
+      last /= sizeof(T);
+      in_parallel(last - first, [&](auto b, auto n) {
+        std::copy_n(mixin::data() + first + b, n,
+                    std::next(final_data, first + b));
+      });
+    }
+  }
+
   /// Deallocate buffer memory if required
   void deallocate_buffer() {
     if (allocation)
-      alloc.deallocate(allocation, mixin::get_count());
+      deallocate(allocation, mixin::get_storage_count());
   }
 
   /** Assign the 1-D storage behind the accessor
 
       Use 2 different iterator types since in C++20 ranges it is now
       the case.
+
+      The elements from some random-access iterators are copied in
+      parallel, into the pages already placed on the NUMA nodes by
+      allocate_buffer().
   */
   template <typename StartIter, typename EndIter>
   void assign(StartIter start_iterator, EndIter end_iterator) {
-    std::copy(start_iterator, end_iterator, mixin::data());
+    if constexpr (std::random_access_iterator<StartIter>)
+      in_parallel(mixin::get_count(), [&](auto b, auto n) {
+        std::uninitialized_copy_n(std::next(start_iterator, b), n,
+                                  mixin::data() + b);
+      });
+    else
+      std::uninitialized_copy(start_iterator, end_iterator, mixin::data());
   }
 
   /** Function pair to work around the fact that T might be a \c const type.
@@ -309,7 +753,7 @@ class buffer
       wait for, otherwise an empty \c optional
       \todo Make the function private again
   */
-  boost::optional<std::future<void>> get_destructor_future() {
+  boost::optional<std::shared_future<void>> get_destructor_future() {
     /* If there is only 1 shared_ptr user of the buffer, this is the
        caller of this function, the \c buffer_waiter, so there is no
        need to get a \ future otherwise there will be a dead-lock if
@@ -320,13 +764,9 @@ class buffer
        so check for 1 + 1 use count instead...
     */
     // If the buffer's destruction triggers a write-back, wait
-    if ((shared_from_this().use_count() > 2) && modified &&
-        (final_write_back || data_host)) {
-      // Create a promise to wait for
-      notify_buffer_destructor = std::promise<void> {};
-      // And return the future to wait for it
-      return notify_buffer_destructor->get_future();
-    }
+    if (!detached && (shared_from_this().use_count() > 2) && modified &&
+        (final_write_back || data_host))
+      return get_destruction_future();
     return boost::none;
   }
 
@@ -350,8 +790,9 @@ class buffer
 template <typename BufferDetail>
 static std::shared_ptr<detail::task>
 buffer_add_to_task(BufferDetail buf, handler* command_group_handler,
-                   bool is_write_mode) {
-  return buf->add_to_task(command_group_handler, is_write_mode);
+                   bool is_write_mode, std::size_t first = 0,
+                   std::size_t last = std::numeric_limits<std::size_t>::max()) {
+  return buf->add_to_task(command_group_handler, is_write_mode, first, last);
 }
 
 /// @} End the data Doxygen group
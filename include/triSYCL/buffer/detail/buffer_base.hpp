@@ -16,15 +16,31 @@
 #endif
 // \todo Use C++17 optional when it is mainstream
 #include <boost/optional.hpp>
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "triSYCL/buffer/detail/coherence_directory.hpp"
+#include "triSYCL/buffer/detail/dirty_ranges.hpp"
+#include "triSYCL/command_group/detail/storage_plan.hpp"
 #include "triSYCL/command_group/detail/task.hpp"
 #include "triSYCL/context.hpp"
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/detail/timeline.hpp"
+#ifdef TRISYCL_OPENCL
+#include "triSYCL/vendor/triSYCL/data_transfers.hpp"
+#include "triSYCL/vendor/triSYCL/device_memory.hpp"
+#endif
 
 namespace trisycl {
 
@@ -42,24 +58,61 @@ struct buffer_base;
 inline static std::shared_ptr<detail::task>
 add_buffer_to_task(handler *command_group_handler,
                    std::shared_ptr<detail::buffer_base> b,
-                   bool is_write_mode);
+                   bool is_write_mode, std::size_t first, std::size_t last);
 
 /** Factorize some template independent buffer aspects in a base class
  */
 struct buffer_base : public std::enable_shared_from_this<buffer_base> {
 
-  //// Keep track of the number of kernel accessors using this buffer
-  std::atomic<size_t> number_of_users;
+  /** Keep track of the number of tasks using this buffer, which the
+      host accessors and the buffer destructor wait to reach 0
+  */
+  detail::task_counter number_of_users;
+
+  /// The end of the elements of a buffer, whatever its size
+  static constexpr auto all = std::numeric_limits<std::size_t>::max();
+
+  /** A task accessing the elements of the buffer from first up to one
+      before last
+  */
+  struct tracked_task {
+    std::weak_ptr<detail::task> task;
+    std::size_t first;
+    std::size_t last;
+
+    /// Test whether the access overlaps the elements [first, last)
+    bool overlaps(std::size_t first, std::size_t last) const {
+      return this->first < last && first < this->last;
+    }
+
+    /// Test whether the access is within the elements [first, last)
+    bool is_within(std::size_t first, std::size_t last) const {
+      return first <= this->first && this->last <= last;
+    }
+  };
+
+  /** Track the latest tasks to produce some parts of this buffer
+
+      Usually there is only one of them, but the tasks writing disjoint
+      parts through ranged accessors are all latest producers.
+  */
+  std::vector<tracked_task> producers;
+
+  /** Track the tasks reading this buffer since the latest producers of
+      the parts they read
 
-  /// Track the latest task to produce this buffer
-  std::weak_ptr<detail::task> latest_producer;
-  /// To protect the access to latest_producer
-  std::mutex latest_producer_mutex;
+      They can run concurrently, but the next producer of an
+      overlapping part has to wait for them
+  */
+  std::vector<tracked_task> readers;
+
+  /// To protect the access to producers and readers
+  detail::task_mutex latest_producer_mutex;
 
-  /// To signal when this buffer ready
-  std::condition_variable ready;
-  /// To protect the access to the condition variable
-  std::mutex ready_mutex;
+  /** The functions to call once the buffer is no longer in use,
+      protected by latest_producer_mutex
+  */
+  std::vector<std::function<void(void)>> unused_continuations;
 
   /** If the SYCL user buffer destructor is blocking, use this to
       block until this buffer implementation is destroyed.
@@ -68,151 +121,758 @@ struct buffer_base : public std::enable_shared_from_this<buffer_base> {
       waiting */
   boost::optional<std::promise<void>> notify_buffer_destructor;
 
-  /// To track contexts in which the data is up-to-date
-  std::unordered_set<trisycl::context> fresh_ctx;
+  /// The future of notify_buffer_destructor, shared by all the waiters
+  std::shared_future<void> destruction;
+
+  /// To create notify_buffer_destructor only once
+  std::once_flag destruction_requested;
+
+  /** Do not block the destruction of the last SYCL user buffer, which
+      leaves the write-back to the last task using this buffer
+  */
+  bool detached = false;
+
+  /** The buffer this sub-buffer is a part of, if any
+
+      A reinterpreted view is a sub-buffer of the buffer owning the
+      storage, even when it is created from another sub-buffer.
+  */
+  std::shared_ptr<buffer_base> parent;
+
+  /** The elements of the storage of the parent buffer covered by this
+      sub-buffer, from begin up to one before end
+
+      They are elements of the parent, also for a reinterpreted view
+      with another element type, so the overlaps between the
+      sub-buffers do not depend on their types.
+  */
+  std::size_t begin = 0;
+  std::size_t end = 0;
+
+  /// The sub-buffers of this buffer, protected by latest_producer_mutex
+  std::vector<std::weak_ptr<buffer_base>> sub_buffers;
+
+  /// To skip the dependencies through sub-buffers when there is none
+  std::atomic<bool> has_sub_buffers = false;
+
+  /** For a temporary buffer of a recorded task_graph, the slab of the
+      graph providing its storage
+  */
+  std::shared_ptr<detail::graph_slab> slab;
+
+  /** The bytes of the storage which may have been written since the
+      buffer creation, the other ones still having their initial value
+      everywhere
+  */
+  dirty_ranges written;
+
+  /** The version of the content of the buffer, bumped each time an
+      accessor which may write to it is created
+
+      Writing through a sub-buffer bumps also its parent, so the
+      version of the buffer owning the storage changes on any write
+      to it. This tells the memoized kernels whether their inputs and
+      outputs changed since their last execution.
+  */
+  std::atomic<std::uint64_t> version = 0;
 
 #ifdef TRISYCL_OPENCL
-  /** Buffer-side cache that keeps the \c boost::compute::buffer (and the
-      underlying \c cl_buffer ) so that if the buffer already exists inside
-      the same context it is not recreated.
+  /** To track the contexts in which the data is up-to-date, with the
+      buffer-side cache keeping the \c boost::compute::buffer (and the
+      underlying \c cl_buffer ) so that if the buffer already exists
+      inside the same context it is not recreated.
    */
-  std::unordered_map<trisycl::context, boost::compute::buffer> buffer_cache;
+  coherence_directory<trisycl::context, boost::compute::buffer> directory;
+
+  /** Whether the devices work directly in the host memory of the
+      buffer instead of in a copy of it
+
+      Then a transfer between the host and a device is just a mapping
+      and unmapping of the buffer, which is free on the integrated GPU
+      or on the FPGA shells with some memory coherent with the host.
+  */
+  bool zero_copy = false;
+#endif
+
+#ifdef TRISYCL_OPENCL
+  /** Get the host memory of the buffer, allocating it if needed, to
+      write back a device copy to evict
+
+      \return nullptr when the buffer cannot be written to
+  */
+  virtual void* host_memory() { return nullptr; }
 #endif
 
+
+  /** Get the host storage of this buffer as bytes, allocating it if
+      needed, for the reinterpreted views of it with another element
+      type
+  */
+  virtual std::byte* host_bytes() = 0;
+
+
+  /** Track an access through a reinterpreted view to the bytes from
+      \p first up to one before \p last of the storage of this buffer
+
+      \param[in] host is true for an access by the host
+
+      \param[in] write is true for an access which may write
+
+      \param[in] discard is true when the previous content is not read
+  */
+  virtual void track_bytes_access(bool host, bool write, bool discard,
+                                  std::size_t first, std::size_t last) = 0;
+
+
+  /** Consider the bytes from \p first up to one before \p last of the
+      storage as modified through a reinterpreted view
+  */
+  virtual void mark_bytes_as_written(std::size_t first,
+                                     std::size_t last) = 0;
+
+
   /** Create a buffer base and marks the host context as the context that
       holds the most recent version of the data
-      \todo Use lazy allocation for the context tracking set
+
+      \param[in] host_data is false when there is no data on the host
+      yet, so the devices do not need to get any
    */
-  buffer_base() : number_of_users { 0 },
-                  fresh_ctx { trisycl::context {} } {}
+  buffer_base(bool host_data = true) {
+#ifdef TRISYCL_OPENCL
+    if (host_data)
+      directory.share(trisycl::context {});
+#endif
+  }
+
+
+  /** Create a sub-buffer covering the elements from begin up to one
+      before end of the storage of a parent buffer
+  */
+  buffer_base(std::shared_ptr<buffer_base> parent,
+              std::size_t begin, std::size_t end)
+    : buffer_base {} {
+    this->parent = std::move(parent);
+    this->begin = begin;
+    this->end = end;
+  }
 
 
   /// The destructor waits for not being used anymore
   ~buffer_base() {
-    wait();
+    wait_for_users();
+#ifdef TRISYCL_OPENCL
+    directory.for_each_copy([&] (auto &ctx, auto &) {
+        vendor::trisycl::device_memory::instance().released(ctx, this);
+      });
+    vendor::trisycl::data_transfers::instance().forget(this);
+#endif
     // If there is the last SYCL user buffer waiting, notify it
     if (notify_buffer_destructor)
       notify_buffer_destructor->set_value();
   }
 
 
-  /// Wait for this buffer to be ready, which is no longer in use
-  void wait() {
-    std::unique_lock<std::mutex> ul { ready_mutex };
-    ready.wait(ul, [&] {
-        // When there is no producer for this buffer, we are ready to use it
-        return number_of_users == 0;
+  /** Get a future ready once this buffer is destroyed, after its
+      final write-back if any
+  */
+  std::shared_future<void> get_destruction_future() {
+    std::call_once(destruction_requested, [&] {
+        notify_buffer_destructor = std::promise<void> {};
+        destruction = notify_buffer_destructor->get_future().share();
       });
+    return destruction;
+  }
+
+
+  /// Wait for the tasks using this very buffer to end
+  void wait_for_users() {
+    // When there is no producer for this buffer, we are ready to use it
+    number_of_users.wait_for_zero();
+  }
+
+
+  /** Wait for this buffer to be ready, which is no longer in use,
+      neither through the buffers sharing some of its storage
+  */
+  void wait() {
+    wait_for_users();
+    for (auto &b : aliases())
+      b->wait_for_users();
+  }
+
+
+  /// Make a sub-buffer known by its parent buffer
+  void attach_to_parent() {
+    std::lock_guard<detail::task_mutex> lg { parent->latest_producer_mutex };
+    // Forget about the sub-buffers already destroyed
+    std::erase_if(parent->sub_buffers, [] (auto &b) { return b.expired(); });
+    parent->sub_buffers.push_back(weak_from_this());
+    parent->has_sub_buffers = true;
+  }
+
+
+  /// Get the buffer owning the storage, which is the parent of a sub-buffer
+  std::shared_ptr<buffer_base> storage_owner() {
+    return parent ? parent : shared_from_this();
+  }
+
+
+  /** Get the other buffers sharing some storage with this one
+
+      This is the sub-buffers of a buffer. For a sub-buffer, this is
+      its parent and its overlapping sibling sub-buffers.
+  */
+  std::vector<std::shared_ptr<buffer_base>> aliases() {
+    std::vector<std::shared_ptr<buffer_base>> related;
+    auto root = parent ? parent.get() : this;
+    if (parent)
+      related.push_back(parent);
+    std::lock_guard<detail::task_mutex> lg { root->latest_producer_mutex };
+    for (auto &w : root->sub_buffers)
+      if (auto b = w.lock();
+          b && b.get() != this
+          && (!parent || (b->begin < end && begin < b->end)))
+        related.push_back(std::move(b));
+    return related;
   }
 
 
   /// Mark this buffer in use by a task
   void use() {
     // Increment the use count
-    ++number_of_users;
+    number_of_users.increment();
   }
 
 
   /// A task has released the buffer
   void release() {
-    std::unique_lock<std::mutex> lock { ready_mutex };
-    if (--number_of_users == 0) {
-      // Micro-optimization: unlock before the notification
-      // https://en.cppreference.com/w/cpp/thread/condition_variable/notify_all
-      lock.unlock();
-      // Notify the host consumers or the buffer destructor that it is ready
-      ready.notify_all();
+    /* Notify the host consumers or the buffer destructor that it is
+       ready when it was the last user */
+    if (!number_of_users.decrement())
+      return;
+    decltype(unused_continuations) ready;
+    {
+      std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+      // Another task may have started to use the buffer meanwhile
+      if (number_of_users.load() == 0)
+        ready.swap(unused_continuations);
     }
+    for (auto &f : ready)
+      f();
   }
 
 
-  /// Return the latest producer for the buffer
-  std::shared_ptr<detail::task> get_latest_producer() {
-    std::lock_guard<std::mutex> lg { latest_producer_mutex };
-    // Return the valid shared_ptr to the task, if any
-    return latest_producer.lock();
+  /** Call \p f once this buffer is no longer in use, without waiting
+      for it
+
+      \p f is called right now if the buffer is not in use, otherwise
+      from the thread of the task releasing it last, so it should only
+      hand over some work.
+  */
+  void when_unused(std::function<void(void)> f) {
+    {
+      std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+      if (number_of_users.load() != 0) {
+        unused_continuations.push_back(std::move(f));
+        return;
+      }
+    }
+    f();
   }
 
 
-  /** Return the latest producer for the buffer and set another
-      future producer
+  /** Call \p f once this buffer is ready, as waited for by wait(),
+      without waiting for it
   */
-  std::shared_ptr<detail::task>
-  set_latest_producer(std::weak_ptr<detail::task> newer_latest_producer) {
-    std::lock_guard<std::mutex> lg { latest_producer_mutex };
-    using std::swap;
+  void when_ready(std::function<void(void)> f) {
+    auto buffers = aliases();
+    buffers.push_back(shared_from_this());
+    when_all_unused(std::move(buffers), std::move(f));
+  }
+
+
+  /// Call \p f once all the \p buffers are no longer in use
+  static void
+  when_all_unused(std::vector<std::shared_ptr<buffer_base>> buffers,
+                  std::function<void(void)> f) {
+    if (buffers.empty()) {
+      f();
+      return;
+    }
+    auto b = std::move(buffers.back());
+    buffers.pop_back();
+    b->when_unused([buffers = std::move(buffers), f = std::move(f)] {
+        when_all_unused(buffers, f);
+      });
+  }
+
+
+  /** Register a task reading the elements of the buffer from \p first
+      up to one before \p last
 
-    swap(newer_latest_producer, latest_producer);
-    // Return the valid shared_ptr to the previous producing task, if any
-    return newer_latest_producer.lock();
+      \param[in] reader is the task reading the buffer
+
+      \param[out] dependencies accumulates the latest producers of
+      these elements to wait for, which never includes the reader
+      itself
+  */
+  template <typename Tasks>
+  void add_reader(const std::shared_ptr<detail::task> &reader,
+                  Tasks &dependencies,
+                  std::size_t first = 0, std::size_t last = all) {
+    std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+    for (auto &p : producers)
+      if (p.overlaps(first, last))
+        if (auto t = p.task.lock(); t && t != reader)
+          dependencies.push_back(std::move(t));
+    // Forget about the readers already done to keep the list short
+    std::erase_if(readers, [] (auto &r) { return r.task.expired(); });
+    // Many accessors of the same task are registered only once
+    if (readers.empty() || readers.back().task.lock() != reader
+        || readers.back().first != first || readers.back().last != last)
+      readers.push_back({ reader, first, last });
+  }
+
+
+  /** Register a task writing the elements of the buffer from \p first
+      up to one before \p last
+
+      The writer becomes a latest producer and has to wait for the
+      previous producers (write after write) and for the readers since
+      then (write after read) of the overlapping elements.
+
+      \param[in] writer is the task writing the buffer
+
+      \param[out] dependencies accumulates the tasks to wait for,
+      which never includes the writer itself
+  */
+  template <typename Tasks>
+  void add_writer(const std::shared_ptr<detail::task> &writer,
+                  Tasks &dependencies,
+                  std::size_t first = 0, std::size_t last = all) {
+    std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+    auto add = [&] (auto &accesses) {
+      for (auto &a : accesses)
+        if (a.overlaps(first, last))
+          if (auto p = a.task.lock(); p && p != writer)
+            dependencies.push_back(std::move(p));
+      /* The accesses hidden by this writer are reached through it by
+         the next accesses */
+      std::erase_if(accesses, [&] (auto &a) {
+          return a.task.expired() || a.is_within(first, last);
+        });
+    };
+    add(producers);
+    add(readers);
+    producers.push_back({ writer, first, last });
+  }
+
+
+  /** Add the tasks accessing this buffer which conflict with an
+      access by another buffer sharing some storage, without
+      registering this access
+
+      \param[in] t is the task doing the access
+
+      \param[in] is_write_mode is true for a write access
+
+      \param[out] dependencies accumulates the tasks to wait for
+  */
+  template <typename Tasks>
+  void add_conflicts(const std::shared_ptr<detail::task> &t,
+                     bool is_write_mode,
+                     Tasks &dependencies) {
+    std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+    auto add = [&] (auto &a) {
+      if (auto p = a.task.lock(); p && p != t)
+        dependencies.push_back(std::move(p));
+    };
+    for (auto &p : producers)
+      add(p);
+    if (is_write_mode)
+      for (auto &r : readers)
+        add(r);
+  }
+
+
+  /** Forget a task done with this buffer
+
+      The next accesses do not have to wait for it, and the tracking
+      does not keep the memory of the task or of the other tasks
+      already destroyed.
+
+      \param[in] t is the task, still alive
+  */
+  void forget_task(const detail::task *t) {
+    std::lock_guard<detail::task_mutex> lg { latest_producer_mutex };
+    auto done = [&] (auto &a) {
+      auto p = a.task.lock();
+      return !p || p.get() == t;
+    };
+    std::erase_if(producers, done);
+    std::erase_if(readers, done);
+  }
+
+
+  /** Register a task accessing the buffer
+
+      The task also waits for the conflicting accesses through the
+      buffers sharing some storage with this one, so kernels on
+      disjoint sub-buffers run concurrently while the parent buffer
+      waits for all of them.
+
+      \param[in] t is the task doing the access
+
+      \param[in] is_write_mode is true for a write access
+
+      \param[out] dependencies accumulates the tasks to wait for,
+      which never includes the task itself
+
+      \param[in] first and \p last delimit the elements accessed, so
+      the tasks accessing disjoint parts through ranged accessors do
+      not depend on each other
+  */
+  template <typename Tasks>
+  void add_access(const std::shared_ptr<detail::task> &t,
+                  bool is_write_mode,
+                  Tasks &dependencies,
+                  std::size_t first = 0, std::size_t last = all) {
+    if (is_write_mode)
+      add_writer(t, dependencies, first, last);
+    else
+      add_reader(t, dependencies, first, last);
+    // The accesses through the aliases conflict with the whole buffer
+    if (parent || has_sub_buffers)
+      for (auto &b : aliases())
+        b->add_conflicts(t, is_write_mode, dependencies);
   }
 
 
-  /// Add a buffer to the task running the command group
+  /** Add a buffer to the task running the command group, accessing
+      its elements from \p first up to one before \p last
+  */
   std::shared_ptr<detail::task>
-  add_to_task(handler *command_group_handler, bool is_write_mode) {
+  add_to_task(handler *command_group_handler, bool is_write_mode,
+              std::size_t first = 0, std::size_t last = all) {
     return add_buffer_to_task(command_group_handler,
                               shared_from_this(),
-                              is_write_mode);
+                              is_write_mode, first, last);
   }
 
 
 #ifdef TRISYCL_OPENCL
+  /** Account for a transfer of \p bytes started at \p start
+
+      \param[in] ctx is the device context involved
+  */
+  void transferred(vendor::trisycl::data_transfers::direction d,
+                   const trisycl::context& ctx, std::size_t bytes,
+                   std::chrono::steady_clock::time_point start) {
+    TRISYCL_DUMP_T("buffer " << this << ' '
+                   << vendor::trisycl::data_transfers::name(d) << ' '
+                   << bytes << " bytes");
+    vendor::trisycl::data_transfers::instance().record(
+      d, ctx, this, bytes, std::chrono::steady_clock::now() - start);
+  }
+
+
+  /** Account for a transfer of \p bytes into \p ctx skipped since it
+      has the most recent data already
+
+      It is not accounted when no device has a copy of the buffer,
+      since no transfer could happen anyway.
+  */
+  void transfer_avoided(const trisycl::context& ctx, std::size_t bytes) {
+    if (!directory.has_copies())
+      return;
+    TRISYCL_DUMP_T("buffer " << this << " transfer avoided " << bytes
+                   << " bytes");
+    vendor::trisycl::data_transfers::instance().avoided(ctx, this, bytes);
+  }
+
+
   /// Check if the data of this buffer is up-to-date in a certain context
   bool is_data_up_to_date(const trisycl::context& ctx) {
-    return fresh_ctx.count(ctx);
+    return directory.is_fresh(ctx);
   }
 
 
   /// Check if the buffer is already cached for a certain context
   bool is_cached(const trisycl::context& ctx) {
-    return buffer_cache.count(ctx);
+    return directory.has_copy(ctx);
   }
 
 
   /** Create a \c boost::compute::buffer for this \c trisycl::buffer in the
       cache and associate it with a given context
+
+      In zero-copy mode, the buffer uses the host memory \p data, if any.
   */
   void create_in_cache(const trisycl::context& ctx, size_t size,
                        cl_mem_flags flags, void* data) {
-    buffer_cache[ctx] = boost::compute::buffer
-      { ctx.get_boost_compute(),
-        size,
-        flags,
-        data
-      };
+    if (zero_copy && data)
+      flags |= CL_MEM_USE_HOST_PTR;
+    // Without any host memory allocated yet there is nothing to copy
+    if (!data)
+      flags &= ~CL_MEM_COPY_HOST_PTR;
+    auto uses_data = flags & (CL_MEM_COPY_HOST_PTR | CL_MEM_USE_HOST_PTR);
+    auto &accounting = vendor::trisycl::device_memory::instance();
+    // Make room in the device memory budget for this buffer
+    accounting.reserve(ctx, size, this);
+    auto start = std::chrono::steady_clock::now();
+    directory.set_copy(ctx, boost::compute::buffer
+                       { ctx.get_boost_compute(),
+                         size,
+                         flags,
+                         uses_data ? data : nullptr
+                       });
+    // The creation copies the host data into the device
+    if ((flags & CL_MEM_COPY_HOST_PTR) && !(flags & CL_MEM_USE_HOST_PTR))
+      transferred(vendor::trisycl::data_transfers::direction::host_to_device,
+                  ctx, size, start);
+    /* Only keep a weak reference so that the accounting does not
+       keep the buffer alive */
+    accounting.allocated(ctx, this, size, [ctx, w = weak_from_this()] {
+        auto b = w.lock();
+        return b && b->evict_from_cache(ctx);
+      });
+  }
+
+
+  /** Evict the copy of the buffer in a context, to make room in its
+      memory
+
+      The copy holding the only fresh data is written back to the host
+      first.
+
+      \return false if the buffer is in use, so the copy is kept
+  */
+  bool evict_from_cache(const trisycl::context& ctx) {
+    if (number_of_users.load() != 0 || !is_cached(ctx))
+      return false;
+    if (directory.is_only_fresh(ctx)) {
+      auto data = host_memory();
+      if (!data)
+        return false;
+      sync_with_host(directory.copy(ctx).size(), data);
+    }
+    directory.forget(ctx);
+    vendor::trisycl::device_memory::instance().released(ctx, this);
+    return true;
+  }
+
+
+  /** Test whether the buffer of a context works directly in the host
+      memory \p data
+  */
+  bool uses_host_memory(const trisycl::context& ctx, void* data) {
+    return zero_copy && data && is_cached(ctx)
+      && directory.copy(ctx).get_info<void*>(CL_MEM_HOST_PTR) == data;
+  }
+
+
+  /** Map and unmap some bytes of the buffer of a context working in
+      the host memory, which makes coherent the host and the device
+      without any copy
+
+      \param[in] flags is CL_MAP_READ to get the device writes on the
+      host or CL_MAP_WRITE to give the host writes to the device
+
+      \return the event of the unmapping
+  */
+  boost::compute::event map_unmap(const trisycl::context& ctx,
+                                  cl_map_flags flags,
+                                  std::size_t first, std::size_t last) {
+    // The reads back to the host do not wait for the other transfers
+    auto q = flags == CL_MAP_READ ? ctx.get_boost_read_queue()
+                                  : ctx.get_boost_queue();
+    auto &b = directory.copy(ctx);
+    boost::compute::event mapped;
+    auto p = q.enqueue_map_buffer_async(b, flags, first, last - first,
+                                        mapped);
+    return q.enqueue_unmap_buffer(b, p, boost::compute::wait_list { mapped });
+  }
+
+
+  /** Find a device context holding the most recent data while the
+      host does not, so that another device can get them directly
+      from it
+  */
+  boost::optional<trisycl::context> fresh_device_context() {
+    // In zero-copy mode the host memory is where the devices work
+    if (zero_copy || is_data_up_to_date(trisycl::context {}))
+      return {};
+    return directory.find_fresh([] (auto &c) { return !c.is_host(); });
+  }
+
+
+  /** Copy the bytes from \p first up to one before \p last of the
+      buffer of device context \p src into the buffer of device
+      context \p ctx, creating it if needed, without going through
+      the host storage
+
+      Inside the same OpenCL context this is a copy on the device
+      side. Otherwise the source is mapped and written directly from
+      the mapping into the target, which avoids the copy into the host
+      storage and keeps the host data stale.
+
+      \param[out] transfers accumulates the event of the copy inside
+      the same OpenCL context, or if it is nullptr the copy is waited
+      for
+  */
+  void copy_between_devices(const trisycl::context& src,
+                            const trisycl::context& ctx, std::size_t size,
+                            std::size_t first, std::size_t last,
+                            boost::compute::wait_list* transfers) {
+    TRISYCL_TIMELINE_SCOPE("transfer", "device to device");
+    if (!is_cached(ctx))
+      create_in_cache(ctx, size, CL_MEM_READ_WRITE, nullptr);
+    if (first == last)
+      return;
+    auto start = std::chrono::steady_clock::now();
+    auto q = ctx.get_boost_queue();
+    if (src.get_boost_compute() == ctx.get_boost_compute()) {
+      auto e = q.enqueue_copy_buffer(directory.copy(src),
+                                     directory.copy(ctx),
+                                     first, first, last - first);
+      if (transfers)
+        transfers->insert(e);
+      else
+        e.wait();
+    }
+    else {
+      auto src_q = src.get_boost_queue();
+      auto &b = directory.copy(src);
+      auto p = src_q.enqueue_map_buffer(b, CL_MAP_READ, first, last - first);
+      // The mapping has to live up to the end of the write
+      q.enqueue_write_buffer(directory.copy(ctx), first, last - first, p);
+      src_q.enqueue_unmap_buffer(b, p).wait();
+    }
+    transferred(vendor::trisycl::data_transfers::direction::device_to_device,
+                ctx, last - first, start);
+  }
+
+
+  /** Test whether an access in a context needs the data to go through
+      the host memory
+  */
+  bool needs_host_data(const trisycl::context& ctx, access::mode mode) {
+    // In zero-copy mode the devices work in the host memory anyway
+    if (zero_copy)
+      return true;
+    // A device can get the data directly from another device
+    if (!ctx.is_host() && fresh_device_context())
+      return false;
+    return mode != access::mode::discard_write
+      && mode != access::mode::discard_read_write
+      && directory.any_fresh() && !is_data_up_to_date(ctx);
   }
 
 
   /** Transfer the most up-to-date version of the data to the host
       if the host version is not already up-to-date
+
+      This waits for the transfers since the host data are then used
+      by the transfers to another context, which cannot have the
+      events of this one in their wait list.
   */
   void sync_with_host(std::size_t size, void* data) {
+    TRISYCL_TIMELINE_SCOPE("transfer", "device to host");
     trisycl::context host_context;
-    if (!is_data_up_to_date(host_context) && !fresh_ctx.empty()) {
-      /* We know that the context(s) in \c fresh_ctx hold the most recent
-         version of the buffer
+    if (!is_data_up_to_date(host_context) && directory.any_fresh()) {
+      /* We know that the fresh context(s) of the directory hold the
+         most recent version of the buffer
       */
-      auto fresh_context = *(fresh_ctx.begin());
-      auto fresh_q = fresh_context.get_boost_queue();
-      fresh_q.enqueue_read_buffer(buffer_cache[fresh_context], 0, size, data);
-      fresh_ctx.insert(host_context);
+      auto fresh_context = *directory.find_fresh([] (auto &) {
+          return true;
+        });
+      auto fresh_q = fresh_context.get_boost_read_queue();
+      auto zero = uses_host_memory(fresh_context, data);
+      auto start = std::chrono::steady_clock::now();
+      std::size_t bytes = 0;
+      /* Outside of the written bytes, the host has the same data as
+         the device, so only transfer the written ones, all at once */
+      std::vector<boost::compute::event> transfers;
+      for (auto [first, last] : written.get()) {
+        bytes += std::min(last, size) - first;
+        transfers.push_back(zero
+                            ? map_unmap(fresh_context, CL_MAP_READ, first,
+                                        std::min(last, size))
+                            : fresh_q.enqueue_read_buffer_async(
+                                directory.copy(fresh_context), first,
+                                std::min(last, size) - first,
+                                static_cast<char*>(data) + first));
+      }
+      for (auto &e : transfers)
+        e.wait();
+      transferred(vendor::trisycl::data_transfers::direction::device_to_host,
+                  fresh_context, bytes, start);
+      directory.share(host_context);
     }
   }
 
 
+  /** Copy the bytes of the host data from \p first up to one before
+      \p last into the buffer of a device context, creating it if
+      needed
+
+      \param[out] transfers accumulates the event of the copy, which
+      is not waited for, or if it is nullptr the copy is waited for
+  */
+  void write_to_cache(const trisycl::context& ctx, std::size_t size,
+                      std::size_t first, std::size_t last, void* data,
+                      boost::compute::wait_list* transfers) {
+    TRISYCL_TIMELINE_SCOPE("transfer", "host to device");
+    /* In zero-copy mode, a buffer created on the host memory holds
+       the host data, but after a copy on write of the host memory it
+       has to be created again */
+    if (!is_cached(ctx) || (zero_copy && !uses_host_memory(ctx, data))) {
+      create_in_cache(ctx, size, CL_MEM_READ_WRITE, data);
+      if (uses_host_memory(ctx, data))
+        return;
+    }
+    // Without any host memory allocated yet there is nothing to copy
+    if (!data || first == last)
+      return;
+    auto start = std::chrono::steady_clock::now();
+    auto e = uses_host_memory(ctx, data)
+      ? map_unmap(ctx, CL_MAP_WRITE, first, last)
+      : ctx.get_boost_queue().enqueue_write_buffer_async(
+          directory.copy(ctx), first, last - first,
+          static_cast<char*>(data) + first);
+    if (transfers)
+      transfers->insert(e);
+    else
+      e.wait();
+    transferred(vendor::trisycl::data_transfers::direction::host_to_device,
+                ctx, last - first, start);
+  }
+
+
   /** When a transfer is requested this function is called, it will
       update the state of the buffer according to the context in which
       the accessor is created and the access mode
+
+      The transfers to a device do not block: the kernel waits for
+      them through its wait list instead, so the host thread can
+      already upload the inputs of the next kernels.
+
+      \param[in] first and \p last delimit the bytes accessed through a
+      ranged accessor, which are the only ones to transfer when the
+      device keeps the rest of the buffer from a previous use
+
+      \param[out] transfers accumulates the events of the transfers to
+      wait for before using the buffer on the target context, or if it
+      is nullptr the transfers are waited for here
   */
   void update_buffer_state(const trisycl::context& target_ctx,
-                           access::mode mode, std::size_t size, void* data) {
-    /* The \c cl_buffer we put in the cache might get accessed again in the
-       future, this means that we have to always to create it in read/write
-       mode to be able to write to it if it is accessed through a
-       write accessor in the future
-     */
-    auto constexpr flag = CL_MEM_READ_WRITE;
+                           access::mode mode, std::size_t size, void* data,
+                           std::size_t first = 0, std::size_t last = all,
+                           boost::compute::wait_list* transfers = nullptr) {
+    TRISYCL_TIMELINE_SCOPE("transfer", "update buffer state");
+    last = std::min(last, size);
+    if (!target_ctx.is_host())
+      vendor::trisycl::device_memory::instance().used(target_ctx, this);
 
     /* The buffer is accessed in read mode, we want to transfer the data only if
        necessary. We start a transfer if the data on the target context is not
@@ -220,32 +880,40 @@ struct buffer_base : public std::enable_shared_from_this<buffer_base> {
      */
     if (mode == access::mode::read) {
 
-      if (is_data_up_to_date(target_ctx))
+      if (is_data_up_to_date(target_ctx)) {
         // If read mode and the data is up-to-date there is nothing to do
+        transfer_avoided(target_ctx, last - first);
         return;
+      }
 
       // The data is not up-to-date, we need a transfer
-      // We also want to be sure that the host holds the most recent data
-      sync_with_host(size, data);
+      auto src = target_ctx.is_host() ? boost::none : fresh_device_context();
+      // Otherwise we want to be sure that the host holds the most recent data
+      if (!src)
+        sync_with_host(size, data);
 
       if (!target_ctx.is_host()) {
-        // If the target context is a device context
-        if (!is_cached(target_ctx)) {
-          /* If not cached, we create the buffer and copy the data
-             at the same time
-          */
-          create_in_cache(target_ctx, size,
-                          (flag | CL_MEM_COPY_HOST_PTR), data);
-          fresh_ctx.insert(target_ctx);
+        if (is_cached(target_ctx) && (first != 0 || last != size)) {
+          // The part may still be valid from a previous ranged access
+          if (directory.is_valid(target_ctx, first, last)) {
+            transfer_avoided(target_ctx, last - first);
+            return;
+          }
+          /* Only the accessed part is transferred, so the rest of the
+             device buffer is still stale and the context is not fresh */
+          if (src)
+            copy_between_devices(*src, target_ctx, size, first, last,
+                                 transfers);
+          else
+            write_to_cache(target_ctx, size, first, last, data, transfers);
+          directory.validate(target_ctx, first, last, size);
           return;
         }
-
-        /* Else we transfer the data to the existing buffer associated
-           with the target context buffer
-        */
-        auto q = target_ctx.get_boost_queue();
-        q.enqueue_write_buffer(buffer_cache[target_ctx], 0, size, data);
-        fresh_ctx.insert(target_ctx);
+        if (src)
+          copy_between_devices(*src, target_ctx, size, 0, size, transfers);
+        else
+          write_to_cache(target_ctx, size, 0, size, data, transfers);
+        directory.share(target_ctx);
       }
       return;
     }
@@ -264,21 +932,17 @@ struct buffer_base : public std::enable_shared_from_this<buffer_base> {
       if (   mode == access::mode::read_write
           || mode == access::mode::write
           || mode == access::mode::atomic) {
-        // If the data is not up-to-date in the target context
-        // We want to host to be up-to-date
-        sync_with_host(size, data);
-
-        if (!target_ctx.is_host()) {
-          // If the target context is a device context
-          if (!is_cached(target_ctx)) {
-            create_in_cache(target_ctx, size,
-                            (flag | CL_MEM_COPY_HOST_PTR), data);
-          }
-          else {
-            // We update the buffer associated with the target context
-            auto q = target_ctx.get_boost_queue();
-            q.enqueue_write_buffer(buffer_cache[target_ctx], 0, size, data);
-          }
+        /* Even for a ranged accessor the whole buffer is transferred
+           since the target becomes the only fresh context */
+        if (auto src = target_ctx.is_host() ? boost::none
+                                            : fresh_device_context())
+          copy_between_devices(*src, target_ctx, size, 0, size, transfers);
+        else {
+          // If the data is not up-to-date in the target context
+          // We want to host to be up-to-date
+          sync_with_host(size, data);
+          if (!target_ctx.is_host())
+            write_to_cache(target_ctx, size, 0, size, data, transfers);
         }
       }
 
@@ -290,27 +954,25 @@ struct buffer_base : public std::enable_shared_from_this<buffer_base> {
         /* We only need to create the buffer if it doesn't exist
            but without copying any data because of the discard mode
         */
-        if (!target_ctx.is_host() && !is_cached(target_ctx)) {
-          // If the context doesn't exist we create it.
-          /* We don't want to transfer any data so we don't
-             add \c CL_MEM_COPY_HOST_PTR
-          */
-          create_in_cache(target_ctx, size, flag, 0);
-        }
+        if (!target_ctx.is_host() && !is_cached(target_ctx))
+          create_in_cache(target_ctx, size, CL_MEM_READ_WRITE, data);
       }
     }
+    else if (mode != access::mode::discard_write
+             && mode != access::mode::discard_read_write)
+      // The whole buffer would have been transferred otherwise
+      transfer_avoided(target_ctx, size);
     /* Here we are sure that we are in some kind of write mode,
        we indicate that all contexts except the target context
        are not up-to-date anymore
     */
-    fresh_ctx.clear();
-    fresh_ctx.insert(target_ctx);
+    directory.own(target_ctx);
   }
 
 
   /// Returns the cl_buffer for a given context.
   boost::compute::buffer get_cl_buffer(const trisycl::context& context) {
-    return buffer_cache[context];
+    return directory.copy(context);
   }
 
 #endif
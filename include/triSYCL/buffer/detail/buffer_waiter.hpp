@@ -66,6 +66,9 @@ public:
       f->wait();
       TRISYCL_DUMP_T("~buffer_waiter() is done");
     }
+    else
+      // A temporary of a recording lends its storage to the next ones
+      implementation->release_graph_storage();
   }
 };
 
@@ -0,0 +1,288 @@
+#ifndef TRISYCL_SYCL_BUFFER_DETAIL_COHERENCE_DIRECTORY_HPP
+#define TRISYCL_SYCL_BUFFER_DETAIL_COHERENCE_DIRECTORY_HPP
+
+/** \file Track where the data of a buffer are up-to-date
+
+    A buffer is used by the host and usually by one or two devices, so
+    the state of the buffer in each context is kept in a small table
+    inside the buffer, searched linearly by context without hashing
+    nor allocation.
+
+    Each context is in a state inspired by the MSI protocol:
+
+    - modified: it is the only context holding the most recent data;
+
+    - shared: it holds the most recent data as some other contexts;
+
+    - invalid: its copy, if any, is stale, except maybe for some
+      intervals transferred for some ranged accessors, which are still
+      valid up to the next write in another context.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** The state of the data of a buffer in each context, with the copy
+    of the buffer in the context
+
+    \param Context is the type of the contexts, compared with ==
+
+    \param Copy is the type of the copy of the buffer in a context
+*/
+template <typename Context, typename Copy>
+class coherence_directory {
+
+public:
+
+  /// The state of the data in a context
+  enum class state : std::uint8_t {
+    invalid,
+    shared,
+    modified
+  };
+
+private:
+
+  /// The bytes of a stale copy which are still valid
+  using intervals =
+    boost::container::small_vector<std::pair<std::size_t, std::size_t>, 1>;
+
+  /// What is known about a context
+  struct entry {
+    Context context;
+    state s = state::invalid;
+    /// The valid bytes of an invalid copy, sorted and disjoint
+    intervals valid {};
+    std::optional<Copy> copy {};
+  };
+
+  /// Usually the host and a device
+  boost::container::small_vector<entry, 2> entries;
+
+
+  /// Find the entry of context \p c, if any
+  entry *find(const Context &c) {
+    auto e = std::find_if(entries.begin(), entries.end(),
+                          [&] (auto &e) { return e.context == c; });
+    return e == entries.end() ? nullptr : &*e;
+  }
+
+
+  const entry *find(const Context &c) const {
+    return const_cast<coherence_directory *>(this)->find(c);
+  }
+
+
+  /// Get the entry of context \p c, creating it if needed
+  entry &get(const Context &c) {
+    if (auto e = find(c))
+      return *e;
+    return entries.emplace_back(entry { c });
+  }
+
+
+  /** Restore the invariant that a context is modified if and only if
+      it is the only one holding the most recent data
+  */
+  void normalize() {
+    auto fresh = std::count_if(entries.begin(), entries.end(),
+                               [] (auto &e) {
+                                 return e.s != state::invalid;
+                               });
+    for (auto &e : entries)
+      if (e.s != state::invalid)
+        e.s = fresh == 1 ? state::modified : state::shared;
+  }
+
+
+  /// Remove the entries without any information
+  void prune() {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [] (auto &e) {
+                                   return e.s == state::invalid && !e.copy;
+                                 }),
+                  entries.end());
+  }
+
+public:
+
+  /// Get the state of the data in context \p c
+  state get_state(const Context &c) const {
+    auto e = find(c);
+    return e ? e->s : state::invalid;
+  }
+
+
+  /// Test whether context \p c holds the most recent data
+  bool is_fresh(const Context &c) const {
+    return get_state(c) != state::invalid;
+  }
+
+
+  /// Test whether context \p c is the only one holding the most recent data
+  bool is_only_fresh(const Context &c) const {
+    return get_state(c) == state::modified;
+  }
+
+
+  /// Test whether some context holds the most recent data
+  bool any_fresh() const {
+    return std::any_of(entries.begin(), entries.end(), [] (auto &e) {
+        return e.s != state::invalid;
+      });
+  }
+
+
+  /// Find a context holding the most recent data and satisfying \p pred
+  template <typename Predicate>
+  boost::optional<Context> find_fresh(Predicate pred) const {
+    for (auto &e : entries)
+      if (e.s != state::invalid && pred(e.context))
+        return e.context;
+    return {};
+  }
+
+
+  /** Test whether the bytes from \p first up to one before \p last
+      are up-to-date in context \p c
+  */
+  bool is_valid(const Context &c, std::size_t first,
+                std::size_t last) const {
+    auto e = find(c);
+    if (!e)
+      return false;
+    if (e->s != state::invalid || first >= last)
+      return true;
+    return std::any_of(e->valid.begin(), e->valid.end(), [&] (auto &i) {
+        return i.first <= first && last <= i.second;
+      });
+  }
+
+
+  /// Record that context \p c also holds the most recent data now
+  void share(const Context &c) {
+    auto &e = get(c);
+    e.s = state::shared;
+    e.valid.clear();
+    normalize();
+  }
+
+
+  /** Record that context \p c holds the most recent data, all the
+      other contexts being stale, as after a write in \p c
+  */
+  void own(const Context &c) {
+    get(c);
+    for (auto &e : entries) {
+      e.s = e.context == c ? state::modified : state::invalid;
+      e.valid.clear();
+    }
+    prune();
+  }
+
+
+  /** Record that the bytes from \p first up to one before \p last of
+      the whole \p size bytes are up-to-date in context \p c
+
+      The context becomes fresh once all its bytes are valid.
+  */
+  void validate(const Context &c, std::size_t first, std::size_t last,
+                std::size_t size) {
+    auto &e = get(c);
+    if (e.s != state::invalid || first >= last)
+      return;
+    // Merge the intervals overlapping or touching [first, last)
+    auto &v = e.valid;
+    auto i = std::find_if(v.begin(), v.end(),
+                          [&] (auto &i) { return first <= i.second; });
+    auto j = i;
+    while (j != v.end() && j->first <= last) {
+      first = std::min(first, j->first);
+      last = std::max(last, j->second);
+      ++j;
+    }
+    i = v.erase(i, j);
+    v.insert(i, { first, last });
+    if (first == 0 && last >= size)
+      share(c);
+  }
+
+
+  /// Test whether context \p c has a copy of the buffer
+  bool has_copy(const Context &c) const {
+    auto e = find(c);
+    return e && e->copy;
+  }
+
+
+  /// Test whether some context has a copy of the buffer
+  bool has_copies() const {
+    return std::any_of(entries.begin(), entries.end(),
+                       [] (auto &e) { return bool { e.copy }; });
+  }
+
+
+  /// Get the copy of the buffer in context \p c, creating it if needed
+  Copy &copy(const Context &c) {
+    auto &e = get(c);
+    if (!e.copy)
+      e.copy.emplace();
+    return *e.copy;
+  }
+
+
+  /// Set the copy of the buffer in context \p c
+  void set_copy(const Context &c, Copy copy) {
+    get(c).copy = std::move(copy);
+  }
+
+
+  /** Forget about context \p c and its copy, for example when it is
+      evicted
+  */
+  void forget(const Context &c) {
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                 [&] (auto &e) { return e.context == c; }),
+                  entries.end());
+    normalize();
+  }
+
+
+  /// Call \p f with each context having a copy and its copy
+  template <typename F>
+  void for_each_copy(F f) {
+    for (auto &e : entries)
+      if (e.copy)
+        f(e.context, *e.copy);
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_BUFFER_DETAIL_COHERENCE_DIRECTORY_HPP
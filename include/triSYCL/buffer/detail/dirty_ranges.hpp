@@ -0,0 +1,104 @@
+#ifndef TRISYCL_SYCL_BUFFER_DETAIL_DIRTY_RANGES_HPP
+#define TRISYCL_SYCL_BUFFER_DETAIL_DIRTY_RANGES_HPP
+
+/** \file Track the elements written in a buffer
+
+    The written elements are kept as a sorted list of disjoint
+    intervals of linear positions in the buffer storage, so that the
+    write-back and the transfers to the host can skip the elements
+    which have not changed.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/// The intervals of elements written in a buffer
+class dirty_ranges {
+
+  /// The sorted disjoint and non-adjacent intervals [first, last)
+  std::vector<std::pair<std::size_t, std::size_t>> intervals;
+
+  /// To protect the intervals from concurrent accessor creations
+  mutable std::mutex m;
+
+public:
+
+  /// Mark the elements from \p first up to one before \p last as written
+  void add(std::size_t first, std::size_t last) {
+    if (first >= last)
+      return;
+    std::lock_guard lg { m };
+    // The first interval ending at or after first, which may be merged
+    auto i = std::lower_bound(intervals.begin(), intervals.end(), first,
+                              [] (auto &interval, auto position) {
+                                return interval.second < position;
+                              });
+    // Merge all the intervals overlapping or touching [first, last)
+    auto j = i;
+    while (j != intervals.end() && j->first <= last) {
+      first = std::min(first, j->first);
+      last = std::max(last, j->second);
+      ++j;
+    }
+    i = intervals.erase(i, j);
+    intervals.insert(i, { first, last });
+  }
+
+
+  /// Test whether nothing has been written
+  bool empty() const {
+    std::lock_guard lg { m };
+    return intervals.empty();
+  }
+
+
+  /// Get the total number of written elements
+  std::size_t count() const {
+    std::lock_guard lg { m };
+    std::size_t c = 0;
+    for (auto [first, last] : intervals)
+      c += last - first;
+    return c;
+  }
+
+
+  /// Get a copy of the written intervals, in increasing order
+  std::vector<std::pair<std::size_t, std::size_t>> get() const {
+    std::lock_guard lg { m };
+    return intervals;
+  }
+
+
+  /// Forget about the written elements
+  void clear() {
+    std::lock_guard lg { m };
+    intervals.clear();
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_BUFFER_DETAIL_DIRTY_RANGES_HPP
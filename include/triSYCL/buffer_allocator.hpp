@@ -12,6 +12,8 @@
 #include <cstddef>
 #include <memory>
 
+#include "triSYCL/vendor/triSYCL/allocator.hpp"
+
 namespace trisycl {
 
 /** \addtogroup data Data access and storage in SYCL
@@ -0,0 +1,122 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_DATAFLOW_WINDOW_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_DATAFLOW_WINDOW_HPP
+
+/** \file Gather the kernels connected by pipes to schedule them together
+
+    Kernels connected by blocking pipes have to run at the same time,
+    otherwise a producer waits forever for a consumer which cannot
+    start. In the dataflow mode of a queue, the execution of a task
+    using some pipes is held in a window until every pipe used by the
+    held tasks has both a writer and a reader among them. Then the
+    connected tasks are submitted at once as a gang to the executor,
+    which runs them concurrently.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The use of a pipe by a task
+struct pipe_end {
+  /// The pipe implementation, only used as an identity
+  const void *pipe;
+
+  /// Whether the task writes to the pipe, otherwise it reads from it
+  bool is_write;
+};
+
+
+/// The tasks connected by pipes waiting for the rest of their gang
+class dataflow_window : public detail::debug<dataflow_window> {
+
+  /// A pipe used by the gang
+  struct connection {
+    const void *pipe;
+    bool has_writer;
+    bool has_reader;
+  };
+
+  /// The executions of the held tasks, in submission order
+  std::vector<std::function<void(void)>> gang;
+
+  /// The pipes used by the held tasks
+  std::vector<connection> connections;
+
+  /// To protect the window
+  detail::task_mutex m;
+
+  /// Test whether every pipe used by the gang has both of its ends
+  bool closed() const {
+    return std::all_of(connections.begin(), connections.end(),
+                       [] (auto &c) { return c.has_writer && c.has_reader; });
+  }
+
+public:
+
+  /** Hold the execution \p f of a task using some pipes
+
+      \param[in] ends are the pipes used by the task
+
+      \return the whole gang to submit at once if the task completes
+      it, otherwise nothing
+  */
+  template <typename PipeEnds>
+  std::vector<std::function<void(void)>>
+  add(std::function<void(void)> f, const PipeEnds &ends) {
+    std::lock_guard<detail::task_mutex> lg { m };
+    gang.push_back(std::move(f));
+    for (auto &e : ends) {
+      auto c = std::find_if(connections.begin(), connections.end(),
+                            [&] (auto &k) { return k.pipe == e.pipe; });
+      if (c == connections.end())
+        c = connections.insert(c, connection { e.pipe, false, false });
+      (e.is_write ? c->has_writer : c->has_reader) = true;
+    }
+    if (!closed())
+      return {};
+    TRISYCL_DUMP_T("Dataflow gang of " << gang.size() << " tasks complete");
+    connections.clear();
+    return std::exchange(gang, {});
+  }
+
+
+  /** Take the held tasks even if their gang is not complete, to have
+      them running when someone waits for them
+  */
+  std::vector<std::function<void(void)>> flush() {
+    std::lock_guard<detail::task_mutex> lg { m };
+    connections.clear();
+    return std::exchange(gang, {});
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_DATAFLOW_WINDOW_HPP
@@ -0,0 +1,106 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_FUSION_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_FUSION_HPP
+
+/** \file Fusion of consecutive element-wise parallel_for kernels
+
+    On a queue with the fuse_kernels property, a 1D parallel_for
+    kernel with the same range as the latest fusable kernel of the
+    queue and depending only on it is appended to it instead of being
+    scheduled on its own, as long as this batch of kernels has not
+    started. The batch is executed by chunks small enough to stay in
+    cache, running all its kernels on a chunk before the next one, so
+    the data are streamed only once from memory.
+
+    This is only correct for element-wise kernels, where a work-item
+    of a kernel only uses the data produced by the same work-item of
+    the previous kernels, which is why it is opt-in.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/item.hpp"
+#include "triSYCL/range.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The kernels fused into a batch
+struct fused_kernels {
+  /// The number of work-items of a chunk executed by all the kernels
+  static constexpr std::size_t chunk_size = 4096;
+
+  /// The type of a kernel executing the work-items of a chunk
+  using stage = std::function<void(std::size_t, std::size_t)>;
+
+  /// The iteration space shared by all the kernels
+  range<1> r;
+
+  /// The fused kernels in submission order
+  std::vector<stage> stages;
+
+
+  /// Start a batch on an iteration space
+  fused_kernels(range<1> r) : r { r } {}
+
+
+  /// Make a stage from a kernel functor taking an id<1> or an item<1>
+  template <typename ParallelForFunctor>
+  static stage make_stage(range<1> r, ParallelForFunctor f) {
+    return [r, f = std::move(f)] (std::size_t begin,
+                                  std::size_t end) mutable {
+      for (auto i = begin; i != end; ++i)
+        if constexpr (std::is_invocable_v<ParallelForFunctor &, id<1>>)
+          f(id<1> { i });
+        else
+          f(item<1> { r, id<1> { i } });
+    };
+  }
+
+
+  /// Execute all the kernels chunk by chunk
+  void run() {
+    auto n = r.get(0);
+    std::ptrdiff_t chunks = (n + chunk_size - 1)/chunk_size;
+#ifdef _OPENMP
+    // Do not oversubscribe the cores with the other running kernels
+    auto share = concurrency_governor::instance().acquire();
+#pragma omp parallel for num_threads(share.get_threads())
+#endif
+    for (std::ptrdiff_t c = 0; c < chunks; ++c) {
+      std::size_t begin = c*chunk_size;
+      std::size_t end = std::min(n, begin + chunk_size);
+      for (auto &s : stages)
+        s(begin, end);
+    }
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_FUSION_HPP
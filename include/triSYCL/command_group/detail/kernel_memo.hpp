@@ -0,0 +1,126 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_MEMO_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_MEMO_HPP
+
+/** \file Remember the buffer contents produced by the memoized kernels
+
+    A kernel asked to be memoized through handler::memoize() is
+    skipped when the same kernel already ran with the same scalars and
+    the same number of work-items, and when none of the buffers it
+    accesses has been written since. Then its outputs still hold what
+    it would compute again.
+
+    The content of a buffer is identified by its version, bumped each
+    time an accessor which may write to it is created.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+struct buffer_base;
+
+/// The buffer contents produced by the latest execution of each memoized kernel
+class kernel_memo {
+
+public:
+
+  /// The version of the content of a buffer used by a kernel
+  struct buffer_version {
+    std::weak_ptr<buffer_base> buffer;
+    std::uint64_t version;
+  };
+
+  /// The versions of the buffers used by a kernel, in access order
+  using versions = std::vector<buffer_version>;
+
+  /** A kernel identified by its type, the bytes of its scalars and
+      its number of work-items
+  */
+  using key = std::pair<std::type_index, std::string>;
+
+private:
+
+  /// The buffer versions left by the latest execution of each kernel
+  std::map<key, versions> entries;
+
+  /// To protect entries
+  std::mutex m;
+
+public:
+
+  /// Get the memo shared by all the queues
+  static kernel_memo &instance() {
+    static kernel_memo memo;
+    return memo;
+  }
+
+
+  /** Test whether the kernel \p k last ran on the same buffers as
+      \p before, which have not been written since
+
+      \param[in] before is the versions of the buffers before the
+      command group to run, without the bumps of its own accessors
+  */
+  bool is_up_to_date(const key &k, const versions &before) {
+    std::lock_guard lg { m };
+    auto e = entries.find(k);
+    if (e == entries.end())
+      return false;
+    auto same = [] (const buffer_version &a, const buffer_version &b) {
+      // A buffer destroyed since then is not the same as a new one
+      return !a.buffer.expired()
+        && !a.buffer.owner_before(b.buffer) && !b.buffer.owner_before(a.buffer)
+        && a.version == b.version;
+    };
+    return std::ranges::equal(e->second, before, same);
+  }
+
+
+  /** Remember the versions of the buffers \p after an execution of
+      the kernel \p k
+
+      The entries on some destroyed buffers are forgotten at the same
+      time, since they can never be reused.
+  */
+  void record(const key &k, versions after) {
+    std::lock_guard lg { m };
+    std::erase_if(entries, [] (const auto &e) {
+        return std::ranges::any_of(e.second, [] (const auto &v) {
+            return v.buffer.expired();
+          });
+      });
+    entries.insert_or_assign(k, std::move(after));
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_KERNEL_MEMO_HPP
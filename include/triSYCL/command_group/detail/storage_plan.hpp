@@ -0,0 +1,172 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_STORAGE_PLAN_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_STORAGE_PLAN_HPP
+
+/** \file The planning of the storage of the temporary buffers of a
+    recorded task_graph
+
+    A buffer without initial data whose storage is first needed by a
+    recorded command group takes it from a slab of the graph. Once
+    the buffer is no longer reachable by the user, its slab can be
+    reused by the temporary buffers first accessed by the next
+    recorded command groups, since nothing can access the former
+    temporary anymore. The graph then orders the accesses to the
+    successive temporaries of a slab like the accesses to a single
+    buffer.
+
+    So the intermediate buffers of a recording, declared in the scope
+    of the command groups using them, share a few slabs instead of
+    having each their own allocation.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+class storage_plan;
+
+/** Some storage shared by the temporary buffers of a recorded graph
+    whose lifetimes do not overlap
+
+    It is kept alive by the buffers using it and by its storage_plan
+    while it is free.
+*/
+struct graph_slab {
+  /// The alignment of the storage
+  static constexpr std::size_t alignment = 64;
+
+  /// The storage itself
+  void *storage;
+
+  /// The number of bytes of the storage
+  std::size_t size;
+
+  /// The plan to give back the slab to
+  std::weak_ptr<storage_plan> plan;
+
+  /** The number of command groups recorded when the slab was given
+      back, the ones up to it may still access its former temporary
+  */
+  std::size_t released_after = 0;
+
+
+  /// Allocate the storage of a slab of \p size bytes
+  graph_slab(std::size_t size, std::weak_ptr<storage_plan> plan)
+    : storage { ::operator new(size, std::align_val_t { alignment }) }
+    , size { size }
+    , plan { std::move(plan) } {}
+
+
+  graph_slab(const graph_slab &) = delete;
+
+
+  ~graph_slab() {
+    ::operator delete(storage, std::align_val_t { alignment });
+  }
+};
+
+
+/// The slabs of the temporary buffers of a recorded graph
+class storage_plan : public std::enable_shared_from_this<storage_plan> {
+
+  /// To protect all the members
+  mutable std::mutex m;
+
+  /// The slabs no longer used by a temporary buffer
+  std::vector<std::shared_ptr<graph_slab>> free_slabs;
+
+  /// The number of command groups recorded so far
+  std::size_t recorded = 0;
+
+  /// The number of bytes asked by the temporary buffers
+  std::size_t requested = 0;
+
+  /// The number of bytes of all the slabs
+  std::size_t allocated = 0;
+
+public:
+
+  /// Count a new recorded command group
+  void add_command_group() {
+    std::lock_guard lg { m };
+    ++recorded;
+  }
+
+
+  /** Get a slab of at least \p bytes bytes for a temporary buffer
+      first accessed by the command group being recorded
+
+      \return the smallest free slab large enough, or a new one
+  */
+  std::shared_ptr<graph_slab> acquire(std::size_t bytes) {
+    // Keep the slabs aligned after each other for the cache lines
+    bytes = (bytes + graph_slab::alignment - 1)
+            /graph_slab::alignment*graph_slab::alignment;
+    std::lock_guard lg { m };
+    requested += bytes;
+    auto best = free_slabs.end();
+    for (auto s = free_slabs.begin(); s != free_slabs.end(); ++s)
+      /* A slab given back during the recording of the current command
+         group may still be used by it */
+      if ((*s)->size >= bytes && (*s)->released_after < recorded
+          && (best == free_slabs.end() || (*s)->size < (*best)->size))
+        best = s;
+    if (best != free_slabs.end()) {
+      auto s = std::move(*best);
+      free_slabs.erase(best);
+      return s;
+    }
+    allocated += bytes;
+    return std::make_shared<graph_slab>(bytes, weak_from_this());
+  }
+
+
+  /// Give back a slab whose temporary buffer is no longer reachable
+  void release(std::shared_ptr<graph_slab> s) {
+    std::lock_guard lg { m };
+    s->released_after = recorded;
+    free_slabs.push_back(std::move(s));
+  }
+
+
+  /// Get the number of bytes asked by the temporary buffers
+  std::size_t requested_bytes() const {
+    std::lock_guard lg { m };
+    return requested;
+  }
+
+
+  /// Get the number of bytes of the slabs actually allocated
+  std::size_t allocated_bytes() const {
+    std::lock_guard lg { m };
+    return allocated;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_STORAGE_PLAN_HPP
@@ -9,21 +9,43 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <mutex>
-#include <thread>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
+
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
 #endif
 
 #include "triSYCL/accessor/detail/accessor_base.hpp"
 #include "triSYCL/buffer/detail/buffer_base.hpp"
+#include "triSYCL/command_group/detail/dataflow_window.hpp"
+#include "triSYCL/command_group/detail/kernel_fusion.hpp"
+#include "triSYCL/command_group/detail/kernel_memo.hpp"
 #include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/detail/timeline.hpp"
+#include "triSYCL/detail/unique_function.hpp"
 #include "triSYCL/kernel.hpp"
 #include "triSYCL/queue/detail/queue.hpp"
+#include "triSYCL/vendor/triSYCL/pipe/detail/cout_sink.hpp"
 
 namespace trisycl::detail {
 
@@ -35,69 +57,305 @@ namespace trisycl::detail {
 struct task : public std::enable_shared_from_this<task>,
               public detail::debug<task> {
 
+  /** The number of buffers and producers a task can have without
+      heap allocation
+  */
+  static constexpr std::size_t inline_capacity = 4;
+
   /** List of the buffers used by this task
 
       \todo Use a set to check that some buffers are not used many
       times at least on writing
   */
-  std::vector<std::shared_ptr<detail::buffer_base>> buffers_in_use;
+  boost::container::small_vector<std::shared_ptr<detail::buffer_base>,
+                                 inline_capacity> buffers_in_use;
+
+  /// Whether each buffer in use is accessed in a write mode
+  boost::container::small_vector<bool, inline_capacity> writes_in_use;
+
+  /// The buffers read by the accessors of this task
+  boost::container::small_vector<detail::buffer_base *,
+                                 inline_capacity> reads_in_use;
 
   /// The tasks producing the buffers used by this task
-  std::vector<std::shared_ptr<detail::task>> producer_tasks;
+  boost::container::small_vector<std::shared_ptr<detail::task>,
+                                 inline_capacity> producer_tasks;
+
+  /// The pipes used by this task, to schedule it with its peers
+  boost::container::small_vector<detail::pipe_end,
+                                 inline_capacity> pipe_ends;
 
   /// Keep track of any prologue to be executed before the kernel
-  std::vector<std::function<void(void)>> prologues;
+  detail::task_graph::functions prologues;
 
   /// Keep track of any epilogue to be executed after the kernel
-  std::vector<std::function<void(void)>> epilogues;
+  detail::task_graph::functions epilogues;
+
+  /** The kernel to execute
+
+      It is kept in the task so the execution submitted to the
+      executor only captures a plain pointer to the task, which fits
+      in the small buffer of a std::function without heap allocation.
+      The kernel itself is moved in without any copy and stored
+      inline for the usual captures.
+  */
+  detail::unique_function<void(void)> kernel_code;
+
+  /// Keep this task alive while its execution is pending
+  std::shared_ptr<detail::task> self;
 
-  /// Store if the execution ended, to be notified by task_ready
+  /// Store if the execution ended, protected by ready_mutex
   bool execution_ended = false;
 
-  /// To signal when this task is ready
-  std::condition_variable ready;
+  /// Set when the execution ended, for the tasks and events waiting for it
+  detail::task_flag completion;
+
+  /** The consumer tasks to notify at the end of this one, protected by
+      ready_mutex
+  */
+  std::vector<std::shared_ptr<detail::task>> consumers;
+
+  /** The number of producers this task still waits for before being
+      submitted to the executor, plus 1 while it registers to them
+  */
+  std::atomic<std::size_t> pending_producers = 0;
+
+  /// The execution submitted once the producers are done
+  std::function<void(void)> pending_execution;
 
-  /// To protect the access to the condition variable
-  std::mutex ready_mutex;
+  /** The expected duration of the kernel in nanoseconds, from the
+      kernel statistics, or 1 to just count the tasks along a path
+  */
+  std::uint64_t cost_estimate = 1;
+
+  /** The estimated duration of the longest path through the consumers
+      of this task known so far, to rank it once ready
+  */
+  std::atomic<std::uint64_t> downstream_path = 0;
+
+  /** The producers this task waits for, to lengthen their path with
+      the one of this task, protected by ready_mutex
+  */
+  boost::container::small_vector<std::weak_ptr<detail::task>,
+                                 inline_capacity> upstream;
+
+  /** Whether the kernel has started, after waiting for the producers,
+      protected by ready_mutex like execution_ended
+  */
+  bool execution_started = false;
+
+  /** Whether the execution of this task is submitted, so it can be
+      waited for through an event
+  */
+  bool scheduled = false;
+
+  /// To protect the state of the execution
+  detail::task_mutex ready_mutex;
 
   /** Keep track of the queue used to submission to notify kernel completion
       or to run OpenCL kernels on */
   std::shared_ptr<detail::queue> owner_queue;
 
+  /// The graph recording this task instead of executing it, if any
+  std::shared_ptr<detail::task_graph> recording;
+
+  /// The node of this task in the recording graph
+  std::size_t recorded_node = 0;
+
+  /** Whether this task is submitted to an in-order queue and only
+      waits for the tasks of the other queues
+  */
+  bool in_order;
+
+  /** Whether this task runs on the submitting thread when it has no
+      pending producer, to avoid handing it over to a worker
+  */
+  bool latency_critical = false;
+
+  /** The partitioning asked through the handler for the kernel of
+      this task, instead of the one of its queue
+  */
+  std::optional<detail::partitioning> partition;
+
+  /** The bytes of the scalars the kernel of this task depends on when
+      it is memoized, to skip it when it would compute the same outputs
+  */
+  std::optional<std::string> memo_scalars;
+
+  /// The kernels executed by this task when it starts a batch of fused kernels
+  std::unique_ptr<detail::fused_kernels> fused;
+
+  /** The tasks whose kernel is fused or coalesced into this one, to
+      be completed by it
+  */
+  std::vector<std::shared_ptr<detail::task>> fused_tasks;
+
+  /// The task executing the kernel of this one, if fused or coalesced
+  detail::task *fused_into = nullptr;
+
+  /** The number of bytes of local memory used by the local accessors
+      of the command group in each work-group
+  */
+  std::size_t local_memory_size = 0;
+
+  /** The number of bytes accessed by the kernel according to the
+      ranges and the modes of its accessors, for the kernel statistics
+  */
+  std::uint64_t accessed_bytes = 0;
+
   /// The OpenCL-compatible kernel run by this task, if any
   std::shared_ptr<detail::kernel> kernel;
 
+#ifdef TRISYCL_OPENCL
+  /// The transfers of the buffers the OpenCL kernel has to wait for
+  boost::compute::wait_list transfers;
+
+  /** The event of the OpenCL kernel run by this task once enqueued,
+      if any, protected by ready_mutex
+  */
+  boost::compute::event kernel_event;
+
+  /** To signal the enqueuing of the OpenCL kernel or the end of the
+      task to the consumer kernels chained on the device
+  */
+  detail::task_condition_variable ready;
+#endif
+
+  /** Whether the timestamps of the execution are recorded, as asked by
+      the queue at the creation of the task
+  */
+  bool profiling;
+
+  /** The timestamps in nanoseconds of the submission, the start and
+      the end of the execution
+
+      They are always recorded for the latency histograms of the
+      queue. The start and the end are protected by ready_mutex.
+  */
+  cl_ulong submit_time = 0;
+  cl_ulong start_time = 0;
+  cl_ulong end_time = 0;
+
   /** The accessors indexed by their creation order
 
       This is used to relate a kernel parameter of a kernel generated
       by the device compiler to its accessor. */
   std::vector<std::weak_ptr<detail::accessor_base>> accessors;
 
+  /** The scalar kernel arguments packed into a single argument, at
+      the offsets of their structure chosen by the device compiler */
+  std::vector<std::byte> packed_args;
+
+  /** The number of tasks alive in the program, to check that the
+      completed tasks are released
+  */
+  static inline std::atomic<std::size_t> live_tasks = 0;
+
 
   /// Create a task from a submitting queue
   task(const std::shared_ptr<detail::queue> &q)
-    : owner_queue { q } {}
+    : owner_queue { q }
+    , recording { q->recording }
+    , in_order { q->is_in_order() }
+    , profiling { q->is_profiling() } {
+    live_tasks.fetch_add(1, std::memory_order_relaxed);
+    if (recording)
+      recorded_node = recording->add_node();
+    submit_time = now();
+  }
+
+
+  ~task() {
+    live_tasks.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+
+  /// Get the number of tasks alive in the program
+  static std::size_t live_count() {
+    return live_tasks.load(std::memory_order_relaxed);
+  }
+
+
+  /// The time in nanoseconds of the steady clock used for profiling
+  static cl_ulong now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+
+  /** Get the partitioning of the kernel of this task, starting from
+      the one of its queue, to change it for this task only
+  */
+  detail::partitioning &get_partitioning() {
+    if (!partition)
+      partition = owner_queue->get_partitioning();
+    return *partition;
+  }
+
+
+  /** Execute the kernel \p k, keeping the exception it may throw for
+      the async_handler of the queue
+
+      The exception would terminate the program in a worker thread.
+      There is no promise to allocate for each task: the try block
+      costs nothing as long as nothing is thrown, and the exception
+      is only stored when there is one.
+  */
+  void run_kernel(detail::unique_function<void(void)> &k) {
+    try {
+      k();
+    } catch (...) {
+      TRISYCL_DUMP_T("The kernel of task " << this << " threw");
+      owner_queue->add_async_error(std::current_exception());
+    }
+  }
 
 
   /// Add a new task to the task graph and schedule for execution
-  void schedule(std::function<void(void)> f) {
-    /* To keep a copy of the task shared_ptr after the end of the
-       command group, capture it by copy in the following lambda.
-    */
-    auto execution = [f = std::move(f), task = shared_from_this()] {
+  void schedule(detail::unique_function<void(void)> f) {
+    if (recording) {
+      // Just keep the kernel for later replays
+      recording->set_kernel(recorded_node, std::move(f),
+                            std::move(prologues), std::move(epilogues));
+      /* The kernel may own this task, so break the ownership cycle
+         with the graph */
+      recording.reset();
+      return;
+    }
+    TRISYCL_TIMELINE_SCOPE("task", "schedule");
+    kernel_code = std::move(f);
+    scheduled = true;
+    /* To keep the task alive after the end of the command group, it
+       owns itself up to the end of the following lambda */
+    self = shared_from_this();
+    auto execution = [task = this] {
+      auto keep_alive = std::move(task->self);
       // Wait for the required tasks to be ready
       task->wait_for_producers();
+      task->notify_start();
       task->prelude();
       TRISYCL_DUMP_T("Execute the kernel");
-      // Execute the kernel
-      f();
-      task->postlude();
-      // Release the buffers that have been written by this task
-      task->release_buffers();
-      // Notify the waiting tasks that we are done
-      task->notify_consumers();
-      // Notify the queue we are done
-      task->owner_queue->kernel_end();
+      // Execute the kernel with its own chunking or the one of its queue
+      partitioning::current() = task->partition
+        ? &*task->partition : &task->owner_queue->get_partitioning();
+      {
+        TRISYCL_TIMELINE_SCOPE("task", "execution");
+        task->run_kernel(task->kernel_code);
+      }
+      partitioning::current() = nullptr;
+      // Display the debug output of the kernel before its completion
+      vendor::trisycl::pipe::detail::end_of_kernel();
+      /* Free the kernel which may own this task and some accessors
+         owning buffers preventing the command group to complete */
+      task->kernel_code = nullptr;
+#ifdef TRISYCL_OPENCL
+      if (task->kernel_event.get()) {
+        // The OpenCL kernel may still be running on its device
+        task->complete_after_kernel(std::move(keep_alive));
+        return;
+      }
+#endif
+      task->complete(std::move(keep_alive));
       TRISYCL_DUMP_T("Task thread exit");
     };
     /* Notify the queue that there is a kernel submitted to the
@@ -106,19 +364,24 @@ struct task : public std::enable_shared_from_this<task>,
        thread, the queue may have finished before the thread is
        scheduled */
     owner_queue->kernel_start();
-    /* \todo it may be implementable with packaged_task that would
-       deal with exceptions in kernels
-    */
 #ifndef TRISYCL_NO_ASYNC
-    /* If in asynchronous execution mode, execute the functor in a new
-       thread */
-    std::thread thread(execution);
-    TRISYCL_DUMP_T("Task thread started");
-    /** Detach the thread since it will synchronize by its own means
-
-        \todo This is an issue if there is an exception in the kernel
+    /* If in asynchronous execution mode, execute the functor on the
+       executor of the queue, as a worker thread or as a fiber with
+       TRISYCL_FIBER_TASKS, which synchronizes by its own means
     */
-    thread.detach();
+    if (!pipe_ends.empty())
+      /* The tasks connected by pipes have to start together, so they
+         wait for their producers on their executor */
+      owner_queue->execute_connected(std::move(execution), pipe_ends);
+    else if (in_order)
+      if (producer_tasks.empty() && runs_inline())
+        execution();
+      else
+        // Keep the submission order of the queue
+        owner_queue->execute(std::move(execution));
+    else
+      execute_after_producers(std::move(execution));
+    TRISYCL_DUMP_T("Task submitted to the worker pool");
 #else
     // Just a synchronous execution otherwise
     execution();
@@ -126,11 +389,453 @@ struct task : public std::enable_shared_from_this<task>,
   }
 
 
-  /// Wait for the required producer tasks to be ready
+  /** Submit the execution of this task once its producers are done
+
+      Instead of blocking a worker on each producer, this task is
+      registered as a consumer of its producers and the last one to
+      complete submits the execution to the executor. The producers
+      this task can only wait for on the device stay in producer_tasks
+      for wait_for_producers().
+
+      The executor serves first the ready tasks with the longest
+      estimated path of tasks after them, so the critical path of the
+      task graph does not wait behind some independent tasks.
+  */
+  void execute_after_producers(std::function<void(void)> e) {
+    pending_execution = std::move(e);
+    // The producers cannot submit the execution before the end of this
+    pending_producers.store(1, std::memory_order_relaxed);
+    auto consumer = shared_from_this();
+    producer_tasks.erase(
+      std::remove_if(producer_tasks.begin(), producer_tasks.end(),
+                     [&] (auto &p) { return p->add_consumer(consumer); }),
+      producer_tasks.end());
+    if (pending_producers.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      // The last producer to complete submits the execution
+      return;
+    auto execution = std::move(pending_execution);
+    forget_producers();
+    if (producer_tasks.empty() && runs_inline())
+      execution();
+    else
+      owner_queue->execute(std::move(execution), path());
+  }
+
+
+  /** Get the estimated duration of the longest path of tasks starting
+      with this one, to run the critical path of the task graph first
+  */
+  std::uint64_t path() const {
+    return cost_estimate + downstream_path.load(std::memory_order_relaxed);
+  }
+
+
+  /** Lengthen to \p path the longest path through the consumers of
+      this task and then the ones of its producers still pending
+
+      The tasks are submitted in the program order, so the path of a
+      task only grows with the consumers submitted while it waits for
+      its producers. A path which is not lengthened stops the
+      propagation, so it is amortized over the submissions.
+  */
+  void lengthen_path(std::uint64_t path) {
+    std::vector<std::pair<std::shared_ptr<detail::task>, std::uint64_t>>
+      work;
+    auto lengthen = [&] (detail::task &t, std::uint64_t path) {
+      auto d = t.downstream_path.load(std::memory_order_relaxed);
+      while (d < path)
+        if (t.downstream_path.compare_exchange_weak(
+              d, path, std::memory_order_relaxed)) {
+          std::lock_guard<detail::task_mutex> lg { t.ready_mutex };
+          for (auto &w : t.upstream)
+            if (auto p = w.lock())
+              work.emplace_back(std::move(p), t.cost_estimate + path);
+          return;
+        }
+    };
+    lengthen(*this, path);
+    while (!work.empty()) {
+      // Keep the producer alive while lengthening its path
+      auto [p, l] = std::move(work.back());
+      work.pop_back();
+      lengthen(*p, l);
+    }
+  }
+
+
+  /** Test whether the execution of this task, ready at its
+      submission, runs right now on the submitting thread
+
+      This is the case for a latency-critical task or when the queue
+      asks for it while it is idle, but not for a task starting a
+      batch of fused kernels, which has to wait for the next kernels.
+  */
+  bool runs_inline() const {
+    return !fused && owner_queue->runs_inline(latency_critical);
+  }
+
+
+  /** Register a \p consumer task to notify at the end of this one
+
+      \return false if the consumer has to wait for this task in
+      wait_for_producers() instead
+  */
+  bool add_consumer(const std::shared_ptr<detail::task> &consumer) {
+#ifdef TRISYCL_OPENCL
+    if (can_chain_on_device(*consumer))
+      return false;
+#endif
+    // This task may be held waiting for the rest of its dataflow gang
+    owner_queue->flush_dataflow();
+    {
+      std::lock_guard<detail::task_mutex> lg { ready_mutex };
+      if (execution_ended)
+        return true;
+      consumer->pending_producers.fetch_add(1, std::memory_order_relaxed);
+      consumers.push_back(consumer);
+    }
+    {
+      std::lock_guard<detail::task_mutex> lg { consumer->ready_mutex };
+      consumer->upstream.push_back(weak_from_this());
+    }
+    // The critical path may now go through the consumer
+    lengthen_path(consumer->path());
+    return true;
+  }
+
+
+  /** Account for the end of a producer, submitting the execution
+      after the last one
+  */
+  void producer_done() {
+    if (pending_producers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      forget_producers();
+      owner_queue->execute(std::move(pending_execution), path());
+    }
+  }
+
+
+  /// Stop lengthening the path of the producers, which are all done
+  void forget_producers() {
+    std::lock_guard<detail::task_mutex> lg { ready_mutex };
+    upstream.clear();
+  }
+
+
+  /// Test whether the kernel of this task can be fused with other ones
+  bool can_fuse() const {
+    return owner_queue->fuses_kernels() && !recording && !in_order
+      && owner_queue->is_host() && prologues.empty() && epilogues.empty()
+      && !memo_scalars;
+  }
+
+
+  /** Test whether the memoized kernel of this task already ran with
+      the same scalars on the current content of its buffers, so its
+      outputs are still valid and its execution can be skipped
+
+      The versions of the buffers left by this task are remembered at
+      the end of its execution for the next submissions.
+
+      \tparam KernelName identifies the kernel
+
+      \param[in] work_items is the number of work-items of the kernel
+  */
+  template <typename KernelName>
+  bool is_memoized(std::uint64_t work_items) {
+    if (!memo_scalars || recording)
+      return false;
+    // A kernel name is often an incomplete type, unlike a pointer to it
+    kernel_memo::key k { typeid(KernelName *), *memo_scalars };
+    k.second.append(reinterpret_cast<const char *>(&work_items),
+                    sizeof(work_items));
+    /* The versions of the storage of each buffer, with the number of
+       bumps by the accessors of this command group */
+    std::vector<std::pair<std::shared_ptr<buffer_base>, std::uint64_t>> owners;
+    for (std::size_t i = 0; i != buffers_in_use.size(); ++i) {
+      auto o = buffers_in_use[i]->storage_owner();
+      auto b = std::ranges::find(owners, o, &decltype(owners)::value_type::first);
+      if (b == owners.end())
+        b = owners.insert(b, { std::move(o), 0 });
+      b->second += writes_in_use[i];
+    }
+    kernel_memo::versions before, after;
+    for (auto &[o, writes] : owners) {
+      if (writes && std::ranges::any_of(reads_in_use, [&] (auto b) {
+            return b->storage_owner() == o;
+          }))
+        // A kernel updating a buffer in place would change it again
+        return false;
+      auto now = o->version.load(std::memory_order_relaxed);
+      before.push_back({ o, now - writes });
+      after.push_back({ o, now });
+    }
+    bool up_to_date = kernel_memo::instance().is_up_to_date(k, before);
+    /* Remember the outputs only once they are produced, so a kernel
+       throwing an exception is not reused */
+    add_postlude([k = std::move(k), after = std::move(after)] {
+        kernel_memo::instance().record(k, after);
+      });
+    return up_to_date;
+  }
+
+
+  /** Schedule an element-wise 1D kernel, fusing it if possible into
+      the latest batch of fused kernels of the queue which has not
+      started yet
+
+      The kernel is fused when the batch has the same range and when
+      this task depends only on the tasks of the batch, which run the
+      kernels in order on each chunk. Otherwise this task starts a new
+      batch.
+  */
+  void schedule_fusable(const range<1> &r, detail::fused_kernels::stage s) {
+    auto &q = *owner_queue;
+    {
+      std::lock_guard<detail::task_mutex> lg { q.fusion_mutex };
+      auto batch = q.fusion_batch.lock();
+      if (batch && batch->fused->r.get(0) == r.get(0)
+          && std::all_of(producer_tasks.begin(), producer_tasks.end(),
+                         [&] (auto &p) {
+                           /* Only the tasks of this queue can be
+                              fused, so checking the queue first
+                              avoids racing with other queues */
+                           return p == batch
+                             || (p->owner_queue == owner_queue
+                                 && p->fused_into == batch.get());
+                         })) {
+        TRISYCL_DUMP_T("Fuse task " << this << " into task " << batch);
+        batch->fused->stages.push_back(std::move(s));
+        // The batch already takes care of the dependencies
+        producer_tasks.clear();
+        fused_into = batch.get();
+        scheduled = true;
+        batch->fused_tasks.push_back(shared_from_this());
+        return;
+      }
+      fused = std::make_unique<detail::fused_kernels>(r);
+      fused->stages.push_back(std::move(s));
+      q.fusion_batch = weak_from_this();
+    }
+    // The execution keeps this task alive
+    schedule([this] { run_fused(); });
+  }
+
+
+  /// Execute the kernels of the batch started by this task
+  void run_fused() {
+    {
+      std::lock_guard<detail::task_mutex> lg { owner_queue->fusion_mutex };
+      // Nothing else can be fused once the execution has started
+      if (owner_queue->fusion_batch.lock().get() == this)
+        owner_queue->fusion_batch.reset();
+    }
+    TRISYCL_DUMP_T("Execute " << fused->stages.size() << " fused kernels");
+    TRISYCL_TIMELINE_SCOPE("kernel", "fused kernels");
+    // The fused kernels start along with this one
+    for (auto &t : fused_tasks)
+      t->notify_start();
+    fused->run();
+    /* Free the kernels which may own an accessor owning a buffer
+       owning this task as its latest producer */
+    fused->stages.clear();
+    // Complete the fused tasks on behalf of them
+    for (auto &t : fused_tasks) {
+      t->release_buffers();
+      t->release_upstream();
+      t->notify_consumers();
+    }
+    fused_tasks.clear();
+  }
+
+
+  /// Test whether the single_task kernel of this task can be coalesced
+  bool can_coalesce() const {
+    return owner_queue->coalesces_tasks() && !recording && !in_order
+      && owner_queue->is_host() && producer_tasks.empty()
+      && pipe_ends.empty() && prologues.empty() && epilogues.empty()
+      && !memo_scalars;
+  }
+
+
+  /** Schedule the kernel of a ready single_task, making it join the
+      latest batch of coalesced kernels of the queue which has not
+      started yet, or start a new batch if there is none or if it is
+      full
+
+      The kernel of the task is kept in it and executed by the task
+      starting the batch, after its own kernel.
+  */
+  void schedule_coalescable(detail::unique_function<void(void)> f) {
+    auto &q = *owner_queue;
+    {
+      std::lock_guard<detail::task_mutex> lg { q.coalescing_mutex };
+      auto batch = q.coalescing_batch.lock();
+      if (batch && batch->fused_tasks.size() + 1 < q.coalesces_tasks()) {
+        TRISYCL_DUMP_T("Coalesce task " << this << " into task " << batch);
+        kernel_code = std::move(f);
+        fused_into = batch.get();
+        scheduled = true;
+        batch->fused_tasks.push_back(shared_from_this());
+        return;
+      }
+      q.coalescing_batch = weak_from_this();
+    }
+    // The execution keeps this task alive
+    schedule([this, f = std::move(f)] () mutable { run_coalesced(f); });
+  }
+
+
+  /** Execute the kernel \p f of this task and then the kernels of the
+      batch it started, completing each coalesced task on its own
+  */
+  void run_coalesced(detail::unique_function<void(void)> &f) {
+    {
+      std::lock_guard<detail::task_mutex> lg { owner_queue->coalescing_mutex };
+      // Nothing else can join the batch once the execution has started
+      if (owner_queue->coalescing_batch.lock().get() == this)
+        owner_queue->coalescing_batch.reset();
+    }
+    run_kernel(f);
+    TRISYCL_DUMP_T("Execute " << fused_tasks.size() << " coalesced kernels");
+    for (auto &t : fused_tasks) {
+      t->notify_start();
+      t->run_kernel(t->kernel_code);
+      /* Free the kernel which may own an accessor owning a buffer
+         owning the task as its latest producer */
+      t->kernel_code = nullptr;
+      // The consumers and the event do not wait for the rest of the batch
+      t->release_buffers();
+      t->release_upstream();
+      t->notify_consumers();
+    }
+    fused_tasks.clear();
+  }
+
+
+  /** Run the epilogues and notify the end of the task
+
+      \param[in] keep_alive owns the task up to its completion and is
+      released before notifying the queue, so the task is already
+      destroyed when a wait on the queue returns, unless an event
+      still owns it
+  */
+  void complete(std::shared_ptr<detail::task> keep_alive) {
+    postlude();
+    // Release the buffers that have been written by this task
+    release_buffers();
+    release_upstream();
+    // Notify the waiting tasks that we are done
+    notify_consumers();
+    // This task may be destroyed with keep_alive
+    auto q = owner_queue;
+    keep_alive.reset();
+    // Notify the queue we are done
+    q->kernel_end();
+  }
+
+
+  /** Release what a completed task refers to, since an event may keep
+      the task itself alive for a long time
+  */
+  void release_upstream() {
+    producer_tasks.clear();
+    pipe_ends.clear();
+    fused.reset();
+    fused_tasks.clear();
+    accessors.clear();
+    kernel.reset();
+#ifdef TRISYCL_OPENCL
+    transfers.clear();
+#endif
+  }
+
+
+#ifdef TRISYCL_OPENCL
+  /** Complete the task once its OpenCL kernel is done
+
+      Instead of blocking a worker thread on the device, the callback
+      of the kernel event submits the completion back to the queue,
+      since no OpenCL function can be called from the callback
+      itself. A task of an in-order queue just waits for its kernel,
+      since the next task of the queue cannot start before.
+
+      \param[in] keep_alive owns the task up to its completion
+  */
+  void complete_after_kernel(std::shared_ptr<detail::task> keep_alive) {
+#if defined(BOOST_COMPUTE_CL_VERSION_1_1) && !defined(TRISYCL_NO_ASYNC)
+    if (!in_order) {
+      kernel_event.set_callback([t = std::move(keep_alive)] () mutable {
+          auto &q = *t->owner_queue;
+          q.execute([t = std::move(t)] () mutable {
+              auto &task = *t;
+              task.complete(std::move(t));
+            });
+        });
+      return;
+    }
+#endif
+    kernel_event.wait();
+    complete(std::move(keep_alive));
+  }
+
+
+  /** Test whether the OpenCL kernel of a \p consumer task can wait
+      for this task on the device
+  */
+  bool can_chain_on_device(const detail::task &consumer) const {
+    return consumer.kernel && !owner_queue->is_host()
+      && !consumer.owner_queue->is_host()
+      && owner_queue->get_context() == consumer.owner_queue->get_context();
+  }
+
+
+  /** Get the event of the OpenCL kernel of this task once enqueued,
+      if a \p consumer task can just wait for it on the device
+
+      This is the case when both run an OpenCL kernel in the same
+      context, since the consumer finds then the buffers already up
+      to date on the device and only its kernel has to wait.
+
+      \return an empty event if the consumer has to wait for the end
+      of this task on the host, or if it is already ended
+  */
+  boost::compute::event get_kernel_event_for(const detail::task &consumer) {
+    if (!can_chain_on_device(consumer))
+      return {};
+    owner_queue->flush_dataflow();
+    detail::worker_pool::blocked_scope b;
+    std::unique_lock<detail::task_mutex> ul { ready_mutex };
+    ready.wait(ul, [&] { return execution_ended || kernel_event.get(); });
+    return execution_ended ? boost::compute::event {} : kernel_event;
+  }
+#endif
+
+
+  /** Wait for the required producer tasks to be ready
+
+      Usually the execution is only submitted once they are done, so
+      this only waits for the producers of the tasks connected by
+      pipes, of the tasks of an in-order queue or of a kernel chained
+      on the device.
+
+      With OpenCL, a kernel waits for the kernels of its producers on
+      the device instead, through the wait list of its enqueuing.
+  */
   void wait_for_producers() {
     TRISYCL_DUMP_T("Task " << this << " waits for the producer tasks");
-    for (auto &t : producer_tasks)
-      t->wait();
+    TRISYCL_TIMELINE_SCOPE("task", "wait for producers");
+    for (auto &t : producer_tasks) {
+#ifdef TRISYCL_OPENCL
+      if (auto e = t->get_kernel_event_for(*this); e.get())
+        transfers.insert(e);
+      else
+#endif
+        t->wait();
+      /* Do not keep a producer done while waiting for the other
+         ones */
+      t.reset();
+    }
     // We can let the producers rest in peace
     producer_tasks.clear();
   }
@@ -139,22 +844,51 @@ struct task : public std::enable_shared_from_this<task>,
   /// Release the buffers that have  been used by this task
   void release_buffers() {
     TRISYCL_DUMP_T("Task " << this << " releases the written buffers");
-    for (auto b: buffers_in_use)
+    TRISYCL_TIMELINE_SCOPE("task", "release buffers");
+    for (auto b: buffers_in_use) {
+      /* The next accesses do not have to wait for this task, so the
+         buffer does not keep it or its memory */
+      b->forget_task(this);
       b->release();
+    }
     buffers_in_use.clear();
+    writes_in_use.clear();
+    reads_in_use.clear();
+  }
+
+
+  /// Record that the kernel starts, for the event of the command group
+  void notify_start() {
+    std::lock_guard<detail::task_mutex> lg { ready_mutex };
+    execution_started = true;
+    start_time = now();
   }
 
 
   /// Notify the waiting tasks that we are done
   void notify_consumers() {
     TRISYCL_DUMP_T("Notify all the task waiting for this task " << this);
-   {
-     std::unique_lock<std::mutex> ul { ready_mutex };
-     execution_ended = true;
-   }
-    /* \todo Verify that the memory model with the notify does not
-       require some fence or atomic */
+    decltype(consumers) ready_consumers;
+    {
+      std::unique_lock<detail::task_mutex> ul { ready_mutex };
+      execution_ended = true;
+      end_time = now();
+      // Only the tasks really started account for the queue latencies
+      if (start_time) {
+        owner_queue->submit_to_start.record(
+          std::chrono::nanoseconds { start_time - submit_time });
+        owner_queue->start_to_end.record(
+          std::chrono::nanoseconds { end_time - start_time });
+      }
+      ready_consumers.swap(consumers);
+    }
+    completion.set();
+#ifdef TRISYCL_OPENCL
     ready.notify_all();
+#endif
+    // Submit directly the consumers waiting only for this task
+    for (auto &c : ready_consumers)
+      c->producer_done();
   }
 
 
@@ -164,49 +898,80 @@ struct task : public std::enable_shared_from_this<task>,
   */
   void wait() {
     TRISYCL_DUMP_T("The task wait for task " << this << " to end");
-    std::unique_lock<std::mutex> ul { ready_mutex };
-    ready.wait(ul, [&] { return execution_ended; });
+    // This task may be held waiting for the rest of its dataflow gang
+    owner_queue->flush_dataflow();
+    completion.wait();
+  }
+
+
+  /** Make this task wait for another one, as an explicit dependency
+      given by the event of its command group
+  */
+  void add_dependency(std::shared_ptr<detail::task> t) {
+    if (t.get() == this)
+      return;
+    if (recording) {
+      /* The recorded graph only knows about the buffers, so wait for
+         the dependency right now */
+      t->wait();
+      return;
+    }
+    producer_tasks.push_back(std::move(t));
+  }
+
+
+  /// Register a pipe used by this task, for writing if \p is_write
+  void add_pipe(const void *pipe, bool is_write) {
+    pipe_ends.push_back({ pipe, is_write });
   }
 
 
-  /** Register a buffer to this task
+  /** Register a buffer to this task, accessing its elements from \p
+      first up to one before \p last
 
       This is how the dependency graph is incrementally built.
   */
   void add_buffer(std::shared_ptr<detail::buffer_base> &buf,
-                  bool is_write_mode) {
+                  bool is_write_mode,
+                  std::size_t first = 0,
+                  std::size_t last = std::numeric_limits<std::size_t>::max()) {
     TRISYCL_DUMP_T("Add buffer " << buf << " in task " << this);
+    if (recording) {
+      // The dependencies are resolved by the graph at the end of recording
+      recording->add_access(recorded_node, buf, is_write_mode);
+      return;
+    }
     /* Keep track of the use of the buffer to notify its release at
        the end of the execution */
     buffers_in_use.push_back(buf);
+    writes_in_use.push_back(is_write_mode);
     // To be sure the buffer does not disappear before the kernel can run
     buf->use();
 
-    std::shared_ptr<detail::task> latest_producer;
-    if (is_write_mode) {
-      /* Set this task as the latest producer of the buffer so that
-         another kernel may wait on this task */
-      latest_producer = buf->set_latest_producer(shared_from_this());
-    }
-    else
-      latest_producer = buf->get_latest_producer();
+    /* Track read after write, write after read and write after write
+       dependencies, so the readers of a buffer run concurrently while
+       a writer waits for all of them
 
-    /* If the buffer is to be produced by a task, add the task in the
-       producer list to wait on it before running the task core
-
-       If a buffer is accessed first in write mode and then in read mode,
-       the task will add itself as a producer and will wait for itself
-       when calling \c wait_for_producers, we avoid this by checking that
-       \c latest_producer is not \c this
+       If a buffer is accessed first in write mode and then in read
+       mode, the task would wait for itself when calling \c
+       wait_for_producers, we avoid this by checking that the producer
+       is not \c this
     */
-    if (latest_producer && latest_producer != shared_from_this())
-      producer_tasks.push_back(latest_producer);
+    buf->add_access(shared_from_this(), is_write_mode, producer_tasks,
+                    first, last);
+    if (in_order)
+      // The previous tasks of the queue are already done when this one runs
+      producer_tasks.erase(
+        std::remove_if(producer_tasks.begin(), producer_tasks.end(),
+                       [&] (auto &p) { return p->owner_queue == owner_queue; }),
+        producer_tasks.end());
   }
 
 
   /// Execute the prologues
   void prelude() {
     TRISYCL_DUMP_T("task::prelude");
+    TRISYCL_TIMELINE_SCOPE("task", "prelude");
 
     for (const auto &p : prologues)
       p();
@@ -218,6 +983,7 @@ struct task : public std::enable_shared_from_this<task>,
 
   /// Execute the epilogues
   void postlude() {
+    TRISYCL_TIMELINE_SCOPE("task", "postlude");
     for (const auto &p : epilogues)
       p();
     /* Free the functors that may own an accessor owning a buffer
@@ -267,9 +1033,7 @@ struct task : public std::enable_shared_from_this<task>,
   void set_arg(std::size_t arg_index, std::size_t arg_size, const void *scalar_value) {
 #ifdef TRISYCL_OPENCL
     // Forward to the OpenCL kernel
-    get_kernel().get_boost_compute().set_arg(arg_index,
-                                             arg_size,
-                                             scalar_value);
+    get_kernel().set_arg(arg_index, arg_size, scalar_value);
 #else
     throw non_cl_error("Not compiled with OpenCL support");
 #endif
@@ -281,13 +1045,39 @@ struct task : public std::enable_shared_from_this<task>,
   void set_arg(std::size_t arg_index, const T &scalar_value) {
 #ifdef TRISYCL_OPENCL
     // Forward to the OpenCL kernel
-    get_kernel().get_boost_compute().set_arg(arg_index, scalar_value);
+    if constexpr (std::is_base_of_v<boost::compute::memory_object, T>) {
+      // Compare the buffers by their OpenCL handle
+      auto m = scalar_value.get();
+      get_kernel().set_arg(arg_index, sizeof m, &m);
+    }
+    else if constexpr (boost::compute::is_fundamental<T>::value)
+      get_kernel().set_arg(arg_index, sizeof scalar_value, &scalar_value);
+    else {
+      // Let Boost.Compute deal with the other kinds of arguments
+      get_kernel().get_boost_compute().set_arg(arg_index, scalar_value);
+      get_kernel().forget_arg(arg_index);
+    }
 #else
     throw non_cl_error("Not compiled with OpenCL support");
 #endif
   }
 
 
+  /// Copy a scalar kernel argument at \p offset of the packed arguments
+  void pack_arg(std::size_t offset, std::size_t arg_size,
+                const void *scalar_value) {
+    if (packed_args.size() < offset + arg_size)
+      packed_args.resize(offset + arg_size);
+    std::memcpy(packed_args.data() + offset, scalar_value, arg_size);
+  }
+
+
+  /// Set the packed scalar arguments as the kernel argument \p arg_index
+  void set_packed_args(std::size_t arg_index) {
+    set_arg(arg_index, packed_args.size(), packed_args.data());
+  }
+
+
 #ifdef TRISYCL_OPENCL
   /// Get the Boost.Compute buffer for an accessor of the task
   auto get_compute_buffer(std::size_t order) {
@@ -308,6 +1098,37 @@ std::size_t register_accessor(std::weak_ptr<detail::accessor_base> a) {
 
 };
 
+
+#ifdef TRISYCL_OPENCL
+/** Get the transfers an OpenCL kernel of a task has to wait for,
+    forgetting them in the task
+
+    This is a proxy function to avoid complicated type recursion.
+*/
+inline boost::compute::wait_list take_transfers(detail::task &t) {
+  auto transfers = std::move(t.transfers);
+  t.transfers.clear();
+  return transfers;
+}
+
+
+/** Keep the event of the OpenCL kernel run by a task, to complete the
+    task when it is done, to chain the consumer kernels on it and to
+    get its profiling information
+
+    This is a proxy function to avoid complicated type recursion.
+*/
+inline void set_kernel_event(detail::task &t,
+                             const boost::compute::event &e) {
+  {
+    std::lock_guard<detail::task_mutex> lg { t.ready_mutex };
+    t.kernel_event = e;
+  }
+  // Some consumer kernels may wait for the enqueuing
+  t.ready.notify_all();
+}
+#endif
+
 }
 
 /*
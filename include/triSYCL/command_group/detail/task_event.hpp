@@ -0,0 +1,110 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_EVENT_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_EVENT_HPP
+
+/** \file The event of a command group executed by a host task
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <memory>
+#include <mutex>
+
+#include "triSYCL/command_group/detail/task.hpp"
+#include "triSYCL/event.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// An event tracking the execution of the task of a command group
+class task_event : public detail::event {
+
+  /// The task to track, kept alive as long as the event
+  std::shared_ptr<detail::task> t;
+
+public:
+
+  task_event(std::shared_ptr<detail::task> t) : t { std::move(t) } {}
+
+#ifdef TRISYCL_OPENCL
+  cl_event get() const override {
+    throw non_cl_error("The event of a host task has no OpenCL event");
+  }
+
+  const boost::compute::event &get_boost_compute() const override {
+    throw non_cl_error("The event of a host task has no underlying "
+                       "Boost Compute event");
+  }
+#endif
+
+  bool is_host() const override {
+    return true;
+  }
+
+  cl_uint get_reference_count() const override {
+    return 0;
+  }
+
+  info::event_command_status get_command_execution_status() const override {
+    std::lock_guard<detail::task_mutex> lg { t->ready_mutex };
+    if (t->execution_ended)
+      return info::event_command_status::complete;
+    return t->execution_started ? info::event_command_status::running
+                                : info::event_command_status::submitted;
+  }
+
+  /** Get a timestamp of the execution in nanoseconds, waiting for the
+      end of the task
+
+      The host timestamps come from a steady clock, while the ones of
+      an OpenCL kernel come from its device.
+  */
+  cl_ulong get_profiling_info(info::event_profiling param) const override {
+    if (!t->profiling)
+      throw invalid_object_error {
+        "The queue of the command group has no enable_profiling property"
+      };
+    t->wait();
+#ifdef TRISYCL_OPENCL
+    if (t->kernel_event.get())
+      return t->kernel_event.get_profiling_info<cl_ulong>(
+        static_cast<cl_profiling_info>(param));
+#endif
+    std::lock_guard<detail::task_mutex> lg { t->ready_mutex };
+    switch (param) {
+    case info::event_profiling::command_submit:
+      return t->submit_time;
+    case info::event_profiling::command_start:
+      return t->start_time;
+    default:
+      return t->end_time;
+    }
+  }
+
+  void wait() const override {
+    t->wait();
+  }
+
+  std::shared_ptr<detail::task> get_task() const override {
+    return t;
+  }
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_EVENT_HPP
@@ -0,0 +1,296 @@
+#ifndef TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_GRAPH_HPP
+#define TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_GRAPH_HPP
+
+/** \file A recorded graph of command groups to be replayed
+
+    Instead of being scheduled, the command groups submitted to a
+    recording queue are recorded as nodes of a task_graph with their
+    buffer accesses. The dependencies between the nodes are resolved
+    once at the end of the recording, so a replay only has to execute
+    the nodes in the dependency order.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "triSYCL/command_group/detail/storage_plan.hpp"
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/detail/unique_function.hpp"
+
+namespace trisycl::detail {
+
+struct buffer_base;
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// A graph of recorded command groups
+struct task_graph : detail::debug<task_graph> {
+
+  /** Some functions around a kernel, with room for a few of them
+      without heap allocation
+  */
+  using functions =
+    boost::container::small_vector<std::function<void(void)>, 2>;
+
+  /// A buffer used by a graph or a node
+  struct access {
+    std::shared_ptr<detail::buffer_base> buffer;
+    bool is_write_mode;
+  };
+
+  /// A recorded command group
+  struct node {
+    /// The kernel and its tracing wrapper
+    detail::unique_function<void(void)> kernel;
+
+    /// Any prologue to be executed before the kernel
+    functions prologues;
+
+    /// Any epilogue to be executed after the kernel
+    functions epilogues;
+
+    /// The buffers used by the command group
+    std::vector<access> accesses;
+
+    /// The nodes to run after this one
+    std::vector<std::size_t> successors;
+
+    /// The number of nodes to run before this one
+    std::size_t predecessors = 0;
+
+    /// The predecessors still running during a replay
+    std::atomic<std::size_t> pending;
+  };
+
+  /** The nodes in submission order
+
+      Allocate them individually since the atomic counters prevent
+      the nodes from being moved
+  */
+  std::vector<std::unique_ptr<node>> nodes;
+
+  /// The union of the node accesses, with one entry per buffer
+  std::vector<access> accesses;
+
+  /// The slabs shared by the temporary buffers of the graph
+  std::shared_ptr<detail::storage_plan> storage =
+    std::make_shared<detail::storage_plan>();
+
+  /// The executor running the nodes during a replay
+  detail::task_executor *executor = nullptr;
+
+  /// The chunking of the kernels of the queue replaying the graph
+  const detail::partitioning *partition = nullptr;
+
+  /// The nodes still to be executed during a replay
+  std::size_t remaining = 0;
+
+  /// To serialize the replays of the same graph
+  detail::task_mutex replay_mutex;
+
+  /// To protect remaining
+  detail::task_mutex remaining_mutex;
+
+  /// To signal the execution of the last node of a replay
+  detail::task_condition_variable done;
+
+
+  /// Start recording a new command group and return its node index
+  std::size_t add_node() {
+    nodes.push_back(std::make_unique<node>());
+    storage->add_command_group();
+    return nodes.size() - 1;
+  }
+
+
+  /// Record the use of a buffer by a node
+  void add_access(std::size_t n,
+                  std::shared_ptr<detail::buffer_base> buf,
+                  bool is_write_mode) {
+    nodes[n]->accesses.push_back({ std::move(buf), is_write_mode });
+  }
+
+
+  /// Record the kernel of a node
+  void set_kernel(std::size_t n,
+                  detail::unique_function<void(void)> f,
+                  functions prologues,
+                  functions epilogues) {
+    auto &nd = *nodes[n];
+    nd.kernel = std::move(f);
+    nd.prologues = std::move(prologues);
+    nd.epilogues = std::move(epilogues);
+  }
+
+
+  /** Resolve the dependencies between the nodes at the end of the
+      recording
+
+      This uses the same read after write, write after read and write
+      after write rules as the buffers. The temporary buffers sharing
+      a slab are tracked as a single buffer, so a temporary is only
+      used once the previous ones of its slab are done. The command
+      groups without a kernel are dropped.
+  */
+  void finalize() {
+    std::erase_if(nodes, [] (auto &n) { return !n->kernel; });
+    struct tracking {
+      // The latest node writing the storage, if any
+      std::ptrdiff_t producer = -1;
+      // The nodes reading the storage since the producer
+      std::vector<std::size_t> readers;
+    };
+    std::unordered_map<const void *, tracking> storages;
+    auto storage_of = [] (detail::buffer_base *b) -> const void * {
+      return b->slab ? static_cast<const void *>(b->slab.get()) : b;
+    };
+    // The index of each buffer in accesses
+    std::unordered_map<detail::buffer_base *, std::size_t> global;
+    for (std::size_t i = 0; i != nodes.size(); ++i) {
+      auto edge = [&] (std::size_t from) {
+        if (from == i)
+          return;
+        auto &s = nodes[from]->successors;
+        // Avoid duplicate edges, which are typically the latest ones
+        if (std::find(s.begin(), s.end(), i) == s.end()) {
+          s.push_back(i);
+          ++nodes[i]->predecessors;
+        }
+      };
+      for (auto &a : nodes[i]->accesses) {
+        if (auto [g, inserted] =
+              global.try_emplace(a.buffer.get(), accesses.size());
+            inserted)
+          accesses.push_back(a);
+        else
+          accesses[g->second].is_write_mode |= a.is_write_mode;
+        auto &t = storages[storage_of(a.buffer.get())];
+        // Conflict with the accesses through the sub-buffers or parent
+        if (a.buffer->parent || a.buffer->has_sub_buffers)
+          for (auto &b : a.buffer->aliases())
+            if (auto other = storages.find(storage_of(b.get()));
+                other != storages.end()) {
+              if (other->second.producer >= 0)
+                edge(other->second.producer);
+              if (a.is_write_mode)
+                for (auto r : other->second.readers)
+                  edge(r);
+            }
+        if (a.is_write_mode) {
+          if (t.producer >= 0)
+            edge(t.producer);
+          for (auto r : t.readers)
+            edge(r);
+          t.readers.clear();
+          t.producer = i;
+        }
+        else {
+          if (t.producer >= 0)
+            edge(t.producer);
+          t.readers.push_back(i);
+        }
+      }
+    }
+    TRISYCL_DUMP_T("task_graph finalized with " << nodes.size() << " nodes");
+  }
+
+
+  /** Execute all the nodes on an executor and wait for their completion
+
+      This is used as the kernel of the task replaying the graph, which
+      has already taken care of the dependencies with the outside
+      world. The nodes are executed with continuation passing: a node
+      submits to the executor all but one of its successors becoming
+      ready and executes the remaining one by itself.
+  */
+  void run(detail::task_executor &e) {
+    std::lock_guard<detail::task_mutex> lg { replay_mutex };
+    if (nodes.empty())
+      return;
+    executor = &e;
+    partition = partitioning::current();
+    remaining = nodes.size();
+    std::ptrdiff_t next = -1;
+    for (std::size_t i = 0; i != nodes.size(); ++i) {
+      nodes[i]->pending = nodes[i]->predecessors;
+      if (nodes[i]->predecessors == 0)
+        make_ready(i, next);
+    }
+    execute(next);
+    detail::worker_pool::blocked_scope b;
+    std::unique_lock<detail::task_mutex> ul { remaining_mutex };
+    done.wait(ul, [&] { return remaining == 0; });
+  }
+
+private:
+
+  /** Handle a node becoming ready by keeping it in \param next to be
+      executed by the current thread, or by submitting it if \param
+      next is already taken
+  */
+  void make_ready(std::size_t n, std::ptrdiff_t &next) {
+    if (next < 0)
+      next = n;
+    else
+      // Capture only 2 words to fit in the std::function small buffer
+      executor->submit([this, n] { execute(n); });
+  }
+
+
+  /// Execute a node and its chain of continuations
+  void execute(std::ptrdiff_t n) {
+    while (n >= 0) {
+      auto &nd = *nodes[n];
+      for (auto &p : nd.prologues)
+        p();
+      // The node may run on another worker thread than the replay
+      partitioning::current() = partition;
+      nd.kernel();
+      for (auto &p : nd.epilogues)
+        p();
+      std::ptrdiff_t next = -1;
+      for (auto s : nd.successors)
+        if (--nodes[s]->pending == 0)
+          make_ready(s, next);
+      {
+        std::lock_guard<detail::task_mutex> lg { remaining_mutex };
+        if (--remaining == 0)
+          done.notify_all();
+      }
+      n = next;
+    }
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_COMMAND_GROUP_DETAIL_TASK_GRAPH_HPP
@@ -173,6 +173,13 @@ public:
   boost::compute::command_queue &get_boost_queue() const {
     return implementation->get_boost_queue();
   }
+
+  /** Return the internal queue used by triSYCL to read data back to
+      the host, concurrently with the transfers to the devices
+  */
+  boost::compute::command_queue &get_boost_read_queue() const {
+    return implementation->get_boost_read_queue();
+  }
 #endif
 
 
@@ -35,6 +35,11 @@ public:
       with the context
   */
   virtual boost::compute::command_queue &get_boost_queue() = 0;
+
+  /** Return the \c boost::compute::command_queue reading data back to
+      the host, so they do not wait behind the transfers to the device
+  */
+  virtual boost::compute::command_queue &get_boost_read_queue() = 0;
 #endif
 
   /// Returns true is the context is a SYCL host context
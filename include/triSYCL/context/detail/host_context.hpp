@@ -63,6 +63,12 @@ public:
   boost::compute::command_queue &get_boost_queue() override {
     throw non_cl_error("The host context cannot have an OpenCL queue");
   }
+
+
+  /// This throws an error too, for the same reason
+  boost::compute::command_queue &get_boost_read_queue() override {
+    throw non_cl_error("The host context cannot have an OpenCL queue");
+  }
 #endif
 
 
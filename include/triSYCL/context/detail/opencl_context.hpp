@@ -36,12 +36,24 @@ class opencl_context : public detail::context {
   */
   boost::compute::command_queue q;
 
+  /** The queue reading data back to the host, so the reads overlap
+      with the transfers to the device for the next kernels and with
+      the kernels, which run on the queues of the SYCL queues
+  */
+  boost::compute::command_queue read_q;
+
   /** A cache to always return the same alive context for a given OpenCL
       context
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
   */
-  static detail::cache<cl_context, detail::opencl_context> cache;
+  static auto &cache() {
+    static auto c = new detail::cache<cl_context, detail::opencl_context>;
+    return *c;
+  }
 
 public:
 
@@ -65,6 +77,12 @@ public:
   }
 
 
+  /// Return the queue reading data back to the host
+  boost::compute::command_queue &get_boost_read_queue() override {
+    return read_q;
+  }
+
+
   /// Return false because the context is not a SYCL host context
   bool is_host() const override {
     return false;
@@ -115,8 +133,8 @@ public:
   /// Get a singleton instance of the \c opencl_context
   static std::shared_ptr<opencl_context>
   instance(const boost::compute::context &c) {
-    return cache.get_or_register(c.get(),
-                                 [&] { return new opencl_context { c }; });
+    return cache().get_or_register(c.get(),
+                                   [&] { return new opencl_context { c }; });
   }
 
 
@@ -125,26 +143,19 @@ private:
   /// Only the instance factory can build it
   opencl_context(const boost::compute::context &c) :
     c { c },
-    q { boost::compute::command_queue { c, c.get_device() } } {}
+    q { boost::compute::command_queue { c, c.get_device() } },
+    read_q { boost::compute::command_queue { c, c.get_device() } } {}
 
 
 public:
   /// Unregister from the cache on destruction
   ~opencl_context() override {
-    cache.remove(c.get());
+    cache().remove(c.get());
   }
 
 };
 
 
-/* Allocate the cache here but since this is a pure-header library,
-   use a weak symbol so that only one remains when SYCL headers are
-   used in different compilation units of a program
-*/
-TRISYCL_WEAK_ATTRIB_PREFIX
-detail::cache<cl_context, detail::opencl_context> opencl_context::cache
-TRISYCL_WEAK_ATTRIB_SUFFIX;
-
 }
 
 /*
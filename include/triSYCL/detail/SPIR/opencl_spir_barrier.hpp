@@ -0,0 +1,58 @@
+#ifndef TRISYCL_SYCL_DETAIL_SPIR_OPENCL_SPIR_BARRIER_HPP
+#define TRISYCL_SYCL_DETAIL_SPIR_OPENCL_SPIR_BARRIER_HPP
+
+/** \file
+    Implement the work-group barrier of a kernel compiled to SPIR with
+    the SPIR-V OpControlBarrier instruction
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/detail/SPIR/opencl_spir_req.h"
+
+/** \addtogroup opencl_spir_helpers
+    @{
+*/
+
+namespace trisycl::detail::spir {
+
+/// The SPIR-V scope of the work-items of a work-group
+inline constexpr unsigned int workgroup_scope = 2;
+
+/// The SPIR-V memory semantics ordering the accesses around a barrier
+inline constexpr unsigned int sequentially_consistent = 0x10;
+
+/// The SPIR-V memory semantics applying to the local memory
+inline constexpr unsigned int workgroup_memory = 0x100;
+
+/// The SPIR-V memory semantics applying to the global memory
+inline constexpr unsigned int cross_workgroup_memory = 0x200;
+
+
+/** Wait for all the work-items of the work-group, with a fence on
+    the address spaces of \p flag
+*/
+inline void barrier(access::fence_space flag) {
+  unsigned int semantics = sequentially_consistent;
+  if (flag != access::fence_space::global_space)
+    semantics |= workgroup_memory;
+  if (flag != access::fence_space::local_space)
+    semantics |= cross_workgroup_memory;
+  __spirv_ControlBarrier(workgroup_scope, workgroup_scope, semantics);
+}
+
+/// @} End the opencl_spir_helpers Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_SPIR_OPENCL_SPIR_BARRIER_HPP
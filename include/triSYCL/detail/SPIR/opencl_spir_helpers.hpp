@@ -5,9 +5,6 @@
     Adds helper functions to populate Id's and Range's with OpenCL SPIR
     intrinsics data: e.g. get_global_id(0)
 
-    \todo implement group and nd_item and to add nd_item to
-      create_parallel_for_arg
-
     andrew point gozillon at yahoo point com
 
     This file is distributed under the University of Illinois Open Source
@@ -30,14 +27,14 @@
 
 namespace trisycl::detail::spir {
 
-// Fills the small_array_sycl of the type passed to it up to the dimensionality
-// of the type T (T generally intended to be a sycl id or range, but can be
-// anything with a dimensionality variable defined and a subscript operator)
+// Fills the small_array_sycl of the type passed to it up to the rank of the
+// type T (T generally intended to be a sycl id or range, but can be anything
+// with a rank() function defined and a subscript operator)
 template <typename T,  typename F>
 auto make_array_with_func(F unary_func) {
   T id_or_range {};
 
-  for (size_t i = 0; i < id_or_range.dimensionality; ++i)
+  for (size_t i = 0; i < id_or_range.rank(); ++i)
     id_or_range[i] = unary_func(i);
 
   return id_or_range;
@@ -52,20 +49,32 @@ nd_range<Dimensions> make_spir_nd_range() {
   };
 }
 
-// template <int Dimensions>
-// nd_item<Dimensions> make_spir_nd_item() {}
+/// Make the nd_item of the current work-item from the SPIR built-ins
+template <int Dimensions>
+nd_item<Dimensions> make_spir_nd_item() {
+  nd_item<Dimensions> index { make_spir_nd_range<Dimensions>() };
+  index.set_global(make_array_with_func<id<Dimensions>>(get_global_id));
+  index.set_local(make_array_with_func<id<Dimensions>>(get_local_id));
+  return index;
+}
 
+/** Make the h_item of the current work-item from the SPIR built-ins,
+    the work-group being executed by as many work-items as it has
+*/
 template <int Dimensions>
 h_item<Dimensions> make_spir_h_item() {
-  return h_item<Dimensions> {
-    make_array_with_func<id<Dimensions>>(get_global_offset),
-    make_spir_nd_range<Dimensions>()
-  };
+  h_item<Dimensions> index { make_spir_nd_range<Dimensions>() };
+  index.set_global(make_array_with_func<id<Dimensions>>(get_global_id));
+  index.set_local(make_array_with_func<id<Dimensions>>(get_local_id));
+  return index;
 }
 
-// group
-// template <int Dimensions>
-// group<Dimensions> make_spir_group() {}
+/// Make the group of the current work-item from the SPIR built-ins
+template <int Dimensions>
+group<Dimensions> make_spir_group() {
+  return { make_array_with_func<id<Dimensions>>(get_group_id),
+           make_spir_nd_range<Dimensions>() };
+}
 
 // Uses a passed in index or range to identify the required index or range type
 // to generate
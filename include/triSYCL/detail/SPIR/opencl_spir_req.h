@@ -129,6 +129,25 @@ std::size_t const_func __attribute__((overloadable))
 std::size_t const_func __attribute__((overloadable))
   get_global_offset(unsigned int dimindx);
 
+/**
+ * Prefetch num_elements * sizeof(gentype)
+ * bytes into the global cache. The prefetch
+ * instruction is applied to a work-item in a workgroup
+ * and does not affect the functional
+ * behavior of the kernel.
+ */
+void __attribute__((overloadable))
+  prefetch(const __global char *p, std::size_t num_elements);
+
+/**
+ * Wait for all the invocations of the execution scope to reach
+ * this point, ordering the memory of the memory scope according
+ * to the memory semantics. It is the SPIR-V OpControlBarrier
+ * instruction.
+ */
+void __spirv_ControlBarrier(unsigned int execution, unsigned int memory,
+                            unsigned int semantics);
+
 // Doesn't appear to work on device at the moment
 int printf(__constant const char* st, ...);
 
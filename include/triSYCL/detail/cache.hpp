@@ -9,8 +9,12 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <array>
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 namespace trisycl::detail {
@@ -22,6 +26,13 @@ namespace trisycl::detail {
     Since internally only std::weak_ptr are stored, this does not
     prevent object deletion but it is up to the programmer not to use
     this cache to retrieve deleted objects.
+
+    The cache is read-mostly: it is looked up on each kernel launch
+    from many threads while it changes only when an object is
+    created or removed. So the entries are spread over some shards,
+    each one protected by a reader-writer lock, and a lookup finding a
+    live value only takes a shared lock on its shard. The exclusive
+    lock is taken only to insert a value or to remove one.
 */
 template <typename Key, typename Value>
 class cache {
@@ -36,11 +47,29 @@ public:
 
 private:
 
-  /// The caching storage
-  std::unordered_map<key_type, std::weak_ptr<value_type>> c;
+  /// The number of independent shards, a power of 2
+  static constexpr std::size_t shard_count = 16;
+
+  /// A part of the cache with its own lock, on its own cache line to
+  /// avoid false sharing between the locks
+  struct alignas(64) shard {
+    /// The caching storage
+    std::unordered_map<key_type, std::weak_ptr<value_type>> c;
+
+    /// To make the shard thread-safe
+    std::shared_mutex m;
+  };
+
+  std::array<shard, shard_count> shards;
 
-  /// To make the cache thread-safe
-  std::mutex m;
+
+  /// Get the shard storing the key \p k
+  shard &shard_of(const key_type &k) {
+    // Mix the high bits in since the hash of a pointer is often its
+    // value, whose low bits are always 0 because of the alignment
+    auto h = std::hash<key_type> {}(k);
+    return shards[(h ^ h >> 4 ^ h >> 12) % shard_count];
+  }
 
 public:
 
@@ -59,17 +88,28 @@ public:
   template <typename Functor>
   std::shared_ptr<value_type> get_or_register(const key_type &k,
                                               Functor &&create_element) {
-    std::lock_guard<std::mutex> lg { m };
-
-    auto i = c.find(k);
-    if (i != c.end())
+    auto &s = shard_of(k);
+    {
+      // The fast path of the hits, concurrent with the other lookups
+      std::shared_lock sl { s.m };
+      auto i = s.c.find(k);
+      if (i != s.c.end())
+        if (auto observe = i->second.lock())
+          // Returns \c shared_ptr only if target object is still alive
+          return observe;
+    }
+
+    std::lock_guard lg { s.m };
+    // Another thread may have inserted the value in the meantime
+    auto i = s.c.find(k);
+    if (i != s.c.end())
       if (auto observe = i->second.lock())
-        // Returns \c shared_ptr only if target object is still alive
         return observe;
 
-    // Otherwise create and insert a new element
+    // Otherwise create and insert a new element, replacing an
+    // expired one
     std::shared_ptr<value_type> e { create_element() };
-    c.insert({ k, e });
+    s.c.insert_or_assign(k, e);
     return e;
   }
 
@@ -80,8 +120,9 @@ public:
       the cache
   */
   void remove(const key_type &k) {
-    std::lock_guard<std::mutex> lg { m };
-    c.erase(k);
+    auto &s = shard_of(k);
+    std::lock_guard lg { s.m };
+    s.c.erase(k);
   }
 
 };
@@ -96,4 +137,4 @@ public:
     ### End:
 */
 
-#endif // TRISYCL_SYCL_DEVICE_CACHE_HPP
+#endif // TRISYCL_SYCL_DETAIL_CACHE_HPP
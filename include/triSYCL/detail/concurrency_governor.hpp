@@ -0,0 +1,202 @@
+#ifndef TRISYCL_SYCL_DETAIL_CONCURRENCY_GOVERNOR_HPP
+#define TRISYCL_SYCL_DETAIL_CONCURRENCY_GOVERNOR_HPP
+
+/** \file
+
+    Share the hardware threads among the kernels running concurrently
+
+    Each kernel executed with OpenMP opens its own parallel team, so
+    with several independent kernels in flight the number of OpenMP
+    threads would be the number of kernels times the number of
+    cores. Instead, each kernel asks the governor for a share of the
+    thread budget when it starts and gives it back when it ends.
+
+    A kernel too small to amortize the start of a parallel team is
+    just executed by the thread of its task.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+class concurrency_governor {
+
+  /// The total number of threads to be used by the running kernels
+  std::size_t budget;
+
+  /// To protect the accounting
+  std::mutex m;
+
+  /// Number of kernels holding a share
+  std::size_t active = 0;
+
+  /// Number of threads given to the kernels holding a share
+  std::size_t in_use = 0;
+
+public:
+
+  /// The threads given to a running kernel, returned at its destruction
+  class share {
+    concurrency_governor *g;
+    std::size_t threads;
+
+  public:
+
+    share(concurrency_governor *g, std::size_t threads)
+      : g { g }
+      , threads { threads } {}
+
+    /// A share can be moved but not duplicated
+    share(share &&other) noexcept
+      : g { std::exchange(other.g, nullptr) }
+      , threads { other.threads } {}
+
+    share &operator=(share &&) = delete;
+
+    /// Get the number of threads the kernel can use
+    std::size_t get_threads() const {
+      return threads;
+    }
+
+    ~share() {
+      if (!g)
+        // Moved to another share
+        return;
+      std::lock_guard<std::mutex> lg { g->m };
+      --g->active;
+      g->in_use -= threads;
+    }
+  };
+
+
+  /// Create a governor sharing \param budget threads
+  concurrency_governor(std::size_t budget)
+    : budget { budget == 0 ? 1 : budget } {}
+
+
+  /** Get the governor shared by all the kernels
+
+      Its budget is the default number of OpenMP threads, which can be
+      set with \c OMP_NUM_THREADS, or the number of hardware threads
+      without OpenMP.
+  */
+  static concurrency_governor &global() {
+#ifdef _OPENMP
+    static concurrency_governor g { static_cast<std::size_t>
+                                      (omp_get_max_threads()) };
+#else
+    static concurrency_governor g { std::thread::hardware_concurrency() };
+#endif
+    return g;
+  }
+
+
+  /** The governor of the worker running on the current thread, if it
+      has its own, such as the workers of a host sub-device
+  */
+  static concurrency_governor *&current() {
+    static thread_local concurrency_governor *g = nullptr;
+    return g;
+  }
+
+
+  /** Get the governor of the kernels executed by the current thread,
+      the one of its worker if any or the global one otherwise
+  */
+  static concurrency_governor &instance() {
+    if (auto g = current())
+      return *g;
+    return global();
+  }
+
+
+  /// Get the total number of threads shared by the kernels
+  std::size_t get_budget() const {
+    return budget;
+  }
+
+
+  /** Get the cost, in simple work-items, below which a kernel is
+      executed by the thread of its task
+
+      It can be set with the \c TRISYCL_SERIAL_THRESHOLD environment
+      variable, 4096 by default, and 0 always runs in parallel.
+  */
+  static std::size_t serial_threshold() {
+    static auto threshold = [] () -> std::size_t {
+      if (auto e = std::getenv("TRISYCL_SERIAL_THRESHOLD")) {
+        char *end;
+        auto t = std::strtoul(e, &end, 10);
+        if (end != e)
+          return t;
+      }
+      return 4096;
+    }();
+    return threshold;
+  }
+
+
+  /** Test whether a kernel is worth executing in parallel
+
+      \param[in] work_items is the number of work-items of the kernel
+
+      \param[in] cost is the estimated cost of a work-item, relative to
+      a simple element-wise operation
+  */
+  static bool is_worth_parallelizing(std::size_t work_items,
+                                     std::size_t cost = 1) {
+    auto threshold = serial_threshold();
+    // Compare without overflowing work_items*cost
+    return cost != 0 && work_items >= (threshold + cost - 1)/cost;
+  }
+
+
+  /** Get a share of the threads for a kernel starting now
+
+      A kernel gets an equal part of the budget among the running
+      kernels, without exceeding what is left by the kernels already
+      running, but always at least 1 thread. So the number of threads
+      in use stays below the budget plus the number of running kernels.
+  */
+  share acquire() {
+    std::lock_guard<std::mutex> lg { m };
+    ++active;
+    auto left = budget > in_use ? budget - in_use : 0;
+    auto threads = std::max<std::size_t>(1, std::min(budget/active, left));
+    in_use += threads;
+    return { this, threads };
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_CONCURRENCY_GOVERNOR_HPP
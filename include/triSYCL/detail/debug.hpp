@@ -3,7 +3,9 @@
 
 /** \file Track constructor/destructor invocations and trace kernel execution
 
-    Define the TRISYCL_DEBUG CPP flag to have an output.
+    Define the TRISYCL_DEBUG CPP flag to have an output, or the
+    TRISYCL_EVENT_LOG CPP flag to record it instead in a binary log
+    cheap enough to be used in production.
 
     To use it in some class C, make C inherit from debug<C>.
 
@@ -14,9 +16,13 @@
 */
 
 #include <iostream>
+#include <utility>
 
 #include <boost/type_index.hpp>
 
+#include "triSYCL/detail/timeline.hpp"
+#include "triSYCL/vendor/Xilinx/fpga/performance_model.hpp"
+
 // Only when the common debug or trace infrastructure is required
 #if defined(TRISYCL_DEBUG) || defined(TRISYCL_TRACE_KERNEL)
 #include <sstream>
@@ -40,7 +46,15 @@ using namespace std::string_literals;
   } while(0)
 #endif
 
-#ifdef TRISYCL_DEBUG
+#ifdef TRISYCL_EVENT_LOG
+#include "triSYCL/detail/event_log.hpp"
+
+/// Record the event in the binary log instead of formatting it
+#define TRISYCL_DUMP(expression) TRISYCL_EVENT_LOG_RECORD(expression)
+
+/// The log already records the thread of each event
+#define TRISYCL_DUMP_T(expression) TRISYCL_EVENT_LOG_RECORD(expression)
+#elif defined(TRISYCL_DEBUG)
 #define TRISYCL_DUMP(expression) TRISYCL_INTERNAL_DUMP(expression)
 
 /// Same as TRISYCL_DUMP() but with thread id first
@@ -125,22 +139,38 @@ struct debug {
 
 
 /** Wrap a kernel functor in some tracing messages to have start/stop
-    information when TRISYCL_TRACE_KERNEL macro is defined */
+    information when TRISYCL_TRACE_KERNEL macro is defined, in a
+    span of the timeline when TRISYCL_TIMELINE is defined and in the
+    FPGA performance model when TRISYCL_XILINX_PERFORMANCE_MODEL is
+    defined */
 template <typename KernelName, typename Functor>
 auto trace_kernel(Functor f) {
+#if defined(TRISYCL_TRACE_KERNEL) || defined(TRISYCL_TIMELINE) \
+  || defined(TRISYCL_XILINX_PERFORMANCE_MODEL)
+  // Inject tracing message around the kernel, moving it without a copy
+  return [f = std::move(f)] () mutable {
 #ifdef TRISYCL_TRACE_KERNEL
-  // Inject tracing message around the kernel
-  return [=] () mutable {
     /* Since the class KernelName may just be declared and not really
        defined, just use it through a class pointer to have
        typeid().name() not complaining */
     TRISYCL_INTERNAL_DUMP(
       "Kernel started "
       << boost::typeindex::type_id<KernelName *>().pretty_name());
-    f();
+#endif
+    {
+      TRISYCL_TIMELINE_SCOPE("kernel", timeline::type_name<KernelName>());
+#ifdef TRISYCL_XILINX_PERFORMANCE_MODEL
+      vendor::xilinx::performance_model::kernel_scope modeled {
+        boost::typeindex::type_id<KernelName *>().pretty_name()
+      };
+#endif
+      f();
+    }
+#ifdef TRISYCL_TRACE_KERNEL
     TRISYCL_INTERNAL_DUMP(
       "Kernel stopped "
       << boost::typeindex::type_id<KernelName *>().pretty_name());
+#endif
   };
 #else
   // Identity by default
@@ -0,0 +1,371 @@
+#ifndef TRISYCL_SYCL_DETAIL_EVENT_LOG_HPP
+#define TRISYCL_SYCL_DETAIL_EVENT_LOG_HPP
+
+/** \file A binary event log with a low overhead
+
+    With the TRISYCL_EVENT_LOG CPP flag, TRISYCL_DUMP() and
+    TRISYCL_DUMP_T() do not format anything. Instead they write a
+    fixed-size record into a lock-free ring of the current thread. The
+    record holds:
+    - a timestamp;
+    - the call site, with the text of the expression;
+    - up to 3 of the pointer or arithmetic values of the expression.
+
+    A background thread decodes the records into the file named by the
+    TRISYCL_EVENT_LOG_FILE environment variable, or into std::clog by
+    default. The rings are never blocking. A thread writing faster than
+    they are decoded overwrites its oldest records, and the loss is
+    reported.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/** Record an event with the text of \p expression and the values
+    inserted into it
+*/
+#define TRISYCL_EVENT_LOG_RECORD(expression) do {                        \
+    static constexpr ::trisycl::detail::event_log::site                 \
+      trisycl_event_log_site { __FILE__, __LINE__, #expression };       \
+    ::trisycl::detail::event_log::arguments trisycl_event_log_arguments; \
+    trisycl_event_log_arguments << expression;                          \
+    ::trisycl::detail::event_log::record(&trisycl_event_log_site,        \
+                                         trisycl_event_log_arguments);  \
+  } while(0)
+
+namespace trisycl::detail {
+
+/** \addtogroup debug_trace Debugging and tracing support
+    @{
+*/
+
+/// The log of the events of all the threads
+class event_log {
+
+  using clock = std::chrono::steady_clock;
+
+public:
+
+  /// A place in the code recording an event
+  struct site {
+    const char *file;
+    int line;
+    const char *text;
+  };
+
+
+  /// The kind of a value recorded with an event
+  enum class kind : std::uint8_t { pointer, signed_integer,
+                                   unsigned_integer, floating_point };
+
+
+  /** The values inserted into the expression of an event
+
+      The strings are already in the text of the site and the other
+      values are ignored.
+  */
+  struct arguments {
+    static constexpr std::size_t max = 3;
+
+    std::array<std::uint64_t, max> values;
+
+    std::array<kind, max> kinds;
+
+    std::size_t size = 0;
+
+
+    template <typename T>
+    arguments &operator<<(const T &v) {
+      if (size == max)
+        return *this;
+      using U = std::decay_t<T>;
+      if constexpr (std::is_pointer_v<U>
+                    && !std::is_same_v<U, const char *>
+                    && !std::is_same_v<U, char *>
+                    && !std::is_function_v<std::remove_pointer_t<U>>)
+        add(kind::pointer, reinterpret_cast<std::uintptr_t>(v));
+      else if constexpr (std::is_floating_point_v<U>) {
+        double d = v;
+        std::uint64_t bits;
+        std::memcpy(&bits, &d, sizeof bits);
+        add(kind::floating_point, bits);
+      }
+      else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        add(kind::signed_integer, static_cast<std::int64_t>(v));
+      else if constexpr (std::is_integral_v<U> || std::is_enum_v<U>)
+        add(kind::unsigned_integer, static_cast<std::uint64_t>(v));
+      else if constexpr (requires {
+                           requires std::is_pointer_v<decltype(v.get())>;
+                         })
+        // Some smart pointer
+        add(kind::pointer, reinterpret_cast<std::uintptr_t>(v.get()));
+      return *this;
+    }
+
+
+    /// Ignore the I/O manipulators like std::endl
+    arguments &operator<<(std::ostream &(*)(std::ostream &)) {
+      return *this;
+    }
+
+
+    void add(kind k, std::uint64_t v) {
+      kinds[size] = k;
+      values[size++] = v;
+    }
+  };
+
+private:
+
+  /// The number of records of the ring of a thread, a power of 2
+  static constexpr std::size_t ring_size = 1024;
+
+  /** A record in a ring
+
+      The fields are relaxed atomics so the background thread can read
+      a record which is being overwritten, detecting it afterwards.
+  */
+  struct record_slot {
+    std::atomic<std::uint64_t> time;
+    std::atomic<const site *> where;
+    std::atomic<std::uint64_t> kinds;
+    std::array<std::atomic<std::uint64_t>, arguments::max> values;
+  };
+
+
+  /// The ring of a thread, with a single writer
+  struct ring {
+    /// The number of the thread in the log
+    std::size_t tid;
+
+    /// The number of records written since the start
+    alignas(64) std::atomic<std::uint64_t> written = 0;
+
+    /// The number of records read by the background thread
+    alignas(64) std::uint64_t read = 0;
+
+    std::array<record_slot, ring_size> slots;
+  };
+
+
+  /// The time origin of the log
+  static inline const clock::time_point origin = clock::now();
+
+  /// The rings of each thread, kept after the exit of their thread
+  std::vector<std::shared_ptr<ring>> rings;
+
+  /// To protect the list of the rings
+  std::mutex m;
+
+  /// To decode the rings from only one thread at a time
+  std::mutex decoding;
+
+  /// To wake up the background thread earlier at the end
+  std::condition_variable wake_up;
+
+  /// Set to have the background thread exit
+  bool stopping = false;
+
+  /// Where the events are decoded
+  std::ofstream file;
+
+  std::ostream *output = &std::clog;
+
+  /// The background thread decoding the records
+  std::thread decoder;
+
+
+  event_log() {
+    if (auto name = std::getenv("TRISYCL_EVENT_LOG_FILE")) {
+      file.open(name);
+      output = &file;
+    }
+    decoder = std::thread { [this] { run(); } };
+  }
+
+
+  /// Register the ring of a new thread
+  std::shared_ptr<ring> add_ring() {
+    auto r = std::make_shared<ring>();
+    std::lock_guard<std::mutex> lg { m };
+    r->tid = rings.size();
+    rings.push_back(r);
+    return r;
+  }
+
+
+  /// Get the ring of the current thread, registered on first use
+  ring &current() {
+    static thread_local std::shared_ptr<ring> r = add_ring();
+    return *r;
+  }
+
+
+  /// Decode the new records of the ring \p r
+  void drain(ring &r) {
+    auto end = r.written.load(std::memory_order_acquire);
+    if (end - r.read > ring_size) {
+      *output << "event_log: thread " << r.tid << " lost "
+              << end - r.read - ring_size << " events\n";
+      r.read = end - ring_size;
+    }
+    for (; r.read != end; ++r.read) {
+      auto &s = r.slots[r.read % ring_size];
+      auto time = s.time.load(std::memory_order_relaxed);
+      auto where = s.where.load(std::memory_order_relaxed);
+      auto kinds = s.kinds.load(std::memory_order_relaxed);
+      std::array<std::uint64_t, arguments::max> values;
+      for (std::size_t i = 0; i != values.size(); ++i)
+        values[i] = s.values[i].load(std::memory_order_relaxed);
+      /* Skip the record if it may have been overwritten while being
+         read, including by a record not counted as written yet */
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (r.written.load(std::memory_order_relaxed) - r.read >= ring_size)
+        continue;
+      decode(r.tid, time, *where, kinds, values);
+    }
+  }
+
+
+  /// Write a record in text
+  void decode(std::size_t tid, std::uint64_t time, const site &where,
+              std::uint64_t kinds,
+              const std::array<std::uint64_t, arguments::max> &values) {
+    auto &o = *output;
+    o << time << " ns thread " << tid << ' ' << where.file << ':'
+      << where.line << ": " << where.text;
+    // The low byte is the number of values, then a byte per kind
+    for (std::size_t i = 0; i != (kinds & 0xff); ++i) {
+      o << (i == 0 ? " [" : ", ");
+      auto v = values[i];
+      switch (static_cast<kind>(kinds >> 8*(i + 1) & 0xff)) {
+      case kind::pointer:
+        o << reinterpret_cast<const void *>(static_cast<std::uintptr_t>(v));
+        break;
+      case kind::signed_integer:
+        o << static_cast<std::int64_t>(v);
+        break;
+      case kind::unsigned_integer:
+        o << v;
+        break;
+      case kind::floating_point:
+        double d;
+        std::memcpy(&d, &v, sizeof d);
+        o << d;
+        break;
+      }
+    }
+    o << ((kinds & 0xff) ? "]\n" : "\n");
+  }
+
+
+
+
+  /// The background thread job
+  void run() {
+    std::unique_lock<std::mutex> ul { m };
+    while (!stopping) {
+      wake_up.wait_for(ul, std::chrono::milliseconds { 10 });
+      ul.unlock();
+      flush();
+      ul.lock();
+    }
+  }
+
+public:
+
+  /** Whether the log of the process has been destroyed
+
+      The threads still running after its destruction at the program
+      exit do not record anything.
+  */
+  static inline std::atomic<bool> finished = false;
+
+
+  /// Get the log of the process, started on first use
+  static event_log &instance() {
+    static event_log l;
+    return l;
+  }
+
+
+  /// Record an event of the current thread
+  static void record(const site *where, const arguments &a) {
+    if (finished)
+      return;
+    auto &r = instance().current();
+    auto n = r.written.load(std::memory_order_relaxed);
+    auto &s = r.slots[n % ring_size];
+    s.time.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   clock::now() - origin).count(),
+                 std::memory_order_relaxed);
+    s.where.store(where, std::memory_order_relaxed);
+    std::uint64_t kinds = a.size;
+    for (std::size_t i = 0; i != a.size; ++i) {
+      kinds |= static_cast<std::uint64_t>(a.kinds[i]) << 8*(i + 1);
+      s.values[i].store(a.values[i], std::memory_order_relaxed);
+    }
+    s.kinds.store(kinds, std::memory_order_relaxed);
+    r.written.store(n + 1, std::memory_order_release);
+  }
+
+
+  /** Decode the events recorded so far, for example before a
+      crash analysis
+  */
+  void flush() {
+    std::lock_guard<std::mutex> dlg { decoding };
+    std::vector<std::shared_ptr<ring>> snapshot;
+    {
+      std::lock_guard<std::mutex> lg { m };
+      snapshot = rings;
+    }
+    for (auto &r : snapshot)
+      drain(*r);
+    output->flush();
+  }
+
+
+  /// Decode the remaining records before stopping the background thread
+  ~event_log() {
+    finished = true;
+    {
+      std::lock_guard<std::mutex> lg { m };
+      stopping = true;
+    }
+    wake_up.notify_one();
+    decoder.join();
+    flush();
+  }
+
+};
+
+/// @} End the debug_trace Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_EVENT_LOG_HPP
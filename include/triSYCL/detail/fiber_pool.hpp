@@ -13,6 +13,12 @@
     It allows the execution of some callable and return some future
     for later shepherding.
 
+    Any thread can submit some work through a buffered channel, which
+    is drained by all the threads of the pool. The work submitted from
+    a fiber of the pool does not go through the channel but starts a
+    fiber directly on the current thread, where the work-stealing
+    scheduler lets the other threads steal it.
+
 
     Ronan at Keryell point FR
 
@@ -20,11 +26,27 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <type_traits>
 #include <vector>
-#include <boost/fiber/all.hpp>
+#include <boost/fiber/barrier.hpp>
+#include <boost/fiber/buffered_channel.hpp>
+#include <boost/fiber/channel_op_status.hpp>
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/fiber.hpp>
+#include <boost/fiber/future.hpp>
+#include <boost/fiber/mutex.hpp>
+#include <boost/fiber/operations.hpp>
+#include <boost/fiber/policy.hpp>
 #include <boost/thread/barrier.hpp>
-#include <range/v3/all.hpp>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/transform.hpp>
 
 /** Some global triSYCL configuration */
 #include "triSYCL/detail/global_config.hpp"
@@ -52,8 +74,21 @@ private:
   /// The thread running the Boost.Fiber schedulers to do the work
   std::vector<std::future<void>> working_threads;
 
-  /// The queue to submit work
-  boost::fibers::unbuffered_channel<std::function<void(void)>> submission;
+  /** The number of submissions buffered before the submitters wait,
+      a power of 2 as required by the channel
+  */
+  static constexpr std::size_t submission_capacity = 1024;
+
+  /// The queue to submit work from any thread
+  boost::fibers::buffered_channel<std::function<void(void)>> submission {
+    submission_capacity };
+
+  /// The number of fibers started and not finished yet
+  std::atomic<std::size_t> live = 0;
+
+  /// To wait for the last fiber when the pool is joined
+  boost::fibers::mutex live_mutex;
+  boost::fibers::condition_variable all_finished;
 
   //static auto constexpr starting_mode = boost::fibers::launch::post;
   static auto constexpr starting_mode = boost::fibers::launch::dispatch;
@@ -70,6 +105,9 @@ private:
   /// The model of scheduler
   sched s;
 
+  /// The number of threads running the fibers
+  int thread_number;
+
   // Pool context for the work-stealing scheduler
   pooled_work_stealing::ctx pc_stealing;
 
@@ -89,6 +127,7 @@ public:
     : starting_block { static_cast<unsigned int>(thread_number) + 1 }
     , finish_line { static_cast<unsigned int>(thread_number) }
     , s { scheduler }
+    , thread_number { thread_number }
   {
     if (scheduler == sched::shared_work)
       // This scheduler needs a shared context
@@ -99,9 +138,9 @@ public:
         (thread_number, suspend);
     // Start the working threads
     working_threads = ranges::iota_view { 0, thread_number }
-                    | ranges::views::transform([&] (int i) {
+                    | ranges::views::transform([&] (int) {
                         return std::async(std::launch::async,
-                                          [&, i] { run(i); }); })
+                                          [&] { run(); }); })
                     | ranges::to<std::vector>;
     // Wait for all thread workers to be ready
     starting_block.count_down_and_wait();
@@ -110,6 +149,9 @@ public:
 
   /** Submit some work on a new fiber
 
+      From a fiber of the pool, the new fiber starts on the current
+      thread without going through the submission channel.
+
       \param[in] work is the callable to execute, taking no arguments
       and returning a result of some type R
 
@@ -117,19 +159,72 @@ public:
   */
   template <typename Callable>
   auto submit(Callable && work) {
+    using result = std::invoke_result_t<Callable>;
     // Put the packaged_task into a shared_ptr to fit it later in a
     // lambda in a std::function since the type is move-only
-    auto pt = std::make_shared<boost::fibers::packaged_task<void(void)>>
+    auto pt = std::make_shared<boost::fibers::packaged_task<result(void)>>
       ([w = std::forward<Callable>(work)] () mutable { return w(); });
     auto f = pt->get_future();
-    // Submit a lambda to do the type erasure so the submission queue
+    // Use a lambda to do the type erasure so the submission queue
     // type is independent of the type of the packaged_task
-    submission.push([p = std::move(pt)] () mutable { (*p)(); });
+    post([p = std::move(pt)] () mutable { (*p)(); });
     // Return the future to the client to get the result or the exception
     return f;
   }
 
 
+  /** Submit \p n instances of some work, each one on its own fiber
+
+      The whole batch is a single submission, whose fibers are all
+      started by the thread receiving it.
+
+      \param[in] work is the callable to execute, taking the
+      std::size_t index of the instance and returning a result of some
+      type R
+
+      \return a std::vector<future<R>> with the future of each instance
+  */
+  template <typename Callable>
+  auto submit_n(std::size_t n, Callable && work) {
+    using result = std::invoke_result_t<Callable, std::size_t>;
+    using task = boost::fibers::packaged_task<result(void)>;
+    auto w = std::make_shared<std::decay_t<Callable>>
+      (std::forward<Callable>(work));
+    auto tasks = std::make_shared<std::vector<task>>();
+    std::vector<future<result>> futures;
+    tasks->reserve(n);
+    futures.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+      tasks->emplace_back([w, i] { return (*w)(i); });
+      futures.push_back(tasks->back().get_future());
+    }
+    post([this, tasks = std::move(tasks)] {
+        for (auto &t : *tasks)
+          launch([t = std::move(t)] () mutable { t(); });
+      });
+    return futures;
+  }
+
+
+  /// Get the number of threads running the fibers
+  int get_thread_number() const {
+    return thread_number;
+  }
+
+
+  /** Get the pool the current thread is running the fibers of, or
+      nullptr if this is not a thread of a pool
+
+      A fiber launched from such a thread runs on this pool too, and
+      with the work-stealing scheduler the other threads of the pool
+      can steal it.
+  */
+  static fiber_pool *&current() {
+    static thread_local fiber_pool *p = nullptr;
+    return p;
+  }
+
+
   /// Close the submission
   void close() {
     // Can be done many times, so no protection required here
@@ -166,36 +261,64 @@ public:
 
 private:
 
+  /** Start some type-erased work on a new fiber of the current
+      thread, tracked up to its end to join the pool
+  */
+  template <typename Work>
+  void launch(Work && work) {
+    live.fetch_add(1, std::memory_order_relaxed);
+    boost::fibers::fiber { starting_mode,
+      [this, w = std::forward<Work>(work)] () mutable {
+        w();
+        if (live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+          // Lock to not notify between the test and the wait of join
+          std::unique_lock lock { live_mutex };
+          all_finished.notify_all();
+        }
+      } }.detach();
+  }
+
+
+  /// Start some type-erased work from the current thread if it is ours
+  template <typename Work>
+  void post(Work && work) {
+    if (current() == this)
+      launch(std::forward<Work>(work));
+    else
+      submission.push(std::forward<Work>(work));
+  }
+
+
   /// The thread worker job
-  void run(int i) {
+  void run() {
+    current() = this;
     if (s == sched::shared_work)
       boost::fibers::use_scheduling_algorithm<pooled_shared_work>(pc_shared);
     else if (s == sched::work_stealing)
       boost::fibers::use_scheduling_algorithm
         <pooled_work_stealing>(pc_stealing);
-    // Otherwise a round-robin scheduler is used and the fibers will
-    // use only 1 thread since there is no thread migration in that
-    // case
+    // Otherwise a round-robin scheduler is used and the fibers stay
+    // on the thread which received their work since there is no
+    // thread migration in that case
 
     // Wait for all thread workers to be ready
     starting_block.count_down_and_wait();
 
-    // Only the first thread receives and starts the work
-    if (i == 0) {
-      // Keep track of each fiber execution to avoid quitting before completion
-      std::vector<boost::fibers::fiber> fibers;
-      for (;;) {
-        decltype(submission)::value_type work;
-        if (submission.pop(work)
-            == boost::fibers::channel_op_status::closed)
-          // Someone asked to stop accepting work
-          break;
-        // Launch the work on a new fiber
-        fibers.emplace_back(starting_mode, std::move(work));
-      }
-      // Now wait for the completion of each fiber
-      for (auto &f : fibers)
-        f.join();
+    // All the threads receive and start the work
+    for (;;) {
+      decltype(submission)::value_type work;
+      if (submission.pop(work)
+          == boost::fibers::channel_op_status::closed)
+        // Someone asked to stop accepting work
+        break;
+      // Launch the work on a new fiber
+      launch(std::move(work));
+    }
+    /* Now wait for the completion of all the fibers, including the
+       ones they start, which can only happen while some are alive */
+    {
+      std::unique_lock lock { live_mutex };
+      all_finished.wait(lock, [&] { return live == 0; });
     }
     // Wait for all the threads to finish their fiber execution
     finish_line.wait();
@@ -9,7 +9,9 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <array>
 #include <cstddef>
+#include <iterator>
 
 namespace trisycl::detail {
 
@@ -23,8 +25,10 @@ namespace trisycl::detail {
     functions.
 */
 template <typename Range, typename Id>
-size_t constexpr inline linear_id(Range range, Id id, Id offset = {}) {
-  auto dims = std::distance(std::begin(range), std::end(range));
+size_t constexpr inline linear_id(const Range &range,
+                                  const Id &id,
+                                  const Id &offset = {}) {
+  int dims = std::distance(std::begin(range), std::end(range));
 
   size_t linear_id = 0;
   /* A good compiler should unroll this and do partial evaluation to
@@ -37,6 +41,48 @@ size_t constexpr inline linear_id(Range range, Id id, Id offset = {}) {
 }
 
 
+/** The strides of the linearization done by linear_id(), to compute
+    a linearized access without the multiplication chain
+
+    The strides are computed once for a range, then a linear id is a
+    dot product with them, which is reduced to an addition of the
+    stride when moving along a dimension in a loop.
+*/
+template <int Dimensions>
+struct linear_strides {
+  std::array<size_t, Dimensions> stride;
+
+  constexpr linear_strides() = default;
+
+
+  /// Compute the strides of \p range, the dimension 0 being contiguous
+  template <typename Range>
+  constexpr explicit linear_strides(const Range &range) : stride {} {
+    size_t s = 1;
+    for (int i = 0; i != Dimensions; ++i) {
+      stride[i] = s;
+      s *= range[i];
+    }
+  }
+
+
+  /// The stride of a dimension
+  constexpr size_t operator[](int dimension) const {
+    return stride[dimension];
+  }
+
+
+  /// Compute the same value as linear_id() on the range of the strides
+  template <typename Id>
+  constexpr size_t operator()(const Id &id) const {
+    size_t linear_id = 0;
+    for (int i = 0; i != Dimensions; ++i)
+      linear_id += stride[i]*id[i];
+    return linear_id;
+  }
+};
+
+
 /// @} End the helpers Doxygen group
 
 }
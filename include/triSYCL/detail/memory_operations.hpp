@@ -0,0 +1,269 @@
+#ifndef TRISYCL_SYCL_DETAIL_MEMORY_OPERATIONS_HPP
+#define TRISYCL_SYCL_DETAIL_MEMORY_OPERATIONS_HPP
+
+/** \file
+
+    The bulk memory operations of the explicit memory commands of the
+    handler executed on the host, including the reads from a file
+
+    The large operations are split among some threads, each one
+    processing a contiguous slice, and the copies and the byte fills
+    use some non-temporal stores so they do not evict the working set
+    of the other kernels from the caches with data which are not read
+    back soon.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/exception.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** The size in bytes from which a memory operation is split among
+    some threads and uses non-temporal stores
+
+    Below, the operation is likely to stay in the caches and the start
+    of a parallel team would dominate.
+*/
+inline constexpr std::size_t parallel_memory_threshold = 1 << 20;
+
+
+/** Call \p f(first, last) on some slices of [0, \p count) elements
+    of \p element_size bytes, in parallel if they are large enough
+
+    The slice boundaries are multiple of \p granularity elements, so
+    they do not split a cache line.
+*/
+template <typename Slice>
+void parallel_slices(std::size_t count,
+                     [[maybe_unused]] std::size_t element_size,
+                     [[maybe_unused]] std::size_t granularity, Slice f) {
+#ifdef _OPENMP
+  if (count*element_size >= parallel_memory_threshold) {
+    // Do not oversubscribe the cores with the running kernels
+    auto share = concurrency_governor::instance().acquire();
+    auto chunks = (count + granularity - 1)/granularity;
+#pragma omp parallel num_threads(share.get_threads())
+    {
+      std::size_t t = omp_get_thread_num();
+      std::size_t n = omp_get_num_threads();
+      auto first = std::min(count, chunks*t/n*granularity);
+      auto last = std::min(count, chunks*(t + 1)/n*granularity);
+      if (first != last)
+        f(first, last);
+    }
+    return;
+  }
+#endif
+  f(0, count);
+}
+
+
+/** Copy \p count bytes with non-temporal stores when possible
+
+    The memory areas cannot overlap.
+*/
+inline void stream_copy(std::byte *dest, const std::byte *src,
+                        std::size_t count) {
+#ifdef __SSE2__
+  // Reach a 16-byte aligned destination with a normal copy
+  auto head = std::min(count,
+                       -reinterpret_cast<std::uintptr_t>(dest) % 16);
+  std::memcpy(dest, src, head);
+  dest += head;
+  src += head;
+  count -= head;
+  for (; count >= 16; count -= 16, dest += 16, src += 16)
+    _mm_stream_si128(reinterpret_cast<__m128i *>(dest),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+  // Order the non-temporal stores before the next ones
+  _mm_sfence();
+#endif
+  std::memcpy(dest, src, count);
+}
+
+
+/// Set \p count bytes to \p value with non-temporal stores when possible
+inline void stream_set(std::byte *dest, unsigned char value,
+                       std::size_t count) {
+#ifdef __SSE2__
+  auto head = std::min(count,
+                       -reinterpret_cast<std::uintptr_t>(dest) % 16);
+  std::memset(dest, value, head);
+  dest += head;
+  count -= head;
+  auto pattern = _mm_set1_epi8(static_cast<char>(value));
+  for (; count >= 16; count -= 16, dest += 16)
+    _mm_stream_si128(reinterpret_cast<__m128i *>(dest), pattern);
+  _mm_sfence();
+#endif
+  std::memset(dest, value, count);
+}
+
+
+/// Copy \p count bytes from \p src to \p dest, which cannot overlap
+inline void parallel_memcpy(void *dest, const void *src, std::size_t count) {
+  if (count < parallel_memory_threshold) {
+    std::memcpy(dest, src, count);
+    return;
+  }
+  auto d = static_cast<std::byte *>(dest);
+  auto s = static_cast<const std::byte *>(src);
+  parallel_slices(count, 1, 64, [=] (std::size_t first, std::size_t last) {
+      stream_copy(d + first, s + first, last - first);
+    });
+}
+
+
+/** Copy \p count bytes from some rows of \p src_row bytes starting
+    \p src_pitch bytes apart to some rows of \p dest_row bytes starting
+    \p dest_pitch bytes apart, as between some storages with padded
+    rows
+
+    The memory areas cannot overlap.
+*/
+inline void parallel_copy_rows(void *dest, std::size_t dest_row,
+                               std::size_t dest_pitch, const void *src,
+                               std::size_t src_row, std::size_t src_pitch,
+                               std::size_t count) {
+  if (count == 0)
+    return;
+  if (dest_row == dest_pitch && src_row == src_pitch) {
+    parallel_memcpy(dest, src, count);
+    return;
+  }
+  auto d = static_cast<std::byte *>(dest);
+  auto s = static_cast<const std::byte *>(src);
+  if (dest_row != src_row) {
+    // Copy the pieces between the ends of the rows of both sides
+    for (std::size_t di = 0, si = 0; count;) {
+      auto n = std::min({ count, dest_row - di, src_row - si });
+      std::memcpy(d + di, s + si, n);
+      count -= n;
+      if ((di += n) == dest_row) {
+        d += dest_pitch;
+        di = 0;
+      }
+      if ((si += n) == src_row) {
+        s += src_pitch;
+        si = 0;
+      }
+    }
+    return;
+  }
+  auto rows = count/src_row;
+  auto stream = count >= parallel_memory_threshold;
+  parallel_slices(rows, src_row, 1, [=] (std::size_t first, std::size_t last) {
+      for (auto r = first; r != last; ++r)
+        if (stream)
+          stream_copy(d + r*dest_pitch, s + r*src_pitch, src_row);
+        else
+          std::memcpy(d + r*dest_pitch, s + r*src_pitch, src_row);
+    });
+  // A last partial row
+  std::memcpy(d + rows*dest_pitch, s + rows*src_pitch, count % src_row);
+}
+
+
+/// Set \p count bytes from \p ptr to \p value
+inline void parallel_memset(void *ptr, unsigned char value,
+                            std::size_t count) {
+  if (count < parallel_memory_threshold) {
+    std::memset(ptr, value, count);
+    return;
+  }
+  auto p = static_cast<std::byte *>(ptr);
+  parallel_slices(count, 1, 64, [=] (std::size_t first, std::size_t last) {
+      stream_set(p + first, value, last - first);
+    });
+}
+
+
+/// Set \p count elements from \p ptr to \p pattern
+template <typename T>
+void parallel_fill(T *ptr, const T &pattern, std::size_t count) {
+  parallel_slices(count, sizeof(T), std::max<std::size_t>(1, 64/sizeof(T)),
+                  [=] (std::size_t first, std::size_t last) {
+                    std::fill(ptr + first, ptr + last, pattern);
+                  });
+}
+
+
+/** Read into \p dest the \p count bytes at the byte \p offset of the
+    file descriptor \p fd
+
+    The slices of a large read are read concurrently with pread(), so
+    a fast storage device gets several requests in flight.
+
+    \throw runtime_error if the file cannot be read or is too short
+*/
+inline void parallel_read(int fd, void *dest, std::size_t count,
+                          std::uint64_t offset) {
+#if __has_include(<unistd.h>)
+  auto d = static_cast<std::byte *>(dest);
+  // The errno of a failing slice, or -1 at the end of the file
+  std::atomic<int> error = 0;
+  parallel_slices(count, 1, 4096, [=, &error] (std::size_t first,
+                                               std::size_t last) {
+      while (first != last && !error.load(std::memory_order_relaxed)) {
+        auto n = ::pread(fd, d + first, last - first, offset + first);
+        if (n > 0)
+          first += n;
+        else if (n == 0)
+          error = -1;
+        else if (errno != EINTR)
+          error = errno;
+      }
+    });
+  if (error < 0)
+    throw ::trisycl::runtime_error { "The file is too short" };
+  if (error)
+    throw ::trisycl::runtime_error {
+      std::string { "Cannot read the file: " } + std::strerror(error)
+    };
+#else
+  throw ::trisycl::runtime_error { "Reading a file needs pread()" };
+#endif
+}
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_MEMORY_OPERATIONS_HPP
@@ -0,0 +1,146 @@
+#ifndef TRISYCL_SYCL_DETAIL_NATIVE_VECTOR_HPP
+#define TRISYCL_SYCL_DETAIL_NATIVE_VECTOR_HPP
+
+/** \file
+
+    Map a SYCL vec to a native SIMD vector type of the compiler
+
+    With GCC and Clang, the vector_size extension gives a type holding
+    the elements of a vec in a SIMD register, so the element-wise
+    operations on it are single SSE, AVX or NEON instructions instead
+    of a scalar loop. The vec keeps its std::array storage with the
+    layout and alignment required by SYCL and is only loaded into the
+    native type for the duration of an operation, which the compiler
+    turns into register moves.
+
+    A vec of 3 elements uses a native vector of 4 elements, as its
+    alignment. The vec larger than the SIMD registers enabled, such as
+    a float8 without AVX, keep the scalar loops. The native path can be
+    disabled by defining \c TRISYCL_NO_NATIVE_VEC.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+#include "triSYCL/detail/alignment_helper.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup vector Vector types in SYCL
+    @{
+*/
+
+/// The element-wise operators are not available on this type
+struct no_native_vector {};
+
+
+/// By default there is no native vector type for a small_array heir
+template <typename FinalType>
+struct native_vector {
+  static constexpr bool value = false;
+
+  using type = no_native_vector;
+};
+
+#if defined(__GNUC__) && !defined(TRISYCL_NO_NATIVE_VEC)
+
+/** The size in bytes of the widest SIMD registers enabled
+
+    A wider native vector would be split by the compiler anyway and
+    would change the ABI of the functions using it.
+*/
+inline constexpr int max_native_vector_bytes =
+#if defined(__AVX512F__)
+  64;
+#elif defined(__AVX__)
+  32;
+#else
+  16;
+#endif
+
+
+/// A native vector of Bytes bytes of T elements
+template <typename T, int Bytes>
+struct vector_of {
+  typedef T type __attribute__((vector_size(Bytes)));
+};
+
+
+/// The native vector type of a vec with more than 1 arithmetic element
+template <typename DataType, int NumElements>
+  requires(std::is_arithmetic_v<DataType> && !std::is_same_v<DataType, bool>
+           && NumElements > 1
+           && std::has_single_bit(unsigned(
+                alignment_v<::trisycl::vec<DataType, NumElements>>))
+           && alignment_v<::trisycl::vec<DataType, NumElements>>
+              <= max_native_vector_bytes)
+struct native_vector<::trisycl::vec<DataType, NumElements>> {
+  static constexpr bool value = true;
+
+  /// The number of bytes, with the padding element of a vec of 3
+  static constexpr int bytes =
+    alignment_v<::trisycl::vec<DataType, NumElements>>;
+
+  using type = typename vector_of<DataType, bytes>::type;
+
+
+  /** Load the elements of a vec
+
+      \param[in] padding is the value of the extra element of a vec of
+      3, such as 1 to avoid a division by 0
+  */
+  static type load(const DataType *elements, DataType padding = 0) {
+    type v;
+    if constexpr (NumElements == 3)
+      v[3] = padding;
+    std::memcpy(&v, elements, NumElements*sizeof(DataType));
+    return v;
+  }
+
+
+  /// Store the elements of a vec
+  static void store(const type &v, DataType *elements) {
+    std::memcpy(elements, &v, NumElements*sizeof(DataType));
+  }
+
+
+  /// Get a value from the result of an element-wise operation
+  template <typename Value>
+  static type from_value(const Value &v) {
+    return v;
+  }
+
+
+  /** Get the 0 or 1 values of a vec from the result of an
+      element-wise comparison, which is 0 or -1 on each element
+  */
+  template <typename Mask>
+  static type from_mask(const Mask &m) {
+    return __builtin_convertvector(-m, type);
+  }
+
+};
+
+#endif
+
+/// Test whether a small_array heir has a native vector type
+template <typename FinalType>
+constexpr bool has_native_vector_v = native_vector<FinalType>::value;
+
+/// @} End the vector Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_NATIVE_VECTOR_HPP
@@ -0,0 +1,110 @@
+#ifndef TRISYCL_SYCL_DETAIL_PARTITIONING_HPP
+#define TRISYCL_SYCL_DETAIL_PARTITIONING_HPP
+
+/** \file
+
+    Describe how the iteration space of a kernel is split into chunks
+    for the threads and in which order it is walked
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <cstddef>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The chunking of the iteration space of the kernels of a queue
+struct partitioning {
+
+  /// The order of execution of the work-items of a 2D or 3D kernel
+  enum class order {
+    /// Row-major, with only the first dimension split among the threads
+    row_major,
+    /// Row-major by tiles
+    tiled,
+    /// The tiles along a Morton (Z-order) curve
+    morton,
+    /// The tiles along a Hilbert curve
+    hilbert
+  };
+
+  /// The TBB partitioner used to split the iteration space
+  enum class kind {
+    /// Split adaptively according to the work stealing
+    auto_partitioner,
+    /** Like auto_partitioner but replay the chunk to thread mapping of
+        the previous launch of the same kernel, for cache reuse, or
+        with OpenMP keep the slices of all the kernels on the same
+        range on the same CPUs */
+    affinity_partitioner,
+    /// Split evenly among the threads once for all
+    static_partitioner,
+    /// Split down to the grain size
+    simple_partitioner
+  };
+
+  /// The OpenMP schedule of the loop distributing the iteration space
+  enum class schedule {
+    /// Split evenly among the threads once for all
+    static_schedule,
+    /// Give the chunks to the threads as they become idle
+    dynamic_schedule,
+    /// Like dynamic_schedule but with decreasing chunks
+    guided_schedule
+  };
+
+  kind partitioner = kind::auto_partitioner;
+
+  schedule scheduling = schedule::static_schedule;
+
+  /** The number of iterations of the distributed loop given at once to
+      an OpenMP thread, or 0 for the default of the schedule */
+  std::size_t chunk_size = 0;
+
+  /** The maximum number of OpenMP threads executing a kernel, or 0 to
+      use all the threads the concurrency governor gives */
+  std::size_t team_size = 0;
+
+  /** The minimum number of work-items of a chunk along the last
+      dimension of the iteration space */
+  std::size_t grain_size = 1;
+
+  order iteration = order::row_major;
+
+  /** The extents of a tile for the tiled orders, a kernel with N
+      dimensions using the last N ones */
+  std::array<std::size_t, 3> tile = { 8, 8, 64 };
+
+
+  /** The partitioning of the kernel running on the current thread
+
+      It is set by the task running the kernel from its queue.
+  */
+  static const partitioning *&current() {
+    static thread_local const partitioning *p = nullptr;
+    return p;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_PARTITIONING_HPP
@@ -0,0 +1,259 @@
+#ifndef TRISYCL_SYCL_DETAIL_PERF_COUNTERS_HPP
+#define TRISYCL_SYCL_DETAIL_PERF_COUNTERS_HPP
+
+/** \file Sample the hardware performance counters of the threads
+    executing a kernel
+
+    On Linux each thread opens on first use a group of perf_event
+    counters of its own user-space cycles, instructions, cache
+    references and cache misses. A scope reads them at its start and at
+    its end and adds the difference to the sample of the kernel being
+    executed, so the threads of an OpenMP team or the TBB workers
+    running some chunks of the same kernel cumulate into one sample.
+
+    When the counters cannot be opened, for example because of the
+    kernel.perf_event_paranoid setting or on another system, the samples
+    just stay at 0.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <cstdint>
+
+#if __has_include(<linux/perf_event.h>)
+#define TRISYCL_PERF_EVENT 1
+#include <array>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The hardware performance counters of the threads
+class perf_counters {
+
+public:
+
+  /// Some counter values
+  struct values {
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cache_references = 0;
+    std::uint64_t cache_misses = 0;
+
+
+    values &operator+=(const values &v) {
+      cycles += v.cycles;
+      instructions += v.instructions;
+      cache_references += v.cache_references;
+      cache_misses += v.cache_misses;
+      return *this;
+    }
+
+
+    values operator-(const values &v) const {
+      return { cycles - v.cycles, instructions - v.instructions,
+               cache_references - v.cache_references,
+               cache_misses - v.cache_misses };
+    }
+  };
+
+
+  /// The counters cumulated by all the threads executing a kernel
+  class sample {
+    std::atomic<std::uint64_t> cycles = 0;
+    std::atomic<std::uint64_t> instructions = 0;
+    std::atomic<std::uint64_t> cache_references = 0;
+    std::atomic<std::uint64_t> cache_misses = 0;
+
+  public:
+
+    void add(const values &v) {
+      cycles.fetch_add(v.cycles, std::memory_order_relaxed);
+      instructions.fetch_add(v.instructions, std::memory_order_relaxed);
+      cache_references.fetch_add(v.cache_references,
+                                 std::memory_order_relaxed);
+      cache_misses.fetch_add(v.cache_misses, std::memory_order_relaxed);
+    }
+
+
+    /// Get the values, once all the threads are done with the kernel
+    values get() const {
+      return { cycles.load(std::memory_order_relaxed),
+               instructions.load(std::memory_order_relaxed),
+               cache_references.load(std::memory_order_relaxed),
+               cache_misses.load(std::memory_order_relaxed) };
+    }
+  };
+
+private:
+
+#ifdef TRISYCL_PERF_EVENT
+  /// The counters of a thread, in the order of the values
+  struct group {
+    static constexpr std::size_t size = 4;
+
+    /// The file descriptor of each counter, the first one leading the group
+    std::array<int, size> fds;
+
+    /// The position of each counter in a group read, or -1 if missing
+    std::array<int, size> positions;
+
+    /// The number of counters opened
+    int opened = 0;
+
+
+    static int open(std::uint64_t config, int leader) {
+      perf_event_attr a;
+      std::memset(&a, 0, sizeof a);
+      a.size = sizeof a;
+      a.type = PERF_TYPE_HARDWARE;
+      a.config = config;
+      a.read_format = PERF_FORMAT_GROUP;
+      // Only what the thread does, which is allowed for a normal user
+      a.exclude_kernel = 1;
+      a.exclude_hv = 1;
+      return ::syscall(SYS_perf_event_open, &a, 0, -1, leader, 0);
+    }
+
+
+    group() {
+      const std::array<std::uint64_t, size> configs {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES
+      };
+      for (std::size_t i = 0; i != size; ++i) {
+        fds[i] = open(configs[i], i == 0 ? -1 : fds[0]);
+        positions[i] = fds[i] < 0 ? -1 : opened++;
+        // Without the cycles, there is no group to read
+        if (fds[0] < 0) {
+          opened = 0;
+          return;
+        }
+      }
+    }
+
+
+    ~group() {
+      for (auto fd : fds)
+        if (opened && fd >= 0)
+          ::close(fd);
+    }
+
+
+    /// Read all the counters at once
+    values read() const {
+      if (!opened)
+        return {};
+      // The number of counters followed by their values
+      std::array<std::uint64_t, size + 1> buffer;
+      if (::read(fds[0], buffer.data(), sizeof buffer) <= 0)
+        return {};
+      auto get = [&] (std::size_t i) {
+        return positions[i] < 0 ? 0 : buffer[positions[i] + 1];
+      };
+      return { get(0), get(1), get(2), get(3) };
+    }
+  };
+
+
+  /// Get the counters of the current thread, opened on first use
+  static const group &counters() {
+    static thread_local group g;
+    return g;
+  }
+#endif
+
+public:
+
+  /// Test whether the counters of the current thread can be read
+  static bool is_available() {
+#ifdef TRISYCL_PERF_EVENT
+    return counters().opened != 0;
+#else
+    return false;
+#endif
+  }
+
+
+  /// Read the counters of the current thread
+  static values read() {
+#ifdef TRISYCL_PERF_EVENT
+    return counters().read();
+#else
+    return {};
+#endif
+  }
+
+
+  /** The sample of the kernel executed by the current thread, if it
+      is counted
+
+      It is captured before starting a team of threads to give it to
+      each of them.
+  */
+  static sample *&current() {
+    static thread_local sample *s = nullptr;
+    return s;
+  }
+
+
+  /** Count the events of the current thread into a kernel sample up to
+      the end of the scope
+
+      A thread already counting into the same sample, like the master
+      of an OpenMP team, is not counted twice. With no sample, it costs
+      just a test.
+  */
+  class scope {
+    sample *counting;
+    sample *outer;
+    values start;
+
+  public:
+
+    scope(sample *s)
+      : counting { s && s != current() ? s : nullptr }
+      , outer { current() } {
+      if (counting) {
+        current() = counting;
+        start = read();
+      }
+    }
+
+
+    scope(const scope &) = delete;
+
+
+    ~scope() {
+      if (counting) {
+        counting->add(read() - start);
+        current() = outer;
+      }
+    }
+  };
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_PERF_COUNTERS_HPP
@@ -0,0 +1,287 @@
+#ifndef TRISYCL_SYCL_DETAIL_PLACEMENT_HPP
+#define TRISYCL_SYCL_DETAIL_PLACEMENT_HPP
+
+/** \file
+
+    Place the worker threads, the OpenMP threads of the kernels and the
+    buffer memory on some NUMA nodes
+
+    The slice \c i out of \c n of an iteration space partitioned
+    statically among the threads of a kernel is processed on the node
+    \c i*N/n of the N nodes of the placement. The buffers allocated by
+    triSYCL are first touched with the same partitioning, so on a
+    multi-socket machine a kernel mostly accesses the memory of its own
+    socket.
+
+    With the cache affinity, the thread processing a slice of a kernel
+    is pinned on the CPU given by the position of the slice in the
+    iteration space, so the successive kernels on the same range
+    process the same slices on the same cores and find their data in
+    the caches left by the previous kernel.
+
+    The thread pinning is only implemented on Linux and is a no-op
+    elsewhere.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// A set of NUMA nodes to run on
+struct placement {
+
+  /// The CPUs of each NUMA node of the placement
+  std::vector<std::vector<unsigned>> nodes;
+
+  /// Do not bother spreading the first touch of small buffers
+  static constexpr std::size_t first_touch_threshold = 1 << 20;
+
+  /// The granularity of the memory placement
+  static constexpr std::size_t page_size = 4096;
+
+
+  /** Parse a list of numbers with ranges such as "0-3,8,10-11", as
+      used by Linux for the CPU and node lists
+
+      The parsing stops at the first invalid character.
+  */
+  static std::vector<unsigned> parse_list(std::string_view s) {
+    std::vector<unsigned> l;
+    auto number = [&] (unsigned &n) {
+      if (s.empty() || s.front() < '0' || s.front() > '9')
+        return false;
+      n = 0;
+      while (!s.empty() && s.front() >= '0' && s.front() <= '9') {
+        n = 10*n + (s.front() - '0');
+        s.remove_prefix(1);
+      }
+      return true;
+    };
+    unsigned first, last;
+    while (number(first)) {
+      last = first;
+      if (!s.empty() && s.front() == '-') {
+        s.remove_prefix(1);
+        if (!number(last))
+          break;
+      }
+      for (auto i = first; i <= last; ++i)
+        l.push_back(i);
+      if (s.empty() || s.front() != ',')
+        break;
+      s.remove_prefix(1);
+    }
+    return l;
+  }
+
+
+  /// Get the CPUs of a NUMA node, or nothing if it is unknown
+  static std::vector<unsigned> node_cpus(unsigned node) {
+    std::ifstream f { "/sys/devices/system/node/node"
+                      + std::to_string(node) + "/cpulist" };
+    std::string l;
+    std::getline(f, l);
+    return parse_list(l);
+  }
+
+
+  /// Make a placement on some NUMA nodes
+  static placement from_nodes(const std::vector<unsigned> &node_ids) {
+    placement p;
+    for (auto n : node_ids)
+      p.nodes.push_back(node_cpus(n));
+    return p;
+  }
+
+
+  /** Get the placement given by the \c TRISYCL_NUMA_NODES
+      environment variable, used by the default worker pool and for
+      the first touch of the buffers
+
+      \return nullptr if the variable is not set
+  */
+  static std::shared_ptr<const placement> global() {
+    static auto g = [] () -> std::shared_ptr<const placement> {
+      if (auto e = std::getenv("TRISYCL_NUMA_NODES"))
+        if (auto l = parse_list(e); !l.empty())
+          return std::make_shared<const placement>(from_nodes(l));
+      return nullptr;
+    }();
+    return g;
+  }
+
+
+  /** The placement of the worker running on the current thread, if any
+
+      The kernels executed by the worker use it for their OpenMP
+      threads.
+  */
+  static const placement *&current() {
+    static thread_local const placement *p = nullptr;
+    return p;
+  }
+
+
+  /// Get all the CPUs of the placement
+  std::vector<unsigned> cpus() const {
+    std::vector<unsigned> all;
+    for (auto &n : nodes)
+      all.insert(all.end(), n.begin(), n.end());
+    return all;
+  }
+
+
+  /// Get the node processing the slice \param i out of \param n
+  std::size_t node_of(std::size_t i, std::size_t n) const {
+    return i*nodes.size()/n;
+  }
+
+
+  /// Pin the current thread on some CPUs, if any
+  static void pin(const std::vector<unsigned> &cpus) {
+#ifdef __linux__
+    if (cpus.empty())
+      return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto c : cpus)
+      if (c < CPU_SETSIZE)
+        CPU_SET(c, &set);
+    // Just keep running where we are if it is not allowed
+    sched_setaffinity(0, sizeof(set), &set);
+#endif
+  }
+
+
+  /** Pin the current thread as the thread \param i of a team of \param n
+      threads processing a statically partitioned iteration space
+  */
+  void pin_team_member(std::size_t i, std::size_t n) const {
+    if (!nodes.empty())
+      pin(nodes[node_of(i, n)]);
+  }
+
+
+  /** Get the CPUs the slices of the kernels are kept on with the cache
+      affinity, the ones of the placement \p where if any or the ones
+      the process can run on otherwise
+  */
+  static std::vector<unsigned> affinity_cpus(const placement *where) {
+    if (where)
+      return where->cpus();
+    static const auto process = [] {
+      std::vector<unsigned> all;
+#ifdef __linux__
+      cpu_set_t set;
+      if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (unsigned c = 0; c != CPU_SETSIZE; ++c)
+          if (CPU_ISSET(c, &set))
+            all.push_back(c);
+#endif
+      return all;
+    }();
+    return process;
+  }
+
+
+  /** Pin the current thread, processing the slice \p i out of \p n of
+      the iteration space of a kernel, on the CPU of this position
+      among some \p cpus up to the end of the scope
+
+      The slice \p i starts in the part of the iteration space of the
+      CPU \p i*C/n of C, whatever the number of threads of the kernel.
+      Nothing is done if \p cpus is empty.
+  */
+  class slice_scope {
+#ifdef __linux__
+    /// The CPUs of the thread before the kernel
+    cpu_set_t saved;
+
+    bool pinned = false;
+#endif
+
+  public:
+
+    slice_scope(const std::vector<unsigned> &cpus,
+                [[maybe_unused]] std::size_t i,
+                [[maybe_unused]] std::size_t n) {
+#ifdef __linux__
+      if (cpus.empty())
+        return;
+      pinned = sched_getaffinity(0, sizeof(saved), &saved) == 0;
+      if (pinned)
+        pin({ cpus[i*cpus.size()/n] });
+#endif
+    }
+
+    ~slice_scope() {
+#ifdef __linux__
+      // The thread may execute something else after the kernel
+      if (pinned)
+        sched_setaffinity(0, sizeof(saved), &saved);
+#endif
+    }
+
+    slice_scope(const slice_scope &) = delete;
+    slice_scope &operator=(const slice_scope &) = delete;
+  };
+
+
+  /** Touch the pages of some fresh memory from the nodes which will
+      process them, so the operating system allocates them there
+
+      \param[in] p is the beginning of the memory, which is written
+
+      \param[in] bytes is the size of the memory
+  */
+  void first_touch(void *p, std::size_t bytes) const {
+    if (nodes.empty() || bytes < first_touch_threshold)
+      return;
+    auto memory = static_cast<volatile char *>(p);
+    std::vector<std::thread> touchers;
+    for (std::size_t i = 0; i != nodes.size(); ++i)
+      touchers.emplace_back([&, i] {
+          pin(nodes[i]);
+          auto end = bytes*(i + 1)/nodes.size();
+          for (auto b = bytes*i/nodes.size(); b < end; b += page_size)
+            memory[b] = 0;
+        });
+    for (auto &t : touchers)
+      t.join();
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_PLACEMENT_HPP
@@ -0,0 +1,149 @@
+#ifndef TRISYCL_SYCL_DETAIL_POOL_ALLOCATOR_HPP
+#define TRISYCL_SYCL_DETAIL_POOL_ALLOCATOR_HPP
+
+/** \file
+
+    An allocator recycling the memory of the objects allocated often
+    and one at a time, such as the tasks
+
+    Each allocated type has a free-list of its released objects which
+    is used before asking the system for some memory, so in a steady
+    state of task submission there is no heap allocation.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** A stateless allocator recycling the single objects it allocates
+
+    It is typically used with \c std::allocate_shared, which rebinds it
+    to the type of the object and its control block.
+
+    The free-lists only hold trivially destructible members, so they
+    are still usable by the objects released during the program
+    exit. The cached objects are never given back to the system.
+*/
+template <typename T>
+struct pool_allocator {
+  using value_type = T;
+
+  /// Keep at most this number of released objects per type
+  static constexpr std::size_t max_cached = 256;
+
+private:
+
+  /// The storage of a released object becomes a node of the free-list
+  union node {
+    node *next;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  /// The free-list head
+  static inline constinit node *free_list = nullptr;
+
+  /// The number of objects in the free-list
+  static inline constinit std::size_t cached = 0;
+
+  /** To protect the free-list
+
+      A spin lock is enough since it is taken just for a few
+      instructions, and it does not interfere with the fibers.
+  */
+  static inline constinit std::atomic_flag busy = ATOMIC_FLAG_INIT;
+
+
+  /// Lock the free-list for the lifetime of this object
+  struct lock {
+    lock() {
+      while (busy.test_and_set(std::memory_order_acquire))
+        busy.wait(true, std::memory_order_relaxed);
+    }
+
+    ~lock() {
+      busy.clear(std::memory_order_release);
+      busy.notify_one();
+    }
+  };
+
+public:
+
+  pool_allocator() = default;
+
+
+  /// Allow the rebinding needed by std::allocate_shared
+  template <typename U>
+  pool_allocator(const pool_allocator<U> &) noexcept {}
+
+
+  /// Allocate some objects, recycling a released one if there is only 1
+  T *allocate(std::size_t n) {
+    if (n != 1)
+      return std::allocator<T> {}.allocate(n);
+    {
+      lock l;
+      if (free_list) {
+        auto p = free_list;
+        free_list = p->next;
+        --cached;
+        return reinterpret_cast<T *>(p);
+      }
+    }
+    return static_cast<T *>(::operator new(sizeof(node),
+                                           std::align_val_t { alignof(node) }));
+  }
+
+
+  /// Release some objects, keeping a single one for later
+  void deallocate(T *p, std::size_t n) noexcept {
+    if (n != 1) {
+      std::allocator<T> {}.deallocate(p, n);
+      return;
+    }
+    {
+      lock l;
+      if (cached < max_cached) {
+        auto nd = reinterpret_cast<node *>(p);
+        nd->next = free_list;
+        free_list = nd;
+        ++cached;
+        return;
+      }
+    }
+    ::operator delete(p, std::align_val_t { alignof(node) });
+  }
+
+
+  /// All the allocators share the same free-lists
+  template <typename U>
+  bool operator==(const pool_allocator<U> &) const noexcept {
+    return true;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_POOL_ALLOCATOR_HPP
@@ -0,0 +1,88 @@
+#ifndef TRISYCL_SYCL_DETAIL_PRECOMPILED_DEPENDENCIES_HPP
+#define TRISYCL_SYCL_DETAIL_PRECOMPILED_DEPENDENCIES_HPP
+
+/** \file The third-party and standard headers used by most of the
+    triSYCL headers, to be compiled once as a precompiled header
+
+    This is used by the TRISYCL_PRECOMPILED_HEADERS CMake option. Only
+    the headers which do not depend on the triSYCL configuration
+    macros defined by a translation unit, such as
+    TRISYCL_SYCL_NAMESPACE, can be listed here, so not CL/sycl.hpp
+    itself.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <boost/circular_buffer.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/fiber/buffered_channel.hpp>
+#include <boost/operators.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/type_index.hpp>
+
+#include <experimental/mdspan>
+
+#include <range/v3/algorithm/copy.hpp>
+
+#ifdef TRISYCL_OPENCL
+#include <boost/compute.hpp>
+#endif
+
+#if defined(TRISYCL_DEBUG) || defined(TRISYCL_TRACE_KERNEL)
+#include <boost/log/trivial.hpp>
+#endif
+
+#ifdef TRISYCL_FIBER_TASKS
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/fiber.hpp>
+#include <boost/fiber/future.hpp>
+#include <boost/fiber/mutex.hpp>
+#include <boost/fiber/operations.hpp>
+#include <boost/fiber/unbuffered_channel.hpp>
+#include <range/v3/range/conversion.hpp>
+#include <range/v3/view/iota.hpp>
+#include <range/v3/view/transform.hpp>
+#endif
+
+#ifdef TRISYCL_WORK_ITEM_FIBERS
+#include <boost/context/fiber.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#endif
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_PRECOMPILED_DEPENDENCIES_HPP
@@ -0,0 +1,65 @@
+#ifndef TRISYCL_SYCL_DETAIL_PREFETCH_HPP
+#define TRISYCL_SYCL_DETAIL_PREFETCH_HPP
+
+/** \file Prefetch some elements into the cache before they are read
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(TRISYCL_DEVICE) && defined(TRISYCL_USE_OPENCL_ND_RANGE)
+#include "triSYCL/detail/SPIR/opencl_spir_req.h"
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup helpers Some helpers for the implementation
+    @{
+*/
+
+/// The size of the cache lines assumed by the host prefetch
+inline constexpr std::size_t prefetch_line = 64;
+
+
+/** Hint that the \p count elements from \p p are going to be read
+    soon
+
+    On the host, each cache line covering the elements is prefetched.
+    On a SPIR device, the global memory is prefetched with the OpenCL
+    \c prefetch() built-in while the other address spaces are already
+    close enough. It is only a hint, so it does nothing elsewhere.
+
+    \param Global is whether \p p points to the global address space
+*/
+template <bool Global = true, typename T>
+void prefetch(const T *p, std::size_t count) {
+#ifdef TRISYCL_DEVICE
+#ifdef TRISYCL_USE_OPENCL_ND_RANGE
+  if constexpr (Global)
+    ::prefetch(reinterpret_cast<const __global char *>(p), count*sizeof(T));
+#endif
+#elif defined(__GNUC__)
+  auto end = reinterpret_cast<std::uintptr_t>(p + count);
+  for (auto line = reinterpret_cast<std::uintptr_t>(p) & ~(prefetch_line - 1);
+       line < end;
+       line += prefetch_line)
+    __builtin_prefetch(reinterpret_cast<const void *>(line));
+#endif
+}
+
+/// @} End the helpers Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_PREFETCH_HPP
@@ -0,0 +1,109 @@
+#ifndef TRISYCL_SYCL_DETAIL_SCRATCH_ARENA_HPP
+#define TRISYCL_SYCL_DETAIL_SCRATCH_ARENA_HPP
+
+/** \file A per-thread bump allocator for the temporaries of the kernels
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** A stack of memory chunks owned by a thread, from which the
+    temporaries of the work-items are allocated by bumping a pointer
+
+    The memory is released by going back to a previous mark, so the
+    allocations are released in the reverse order, and the chunks are
+    kept for the next work-items, so a thread stops calling the system
+    allocator once it has run its biggest work-item.
+*/
+class scratch_arena {
+
+  /// The minimum size of a chunk
+  static constexpr std::size_t chunk_size = 64 << 10;
+
+  struct chunk {
+    std::unique_ptr<std::byte[]> memory;
+    std::size_t size;
+  };
+
+  /// The chunks, never freed before the end of the thread
+  std::vector<chunk> chunks;
+
+  /// The chunk allocated from
+  std::size_t current = 0;
+
+  /// The number of bytes used in the current chunk
+  std::size_t top = 0;
+
+public:
+
+  /// A position in the arena to go back to
+  struct mark {
+    std::size_t chunk;
+    std::size_t top;
+  };
+
+
+  /// Get the arena of the current thread
+  static scratch_arena &instance() {
+    static thread_local scratch_arena a;
+    return a;
+  }
+
+
+  /// Get the current position, to release what is allocated after it
+  mark get_mark() const {
+    return { current, top };
+  }
+
+
+  /// Allocate \p bytes aligned on \p alignment, a power of 2
+  void *allocate(std::size_t bytes, std::size_t alignment) {
+    for (;; ++current, top = 0) {
+      if (current == chunks.size()) {
+        auto size = std::max(chunk_size, bytes + alignment);
+        chunks.push_back({ std::make_unique<std::byte[]>(size), size });
+      }
+      auto &c = chunks[current];
+      auto base = reinterpret_cast<std::uintptr_t>(c.memory.get());
+      auto p = (base + top + alignment - 1) & ~(alignment - 1);
+      if (p + bytes <= base + c.size) {
+        top = p + bytes - base;
+        return reinterpret_cast<void *>(p);
+      }
+    }
+  }
+
+
+  /// Release everything allocated since the mark \p m
+  void release(mark m) {
+    current = m.chunk;
+    top = m.top;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_SCRATCH_ARENA_HPP
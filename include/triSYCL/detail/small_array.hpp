@@ -18,12 +18,13 @@
 
 #include <boost/operators.hpp>
 
-#include <range/v3/all.hpp>
+#include <range/v3/algorithm/copy.hpp>
 
 #include "triSYCL/detail/global_config.hpp"
 #include "triSYCL/detail/array_tuple_helpers.hpp"
 #include "triSYCL/detail/debug.hpp"
 #include "triSYCL/detail/metaprogramming.hpp"
+#include "triSYCL/detail/native_vector.hpp"
 
 
 namespace trisycl::detail {
@@ -43,29 +44,50 @@ concept is_small_array = std::derived_from<T, trisycl::detail::small_array_tag>;
     operator.
 
     This handles both a[i] op b[i] and a[i] op b, where b is a BasicType.
+
+    When the native vector type of FinalType supports the operator,
+    it is applied to all the elements at once.
 */
-#define TRISYCL_BOOST_OPERATOR_VECTOR_OP(op)            \
-  FinalType operator op(const FinalType &rhs) {         \
-    for (std::size_t i = 0; i != Dims; ++i)             \
-      (*this)[i] op rhs[i];                             \
-    return *this;                                       \
-  }                                                     \
-  FinalType operator op(const BasicType &rhs) {         \
-    for (std::size_t i = 0; i != Dims; ++i)             \
-      (*this)[i] op rhs;                                \
-    return *this;                                       \
-  }                                                     \
+#define TRISYCL_BOOST_OPERATOR_VECTOR_OP(op)                      \
+  FinalType operator op(const FinalType &rhs) {                   \
+    if constexpr (requires (native_type a) { a op a; }) {         \
+      auto v = native::load(this->data());                        \
+      v op native::load(rhs.data(), 1);                           \
+      native::store(v, this->data());                             \
+    } else                                                        \
+      for (std::size_t i = 0; i != Dims; ++i)                     \
+        (*this)[i] op rhs[i];                                     \
+    return *this;                                                 \
+  }                                                               \
+  FinalType operator op(const BasicType &rhs) {                   \
+    if constexpr (requires (native_type a) { a op rhs; }) {       \
+      auto v = native::load(this->data());                        \
+      v op rhs;                                                   \
+      native::store(v, this->data());                             \
+    } else                                                        \
+      for (std::size_t i = 0; i != Dims; ++i)                     \
+        (*this)[i] op rhs;                                        \
+    return *this;                                                 \
+  }                                                               \
 
 /** Helper macro to declare a vector operation returning a new
     type containing the result of the operator.
 
     This handles both a[] op b[] and a[] op b, where b is a BasicType.
+
+    \param result is the native_vector function getting the elements
+    from the result of the operator on the native vector type, if any
 */
-#define TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(op)                    \
+#define TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(op, result)            \
   FinalType operator op(const FinalType &rhs) const {             \
     FinalType res;                                                \
-    for (std::size_t i = 0; i != Dims; ++i)                       \
-      res[i] = (*this)[i] op rhs[i];                              \
+    if constexpr (requires (native_type a) { a op a; })           \
+      native::store(native::result(native::load(this->data())     \
+                                   op native::load(rhs.data(), 1)),\
+                    res.data());                                  \
+    else                                                          \
+      for (std::size_t i = 0; i != Dims; ++i)                     \
+        res[i] = (*this)[i] op rhs[i];                            \
     return res;                                                   \
   }                                                               \
   /* Skip this for Dims = 1 to avoid ambiguity with implicit type \
@@ -74,8 +96,13 @@ concept is_small_array = std::derived_from<T, trisycl::detail::small_array_tag>;
             typename = std::enable_if_t<Dims != 1, FT>>           \
   FinalType operator op(const BasicType &rhs) {                   \
     FinalType res;                                                \
-    for (std::size_t i = 0; i != Dims; ++i)                       \
-      res[i] = (*this)[i] op rhs;                                 \
+    if constexpr (requires (native_type a) { a op rhs; })         \
+      native::store(native::result(native::load(this->data())     \
+                                   op rhs),                       \
+                    res.data());                                  \
+    else                                                          \
+      for (std::size_t i = 0; i != Dims; ++i)                     \
+        res[i] = (*this)[i] op rhs;                               \
     return res;                                                   \
   }
 
@@ -83,12 +110,15 @@ concept is_small_array = std::derived_from<T, trisycl::detail::small_array_tag>;
 
     This handles op a.
 */
-#define TRISYCL_UNARY_OPERATOR_VECTOR_OP(op)    \
-  FinalType operator op() const {               \
-    FinalType result;                           \
-    for (std::size_t i = 0; i != Dims; ++i)     \
-      result[i] = op(*this)[i];                 \
-    return result;                              \
+#define TRISYCL_UNARY_OPERATOR_VECTOR_OP(op)                      \
+  FinalType operator op() const {                                 \
+    FinalType result;                                             \
+    if constexpr (requires (native_type a) { op a; })             \
+      native::store(op native::load(this->data()), result.data()); \
+    else                                                          \
+      for (std::size_t i = 0; i != Dims; ++i)                     \
+        result[i] = op(*this)[i];                                 \
+    return result;                                                \
   }
 
 /** Helper macro to declare a vector prefix unary operation.
@@ -161,6 +191,11 @@ struct small_array : std::array<BasicType, Dims>,
 
   using element_type = BasicType;
 
+  /// The SIMD type used by the element-wise operators, if any
+  using native = detail::native_vector<FinalType>;
+
+  using native_type = typename native::type;
+
   /** A constructor from another array
 
       Make it explicit to avoid spurious range<> constructions from int *
@@ -248,20 +283,20 @@ struct small_array : std::array<BasicType, Dims>,
 #undef TRISYCL_BOOST_OPERATOR_VECTOR_OP
 
   /// Add && operations on the id<> and others
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(&&)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(&&, from_mask)
 
   /// Add || operations on the id<> and others
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(||)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(||, from_mask)
 
   /// Add comparison operations on the id<> and others
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<)
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>)
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<=)
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>=)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<, from_mask)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>, from_mask)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<=, from_mask)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>=, from_mask)
 
   /// Add shiftable operators on the vector op
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<<)
-  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>>)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(<<, from_value)
+  TRISYCL_LOGICAL_OPERATOR_VECTOR_OP(>>, from_value)
 
 #undef TRISYCL_LOGICAL_OPERATOR_VECTOR_OP
 
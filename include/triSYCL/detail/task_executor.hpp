@@ -0,0 +1,464 @@
+#ifndef TRISYCL_SYCL_DETAIL_TASK_EXECUTOR_HPP
+#define TRISYCL_SYCL_DETAIL_TASK_EXECUTOR_HPP
+
+/** \file
+
+    Select how the SYCL tasks are executed and how they synchronize
+
+    By default each task runs on a std::thread from a worker_pool and
+    the waits on producers, buffers and pipes park the thread.
+
+    When \c TRISYCL_FIBER_TASKS is defined, each task runs instead as
+    a Boost.Fiber on a fiber_pool and all these waits use the
+    Boost.Fiber synchronization primitives, so a blocked task only
+    yields its fiber and the thread can run another task. This allows
+    a large graph of blocking tasks, such as a dataflow of kernels
+    connected by pipes, to run on a few threads.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#endif
+
+#ifdef TRISYCL_FIBER_TASKS
+#include <mutex>
+#include <vector>
+
+#include <boost/fiber/condition_variable.hpp>
+#include <boost/fiber/context.hpp>
+#include <boost/fiber/fss.hpp>
+#include <boost/fiber/mutex.hpp>
+#include <boost/fiber/operations.hpp>
+
+#include "triSYCL/detail/fiber_pool.hpp"
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "triSYCL/detail/worker_pool.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+#ifdef TRISYCL_FIBER_TASKS
+
+/// The mutex to use for anything a task can wait on
+using task_mutex = boost::fibers::mutex;
+
+/// The condition variable to use for anything a task can wait on
+using task_condition_variable = boost::fibers::condition_variable;
+
+
+/** Execute the SYCL tasks as fibers on a pool of threads
+
+    This is a thin wrapper with the worker_pool interface on top of a
+    fiber_pool using work stealing between its threads.
+
+    Since the tasks cannot block their thread when waiting for each
+    other, the number of threads is fixed. But a kernel blocking on
+    something else than a triSYCL object, such as a std::future, parks
+    its thread and can starve the pool.
+*/
+class fiber_executor : public detail::debug<fiber_executor> {
+
+  /// The number of threads running the fibers
+  std::size_t capacity;
+
+  /// The fibers and their threads
+  std::unique_ptr<detail::fiber_pool> pool;
+
+  /** The pool running the current fiber, if any
+
+      Used to avoid waiting for itself when an executor is destroyed
+      from one of its fibers.
+  */
+  static auto& current_pool() {
+    static boost::fibers::fiber_specific_ptr<detail::fiber_pool> current {
+      [] (detail::fiber_pool *) {} };
+    return current;
+  }
+
+
+  /** The threads joining the pools of the executors destroyed from
+      one of their fibers
+
+      They are joined at the program exit, before the destruction of
+      the default executor created earlier.
+  */
+  struct retired_pools {
+    std::mutex m;
+    std::vector<std::thread> joiners;
+
+    ~retired_pools() {
+      for (auto &t : joiners)
+        t.join();
+    }
+  };
+
+  static retired_pools& graveyard() {
+    static retired_pools r;
+    return r;
+  }
+
+public:
+
+  /// Create an executor running the fibers on \param capacity threads
+  fiber_executor(std::size_t capacity)
+    : capacity { capacity == 0 ? 1 : capacity }
+    , pool { std::make_unique<detail::fiber_pool>
+               (static_cast<int>(this->capacity),
+                detail::fiber_pool::sched::work_stealing,
+                true) } {}
+
+
+  /// Get the number of threads running the fibers
+  std::size_t get_capacity() const {
+    return capacity;
+  }
+
+
+  /** Get the executor shared by all the queues without a specific
+      worker thread property
+
+      C++11 guaranties the static construction is thread-safe.
+  */
+  static std::shared_ptr<fiber_executor> default_pool() {
+    static auto p = std::make_shared<fiber_executor>
+      (detail::worker_pool::default_capacity());
+    return p;
+  }
+
+
+  /** Specify where the fibers run
+
+      This is ignored since the threads of the fiber pool are already
+      running and the fibers migrate among them.
+  */
+  void set_placement(std::shared_ptr<const detail::placement>) {}
+
+
+  /** Share the threads among the kernels with their own governor
+
+      This is ignored since the fibers migrate among the threads of
+      the fiber pool.
+  */
+  void set_governor(std::shared_ptr<detail::concurrency_governor>) {}
+
+
+  /** Submit some work to be executed on a new fiber
+
+      \param[in] f is the callable to execute, taking no arguments
+
+      \param[in] high_priority and \p rank are ignored since the
+      fibers are scheduled by Boost.Fiber
+  */
+  void submit(std::function<void(void)> f, bool high_priority = false,
+              std::uint64_t rank = 0) {
+    // The completion is tracked by the task itself, not by the future
+    pool->submit([p = pool.get(), f = std::move(f)] {
+        current_pool().reset(p);
+        f();
+      });
+  }
+
+
+  /** Submit some work to be executed all at the same time, such as
+      some kernels connected by blocking pipes
+
+      Since a fiber blocked on a pipe lets the other fibers run, the
+      gang is just multiplexed on the threads of the pool.
+  */
+  void submit_gang(std::vector<std::function<void(void)>> gang,
+                   bool high_priority = false) {
+    for (auto &f : gang)
+      submit(std::move(f), high_priority);
+  }
+
+
+  /** Submit a batch of work, each one on its own fiber, as a single
+      submission to the pool
+  */
+  void submit_bulk(std::vector<std::function<void(void)>> batch,
+                   bool high_priority = false) {
+    auto n = batch.size();
+    pool->submit_n(n, [p = pool.get(), b = std::move(batch)]
+                      (std::size_t i) {
+        current_pool().reset(p);
+        b[i]();
+      });
+  }
+
+
+  /** Wait for the submitted work to be done
+
+      The pool is always joined from a new thread, since closing it
+      wakes up some fibers, which cannot be done from a thread whose
+      Boost.Fiber runtime is already gone, such as the main thread
+      destroying the default executor at the program exit.
+
+      When the executor is destroyed from one of its fibers, for
+      example when a task releases the last reference to a queue, the
+      joining thread cannot be waited for from there, so it is only
+      joined at the program exit.
+  */
+  ~fiber_executor() {
+    // There is no fiber context anymore during the program exit
+    bool from_own_fiber = boost::fibers::context::active()
+      && current_pool().get() == pool.get();
+    std::thread joiner { [p = std::move(pool)] {} };
+    if (from_own_fiber) {
+      auto &g = graveyard();
+      std::lock_guard<std::mutex> lg { g.m };
+      g.joiners.push_back(std::move(joiner));
+    }
+    else
+      joiner.join();
+  }
+
+};
+
+/// The executor used by the queues to run their tasks
+using task_executor = fiber_executor;
+
+
+/// Let the other tasks run, typically when busy-waiting on something
+inline void yield_task() {
+  boost::this_fiber::yield();
+}
+
+#else
+
+/// The mutex to use for anything a task can wait on
+using task_mutex = std::mutex;
+
+/// The condition variable to use for anything a task can wait on
+using task_condition_variable = std::condition_variable;
+
+/// The executor used by the queues to run their tasks
+using task_executor = worker_pool;
+
+
+/** Let the other tasks run, typically when busy-waiting on something
+
+    Since the task keeps its thread, it is counted as blocked in its
+    worker pool, so the task it waits for can get a worker, and the
+    thread lets the others run on its core
+*/
+inline void yield_task() {
+  worker_pool::poll();
+  std::this_thread::yield();
+}
+
+#endif
+
+
+/** A flag set once, such as the completion of a task, which the tasks
+    can wait for
+
+    With threads, the waiters wait on the atomic flag itself, without
+    any mutex, and nothing is woken up while it is not set. With \c
+    TRISYCL_FIBER_TASKS, the waiting fibers park on a condition
+    variable so their thread can run the other fibers.
+*/
+class task_flag {
+#ifdef TRISYCL_FIBER_TASKS
+  bool flag = false;
+
+  mutable task_mutex m;
+
+  mutable task_condition_variable cv;
+#else
+  std::atomic<bool> flag = false;
+#endif
+
+public:
+
+  /// Set the flag and wake up its waiters
+  void set() {
+#ifdef TRISYCL_FIBER_TASKS
+    {
+      std::lock_guard<task_mutex> lg { m };
+      flag = true;
+    }
+    cv.notify_all();
+#else
+    flag.store(true, std::memory_order_release);
+    flag.notify_all();
+#endif
+  }
+
+
+  /// Test whether the flag is set
+  bool is_set() const {
+#ifdef TRISYCL_FIBER_TASKS
+    std::lock_guard<task_mutex> lg { m };
+    return flag;
+#else
+    return flag.load(std::memory_order_acquire);
+#endif
+  }
+
+
+  /// Wait for the flag to be set
+  void wait() const {
+#ifdef TRISYCL_FIBER_TASKS
+    std::unique_lock<task_mutex> ul { m };
+    cv.wait(ul, [&] { return flag; });
+#else
+    if (flag.load(std::memory_order_acquire))
+      return;
+    worker_pool::blocked_scope b;
+    flag.wait(false, std::memory_order_acquire);
+#endif
+  }
+};
+
+
+/** A counter of users, such as the tasks using a buffer, which the
+    tasks can wait to reach 0
+
+    As for task_flag, the threads wait on the atomic counter itself.
+*/
+class task_counter {
+  std::atomic<std::size_t> count = 0;
+
+#ifdef TRISYCL_FIBER_TASKS
+  mutable task_mutex m;
+
+  mutable task_condition_variable cv;
+#endif
+
+public:
+
+  /// Get the current value
+  std::size_t load() const {
+    return count.load(std::memory_order_acquire);
+  }
+
+
+  void increment() {
+    count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  /** Decrement the counter and wake up its waiters when it reaches 0
+
+      \return true if the counter reached 0
+  */
+  bool decrement() {
+#ifdef TRISYCL_FIBER_TASKS
+    std::unique_lock<task_mutex> ul { m };
+    if (count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return false;
+    ul.unlock();
+    cv.notify_all();
+#else
+    if (count.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return false;
+    count.notify_all();
+#endif
+    return true;
+  }
+
+
+  /// Wait for the counter to reach 0
+  void wait_for_zero() const {
+#ifdef TRISYCL_FIBER_TASKS
+    std::unique_lock<task_mutex> ul { m };
+    cv.wait(ul, [&] { return load() == 0; });
+#else
+    /* A waiter is only woken up when the counter reaches 0, but
+       another user may have started meanwhile */
+    if (load() == 0)
+      return;
+    worker_pool::blocked_scope b;
+    for (auto c = load(); c != 0; c = load())
+      count.wait(c, std::memory_order_acquire);
+#endif
+  }
+};
+
+/** Tell the processor that this is a busy-wait loop
+
+    This saves some power and avoids a memory-order violation penalty
+    when leaving the loop.
+*/
+inline void spin_pause() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+
+/** Busy-wait a while for \p ready to be true, before the caller
+    parks its task
+
+    When a producer and a consumer run at the same pace on different
+    cores, what is waited for is usually only a few hundred cycles
+    away, much less than the cost of parking and waking up a thread.
+
+    Test \p ready up to \p spin_budget times with a processor pause in
+    between, then a few more times yielding the thread. Since a spinning
+    fiber would prevent the other fibers of its thread from running,
+    with \c TRISYCL_FIBER_TASKS it yields the fiber instead of pausing.
+
+    \return true if \p ready became true, false if the caller has to
+    park
+*/
+template <typename Predicate>
+bool spin_wait(std::size_t spin_budget, Predicate ready) {
+  if (spin_budget == 0)
+    return false;
+  for (std::size_t i = 0; i != spin_budget; ++i) {
+    if (ready())
+      return true;
+#ifdef TRISYCL_FIBER_TASKS
+    yield_task();
+#else
+    spin_pause();
+#endif
+  }
+#ifndef TRISYCL_FIBER_TASKS
+  // Let another thread run on this core, in case it is the awaited one
+  for (int i = 0; i != 16; ++i) {
+    if (ready())
+      return true;
+    std::this_thread::yield();
+  }
+#endif
+  return ready();
+}
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_TASK_EXECUTOR_HPP
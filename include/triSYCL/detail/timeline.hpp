@@ -0,0 +1,239 @@
+#ifndef TRISYCL_SYCL_DETAIL_TIMELINE_HPP
+#define TRISYCL_SYCL_DETAIL_TIMELINE_HPP
+
+/** \file Record a timeline of the execution for the Chrome trace viewer
+
+    Define the TRISYCL_TIMELINE CPP flag to record the spans of the
+    task scheduling, producer waits, preludes, kernels, postludes,
+    buffer releases and buffer transfers. Each thread records its spans
+    in its own buffer without contention and they are written at the
+    program exit in the Chrome trace-event JSON format, which can be
+    loaded in chrome://tracing or https://ui.perfetto.dev
+
+    The output file is named by the TRISYCL_TIMELINE_FILE environment
+    variable, "trisycl_timeline.json" by default.
+
+    Without TRISYCL_TIMELINE, nothing is recorded and there is no cost.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#ifdef TRISYCL_TIMELINE
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <boost/type_index.hpp>
+#endif
+
+#ifdef TRISYCL_TIMELINE
+/// Record a span named \p name of category \p category up to the end of the scope
+#define TRISYCL_TIMELINE_SCOPE(category, name)                          \
+  ::trisycl::detail::timeline::scope                                    \
+  TRISYCL_TIMELINE_CONCAT(trisycl_timeline_scope_, __LINE__) { category, name }
+
+#define TRISYCL_TIMELINE_CONCAT(a, b) TRISYCL_TIMELINE_CONCAT_(a, b)
+#define TRISYCL_TIMELINE_CONCAT_(a, b) a##b
+#else
+#define TRISYCL_TIMELINE_SCOPE(category, name) do { } while(0)
+#endif
+
+#ifdef TRISYCL_TIMELINE
+namespace trisycl::detail {
+
+/** \addtogroup debug_trace Debugging and tracing support
+    @{
+*/
+
+/// The recorder of the spans of all the threads
+class timeline {
+
+  using clock = std::chrono::steady_clock;
+
+  /// A span of time spent by a thread
+  struct span {
+    /// The names have to outlive the timeline, like string literals
+    const char *category;
+    const char *name;
+    clock::time_point start;
+    clock::time_point end;
+  };
+
+  /// The spans recorded by a thread
+  struct thread_spans {
+    /// The number of the thread in the timeline
+    std::size_t tid;
+
+    std::vector<span> spans;
+
+    /** To read the spans at the exit while the thread may still be
+        running, uncontended otherwise
+    */
+    std::mutex m;
+  };
+
+  /** The time origin of the timeline, at the start of the program
+      since some spans may start before the creation of the timeline
+  */
+  static inline const clock::time_point origin = clock::now();
+
+  /// The spans of each thread, kept after the exit of their thread
+  std::vector<std::shared_ptr<thread_spans>> threads;
+
+  /// To protect the list of the threads
+  std::mutex m;
+
+
+  /// Register the spans of a new thread
+  std::shared_ptr<thread_spans> add_thread() {
+    auto t = std::make_shared<thread_spans>();
+    std::lock_guard<std::mutex> lg { m };
+    t->tid = threads.size();
+    threads.push_back(t);
+    return t;
+  }
+
+
+  /// Get the spans of the current thread, registered on first use
+  thread_spans &current() {
+    static thread_local std::shared_ptr<thread_spans> t = add_thread();
+    return *t;
+  }
+
+
+  /// Write \p s as a JSON string
+  static void write_string(std::ostream &o, const char *s) {
+    o << '"';
+    for (; *s; ++s) {
+      if (*s == '"' || *s == '\\')
+        o << '\\';
+      o << *s;
+    }
+    o << '"';
+  }
+
+
+  /// The microseconds from the time origin, as used by the trace format
+  static double microseconds(clock::time_point t) {
+    return std::chrono::duration<double, std::micro> { t - origin }.count();
+  }
+
+public:
+
+  /** Whether the timeline of the process has been written
+
+      The threads still running after its destruction at the program
+      exit do not record anything.
+  */
+  static inline std::atomic<bool> finished = false;
+
+
+  /// Record a span up to the end of a scope
+  class scope {
+    const char *category;
+    const char *name;
+    clock::time_point start = clock::now();
+
+  public:
+
+    scope(const char *category, const char *name)
+      : category { category }
+      , name { name } {}
+
+    scope(const scope &) = delete;
+
+    ~scope() {
+      if (!finished)
+        timeline::instance().record({ category, name, start, clock::now() });
+    }
+  };
+
+
+  /// Get the timeline of the process, written at the exit
+  static timeline &instance() {
+    static timeline t;
+    return t;
+  }
+
+
+  /// Record a span in the buffer of the current thread
+  void record(const span &s) {
+    auto &t = current();
+    std::lock_guard<std::mutex> lg { t.m };
+    t.spans.push_back(s);
+  }
+
+
+  /// Get a name for the type \p T which lives as long as the program
+  template <typename T>
+  static const char *type_name() {
+    /* Since the class T may just be declared and not really defined,
+       just use it through a class pointer */
+    static const std::string n =
+      boost::typeindex::type_id<T *>().pretty_name();
+    return n.c_str();
+  }
+
+
+  /// Write the spans recorded so far in the Chrome trace-event format
+  void write(std::ostream &o) {
+    std::lock_guard<std::mutex> lg { m };
+    o << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    auto first = true;
+    auto separate = [&] { o << (first ? "\n" : ",\n"); first = false; };
+    for (auto &t : threads) {
+      separate();
+      o << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << t->tid << ",\"args\":{\"name\":\"thread " << t->tid << "\"}}";
+      std::lock_guard<std::mutex> lg { t->m };
+      for (auto &s : t->spans) {
+        separate();
+        o << "{\"name\":";
+        write_string(o, s.name);
+        o << ",\"cat\":";
+        write_string(o, s.category);
+        o << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << t->tid
+          << ",\"ts\":" << microseconds(s.start)
+          << ",\"dur\":" << microseconds(s.end) - microseconds(s.start)
+          << '}';
+      }
+    }
+    o << "\n]}\n";
+  }
+
+
+  /// Write the timeline into its file at the exit of the program
+  ~timeline() {
+    finished = true;
+    auto name = std::getenv("TRISYCL_TIMELINE_FILE");
+    std::ofstream o { name ? name : "trisycl_timeline.json" };
+    // Keep the sub-microsecond resolution
+    o.precision(3);
+    o << std::fixed;
+    write(o);
+  }
+
+};
+
+/// @} End the debug_trace Doxygen group
+
+}
+#endif
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_TIMELINE_HPP
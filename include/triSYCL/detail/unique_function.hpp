@@ -0,0 +1,180 @@
+#ifndef TRISYCL_SYCL_DETAIL_UNIQUE_FUNCTION_HPP
+#define TRISYCL_SYCL_DETAIL_UNIQUE_FUNCTION_HPP
+
+/** \file
+
+    A move-only type-erased callable with a large small buffer, to
+    store the kernels of the tasks
+
+    Unlike std::function, the callable does not have to be copyable,
+    so it is moved along the submission path instead of being copied
+    with all the accessors it captures, and the small buffer is large
+    enough for a kernel capturing a few accessors, so storing it does
+    not allocate.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace trisycl::detail {
+
+/** \addtogroup helpers Some helpers for the implementation
+    @{
+*/
+
+template <typename Signature, std::size_t InlineSize = 160>
+class unique_function;
+
+
+/** A move-only callable of signature R(Args...) stored inline when it
+    fits in \p InlineSize bytes and on the heap otherwise
+*/
+template <typename R, typename... Args, std::size_t InlineSize>
+class unique_function<R(Args...), InlineSize> {
+
+  /// The operations on the type-erased callable
+  struct operations {
+    R (*call)(void *storage, Args &&... args);
+    /// Move-construct into \p to and destroy \p from
+    void (*relocate)(void *to, void *from) noexcept;
+    void (*destroy)(void *storage) noexcept;
+  };
+
+  /// Whether a callable of type \p F is stored inline
+  template <typename F>
+  static constexpr bool is_inline = sizeof(F) <= InlineSize
+    && alignof(F) <= alignof(std::max_align_t)
+    && std::is_nothrow_move_constructible_v<F>;
+
+  template <typename F>
+  static constexpr operations inline_operations {
+    [] (void *s, Args &&... args) -> R {
+      return std::invoke(*static_cast<F *>(s), std::forward<Args>(args)...);
+    },
+    [] (void *to, void *from) noexcept {
+      ::new (to) F { std::move(*static_cast<F *>(from)) };
+      static_cast<F *>(from)->~F();
+    },
+    [] (void *s) noexcept { static_cast<F *>(s)->~F(); }
+  };
+
+  template <typename F>
+  static constexpr operations heap_operations {
+    [] (void *s, Args &&... args) -> R {
+      return std::invoke(**static_cast<F **>(s), std::forward<Args>(args)...);
+    },
+    [] (void *to, void *from) noexcept {
+      *static_cast<F **>(to) = *static_cast<F **>(from);
+    },
+    [] (void *s) noexcept { delete *static_cast<F **>(s); }
+  };
+
+  alignas(std::max_align_t) std::byte storage[InlineSize];
+
+  /// The operations of the current callable, or nullptr if empty
+  const operations *ops = nullptr;
+
+public:
+
+  unique_function() = default;
+
+  unique_function(std::nullptr_t) {}
+
+
+  /// Store the callable \p f, moving it if it is an rvalue
+  template <typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, unique_function>
+              && std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+  unique_function(F &&f) {
+    using stored = std::decay_t<F>;
+    if constexpr (is_inline<stored>) {
+      ::new (static_cast<void *>(storage)) stored { std::forward<F>(f) };
+      ops = &inline_operations<stored>;
+    } else {
+      *reinterpret_cast<stored **>(storage) =
+        new stored { std::forward<F>(f) };
+      ops = &heap_operations<stored>;
+    }
+  }
+
+
+  unique_function(unique_function &&other) noexcept : ops { other.ops } {
+    if (ops) {
+      ops->relocate(storage, other.storage);
+      other.ops = nullptr;
+    }
+  }
+
+
+  unique_function &operator=(unique_function &&other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.ops) {
+        other.ops->relocate(storage, other.storage);
+        ops = std::exchange(other.ops, nullptr);
+      }
+    }
+    return *this;
+  }
+
+
+  unique_function &operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+
+  unique_function(const unique_function &) = delete;
+
+  unique_function &operator=(const unique_function &) = delete;
+
+
+  ~unique_function() {
+    reset();
+  }
+
+
+  /// Test whether there is a callable
+  explicit operator bool() const noexcept {
+    return ops != nullptr;
+  }
+
+
+  /// Call the callable, which must exist
+  R operator()(Args... args) {
+    return ops->call(storage, std::forward<Args>(args)...);
+  }
+
+private:
+
+  /// Destroy the callable, if any
+  void reset() noexcept {
+    if (ops) {
+      ops->destroy(storage);
+      ops = nullptr;
+    }
+  }
+
+};
+
+/// @} End the helpers Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_UNIQUE_FUNCTION_HPP
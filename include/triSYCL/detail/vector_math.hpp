@@ -0,0 +1,274 @@
+#ifndef TRISYCL_SYCL_DETAIL_VECTOR_MATH_HPP
+#define TRISYCL_SYCL_DETAIL_VECTOR_MATH_HPP
+
+/** \file
+
+    Vectorized exponential, logarithm and trigonometric functions of
+    the float vec with a native vector type
+
+    Instead of calling the scalar std:: function on each element, the
+    argument is reduced and a polynomial is evaluated on all the
+    elements at once, as in the Cephes library and SLEEF. The error
+    stays within the 3 ulp of exp and log and the 4 ulp of sin and cos
+    required by SYCL for the float type.
+
+    The sin and cos arguments are reduced in double precision. Beyond
+    8192 in magnitude, where this reduction is not precise enough, and
+    for the infinities and NaN, the scalar std:: functions are used.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <bit>
+#include <cmath>
+
+#include "triSYCL/detail/native_vector.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup vector Vector types in SYCL
+    @{
+*/
+
+/// The math functions of a vec of NumElements float
+template <int NumElements>
+struct vector_math;
+
+#if defined(__GNUC__) && !defined(TRISYCL_NO_NATIVE_VEC)
+
+template <int NumElements>
+struct vector_math {
+  using native = native_vector<::trisycl::vec<float, NumElements>>;
+
+  using type = typename native::type;
+
+  /// The 32-bit integers with the same layout, as the comparison masks
+  using int_type = decltype(type {} < type {});
+
+  /// The vec type of the arguments and results
+  using vec = ::trisycl::vec<float, NumElements>;
+
+
+  /// Round the elements below 2^31 in magnitude toward -infinity
+  static type floor(type x) {
+    auto t = __builtin_convertvector(__builtin_convertvector(x, int_type),
+                                     type);
+    // Subtract 1 where the truncation went up, the mask being -1
+    return t + __builtin_convertvector(t > x, type);
+  }
+
+
+  /// Multiply by 2^n with n in [-150, 128]
+  static type scale(type x, int_type n) {
+    // Split the power so that each factor is a normal float
+    auto n1 = n >> 1;
+    auto n2 = n - n1;
+    return x*std::bit_cast<type>((n1 + 127) << 23)
+      *std::bit_cast<type>((n2 + 127) << 23);
+  }
+
+
+  /// Compute e^r - 1 - r for r in [-ln(2)/2, ln(2)/2]
+  static type expm1_minus(type r) {
+    type p = 1.9875691500E-4f*r + 1.3981999507E-3f;
+    p = p*r + 8.3334519073E-3f;
+    p = p*r + 4.1665795894E-2f;
+    p = p*r + 1.6666665459E-1f;
+    p = p*r + 5.0000001201E-1f;
+    return p*r*r;
+  }
+
+
+  static vec exp(const vec &v) {
+    auto x = native::load(v.data());
+    // Beyond these bounds, the result is 0 or infinity anyway
+    auto c = x < -104.0f ? -104.0f : x;
+    c = c > 89.0f ? 89.0f : c;
+    auto n = floor(c*1.44269504088896341f + 0.5f);
+    // Cody-Waite reduction with ln(2) in 2 parts
+    auto r = c - n*0.693359375f + n*2.12194440e-4f;
+    auto y = scale(expm1_minus(r) + r + 1.0f,
+                   __builtin_convertvector(n, int_type));
+    // Keep the NaN
+    y = x != x ? x : y;
+    vec result;
+    native::store(y, result.data());
+    return result;
+  }
+
+
+  static vec exp2(const vec &v) {
+    auto x = native::load(v.data());
+    auto c = x < -151.0f ? -151.0f : x;
+    c = c > 129.0f ? 129.0f : c;
+    auto n = floor(c + 0.5f);
+    auto r = (c - n)*0.693147180559945309f;
+    auto y = scale(expm1_minus(r) + r + 1.0f,
+                   __builtin_convertvector(n, int_type));
+    y = x != x ? x : y;
+    vec result;
+    native::store(y, result.data());
+    return result;
+  }
+
+
+  /** Split the positive normal or subnormal x in m*2^e with m in
+      [sqrt(1/2) - 1, sqrt(2) - 1] and compute ln(1 + m) - m
+
+      \return the exponent e and the mantissa m through references
+  */
+  static type log1p_minus(type x, type &e, type &m) {
+    // Make the subnormal numbers normal
+    auto subnormal = x < 1.17549435e-38f;
+    x = subnormal ? x*8388608.0f : x;
+    auto bits = std::bit_cast<int_type>(x);
+    auto exponent = ((bits >> 23) & 0xff) - 126 + (subnormal & -23);
+    // The mantissa in [0.5, 1)
+    m = std::bit_cast<type>((bits & 0x807fffff) | 0x3f000000);
+    auto low = m < 0.707106781186547524f;
+    // Use 2m in [sqrt(1/2), 1) with 1 less in the exponent, the mask being -1
+    e = __builtin_convertvector(exponent + low, type);
+    m = (low ? m + m : m) - 1.0f;
+    auto z = m*m;
+    type p = 7.0376836292E-2f*m - 1.1514610310E-1f;
+    p = p*m + 1.1676998740E-1f;
+    p = p*m - 1.2420140846E-1f;
+    p = p*m + 1.4249322787E-1f;
+    p = p*m - 1.6668057665E-1f;
+    p = p*m + 2.0000714765E-1f;
+    p = p*m - 2.4999993993E-1f;
+    p = p*m + 3.3333331174E-1f;
+    return p*m*z - 0.5f*z;
+  }
+
+
+  /// Give the special values of log for 0, the negative numbers,
+  /// infinity and NaN
+  static type log_special(type x, type y) {
+    y = x == 0.0f ? -HUGE_VALF : y;
+    y = x < 0.0f ? NAN : y;
+    y = x == HUGE_VALF ? x : y;
+    return x != x ? x : y;
+  }
+
+
+  static vec log(const vec &v) {
+    auto x = native::load(v.data(), 1.0f);
+    type e, m;
+    auto p = log1p_minus(x, e, m);
+    // Add e*ln(2), with ln(2) in 2 parts
+    auto y = (p - 2.12194440e-4f*e + m) + 0.693359375f*e;
+    vec result;
+    native::store(log_special(x, y), result.data());
+    return result;
+  }
+
+
+  static vec log2(const vec &v) {
+    auto x = native::load(v.data(), 1.0f);
+    type e, m;
+    auto p = log1p_minus(x, e, m);
+    auto y = (p*1.44269504088896341f + m*1.44269504088896341f) + e;
+    vec result;
+    native::store(log_special(x, y), result.data());
+    return result;
+  }
+
+
+  /** Compute sin(x) or cos(x)
+
+      \param[in] quarter is 0 for sin and 1 for cos, which is the sin of
+      x + pi/2
+  */
+  static vec sin_cos(const vec &v, int quarter) {
+    // Twice wider, but only used inside this function
+    using wide = typename vector_of<double, 2*native::bytes>::type;
+    auto x = native::load(v.data());
+    auto sign = std::bit_cast<int_type>(x) >> 31;
+    auto a = __builtin_convertvector(
+      std::bit_cast<type>(std::bit_cast<int_type>(x) & 0x7fffffff), wide);
+    // The octant of the argument, rounded to an even one
+    auto j = __builtin_convertvector(a*1.27323954473516268, int_type);
+    j = (j + 1) & ~1;
+    auto n = __builtin_convertvector(j, wide);
+    /* Cody-Waite reduction in double with pi/4 in 2 parts, the first
+       one with 39 bits so that its product by n < 2^14 is exact */
+    auto r = __builtin_convertvector((a - n*0x1.921fb5444p-1)
+                                     - n*0x1.68c234c4c6629p-40, type);
+    auto z = r*r;
+    type s = -1.9515295891E-4f*z + 8.3321608736E-3f;
+    s = s*z - 1.6666654611E-1f;
+    s = s*z*r + r;
+    type c = 2.443315711809948E-5f*z - 1.388731625493765E-3f;
+    c = c*z + 4.166664568298827E-2f;
+    c = c*z*z - 0.5f*z + 1.0f;
+    // Count the quarter turns, with a half turn more for the sin of x < 0
+    auto quadrant = (j >> 1) + quarter;
+    if (quarter == 0)
+      quadrant += sign & 2;
+    auto y = (quadrant & 1) ? c : s;
+    y = (quadrant & 2) ? -y : y;
+    vec result;
+    native::store(y, result.data());
+    // Use the scalar version where the reduction is not precise enough
+    for (int i = 0; i != NumElements; ++i)
+      if (!(std::abs(v[i]) <= 8192.0f))
+        result[i] = quarter ? std::cos(v[i]) : std::sin(v[i]);
+    return result;
+  }
+
+
+  static vec sin(const vec &v) {
+    return sin_cos(v, 0);
+  }
+
+
+  static vec cos(const vec &v) {
+    return sin_cos(v, 1);
+  }
+
+
+  /** Estimate 1/sqrt(x) within about 5e-6 in relative error, for
+      native::rsqrt
+
+      Start from the classical estimate built on the bits of x and
+      refine it with 2 Newton-Raphson iterations.
+  */
+  static vec rsqrt(const vec &v) {
+    auto x = native::load(v.data(), 1.0f);
+    // Make the subnormal numbers normal, 2^24 times larger
+    auto subnormal = x < 1.17549435e-38f;
+    auto n = subnormal ? x*16777216.0f : x;
+    auto y = std::bit_cast<type>(0x5f375a86
+                                 - (std::bit_cast<int_type>(n) >> 1));
+    auto half = 0.5f*n;
+    y = y*(1.5f - half*y*y);
+    y = y*(1.5f - half*y*y);
+    y = subnormal ? y*4096.0f : y;
+    // Give the special values of 1/sqrt(x)
+    y = x == 0.0f ? 1.0f/x : y;
+    y = x == HUGE_VALF ? 0.0f : y;
+    y = x < 0.0f || x != x ? NAN : y;
+    vec result;
+    native::store(y, result.data());
+    return result;
+  }
+
+};
+
+#endif
+
+/// @} End the vector Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_VECTOR_MATH_HPP
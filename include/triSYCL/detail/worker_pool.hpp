@@ -0,0 +1,576 @@
+#ifndef TRISYCL_SYCL_DETAIL_WORKER_POOL_HPP
+#define TRISYCL_SYCL_DETAIL_WORKER_POOL_HPP
+
+/** \file
+
+    A persistent pool of std::thread to run the SYCL tasks
+
+    Instead of creating and detaching a new std::thread for each
+    command group, the tasks are pushed into a work queue consumed by
+    some reusable worker threads.
+
+    Since a task can block on some other task running concurrently
+    (typically a kernel blocked on a pipe waiting for another kernel),
+    the workers known to be blocked do not count against the capacity
+    of the pool: if there is no idle worker when some work is submitted
+    and fewer running workers than the capacity, a new worker is
+    started, and a worker blocking while some work waits starts its
+    replacement. A worker polling something, such as a non-blocking
+    pipe, is counted as blocked until the end of its current work.
+
+    Since a task can also wait for another one without being known as
+    blocked, for example by spinning on an atomic variable, a watchdog
+    starts an extra worker each time no waiting work has been started
+    for a while. The workers above the limit of the pool retire after
+    lingering a little while without work, so bursts do not keep
+    threads alive forever.
+
+    The high-priority work is served first by the available workers.
+    The other work is served by decreasing rank, such as the estimated
+    length of the longest path of tasks starting from it, so a worker
+    becoming available continues the critical path of a task graph
+    before the independent leaves, and otherwise in submission order.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/placement.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+class worker_pool : public detail::debug<worker_pool> {
+
+  /** The state shared between the pool and its workers
+
+      The workers are detached threads owning the state too, so the
+      pool can be destroyed even from one of its workers, for example
+      when a task releases the last reference to a queue.
+  */
+  struct state : std::enable_shared_from_this<state> {
+    /// Some work waiting for a worker, with what orders it
+    struct ranked_work {
+      /// The rank of the work, the highest being served first
+      std::uint64_t rank;
+
+      /// The submission number, to serve the same ranks in order
+      std::uint64_t order;
+
+      std::function<void(void)> f;
+
+      /// The order of a max-heap serving the first submitted work last
+      friend bool operator<(const ranked_work &a, const ranked_work &b) {
+        return a.rank < b.rank || (a.rank == b.rank && a.order > b.order);
+      }
+    };
+
+    /// The work waiting for a worker, as a heap
+    std::vector<ranked_work> work;
+
+    /// The number of work submitted so far
+    std::uint64_t submitted = 0;
+
+    /// The high-priority work waiting for a worker, served first
+    std::deque<std::function<void(void)>> high_priority_work;
+
+    /// To protect the whole state
+    std::mutex m;
+
+    /// To signal some work or the pool shutdown to the workers
+    std::condition_variable work_available;
+
+    /// To signal the exit of the last worker to the pool
+    std::condition_variable all_done;
+
+    /// Number of worker threads still running
+    std::size_t live = 0;
+
+    /// Number of workers waiting for some work
+    std::size_t idle = 0;
+
+    /// Number of workers waiting for something else than some work
+    std::size_t blocked = 0;
+
+    /// Number of extra workers started because the work was stalled
+    std::size_t stalled = 0;
+
+    /// Number of work started so far, to detect a stall
+    std::uint64_t started = 0;
+
+    /// Set when a watchdog looks for a stall of the waiting work
+    bool watched = false;
+
+    /// Number of workers to keep alive even without work
+    std::size_t capacity;
+
+    /// Whether more workers than the capacity can be started
+    bool elastic;
+
+    /// Set when the pool is destroyed to have the workers exit
+    bool stopping = false;
+
+    /// Where the workers and their kernels run, if specified
+    std::shared_ptr<const detail::placement> where;
+
+    /** What shares the threads among the kernels of the workers, if
+        not the global governor
+    */
+    std::shared_ptr<detail::concurrency_governor> governor;
+
+    state(std::size_t capacity, bool elastic)
+      : capacity { capacity }
+      , elastic { elastic } {}
+
+    /// The number of work items waiting for a worker
+    std::size_t pending() const {
+      return work.size() + high_priority_work.size();
+    }
+
+
+    /// The number of workers allowed to run
+    std::size_t limit() const {
+      return capacity + (elastic ? blocked + stalled : 0);
+    }
+
+
+    /// Add some work to the queue given by \p high_priority
+    void push(std::function<void(void)> f, bool high_priority,
+              std::uint64_t rank = 0) {
+      if (high_priority) {
+        high_priority_work.push_back(std::move(f));
+        return;
+      }
+      work.push_back({ rank, submitted++, std::move(f) });
+      std::push_heap(work.begin(), work.end());
+    }
+
+
+    /// Remove the next work to execute
+    std::function<void(void)> pop() {
+      if (!high_priority_work.empty()) {
+        auto f = std::move(high_priority_work.front());
+        high_priority_work.pop_front();
+        return f;
+      }
+      std::pop_heap(work.begin(), work.end());
+      auto f = std::move(work.back().f);
+      work.pop_back();
+      return f;
+    }
+  };
+
+  std::shared_ptr<state> s;
+
+  /// How long a worker above the pool limit waits before retiring
+  static auto constexpr linger = std::chrono::milliseconds { 100 };
+
+  /** How long some waiting work can wait without any work started
+      before the watchdog starts an extra worker
+  */
+  static auto constexpr stall = std::chrono::milliseconds { 100 };
+
+  /** The state of the pool the current thread is a worker of, if any
+
+      Used to avoid waiting for itself when a pool is destroyed from
+      one of its workers.
+  */
+  static state*& current_pool() {
+    static thread_local state* current = nullptr;
+    return current;
+  }
+
+
+  /// Whether the work of the current worker is counted as polling
+  static bool& polling() {
+    static thread_local bool p = false;
+    return p;
+  }
+
+
+  /** Make sure a watchdog looks for a stall of the work waiting in
+      \p st while all the workers are busy
+
+      This assumes the state is locked by \p ul, which is unlocked.
+  */
+  static void watch(const std::shared_ptr<state> &st,
+                    std::unique_lock<std::mutex> &ul) {
+    bool start = !st->watched;
+    st->watched = true;
+    ul.unlock();
+    if (start)
+      std::thread { [st] { watchdog(st); } }.detach();
+  }
+
+
+  /// Count a worker of \p st as blocked, replacing it if needed
+  static void block(state *st) {
+    if (!st || !st->elastic)
+      return;
+    std::unique_lock<std::mutex> ul { st->m };
+    ++st->blocked;
+    if (st->idle >= st->pending() || st->live >= st->limit())
+      return;
+    ++st->live;
+    ul.unlock();
+    std::thread { [s = st->shared_from_this()] { run(s); } }.detach();
+    TRISYCL_DUMP_T("worker_pool started a worker replacing a blocked one");
+  }
+
+
+  /// Stop counting a worker of \p st as blocked
+  static void unblock(state *st) {
+    if (!st || !st->elastic)
+      return;
+    std::lock_guard<std::mutex> lg { st->m };
+    --st->blocked;
+  }
+
+public:
+
+  /** Account for a worker of the current thread waiting for
+      something else than some work, such as another task
+
+      A worker blocking while some work is waiting for a worker starts
+      a new one to replace it, so the waiting work can make progress
+      without waiting for the watchdog. Nothing is done outside of the
+      workers of an elastic pool, or if the worker is already counted
+      as polling.
+  */
+  class blocked_scope {
+    state *st = polling() ? nullptr : current_pool();
+
+  public:
+
+    blocked_scope() {
+      block(st);
+    }
+
+    ~blocked_scope() {
+      unblock(st);
+    }
+
+    blocked_scope(const blocked_scope &) = delete;
+    blocked_scope &operator=(const blocked_scope &) = delete;
+  };
+
+
+  /** Account for the work of the current worker as polling something,
+      such as a non-blocking pipe, until the end of this work
+
+      The worker is counted as blocked, as with a blocked_scope, so a
+      task busy-waiting for another one does not prevent it from
+      running.
+  */
+  static void poll() {
+    if (polling())
+      return;
+    if (auto st = current_pool(); st && st->elastic) {
+      polling() = true;
+      block(st);
+    }
+  }
+
+
+  /** Create a pool keeping \param capacity workers alive
+
+      The threads are lazily started on the first submissions.
+
+      \param elastic allows to start more workers when some of them
+      are blocked, typically on another task. Otherwise the work waits
+      for a worker, so a pool with a capacity of 1 executes the work in
+      submission order.
+  */
+  worker_pool(std::size_t capacity, bool elastic = true)
+    : s { std::make_shared<state>(capacity == 0 ? 1 : capacity, elastic) } {}
+
+
+  /// Get the number of workers kept alive by the pool
+  std::size_t get_capacity() const {
+    return s->capacity;
+  }
+
+
+  /** Get the default capacity of a pool
+
+      It can be set with the \c TRISYCL_WORKER_THREADS environment
+      variable and otherwise it is the number of hardware threads.
+  */
+  static std::size_t default_capacity() {
+    if (auto e = std::getenv("TRISYCL_WORKER_THREADS"))
+      if (auto n = std::strtoul(e, nullptr, 10); n > 0)
+        return n;
+    auto n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+  }
+
+
+  /** Get the pool shared by all the queues without a specific
+      worker thread property
+
+      C++11 guaranties the static construction is thread-safe.
+  */
+  static std::shared_ptr<worker_pool> default_pool() {
+    static auto p = [] {
+      auto wp = std::make_shared<worker_pool>(default_capacity());
+      wp->set_placement(detail::placement::global());
+      return wp;
+    }();
+    return p;
+  }
+
+
+  /** Run the workers started from now on and their kernels on some
+      NUMA nodes
+
+      \param[in] where is the placement to use, or nullptr to let the
+      operating system decide
+  */
+  void set_placement(std::shared_ptr<const detail::placement> where) {
+    std::lock_guard<std::mutex> lg { s->m };
+    s->where = std::move(where);
+  }
+
+
+  /** Share the threads among the kernels of the workers started from
+      now on with their own governor
+
+      \param[in] g is the governor to use, or nullptr to use the global
+      one
+  */
+  void set_governor(std::shared_ptr<detail::concurrency_governor> g) {
+    std::lock_guard<std::mutex> lg { s->m };
+    s->governor = std::move(g);
+  }
+
+
+  /** Submit some work to be executed by a worker
+
+      \param[in] f is the callable to execute, taking no arguments
+
+      \param[in] high_priority makes the next available worker execute
+      this work before any normal-priority work still waiting
+
+      \param[in] rank makes this work served before the normal-priority
+      work of a lower rank still waiting
+  */
+  void submit(std::function<void(void)> f, bool high_priority = false,
+              std::uint64_t rank = 0) {
+    std::unique_lock<std::mutex> ul { s->m };
+    s->push(std::move(f), high_priority, rank);
+    if (s->idle >= s->pending()
+        || (!s->elastic && s->live >= s->capacity)) {
+      // There is an idle or a future idle worker for this work
+      ul.unlock();
+      s->work_available.notify_one();
+      return;
+    }
+    if (s->live >= s->limit()) {
+      // A busy worker takes this work later, unless they are stuck
+      watch(s, ul);
+      return;
+    }
+    // Otherwise start a new worker up to the limit
+    ++s->live;
+    ul.unlock();
+    std::thread { [st = s] { run(st); } }.detach();
+    TRISYCL_DUMP_T("worker_pool started a new worker");
+  }
+
+
+  /** Submit some work to be executed all at the same time, such as
+      some kernels connected by blocking pipes
+
+      Enough workers are started for all the work waiting, even above
+      the capacity of a pool which is not elastic, so no part of the
+      gang waits for another one to finish. The extra workers retire
+      when they run out of work.
+
+      \param[in] gang is the callables to execute, taking no arguments
+
+      \param[in] high_priority makes the gang served before any
+      normal-priority work still waiting
+  */
+  void submit_gang(std::vector<std::function<void(void)>> gang,
+                   bool high_priority = false) {
+    std::unique_lock<std::mutex> ul { s->m };
+    for (auto &f : gang)
+      s->push(std::move(f), high_priority);
+    auto missing = s->pending() > s->idle ? s->pending() - s->idle : 0;
+    s->live += missing;
+    ul.unlock();
+    s->work_available.notify_all();
+    for (std::size_t i = 0; i != missing; ++i)
+      std::thread { [st = s] { run(st); } }.detach();
+    TRISYCL_DUMP_T("worker_pool started " << missing
+                   << " new workers for a gang of " << gang.size());
+  }
+
+
+  /** Submit a batch of work under a single lock, such as the command
+      groups of a queue::submit_batch()
+
+      Unlike a gang, the work is executed in submission order by the
+      available workers, so a work blocked on some earlier work does
+      not need a worker of its own. Only the missing workers up to the
+      capacity are started, and at least one if none is idle, as for a
+      single submission, in case all the workers are blocked.
+
+      \param[in] batch is the callables to execute, taking no arguments
+
+      \param[in] high_priority makes the batch served before any
+      normal-priority work still waiting
+  */
+  void submit_bulk(std::vector<std::function<void(void)>> batch,
+                   bool high_priority = false) {
+    std::unique_lock<std::mutex> ul { s->m };
+    for (auto &f : batch)
+      s->push(std::move(f), high_priority);
+    auto missing = s->pending() > s->idle ? s->pending() - s->idle : 0;
+    auto room = s->capacity > s->live ? s->capacity - s->live : 0;
+    if (s->elastic && s->idle == 0)
+      room = std::max<std::size_t>(room, 1);
+    missing = std::min(missing, room);
+    s->live += missing;
+    ul.unlock();
+    s->work_available.notify_all();
+    for (std::size_t i = 0; i != missing; ++i)
+      std::thread { [st = s] { run(st); } }.detach();
+    TRISYCL_DUMP_T("worker_pool started " << missing
+                   << " new workers for a batch of " << batch.size());
+  }
+
+
+  /** Wait for the submitted work to be done and the workers to exit
+
+      Do not wait if the pool is destroyed from one of its workers,
+      which will exit on its own after its current work.
+  */
+  ~worker_pool() {
+    std::unique_lock<std::mutex> ul { s->m };
+    s->stopping = true;
+    s->work_available.notify_all();
+    if (current_pool() != s.get())
+      s->all_done.wait(ul, [&] { return s->live == 0; });
+  }
+
+private:
+
+  /// The worker thread job
+  static void run(std::shared_ptr<state> st) {
+    current_pool() = st.get();
+    std::unique_lock<std::mutex> ul { st->m };
+    // The governor lives as long as the worker using it
+    auto governor = st->governor;
+    detail::concurrency_governor::current() = governor.get();
+    if (auto where = st->where) {
+      // The placement lives as long as the worker owning it
+      detail::placement::current() = where.get();
+      ul.unlock();
+      detail::placement::pin(where->cpus());
+      ul.lock();
+    }
+    for (;;) {
+      if (st->pending() == 0) {
+        if (st->stopping)
+          break;
+        ++st->idle;
+        bool timed_out = false;
+        if (st->live > st->limit())
+          // Only linger for a while before retiring when above the limit
+          timed_out = !st->work_available.wait_for(ul, linger, [&] {
+              return st->pending() != 0 || st->stopping;
+            });
+        else
+          st->work_available.wait(ul, [&] {
+              return st->pending() != 0 || st->stopping;
+            });
+        --st->idle;
+        if (timed_out && st->live > st->limit())
+          break;
+        continue;
+      }
+      auto f = st->pop();
+      ++st->started;
+      if (st->pending() == 0)
+        // The extra workers are no longer needed by the waiting work
+        st->stalled = 0;
+      ul.unlock();
+      f();
+      // Release what the work captured before going back to sleep
+      f = nullptr;
+      ul.lock();
+      if (polling()) {
+        polling() = false;
+        --st->blocked;
+      }
+    }
+    if (--st->live == 0)
+      st->all_done.notify_all();
+    TRISYCL_DUMP_T("worker_pool worker exits");
+  }
+
+
+  /** The watchdog thread job, starting an extra worker each time no
+      work has been started for a while although some is waiting
+
+      This guaranties the forward progress when all the workers wait
+      for some work still waiting without being known as blocked.
+  */
+  static void watchdog(std::shared_ptr<state> st) {
+    std::unique_lock<std::mutex> ul { st->m };
+    for (;;) {
+      auto started = st->started;
+      ul.unlock();
+      std::this_thread::sleep_for(stall);
+      ul.lock();
+      if (st->stopping || st->idle >= st->pending())
+        break;
+      if (st->started != started)
+        continue;
+      if (st->live >= st->limit())
+        ++st->stalled;
+      ++st->live;
+      ul.unlock();
+      std::thread { [=] { run(st); } }.detach();
+      TRISYCL_DUMP_T("worker_pool started a worker for some stalled work");
+      ul.lock();
+    }
+    st->watched = false;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DETAIL_WORKER_POOL_HPP
@@ -13,6 +13,7 @@
 #include <functional>
 #include <memory>
 #include <any>
+#include <vector>
 
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
@@ -22,6 +23,7 @@
 
 #include "triSYCL/device/facade/device.hpp"
 #include "triSYCL/device/detail/host_device.hpp"
+#include "triSYCL/device/detail/host_sub_device.hpp"
 #ifdef TRISYCL_OPENCL
 #include "triSYCL/device/detail/opencl_device.hpp"
 #endif
@@ -228,25 +230,84 @@ public:
     return implementation->has_extension(extension);
   }
 
-  // Available only when prop == info::partition_property::partition_equally
+  /** Partition the host device into as many sub-devices as possible
+      of \p nbSubDev compute units each
+
+      Each host sub-device owns some CPUs, with its own workers
+      shared by its queues, so the kernels of different sub-devices do
+      not compete for the same cores. Only available when \p prop is
+      info::partition_property::partition_equally.
+  */
   template <info::partition_property prop>
-  vector_class<device> create_sub_devices(size_t nbSubDev) const
-  {
-    throw trisycl::feature_not_supported("unsupported feature\n");
+  vector_class<device> create_sub_devices(size_t nbSubDev) const {
+    static_assert(prop == info::partition_property::partition_equally,
+                  "Partitioning by a number of compute units is "
+                  "partition_equally");
+    return make_sub_devices(
+      detail::host_sub_device::split_equally(cpus(), nbSubDev), prop);
   }
 
-  // Available only when prop == info::partition_property::partition_by_counts
+
+  /** Partition the host device into some sub-devices of \p counts
+      compute units
+
+      Only available when \p prop is
+      info::partition_property::partition_by_counts.
+  */
   template <info::partition_property prop>
-  vector_class<device> create_sub_devices(const vector_class<size_t> &counts) const
-  {
-    throw trisycl::feature_not_supported("unsupported feature\n");
+  vector_class<device>
+  create_sub_devices(const vector_class<size_t> &counts) const {
+    static_assert(prop == info::partition_property::partition_by_counts,
+                  "Partitioning by some counts is partition_by_counts");
+    return make_sub_devices(
+      detail::host_sub_device::split_by_counts(cpus(), counts), prop);
   }
 
-  // Available only when prop == info::partition_property::partition_by_affinity_domain
+
+  /** Partition the host device into the sub-devices sharing an \p
+      affinityDomain, such as a NUMA node or a L3 cache
+
+      Only available when \p prop is
+      info::partition_property::partition_by_affinity_domain.
+  */
   template <info::partition_property prop>
-  vector_class<device> create_sub_devices(info::partition_affinity_domain affinityDomain) const
-  {
-    throw trisycl::feature_not_supported("unsupported feature\n");
+  vector_class<device>
+  create_sub_devices(info::partition_affinity_domain affinityDomain) const {
+    static_assert(prop
+                  == info::partition_property::partition_by_affinity_domain,
+                  "Partitioning by an affinity domain is "
+                  "partition_by_affinity_domain");
+    auto [groups, domain] =
+      detail::host_sub_device::split_by_affinity(cpus(), affinityDomain);
+    return make_sub_devices(groups, prop, domain);
+  }
+
+private:
+
+  /// Get the CPUs of this host device to partition
+  std::vector<unsigned> cpus() const {
+    auto c = detail::host_sub_device::cpus_of(implementation);
+    if (c.empty())
+      throw trisycl::feature_not_supported {
+        "Only the host device can be partitioned"
+      };
+    return c;
+  }
+
+
+  /// Make the host sub-devices running on each group of CPUs
+  vector_class<device>
+  make_sub_devices(const std::vector<std::vector<unsigned>> &groups,
+                   info::partition_property prop,
+                   info::partition_affinity_domain domain =
+                     info::partition_affinity_domain::not_applicable) const {
+    vector_class<device> sub_devices;
+    for (auto &g : groups) {
+      auto &d = sub_devices.emplace_back();
+      d.implementation = std::make_shared<detail::host_sub_device>(
+        implementation, g, prop, domain);
+    }
+    return sub_devices;
   }
 
 };
@@ -27,8 +27,8 @@ device::get_devices(info::device_type device_type) {
   vector_class<device> devices = { {} };
 
 #ifdef TRISYCL_OPENCL
-  // Then add all the OpenCL devices
-  for (const auto &d : boost::compute::system::devices())
+  // Then add the OpenCL devices, enumerated only once
+  for (const auto &d : detail::opencl_discovery::instance()->get_devices())
     devices.emplace_back(d);
 #endif
 
@@ -16,6 +16,7 @@
 #include "triSYCL/detail/singleton.hpp"
 #include "triSYCL/detail/unimplemented.hpp"
 #include "triSYCL/device/detail/device.hpp"
+#include "triSYCL/device/detail/host_sub_device.hpp"
 #include "triSYCL/exception.hpp"
 #include "triSYCL/info/param_traits.hpp"
 #include "triSYCL/platform.hpp"
@@ -105,6 +106,26 @@ public:
     TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(device_type, info::device_type::host)
     TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(local_mem_type, info::local_mem_type::global)
     TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(local_mem_size, static_cast<trisycl::cl_ulong>(32768))
+    TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(partition_max_sub_devices,
+      static_cast<trisycl::cl_uint>(
+        host_sub_device::cpus_of(instance()).size()))
+    TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(partition_properties,
+      (vector_class<info::partition_property> {
+        info::partition_property::partition_equally,
+        info::partition_property::partition_by_counts,
+        info::partition_property::partition_by_affinity_domain }))
+    TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(partition_affinity_domains,
+      (vector_class<info::partition_affinity_domain> {
+        info::partition_affinity_domain::numa,
+        info::partition_affinity_domain::L4_cache,
+        info::partition_affinity_domain::L3_cache,
+        info::partition_affinity_domain::L2_cache,
+        info::partition_affinity_domain::L1_cache,
+        info::partition_affinity_domain::next_partitionable }))
+    TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(partition_type_property,
+      info::partition_property::no_partition)
+    TRISYCL_DEFINE_DEVICE_HOST_INFO_TEMPLATE(partition_type_affinity_domain,
+      info::partition_affinity_domain::not_applicable)
     default:
       return 0;
     }
@@ -0,0 +1,338 @@
+#ifndef TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_HPP
+#define TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_HPP
+
+/** \file A part of the SYCL host device running on some of the CPUs
+
+    Several independent services in a process would otherwise compete
+    for all the cores with their kernels. A host sub-device owns a
+    disjoint set of CPUs, with its own workers pinned on them and its
+    own concurrency_governor sharing only these CPUs among its kernels,
+    so the queues on different sub-devices do not thrash the caches of
+    each other.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <any>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/default_classes.hpp"
+#include "triSYCL/detail/placement.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/device/detail/device.hpp"
+#include "triSYCL/exception.hpp"
+#include "triSYCL/info/device.hpp"
+#include "triSYCL/platform.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// A SYCL host sub-device, running its kernels on some CPUs only
+class host_sub_device : public detail::device {
+
+  /// The device this one is a partition of
+  std::shared_ptr<detail::device> parent;
+
+  /// The CPUs owned by this sub-device
+  std::vector<unsigned> cpus;
+
+  /// How the parent device was partitioned
+  info::partition_property property;
+
+  /// The affinity domain of the partition, if partitioned by affinity
+  info::partition_affinity_domain domain;
+
+  /// Where the workers of the sub-device run
+  std::shared_ptr<detail::placement> where;
+
+  /// What shares the CPUs among the kernels of the sub-device
+  std::shared_ptr<detail::concurrency_governor> governor;
+
+  /// The workers shared by the queues on this sub-device
+  std::shared_ptr<detail::task_executor> workers;
+
+
+  /** Get the CPUs sharing with \p cpu the affinity \p domain, or
+      nothing if it is unknown
+  */
+  static std::vector<unsigned>
+  domain_cpus(unsigned cpu, info::partition_affinity_domain domain) {
+    if (domain == info::partition_affinity_domain::numa) {
+      std::ifstream f { "/sys/devices/system/node/possible" };
+      std::string l;
+      std::getline(f, l);
+      for (auto n : placement::parse_list(l))
+        if (auto c = placement::node_cpus(n);
+            std::find(c.begin(), c.end(), cpu) != c.end())
+          return c;
+      return {};
+    }
+    auto level = domain == info::partition_affinity_domain::L1_cache ? 1
+      : domain == info::partition_affinity_domain::L2_cache ? 2
+      : domain == info::partition_affinity_domain::L3_cache ? 3 : 4;
+    auto dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu)
+      + "/cache/index";
+    for (int i = 0;; ++i) {
+      std::ifstream l { dir + std::to_string(i) + "/level" };
+      if (!l)
+        return {};
+      int cache_level = 0;
+      l >> cache_level;
+      std::string type;
+      std::ifstream { dir + std::to_string(i) + "/type" } >> type;
+      if (cache_level == level && type != "Instruction") {
+        std::ifstream f { dir + std::to_string(i) + "/shared_cpu_list" };
+        std::string shared;
+        std::getline(f, shared);
+        return placement::parse_list(shared);
+      }
+    }
+  }
+
+public:
+
+  /** Create a sub-device of \p parent running on \p cpus, as
+      partitioned with \p property and \p domain
+  */
+  host_sub_device(std::shared_ptr<detail::device> parent,
+                  std::vector<unsigned> cpus,
+                  info::partition_property property,
+                  info::partition_affinity_domain domain =
+                    info::partition_affinity_domain::not_applicable)
+    : parent { std::move(parent) }
+    , cpus { std::move(cpus) }
+    , property { property }
+    , domain { domain }
+    , where { std::make_shared<detail::placement>() }
+    , governor { std::make_shared<detail::concurrency_governor>(
+        this->cpus.size()) }
+    , workers { std::make_shared<detail::task_executor>(this->cpus.size()) } {
+    where->nodes.push_back(this->cpus);
+    workers->set_placement(where);
+    workers->set_governor(governor);
+  }
+
+
+  /** Get the CPUs a host device or sub-device \p d runs on, or
+      nothing if it is not a host device
+  */
+  static std::vector<unsigned>
+  cpus_of(const std::shared_ptr<detail::device> &d) {
+    if (auto s = std::dynamic_pointer_cast<host_sub_device>(d))
+      return s->cpus;
+    if (!d->is_host())
+      return {};
+    auto all = placement::affinity_cpus(nullptr);
+    if (all.empty())
+      // Without knowing the CPUs, number them all
+      for (unsigned c = 0; c != std::thread::hardware_concurrency(); ++c)
+        all.push_back(c);
+    return all;
+  }
+
+
+  /// Split \p cpus into as many groups as possible of \p n CPUs each
+  static std::vector<std::vector<unsigned>>
+  split_equally(const std::vector<unsigned> &cpus, std::size_t n) {
+    if (n == 0 || n > cpus.size())
+      throw ::trisycl::invalid_parameter_error {
+        "Cannot partition the device equally with this number of "
+        "compute units"
+      };
+    std::vector<std::vector<unsigned>> groups;
+    for (std::size_t i = 0; i + n <= cpus.size(); i += n)
+      groups.emplace_back(cpus.begin() + i, cpus.begin() + i + n);
+    return groups;
+  }
+
+
+  /// Split \p cpus into some groups of \p counts CPUs
+  static std::vector<std::vector<unsigned>>
+  split_by_counts(const std::vector<unsigned> &cpus,
+                  const vector_class<std::size_t> &counts) {
+    std::vector<std::vector<unsigned>> groups;
+    std::size_t first = 0;
+    for (auto n : counts) {
+      if (n == 0 || n > cpus.size() - first)
+        throw ::trisycl::invalid_parameter_error {
+          "The counts of the partition exceed the compute units of the "
+          "device"
+        };
+      groups.emplace_back(cpus.begin() + first, cpus.begin() + first + n);
+      first += n;
+    }
+    return groups;
+  }
+
+
+  /** Split \p cpus into the groups sharing an affinity \p domain
+
+      With \c next_partitionable, the first of the NUMA node and the
+      caches from the outermost one splitting the CPUs is used.
+
+      \return the groups and the domain used
+  */
+  static std::pair<std::vector<std::vector<unsigned>>,
+                   info::partition_affinity_domain>
+  split_by_affinity(const std::vector<unsigned> &cpus,
+                    info::partition_affinity_domain domain) {
+    if (domain == info::partition_affinity_domain::next_partitionable) {
+      for (auto d : { info::partition_affinity_domain::numa,
+                      info::partition_affinity_domain::L4_cache,
+                      info::partition_affinity_domain::L3_cache,
+                      info::partition_affinity_domain::L2_cache,
+                      info::partition_affinity_domain::L1_cache })
+        try {
+          if (auto g = split_by_affinity(cpus, d); g.first.size() > 1)
+            return g;
+        } catch (const ::trisycl::feature_not_supported &) {
+          // Try the next domain
+        }
+      throw ::trisycl::feature_not_supported {
+        "No affinity domain splits the host device"
+      };
+    }
+    std::vector<std::vector<unsigned>> groups;
+    std::vector<bool> assigned(cpus.size());
+    for (std::size_t i = 0; i != cpus.size(); ++i) {
+      if (assigned[i])
+        continue;
+      auto shared = domain_cpus(cpus[i], domain);
+      if (shared.empty())
+        throw ::trisycl::feature_not_supported {
+          "This affinity domain is unknown on the host device"
+        };
+      auto &g = groups.emplace_back();
+      for (std::size_t j = i; j != cpus.size(); ++j)
+        if (!assigned[j]
+            && std::find(shared.begin(), shared.end(), cpus[j])
+               != shared.end()) {
+          g.push_back(cpus[j]);
+          assigned[j] = true;
+        }
+      if (!assigned[i]) {
+        // The CPU is not in its own domain, so keep it alone
+        g.push_back(cpus[i]);
+        assigned[i] = true;
+      }
+    }
+    return { std::move(groups), domain };
+  }
+
+
+  /// Get the CPUs owned by this sub-device
+  const std::vector<unsigned> &get_cpus() const {
+    return cpus;
+  }
+
+
+  /// Get the workers shared by the queues on this sub-device
+  std::shared_ptr<detail::task_executor> get_worker_pool() const {
+    return workers;
+  }
+
+
+  /// Get where the workers of this sub-device run
+  std::shared_ptr<const detail::placement> get_placement() const {
+    return where;
+  }
+
+
+  /// Get what shares the CPUs among the kernels of this sub-device
+  std::shared_ptr<detail::concurrency_governor> get_governor() const {
+    return governor;
+  }
+
+
+#ifdef TRISYCL_OPENCL
+  /** Return the cl_device_id of the underlying OpenCL platform
+
+      This throws an error since there is no OpenCL device associated
+      to the host device.
+  */
+  cl_device_id get() const override {
+    throw non_cl_error("The host device has no OpenCL device");
+  }
+
+
+  /** Return the underlying Boost.Compute device
+
+      This throws an error since there is no OpenCL device associated
+      to the host device.
+  */
+  boost::compute::device &get_boost_compute() override {
+    throw non_cl_error("The host device has no underlying OpenCL device");
+  }
+#endif
+
+
+  /// Return true since the sub-device is a part of the SYCL host device
+  bool is_host() const override {
+    return true;
+  }
+
+
+  /// Return false since the host device is not an OpenCL CPU device
+  bool is_cpu() const override {
+    return false;
+  }
+
+
+  /// Return false since the host device is not an OpenCL GPU device
+  bool is_gpu() const override {
+    return false;
+  }
+
+
+  /// Return false since the host device is not an OpenCL accelerator device
+  bool is_accelerator() const override {
+    return false;
+  }
+
+
+  /// Return the platform of the parent device
+  trisycl::platform get_platform() const override {
+    return parent->get_platform();
+  }
+
+
+  /** Query the device for OpenCL info::device info
+
+      This is defined in host_sub_device_tail.hpp, once a device can
+      be returned as the parent device.
+  */
+  std::any get_info(info::device param) const override;
+
+
+  /// Specify whether a specific extension is supported on the device
+  bool has_extension(const string_class &extension) const override {
+    return parent->has_extension(extension);
+  }
+
+};
+
+/// @} to end the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_HPP
@@ -0,0 +1,52 @@
+#ifndef TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_TAIL_HPP
+#define TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_TAIL_HPP
+
+/** \file The ending part of the host sub-device
+
+    This is here to return the parent device, once the device class
+    is defined.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// Query the sub-device for OpenCL info::device info
+inline std::any host_sub_device::get_info(info::device param) const {
+  switch (param) {
+  case info::device::max_compute_units:
+  case info::device::partition_max_sub_devices:
+    return static_cast<::trisycl::cl_uint>(cpus.size());
+  case info::device::parent_device: {
+    ::trisycl::device d;
+    d.implementation = parent;
+    return d;
+  }
+  case info::device::partition_type_property:
+    return property;
+  case info::device::partition_type_affinity_domain:
+    return domain;
+  default:
+    // The sub-device is otherwise like its parent device
+    return parent->get_info(param);
+  }
+}
+
+/// @} to end the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_DEVICE_DETAIL_HOST_SUB_DEVICE_TAIL_HPP
@@ -33,9 +33,15 @@ class opencl_device : public detail::device {
   /** A cache to always return the same alive device for a given
       OpenCL device
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
   */
-  static detail::cache<cl_device_id, detail::opencl_device> cache;
+  static auto &cache() {
+    static auto c = new detail::cache<cl_device_id, detail::opencl_device>;
+    return *c;
+  }
 
 public:
 
@@ -102,8 +108,8 @@ public:
   ///// Get a singleton instance of the opencl_device
   static std::shared_ptr<opencl_device>
   instance(const boost::compute::device &d) {
-    return cache.get_or_register(d.id(),
-                                 [&] { return new opencl_device { d }; });
+    return cache().get_or_register(d.id(),
+                                   [&] { return new opencl_device { d }; });
   }
 
 private:
@@ -117,19 +123,11 @@ public:
 
   /// Unregister from the cache on destruction
   ~opencl_device() override {
-    cache.remove(d.id());
+    cache().remove(d.id());
   }
 
 };
 
-/* Allocate the cache here but since this is a pure-header library,
-   use a weak symbol so that only one remains when SYCL headers are
-   used in different compilation units of a program
-*/
-TRISYCL_WEAK_ATTRIB_PREFIX
-detail::cache<cl_device_id, detail::opencl_device> opencl_device::cache
-TRISYCL_WEAK_ATTRIB_SUFFIX;
-
 }
 
 /*
@@ -16,12 +16,23 @@
 */
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
+#include <unistd.h>
 #endif
 #include <boost/optional.hpp>
 
@@ -36,6 +47,7 @@
 #endif
 #include "triSYCL/info/device.hpp"
 #include "triSYCL/device_selector.hpp"
+#include "triSYCL/exception.hpp"
 #include "triSYCL/platform.hpp"
 
 /// The device-side runtime
@@ -149,29 +161,113 @@ serialize_accessor_arg(detail::task &task,
 }
 
 
+/** Copy a scalar argument of the kernel into its packed arguments
+
+    When the device compiler packs the arguments, all the scalar
+    captures of a kernel are gathered into a single structure passed
+    by value, so a launch sets only this argument and the accessors
+    instead of one argument per capture.
+
+    \param[in] task is the implementation detail of a triSYCL kernel
+
+    \param[in] offset is the position of the argument in the structure
+
+    \param[in] arg points to the argument value
+
+    \param[in] arg_size is the size of the argument
+*/
+TRISYCL_WEAK_ATTRIB_PREFIX void TRISYCL_WEAK_ATTRIB_SUFFIX
+serialize_packed_arg(detail::task &task,
+                     std::size_t offset,
+                     void *arg,
+                     std::size_t arg_size) {
+  TRISYCL_DUMP_T("serialize_packed_arg offset = " << offset
+                 << ", size = " << arg_size << ", arg = " << arg);
+  task.pack_arg(offset, arg_size, arg);
+}
+
+
+/** Set the packed scalar arguments of the kernel, once all of them
+    have been serialized with serialize_packed_arg()
+
+    \param[in] task is the implementation detail of a triSYCL kernel
+
+    \param[in] index is the order of the argument receiving the
+    structure (0 is the first one)
+*/
+TRISYCL_WEAK_ATTRIB_PREFIX void TRISYCL_WEAK_ATTRIB_SUFFIX
+set_packed_args(detail::task &task, std::size_t index) {
+  TRISYCL_DUMP_T("set_packed_args index = " << index
+                 << ", size = " << task.packed_args.size());
+  task.set_packed_args(index);
+}
+
+
 /// The binary code of the kernels
 namespace code {
 
-  /// A binary program containing some kernels
+  /** A binary program containing some kernels
+
+      Each translation unit compiled for the device registers its
+      program, and the program of a kernel is only built on the first
+      use of one of its kernels.
+
+      The binary may be compressed by \c triSYCL_tool \c --compress,
+      in which case it is only decompressed when the program is built,
+      so the registration at start-up stays cheap.
+  */
   struct program {
+    /// The type of a function decompressing a binary
+    using decompressor =
+      std::vector<unsigned char> (*)(const unsigned char *, std::size_t);
+
     /// The size of a binary program
     std::size_t binary_size;
     /// The bytes of program. Use this type for \c boost::compute
     unsigned const char *binary;
+    /// The decompressor of the binary, if it is compressed
+    decompressor decompress;
 
-    /** The current program
-
-        \todo Deal with several programs
-    */
+    /// The latest program registered
     static TRISYCL_WEAK_ATTRIB_PREFIX boost::optional<program> TRISYCL_WEAK_ATTRIB_SUFFIX
     p;
 
-    program(std::size_t binary_size, const char *binary)
+    /** Describe a binary program
+
+        \param[in] registered makes the program available to the
+        kernel lookup by name
+
+        \param[in] decompress is the decompressor of a compressed
+        binary
+    */
+    program(std::size_t binary_size, const char *binary,
+            bool registered = true, decompressor decompress = nullptr)
       : binary_size { binary_size }
-      , binary { reinterpret_cast<unsigned const char *>(binary) } {
+      , binary { reinterpret_cast<unsigned const char *>(binary) }
+      , decompress { decompress } {
+        if (!registered)
+          return;
         p = *this;
+        programs().push_back(*this);
         TRISYCL_DUMP_T("Create program with binary size = 0x" << binary_size);
       }
+
+
+    /** Get all the programs registered, in the order of their
+        registration during the program initialization
+    */
+    static std::vector<program> &programs() {
+      static auto v = new std::vector<program>;
+      return *v;
+    }
+
+
+    /// Get the bytes of the program, decompressing them if needed
+    std::vector<unsigned char> bytes() const {
+      if (decompress)
+        return decompress(binary, binary_size);
+      return { binary, binary + binary_size };
+    }
   };
 
   TRISYCL_WEAK_ATTRIB_PREFIX boost::optional<program>
@@ -187,8 +283,220 @@ TRISYCL_WEAK_ATTRIB_PREFIX std::map<std::string, std::vector<unsigned char>>
 TRISYCL_WEAK_ATTRIB_SUFFIX kernel_IR;
 
 
+#ifdef TRISYCL_OPENCL
+/** The OpenCL programs built from the binary code of the kernels and
+    their kernels, for each context
+
+    Building a SPIR or XCLBIN program may take seconds on an FPGA, so
+    it is done only once per context, and even only once per device
+    across the runs when the \c TRISYCL_PROGRAM_CACHE environment
+    variable names a directory to keep the device binaries.
+
+    A kernel is reused by the next launches once the task which used
+    it is gone, since its arguments cannot be shared by 2 tasks in
+    flight.
+*/
+class built_programs {
+
+  /// To protect all the members
+  std::mutex m;
+
+  /// The programs indexed by context and binary code
+  std::map<std::pair<cl_context, const unsigned char *>,
+           boost::compute::program> programs;
+
+  /// The kernels indexed by context, binary code and name
+  std::map<std::tuple<cl_context, const unsigned char *, std::string>,
+           std::vector<std::shared_ptr<detail::kernel>>> kernels;
+
+  /// The registered program containing each kernel found so far
+  std::map<std::string, code::program> kernel_programs;
+
+  /// The number of registered programs whose kernels are known
+  std::size_t scanned_programs = 0;
+
+
+  /// Get the program built for a context, building it on first use
+  boost::compute::program &
+  get_program(const boost::compute::context &context,
+              const code::program &binary) {
+    auto [p, inserted] =
+      programs.try_emplace({ context.get(), binary.binary });
+    if (inserted)
+      try {
+        p->second = build(context, binary);
+      } catch (...) {
+        // Try again on next use
+        programs.erase(p);
+        throw;
+      }
+    return p->second;
+  }
+
+
+  /** Get the file caching the device binary of a program, if the
+      \c TRISYCL_PROGRAM_CACHE environment variable names a directory
+
+      The file name is a hash of the device, of its driver version, of
+      the build options and of the binary code, so a new driver or
+      some new kernels do not use a stale device binary.
+  */
+  static std::string cache_file(const boost::compute::device &device,
+                                const code::program &binary) {
+    auto directory = std::getenv("TRISYCL_PROGRAM_CACHE");
+    if (!directory)
+      return {};
+    // 64-bit FNV-1a
+    std::uint64_t h = 0xcbf29ce484222325;
+    auto hash = [&] (const unsigned char *first, std::size_t size) {
+      for (std::size_t i = 0; i != size; ++i)
+        h = (h ^ first[i])*0x100000001b3;
+      // Separate the fields
+      h = (h ^ 0xff)*0x100000001b3;
+    };
+    auto hash_string = [&] (const std::string &s) {
+      hash(reinterpret_cast<const unsigned char *>(s.data()), s.size());
+    };
+    hash_string(device.name());
+    hash_string(device.driver_version());
+    // The programs are built without any option
+    hash_string("");
+    hash(binary.binary, binary.binary_size);
+    std::ostringstream name;
+    name << directory << "/trisycl-" << std::hex << h << ".bin";
+    return name.str();
+  }
+
+
+  /** Build the program from the binary code, or load the device binary
+      built by a previous run from the on-disk cache
+  */
+  static boost::compute::program
+  build(const boost::compute::context &context, const code::program &binary) {
+    auto device = context.get_device();
+    auto file = cache_file(device, binary);
+    if (!file.empty())
+      if (std::ifstream in { file, std::ios::binary }) {
+        std::vector<unsigned char> cached {
+          std::istreambuf_iterator<char> { in },
+          std::istreambuf_iterator<char> {}
+        };
+        TRISYCL_DUMP_T("Load the device binary from " << file);
+        try {
+          auto p = boost::compute::program::create_with_binary(cached,
+                                                               context);
+          p.build();
+          return p;
+        } catch (const boost::compute::opencl_error &) {
+          // Rebuild a corrupted or incompatible device binary
+        }
+      }
+    TRISYCL_DUMP_T("Build program with binary size = 0x"
+                   << binary.binary_size);
+    // Construct an OpenCL program from the precompiled kernel file
+    auto p = binary.decompress
+      ? boost::compute::program::create_with_binary(binary.bytes(), context)
+      : boost::compute::program::create_with_binary
+          (binary.binary, binary.binary_size, context);
+    p.build();
+    if (!file.empty()) {
+      auto device_binary = p.binary();
+      /* Write to another file first, so a concurrent process never
+         reads a partial binary */
+      auto partial = file + ".tmp" + std::to_string(::getpid());
+      if (std::ofstream out { partial, std::ios::binary };
+          out.write(reinterpret_cast<const char *>(device_binary.data()),
+                    device_binary.size()))
+        out.close();
+      std::rename(partial.c_str(), file.c_str());
+    }
+    return p;
+  }
+
+
+  /** Find the binary program containing a kernel
+
+      The code of the kernel in \c kernel_IR is used first. Otherwise
+      the registered programs are built in order up to the one listing
+      the kernel, so the programs after it are not built until one of
+      their kernels is used. Without the kernel names of OpenCL 1.2,
+      the latest program registered is used.
+  */
+  code::program find_program(const boost::compute::context &context,
+                             const char *kernel_name,
+                             const char *short_name) {
+    if (auto ir = kernel_IR.find(kernel_name); ir != kernel_IR.end())
+      return { ir->second.size(),
+               reinterpret_cast<const char *>(ir->second.data()), false };
+    auto &registered = code::program::programs();
+    if (registered.empty())
+      throw kernel_error { "No device program registered for kernel "
+                           + std::string { kernel_name } };
+#ifdef BOOST_COMPUTE_CL_VERSION_1_2
+    for (;;) {
+      if (auto p = kernel_programs.find(short_name);
+          p != kernel_programs.end())
+        return p->second;
+      if (scanned_programs == registered.size())
+        // Let the kernel creation report the missing kernel
+        break;
+      auto &candidate = registered[scanned_programs];
+      auto names = get_program(context, candidate)
+        .get_info<std::string>(CL_PROGRAM_KERNEL_NAMES);
+      ++scanned_programs;
+      // The names are separated by ';'
+      std::istringstream in { names };
+      for (std::string name; std::getline(in, name, ';');)
+        kernel_programs.try_emplace(name, candidate);
+    }
+#endif
+    return registered.back();
+  }
+
+public:
+
+  /** Get the cache used by the device runtime
+
+      It is never destroyed, so that the kernels still alive during
+      the program exit can use their program.
+  */
+  static built_programs &instance() {
+    static auto b = new built_programs;
+    return *b;
+  }
+
+
+  /// Get a kernel not used by any task, from the cache or built
+  std::shared_ptr<detail::kernel>
+  get_kernel(const boost::compute::context &context,
+             const char *kernel_name,
+             const char *short_name) {
+    std::lock_guard lg { m };
+    auto binary = find_program(context, kernel_name, short_name);
+    auto &free_kernels = kernels[{ context.get(), binary.binary,
+                                   short_name }];
+    for (auto &k : free_kernels)
+      // Only the cache owns it, so no task can set its arguments
+      if (k.use_count() == 1)
+        return k;
+    // Build a SYCL kernel from the OpenCL kernel
+    trisycl::kernel k {
+      boost::compute::kernel { get_program(context, binary), short_name }
+    };
+    free_kernels.push_back(k.implementation);
+    return k.implementation;
+  }
+
+};
+#endif
+
+
 /** Set the kernel for a later invocation
 
+    The program containing the kernel is found by the name of the
+    kernel and built only on the first use in the context of the
+    queue.
+
     \param[in] task is the implementation detail of a triSYCL kernel
 
     \param[in] kernel_name is set by the device compiler to identify
@@ -200,25 +508,12 @@ set_kernel(detail::task &task,
            const char *kernel_short_name) {
   TRISYCL_DUMP_T("set_kernel setting up " << kernel_name
                  << "\n\taka " << kernel_short_name);
-  // \todo Add kernel caching per device
-  // auto binary = kernel_IR.find(kernel_name);
-  // if (binary == kernel_IR.end()) {
 #ifdef TRISYCL_OPENCL
-  auto context = task.get_queue()->get_boost_compute().get_context();
-  // Construct an OpenCL program from the precompiled kernel file
-  auto program = boost::compute::program::create_with_binary
-    (code::program::p->binary,
-     code::program::p->binary_size,
-     context);
-  TRISYCL_DUMP_T("...on device with name "
-                 << task.get_queue()->get_boost_compute().get_device().name());
-  // Build the OpenCL program
-  program.build();
-
-  // Build a SYCL kernel from the OpenCL kernel
-  trisycl::kernel k { boost::compute::kernel { program, kernel_short_name } };
-
-  task.set_kernel(k.implementation);
+  auto &q = task.get_queue()->get_boost_compute();
+  TRISYCL_DUMP_T("...on device with name " << q.get_device().name());
+  task.set_kernel(built_programs::instance()
+                  .get_kernel(q.get_context(), kernel_name,
+                              kernel_short_name));
 #endif
 }
 
@@ -8,6 +8,15 @@
     This file is distributed under the University of Illinois Open Source
     License. See LICENSE.TXT for details.
 */
+#include <memory>
+
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/default_classes.hpp"
+#include "triSYCL/detail/global_config.hpp"
+#include "triSYCL/detail/shared_ptr_implementation.hpp"
+#include "triSYCL/detail/unimplemented.hpp"
+#include "triSYCL/exception.hpp"
+#include "triSYCL/info/param_traits.hpp"
 #include "triSYCL/info/event.hpp"
 #include "triSYCL/event/detail/event.hpp"
 #include "triSYCL/event/detail/host_event.hpp"
@@ -28,6 +37,14 @@ public:
 
   event() : implementation_t { detail::host_event::instance() } {}
 
+  /** Construct an event from its implementation
+
+      This is used by the runtime to return the event of a command
+      group.
+  */
+  event(std::shared_ptr<detail::event> e)
+    : implementation_t { std::move(e) } {}
+
 #ifdef TRISYCL_OPENCL
   /** Construct an event class using the clEvent from OpenCL.
 
@@ -74,8 +91,10 @@ public:
     implementation->wait();
   }
 
+  /// Wait for all the events of a list
   static void wait(const vector_class<event> &eventList) {
-    TRISYCL_UNIMPL;
+    for (auto &e : eventList)
+      e.implementation->wait();
   }
 
   void wait_and_throw() {
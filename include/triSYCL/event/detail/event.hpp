@@ -9,8 +9,12 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <memory>
+
 namespace trisycl::detail {
 
+struct task;
+
 struct event : detail::debug<detail::event> {
 
 public:
@@ -32,6 +36,9 @@ public:
 
   virtual void wait() const = 0;
 
+  /// Return the task behind a command group event, if any
+  virtual std::shared_ptr<detail::task> get_task() const { return {}; }
+
   virtual ~event() {}
 };
 
@@ -36,14 +36,18 @@ public:
     return 0;
   }
 
+  /** The default event is given to the command groups without
+      anything to execute, so they are already complete
+  */
   info::event_command_status get_command_execution_status() const override {
-    return info::event_command_status::submitted;
+    return info::event_command_status::complete;
   }
 
   cl_ulong get_profiling_info(info::event_profiling param) const override {
     return 0;
   }
 
+  /// Nothing to wait for
   void wait() const override {
   }
 };
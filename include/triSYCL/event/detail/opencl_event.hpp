@@ -18,9 +18,15 @@ class opencl_event : public detail::event {
   /** A cache to always return the same alive event for a given OpenCL
       event
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
   */
-  static detail::cache<cl_event, detail::opencl_event> cache;
+  static auto &cache() {
+    static auto c = new detail::cache<cl_event, detail::opencl_event>;
+    return *c;
+  }
 public:
   cl_event get() const override {
     return e.get();
@@ -53,8 +59,8 @@ public:
   /// Get a singleton instance of the \c opencl_event
   static std::shared_ptr<opencl_event>
   instance(const boost::compute::event &e) {
-    return cache.get_or_register(e.get(),
-                                 [&] { return new opencl_event { e }; });
+    return cache().get_or_register(e.get(),
+                                   [&] { return new opencl_event { e }; });
   }
 private:
   /// Only the instance factory can build it
@@ -63,7 +69,7 @@ private:
 
 public:
   ~opencl_event() override {
-    cache.remove(e.get());
+    cache().remove(e.get());
   }
 };
 
@@ -0,0 +1,197 @@
+#ifndef TRISYCL_SYCL_FUNCTIONAL_HPP
+#define TRISYCL_SYCL_FUNCTIONAL_HPP
+
+/** \file The SYCL function objects used by the reductions, with their
+    known identities
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace trisycl {
+
+/** \addtogroup parallelism Expressing parallelism through kernels
+    @{
+*/
+
+/// The arithmetic, bitwise and logical operations are the standard ones
+template <typename T = void>
+using plus = std::plus<T>;
+
+template <typename T = void>
+using multiplies = std::multiplies<T>;
+
+template <typename T = void>
+using bit_and = std::bit_and<T>;
+
+template <typename T = void>
+using bit_or = std::bit_or<T>;
+
+template <typename T = void>
+using bit_xor = std::bit_xor<T>;
+
+template <typename T = void>
+using logical_and = std::logical_and<T>;
+
+template <typename T = void>
+using logical_or = std::logical_or<T>;
+
+
+/// Compute the minimum of 2 values
+template <typename T = void>
+struct minimum {
+  T operator()(const T &x, const T &y) const {
+    return y < x ? y : x;
+  }
+};
+
+template <>
+struct minimum<void> {
+  template <typename T, typename U>
+  auto operator()(T &&x, U &&y) const {
+    return y < x ? y : x;
+  }
+};
+
+
+/// Compute the maximum of 2 values
+template <typename T = void>
+struct maximum {
+  T operator()(const T &x, const T &y) const {
+    return x < y ? y : x;
+  }
+};
+
+template <>
+struct maximum<void> {
+  template <typename T, typename U>
+  auto operator()(T &&x, U &&y) const {
+    return x < y ? y : x;
+  }
+};
+
+
+namespace detail {
+
+/// Test whether a function object is an instance of a given template
+template <template <typename> typename Op, typename BinaryOperation,
+          typename T>
+inline constexpr bool is_operation_v =
+  std::is_same_v<BinaryOperation, Op<T>>
+  || std::is_same_v<BinaryOperation, Op<void>>;
+
+}
+
+
+/** The identity of a binary operation on a type, if it is known
+
+    \c value is not defined when there is no known identity.
+*/
+template <typename BinaryOperation, typename AccumulatorT>
+struct known_identity {};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_arithmetic_v<AccumulatorT>
+            && detail::is_operation_v<plus, BinaryOperation, AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value {};
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_integral_v<AccumulatorT>
+            && (detail::is_operation_v<bit_or, BinaryOperation, AccumulatorT>
+                || detail::is_operation_v<bit_xor, BinaryOperation,
+                                          AccumulatorT>))
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value {};
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_arithmetic_v<AccumulatorT>
+            && detail::is_operation_v<multiplies, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value { 1 };
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_integral_v<AccumulatorT>
+            && detail::is_operation_v<bit_and, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value = static_cast<AccumulatorT>(~0ULL);
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_same_v<AccumulatorT, bool>
+            && detail::is_operation_v<logical_and, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value = true;
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_same_v<AccumulatorT, bool>
+            && detail::is_operation_v<logical_or, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value = false;
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_arithmetic_v<AccumulatorT>
+            && detail::is_operation_v<minimum, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value =
+    std::numeric_limits<AccumulatorT>::has_infinity
+    ? std::numeric_limits<AccumulatorT>::infinity()
+    : std::numeric_limits<AccumulatorT>::max();
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+  requires (std::is_arithmetic_v<AccumulatorT>
+            && detail::is_operation_v<maximum, BinaryOperation,
+                                      AccumulatorT>)
+struct known_identity<BinaryOperation, AccumulatorT> {
+  static constexpr AccumulatorT value =
+    std::numeric_limits<AccumulatorT>::has_infinity
+    ? -std::numeric_limits<AccumulatorT>::infinity()
+    : std::numeric_limits<AccumulatorT>::lowest();
+};
+
+template <typename BinaryOperation, typename AccumulatorT>
+inline constexpr AccumulatorT known_identity_v =
+  known_identity<BinaryOperation, AccumulatorT>::value;
+
+
+/// Test whether a binary operation on a type has a known identity
+template <typename BinaryOperation, typename AccumulatorT>
+struct has_known_identity
+  : std::bool_constant<requires {
+      known_identity<BinaryOperation, AccumulatorT>::value;
+    }> {};
+
+template <typename BinaryOperation, typename AccumulatorT>
+inline constexpr bool has_known_identity_v =
+  has_known_identity<BinaryOperation, AccumulatorT>::value;
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_FUNCTIONAL_HPP
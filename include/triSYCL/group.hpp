@@ -29,6 +29,11 @@ template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for_workitem_in_group(const group<Dimensions> &g,
                                     ParallelForFunctor f);
 
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for_workitem_in_group(const group<Dimensions> &g,
+                                    const range<Dimensions> &flexible_range,
+                                    ParallelForFunctor f);
+
 }
 
 /** \addtogroup parallelism Expressing parallelism through kernels
@@ -180,6 +185,19 @@ public:
     detail::parallel_for_workitem_in_group(*this, f);
   }
 
+
+  /** Loop on a flexible range of logical work-items inside a
+      work-group, such as the ragged part of the work of this group
+
+      The logical work-items are executed by the current thread with
+      the simd loop of its vector units, each one seeing the physical
+      work-item of its position modulo the local range.
+   */
+  void parallel_for_work_item(range<Dimensions> flexible_range,
+                              std::function<void(h_item<rank()>)> f) const {
+    detail::parallel_for_workitem_in_group(*this, flexible_range, f);
+  }
+
   /* Comparison operators for group object.
    */
   bool operator==(const group &groupB) const {
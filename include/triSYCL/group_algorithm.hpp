@@ -0,0 +1,424 @@
+#ifndef TRISYCL_SYCL_GROUP_ALGORITHM_HPP
+#define TRISYCL_SYCL_GROUP_ALGORITHM_HPP
+
+/** \file The SYCL 2020 group algorithms
+
+    In an nd_range kernel, the collectives are called by all the
+    work-items of a work-group with their nd_item, or with their
+    sub_group, in the same order:
+    \code
+    cgh.parallel_for(nd_range<1> { N, L }, [=](nd_item<1> i) {
+      auto sum = reduce_over_group(i, a[i.get_global_id()], plus<>());
+      b[i.get_global_id()] = exclusive_scan_over_group(i, 1, plus<>());
+    });
+    \endcode
+
+    Each collective costs a single barrier. Since the barrier is for
+    the whole work-group, all the sub-groups of a work-group have to
+    call the same sub-group collectives. When the work-items are
+    executed as fibers on the same thread (with \c
+    TRISYCL_WORK_ITEM_FIBERS) the result is computed once for the
+    whole work-group by the first work-item resumed after the barrier.
+
+    In a hierarchical kernel, the work-group scope is executed by a
+    single thread, so the joint algorithms on a range of memory are
+    done directly, without any barrier.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/detail/linear_id.hpp"
+#include "triSYCL/exception.hpp"
+#include "triSYCL/functional.hpp"
+#include "triSYCL/group.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/nd_item.hpp"
+#include "triSYCL/parallelism/detail/work_group_scratch.hpp"
+#include "triSYCL/sub_group.hpp"
+
+namespace trisycl {
+
+/** \addtogroup parallelism Expressing parallelism through kernels
+    @{
+*/
+
+namespace detail {
+
+/// Test whether a type can be used as a group by the collectives
+template <typename T>
+inline constexpr bool is_group_v = false;
+
+template <int Dimensions>
+inline constexpr bool is_group_v<nd_item<Dimensions>> = true;
+
+template <>
+inline constexpr bool is_group_v<sub_group> = true;
+
+
+/** The slots of the work-items of a group in the scratch memory of
+    their work-group, which is split into groups of the same size
+*/
+struct group_slots {
+  /// The number of work-items in the work-group
+  std::size_t work_group_size;
+
+  /// The maximum number of work-items in a group
+  std::size_t group_size;
+
+  /// The slot of the work-item, its local linear id in the work-group
+  std::size_t local;
+
+
+  /// The number of work-items of the group starting at the slot \p first
+  std::size_t size_from(std::size_t first) const {
+    return std::min(group_size, work_group_size - first);
+  }
+
+
+  /// The first slot of the group of the work-item
+  std::size_t first() const { return local/group_size*group_size; }
+
+
+  /// The index of the work-item in its group
+  std::size_t lane() const { return local - first(); }
+
+
+  /// Execute f(first) on the first slot of each group of the work-group
+  template <typename F>
+  void for_each_group(F &&f) const {
+    for (std::size_t first = 0; first < work_group_size; first += group_size)
+      f(first);
+  }
+};
+
+
+template <int Dimensions>
+group_slots slots_of(const nd_item<Dimensions> &it) {
+  auto n = it.get_local_range().size();
+  return { n, n, it.get_local_linear_id() };
+}
+
+
+inline group_slots slots_of(const sub_group &sg) {
+  return { sg.get_work_group_size(), sub_group::max_size,
+           sg.get_work_group_local_linear_id() };
+}
+
+
+/// Share the value of a work-item with the other ones of its work-group
+template <typename Group, typename T>
+auto share_with_group(const Group &g, const T &x) {
+  auto scratch = work_group_scratch::current();
+  if (!scratch)
+    throw ::trisycl::feature_not_supported {
+      "The group collectives need a barrier between the work-items"
+    };
+  return scratch->share(slots_of(g).local, x, [&] {
+    g.barrier(access::fence_space::local_space);
+  });
+}
+
+
+/** Scan the values of the work-items of a group
+
+    \param[in] init starts the scan, if any
+*/
+template <bool Inclusive, typename V, typename Group, typename T,
+          typename BinaryOperation>
+V scan_over_group(const Group &g, const T &x, const V *init,
+                  BinaryOperation op) {
+  auto s = slots_of(g);
+  auto values = share_with_group(g, x);
+  // Accumulate the contribution of the slot i of a group starting at first
+  auto accumulate = [&] (std::size_t first, std::size_t i,
+                         const V &prefix) -> V {
+    T v = values.template get<T>(i);
+    if (Inclusive && i == first && !init)
+      return v;
+    return op(prefix, v);
+  };
+  if constexpr (work_group_scratch::same_thread) {
+    if (values.first)
+      s.for_each_group([&] (std::size_t first) {
+        // Replace in order the contributions by the prefixes
+        V prefix = init ? *init : V {};
+        for (std::size_t i = first, end = first + s.size_from(first);
+             i != end; ++i) {
+          auto next = accumulate(first, i, prefix);
+          values.set(i, Inclusive ? next : prefix);
+          prefix = next;
+        }
+      });
+    return values.template get<V>(s.local);
+  } else {
+    auto first = s.first();
+    V prefix = init ? *init : V {};
+    for (std::size_t i = first, end = s.local + Inclusive; i != end; ++i)
+      prefix = accumulate(first, i, prefix);
+    return prefix;
+  }
+}
+
+}
+
+
+/** Wait for all the work-items of a group
+
+    For a sub-group, all the sub-groups of the work-group have to
+    reach it.
+*/
+template <typename Group>
+  requires detail::is_group_v<Group>
+void group_barrier(const Group &g) {
+  g.barrier();
+}
+
+
+/** Get the value of a work-item for all the work-items of its group
+
+    \param[in] local_linear_id is the local linear id in the group of
+    the work-item providing the value
+*/
+template <typename Group, typename T>
+  requires detail::is_group_v<Group>
+T group_broadcast(const Group &g, const T &x,
+                  std::size_t local_linear_id = 0) {
+  return detail::share_with_group(g, x)
+    .template get<T>(detail::slots_of(g).first() + local_linear_id);
+}
+
+
+/// Get the value of the work-item at a local id for all its work-group
+template <int Dimensions, typename T>
+T group_broadcast(const nd_item<Dimensions> &it, const T &x,
+                  const id<Dimensions> &local_id) {
+  return group_broadcast(it, x, detail::linear_id(it.get_local_range(),
+                                                  local_id));
+}
+
+
+/// Combine the values of all the work-items of a group
+template <typename Group, typename T, typename BinaryOperation>
+  requires detail::is_group_v<Group>
+T reduce_over_group(const Group &g, const T &x, BinaryOperation op) {
+  auto s = detail::slots_of(g);
+  auto values = detail::share_with_group(g, x);
+  // Combine the values of the group starting at the slot first
+  auto fold = [&] (std::size_t first) {
+    T result = values.template get<T>(first);
+    for (std::size_t i = first + 1, end = first + s.size_from(first);
+         i != end; ++i)
+      result = op(result, values.template get<T>(i));
+    return result;
+  };
+  if constexpr (detail::work_group_scratch::same_thread) {
+    if (values.first)
+      s.for_each_group([&] (std::size_t first) {
+        values.set(first, fold(first));
+      });
+    return values.template get<T>(s.first());
+  } else
+    return fold(s.first());
+}
+
+
+/// Combine an initial value with the values of all the work-items
+template <typename Group, typename V, typename T, typename BinaryOperation>
+  requires detail::is_group_v<Group>
+T reduce_over_group(const Group &g, const V &x, const T &init,
+                    BinaryOperation op) {
+  return op(init, reduce_over_group(g, x, op));
+}
+
+
+/// Combine the values of the work-items up to the current one, excluded
+template <typename Group, typename T, typename BinaryOperation>
+  requires detail::is_group_v<Group>
+           && has_known_identity_v<BinaryOperation, T>
+T exclusive_scan_over_group(const Group &g, const T &x,
+                            BinaryOperation op) {
+  const T identity = known_identity_v<BinaryOperation, T>;
+  return detail::scan_over_group<false>(g, x, &identity, op);
+}
+
+
+/// Combine an initial value with the values of the previous work-items
+template <typename Group, typename V, typename T, typename BinaryOperation>
+  requires detail::is_group_v<Group>
+T exclusive_scan_over_group(const Group &g, const V &x, const T &init,
+                            BinaryOperation op) {
+  return detail::scan_over_group<false>(g, x, &init, op);
+}
+
+
+/// Combine the values of the work-items up to the current one, included
+template <typename Group, typename T, typename BinaryOperation>
+  requires detail::is_group_v<Group>
+T inclusive_scan_over_group(const Group &g, const T &x,
+                            BinaryOperation op) {
+  return detail::scan_over_group<true>(g, x, static_cast<const T *>(nullptr),
+                                       op);
+}
+
+
+/// Combine an initial value with the values up to the current work-item
+template <typename Group, typename V, typename BinaryOperation, typename T>
+  requires detail::is_group_v<Group>
+T inclusive_scan_over_group(const Group &g, const V &x, BinaryOperation op,
+                            const T &init) {
+  return detail::scan_over_group<true>(g, x, &init, op);
+}
+
+
+/// Test whether a predicate is true for any work-item of a group
+template <typename Group>
+  requires detail::is_group_v<Group>
+bool any_of_group(const Group &g, bool pred) {
+  return reduce_over_group(g, pred, logical_or<bool> {});
+}
+
+
+/// Test whether a predicate is true for all the work-items of a group
+template <typename Group>
+  requires detail::is_group_v<Group>
+bool all_of_group(const Group &g, bool pred) {
+  return reduce_over_group(g, pred, logical_and<bool> {});
+}
+
+
+/// Test whether a predicate is false for all the work-items of a group
+template <typename Group>
+  requires detail::is_group_v<Group>
+bool none_of_group(const Group &g, bool pred) {
+  return !any_of_group(g, pred);
+}
+
+
+/// Get the value of another work-item of the sub-group
+template <typename T>
+T select_from_group(const sub_group &sg, const T &x,
+                    sub_group::id_type remote_local_id) {
+  return detail::share_with_group(sg, x)
+    .template get<T>(detail::slots_of(sg).first() + remote_local_id[0]);
+}
+
+
+/** Get the value of the work-item \p delta lanes after in the
+    sub-group, or its own value if there is none
+*/
+template <typename T>
+T shift_group_left(const sub_group &sg, const T &x,
+                   sub_group::linear_id_type delta = 1) {
+  auto values = detail::share_with_group(sg, x);
+  auto lane = sg.get_local_linear_id();
+  return lane + delta < sg.get_local_linear_range()
+    ? values.template get<T>(detail::slots_of(sg).local + delta) : x;
+}
+
+
+/** Get the value of the work-item \p delta lanes before in the
+    sub-group, or its own value if there is none
+*/
+template <typename T>
+T shift_group_right(const sub_group &sg, const T &x,
+                    sub_group::linear_id_type delta = 1) {
+  auto values = detail::share_with_group(sg, x);
+  return sg.get_local_linear_id() >= delta
+    ? values.template get<T>(detail::slots_of(sg).local - delta) : x;
+}
+
+
+/** Get the value of the work-item whose lane is the one of the
+    current work-item xor \p mask, or its own value if there is none
+*/
+template <typename T>
+T permute_group_by_xor(const sub_group &sg, const T &x,
+                       sub_group::linear_id_type mask) {
+  auto values = detail::share_with_group(sg, x);
+  auto other = sg.get_local_linear_id() ^ mask;
+  return other < sg.get_local_linear_range()
+    ? values.template get<T>(detail::slots_of(sg).first() + other) : x;
+}
+
+
+/** Combine the elements of a non-empty range of memory from the
+    work-group scope of a hierarchical kernel
+*/
+template <int Dimensions, typename Ptr, typename BinaryOperation>
+auto joint_reduce(const group<Dimensions> &, Ptr first, Ptr last,
+                  BinaryOperation op) {
+  std::iter_value_t<Ptr> init = *first;
+  return std::accumulate(std::next(first), last, init, op);
+}
+
+
+/// Combine an initial value with the elements of a range of memory
+template <int Dimensions, typename Ptr, typename T, typename BinaryOperation>
+T joint_reduce(const group<Dimensions> &, Ptr first, Ptr last, const T &init,
+               BinaryOperation op) {
+  return std::accumulate(first, last, init, op);
+}
+
+
+/// Write the exclusive prefixes of a range of memory from an initial value
+template <int Dimensions, typename InPtr, typename OutPtr, typename T,
+          typename BinaryOperation>
+OutPtr joint_exclusive_scan(const group<Dimensions> &, InPtr first,
+                            InPtr last, OutPtr result, const T &init,
+                            BinaryOperation op) {
+  return std::exclusive_scan(first, last, result, init, op);
+}
+
+
+/// Write the exclusive prefixes of a range of memory
+template <int Dimensions, typename InPtr, typename OutPtr,
+          typename BinaryOperation>
+  requires has_known_identity_v<BinaryOperation, std::iter_value_t<InPtr>>
+OutPtr joint_exclusive_scan(const group<Dimensions> &g, InPtr first,
+                            InPtr last, OutPtr result, BinaryOperation op) {
+  return joint_exclusive_scan(
+    g, first, last, result,
+    known_identity_v<BinaryOperation, std::iter_value_t<InPtr>>, op);
+}
+
+
+/// Write the inclusive prefixes of a range of memory
+template <int Dimensions, typename InPtr, typename OutPtr,
+          typename BinaryOperation>
+OutPtr joint_inclusive_scan(const group<Dimensions> &, InPtr first,
+                            InPtr last, OutPtr result, BinaryOperation op) {
+  return std::inclusive_scan(first, last, result, op);
+}
+
+
+/// Write the inclusive prefixes of a range of memory from an initial value
+template <int Dimensions, typename InPtr, typename OutPtr,
+          typename BinaryOperation, typename T>
+OutPtr joint_inclusive_scan(const group<Dimensions> &, InPtr first,
+                            InPtr last, OutPtr result, BinaryOperation op,
+                            const T &init) {
+  return std::inclusive_scan(first, last, result, op, init);
+}
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_GROUP_ALGORITHM_HPP
@@ -19,6 +19,10 @@
 #include "triSYCL/nd_range.hpp"
 #include "triSYCL/range.hpp"
 
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+#include "triSYCL/parallelism/detail/work_item_fibers.hpp"
+#endif
+
 namespace trisycl {
 
 /** \addtogroup parallelism Expressing parallelism through kernels
@@ -51,6 +55,12 @@ private:
   id<Dimensions> local_index;
   nd_range<Dimensions> ND_range;
 
+  /* The position in the flexible range given to parallel_for_work_item,
+     the local range of the work-group otherwise */
+  id<Dimensions> logical_local_index;
+
+  range<Dimensions> logical_local_range;
+
 public:
 
   /** Create an empty nd_item<> from an nd_range<>
@@ -59,7 +69,9 @@ public:
       call set_global() and set_local() later. This should be hidden to
       the user.
   */
-  h_item(nd_range<Dimensions> ndr) : ND_range { ndr } {}
+  h_item(nd_range<Dimensions> ndr)
+    : ND_range { ndr }
+    , logical_local_range { ndr.get_local_range() } {}
 
 
   /** Create a full nd_item
@@ -73,7 +85,9 @@ public:
     // Compute the local index using the offset and the group size
     local_index
       { (global_index - ndr.get_offset())%id<Dimensions> { ndr.get_local() } },
-    ND_range { ndr }
+    ND_range { ndr },
+    logical_local_index { local_index },
+    logical_local_range { ndr.get_local_range() }
   {}
 
 
@@ -208,7 +222,10 @@ public:
   */
   void barrier(access::fence_space flag =
                access::fence_space::global_and_local) const {
-#if defined(_OPENMP) && !defined(TRISYCL_NO_BARRIER)
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+    // Switch to the other work-items of the work-group
+    detail::work_item_fibers::barrier();
+#elif defined(_OPENMP) && !defined(TRISYCL_NO_BARRIER)
     /* Use OpenMP barrier in the implementation with 1 OpenMP thread per
        work-item of the work-group */
 #pragma omp barrier
@@ -219,8 +236,57 @@ public:
   }
 
 
+  /** Return the position of the work-item in the flexible range given
+      to parallel_for_work_item, or its local id without one
+  */
+  id<Dimensions> get_logical_local_id() const { return logical_local_index; }
+
+
+  /// Return the logical local id in the given dimension
+  size_t get_logical_local_id(int dimension) const {
+    return get_logical_local_id()[dimension];
+  }
+
+
+  /** Return the flexible range given to parallel_for_work_item, or the
+      local range of the work-group without one
+  */
+  range<Dimensions> get_logical_local_range() const {
+    return logical_local_range;
+  }
+
+
+  /** Return the local id of the physical work-item executing this
+      logical work-item
+  */
+  id<Dimensions> get_physical_local_id() const { return get_local_id(); }
+
+
+  /// Return the physical local id in the given dimension
+  size_t get_physical_local_id(int dimension) const {
+    return get_local_id(dimension);
+  }
+
+
+  /// Return the local range of the work-group, executing the logical range
+  range<Dimensions> get_physical_local_range() const {
+    return get_local_range();
+  }
+
+
   // For the triSYCL implementation, need to set the local index
-  void set_local(id<Dimensions> Index) { local_index = Index; }
+  void set_local(id<Dimensions> Index) {
+    local_index = Index;
+    logical_local_index = Index;
+  }
+
+
+  /* For the triSYCL implementation, need to set the logical local
+     index in a flexible range, after the physical one */
+  void set_logical_local(id<Dimensions> Index, range<Dimensions> Range) {
+    logical_local_index = Index;
+    logical_local_range = Range;
+  }
 
 
   // For the triSYCL implementation, need to set the global index
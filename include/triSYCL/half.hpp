@@ -1,21 +1,286 @@
 #ifndef TRISYCL_SYCL_HALF_HPP
 #define TRISYCL_SYCL_HALF_HPP
 
-/** \file SYCL Half support - dummy
+/** \file The SYCL half-precision floating-point type
+
+    A half is stored as the 16 bits of an IEEE 754 binary16 number and
+    computes in float, rounding the result back to the nearest even
+    half. The conversions use the _Float16 type of the compiler when
+    available, the F16C instructions on x86 or the __fp16 type on Arm,
+    and a software version otherwise.
+
     This file is distributed under the University of Illinois Open Source
     License. See LICENSE.TXT for details.
- */
+*/
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if !defined(__FLT16_MAX__) && defined(__F16C__)
+#include <immintrin.h>
+#endif
 
-/* Dummy half implementation - this is enough to get the CTS to build. */
 namespace trisycl {
 
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+namespace detail {
+
+/// Round a float to the nearest even binary16 number, in software
+inline std::uint16_t float_to_half_bits(float f) {
+  auto x = std::bit_cast<std::uint32_t>(f);
+  std::uint16_t sign = (x >> 16) & 0x8000;
+  auto a = x & 0x7fffffff;
+  // Infinity, NaN and numbers too large for a half
+  if (a >= 0x47800000)
+    return sign | (a > 0x7f800000 ? 0x7e00 | ((a >> 13) & 0x3ff) : 0x7c00);
+  // The subnormal halves: the float addition rounds to 2^-24 steps
+  if (a < 0x38800000)
+    return sign | (std::bit_cast<std::uint32_t>(std::bit_cast<float>(a)
+                                                 + 0.5f) - 0x3f000000);
+  // Rebias the exponent and round the mantissa to the nearest even
+  a += 0xc8000fff + ((a >> 13) & 1);
+  return sign | (a >> 13);
+}
+
+
+/// Widen a binary16 number to a float, in software
+inline float half_bits_to_float(std::uint16_t h) {
+  std::uint32_t sign = (h & 0x8000) << 16;
+  std::uint32_t a = h & 0x7fff;
+  // Infinity and NaN
+  if (a >= 0x7c00)
+    return std::bit_cast<float>(sign | 0x7f800000 | ((a & 0x3ff) << 13));
+  // Zero and the subnormal halves, exact in float
+  if (a < 0x400) {
+    auto f = a*0x1p-24f;
+    return sign ? -f : f;
+  }
+  return std::bit_cast<float>(sign | ((a << 13) + 0x38000000));
+}
+
+}
+
+/// The SYCL half-precision floating-point type
 class half {
+
+  std::uint16_t bits;
+
+
+  /// Convert a float with the fastest way available
+  static std::uint16_t from_float(float f) {
+#if defined(__FLT16_MAX__)
+    return std::bit_cast<std::uint16_t>(static_cast<_Float16>(f));
+#elif defined(__F16C__)
+    return _cvtss_sh(f, _MM_FROUND_TO_NEAREST_INT);
+#elif defined(__ARM_FP16_FORMAT_IEEE)
+    return std::bit_cast<std::uint16_t>(static_cast<__fp16>(f));
+#else
+    return detail::float_to_half_bits(f);
+#endif
+  }
+
+
+  /// Convert to a float with the fastest way available
+  static float to_float(std::uint16_t h) {
+#if defined(__FLT16_MAX__)
+    return std::bit_cast<_Float16>(h);
+#elif defined(__F16C__)
+    return _cvtsh_ss(h);
+#elif defined(__ARM_FP16_FORMAT_IEEE)
+    return std::bit_cast<__fp16>(h);
+#else
+    return detail::half_bits_to_float(h);
+#endif
+  }
+
+
+  /** The type of a mixed operation: the floating-point type of the
+      other operand, or half with an integer
+  */
+  template <typename T>
+  using mixed = std::conditional_t<std::is_floating_point_v<T>, T, half>;
+
 public:
-  half(int) {};
 
-  bool operator>(const half &h1) { return false; };
+  /// An uninitialized half, as a float would be
+  half() = default;
+
+  half(float f) : bits { from_float(f) } {}
+
+  /// Construct from any other arithmetic type, through a float
+  template <typename T>
+    requires std::is_arithmetic_v<T>
+  half(T v) : half { static_cast<float>(v) } {}
+
+
+  /// Get a half from its binary16 representation
+  static half from_bits(std::uint16_t b) {
+    half h;
+    h.bits = b;
+    return h;
+  }
+
+
+  /// Get the binary16 representation
+  std::uint16_t get_bits() const {
+    return bits;
+  }
+
+
+  operator float() const {
+    return to_float(bits);
+  }
+
+
+  half operator+() const {
+    return *this;
+  }
+
+
+  half operator-() const {
+    return from_bits(bits ^ 0x8000);
+  }
+
+
+#define TRISYCL_HALF_OPERATOR(op)                                       \
+  half &operator op##=(half rhs) {                                      \
+    return *this = float(*this) op float(rhs);                          \
+  }                                                                     \
+                                                                        \
+  friend half operator op(half lhs, half rhs) {                         \
+    return float(lhs) op float(rhs);                                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend mixed<T> operator op(half lhs, T rhs) {                        \
+    return static_cast<mixed<T>>(float(lhs) op rhs);                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend mixed<T> operator op(T lhs, half rhs) {                        \
+    return static_cast<mixed<T>>(lhs op float(rhs));                    \
+  }
+
+  TRISYCL_HALF_OPERATOR(+)
+  TRISYCL_HALF_OPERATOR(-)
+  TRISYCL_HALF_OPERATOR(*)
+  TRISYCL_HALF_OPERATOR(/)
+
+#undef TRISYCL_HALF_OPERATOR
+
+
+#define TRISYCL_HALF_COMPARISON(op)                                     \
+  friend bool operator op(half lhs, half rhs) {                         \
+    return float(lhs) op float(rhs);                                    \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend bool operator op(half lhs, T rhs) {                            \
+    return float(lhs) op rhs;                                           \
+  }                                                                     \
+                                                                        \
+  template <typename T>                                                 \
+    requires std::is_arithmetic_v<T>                                     \
+  friend bool operator op(T lhs, half rhs) {                            \
+    return lhs op float(rhs);                                           \
+  }
+
+  TRISYCL_HALF_COMPARISON(==)
+  TRISYCL_HALF_COMPARISON(!=)
+  TRISYCL_HALF_COMPARISON(<)
+  TRISYCL_HALF_COMPARISON(>)
+  TRISYCL_HALF_COMPARISON(<=)
+  TRISYCL_HALF_COMPARISON(>=)
+
+#undef TRISYCL_HALF_COMPARISON
+
+
+  half &operator++() {
+    return *this += 1.0f;
+  }
+
+
+  half operator++(int) {
+    auto old = *this;
+    ++*this;
+    return old;
+  }
+
+
+  half &operator--() {
+    return *this -= 1.0f;
+  }
+
+
+  half operator--(int) {
+    auto old = *this;
+    --*this;
+    return old;
+  }
+
 };
 
+static_assert(sizeof(half) == 2, "A half has the size of a binary16");
+
+/// @} End the data Doxygen group
+
 }
 
-#endif
+
+namespace std {
+
+/// The characteristics of the binary16 format
+template <>
+class numeric_limits<trisycl::half> {
+  using half = trisycl::half;
+
+public:
+
+  static constexpr bool is_specialized = true;
+  static constexpr bool is_signed = true;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_exact = false;
+  static constexpr bool has_infinity = true;
+  static constexpr bool has_quiet_NaN = true;
+  static constexpr bool has_signaling_NaN = true;
+  static constexpr bool is_iec559 = true;
+  static constexpr bool is_bounded = true;
+  static constexpr int digits = 11;
+  static constexpr int digits10 = 3;
+  static constexpr int max_digits10 = 5;
+  static constexpr int radix = 2;
+  static constexpr int min_exponent = -13;
+  static constexpr int min_exponent10 = -4;
+  static constexpr int max_exponent = 16;
+  static constexpr int max_exponent10 = 4;
+
+  static half min() { return half::from_bits(0x0400); }
+  static half lowest() { return half::from_bits(0xfbff); }
+  static half max() { return half::from_bits(0x7bff); }
+  static half epsilon() { return half::from_bits(0x1400); }
+  static half round_error() { return half::from_bits(0x3800); }
+  static half infinity() { return half::from_bits(0x7c00); }
+  static half quiet_NaN() { return half::from_bits(0x7e00); }
+  static half signaling_NaN() { return half::from_bits(0x7d00); }
+  static half denorm_min() { return half::from_bits(0x0001); }
+};
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_HALF_HPP
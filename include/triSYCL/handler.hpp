@@ -9,10 +9,15 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #ifdef TRISYCL_OPENCL
@@ -21,13 +26,25 @@
 
 #include "triSYCL/accessor.hpp"
 #include "triSYCL/command_group/detail/task.hpp"
+#include "triSYCL/command_group/detail/task_event.hpp"
 #include "triSYCL/detail/instantiate_kernel.hpp"
+#include "triSYCL/detail/memory_operations.hpp"
+#include "triSYCL/detail/pool_allocator.hpp"
 #include "triSYCL/detail/unimplemented.hpp"
+#include "triSYCL/event.hpp"
 #include "triSYCL/exception.hpp"
 #include "triSYCL/kernel.hpp"
+#include "triSYCL/kernel/detail/partitioning_tuner.hpp"
+#include "triSYCL/kernel_handler.hpp"
 #include "triSYCL/opencl_types.hpp"
 #include "triSYCL/parallelism.hpp"
+#include "triSYCL/parallelism/detail/local_memory_arena.hpp"
 #include "triSYCL/queue/detail/queue.hpp"
+#include "triSYCL/reduction/detail/reduction.hpp"
+#include "triSYCL/specialization_id.hpp"
+#include "triSYCL/vendor/triSYCL/backend.hpp"
+#include "triSYCL/vendor/triSYCL/index32.hpp"
+#include "triSYCL/vendor/triSYCL/kernel_statistics.hpp"
 
 namespace trisycl {
 
@@ -62,8 +79,10 @@ public:
      \todo Make this constructor private
   */
   handler(const std::shared_ptr<detail::queue> &q) {
-    // Create a new task for this command_group
-    task = std::make_shared<detail::task>(q);
+    /* Create a new task for this command_group, recycling the memory
+       of the previous tasks */
+    task = std::allocate_shared<detail::task>(
+      detail::pool_allocator<detail::task> {}, q);
   }
 
 
@@ -160,18 +179,72 @@ public:
 
 private:
 
+  /// The specialization constants set in this command group, if any
+  std::shared_ptr<detail::specialization_constants> specialization_values;
+
+
+  /** Give the values of the specialization constants to a kernel
+      taking a kernel_handler as its last parameter
+
+      A kernel tagged with a back-end keeps its tag.
+  */
+  template <typename Kernel>
+  auto with_kernel_handler(Kernel k) const {
+    if constexpr (vendor::trisycl::is_backend_kernel_v<Kernel>)
+      return vendor::trisycl::use_backend<typename Kernel::backend>(
+        with_kernel_handler(std::move(k.kernel)));
+    else
+      return detail::bind_kernel_handler(std::move(k),
+                                         kernel_handler {
+                                           specialization_values });
+  }
+
+
+  /** Estimate the duration of the kernel of the task from the
+      previous launches of the kernel named \p KernelName, to rank the
+      task in the critical path of the task graph
+  */
+  template <typename KernelName>
+  void estimate_cost() {
+    task->cost_estimate = std::max<std::uint64_t>(
+      1, vendor::trisycl::kernel_statistics::instance()
+      .expected_duration<KernelName>());
+  }
+
+
   /** Schedule the kernel
 
       Add a traced version of the kernel in host mode or add the
       kernel in an instantiating function for later extraction by the
       compiler
+
+      \param work_items is the number of work-items executed by the
+      kernel, for the kernel statistics
+
+      \param coalescable is true for a single_task, which may run in
+      a batch of single_task kernels if the queue coalesces them
   */
   template <typename KernelName,
             typename Kernel>
-  void schedule_kernel(Kernel k) {
+  void schedule_kernel(Kernel k, std::uint64_t work_items = 1,
+                       bool coalescable = false) {
+    /* The kernels without a name are accounted by their functor type
+       in the kernel statistics */
+    using statistics_name =
+      std::conditional_t<std::is_same_v<KernelName, std::nullptr_t>,
+                         Kernel, KernelName>;
+    if (task->is_memoized<statistics_name>(work_items)) {
+      // The outputs are still those of the previous execution
+      task->schedule([] {});
+      return;
+    }
     /* Explicitly capture task by copy instead of having this captured
-       by reference and task by reference by side effect */
-    task->schedule(detail::trace_kernel<KernelName>([=, t = task] () mutable {
+       by reference and task by reference by side effect, and move
+       the kernel without copying its accessors */
+    detail::unique_function<void(void)> f = detail::trace_kernel<KernelName>(
+      vendor::trisycl::kernel_statistics::measure<statistics_name>(
+        work_items, task->accessed_bytes,
+        [k = std::move(k), t = task] () mutable {
           if (t->owner_queue->is_host())
             k();
           else {
@@ -183,6 +256,11 @@ private:
             t->get_kernel().single_task(t, t->get_queue());
           }
         }));
+    estimate_cost<statistics_name>();
+    if (coalescable && task->can_coalesce())
+      task->schedule_coalescable(std::move(f));
+    else
+      task->schedule(std::move(f));
   }
 
   /** Schedule a parallel for kernel
@@ -197,7 +275,18 @@ private:
             typename Kernel,
             int N>
   void schedule_parallel_for_kernel(Kernel k, const range<N> &num_work_items) {
-    task->schedule(detail::trace_kernel<KernelName>([=, t = task] () mutable {
+    using statistics_name =
+      std::conditional_t<std::is_same_v<KernelName, std::nullptr_t>,
+                         Kernel, KernelName>;
+    if (task->is_memoized<statistics_name>(num_work_items.size())) {
+      task->schedule([] {});
+      return;
+    }
+    estimate_cost<statistics_name>();
+    task->schedule(detail::trace_kernel<KernelName>(
+      vendor::trisycl::kernel_statistics::measure<statistics_name>(
+        num_work_items.size(), task->accessed_bytes,
+        [=, k = std::move(k), t = task] () mutable {
           // if (t->owner_queue->is_host())
              // k();
           // else {
@@ -208,11 +297,58 @@ private:
 
             t->get_kernel().parallel_for(t, t->get_queue(), num_work_items);
       // }
-    }));
+    })));
+  }
+
+
+  /** Make the kernel launching the loop nests of a parallel_for on
+      the range \p r use the partitioning tuned for them
+
+      The command groups choosing their own partitioning are not
+      tuned, nor any kernel when the autotuning is not enabled.
+  */
+  template <typename KernelName, typename Kernel, int N, typename Launch>
+  auto tune_partitioning(const range<N> &r, Launch launch) {
+    using tuning_name =
+      std::conditional_t<std::is_same_v<KernelName, std::nullptr_t>,
+                         Kernel, KernelName>;
+    return [r, launch = std::move(launch), t = task] () mutable {
+      if (detail::partitioning_tuner::is_enabled() && !t->partition)
+        detail::partitioning_tuner::instance().run(
+          vendor::trisycl::kernel_statistics::name<tuning_name>(), r,
+          launch);
+      else
+        launch();
+    };
   }
 
 public:
 
+  /** Set the value of a specialization constant for the kernel of this
+      command group
+
+      On the host device, a kernel can select with
+      vendor::trisycl::specialize() some code compiled for the value.
+  */
+  template <auto &SpecName>
+  void set_specialization_constant(
+    typename std::remove_reference_t<decltype(SpecName)>::value_type value) {
+    if (!specialization_values)
+      specialization_values =
+        std::make_shared<detail::specialization_constants>();
+    specialization_values->set(SpecName, value);
+  }
+
+
+  /// Get the value of a specialization constant set in this command group
+  template <auto &SpecName>
+  typename std::remove_reference_t<decltype(SpecName)>::value_type
+  get_specialization_constant() const {
+    return kernel_handler { specialization_values }
+      .template get_specialization_constant<SpecName>();
+  }
+
+
   /** Kernel invocation method of a kernel defined as a lambda or
       functor. If it is a lambda function or the functor type is globally
       visible there is no need for the developer to provide a kernel name type
@@ -231,7 +367,8 @@ public:
   void single_task(ParallelForFunctor &&f) {
     TRISYCL_DUMP_T("single_task &f = " << (void *) &f);
 
-    schedule_kernel<KernelName>(std::forward<ParallelForFunctor>(f));
+    schedule_kernel<KernelName>(
+      with_kernel_handler(std::forward<ParallelForFunctor>(f)), 1, true);
   }
 
 
@@ -260,16 +397,57 @@ public:
   template <typename KernelName = std::nullptr_t, int Dims,
             typename ParallelForFunctor>
   // Do not land here if we are using the sycl::kernel API
-  requires (!std::derived_from<ParallelForFunctor, kernel>)
-  void parallel_for(const range<Dims>& global_size, ParallelForFunctor f) {
-    if constexpr (detail::use_native_work_item) {
-      // Use a normal parallel for
-      schedule_parallel_for_kernel<KernelName>(
-          [=] { detail::parallel_for(global_size, f); }, global_size);
-    } else
-      // Launch a single-task kernel containing the loop nests
-      schedule_kernel<KernelName>(
-          [=] { detail::parallel_for(global_size, f); });
+  requires (!std::derived_from<std::remove_cvref_t<ParallelForFunctor>,
+                               kernel>)
+  void parallel_for(const range<Dims>& global_size, ParallelForFunctor &&f) {
+    using functor = std::remove_cvref_t<ParallelForFunctor>;
+    if constexpr (requires {
+        detail::kernel_handler_index(&functor::operator()); }) {
+      // Launch the kernel seen as taking only an index
+      parallel_for<KernelName>(global_size,
+        with_kernel_handler(std::forward<ParallelForFunctor>(f)));
+    } else {
+      // Check the promise of the kernel before relying on it
+      if constexpr (vendor::trisycl::is_index32_kernel_v<functor>)
+        vendor::trisycl::check_index32(global_size);
+      if constexpr (Dims == 1 && !detail::use_native_work_item
+                    && !vendor::trisycl::is_backend_kernel_v<functor>) {
+        if (task->can_fuse()) {
+          // Fuse the element-wise kernel with the previous ones if possible
+          task->schedule_fusable(global_size,
+                                 detail::fused_kernels::make_stage(
+                                   global_size,
+                                   std::forward<ParallelForFunctor>(f)));
+          return;
+        }
+      }
+      /* The kernel is moved into the scheduled functor, which is the
+         only copy done at submission when f is an rvalue */
+      if constexpr (detail::use_native_work_item) {
+        // Use a normal parallel for
+        schedule_parallel_for_kernel<KernelName>(
+          [global_size, f = std::forward<ParallelForFunctor>(f)] () mutable {
+            detail::parallel_for(global_size, f);
+          }, global_size);
+      } else if constexpr (vendor::trisycl::is_backend_kernel_v<functor>)
+        // Launch the loop nests with the back-end the kernel is tagged with
+        schedule_kernel<KernelName>(
+          tune_partitioning<KernelName, functor>(global_size,
+            [global_size,
+             f = with_kernel_handler(std::forward<ParallelForFunctor>(f))]
+            () mutable {
+              detail::backend_parallelism<typename functor::backend>
+                ::parallel_for(global_size, f.kernel);
+            }), global_size.size());
+      else
+        // Launch a single-task kernel containing the loop nests
+        schedule_kernel<KernelName>(
+          tune_partitioning<KernelName, functor>(global_size,
+            [global_size, f = std::forward<ParallelForFunctor>(f)]
+            () mutable {
+              detail::backend_parallelism<>::parallel_for(global_size, f);
+            }), global_size.size());
+    }
   }
 
   /** SYCL parallel_for launches a data parallel computation with
@@ -300,8 +478,9 @@ public:
   template <typename KernelName = std::nullptr_t, int Dims,
             typename ParallelForFunctor>
   void parallel_for(const std::size_t (&global_size)[Dims],
-                    ParallelForFunctor f) {
-    parallel_for<KernelName>(range<Dims> { global_size }, f);
+                    ParallelForFunctor &&f) {
+    parallel_for<KernelName>(range<Dims> { global_size },
+                             std::forward<ParallelForFunctor>(f));
   }
 
   /** SYCL parallel_for launches a data parallel computation with
@@ -329,10 +508,12 @@ public:
   template <typename KernelName = std::nullptr_t,
             typename ParallelForFunctor>
   // Do not land here if we are using the sycl::kernel API
-  requires (!std::derived_from<ParallelForFunctor, kernel>)
+  requires (!std::derived_from<std::remove_cvref_t<ParallelForFunctor>,
+                               kernel>)
   void parallel_for(std::size_t global_size,
-                    ParallelForFunctor f) {
-    parallel_for<KernelName>(range { global_size }, f);
+                    ParallelForFunctor &&f) {
+    parallel_for<KernelName>(range { global_size },
+                             std::forward<ParallelForFunctor>(f));
   }
 
   /** Kernel invocation method of a kernel defined as a lambda or functor,
@@ -357,9 +538,15 @@ public:
   template <typename KernelName = std::nullptr_t, int Dims,
             typename ParallelForFunctor>
   void parallel_for(range<Dims> global_size, id<Dims> offset,
-                    ParallelForFunctor f) {
+                    ParallelForFunctor &&f) {
+    using backend = vendor::trisycl::kernel_backend_t<
+      std::remove_cvref_t<ParallelForFunctor>>;
     schedule_kernel<KernelName>(
-        [=] { detail::parallel_for_global_offset(global_size, offset, f); });
+        [=, f = with_kernel_handler(std::forward<ParallelForFunctor>(f))]
+        () mutable {
+          detail::backend_parallelism<backend>::parallel_for_global_offset(
+            global_size, offset, vendor::trisycl::without_backend(f));
+        }, global_size.size());
   }
 
   /** Kernel invocation method of a kernel defined as a lambda or functor,
@@ -386,10 +573,81 @@ public:
             int Dimensions,
             typename ParallelForFunctor>
   void parallel_for(nd_range<Dimensions> r,
-                    ParallelForFunctor f) {
-    schedule_kernel<KernelName>([=] { detail::parallel_for(r, f); });
+                    ParallelForFunctor &&f) {
+    using backend = vendor::trisycl::kernel_backend_t<
+      std::remove_cvref_t<ParallelForFunctor>>;
+    schedule_kernel<KernelName>([=, local = task->local_memory_size,
+                                 f = with_kernel_handler(
+                                   std::forward<ParallelForFunctor>(f))]
+                                () mutable {
+        // Each work-group gets its own storage for the local accessors
+        detail::backend_parallelism<backend>::parallel_for(
+          r, vendor::trisycl::without_backend(f), local);
+      }, r.get_global_range().size());
+  }
+
+
+  /** Kernel invocation method of a kernel with some reductions, for
+      the specified range or nd_range
+
+      The kernel is called with an id<>, an item<> or an nd_item<>
+      followed by a reducer for each reduction variable.
+
+      \param r defines the iteration space
+
+      \param rest are the reduction variables made by
+      sycl::reduction() followed by the kernel functor
+
+      \param KernelName is a class type that defines the name to be used for
+      the underlying kernel
+  */
+  template <typename KernelName = std::nullptr_t,
+            typename Range,
+            typename... Rest>
+  requires (sizeof...(Rest) >= 2 && detail::is_reduction_v<
+              std::remove_cvref_t<std::tuple_element_t<0,
+                                                       std::tuple<Rest...>>>>)
+  void parallel_for(Range r, Rest &&... rest) {
+    auto arguments = std::forward_as_tuple(std::forward<Rest>(rest)...);
+    constexpr auto reductions = sizeof...(Rest) - 1;
+    auto f = std::get<reductions>(arguments);
+    auto variables = [&]<std::size_t... I>(std::index_sequence<I...>) {
+      return std::tuple { std::get<I>(arguments)... };
+    }(std::make_index_sequence<reductions> {});
+    if constexpr (std::is_integral_v<Range>)
+      parallel_for_reduce<KernelName>(range { std::size_t(r) },
+                                      std::move(variables), f);
+    else
+      parallel_for_reduce<KernelName>(r, std::move(variables), f);
   }
 
+private:
+
+  /// Schedule a kernel on a range with the reduction variables in a tuple
+  template <typename KernelName, int Dims, typename... Reductions,
+            typename ParallelForFunctor>
+  void parallel_for_reduce(range<Dims> r,
+                           std::tuple<Reductions...> variables,
+                           ParallelForFunctor f) {
+    schedule_kernel<KernelName>([=] {
+        detail::parallel_for_reduce(r, f, variables);
+      }, r.size());
+  }
+
+
+  /// Schedule a kernel on an nd_range with the reduction variables
+  template <typename KernelName, int Dimensions, typename... Reductions,
+            typename ParallelForFunctor>
+  void parallel_for_reduce(nd_range<Dimensions> r,
+                           std::tuple<Reductions...> variables,
+                           ParallelForFunctor f) {
+    schedule_kernel<KernelName>([=, local = task->local_memory_size] {
+        // Each work-group gets its own storage for the local accessors
+        detail::parallel_for_reduce(r, f, variables, local);
+      }, r.get_global_range().size());
+  }
+
+public:
 
   /** Hierarchical kernel invocation method of a kernel defined as a
       lambda encoding the body of each work-group to launch
@@ -416,10 +674,16 @@ public:
             int Dimensions = 1,
             typename ParallelForFunctor>
   void parallel_for_work_group(nd_range<Dimensions> r,
-                               ParallelForFunctor f) {
-    schedule_kernel<KernelName>([=] {
-        detail::parallel_for_workgroup(r, f);
-      });
+                               ParallelForFunctor &&f) {
+    using backend = vendor::trisycl::kernel_backend_t<
+      std::remove_cvref_t<ParallelForFunctor>>;
+    schedule_kernel<KernelName>([=, local = task->local_memory_size,
+                                 f = std::forward<ParallelForFunctor>(f)]
+                                () mutable {
+        // Each work-group gets its own storage for the local accessors
+        detail::backend_parallelism<backend>::parallel_for_workgroup(
+          r, vendor::trisycl::without_backend(f), local);
+      }, r.get_global_range().size());
   }
 
 
@@ -448,8 +712,9 @@ public:
             int Dimensions = 1,
             typename ParallelForFunctor>
   void parallel_for_work_group(range<Dimensions> r1, range<Dimensions> r2,
-                               ParallelForFunctor f) {
-    parallel_for_work_group(nd_range<Dimensions> { r1, r2 }, f);
+                               ParallelForFunctor &&f) {
+    parallel_for_work_group<KernelName>(nd_range<Dimensions> { r1, r2 },
+                                        std::forward<ParallelForFunctor>(f));
   }
 
 
@@ -510,14 +775,495 @@ public:
       in the indexing space defined by the nd_range, described in detail
       in 3.5.3
 
+      The global size, the local size and the offset of the nd_range
+      are given to the OpenCL kernel, so it can rely on the size of
+      its work-groups, for example for its local memory.
+
       \todo Add in the spec a version taking a kernel and a functor,
       to have host fall-back
-
-      \todo To be implemented
   */
   template <int Dimensions = 1>
-  void parallel_for(nd_range<Dimensions>, kernel syclKernel) {
-    TRISYCL_UNIMPL;
+  void parallel_for(nd_range<Dimensions> r, kernel sycl_kernel) {
+    task->set_kernel(sycl_kernel.implementation);
+    task->schedule(detail::trace_kernel<kernel>([=, t = task] {
+          sycl_kernel.implementation->parallel_for(t, t->get_queue(), r);
+        }));
+  }
+
+
+  /** Run some host code \p f as the command of the command group
+
+      The host code is executed on a worker of the queue once the
+      producers of its accessors are done, and the consumers wait for
+      it, like for a kernel, so the host stages of an application,
+      such as some I/O, can overlap with the kernels of the other
+      command groups. Its accessors should use the
+      access::target::host_task target, so the data are in the host
+      memory even with an OpenCL queue.
+
+      With TRISYCL_FIBER_TASKS, a host task blocking in a system call
+      blocks the thread running the fibers of the queue.
+  */
+  template <typename HostTask>
+    requires std::invocable<HostTask>
+  void host_task(HostTask f) {
+    task->schedule([=] () mutable { f(); });
+  }
+
+
+  /** Run the command group on the submitting thread if it has no
+      pending dependency, instead of handing it over to a worker thread
+
+      The submission returns then after the end of the kernel, which
+      must not wait for something done by the submitter after the
+      submission. On an in-order queue, this only happens when the
+      previous command groups are done.
+
+      This is a triSYCL extension.
+  */
+  void set_latency_critical() {
+    task->latency_critical = true;
+  }
+
+
+  /** Skip the kernel of this command group when it already ran with
+      the same \p scalars and the same number of work-items, and when
+      none of the buffers it accesses has been written since
+
+      Its outputs hold then what it would compute again, so a repeated
+      computation on unchanged inputs costs almost nothing:
+      \code
+      cgh.memoize(threshold, columns);
+      cgh.parallel_for<class histogram>(...);
+      \endcode
+
+      The kernel is identified by its name, or its type without name.
+      Only the buffers are tracked, so \p scalars has to cover every
+      other value the kernel depends on, such as the scalars it
+      captures or the shape of a multidimensional range. The scalars
+      are compared by their bytes.
+
+      This is a triSYCL extension.
+  */
+  template <typename... Scalars>
+  void memoize(const Scalars &... scalars) {
+    static_assert((std::is_trivially_copyable_v<Scalars> && ...),
+                  "the memoized scalars are compared by their bytes");
+    std::string bytes;
+    (bytes.append(reinterpret_cast<const char *>(&scalars), sizeof(scalars)),
+     ...);
+    task->memo_scalars = std::move(bytes);
+  }
+
+
+  /// The OpenMP schedules to distribute the iterations of a kernel
+  using schedule = detail::partitioning::schedule;
+
+
+  /** Set how the OpenMP threads share the iterations of the kernel of
+      this command group when executed on the host, instead of the
+      static schedule
+
+      For example a kernel whose work-items have very different costs
+      balances better with:
+      \code
+      cgh.set_schedule(handler::schedule::dynamic_schedule, 4);
+      \endcode
+
+      \param[in] chunk_size is the number of iterations of the
+      distributed loop given at once to a thread, which are the rows
+      along the last dimension of a 2D or 3D kernel, the work-items of
+      a 1D kernel or the work-groups of an nd_range kernel, or 0 for
+      the default of the schedule
+
+      This is a triSYCL extension, only used by the OpenMP back-end.
+  */
+  void set_schedule(schedule s, std::size_t chunk_size = 0) {
+    auto &p = task->get_partitioning();
+    p.scheduling = s;
+    p.chunk_size = chunk_size;
+  }
+
+
+  /** Limit the number of OpenMP threads executing the kernel of this
+      command group on the host, 0 meaning all the threads the
+      concurrency governor gives
+
+      This is a triSYCL extension, only used by the OpenMP back-end.
+  */
+  void set_team_size(std::size_t threads) {
+    task->get_partitioning().team_size = threads;
+  }
+
+
+  /** Make the command group wait for the command group of an event
+
+      This is how the command groups using only some USM pointers are
+      ordered, since they have no buffer to track.
+
+      \todo Use the wait list of the OpenCL kernel for an OpenCL event
+  */
+  void depends_on(event e) {
+    if (auto t = e.implementation->get_task())
+      task->add_dependency(std::move(t));
+    else if (!e.is_host())
+      task->add_prelude([e] () mutable { e.wait(); });
+  }
+
+
+  /// Make the command group wait for the command groups of some events
+  void depends_on(const vector_class<event> &events) {
+    for (auto &e : events)
+      depends_on(e);
+  }
+
+
+  /** Copy \p count bytes from \p src to \p dest, which are some USM
+      allocations or some host memory
+  */
+  void memcpy(void *dest, const void *src, std::size_t count) {
+#if defined(TRISYCL_OPENCL) && defined(BOOST_COMPUTE_CL_VERSION_2_0)
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, q = task->get_queue()] {
+          q->get_boost_compute().enqueue_svm_memcpy(dest, src, count);
+        });
+      return;
+    }
+#endif
+    task->schedule([=] { detail::parallel_memcpy(dest, src, count); });
+  }
+
+
+  /// Copy \p count elements from \p src to \p dest
+  template <typename T>
+  void copy(const T *src, T *dest, std::size_t count) {
+    memcpy(dest, src, count*sizeof(T));
+  }
+
+
+  /// Set \p count bytes from \p ptr to \p value converted to a byte
+  void memset(void *ptr, int value, std::size_t count) {
+#if defined(TRISYCL_OPENCL) && defined(BOOST_COMPUTE_CL_VERSION_2_0)
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, q = task->get_queue()] {
+          unsigned char pattern = value;
+          q->get_boost_compute().enqueue_svm_fill(ptr, &pattern, 1, count)
+            .wait();
+        });
+      return;
+    }
+#endif
+    task->schedule([=] { detail::parallel_memset(ptr, value, count); });
+  }
+
+
+  /// Set \p count elements from \p ptr to \p pattern
+  template <typename T>
+  void fill(void *ptr, const T &pattern, std::size_t count) {
+#if defined(TRISYCL_OPENCL) && defined(BOOST_COMPUTE_CL_VERSION_2_0)
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, q = task->get_queue()] {
+          q->get_boost_compute().enqueue_svm_fill(ptr, &pattern, sizeof(T),
+                                                  count*sizeof(T)).wait();
+        });
+      return;
+    }
+#endif
+    task->schedule([=] {
+        detail::parallel_fill(static_cast<T *>(ptr), pattern, count);
+      });
+  }
+
+
+  /** Get the number of bytes of a row of the accessor \p a and the
+      number of bytes from a row to the next one in its storage, which
+      differ when the rows of its buffer are padded
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  static std::pair<std::size_t, std::size_t>
+  row_bytes(const accessor<T, Dimensions, Mode, Target> &a) {
+    return { a.get_range()[Dimensions - 1]*sizeof(T),
+             a.get_row_pitch()*sizeof(T) };
+  }
+
+
+  /** Copy all the elements of the accessor \p src to the host memory
+      at \p dest
+
+      On an OpenCL device this is a read of the OpenCL buffer, which
+      does not need the host storage of the buffer. The padded rows of
+      a buffer are read as a rectangle into the dense host memory.
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target, typename U>
+  void copy(accessor<T, Dimensions, Mode, Target> src, U *dest) {
+    auto [row, pitch] = row_bytes(src);
+#ifdef TRISYCL_OPENCL
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, t = task] {
+          auto &q = t->get_queue()->get_boost_compute();
+          auto buffer = src.implementation->get_cl_buffer();
+          if (row == pitch) {
+            q.enqueue_read_buffer(buffer, 0, src.get_size(), dest,
+                                  detail::take_transfers(*t));
+            return;
+          }
+          const std::size_t origin[3] {};
+          const std::size_t region[3] { row, src.get_size()/row, 1 };
+          q.enqueue_read_buffer_rect(buffer, origin, origin, region, pitch,
+                                     0, row, 0, dest,
+                                     detail::take_transfers(*t));
+        });
+      return;
+    }
+#endif
+    task->schedule([=] {
+        detail::parallel_copy_rows(dest, row, row, src.get_pointer(), row,
+                                   pitch, src.get_size());
+      });
+  }
+
+
+  /// Copy all the elements of the accessor \p src to \p dest
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target, typename U>
+  void copy(accessor<T, Dimensions, Mode, Target> src,
+            std::shared_ptr<U> dest) {
+    // Keep the destination alive up to the end of the copy
+    task->add_postlude([dest] {});
+    copy(src, dest.get());
+  }
+
+
+  /** Copy the host memory at \p src to all the elements of the
+      accessor \p dest
+
+      On an OpenCL device this is a write of the OpenCL buffer, as a
+      rectangle when the rows of the buffer are padded.
+  */
+  template <typename U, typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  void copy(const U *src, accessor<T, Dimensions, Mode, Target> dest) {
+    auto [row, pitch] = row_bytes(dest);
+#ifdef TRISYCL_OPENCL
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, t = task] {
+          auto &q = t->get_queue()->get_boost_compute();
+          auto buffer = dest.implementation->get_cl_buffer();
+          if (row == pitch) {
+            q.enqueue_write_buffer(buffer, 0, dest.get_size(), src,
+                                   detail::take_transfers(*t));
+            return;
+          }
+          const std::size_t origin[3] {};
+          const std::size_t region[3] { row, dest.get_size()/row, 1 };
+          // The host memory is only read despite the non-const API
+          q.enqueue_write_buffer_rect(buffer, origin, origin, region, pitch,
+                                      0, row, 0, const_cast<U *>(src),
+                                      detail::take_transfers(*t));
+        });
+      return;
+    }
+#endif
+    task->schedule([=] {
+        detail::parallel_copy_rows(dest.get_pointer(), row, pitch, src, row,
+                                   row, dest.get_size());
+      });
+  }
+
+
+  /// Copy \p src to all the elements of the accessor \p dest
+  template <typename U, typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  void copy(std::shared_ptr<U> src,
+            accessor<T, Dimensions, Mode, Target> dest) {
+    task->add_postlude([src] {});
+    copy(static_cast<const U *>(src.get()), dest);
+  }
+
+
+  /** Copy the elements of the accessor \p src to the accessor \p
+      dest, up to the size of the smallest one
+
+      The size is not checked when the command group is built, since
+      throwing there would leave the buffers waiting for a command
+      group which is never executed.
+
+      On an OpenCL device this is a copy between the OpenCL buffers,
+      as a rectangle when only their row pitches differ. The copy
+      between some padded buffers with different row lengths is only
+      supported on the host device.
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target, typename U, int DestDimensions,
+            access::mode DestMode, access::target DestTarget>
+  void copy(accessor<T, Dimensions, Mode, Target> src,
+            accessor<U, DestDimensions, DestMode, DestTarget> dest) {
+    auto size = std::min<std::size_t>(src.get_size(), dest.get_size());
+    auto [src_row, src_pitch] = row_bytes(src);
+    auto [dest_row, dest_pitch] = row_bytes(dest);
+#ifdef TRISYCL_OPENCL
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, t = task] {
+          auto &q = t->get_queue()->get_boost_compute();
+          auto s = src.implementation->get_cl_buffer();
+          auto d = dest.implementation->get_cl_buffer();
+          if (src_row == src_pitch && dest_row == dest_pitch) {
+            q.enqueue_copy_buffer(s, d, 0, 0, size,
+                                  detail::take_transfers(*t)).wait();
+            return;
+          }
+          if (src_row != dest_row)
+            throw feature_not_supported {
+              "Copy between some padded buffers with different rows" };
+          const std::size_t origin[3] {};
+          const std::size_t region[3] { src_row, size/src_row, 1 };
+          q.enqueue_copy_buffer_rect(s, d, origin, origin, region, src_pitch,
+                                     0, dest_pitch, 0,
+                                     detail::take_transfers(*t)).wait();
+        });
+      return;
+    }
+#endif
+    task->schedule([=] {
+        detail::parallel_copy_rows(dest.get_pointer(), dest_row, dest_pitch,
+                                   src.get_pointer(), src_row, src_pitch,
+                                   size);
+      });
+  }
+
+
+  /** Set all the elements of the accessor \p dest to \p value
+
+      On an OpenCL device this is a fill of the OpenCL buffer.
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  void fill(accessor<T, Dimensions, Mode, Target> dest,
+            const std::remove_cv_t<T> &value) {
+#ifdef TRISYCL_OPENCL
+    if (!task->get_queue()->is_host()) {
+      task->schedule([=, t = task] {
+          t->get_queue()->get_boost_compute()
+            .enqueue_fill_buffer(dest.implementation->get_cl_buffer(),
+                                 &value, sizeof(T), 0,
+                                 dest.implementation->get_storage_size(),
+                                 detail::take_transfers(*t))
+            .wait();
+        });
+      return;
+    }
+#endif
+    task->schedule([=] {
+        // The padding of the rows is filled too, as a single range
+        detail::parallel_fill(dest.get_pointer(), value,
+                              dest.implementation->get_storage_count());
+      });
+  }
+
+
+  /** Read the elements of the accessor \p dest from the file
+      descriptor \p fd, the first element of the buffer being at the
+      byte \p offset of the file
+
+      Only the elements of a ranged accessor are read, so the command
+      groups reading some disjoint parts of a buffer run concurrently,
+      and a kernel using a part already read does not wait for the
+      other ones, as with vendor::trisycl::read_from_file(). The
+      accessor should use the access::target::host_task target, so
+      the data are read into the host memory even with an OpenCL
+      queue.
+
+      An error or a file too short is reported to the async_handler of
+      the queue.
+
+      The file has no padding, so the rows of a padded buffer are read
+      one after the other.
+
+      This is a triSYCL extension.
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  void read_from_file(accessor<T, Dimensions, Mode, Target> dest, int fd,
+                      std::uint64_t offset = 0) {
+    static_assert(!std::is_const_v<T>, "Cannot read into a const buffer");
+    task->schedule([=] {
+        auto [first, last] = dest.implementation->get_window();
+        std::size_t row = dest.get_range()[Dimensions - 1];
+        std::size_t pitch = dest.get_row_pitch();
+        if (row == pitch) {
+          detail::parallel_read(fd, dest.get_pointer() + first,
+                                (last - first)*sizeof(T),
+                                offset + first*sizeof(T));
+          return;
+        }
+        // The window is in the storage, with the padding of the rows
+        for (auto p = first; p < last; p += pitch - p % pitch)
+          if (auto column = p % pitch; column < row)
+            detail::parallel_read(fd, dest.get_pointer() + p,
+                                  (std::min(row, last - p + column) - column)
+                                  *sizeof(T),
+                                  offset
+                                  + (p/pitch*row + column)*sizeof(T));
+      });
+  }
+
+
+  /** Make the host memory of the buffer behind the accessor \p acc
+      up-to-date, without waiting for it as a host accessor does
+
+      On the host device the buffer is already in the host memory.
+  */
+  template <typename T, int Dimensions, access::mode Mode,
+            access::target Target>
+  void update_host(accessor<T, Dimensions, Mode, Target> acc) {
+    task->schedule([=] {
+#ifdef TRISYCL_OPENCL
+        if constexpr (!std::is_const_v<T>) {
+          auto &b = acc.implementation->get_buffer();
+          b.update_buffer_state(trisycl::context {}, access::mode::read,
+                                acc.implementation->get_storage_size(),
+                                b.host_storage());
+        }
+#else
+        static_cast<void>(acc);
+#endif
+      });
+  }
+
+
+  /** Move the data of a buffer to the device of the queue ahead of
+      the kernels needing them
+
+      The command group uses the buffer like a read accessor, so it is
+      ordered after the kernels writing it but it does not delay the
+      other readers. Once done, the device holds some fresh data and
+      the next kernels reading the buffer there do not have to wait
+      for any transfer. On the host device there is nothing to move.
+  */
+  template <typename T, int Dimensions, typename Allocator>
+  void prefetch(buffer<T, Dimensions, Allocator> &b) {
+    // The transfer is done by the prelude of the accessor
+    accessor<T, Dimensions, access::mode::read,
+             access::target::global_buffer> a { b, *this };
+    task->schedule([t = task] {
+#ifdef TRISYCL_OPENCL
+        detail::take_transfers(*t).wait();
+#endif
+      });
+  }
+
+
+  /** Get the event tracking the execution of the command group
+
+      The command groups without anything to execute, or recorded in
+      a task graph, are considered complete.
+  */
+  event get_event() const {
+    if (!task->scheduled)
+      return {};
+    return { std::make_shared<detail::task_event>(task) };
   }
 
 };
@@ -531,11 +1277,36 @@ namespace detail {
 static std::shared_ptr<detail::task>
 add_buffer_to_task(handler *command_group_handler,
                    std::shared_ptr<detail::buffer_base> b,
-                   bool is_write_mode) {
-  command_group_handler->task->add_buffer(b, is_write_mode);
+                   bool is_write_mode, std::size_t first, std::size_t last) {
+  command_group_handler->task->add_buffer(b, is_write_mode, first, last);
   return command_group_handler->task;
 }
 
+
+/** Register the use of a pipe by a command group, for writing if \p
+    is_write
+
+    This is a proxy function to avoid complicated type recursion.
+*/
+inline void add_pipe_to_task(handler &command_group_handler,
+                             const void *pipe, bool is_write) {
+  command_group_handler.task->add_pipe(pipe, is_write);
+}
+
+
+/** Register the use of some local memory by a command group
+
+    \return the offset of the \p size bytes in the local memory of a
+    work-group
+*/
+inline std::size_t register_local_memory(handler &command_group_handler,
+                                         std::size_t size) {
+  auto &total = command_group_handler.task->local_memory_size;
+  auto offset = local_memory_arena::align(total);
+  total = offset + size;
+  return offset;
+}
+
 }
 
 /// @} End the execution Doxygen group
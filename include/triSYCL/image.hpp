@@ -5,25 +5,187 @@
 
     OpenCL SYCL image class
 
+    The texels are stored on the host in tiles with a Morton order
+    inside each tile, so that the neighbourhood fetches of the 2D and
+    3D kernels stay in a few cache lines.
+
     Ronan at Keryell point FR
 
     This file is distributed under the University of Illinois Open Source
     License. See LICENSE.TXT for details.
 */
 
+#include <cstddef>
+#include <memory>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/accessor.hpp"
+#include "triSYCL/detail/shared_ptr_implementation.hpp"
+#include "triSYCL/image/detail/image.hpp"
+#include "triSYCL/image/detail/image_accessor.hpp"
+#include "triSYCL/property_list.hpp"
+#include "triSYCL/range.hpp"
+#include "triSYCL/sampler.hpp"
+
 namespace trisycl {
 
+class handler;
+
 /** \addtogroup data
 
     @{
 */
 
-/// \todo implement image
-template <int Dimensions> struct image;
+/** An image of texels in 1, 2 or 3 dimensions
+
+    The kernels read it through an image accessor, with some integer
+    coordinates or with a sampler, and write it with some integer
+    coordinates.
+
+    \todo Map it to the OpenCL image objects on the OpenCL devices
+*/
+template <int Dimensions = 1>
+class image
+  : public detail::shared_ptr_implementation<image<Dimensions>,
+                                             detail::image<Dimensions>> {
+
+  // The type encapsulating the implementation
+  using implementation_t = typename image::shared_ptr_implementation;
+
+  // Allows the comparison operation to access the implementation
+  friend implementation_t;
+
+public:
+
+  // Make the implementation member directly accessible in this class
+  using implementation_t::implementation;
+
+  /// Create an image of \p r uninitialized texels
+  image(image_channel_order order, image_channel_type type,
+        const range<Dimensions> &r, const property_list & = {})
+    : implementation_t { new detail::image<Dimensions> { order, type, r } } {}
+
+
+  /** Create an image of \p r texels initialized from the linear data
+      at \p host_data, where they are written back at the destruction
+  */
+  image(void *host_data, image_channel_order order, image_channel_type type,
+        const range<Dimensions> &r, const property_list & = {})
+    : implementation_t { new detail::image<Dimensions> {
+        order, type, r, host_data, host_data } } {}
+
+
+  /// Create an image of \p r texels initialized from the read-only
+  /// linear data at \p host_data
+  image(const void *host_data, image_channel_order order,
+        image_channel_type type, const range<Dimensions> &r,
+        const property_list & = {})
+    : implementation_t { new detail::image<Dimensions> {
+        order, type, r, host_data } } {}
+
+
+  /// The range of the image in texels
+  range<Dimensions> get_range() const {
+    return implementation->get_range();
+  }
+
+
+  /// The number of texels of the image
+  std::size_t get_count() const {
+    return implementation->layout.get_count();
+  }
+
+
+  /// The size in bytes of the texels of the image in a linear layout
+  std::size_t get_size() const {
+    return get_count()*implementation->format.get_texel_size();
+  }
+
+
+  /** Get an accessor to the image for a kernel
 
+      \param DataType is the vector type of the texels seen by the
+      kernel, such as \c float4, \c int4 or \c uint4
+  */
+  template <typename DataType, access::mode Mode>
+  accessor<DataType, Dimensions, Mode, access::target::image>
+  get_access(handler &command_group_handler) {
+    return { *this, command_group_handler };
+  }
+
+
+  /// Get a host accessor to the image
+  template <typename DataType, access::mode Mode>
+  accessor<DataType, Dimensions, Mode, access::target::host_image>
+  get_access() {
+    return { *this };
+  }
+
+
+  /** Set where the texels are written back in a linear layout at the
+      destruction, or nullptr to disable the write-back
+  */
+  void set_final_data(void *final_data) {
+    implementation->set_final_data(final_data);
+  }
+
+};
+
+
+/** The accessor to an image from a kernel
+
+    The image is read and written through read() and write().
+*/
+template <typename DataType, int Dimensions, access::mode AccessMode>
+class accessor<DataType, Dimensions, AccessMode, access::target::image>
+  : public detail::image_accessor<DataType, Dimensions, AccessMode,
+                                  access::target::image> {
+public:
+
+  using accessor_detail =
+    detail::image_accessor<DataType, Dimensions, AccessMode,
+                           access::target::image>;
+
+  accessor(image<Dimensions> &i, handler &command_group_handler)
+    : accessor_detail { *i.implementation, command_group_handler } {}
+
+};
+
+
+/// The accessor to an image from the host
+template <typename DataType, int Dimensions, access::mode AccessMode>
+class accessor<DataType, Dimensions, AccessMode, access::target::host_image>
+  : public detail::image_accessor<DataType, Dimensions, AccessMode,
+                                  access::target::host_image> {
+public:
+
+  using accessor_detail =
+    detail::image_accessor<DataType, Dimensions, AccessMode,
+                           access::target::host_image>;
+
+  accessor(image<Dimensions> &i)
+    : accessor_detail { *i.implementation } {}
+
+};
 
 /// @} End the data Doxygen group
 
+}
+
+/* Inject a custom specialization of std::hash to have the image
+   usable into an unordered associative container
+*/
+namespace std {
+
+template <int Dimensions>
+struct hash<trisycl::image<Dimensions>> {
+
+  auto operator()(const trisycl::image<Dimensions> &i) const {
+    // Forward the hashing to the implementation
+    return i.hash();
+  }
+
+};
 
 }
 
@@ -0,0 +1,135 @@
+#ifndef TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_HPP
+#define TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_HPP
+
+/** \file
+
+    The implementation of the image, with its texels tiled in a buffer
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/buffer.hpp"
+#include "triSYCL/image/detail/image_layout.hpp"
+#include "triSYCL/image/detail/texel_format.hpp"
+#include "triSYCL/range.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** The implementation of an image
+
+    The texels are stored with the tiled layout in a buffer of bytes,
+    so the accessors to the image are just some accessors to this
+    buffer and the kernels using the image are scheduled by the usual
+    buffer dependencies. The linear host data are converted from and
+    to the tiled layout at the construction and at the destruction.
+*/
+template <int Dimensions>
+class image {
+
+public:
+
+  /// The tiled layout of the texels
+  image_layout<Dimensions> layout;
+
+  /// The format of the texels
+  texel_format format;
+
+  /// The tiled texels
+  ::trisycl::buffer<std::byte> storage;
+
+private:
+
+  /// The linear host data to write back at the destruction, if any
+  void *final_data = nullptr;
+
+public:
+
+  /** Create an image of \p r texels, initialized from the linear data
+      at \p host_data if not nullptr
+
+      \param[in] final_data is where the texels are written back at
+      the destruction if not nullptr
+  */
+  image(image_channel_order order, image_channel_type type,
+        const range<Dimensions> &r, const void *host_data = nullptr,
+        void *final_data = nullptr)
+    : layout { extents(r) }
+    , format { order, type }
+    , storage { range<1> { layout.get_storage_count()
+                           *format.get_texel_size() } }
+    , final_data { final_data } {
+    if (host_data) {
+      auto a = storage.get_access<access::mode::discard_write>();
+      auto src = static_cast<const std::byte *>(host_data);
+      auto size = format.get_texel_size();
+      layout.for_each_texel([&] (std::size_t i, std::size_t p) {
+          std::memcpy(a.get_pointer() + p*size, src + i*size, size);
+        });
+    }
+  }
+
+
+  /// Set where the texels are written back at the destruction
+  void set_final_data(void *data) {
+    final_data = data;
+  }
+
+
+  /// The range of the image in texels
+  range<Dimensions> get_range() const {
+    range<Dimensions> r;
+    for (int d = 0; d != Dimensions; ++d)
+      r[d] = layout.get_extent(d);
+    return r;
+  }
+
+
+  /// Write back the texels, once the kernels using them are done
+  ~image() {
+    if (final_data) {
+      auto a = storage.get_access<access::mode::read>();
+      auto dest = static_cast<std::byte *>(final_data);
+      auto size = format.get_texel_size();
+      layout.for_each_texel([&] (std::size_t i, std::size_t p) {
+          std::memcpy(dest + i*size, a.get_pointer() + p*size, size);
+        });
+    }
+  }
+
+private:
+
+  static std::array<std::size_t, Dimensions>
+  extents(const range<Dimensions> &r) {
+    std::array<std::size_t, Dimensions> e;
+    for (int d = 0; d != Dimensions; ++d)
+      e[d] = r[d];
+    return e;
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_HPP
@@ -0,0 +1,243 @@
+#ifndef TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_ACCESSOR_HPP
+#define TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_ACCESSOR_HPP
+
+/** \file
+
+    The accessors reading and writing the texels of an image
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/accessor.hpp"
+#include "triSYCL/image/detail/image.hpp"
+#include "triSYCL/range.hpp"
+#include "triSYCL/sampler.hpp"
+
+namespace trisycl {
+
+class handler;
+
+namespace detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** The implementation of the accessors of an image
+
+    \param DataType is the 4-element vector type of the texels seen by
+    the kernel, such as \c float4, \c int4 or \c uint4
+
+    \param Target is \c access::target::image for a kernel accessor or
+    \c access::target::host_image for a host accessor
+*/
+template <typename DataType, int Dimensions, access::mode AccessMode,
+          access::target Target>
+class image_accessor {
+
+  using element_type = typename DataType::element_type;
+
+  /// The accessor to the tiled texels, which tracks the dependencies
+  ::trisycl::accessor<std::byte, 1, AccessMode,
+                      Target == access::target::image
+                      ? access::target::global_buffer
+                      : access::target::host_buffer> storage;
+
+  /// The start of the tiled texels
+  std::byte *texels;
+
+  image_layout<Dimensions> layout;
+
+  texel_format format;
+
+  std::size_t texel_size;
+
+public:
+
+  /// Construct a kernel accessor to the image \p i
+  image_accessor(image<Dimensions> &i, handler &command_group_handler)
+    : storage { i.storage, command_group_handler }
+    , texels { storage.get_pointer() }
+    , layout { i.layout }
+    , format { i.format }
+    , texel_size { format.get_texel_size() } {}
+
+
+  /// Construct a host accessor to the image \p i
+  image_accessor(image<Dimensions> &i)
+    : storage { i.storage }
+    , texels { storage.get_pointer() }
+    , layout { i.layout }
+    , format { i.format }
+    , texel_size { format.get_texel_size() } {}
+
+
+  /// The range of the image in texels
+  range<Dimensions> get_range() const {
+    range<Dimensions> r;
+    for (int d = 0; d != Dimensions; ++d)
+      r[d] = layout.get_extent(d);
+    return r;
+  }
+
+
+  /// The number of texels of the image
+  std::size_t get_count() const {
+    return layout.get_count();
+  }
+
+
+  /** Read the texel at the integer \p coordinates, which have to be
+      inside the image
+
+      \param Coordinates is \c int in 1D, \c int2 in 2D and \c int4 in
+      3D
+  */
+  template <typename Coordinates>
+  DataType read(const Coordinates &coordinates) const {
+    return load(integer_coordinates(coordinates));
+  }
+
+
+  /** Read the image at \p coordinates with the sampler \p s
+
+      \param Coordinates is \c float or \c int in 1D, \c float2 or \c
+      int2 in 2D and \c float4 or \c int4 in 3D
+  */
+  template <typename Coordinates>
+  DataType read(const Coordinates &coordinates, const sampler &s) const {
+    std::array<float, Dimensions> x;
+    for (int d = 0; d != Dimensions; ++d) {
+      auto u = static_cast<float>(coordinate(coordinates, d));
+      /* Map the normalized coordinates to the texels, the repeat
+         modes being only defined with normalized coordinates */
+      if (s.get_coordinate_normalization_mode()
+          == coordinate_normalization_mode::normalized) {
+        if (s.get_addressing_mode() == addressing_mode::repeat)
+          u -= std::floor(u);
+        else if (s.get_addressing_mode() == addressing_mode::mirrored_repeat)
+          u = std::fabs(u - 2*std::nearbyint(u/2));
+        u *= layout.get_extent(d);
+      }
+      x[d] = u;
+    }
+    if (s.get_filtering_mode() == filtering_mode::nearest) {
+      std::array<long, Dimensions> i;
+      for (int d = 0; d != Dimensions; ++d)
+        i[d] = static_cast<long>(std::floor(x[d]));
+      return fetch(i, s.get_addressing_mode());
+    }
+    /* Linear filtering: blend the 2^Dimensions texels around the
+       coordinates, shifted by half a texel to the texel centers */
+    std::array<long, Dimensions> i0;
+    std::array<float, Dimensions> a;
+    for (int d = 0; d != Dimensions; ++d) {
+      auto shifted = x[d] - 0.5f;
+      auto f = std::floor(shifted);
+      i0[d] = static_cast<long>(f);
+      a[d] = shifted - f;
+    }
+    std::array<float, 4> sum {};
+    for (unsigned corner = 0; corner != 1U << Dimensions; ++corner) {
+      auto i = i0;
+      float weight = 1;
+      for (int d = 0; d != Dimensions; ++d)
+        if (corner >> d & 1) {
+          ++i[d];
+          weight *= a[d];
+        } else
+          weight *= 1 - a[d];
+      auto t = fetch(i, s.get_addressing_mode());
+      for (int c = 0; c != 4; ++c)
+        sum[c] += weight*static_cast<float>(t[c]);
+    }
+    DataType v;
+    for (int c = 0; c != 4; ++c)
+      v[c] = static_cast<element_type>(sum[c]);
+    return v;
+  }
+
+
+  /** Write \p value into the texel at the integer \p coordinates,
+      which have to be inside the image
+  */
+  template <typename Coordinates>
+  void write(const Coordinates &coordinates, const DataType &value) const {
+    static_assert(AccessMode != access::mode::read,
+                  "an image accessor in read mode cannot write");
+    format.store(texels + layout.position(integer_coordinates(coordinates))
+                 *texel_size, value);
+  }
+
+private:
+
+  /// The coordinate \p d of a scalar or of a vector
+  template <typename Coordinates>
+  static auto coordinate(const Coordinates &c, int d) {
+    if constexpr (std::is_arithmetic_v<Coordinates>)
+      return c;
+    else
+      return c[d];
+  }
+
+
+  template <typename Coordinates>
+  static std::array<std::size_t, Dimensions>
+  integer_coordinates(const Coordinates &c) {
+    std::array<std::size_t, Dimensions> i;
+    for (int d = 0; d != Dimensions; ++d)
+      i[d] = static_cast<std::size_t>(coordinate(c, d));
+    return i;
+  }
+
+
+  /// Read the texel at some coordinates inside the image
+  DataType load(const std::array<std::size_t, Dimensions> &i) const {
+    return format.load<element_type>(texels + layout.position(i)*texel_size);
+  }
+
+
+  /** Read the texel at some coordinates maybe outside of the image,
+      mapped inside according to the addressing mode \p m
+  */
+  DataType fetch(std::array<long, Dimensions> i, addressing_mode m) const {
+    std::array<std::size_t, Dimensions> inside;
+    for (int d = 0; d != Dimensions; ++d) {
+      long w = layout.get_extent(d);
+      if (m == addressing_mode::repeat)
+        i[d] = (i[d] % w + w) % w;
+      else if (i[d] < 0 || i[d] >= w) {
+        if (m == addressing_mode::clamp)
+          return format.border<element_type>();
+        i[d] = i[d] < 0 ? 0 : w - 1;
+      }
+      inside[d] = i[d];
+    }
+    return load(inside);
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_ACCESSOR_HPP
@@ -0,0 +1,157 @@
+#ifndef TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_LAYOUT_HPP
+#define TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_LAYOUT_HPP
+
+/** \file
+
+    The tiled storage of the texels of an image
+
+    A row-major image has a poor locality in the vertical direction: 2
+    vertically adjacent texels are a row apart, so a 3x3 neighbourhood
+    touches 3 different cache lines or pages. Here the image is cut in
+    tiles of 64 texels, 8x8 in 2D and 4x4x4 in 3D, stored one after the
+    other, and the texels inside a tile are in Morton order. So a small
+    neighbourhood fetch only touches a few tiles, each one a few cache
+    lines large.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <cstddef>
+
+namespace trisycl::detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** The mapping of the coordinates of the texels of an image to their
+    position in the storage
+
+    It is just a few integers, cheap to copy into the kernels.
+*/
+template <int Dimensions>
+class image_layout {
+
+  static_assert(1 <= Dimensions && Dimensions <= 3,
+                "an image has 1, 2 or 3 dimensions");
+
+public:
+
+  /// The number of texels of a tile
+  static constexpr std::size_t tile_size = 64;
+
+  /// The log2 of the edge of a tile
+  static constexpr std::size_t edge_bits = 6/Dimensions;
+
+  /// The number of texels along each edge of a tile
+  static constexpr std::size_t edge = std::size_t { 1 } << edge_bits;
+
+private:
+
+  /** Spread the bits of a coordinate inside a tile so that they are
+      Dimensions bits apart, to be interleaved with the other ones into
+      a Morton index
+  */
+  static constexpr std::array<unsigned char, edge> spread = [] {
+    std::array<unsigned char, edge> s {};
+    for (std::size_t v = 0; v != edge; ++v)
+      for (std::size_t b = 0; b != edge_bits; ++b)
+        s[v] |= ((v >> b) & 1) << b*Dimensions;
+    return s;
+  }();
+
+  /// The size in texels of the image in each dimension
+  std::array<std::size_t, Dimensions> extents {};
+
+  /// The number of tiles in each dimension
+  std::array<std::size_t, Dimensions> tiles {};
+
+public:
+
+  image_layout() = default;
+
+
+  /// The layout of an image of \p extents texels
+  image_layout(const std::array<std::size_t, Dimensions> &extents)
+    : extents { extents } {
+    for (int d = 0; d != Dimensions; ++d)
+      tiles[d] = (extents[d] + edge - 1)/edge;
+  }
+
+
+  /// The size in texels of the image in dimension \p d
+  std::size_t get_extent(int d) const {
+    return extents[d];
+  }
+
+
+  /// The number of texels of the image
+  std::size_t get_count() const {
+    std::size_t c = 1;
+    for (auto e : extents)
+      c *= e;
+    return c;
+  }
+
+
+  /// The number of texel slots of the storage, including the padding
+  std::size_t get_storage_count() const {
+    std::size_t c = tile_size;
+    for (auto t : tiles)
+      c *= t;
+    return c;
+  }
+
+
+  /** The position in the storage of the texel at \p coordinates, with
+      the dimension 0 varying the fastest
+
+      The coordinates have to be inside the image.
+  */
+  std::size_t position(const std::array<std::size_t, Dimensions>
+                       &coordinates) const {
+    std::size_t tile = 0;
+    std::size_t morton = 0;
+    for (int d = Dimensions - 1; d >= 0; --d) {
+      tile = tile*tiles[d] + (coordinates[d] >> edge_bits);
+      morton |= std::size_t { spread[coordinates[d] & (edge - 1)] } << d;
+    }
+    return tile*tile_size + morton;
+  }
+
+
+  /** Call \p f(coordinates, position) for each texel of the image, in
+      the order of a linear image with the dimension 0 varying the
+      fastest
+
+      This is used to convert from and to the linear host data.
+  */
+  template <typename F>
+  void for_each_texel(F &&f) const {
+    std::array<std::size_t, Dimensions> c {};
+    for (std::size_t i = 0, n = get_count(); i != n; ++i) {
+      f(i, position(c));
+      for (int d = 0; d != Dimensions && ++c[d] == extents[d]; ++d)
+        c[d] = 0;
+    }
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_IMAGE_DETAIL_IMAGE_LAYOUT_HPP
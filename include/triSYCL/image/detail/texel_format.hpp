@@ -0,0 +1,319 @@
+#ifndef TRISYCL_SYCL_IMAGE_DETAIL_TEXEL_FORMAT_HPP
+#define TRISYCL_SYCL_IMAGE_DETAIL_TEXEL_FORMAT_HPP
+
+/** \file
+
+    The channel orders and types of the images and the conversion of
+    their texels from and to the vectors used by the kernels
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "triSYCL/exception.hpp"
+#include "triSYCL/half.hpp"
+#include "triSYCL/vec.hpp"
+
+namespace trisycl {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/// The channels of a texel and their order in memory
+enum class image_channel_order : char {
+  a,
+  r,
+  rx,
+  rg,
+  rgx,
+  ra,
+  rgb,
+  rgbx,
+  rgba,
+  argb,
+  bgra,
+  intensity,
+  luminance,
+  abgr
+};
+
+
+/// The type of each channel of a texel
+enum class image_channel_type : char {
+  snorm_int8,
+  snorm_int16,
+  unorm_int8,
+  unorm_int16,
+  unorm_short_565,
+  unorm_short_555,
+  unorm_int_101010,
+  signed_int8,
+  signed_int16,
+  signed_int32,
+  unsigned_int8,
+  unsigned_int16,
+  unsigned_int32,
+  fp16,
+  fp32
+};
+
+namespace detail {
+
+/** The layout of a texel in memory and its conversions from and to a
+    4-element vector in the r, g, b, a order
+
+    The packed channel types are not supported.
+*/
+class texel_format {
+
+  image_channel_order order;
+
+  image_channel_type type;
+
+  /// The number of channels stored in memory
+  unsigned char channels;
+
+  /// The size in bytes of a channel
+  unsigned char channel_size;
+
+  /** The element of the r, g, b, a vector of each channel stored in
+      memory, or 4 for the ignored x channels
+  */
+  std::array<unsigned char, 4> slots;
+
+public:
+
+  texel_format(image_channel_order o, image_channel_type t)
+    : order { o }, type { t } {
+    using enum image_channel_order;
+    switch (o) {
+    case a: slots = { 3 }; channels = 1; break;
+    case r: case intensity: case luminance: slots = { 0 }; channels = 1; break;
+    case rx: slots = { 0, 4 }; channels = 2; break;
+    case rg: slots = { 0, 1 }; channels = 2; break;
+    case rgx: slots = { 0, 1, 4 }; channels = 3; break;
+    case ra: slots = { 0, 3 }; channels = 2; break;
+    case rgb: slots = { 0, 1, 2 }; channels = 3; break;
+    case rgbx: slots = { 0, 1, 2, 4 }; channels = 4; break;
+    case rgba: slots = { 0, 1, 2, 3 }; channels = 4; break;
+    case argb: slots = { 3, 0, 1, 2 }; channels = 4; break;
+    case bgra: slots = { 2, 1, 0, 3 }; channels = 4; break;
+    case abgr: slots = { 3, 2, 1, 0 }; channels = 4; break;
+    }
+    switch (t) {
+    case image_channel_type::unorm_short_565:
+    case image_channel_type::unorm_short_555:
+    case image_channel_type::unorm_int_101010:
+      throw feature_not_supported { "the packed image channel types are "
+                                    "not supported" };
+    case image_channel_type::snorm_int8:
+    case image_channel_type::unorm_int8:
+    case image_channel_type::signed_int8:
+    case image_channel_type::unsigned_int8:
+      channel_size = 1;
+      break;
+    case image_channel_type::snorm_int16:
+    case image_channel_type::unorm_int16:
+    case image_channel_type::signed_int16:
+    case image_channel_type::unsigned_int16:
+    case image_channel_type::fp16:
+      channel_size = 2;
+      break;
+    default:
+      channel_size = 4;
+    }
+  }
+
+
+  image_channel_order get_channel_order() const { return order; }
+
+
+  image_channel_type get_channel_type() const { return type; }
+
+
+  /// The size in bytes of a texel
+  std::size_t get_texel_size() const {
+    return std::size_t { channels }*channel_size;
+  }
+
+
+  /** The value read outside of the image with the clamp addressing
+      mode: a transparent black if there is an alpha channel and an
+      opaque one otherwise
+  */
+  template <typename T>
+  vec<T, 4> border() const {
+    using enum image_channel_order;
+    bool alpha = order == a || order == ra || order == rgba || order == argb
+      || order == bgra || order == abgr || order == intensity;
+    return make_vec<T>(0, 0, 0, alpha ? 0 : 1);
+  }
+
+
+  /// Read the texel at \p texel, the missing channels being 0 and
+  /// alpha 1
+  template <typename T>
+  vec<T, 4> load(const std::byte *texel) const {
+    auto v = make_vec<T>(0, 0, 0, 1);
+    if (order == image_channel_order::intensity) {
+      v[0] = v[1] = v[2] = v[3] = load_channel<T>(texel);
+      return v;
+    }
+    if (order == image_channel_order::luminance) {
+      v[0] = v[1] = v[2] = load_channel<T>(texel);
+      return v;
+    }
+    for (unsigned c = 0; c != channels; ++c)
+      if (slots[c] < 4)
+        v[slots[c]] = load_channel<T>(texel + c*channel_size);
+    return v;
+  }
+
+
+  /// Write \p v into the texel at \p texel
+  template <typename T>
+  void store(std::byte *texel, const vec<T, 4> &v) const {
+    for (unsigned c = 0; c != channels; ++c)
+      store_channel(texel + c*channel_size,
+                    slots[c] < 4 ? v[slots[c]] : T {});
+  }
+
+private:
+
+  template <typename T>
+  static vec<T, 4> make_vec(T r, T g, T b, T a) {
+    vec<T, 4> v;
+    v[0] = r;
+    v[1] = g;
+    v[2] = b;
+    v[3] = a;
+    return v;
+  }
+
+
+  /// Read a channel of type \p C
+  template <typename C>
+  static C raw(const std::byte *p) {
+    C c;
+    std::memcpy(&c, p, sizeof c);
+    return c;
+  }
+
+
+  /// Write a channel of type \p C
+  template <typename C>
+  static void raw(std::byte *p, C c) {
+    std::memcpy(p, &c, sizeof c);
+  }
+
+
+  /// Read the channel at \p p as a normalized, float or integer value
+  template <typename T>
+  T load_channel(const std::byte *p) const {
+    using enum image_channel_type;
+    switch (type) {
+    case snorm_int8:
+      return static_cast<T>(std::max(-1.f, raw<std::int8_t>(p)/127.f));
+    case snorm_int16:
+      return static_cast<T>(std::max(-1.f, raw<std::int16_t>(p)/32767.f));
+    case unorm_int8:
+      return static_cast<T>(raw<std::uint8_t>(p)/255.f);
+    case unorm_int16:
+      return static_cast<T>(raw<std::uint16_t>(p)/65535.f);
+    case signed_int8:
+      return static_cast<T>(raw<std::int8_t>(p));
+    case signed_int16:
+      return static_cast<T>(raw<std::int16_t>(p));
+    case signed_int32:
+      return static_cast<T>(raw<std::int32_t>(p));
+    case unsigned_int8:
+      return static_cast<T>(raw<std::uint8_t>(p));
+    case unsigned_int16:
+      return static_cast<T>(raw<std::uint16_t>(p));
+    case unsigned_int32:
+      return static_cast<T>(raw<std::uint32_t>(p));
+    case fp16:
+      return static_cast<T>(half_bits_to_float(raw<std::uint16_t>(p)));
+    default:
+      return static_cast<T>(raw<float>(p));
+    }
+  }
+
+
+  /// Saturate \p x to the range of the integer type \p C
+  template <typename C, typename T>
+  static C saturate(T x) {
+    if constexpr (std::is_floating_point_v<T>)
+      return static_cast<C>(std::clamp<double>(
+        std::nearbyint(x), std::numeric_limits<C>::min(),
+        std::numeric_limits<C>::max()));
+    else
+      return static_cast<C>(std::clamp<long long>(
+        x, std::numeric_limits<C>::min(), std::numeric_limits<C>::max()));
+  }
+
+
+  /// Write \p x into the channel at \p p, with saturation
+  template <typename T>
+  void store_channel(std::byte *p, T x) const {
+    using enum image_channel_type;
+    float f = static_cast<float>(x);
+    switch (type) {
+    case snorm_int8:
+      return raw(p, saturate<std::int8_t>(std::clamp(f, -1.f, 1.f)*127.f));
+    case snorm_int16:
+      return raw(p, saturate<std::int16_t>(std::clamp(f, -1.f, 1.f)
+                                           *32767.f));
+    case unorm_int8:
+      return raw(p, saturate<std::uint8_t>(std::clamp(f, 0.f, 1.f)*255.f));
+    case unorm_int16:
+      return raw(p, saturate<std::uint16_t>(std::clamp(f, 0.f, 1.f)
+                                            *65535.f));
+    case signed_int8:
+      return raw(p, saturate<std::int8_t>(x));
+    case signed_int16:
+      return raw(p, saturate<std::int16_t>(x));
+    case signed_int32:
+      return raw(p, saturate<std::int32_t>(x));
+    case unsigned_int8:
+      return raw(p, saturate<std::uint8_t>(x));
+    case unsigned_int16:
+      return raw(p, saturate<std::uint16_t>(x));
+    case unsigned_int32:
+      return raw(p, saturate<std::uint32_t>(x));
+    case fp16:
+      return raw(p, float_to_half_bits(f));
+    default:
+      return raw(p, f);
+    }
+  }
+
+};
+
+}
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_IMAGE_DETAIL_TEXEL_FORMAT_HPP
@@ -12,6 +12,7 @@
 #include "triSYCL/id.hpp"
 #include "triSYCL/opencl_types.hpp"
 #include "triSYCL/info/param_traits.hpp"
+#include "triSYCL/vendor/triSYCL/latency_histogram.hpp"
 
 namespace trisycl::info {
 
@@ -23,11 +24,21 @@ enum class queue : int {
   context,
   device,
   reference_count,
+  /** The histogram of the latencies from the submission to the start
+      of the command groups, as a triSYCL extension
+  */
+  submit_to_start_latency,
+  /// The histogram of the execution times of the command groups
+  start_to_end_latency,
 };
 
 TRISYCL_INFO_PARAM_TRAITS(queue::context, trisycl::context)
 TRISYCL_INFO_PARAM_TRAITS(queue::device, trisycl::device)
 TRISYCL_INFO_PARAM_TRAITS(queue::reference_count, trisycl::cl_uint)
+TRISYCL_INFO_PARAM_TRAITS(queue::submit_to_start_latency,
+                          vendor::trisycl::latency_histogram)
+TRISYCL_INFO_PARAM_TRAITS(queue::start_to_end_latency,
+                          vendor::trisycl::latency_histogram)
 
 }
 #endif
@@ -36,6 +36,10 @@ private:
   range<Dimensions> global_range;
   id<Dimensions> global_index;
   id<Dimensions> offset;
+  /// The strides of the range, to linearize without multiplication chain
+  detail::linear_strides<Dimensions> strides;
+  /// The linear id of the index, the offset being subtracted
+  size_t linear_id;
 
 public:
 
@@ -47,9 +51,43 @@ public:
   item(range<Dimensions> global_size,
        id<Dimensions> global_index,
        id<Dimensions> offset = {}) :
+    item { global_size, global_index, offset,
+           detail::linear_strides<Dimensions> { global_size } }
+  {}
+
+
+  /** Create an item with the strides of its range already computed
+
+      This is used by the triSYCL implementation to compute the strides
+      only once for all the work-items of a range.
+  */
+  item(range<Dimensions> global_size,
+       id<Dimensions> global_index,
+       id<Dimensions> offset,
+       const detail::linear_strides<Dimensions> &strides) :
+    global_range { global_size },
+    global_index { global_index },
+    offset { offset },
+    strides { strides },
+    linear_id { strides(global_index) - strides(offset) }
+  {}
+
+
+  /** Create an item with its linear id already computed
+
+      This is used by the triSYCL implementation to advance the linear
+      ids incrementally along the work-items of a range.
+  */
+  item(range<Dimensions> global_size,
+       id<Dimensions> global_index,
+       id<Dimensions> offset,
+       const detail::linear_strides<Dimensions> &strides,
+       size_t linear_id) :
     global_range { global_size },
     global_index { global_index },
-    offset { offset }
+    offset { offset },
+    strides { strides },
+    linear_id { linear_id }
   {}
 
 
@@ -72,10 +110,12 @@ public:
   size_t get_id(int dimension) const { return get_id()[dimension]; }
 
 
-  /** Return the constituent id<> l-value representing the work-item's
+  /** Return the constituent id<> value representing the work-item's
       position in the iteration space in the given dimension
+
+      It is not an l-value, to keep the linear id up to date.
   */
-  auto &operator[](int dimension) { return global_index[dimension]; }
+  size_t operator[](int dimension) const { return global_index[dimension]; }
 
 
   /** Returns a range<> representing the dimensions of the range of
@@ -101,10 +141,11 @@ public:
 
   /** Return the linearized ID in the item's range
 
-      Computed as the flatted ID after the offset is subtracted.
+      Computed as the flatted ID after the offset is subtracted, when
+      the item is created.
   */
   size_t get_linear_id() const {
-    return detail::linear_id(get_range(), get_id(), get_offset());
+    return linear_id;
   }
 
 
@@ -112,7 +153,10 @@ public:
 
       \todo Move to private and add friends
   */
-  void set(id<Dimensions> Index) { global_index = Index; }
+  void set(id<Dimensions> Index) {
+    global_index = Index;
+    linear_id = strides(global_index) - strides(offset);
+  }
 
   /** Returns an item with same dimensions but offset set to 0 */
   operator item<Dimensions, true> () const {
@@ -17,6 +17,7 @@
 #include "triSYCL/detail/unimplemented.hpp"
 //#include "triSYCL/info/kernel.hpp"
 #include "triSYCL/queue/detail/queue.hpp"
+#include "triSYCL/nd_range.hpp"
 #include "triSYCL/range.hpp"
 
 namespace trisycl::detail {
@@ -44,6 +45,18 @@ class kernel : detail::debug<detail::kernel> {
       This is an extension.
   */
   virtual boost::compute::kernel &get_boost_compute() = 0;
+
+
+  /** Set an argument of the kernel from the \p size bytes at \p
+      value, or as some local memory of \p size bytes if \p value is
+      nullptr
+  */
+  virtual void set_arg(std::size_t index, std::size_t size,
+                       const void *value) = 0;
+
+
+  /// Forget the value of an argument set directly with Boost.Compute
+  virtual void forget_arg(std::size_t index) = 0;
 #endif
 
 
@@ -68,6 +81,20 @@ class kernel : detail::debug<detail::kernel> {
 #undef TRISYCL_ParallelForKernel_RANGE
 
 
+  /** Launch a kernel with an nd_range<>, giving its local size and
+      its offset
+  */
+#define TRISYCL_ParallelForKernel_ND_RANGE(N)                     \
+  virtual void parallel_for(std::shared_ptr<detail::task> task,   \
+                            std::shared_ptr<detail::queue> q,     \
+                            const nd_range<N> &r) = 0;
+
+  TRISYCL_ParallelForKernel_ND_RANGE(1)
+  TRISYCL_ParallelForKernel_ND_RANGE(2)
+  TRISYCL_ParallelForKernel_ND_RANGE(3)
+#undef TRISYCL_ParallelForKernel_ND_RANGE
+
+
   /// Return the context that this kernel is defined for
   //virtual context get_context() const;
 
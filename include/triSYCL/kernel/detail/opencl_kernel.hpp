@@ -9,6 +9,11 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
 #endif
@@ -18,11 +23,16 @@
 #include "triSYCL/detail/unimplemented.hpp"
 //#include "triSYCL/info/kernel.hpp"
 #include "triSYCL/kernel/detail/kernel.hpp"
+#include "triSYCL/kernel/detail/work_group_tuner.hpp"
 #include "triSYCL/queue/detail/queue.hpp"
 
 
 namespace trisycl::detail {
 
+inline boost::compute::wait_list take_transfers(detail::task &t);
+inline void set_kernel_event(detail::task &t,
+                             const boost::compute::event &e);
+
 /// An abstraction of the OpenCL kernel
 class opencl_kernel : public detail::kernel,
                       detail::debug<opencl_kernel> {
@@ -33,9 +43,20 @@ class opencl_kernel : public detail::kernel,
   /** A cache to always return the same alive kernel for a given
       OpenCL kernel
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
+  */
+  static auto &cache() {
+    static auto c = new detail::cache<cl_kernel, detail::opencl_kernel>;
+    return *c;
+  }
+
+  /** The bytes of the latest value set for each argument, empty if
+      unknown, to skip setting it again with the same value
   */
-  static detail::cache<cl_kernel, detail::opencl_kernel> cache;
+  std::vector<std::vector<std::byte>> arguments;
 
   opencl_kernel(const boost::compute::kernel &k) : k { k } {}
 
@@ -44,8 +65,8 @@ class opencl_kernel : public detail::kernel,
   ///// Get a singleton instance of the opencl_device
   static std::shared_ptr<opencl_kernel>
   instance(const boost::compute::kernel &k) {
-    return cache.get_or_register(k.get(),
-                                 [&] { return new opencl_kernel { k }; });
+    return cache().get_or_register(k.get(),
+                                   [&] { return new opencl_kernel { k }; });
   }
 
   /** Return the underlying OpenCL object
@@ -69,6 +90,36 @@ class opencl_kernel : public detail::kernel,
   }
 
 
+  /** Set an argument of the kernel, unless it has already this value
+
+      This saves a clSetKernelArg() per argument when a kernel is
+      launched again with the same buffers and scalars.
+  */
+  void set_arg(std::size_t index, std::size_t size,
+               const void *value) override {
+    if (index >= arguments.size())
+      arguments.resize(index + 1);
+    auto &latest = arguments[index];
+    auto bytes = static_cast<const std::byte *>(value);
+    if (value && latest.size() == size
+        && std::equal(bytes, bytes + size, latest.begin()))
+      return;
+    k.set_arg(index, size, value);
+    if (value)
+      latest.assign(bytes, bytes + size);
+    else
+      // Some local memory has no value to compare with
+      latest.clear();
+  }
+
+
+  /// Forget the value of an argument set directly with Boost.Compute
+  void forget_arg(std::size_t index) override {
+    if (index < arguments.size())
+      arguments[index].clear();
+  }
+
+
   //context get_context() const override
 
   //program get_program() const override
@@ -88,10 +139,61 @@ class opencl_kernel : public detail::kernel,
    */
   void single_task(std::shared_ptr<detail::task> task,
                    std::shared_ptr<detail::queue> q) override {
-    q->get_boost_compute().enqueue_task(k);
-    /* For now use a crude synchronization mechanism to map directly a
-       host task to an accelerator task */
-    q->get_boost_compute().finish();
+    /* Start once the buffers are transferred, the task completing on
+       the event of the kernel without draining the queue */
+    set_kernel_event(*task, q->get_boost_compute()
+                     .enqueue_task(k, take_transfers(*task)));
+  }
+
+
+  /** Launch an OpenCL kernel with a range<>
+
+      The local size is left to the OpenCL driver, unless it is tuned
+      by the work_group_tuner.
+  */
+  template <int N>
+  void launch(std::shared_ptr<detail::task> task,
+              std::shared_ptr<detail::queue> q,
+              const range<N> &num_work_items) {
+    static_assert(sizeof(typename range<N>::value_type) == sizeof(size_t),
+                  "num_work_items::value_type compatible with "
+                  "Boost.Compute");
+    auto &cq = q->get_boost_compute();
+    auto global = static_cast<const size_t*>(num_work_items.data());
+    if (!work_group_tuner::is_enabled()) {
+      // Start once the buffers are transferred
+      set_kernel_event(*task, cq.enqueue_nd_range_kernel
+                       (k, N, NULL, global, NULL, take_transfers(*task)));
+      return;
+    }
+    auto &tuner = work_group_tuner::instance();
+    auto device = cq.get_device();
+    auto key = work_group_tuner::key(k.name(), device.name(), N, global);
+    auto c = tuner.choose(key, [&] {
+        return work_group_tuner::candidates(
+          N, global,
+          k.get_work_group_info<std::size_t>(
+            device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE),
+          k.get_work_group_info<std::size_t>(device,
+                                             CL_KERNEL_WORK_GROUP_SIZE));
+      });
+    auto start = std::chrono::steady_clock::now();
+    auto e = cq.enqueue_nd_range_kernel(k, N, NULL, global,
+                                        c.local[0] ? c.local.data() : NULL,
+                                        take_transfers(*task));
+    if (c.trial >= 0) {
+      // Measure the candidate by the device if possible
+      e.wait();
+      std::chrono::duration<double> time =
+        std::chrono::steady_clock::now() - start;
+      try {
+        time = e.duration<std::chrono::nanoseconds>();
+      } catch (const boost::compute::opencl_error &) {
+        // The queue does not record the timestamps
+      }
+      tuner.record(key, c, time.count());
+    }
+    set_kernel_event(*task, e);
   }
 
 
@@ -107,18 +209,7 @@ class opencl_kernel : public detail::kernel,
   void parallel_for(std::shared_ptr<detail::task> task,                 \
                     std::shared_ptr<detail::queue> q,                   \
                     const range<N> &num_work_items) override {          \
-    static_assert(sizeof(range<N>::value_type) == sizeof(size_t),       \
-                  "num_work_items::value_type compatible with "         \
-                  "Boost.Compute");                                     \
-    q->get_boost_compute().enqueue_nd_range_kernel                      \
-      (k,                                                               \
-       static_cast<size_t>(N),                                          \
-       NULL,                                                            \
-       static_cast<const size_t*>(num_work_items.data()),               \
-       NULL);                                                           \
-    /* For now use a crude synchronization mechanism to map directly a  \
-       host task to an accelerator task */                              \
-    q->get_boost_compute().finish();                                    \
+    launch(task, q, num_work_items);                                    \
   };
 
   TRISYCL_ParallelForKernel_RANGE(1)
@@ -127,21 +218,40 @@ class opencl_kernel : public detail::kernel,
 #undef TRISYCL_ParallelForKernel_RANGE
 
 
+  /** Launch an OpenCL kernel with an nd_range<>, with its explicit
+      local size and offset
+  */
+#define TRISYCL_ParallelForKernel_ND_RANGE(N)                           \
+  void parallel_for(std::shared_ptr<detail::task> task,                 \
+                    std::shared_ptr<detail::queue> q,                   \
+                    const nd_range<N> &r) override {                    \
+    auto global = r.get_global_range();                                 \
+    auto local = r.get_local_range();                                   \
+    auto offset = r.get_offset();                                       \
+    set_kernel_event(*task, q->get_boost_compute()                      \
+                     .enqueue_nd_range_kernel                           \
+      (k,                                                               \
+       static_cast<size_t>(N),                                          \
+       static_cast<const size_t*>(offset.data()),                       \
+       static_cast<const size_t*>(global.data()),                       \
+       static_cast<const size_t*>(local.data()),                        \
+       /* Start once the buffers are transferred */                     \
+       take_transfers(*task)));                                         \
+  };
+
+  TRISYCL_ParallelForKernel_ND_RANGE(1)
+  TRISYCL_ParallelForKernel_ND_RANGE(2)
+  TRISYCL_ParallelForKernel_ND_RANGE(3)
+#undef TRISYCL_ParallelForKernel_ND_RANGE
+
+
   /// Unregister from the cache on destruction
   ~opencl_kernel() override {
-    cache.remove(k.get());
+    cache().remove(k.get());
   }
 
 };
 
-/* Allocate the cache here but since this is a pure-header library,
-   use a weak symbol so that only one remains when SYCL headers are
-   used in different compilation units of a program
-*/
-TRISYCL_WEAK_ATTRIB_PREFIX
-detail::cache<cl_kernel, detail::opencl_kernel> opencl_kernel::cache
-TRISYCL_WEAK_ATTRIB_SUFFIX;
-
 }
 
 /*
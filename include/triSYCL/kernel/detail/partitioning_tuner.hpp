@@ -0,0 +1,373 @@
+#ifndef TRISYCL_SYCL_KERNEL_DETAIL_PARTITIONING_TUNER_HPP
+#define TRISYCL_SYCL_KERNEL_DETAIL_PARTITIONING_TUNER_HPP
+
+/** \file Choose the partitioning of the host kernels by trying some
+    candidates
+
+    When the \c TRISYCL_AUTOTUNE environment variable is set, the first
+    launches of a parallel_for kernel on a given range try in turn the
+    partitioning of its queue and some variations of the knobs used by
+    the parallelism back-end: the OpenMP schedule and chunk size, the
+    TBB partitioner and grain size or the work stealing grain size,
+    and the tiled iteration order for 2D and 3D kernels. Once each
+    candidate has been measured a few times, the fastest one is used by
+    all the next launches.
+
+    The winners are kept in the file named by \c TRISYCL_AUTOTUNE_FILE,
+    next to the local sizes of the OpenCL kernels. When only this
+    variable is set, the production runs just apply the winners found
+    by the tuning runs, without trying anything.
+
+    A command group choosing explicitly its partitioning, for example
+    with handler::set_schedule(), is not tuned.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/range.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The autotuning of the partitioning of the host kernels
+class partitioning_tuner {
+
+public:
+
+  /// The knobs of a partitioning explored by the tuner
+  struct settings {
+    partitioning::schedule scheduling;
+    std::size_t chunk_size;
+    partitioning::kind partitioner;
+    std::size_t grain_size;
+    partitioning::order iteration;
+
+    /// Get the settings of a partitioning
+    static settings of(const partitioning &p) {
+      return { p.scheduling, p.chunk_size, p.partitioner, p.grain_size,
+               p.iteration };
+    }
+
+    /// Apply the settings to a partitioning
+    partitioning apply(partitioning p) const {
+      p.scheduling = scheduling;
+      p.chunk_size = chunk_size;
+      p.partitioner = partitioner;
+      p.grain_size = grain_size;
+      p.iteration = iteration;
+      return p;
+    }
+  };
+
+
+  /// The settings to use for a launch
+  struct choice {
+    settings knobs;
+
+    /// The candidate tried by this launch, or -1 once tuned
+    int trial = -1;
+  };
+
+
+  /// Number of measures of each candidate, the best one being kept
+  static constexpr std::size_t trials = 2;
+
+private:
+
+  /// The tuning of a kernel on a range
+  struct tuning {
+    std::vector<settings> candidates;
+
+    /// The best time in seconds measured for each candidate so far
+    std::vector<double> best;
+
+    /// Number of launches trying a candidate
+    std::size_t launches = 0;
+
+    /// Number of measures recorded
+    std::size_t measures = 0;
+
+    /// The fastest settings, once all the candidates are measured
+    std::optional<settings> winner;
+  };
+
+  /// To protect all the members
+  std::mutex m;
+
+  /// The tunings indexed by kernel and range
+  std::map<std::string, tuning> tunings;
+
+  /// The file keeping the winners across runs, if any
+  const char *file = std::getenv("TRISYCL_AUTOTUNE_FILE");
+
+  /// The tag of the lines of the file written by this tuner
+  static constexpr const char *tag = "partitioning";
+
+
+  /// Read the winners found by the previous runs
+  partitioning_tuner() {
+    if (!file)
+      return;
+    std::ifstream in { file };
+    std::string line;
+    while (std::getline(in, line)) {
+      auto tab = line.find('\t');
+      if (tab == std::string::npos)
+        continue;
+      std::istringstream values { line.substr(tab + 1) };
+      std::string t;
+      int s, k, o;
+      settings w;
+      // Skip the lines of the other tuners
+      if (values >> t >> s >> w.chunk_size >> k >> w.grain_size >> o
+          && t == tag) {
+        w.scheduling = static_cast<partitioning::schedule>(s);
+        w.partitioner = static_cast<partitioning::kind>(k);
+        w.iteration = static_cast<partitioning::order>(o);
+        tunings[line.substr(0, tab)].winner = w;
+      }
+    }
+  }
+
+
+  /// Choose the fastest candidate of a tuning and keep it
+  void decide(const std::string &key, tuning &t) {
+    std::size_t fastest = 0;
+    for (std::size_t c = 1; c != t.candidates.size(); ++c)
+      if (t.best[c] < t.best[fastest])
+        fastest = c;
+    t.winner = t.candidates[fastest];
+    if (file) {
+      auto &w = *t.winner;
+      std::ofstream { file, std::ios::app }
+        << key << '\t' << tag << ' ' << static_cast<int>(w.scheduling)
+        << ' ' << w.chunk_size << ' ' << static_cast<int>(w.partitioner)
+        << ' ' << w.grain_size << ' ' << static_cast<int>(w.iteration)
+        << '\n';
+    }
+  }
+
+public:
+
+  /// Test whether the candidates are tried, with \c TRISYCL_AUTOTUNE
+  static bool is_exploring() {
+    static const bool exploring = std::getenv("TRISYCL_AUTOTUNE");
+    return exploring;
+  }
+
+
+  /** Test whether the partitioning of the kernels is tuned, or just
+      taken from the winners of the previous runs
+  */
+  static bool is_enabled() {
+    static const bool enabled =
+      is_exploring() || std::getenv("TRISYCL_AUTOTUNE_FILE");
+    return enabled;
+  }
+
+
+  /// Get the tuner of the program, never destroyed
+  static partitioning_tuner &instance() {
+    static auto t = new partitioning_tuner;
+    return *t;
+  }
+
+
+  /** Get the key of a tuning, without any tabulation or new line
+
+      The host is named as a device, so the kernels also tuned on an
+      OpenCL device do not collide.
+  */
+  template <int Dimensions>
+  static std::string key(const std::string &kernel,
+                         const range<Dimensions> &r) {
+    std::ostringstream k;
+    k << kernel << "@host";
+    for (int d = 0; d != Dimensions; ++d)
+      k << (d ? 'x' : ':') << r[d];
+    auto s = k.str();
+    for (auto &c : s)
+      if (c == '\t' || c == '\n')
+        c = ' ';
+    return s;
+  }
+
+
+  /** Get the candidate settings for a kernel on a range, starting
+      from the partitioning \p base of its queue
+
+      Only the knobs used by the back-end compiled in are explored.
+  */
+  template <int Dimensions>
+  static std::vector<settings> candidates(const partitioning &base,
+                                          const range<Dimensions> &r) {
+    auto s = settings::of(base);
+    std::vector<settings> c { s };
+    auto threads =
+      std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    auto add = [&] (auto change) {
+      auto v = s;
+      change(v);
+      c.push_back(v);
+    };
+    // Some chunks smaller than the default ones, for load balancing
+#if defined(TRISYCL_WORK_STEALING)
+    auto grain = std::max<std::size_t>(1, r[Dimensions - 1]/(8*threads));
+    for (auto g : { grain, 4*grain })
+      if (g != s.grain_size)
+        add([&] (auto &v) { v.grain_size = g; });
+#elif defined(TRISYCL_TBB)
+    auto grain = std::max<std::size_t>(1, r[Dimensions - 1]/(8*threads));
+    using kind = partitioning::kind;
+    for (auto k : { kind::auto_partitioner, kind::static_partitioner,
+                    kind::affinity_partitioner })
+      if (k != s.partitioner)
+        add([&] (auto &v) { v.partitioner = k; });
+    add([&] (auto &v) {
+        v.partitioner = kind::simple_partitioner;
+        v.grain_size = grain;
+      });
+#else
+    auto rows = std::max<std::size_t>(1, r[0]/(8*threads));
+    using schedule = partitioning::schedule;
+    if (s.scheduling != schedule::static_schedule || s.chunk_size)
+      add([&] (auto &v) {
+          v.scheduling = schedule::static_schedule;
+          v.chunk_size = 0;
+        });
+    add([&] (auto &v) {
+        v.scheduling = schedule::dynamic_schedule;
+        v.chunk_size = rows;
+      });
+    add([&] (auto &v) {
+        v.scheduling = schedule::guided_schedule;
+        v.chunk_size = 0;
+      });
+#endif
+    if constexpr (Dimensions > 1)
+      // The tiles may keep more data in the caches
+      add([&] (auto &v) {
+          v.iteration = v.iteration == partitioning::order::row_major
+            ? partitioning::order::tiled : partitioning::order::row_major;
+        });
+    return c;
+  }
+
+
+  /** Choose the settings of a launch
+
+      \param[in] make_candidates is called to get the candidates on
+      the first launch with this key
+
+      \return the winner, a candidate to try, or nothing to keep the
+      partitioning of the queue
+  */
+  template <typename Candidates>
+  std::optional<choice> choose(const std::string &key,
+                               Candidates make_candidates) {
+    std::lock_guard lg { m };
+    if (!is_exploring()) {
+      if (auto t = tunings.find(key);
+          t != tunings.end() && t->second.winner)
+        return choice { *t->second.winner };
+      return {};
+    }
+    auto &t = tunings[key];
+    if (t.winner)
+      return choice { *t.winner };
+    if (t.candidates.empty()) {
+      t.candidates = make_candidates();
+      t.best.assign(t.candidates.size(),
+                    std::numeric_limits<double>::infinity());
+    }
+    // Some launches may still be measured while all are tried
+    if (t.launches == trials*t.candidates.size())
+      return {};
+    auto c = t.launches++ % t.candidates.size();
+    return choice { t.candidates[c], static_cast<int>(c) };
+  }
+
+
+  /// Record the time in seconds of a launch trying a candidate
+  void record(const std::string &key, const choice &c, double seconds) {
+    if (c.trial < 0)
+      return;
+    std::lock_guard lg { m };
+    auto &t = tunings[key];
+    if (t.winner)
+      return;
+    t.best[c.trial] = std::min(t.best[c.trial], seconds);
+    if (++t.measures == trials*t.candidates.size())
+      decide(key, t);
+  }
+
+
+  /// Get the settings tuned for a key, if any
+  std::optional<settings> get_winner(const std::string &key) {
+    std::lock_guard lg { m };
+    if (auto t = tunings.find(key); t != tunings.end())
+      return t->second.winner;
+    return {};
+  }
+
+
+  /** Launch a kernel named \p kernel on the range \p r with the
+      partitioning tuned for them, measuring it while tuning
+
+      \param[in] launch executes the loop nests of the kernel with the
+      current partitioning
+  */
+  template <int Dimensions, typename Launch>
+  void run(const char *kernel, const range<Dimensions> &r, Launch &launch) {
+    auto outer = partitioning::current();
+    auto base = outer ? *outer : partitioning {};
+    auto k = key(kernel, r);
+    auto c = choose(k, [&] { return candidates(base, r); });
+    if (!c) {
+      launch();
+      return;
+    }
+    auto tuned = c->knobs.apply(base);
+    partitioning::current() = &tuned;
+    auto start = std::chrono::steady_clock::now();
+    launch();
+    std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - start;
+    partitioning::current() = outer;
+    record(k, *c, time.count());
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_KERNEL_DETAIL_PARTITIONING_TUNER_HPP
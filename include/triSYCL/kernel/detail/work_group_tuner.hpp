@@ -0,0 +1,249 @@
+#ifndef TRISYCL_SYCL_KERNEL_DETAIL_WORK_GROUP_TUNER_HPP
+#define TRISYCL_SYCL_KERNEL_DETAIL_WORK_GROUP_TUNER_HPP
+
+/** \file Choose the local work size of the OpenCL kernels by trying
+    some candidates
+
+    When the \c TRISYCL_AUTOTUNE environment variable is set, the first
+    launches of a kernel with a given global size on a device try in
+    turn the local size chosen by the OpenCL driver and some multiples
+    of the preferred work-group size multiple of the kernel. Once each
+    candidate has been measured a few times, the fastest one is used by
+    all the next launches. The winners are kept in the file named by
+    \c TRISYCL_AUTOTUNE_FILE, if any, to be reused by the next runs,
+    next to the partitionings tuned for the host kernels.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The autotuning of the local work sizes of the kernels
+class work_group_tuner {
+
+public:
+
+  /// Some work sizes, with 1 in the unused dimensions
+  using sizes = std::array<std::size_t, 3>;
+
+
+  /// The local size to use for a launch
+  struct choice {
+    /// The local size, all 0 to let the OpenCL driver choose
+    sizes local;
+
+    /// The candidate tried by this launch, or -1 once tuned
+    int trial = -1;
+  };
+
+
+  /// Number of measures of each candidate, the best one being kept
+  static constexpr std::size_t trials = 2;
+
+private:
+
+  /// The tuning of a kernel for a global size on a device
+  struct tuning {
+    std::vector<sizes> candidates;
+
+    /// The best time in seconds measured for each candidate so far
+    std::vector<double> best;
+
+    /// Number of launches trying a candidate
+    std::size_t launches = 0;
+
+    /// Number of measures recorded
+    std::size_t measures = 0;
+
+    /// The fastest local size, once all the candidates are measured
+    std::optional<sizes> winner;
+  };
+
+
+  /// To protect all the members
+  std::mutex m;
+
+  /// The tunings indexed by kernel, device and global size
+  std::map<std::string, tuning> tunings;
+
+  /// The file keeping the winners across runs, if any
+  const char *file = std::getenv("TRISYCL_AUTOTUNE_FILE");
+
+
+  /// Read the winners found by the previous runs
+  work_group_tuner() {
+    if (!file)
+      return;
+    std::ifstream in { file };
+    std::string line;
+    while (std::getline(in, line)) {
+      auto tab = line.find('\t');
+      if (tab == std::string::npos)
+        continue;
+      std::istringstream values { line.substr(tab + 1) };
+      sizes local;
+      // Skip the lines of the partitioning_tuner of the host kernels
+      if (values >> local[0] >> local[1] >> local[2])
+        tunings[line.substr(0, tab)].winner = local;
+    }
+  }
+
+
+  /// Choose the fastest candidate of a tuning and keep it
+  void decide(const std::string &key, tuning &t) {
+    std::size_t fastest = 0;
+    for (std::size_t c = 1; c != t.candidates.size(); ++c)
+      if (t.best[c] < t.best[fastest])
+        fastest = c;
+    t.winner = t.candidates[fastest];
+    if (file)
+      std::ofstream { file, std::ios::app }
+        << key << '\t' << (*t.winner)[0] << ' ' << (*t.winner)[1] << ' '
+        << (*t.winner)[2] << '\n';
+  }
+
+public:
+
+  /// Test whether the local sizes are tuned
+  static bool is_enabled() {
+    static const bool enabled = std::getenv("TRISYCL_AUTOTUNE");
+    return enabled;
+  }
+
+
+  /// Get the tuner of the program, never destroyed
+  static work_group_tuner &instance() {
+    static auto t = new work_group_tuner;
+    return *t;
+  }
+
+
+  /** Get the key of a tuning, without any tabulation or new line
+
+      \param[in] dimensions is the number of dimensions used of the
+      \p global sizes
+  */
+  static std::string key(const std::string &kernel,
+                         const std::string &device,
+                         int dimensions,
+                         const std::size_t *global) {
+    std::ostringstream k;
+    k << kernel << '@' << device;
+    for (int d = 0; d != dimensions; ++d)
+      k << (d ? 'x' : ':') << global[d];
+    auto s = k.str();
+    for (auto &c : s)
+      if (c == '\t' || c == '\n')
+        c = ' ';
+    return s;
+  }
+
+
+  /** Get the candidate local sizes for a global size
+
+      The first candidate is the choice of the OpenCL driver. The
+      other ones have a work-group size of the preferred \p multiple
+      times a power of 2, up to \p max_size, dividing the global size
+      in each dimension as required by OpenCL 1.x.
+  */
+  static std::vector<sizes> candidates(int dimensions,
+                                       const std::size_t *global,
+                                       std::size_t multiple,
+                                       std::size_t max_size) {
+    std::vector<sizes> c { { 0, 0, 0 } };
+    for (auto size = std::max<std::size_t>(multiple, 1); size <= max_size;
+         size *= 2) {
+      sizes local { 1, 1, 1 };
+      auto left = size;
+      // Put as many work-items as possible in the first dimensions
+      for (int d = 0; d != dimensions; ++d) {
+        local[d] = std::gcd(left, global[d]);
+        left /= local[d];
+      }
+      if (left == 1)
+        c.push_back(local);
+    }
+    return c;
+  }
+
+
+  /** Choose the local size of a launch
+
+      \param[in] make_candidates is called to get the candidates on
+      the first launch with this key
+  */
+  template <typename Candidates>
+  choice choose(const std::string &key, Candidates make_candidates) {
+    std::lock_guard lg { m };
+    auto &t = tunings[key];
+    if (t.winner)
+      return { *t.winner };
+    if (t.candidates.empty()) {
+      t.candidates = make_candidates();
+      t.best.assign(t.candidates.size(),
+                    std::numeric_limits<double>::infinity());
+    }
+    // Some launches may still be measured while all are tried
+    if (t.launches == trials*t.candidates.size())
+      return { t.candidates.front() };
+    auto c = t.launches++ % t.candidates.size();
+    return { t.candidates[c], static_cast<int>(c) };
+  }
+
+
+  /// Record the time in seconds of a launch trying a candidate
+  void record(const std::string &key, const choice &c, double seconds) {
+    if (c.trial < 0)
+      return;
+    std::lock_guard lg { m };
+    auto &t = tunings[key];
+    if (t.winner)
+      return;
+    t.best[c.trial] = std::min(t.best[c.trial], seconds);
+    if (++t.measures == trials*t.candidates.size())
+      decide(key, t);
+  }
+
+
+  /// Get the local size tuned for a key, if any
+  std::optional<sizes> get_winner(const std::string &key) {
+    std::lock_guard lg { m };
+    if (auto t = tunings.find(key); t != tunings.end())
+      return t->second.winner;
+    return {};
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_KERNEL_DETAIL_WORK_GROUP_TUNER_HPP
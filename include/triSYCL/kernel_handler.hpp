@@ -0,0 +1,129 @@
+#ifndef TRISYCL_SYCL_KERNEL_HANDLER_HPP
+#define TRISYCL_SYCL_KERNEL_HANDLER_HPP
+
+/** \file The SYCL kernel_handler, giving a kernel the values of the
+    specialization constants
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "triSYCL/kernel_handler/detail/specialization_constants.hpp"
+#include "triSYCL/specialization_id.hpp"
+
+namespace trisycl {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** Give a kernel the values of the specialization constants set by its
+    command group
+
+    A kernel gets it as its last parameter:
+    \code
+    cgh.set_specialization_constant<width>(5);
+    cgh.parallel_for(range<1> { n }, [=] (item<1> i, kernel_handler h) {
+        auto w = h.get_specialization_constant<width>();
+        ...
+      });
+    \endcode
+*/
+class kernel_handler {
+  /// The values set by the command group, if any
+  std::shared_ptr<const detail::specialization_constants> values;
+
+public:
+
+  /** Create a kernel_handler giving some values
+
+      This is for the triSYCL implementation and should be hidden to
+      the user.
+  */
+  kernel_handler(std::shared_ptr<const detail::specialization_constants> v =
+                 {}) : values { std::move(v) } {}
+
+
+  /// Get the value of a specialization constant
+  template <auto &SpecName>
+  typename std::remove_reference_t<decltype(SpecName)>::value_type
+  get_specialization_constant() const {
+    if (values)
+      return values->get(SpecName);
+    return detail::specialization_constants {}.get(SpecName);
+  }
+};
+
+namespace detail {
+
+/// Get the index type of a kernel functor taking a kernel_handler
+template <typename F, typename R, typename A>
+A kernel_handler_index(R (F::*)(A, kernel_handler) const);
+
+template <typename F, typename R, typename A>
+A kernel_handler_index(R (F::*)(A, kernel_handler));
+
+
+/** A kernel functor called with a kernel_handler after its index, seen
+    by the runtime as a kernel functor taking only the index
+*/
+template <typename Kernel, typename Index>
+struct kernel_with_handler {
+  Kernel kernel;
+
+  kernel_handler handler;
+
+  void operator()(Index index) const {
+    kernel(index, handler);
+  }
+};
+
+
+/// A single_task kernel functor called with a kernel_handler
+template <typename Kernel>
+struct kernel_with_handler<Kernel, void> {
+  Kernel kernel;
+
+  kernel_handler handler;
+
+  void operator()() const {
+    kernel(handler);
+  }
+};
+
+
+/** Give a kernel_handler to a kernel functor taking one, or return the
+    kernel functor as is
+*/
+template <typename Kernel>
+auto bind_kernel_handler(Kernel kernel, const kernel_handler &handler) {
+  if constexpr (std::is_invocable_v<const Kernel &, kernel_handler>)
+    return kernel_with_handler<Kernel, void> { std::move(kernel), handler };
+  else if constexpr (requires {
+      kernel_handler_index(&Kernel::operator()); }) {
+    using index = std::remove_cvref_t<
+      decltype(kernel_handler_index(&Kernel::operator()))>;
+    return kernel_with_handler<Kernel, index> { std::move(kernel), handler };
+  } else
+    return kernel;
+}
+
+}
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_KERNEL_HANDLER_HPP
@@ -0,0 +1,57 @@
+#ifndef TRISYCL_SYCL_KERNEL_HANDLER_DETAIL_SPECIALIZATION_CONSTANTS_HPP
+#define TRISYCL_SYCL_KERNEL_HANDLER_DETAIL_SPECIALIZATION_CONSTANTS_HPP
+
+/** \file The values of the specialization constants of a command group
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <any>
+#include <unordered_map>
+
+#include "triSYCL/specialization_id.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** The values set by a command group for some specialization
+    constants, indexed by the address of their specialization_id
+*/
+class specialization_constants {
+  std::unordered_map<const void *, std::any> values;
+
+public:
+
+  /// Set the value of a specialization constant
+  template <typename T>
+  void set(const specialization_id<T> &id, const T &value) {
+    values.insert_or_assign(&id, value);
+  }
+
+
+  /// Get the value of a specialization constant, or its default one
+  template <typename T>
+  T get(const specialization_id<T> &id) const {
+    if (auto v = values.find(&id); v != values.end())
+      return std::any_cast<const T &>(v->second);
+    return id.default_value;
+  }
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_KERNEL_HANDLER_DETAIL_SPECIALIZATION_CONSTANTS_HPP
@@ -11,8 +11,14 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <type_traits>
+
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+#include <immintrin.h>
+#endif
 
 #include "vec.hpp"
+#include "triSYCL/detail/vector_math.hpp"
 
 // Include order and configure insensitive treating of unwanted macros
 #ifdef _MSC_VER
@@ -121,6 +127,15 @@ namespace trisycl {
 }
 
 
+/** Declare the vectorized version of FUN for the float vec with a native
+    vector type, which is more specialized than the element-wise one */
+#define TRISYCL_VECTOR_MATH(FUN) template <int size>                    \
+  requires detail::has_native_vector_v<vec<float, size>>                \
+  auto FUN(const vec<float, size>& x) {                                 \
+    return detail::vector_math<size>::FUN(x);                           \
+  }
+
+
 TRISYCL_MATH_WRAP(abs)//I
 //*TRISYCL_MATH_WRAP2(abs_diff)//I
 //*TRISYCL_MATH_WRAP2(add_sat)//I
@@ -350,22 +365,155 @@ template <typename T, int size>
 auto sign(const vec<T, size>& x) {
   return x.map(sign<T>);
 }
+
+// Returns b if c is not 0, otherwise a
+template <typename T, typename U>
+T select(const T& a, const T& b, const U& c) {
+  return c ? b : a;
+}
+
+// For each element, returns b[i] if the most significant bit of c[i] is set,
+// otherwise a[i]. With a native vector type it is a single blend.
+template <typename T, typename U, int size>
+auto select(const vec<T, size>& a,
+            const vec<T, size>& b,
+            const vec<U, size>& c) {
+  using S = std::make_signed_t<U>;
+  using native = detail::native_vector<vec<T, size>>;
+  using native_mask = detail::native_vector<vec<S, size>>;
+  vec<T, size> result;
+  if constexpr (requires (typename native::type v,
+                          typename native_mask::type m) { m < 0 ? v : v; })
+    native::store(native_mask::load(reinterpret_cast<const S*>(c.data())) < 0
+                  ? native::load(b.data()) : native::load(a.data()),
+                  result.data());
+  else
+    for (int i = 0; i != size; ++i)
+      result[i] = static_cast<S>(c[i]) < 0 ? b[i] : a[i];
+  return result;
+}
+
+// The product of 2 half or bfloat16 is exact in float, so the widening
+// multiply-accumulate functions only round into the float accumulator.
+// This is a triSYCL extension.
+
+// Returns a*b + c in float, for some half or bfloat16 a and b
+template <typename T>
+  requires detail::is_float16_v<T>
+float mad_widen(T a, T b, float c) {
+  return float(a)*float(b) + c;
+}
+
+// Element-wise widening multiply-accumulate
+template <typename T, int size>
+  requires detail::is_float16_v<T>
+auto mad_widen(const vec<T, size>& a,
+               const vec<T, size>& b,
+               const vec<float, size>& c) {
+  return a.template convert<float>()*b.template convert<float>() + c;
+}
+
+// Returns c plus the dot product of a and b, accumulated in float. A
+// bfloat16 vec of 16 uses the AVX512-BF16 dot product instruction,
+// which flushes the denormal numbers to zero
+template <typename T, int size>
+  requires detail::is_float16_v<T>
+float dot_widen(const vec<T, size>& a, const vec<T, size>& b,
+                float c = 0) {
+#if defined(__AVX512BF16__) && defined(__AVX512VL__)
+  if constexpr (std::is_same_v<T, bfloat16> && size == 16) {
+    auto p = _mm256_dpbf16_ps(
+      _mm256_setzero_ps(),
+      (__m256bh) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                      a.data())),
+      (__m256bh) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                                      b.data())));
+    auto h = _mm_add_ps(_mm256_castps256_ps128(p),
+                        _mm256_extractf128_ps(p, 1));
+    h = _mm_hadd_ps(h, h);
+    return c + _mm_cvtss_f32(_mm_hadd_ps(h, h));
+  }
+#endif
+  auto p = a.template convert<float>()*b.template convert<float>();
+  return std::accumulate(p.begin(), p.end(), c);
+}
+
+TRISYCL_VECTOR_MATH(cos)
+TRISYCL_VECTOR_MATH(exp)
+TRISYCL_VECTOR_MATH(exp2)
+TRISYCL_VECTOR_MATH(log)
+TRISYCL_VECTOR_MATH(log2)
+TRISYCL_VECTOR_MATH(sin)
 //
+/* Functions with an implementation-defined accuracy, faster than the
+   standard ones */
 namespace native {
 TRISYCL_MATH_WRAP(cos)
-//*TRISYCL_MATH_WRAP2(divide)
+
+template <typename T>
+T divide(const T& x, const T& y) {
+  return x/y;
+}
+
 TRISYCL_MATH_WRAP(exp)
 TRISYCL_MATH_WRAP(exp2)
-//*TRISYCL_MATH_WRAP(exp10)
+TRISYCL_VECTOR_MATH(exp2)
+
+// Computed as 2^(x*log2(10))
+template <typename T>
+T exp10(const T& x) {
+  return native::exp2(x*T { 3.32192809488736235 });
+}
+
 TRISYCL_MATH_WRAP(log)
 TRISYCL_MATH_WRAP(log2)
+TRISYCL_VECTOR_MATH(log2)
 TRISYCL_MATH_WRAP(log10)
-//*TRISYCL_MATH_WRAP(powr)
-//*TRISYCL_MATH_WRAP(recip)
-//*TRISYCL_MATH_WRAP(rsqrt)
+
+// x^y for x >= 0, computed as 2^(y*log2(x))
+template <typename T>
+T powr(const T& x, const T& y) {
+  return native::exp2(y*native::log2(x));
+}
+
+template <typename T>
+T recip(const T& x) {
+  return T { 1 }/x;
+}
+
 TRISYCL_MATH_WRAP(sin)
 TRISYCL_MATH_WRAP(sqrt)
+
+template <typename T>
+T rsqrt(const T& x) {
+  return T { 1 }/native::sqrt(x);
+}
+
 TRISYCL_MATH_WRAP(tan)
+TRISYCL_VECTOR_MATH(cos)
+TRISYCL_VECTOR_MATH(exp)
+TRISYCL_VECTOR_MATH(log)
+TRISYCL_VECTOR_MATH(rsqrt)
+TRISYCL_VECTOR_MATH(sin)
+}
+
+/* Functions with at least 11 bits of accuracy, which are the native ones
+   since they are accurate enough */
+namespace half_precision {
+using native::cos;
+using native::divide;
+using native::exp;
+using native::exp2;
+using native::exp10;
+using native::log;
+using native::log2;
+using native::log10;
+using native::powr;
+using native::recip;
+using native::rsqrt;
+using native::sin;
+using native::sqrt;
+using native::tan;
 }
 #undef TRISYCL_MATH_WRAP
 #undef TRISYCL_MATH_WRAP2
@@ -373,6 +521,7 @@ TRISYCL_MATH_WRAP(tan)
 #undef TRISYCL_MATH_WRAP3
 #undef TRISYCL_MATH_WRAP3s
 #undef TRISYCL_MATH_WRAP3ss
+#undef TRISYCL_VECTOR_MATH
 
 }
 
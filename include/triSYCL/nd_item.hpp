@@ -18,6 +18,13 @@
 #include "triSYCL/item.hpp"
 #include "triSYCL/nd_range.hpp"
 #include "triSYCL/range.hpp"
+#include "triSYCL/sub_group.hpp"
+
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+#include "triSYCL/detail/SPIR/opencl_spir_barrier.hpp"
+#elif defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+#include "triSYCL/parallelism/detail/work_item_fibers.hpp"
+#endif
 
 namespace trisycl {
 
@@ -39,6 +46,13 @@ private:
      ND_range */
   id<Dimensions> local_index;
   nd_range<Dimensions> ND_range;
+  /* The strides of the global and local ranges, cached to compute the
+     linear ids of all the work-items of the nd_range without
+     multiplication chain */
+  detail::linear_strides<Dimensions> global_strides;
+  detail::linear_strides<Dimensions> local_strides;
+  /// The linear id of the offset, to subtract from the global one
+  size_t linear_offset;
 
 public:
 
@@ -48,7 +62,12 @@ public:
       call set_global() and set_local() later. This should be hidden to
       the user.
   */
-  nd_item(nd_range<Dimensions> ndr) : ND_range { ndr } {}
+  nd_item(nd_range<Dimensions> ndr) :
+    ND_range { ndr },
+    global_strides { ndr.get_global_range() },
+    local_strides { ndr.get_local_range() },
+    linear_offset { global_strides(ndr.get_offset()) }
+  {}
 
 
   /** Create a full nd_item
@@ -62,7 +81,10 @@ public:
     // Compute the local index using the offset and the group size
     local_index { (global_index - ndr.get_offset())%id<Dimensions> {
         ndr.get_local_range() } },
-    ND_range { ndr }
+    ND_range { ndr },
+    global_strides { ndr.get_global_range() },
+    local_strides { ndr.get_local_range() },
+    linear_offset { global_strides(ndr.get_offset()) }
   {}
 
 
@@ -92,9 +114,7 @@ public:
       the offset
   */
   size_t get_global_linear_id() const {
-    return detail::linear_id(get_global_range(),
-                             get_global_id(),
-                             get_offset());
+    return global_strides(global_index) - linear_offset;
   }
 
 
@@ -117,7 +137,7 @@ public:
       work-group
    */
   size_t get_local_linear_id() const {
-    return detail::linear_id(get_local_range(), get_local_id());
+    return local_strides(local_index);
   }
 
 
@@ -180,6 +200,12 @@ public:
   nd_range<Dimensions> get_nd_range() const { return ND_range; }
 
 
+  /// Return the sub-group of the work-item
+  sub_group get_sub_group() const {
+    return { get_local_linear_id(), get_local_range().size() };
+  }
+
+
   /** Allows projection down to an item
 
       \todo Add to the specification
@@ -201,7 +227,13 @@ public:
   */
   void barrier(access::fence_space flag =
                access::fence_space::global_and_local) const {
-#if defined(_OPENMP) && !defined(TRISYCL_NO_BARRIER)
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+    // The work-items are the ones of the device, so use its barrier
+    detail::spir::barrier(flag);
+#elif defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+    // Switch to the other work-items of the work-group
+    detail::work_item_fibers::barrier();
+#elif defined(_OPENMP) && !defined(TRISYCL_NO_BARRIER)
     /* Use OpenMP barrier in the implementation with 1 OpenMP thread per
        work-item of the work-group */
 #pragma omp barrier
@@ -11,12 +11,19 @@
     License. See LICENSE.TXT for details.
 */
 
-#ifdef TRISYCL_TBB
-#include "triSYCL/parallelism/detail/parallelism_tbb.hpp"
+#if defined(TRISYCL_WORK_STEALING)
+#include "triSYCL/parallelism/detail/parallelism_work_stealing.hpp"
 #else
 #include "triSYCL/parallelism/detail/parallelism.hpp"
 #endif
 
+// The TBB back-end is available next to the other one
+#if defined(TRISYCL_TBB)
+#include "triSYCL/parallelism/detail/parallelism_tbb.hpp"
+#endif
+
+#include "triSYCL/parallelism/detail/backend.hpp"
+
 /*
     # Some Emacs stuff:
     ### Local Variables:
@@ -0,0 +1,105 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_BACKEND_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_BACKEND_HPP
+
+/** \file
+
+    Select at compile time the parallelism back-end launching a kernel,
+    according to its vendor::trisycl::use_backend() tag
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <type_traits>
+#include <utility>
+
+#include "triSYCL/vendor/triSYCL/backend.hpp"
+
+/** \addtogroup parallelism
+    @{
+*/
+
+namespace trisycl::detail {
+
+/** The kernel launchers of the parallelism back-end \p Backend
+
+    Only the back-ends compiled in are specialized.
+*/
+template <typename Backend = vendor::trisycl::backend::build_default>
+struct backend_parallelism {
+  static_assert(!std::is_same_v<Backend, Backend>,
+                "This parallelism back-end is not compiled in: use "
+                "TRISYCL_TBB for the TBB back-end and "
+                "TRISYCL_WORK_STEALING for the work stealing");
+};
+
+
+/** The back-end implemented directly in trisycl::detail, that is the
+    work stealing or OpenMP
+*/
+#if defined(TRISYCL_WORK_STEALING)
+template <>
+struct backend_parallelism<vendor::trisycl::backend::work_stealing> {
+#else
+template <>
+struct backend_parallelism<vendor::trisycl::backend::openmp> {
+#endif
+
+  template <typename... Args>
+  static void parallel_for(Args &&... args) {
+    detail::parallel_for(std::forward<Args>(args)...);
+  }
+
+
+  template <typename... Args>
+  static void parallel_for_global_offset(Args &&... args) {
+    detail::parallel_for_global_offset(std::forward<Args>(args)...);
+  }
+
+
+  template <typename... Args>
+  static void parallel_for_workgroup(Args &&... args) {
+    detail::parallel_for_workgroup(std::forward<Args>(args)...);
+  }
+
+};
+
+
+#if defined(TRISYCL_TBB)
+/// The TBB back-end
+template <>
+struct backend_parallelism<vendor::trisycl::backend::tbb> {
+
+  template <typename... Args>
+  static void parallel_for(Args &&... args) {
+    tbb_backend::parallel_for(std::forward<Args>(args)...);
+  }
+
+
+  template <typename... Args>
+  static void parallel_for_global_offset(Args &&... args) {
+    tbb_backend::parallel_for_global_offset(std::forward<Args>(args)...);
+  }
+
+
+  template <typename... Args>
+  static void parallel_for_workgroup(Args &&... args) {
+    tbb_backend::parallel_for_workgroup(std::forward<Args>(args)...);
+  }
+
+};
+#endif
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_BACKEND_HPP
@@ -0,0 +1,111 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_FLEXIBLE_RANGE_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_FLEXIBLE_RANGE_HPP
+
+/** \file
+
+    The loop on a flexible range of logical work-items inside a
+    work-group, shared by all the parallelism back-ends since it runs
+    on the thread of the work-group
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/group.hpp"
+#include "triSYCL/h_item.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/range.hpp"
+
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+#include "triSYCL/detail/SPIR/opencl_spir_helpers.hpp"
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/** Implement the loop on a flexible range of logical work-items
+    inside a work-group
+
+    Since there is no barrier inside such a loop, the current thread
+    executes all the logical work-items with a simd loop along the last
+    dimension, each one seeing the physical work-item of its position
+    modulo the local range.
+*/
+template <int Dimensions, typename ParallelForFunctor>
+void parallel_for_workitem_in_group(const group<Dimensions> &g,
+                                    const range<Dimensions> &flexible_range,
+                                    ParallelForFunctor f) {
+  const auto physical_range = g.get_local_range();
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+  /* Each work-item of the device runs the logical work-items of its
+     position modulo the local range, followed by the implicit barrier
+     of the loop */
+  auto index = spir::make_spir_h_item<Dimensions>();
+  const auto physical = index.get_local_id();
+  auto logical = physical;
+  bool done = false;
+  for (int d = 0; d != Dimensions; ++d)
+    done = done || physical[d] >= flexible_range[d];
+  while (!done) {
+    index.set_logical_local(logical, flexible_range);
+    f(index);
+    int d = Dimensions - 1;
+    for (; d >= 0; --d) {
+      logical[d] += physical_range[d];
+      if (logical[d] < flexible_range[d])
+        break;
+      logical[d] = physical[d];
+    }
+    done = d < 0;
+  }
+  spir::barrier(access::fence_space::global_and_local);
+#else
+  constexpr auto last = Dimensions - 1;
+  const std::size_t inner = flexible_range[last];
+  std::size_t rows = 1;
+  for (int d = 0; d != last; ++d)
+    rows *= flexible_range[d];
+  const auto nd = g.get_nd_range();
+  // The global id of the first work-item of the work-group
+  const auto origin = id<Dimensions>(physical_range)*g.get_id();
+  // The coordinates of the current row of logical work-items
+  id<Dimensions> row;
+  for (std::size_t r = 0; r < rows && inner != 0; ++r) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for (std::size_t i = 0; i < inner; ++i) {
+      auto logical = row;
+      logical[last] = i;
+      h_item<Dimensions> index { nd };
+      index.set_local(logical%id<Dimensions> { physical_range });
+      index.set_global(index.get_local_id() + origin);
+      index.set_logical_local(logical, flexible_range);
+      f(index);
+    }
+    // Move to the next row
+    for (int d = last - 1; d >= 0 && ++row[d] == flexible_range[d]; --d)
+      row[d] = 0;
+  }
+#endif
+}
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_FLEXIBLE_RANGE_HPP
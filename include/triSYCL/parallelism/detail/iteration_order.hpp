@@ -0,0 +1,213 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_ITERATION_ORDER_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_ITERATION_ORDER_HPP
+
+/** \file
+
+    Walk a multi-dimensional iteration space by tiles, with the tiles
+    visited in row-major, Morton or Hilbert order
+
+    The tiles are distributed by contiguous ranges among the threads,
+    so with a space-filling curve each thread processes a compact part
+    of the iteration space whatever its shape. The work-items of a
+    tile are executed in row-major order so the innermost loop stays
+    contiguous.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/range.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/// The tiles of an iteration space in the order they are executed
+template <int Dimensions>
+struct ordered_tiles {
+  /// The iteration space
+  range<Dimensions> space;
+
+  /// The extents of a tile
+  range<Dimensions> tile;
+
+  /// The coordinates of the tiles, in tile units, in execution order
+  std::vector<id<Dimensions>> tiles;
+
+
+  /** Get the partitioning of the current kernel if it asks for a
+      tiled execution, or nullptr
+  */
+  static const partitioning *requested() {
+    if constexpr (Dimensions < 2)
+      return nullptr;
+    else {
+      auto p = partitioning::current();
+      return p && p->iteration != partitioning::order::row_major
+        ? p : nullptr;
+    }
+  }
+
+
+  /** Interleave the bits of some coordinates, the first coordinate
+      providing the most significant bit of each group
+  */
+  template <std::size_t N>
+  static std::uint64_t interleave(const std::array<std::uint32_t, N> &x,
+                                  unsigned bits) {
+    std::uint64_t key = 0;
+    for (auto b = bits; b-- > 0;)
+      for (auto c : x)
+        key = key << 1 | (c >> b & 1);
+    return key;
+  }
+
+
+  /** Compute the distance along the Hilbert curve of some coordinates
+      in an hypercube of side 2^bits
+
+      This is the transformation of John Skilling, "Programming the
+      Hilbert curve", AIP Conference Proceedings 707, 381 (2004), in
+      any number of dimensions.
+  */
+  template <std::size_t N>
+  static std::uint64_t hilbert_key(std::array<std::uint32_t, N> x,
+                                   unsigned bits) {
+    if (bits == 0)
+      return 0;
+    // Undo the excess work
+    auto most_significant = std::uint32_t { 1 } << (bits - 1);
+    for (auto q = most_significant; q > 1; q >>= 1) {
+      auto p = q - 1;
+      for (std::size_t i = 0; i != N; ++i)
+        if (x[i] & q)
+          // Invert
+          x[0] ^= p;
+        else {
+          // Exchange
+          auto t = (x[0] ^ x[i]) & p;
+          x[0] ^= t;
+          x[i] ^= t;
+        }
+    }
+    // Gray encode
+    for (std::size_t i = 1; i != N; ++i)
+      x[i] ^= x[i - 1];
+    std::uint32_t t = 0;
+    for (auto q = most_significant; q > 1; q >>= 1)
+      if (x[N - 1] & q)
+        t ^= q - 1;
+    for (auto &c : x)
+      c ^= t;
+    // The index is the interleaving of the transposed coordinates
+    return interleave(x, bits);
+  }
+
+
+  /** Order the tiles of an iteration space
+
+      \param[in] tile_extents gives the tile extents, the last
+      Dimensions ones being used
+  */
+  ordered_tiles(range<Dimensions> r,
+                const std::array<std::size_t, 3> &tile_extents,
+                partitioning::order o)
+    : space { r } {
+    range<Dimensions> tile_range;
+    std::size_t tile_number = 1;
+    for (int d = 0; d != Dimensions; ++d) {
+      tile[d] = std::max<std::size_t>(tile_extents[3 - Dimensions + d], 1);
+      tile_range[d] = (r[d] + tile[d] - 1)/tile[d];
+      tile_number *= tile_range[d];
+    }
+    if (tile_number == 0)
+      return;
+    // Enumerate the tiles in row-major order
+    tiles.reserve(tile_number);
+    for (std::size_t t = 0; t != tile_number; ++t) {
+      id<Dimensions> c;
+      auto l = t;
+      for (int d = Dimensions - 1; d >= 0; --d) {
+        c[d] = l % tile_range[d];
+        l /= tile_range[d];
+      }
+      tiles.push_back(c);
+    }
+    if (o != partitioning::order::morton && o != partitioning::order::hilbert)
+      return;
+    // The side of the smallest power-of-2 hypercube containing the tiles
+    unsigned bits = 0;
+    auto side = *std::max_element(tile_range.begin(), tile_range.end());
+    while ((std::size_t { 1 } << bits) < side)
+      ++bits;
+    std::vector<std::pair<std::uint64_t, std::size_t>> keys;
+    keys.reserve(tile_number);
+    for (std::size_t t = 0; t != tile_number; ++t) {
+      std::array<std::uint32_t, Dimensions> x;
+      for (int d = 0; d != Dimensions; ++d)
+        x[d] = tiles[t][d];
+      keys.emplace_back(o == partitioning::order::morton
+                        ? interleave(x, bits) : hilbert_key(x, bits), t);
+    }
+    std::sort(keys.begin(), keys.end());
+    std::vector<id<Dimensions>> sorted;
+    sorted.reserve(tile_number);
+    for (auto &k : keys)
+      sorted.push_back(tiles[k.second]);
+    tiles = std::move(sorted);
+  }
+
+
+  /// Execute a functor on all the ids of the tile \p t in row-major order
+  template <typename ParallelForFunctor>
+  void iterate_tile(std::size_t t, ParallelForFunctor &f) const {
+    id<Dimensions> begin, end;
+    for (int d = 0; d != Dimensions; ++d) {
+      begin[d] = tiles[t][d]*tile[d];
+      end[d] = std::min(begin[d] + tile[d], space[d]);
+    }
+    auto i = begin;
+    for (;;) {
+      for (i[Dimensions - 1] = begin[Dimensions - 1];
+           i[Dimensions - 1] < end[Dimensions - 1];
+           ++i[Dimensions - 1])
+        f(i);
+      // Move to the next row of the tile
+      int d = Dimensions - 2;
+      while (d >= 0 && ++i[d] == end[d]) {
+        i[d] = begin[d];
+        --d;
+      }
+      if (d < 0)
+        return;
+    }
+  }
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_ITERATION_ORDER_HPP
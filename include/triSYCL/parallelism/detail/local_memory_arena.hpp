@@ -0,0 +1,222 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_LOCAL_MEMORY_ARENA_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_LOCAL_MEMORY_ARENA_HPP
+
+/** \file
+
+    The local memory of the work-groups, carved out of some memory
+    owned by each thread
+
+    All the local accessors of a kernel are laid out one after the
+    other at some cache-aligned offset, so a work-group just needs one
+    piece of memory of the total size. A thread keeps its pieces from
+    a work-group to the next one, so there is no allocation once a
+    thread has run its first work-group and the work-groups running
+    concurrently on different threads do not share anything.
+
+    Since the processors fetch the cache lines by pairs, a line shared
+    with another thread next to the local memory would still bounce
+    between the cores. So the local memory of a thread is surrounded by
+    some unused guard lines, \c TRISYCL_LOCAL_MEMORY_GUARD bytes on
+    each side, and its first touch by its thread keeps it on the NUMA
+    node of the thread.
+
+    With \c TRISYCL_USE_OPENCL_ND_RANGE, the work-groups are the ones of
+    the device, so the local memory is a \c __local array of
+    \c TRISYCL_DEVICE_LOCAL_MEMORY_SIZE bytes shared by the work-items
+    of each work-group.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+#include "triSYCL/address_space.hpp"
+#endif
+
+#ifndef TRISYCL_DEVICE_LOCAL_MEMORY_SIZE
+/// The bytes of local memory of a work-group on a device
+#define TRISYCL_DEVICE_LOCAL_MEMORY_SIZE (32*1024)
+#endif
+
+#ifndef TRISYCL_LOCAL_MEMORY_GUARD
+/** The bytes left unused on each side of the local memory of a host
+    thread, covering the pair of cache lines fetched together */
+#define TRISYCL_LOCAL_MEMORY_GUARD 128
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/// The local memory of the work-groups executed by a thread
+class local_memory_arena {
+
+public:
+
+  /// The alignment of the local memory and of each local accessor in it
+  static constexpr std::size_t alignment = 64;
+
+  /// The unused bytes on each side of the local memory of a thread
+  static constexpr std::size_t guard =
+    (TRISYCL_LOCAL_MEMORY_GUARD + alignment - 1)/alignment*alignment;
+
+private:
+
+  /// A cache line
+  struct alignas(alignment) line {
+    std::byte data[alignment];
+  };
+
+  /// Some memory kept by the thread across the work-groups
+  struct slab {
+    std::unique_ptr<line[]> lines;
+    std::size_t size = 0;
+  };
+
+  /** The memory for each level of work-group nesting
+
+      A thread waiting for the work-items of its work-group may run a
+      work-group of another kernel with some work-stealing scheduler,
+      which gets the next slab instead of overwriting the first one.
+  */
+  std::vector<slab> slabs;
+
+  /// The number of work-groups running on this thread
+  std::size_t depth = 0;
+
+
+  /// Get the arena of the current thread
+  static local_memory_arena &of_this_thread() {
+    static thread_local local_memory_arena a;
+    return a;
+  }
+
+
+  /// Get some local memory of \p size bytes for a new work-group
+  std::byte *enter(std::size_t size) {
+    if (depth == slabs.size())
+      slabs.emplace_back();
+    auto &s = slabs[depth++];
+    auto lines = (size + alignment - 1)/alignment;
+    // Only grow, so it is reused by the next work-groups
+    if (lines > s.size) {
+      // Like in a real local memory the content is not initialized
+      s.lines.reset(new line[guard/alignment + lines + guard/alignment]);
+      s.size = lines;
+    }
+    return s.lines[guard/alignment].data;
+  }
+
+
+  /// Release the local memory of the last work-group entered
+  void leave() { --depth; }
+
+public:
+
+  /// Round \p offset up to the alignment of a local accessor
+  static constexpr std::size_t align(std::size_t offset) {
+    return (offset + alignment - 1)/alignment*alignment;
+  }
+
+
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+
+  /// The local memory of the work-group of the current device work-item
+  static std::byte *current() {
+    static TRISYCL_LOCAL_AS line
+      lines[TRISYCL_DEVICE_LOCAL_MEMORY_SIZE/alignment];
+    return reinterpret_cast<std::byte *>(lines);
+  }
+
+
+  /// The device work-items already use the local memory of their group
+  class scope {
+
+  public:
+
+    scope(std::byte *) {}
+  };
+
+
+  /// The device gives its local memory to each work-group
+  class group_scope {
+
+  public:
+
+    group_scope(std::size_t) {}
+  };
+
+#else
+
+  /** The local memory of the work-group of the current work-item,
+      nullptr outside of a work-group
+  */
+  static std::byte *&current() {
+    static thread_local std::byte *base = nullptr;
+    return base;
+  }
+
+
+  /** Make some local memory current while a work-item runs on this
+      thread, to propagate the one of a work-group to the threads
+      executing its work-items
+  */
+  class scope {
+    std::byte *outer;
+
+  public:
+
+    scope(std::byte *base) : outer { current() } {
+      current() = base;
+    }
+
+    ~scope() { current() = outer; }
+  };
+
+
+  /** Give some local memory to a work-group executed by the current
+      thread
+
+      Nothing is done when the kernel has no local memory.
+  */
+  class group_scope {
+    std::size_t size;
+    scope in_group;
+
+  public:
+
+    group_scope(std::size_t size)
+      : size { size }
+      , in_group { size ? of_this_thread().enter(size) : nullptr } {}
+
+    ~group_scope() {
+      if (size)
+        of_this_thread().leave();
+    }
+  };
+
+#endif
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_LOCAL_MEMORY_ARENA_HPP
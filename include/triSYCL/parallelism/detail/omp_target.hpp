@@ -0,0 +1,88 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_OMP_TARGET_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_OMP_TARGET_HPP
+
+/** \file
+
+    Offload the parallel_for kernels on a range to an OpenMP target
+    device, such as a GPU, when TRISYCL_OMP_TARGET is defined
+
+    The kernel functor stays in the host memory and the device calls
+    it through a pointer, with the accessors it captures pointing to
+    the host memory of the buffers. This relies on the unified shared
+    memory of the device, since OpenMP does not translate the pointers
+    hidden inside the accessors captured by a lambda. So no data is
+    mapped explicitly and the pages of the buffers migrate on demand
+    between the host and the device.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#ifndef _OPENMP
+#error "TRISYCL_OMP_TARGET requires a compilation with OpenMP"
+#endif
+
+#include <cstddef>
+
+#include <omp.h>
+
+#include "triSYCL/id.hpp"
+#include "triSYCL/range.hpp"
+
+/* The device accesses the kernel functor and the buffers in the host
+   memory */
+#pragma omp requires unified_shared_memory
+
+/** \addtogroup parallelism
+    @{
+*/
+
+namespace trisycl::detail {
+
+/// Test whether the kernels can be offloaded to an OpenMP device
+inline bool has_omp_target() {
+  static const bool available =
+    omp_get_default_device() < omp_get_num_devices();
+  return available;
+}
+
+
+/** Execute a kernel on all the ids of a range on the default OpenMP
+    device
+
+    The linear ids are distributed among the teams and the threads of
+    the device and delinearized there, the last dimension varying
+    fastest.
+*/
+template <int Dimensions, typename ParallelForFunctor>
+void parallel_for_omp_target(range<Dimensions> r, ParallelForFunctor &f) {
+  const std::size_t n = r.size();
+  // The kernel functor is used in place through the unified memory
+  auto kernel = &f;
+#pragma omp target teams distribute parallel for firstprivate(r, kernel)
+  for (std::size_t l = 0; l < n; ++l) {
+    id<Dimensions> i;
+    auto rest = l;
+    for (int d = Dimensions - 1; d >= 0; --d) {
+      i[d] = rest % r[d];
+      rest /= r[d];
+    }
+    (*kernel)(i);
+  }
+}
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_OMP_TARGET_HPP
@@ -13,15 +13,31 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <type_traits>
+#include <vector>
 
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/detail/perf_counters.hpp"
+#include "triSYCL/detail/placement.hpp"
 #include "triSYCL/group.hpp"
 #include "triSYCL/h_item.hpp"
 #include "triSYCL/id.hpp"
 #include "triSYCL/item.hpp"
 #include "triSYCL/nd_item.hpp"
 #include "triSYCL/nd_range.hpp"
+#include "triSYCL/parallelism/detail/flexible_range.hpp"
+#include "triSYCL/parallelism/detail/iteration_order.hpp"
+#include "triSYCL/parallelism/detail/local_memory_arena.hpp"
+#include "triSYCL/parallelism/detail/work_group_scratch.hpp"
 #include "triSYCL/range.hpp"
+#include "triSYCL/vendor/triSYCL/cost_hint.hpp"
+#include "triSYCL/vendor/triSYCL/independent.hpp"
+#include "triSYCL/vendor/triSYCL/index32.hpp"
+#include "triSYCL/vendor/triSYCL/no_barrier.hpp"
 
 #if defined(TRISYCL_USE_OPENCL_ND_RANGE)
 #include "triSYCL/detail/SPIR/opencl_spir_helpers.hpp"
@@ -31,6 +47,14 @@
 #include <omp.h>
 #endif
 
+#ifdef TRISYCL_OMP_TARGET
+#include "triSYCL/parallelism/detail/omp_target.hpp"
+#endif
+
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+#include "triSYCL/parallelism/detail/work_item_fibers.hpp"
+#endif
+
 
 /** \addtogroup parallelism
     @{
@@ -69,6 +93,57 @@ struct parallel_for_iterate {
 };
 
 #ifdef _OPENMP
+/** Set the OpenMP schedule asked for the kernel running on the current
+    thread, used by the loops with a schedule(runtime) clause of the
+    next parallel regions
+
+    \param[in] fallback is the schedule used when the kernel does not
+    ask for one
+
+    \return the number of threads of the team executing the kernel,
+    limited by the \p share of the kernel
+*/
+inline std::size_t apply_schedule(const concurrency_governor::share &share,
+                                  omp_sched_t fallback = omp_sched_static) {
+  auto threads = share.get_threads();
+  auto p = partitioning::current();
+  if (!p) {
+    omp_set_schedule(fallback, 0);
+    return threads;
+  }
+  omp_set_schedule(p->scheduling == partitioning::schedule::dynamic_schedule
+                   ? omp_sched_dynamic
+                   : p->scheduling == partitioning::schedule::guided_schedule
+                   ? omp_sched_guided : omp_sched_static,
+                   static_cast<int>(p->chunk_size));
+  return p->team_size ? std::min(threads, p->team_size) : threads;
+}
+
+
+/** Test whether the kernel running on the current thread asks for
+    another schedule than the default static one
+*/
+inline bool is_scheduled() {
+  auto p = partitioning::current();
+  return p && (p->scheduling != partitioning::schedule::static_schedule
+               || p->chunk_size || p->team_size);
+}
+
+
+/** Get the CPUs to keep the slices of the kernel running on the current
+    thread on, if its queue asks for the cache affinity, or nothing
+
+    \param[in] where is the placement of the worker executing the
+    kernel, if any
+*/
+inline std::vector<unsigned> cache_affinity_cpus(const placement *where) {
+  auto p = partitioning::current();
+  if (p && p->partitioner == partitioning::kind::affinity_partitioner)
+    return placement::affinity_cpus(where);
+  return {};
+}
+
+
 /** A top-level recursive multi-dimensional iterator variant using OpenMP
 
     Only the top-level loop uses OpenMP and goes on with the normal
@@ -80,10 +155,29 @@ template <std::size_t level,
           typename Id>
 struct parallel_OpenMP_for_iterate {
   parallel_OpenMP_for_iterate(Range r, ParallelForFunctor &f) {
+    // Do not oversubscribe the cores with the other running kernels
+    auto share = concurrency_governor::instance().acquire();
+    auto threads = apply_schedule(share);
+    // The placement of the worker executing the kernel, if any
+    auto where = placement::current();
+    // The CPUs keeping the slices of the successive kernels, if any
+    auto cpus = cache_affinity_cpus(where);
+    // The hardware counters of the kernel, if they are sampled
+    auto counting = perf_counters::current();
     // Create the OpenMP threads before the for-loop to avoid creating an
     // index in each iteration
-#pragma omp parallel
+#pragma omp parallel num_threads(threads)
     {
+      /* Process the slice of this thread on the node where it has
+         been first touched */
+      if (where)
+        where->pin_team_member(omp_get_thread_num(), omp_get_num_threads());
+      placement::slice_scope in_slice {
+        cpus,
+        static_cast<std::size_t>(omp_get_thread_num()),
+        static_cast<std::size_t>(omp_get_num_threads())
+      };
+      perf_counters::scope in_team { counting };
       // Allocate an OpenMP thread-local index
       Id index;
       // Make a simple loop end condition for OpenMP
@@ -92,7 +186,7 @@ struct parallel_OpenMP_for_iterate {
          "collapse" could be useful for small iteration space, but it
          would need some template specialization to have real contiguous
          loop nests */
-#pragma omp for
+#pragma omp for schedule(runtime)
       for (std::size_t _sycl_index = 0;
            _sycl_index < _sycl_end;
            _sycl_index++) {
@@ -120,61 +214,331 @@ struct parallel_for_iterate<0, Range, ParallelForFunctor, Id> {
 };
 
 
+/** Execute \p body on the indices [\p begin, \p end), as a
+    vectorizable loop if the work-items are \p Independent
+*/
+template <bool Independent, typename Index, typename Body>
+void for_each_index(Index begin, Index end, Body &&body) {
+  if constexpr (Independent) {
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+    for (auto i = begin; i < end; ++i)
+      body(i);
+  } else
+    for (auto i = begin; i < end; ++i)
+      body(i);
+}
+
+
+/** Execute a kernel on all the ids of a range with a contiguous
+    innermost loop
+
+    The iteration space is seen as rows along the last dimension,
+    distributed statically among the OpenMP threads unless the kernel
+    asks for another schedule, or the elements themselves in 1D. The
+    coordinates and the linear id of the rows are advanced
+    incrementally and each work-item of a row gets its own index, so
+    the compiler can see the work-items are independent.
+
+    The innermost loop is only marked as a SIMD loop for the kernels
+    declared with vendor::trisycl::independent(), since the other ones
+    may have some dependencies between their work-items, through some
+    atomics for example. A simple element-wise kernel is then
+    vectorized like a hand-written loop.
+
+    Only the ranges up to 3 dimensions are handled here.
+
+    \param[in] f is called with the id of each work-item, and also its
+    linear id if it accepts it
+
+    \param[in] cost is the estimated cost of a work-item, a kernel too
+    small to be worth a parallel team being executed by the current
+    thread
+
+    \tparam Index is the integer type counting the work-items, which
+    can be 32-bit for a vendor::trisycl::index32() kernel
+
+    \tparam Independent marks the innermost loop as a SIMD loop
+*/
+template <typename Index = std::size_t, bool Independent = false,
+          int Dimensions, typename ParallelForFunctor>
+void parallel_for_simd_iterate(range<Dimensions> r,
+                               ParallelForFunctor &f,
+                               std::size_t cost = 1) {
+  constexpr auto last = Dimensions - 1;
+  const Index inner = r[last];
+  Index rows = 1;
+  for (int d = 0; d != last; ++d)
+    rows *= r[d];
+  if (inner == 0 || rows == 0)
+    return;
+  // The strides of the linear ids, the dimension 0 being contiguous
+  const linear_strides<Dimensions> strides { r };
+  const Index inner_stride = strides[last];
+
+  // Execute a work-item with its linear id, if the kernel takes it
+  auto call = [&] (id<Dimensions> i, Index linear) {
+    if constexpr (std::is_invocable_v<ParallelForFunctor &,
+                                      id<Dimensions>, std::size_t>)
+      f(i, std::size_t { linear });
+    else
+      f(i);
+  };
+
+  // Execute the rows [begin, end) or the elements [begin, end) in 1D
+  auto iterate = [&] (Index begin, Index end) {
+    if constexpr (Dimensions == 1)
+      for_each_index<Independent>(begin, end, [&] (Index i) {
+          call(id<1> { i }, i);
+        });
+    else {
+      // The coordinates and the linear id of the first row
+      std::array<Index, Dimensions> row;
+      Index row_linear = 0;
+      auto rest = begin;
+      for (int d = last - 1; d >= 0; --d) {
+        row[d] = rest % Index(r[d]);
+        rest /= Index(r[d]);
+        row_linear += row[d]*Index(strides[d]);
+      }
+      for (auto l = begin; l < end; ++l) {
+        for_each_index<Independent>(Index { 0 }, inner, [&] (Index i) {
+            /* Build a fresh index instead of updating a copy of the row
+               so the vectorizer does not have to privatize an array */
+            if constexpr (Dimensions == 2)
+              call(id<2> { row[0], i }, row_linear + i*inner_stride);
+            else
+              call(id<3> { row[0], row[1], i },
+                   row_linear + i*inner_stride);
+          });
+        // Move to the next row
+        for (int d = last - 1; d >= 0; --d) {
+          row_linear += Index(strides[d]);
+          if (++row[d] != r[d])
+            break;
+          row_linear -= row[d]*Index(strides[d]);
+          row[d] = 0;
+        }
+      }
+    }
+  };
+
+  const auto total = Dimensions == 1 ? inner : rows;
+#ifdef _OPENMP
+  if (!concurrency_governor::is_worth_parallelizing(r.size(), cost)) {
+    iterate(0, total);
+    return;
+  }
+  // Do not oversubscribe the cores with the other running kernels
+  auto share = concurrency_governor::instance().acquire();
+  // The placement of the worker executing the kernel, if any
+  auto where = placement::current();
+  // The hardware counters of the kernel, if they are sampled
+  auto counting = perf_counters::current();
+  if (is_scheduled()) {
+    // Let OpenMP distribute the rows with the schedule of the kernel
+    auto threads = apply_schedule(share);
+#pragma omp parallel num_threads(threads)
+    {
+      if (where)
+        where->pin_team_member(omp_get_thread_num(), omp_get_num_threads());
+      perf_counters::scope in_team { counting };
+      if constexpr (Dimensions == 1 && Independent) {
+#pragma omp for simd schedule(runtime)
+        for (Index i = 0; i < total; ++i)
+          call(id<1> { i }, i);
+      } else {
+#pragma omp for schedule(runtime)
+        for (Index l = 0; l < total; ++l)
+          iterate(l, l + 1);
+      }
+    }
+    return;
+  }
+  // The CPUs keeping the slices of the successive kernels, if any
+  auto cpus = cache_affinity_cpus(where);
+#pragma omp parallel num_threads(share.get_threads())
+  {
+    std::size_t t = omp_get_thread_num();
+    std::size_t n = omp_get_num_threads();
+    /* Process the slice of this thread on the node where it has
+       been first touched */
+    if (where)
+      where->pin_team_member(t, n);
+    placement::slice_scope in_slice { cpus, t, n };
+    perf_counters::scope in_team { counting };
+    iterate(total*t/n, total*(t + 1)/n);
+  }
+#else
+  iterate(0, total);
+#endif
+}
+
+
+/** Execute a kernel on a range by tiles, in the order requested by
+    the queue
+
+    The tiles are distributed statically among the OpenMP threads by
+    default, so each thread gets a contiguous part of the curve.
+
+    \param[in] cost is the estimated cost of a work-item, as for
+    parallel_for_simd_iterate()
+*/
+template <int Dimensions, typename ParallelForFunctor>
+void parallel_for_tiled(range<Dimensions> r,
+                        ParallelForFunctor &f,
+                        const partitioning &p,
+                        std::size_t cost = 1) {
+  ordered_tiles<Dimensions> t { r, p.tile, p.iteration };
+  std::ptrdiff_t n = t.tiles.size();
+#ifdef _OPENMP
+  if (!concurrency_governor::is_worth_parallelizing(r.size(), cost)) {
+    for (std::ptrdiff_t i = 0; i < n; ++i)
+      t.iterate_tile(i, f);
+    return;
+  }
+  // Do not oversubscribe the cores with the other running kernels
+  auto share = concurrency_governor::instance().acquire();
+  auto threads = apply_schedule(share);
+  // The placement of the worker executing the kernel, if any
+  auto where = placement::current();
+  // The CPUs keeping the slices of the successive kernels, if any
+  auto cpus = cache_affinity_cpus(where);
+  // The hardware counters of the kernel, if they are sampled
+  auto counting = perf_counters::current();
+#pragma omp parallel num_threads(threads)
+  {
+    if (where)
+      where->pin_team_member(omp_get_thread_num(), omp_get_num_threads());
+    placement::slice_scope in_slice {
+      cpus,
+      static_cast<std::size_t>(omp_get_thread_num()),
+      static_cast<std::size_t>(omp_get_num_threads())
+    };
+    perf_counters::scope in_team { counting };
+#pragma omp for schedule(runtime)
+    for (std::ptrdiff_t i = 0; i < n; ++i)
+      t.iterate_tile(i, f);
+  }
+#else
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+    t.iterate_tile(i, f);
+#endif
+}
+
+
 /** Implementation of a data parallel computation with parallelism
     specified at launch time by a range<>. Kernel index is id or int.
 
-    This implementation use OpenMP 3 if compiled with the right flag.
+    This implementation use OpenMP 3 if compiled with the right flag,
+    or an OpenMP target device with \c TRISYCL_OMP_TARGET.
 */
 template <int Dimensions = 1, typename ParallelForFunctor, typename Id>
 void parallel_for(range<Dimensions> r,
-                  ParallelForFunctor f,
+                  ParallelForFunctor &&f,
                   Id) {
+#ifdef TRISYCL_OMP_TARGET
+  if (has_omp_target()) {
+    parallel_for_omp_target(r, f);
+    return;
+  }
+#endif
+  if (auto p = ordered_tiles<Dimensions>::requested()) {
+    parallel_for_tiled(r, f, *p, vendor::trisycl::kernel_cost(f));
+    return;
+  }
+  if constexpr (Dimensions <= 3) {
+    using kernel = std::remove_cvref_t<ParallelForFunctor>;
+    parallel_for_simd_iterate<vendor::trisycl::work_item_index_t<kernel>,
+                              vendor::trisycl::is_independent_kernel_v<kernel>>
+      (r, f, vendor::trisycl::kernel_cost(f));
+  } else {
 #ifdef _OPENMP
-  // Use OpenMP for the top loop level
-  parallel_OpenMP_for_iterate<Dimensions,
-                              range<Dimensions>,
-                              ParallelForFunctor,
-                              id<Dimensions>> { r, f };
+    // Use OpenMP for the top loop level
+    parallel_OpenMP_for_iterate<Dimensions,
+                                range<Dimensions>,
+                                ParallelForFunctor,
+                                id<Dimensions>> { r, f };
 #else
-  // In a sequential execution there is only one index processed at a time
-  id<Dimensions> index;
-  parallel_for_iterate<Dimensions,
-                       range<Dimensions>,
-                       ParallelForFunctor,
-                       id<Dimensions>> { r, f, index };
+    // In a sequential execution there is only one index processed at a time
+    id<Dimensions> index;
+    parallel_for_iterate<Dimensions,
+                         range<Dimensions>,
+                         ParallelForFunctor,
+                         id<Dimensions>> { r, f, index };
 #endif
+  }
 }
 
 
-/** Implementation of a data parallel computation with parallelism
-    specified at launch time by a range<>. Kernel index is item.
+/** Execute a kernel taking an item<> on a range with an offset
 
-    This implementation use OpenMP 3 if compiled with the right flag.
+    The items are reconstructed from the ids, with the linear ids
+    advanced by the loops themselves when they can.
 */
-template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for(range<Dimensions> r,
-                  ParallelForFunctor f,
-                  item<Dimensions>) {
-  auto reconstruct_item = [&] (id<Dimensions> l) {
+template <int Dimensions, typename ParallelForFunctor>
+void parallel_for_items(range<Dimensions> r,
+                        id<Dimensions> offset,
+                        ParallelForFunctor &f) {
+  // The strides of the linear id, computed once for all the work-items
+  const linear_strides<Dimensions> strides { r };
+  // The linear id of an item does not depend on the offset
+  auto reconstruct_item = [&] (id<Dimensions> l, std::size_t linear) {
     // Reconstruct the global item
-    item<Dimensions> index { r, l };
+    item<Dimensions> index { r, l + offset, offset, strides, linear };
     // Call the user kernel with the item<> instead of the id<>
     f(index);
   };
+  // For the loops which do not track the linear ids
+  auto reconstruct_item_of_id = [&] (id<Dimensions> l) {
+    reconstruct_item(l, strides(l));
+  };
+#ifdef TRISYCL_OMP_TARGET
+  if (has_omp_target()) {
+    parallel_for_omp_target(r, reconstruct_item_of_id);
+    return;
+  }
+#endif
+  if (auto p = ordered_tiles<Dimensions>::requested()) {
+    parallel_for_tiled(r, reconstruct_item_of_id, *p,
+                       vendor::trisycl::kernel_cost(f));
+    return;
+  }
+  if constexpr (Dimensions <= 3) {
+    using kernel = std::remove_cvref_t<ParallelForFunctor>;
+    parallel_for_simd_iterate<vendor::trisycl::work_item_index_t<kernel>,
+                              vendor::trisycl::is_independent_kernel_v<kernel>>
+      (r, reconstruct_item, vendor::trisycl::kernel_cost(f));
+  } else {
 #ifdef _OPENMP
-  // Use OpenMP for the top loop level
-  parallel_OpenMP_for_iterate<Dimensions,
-                              range<Dimensions>,
-                              decltype(reconstruct_item),
-                              id<Dimensions>> { r, reconstruct_item };
+    // Use OpenMP for the top loop level
+    parallel_OpenMP_for_iterate<Dimensions,
+                                range<Dimensions>,
+                                decltype(reconstruct_item_of_id),
+                                id<Dimensions>> { r, reconstruct_item_of_id };
 #else
-  // In a sequential execution there is only one index processed at a time
-  id<Dimensions> index;
-  parallel_for_iterate<Dimensions,
-                       range<Dimensions>,
-                       decltype(reconstruct_item),
-                       id<Dimensions>> { r, reconstruct_item, index };
+    // In a sequential execution there is only one index processed at a time
+    id<Dimensions> index;
+    parallel_for_iterate<Dimensions,
+                         range<Dimensions>,
+                         decltype(reconstruct_item_of_id),
+                         id<Dimensions>> { r, reconstruct_item_of_id, index };
 #endif
+  }
+}
+
+
+/** Implementation of a data parallel computation with parallelism
+    specified at launch time by a range<>. Kernel index is item.
+
+    This implementation use OpenMP 3 if compiled with the right flag.
+*/
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for(range<Dimensions> r,
+                  ParallelForFunctor &&f,
+                  item<Dimensions>) {
+  parallel_for_items(r, id<Dimensions> {}, f);
 }
 
 
@@ -215,14 +579,15 @@ auto capture_arg_v(R(F::*)(A) const) { return A{}; }
 */
 #if !defined(TRISYCL_USE_OPENCL_ND_RANGE)
 template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for(range<Dimensions> r, ParallelForFunctor f) {
-  parallel_for(r,f, capture_arg_v(&ParallelForFunctor::operator()));
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f) {
+  parallel_for(r, f, capture_arg_v(
+    &std::remove_cvref_t<ParallelForFunctor>::operator()));
 }
 #else
 template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for(range<Dimensions> r, ParallelForFunctor f) {
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f) {
   f(sycl::detail::spir::create_parallel_for_arg<Dimensions>(capture_arg_v(
-    &ParallelForFunctor::operator())));
+    &std::remove_cvref_t<ParallelForFunctor>::operator())));
 }
 #endif
 
@@ -231,26 +596,67 @@ void parallel_for(range<Dimensions> r, ParallelForFunctor f) {
 template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for_global_offset(range<Dimensions> global_size,
                                 id<Dimensions> offset,
-                                ParallelForFunctor f) {
-  // Reconstruct the item from its id<> and its offset
-  auto reconstruct_item = [&] (id<Dimensions> l) {
-    // Reconstruct the global item
-    item<Dimensions> index { global_size, l + offset, offset };
-    // Call the user kernel with the item<> instead of the id<>
-    f(index);
-  };
-
-  // First iterate on all the work-groups
-  parallel_for(global_size, reconstruct_item);
+                                ParallelForFunctor &&f) {
+  parallel_for_items(global_size, offset, f);
 }
 
 
-/// Implement the loop on the work-groups
+/** Implement the loop on the work-groups
+
+    With OpenMP, the work-groups are distributed among the threads and
+    the work-items of a work-group are executed by the thread of the
+    work-group.
+
+    \param[in] local_memory_size is the number of bytes of local
+    memory of each work-group, taken from the arena of the thread
+    executing it
+*/
 template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for_workgroup(nd_range<Dimensions> r,
-                            ParallelForFunctor f) {
+                            ParallelForFunctor &&f,
+                            std::size_t local_memory_size = 0) {
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+  /* The work-groups are the ones of the OpenCL ND-range of the
+     kernel, so each work-item of the device runs the code of its
+     work-group, with the local memory of the device */
+  f(spir::make_spir_group<Dimensions>());
+#elif defined(_OPENMP)
+  const auto groups = r.get_group_range();
+  // Do not oversubscribe the cores with the other running kernels
+  auto share = concurrency_governor::instance().acquire();
+  /* The work-groups of a hierarchical kernel often have unequal
+     costs, so they are handed out one at a time to the threads as they
+     become idle, unless the kernel asks for another schedule */
+  auto threads = apply_schedule(share, omp_sched_dynamic);
+  // The placement of the worker executing the kernel, if any
+  auto where = placement::current();
+  // The hardware counters of the kernel, if they are sampled
+  auto counting = perf_counters::current();
+#pragma omp parallel num_threads(threads)
+  {
+    if (where)
+      where->pin_team_member(omp_get_thread_num(), omp_get_num_threads());
+    perf_counters::scope in_team { counting };
+    // Distribute all the work-groups, not only along the first dimension
+#pragma omp for schedule(runtime)
+    for (std::size_t l = 0; l < groups.size(); ++l) {
+      id<Dimensions> g;
+      auto rest = l;
+      for (int d = Dimensions - 1; d >= 0; --d) {
+        g[d] = rest%groups[d];
+        rest /= groups[d];
+      }
+      // Each OpenMP thread needs its own work-group
+      local_memory_arena::group_scope in_group { local_memory_size };
+      group<Dimensions> wg { g, r };
+      f(wg);
+    }
+  }
+#else
   // In a sequential execution there is only one index processed at a time
   group<Dimensions> g { r };
+  // So the work-groups can all use the same local memory
+  local_memory_arena::group_scope in_group { local_memory_size };
 
   // First iterate on all the work-groups
   parallel_for_iterate<Dimensions,
@@ -260,17 +666,134 @@ void parallel_for_workgroup(nd_range<Dimensions> r,
     r.get_group_range(),
     f,
     g };
+#endif
+}
+
+
+/** Implement the loop on the work-items inside a work-group with the
+    current thread only
+
+    The loop nest is simple enough to be vectorized by the compiler
+    when the kernel is inlined.
+*/
+template <int Dimensions, typename T_Item, typename ParallelForFunctor>
+void sequential_for_workitem(const group<Dimensions> &g,
+                             ParallelForFunctor &f) {
+  // In a sequential execution there is only one index processed at a time
+  T_Item index { g.get_nd_range() };
+  // To iterate on the local work-item
+  id<Dimensions> local;
+  // The global id of the first work-item of the work-group
+  const auto origin = id<Dimensions>(g.get_local_range())*g.get_id();
+
+  // Reconstruct the item from its group and local id
+  auto reconstruct_item = [&] (id<Dimensions> l) {
+    // Reconstruct the global item
+    index.set_local(local);
+    index.set_global(local + origin);
+    // Call the user kernel at last
+    f(index);
+  };
+
+  // Then iterate on all the work-items of the work-group
+  parallel_for_iterate<Dimensions,
+                       range<Dimensions>,
+                       decltype(reconstruct_item),
+                       id<Dimensions>> {
+    g.get_local_range(),
+    reconstruct_item,
+    local };
+}
+
+
+/** Implement the loop on the work-items inside a work-group when the
+    kernel does not use any barrier
+
+    With OpenMP the work-items are distributed among the threads with
+    a vectorized loop.
+*/
+template <int Dimensions, typename T_Item, typename ParallelForFunctor>
+void simd_for_workitem(const group<Dimensions> &g,
+                       ParallelForFunctor &f) {
+#if defined(_OPENMP) && !defined(_MSC_VER)
+  range<Dimensions> l_r = g.get_nd_range().get_local_range();
+  id<Dimensions> id_l_r { l_r };
+
+  // The threads executing the work-items use the local memory of the group
+  auto local_memory = local_memory_arena::current();
+
+  #pragma omp parallel
+  {
+    local_memory_arena::scope in_group { local_memory };
+    if constexpr (Dimensions == 1) {
+    #pragma omp for simd collapse(1)
+      for (size_t i = 0; i < l_r.get(0); ++i) {
+        T_Item index{g.get_nd_range()};
+        index.set_local(i);
+        index.set_global(index.get_local_id() + id_l_r * g.get_id());
+        f(index);
+      }
+    } else if constexpr (Dimensions == 2) {
+    #pragma omp for simd collapse(2)
+      for (size_t i = 0; i < l_r.get(0); ++i) {
+        for (size_t j = 0; j < l_r.get(1); ++j) {
+          T_Item index{g.get_nd_range()};
+          index.set_local({i,j});
+          index.set_global(index.get_local_id() + id_l_r * g.get_id());
+          f(index);
+        }
+      }
+    } else if constexpr (Dimensions == 3) {
+      #pragma omp for simd collapse(3)
+      for (size_t i = 0; i < l_r.get(0); ++i)
+        for (size_t j = 0; j < l_r.get(1); ++j)
+          for (size_t k = 0; k < l_r.get(2); ++k) {
+            T_Item index{g.get_nd_range()};
+            index.set_local({i,j,k});
+            index.set_global(index.get_local_id() + id_l_r * g.get_id());
+            f(index);
+          }
+    }
+  }
+#else
+  sequential_for_workitem<Dimensions, T_Item>(g, f);
+#endif
 }
 
 
 /** Implement the loop on the work-items inside a work-group
 
+    The kernel is taken by reference since this is called for each
+    work-group.
+
     \todo Better type the functor
 */
 template <int Dimensions, typename T_Item, typename ParallelForFunctor>
 void parallel_for_workitem(const group<Dimensions> &g,
-                           ParallelForFunctor f) {
-#if defined(_OPENMP) && (!defined(TRISYCL_NO_BARRIER) && !defined(_MSC_VER))
+                           ParallelForFunctor &f) {
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+  /* Each work-item is a fiber running on the current thread up to its
+     next barrier, where it switches to the next work-item */
+  range<Dimensions> l_r = g.get_nd_range().get_local_range();
+  id<Dimensions> id_l_r { l_r };
+  // For the group collectives
+  work_group_scratch scratch { l_r.size() };
+  work_group_scratch::scope in_group { scratch };
+
+  auto work_item = [&] (std::size_t linear_local) {
+    // Delinearize the local id with the last dimension varying fastest
+    id<Dimensions> local;
+    for (int d = Dimensions - 1; d >= 0; --d) {
+      local[d] = linear_local % l_r[d];
+      linear_local /= l_r[d];
+    }
+    T_Item index { g.get_nd_range() };
+    index.set_local(local);
+    index.set_global(local + id_l_r*g.get_id());
+    f(index);
+  };
+  work_item_fibers::run(l_r.size(), work_item);
+#elif defined(_OPENMP) && (!defined(TRISYCL_NO_BARRIER) && !defined(_MSC_VER))
   /* To implement barriers with OpenMP, one thread is created for each
      work-item in the group and thus an OpenMP barrier has the same effect
      of an OpenCL barrier executed by the work-items in a workgroup
@@ -282,10 +805,16 @@ void parallel_for_workitem(const group<Dimensions> &g,
   id<Dimensions> id_l_r { l_r };
 
   auto tot = l_r.size();
+  // For the group collectives
+  work_group_scratch scratch { tot };
+  // The threads executing the work-items use the local memory of the group
+  auto local_memory = local_memory_arena::current();
 
   if constexpr (Dimensions == 1) {
   #pragma omp parallel for collapse(1) schedule(static) num_threads(tot)
     for (size_t i = 0; i < l_r.get(0); ++i) {
+      work_group_scratch::scope in_group { scratch };
+      local_memory_arena::scope in_local { local_memory };
       T_Item index{g.get_nd_range()};
       index.set_local(i);
       index.set_global(index.get_local_id() + id_l_r * g.get_id());
@@ -295,6 +824,8 @@ void parallel_for_workitem(const group<Dimensions> &g,
   #pragma omp parallel for collapse(2) schedule(static) num_threads(tot)
     for (size_t i = 0; i < l_r.get(0); ++i) {
       for (size_t j = 0; j < l_r.get(1); ++j) {
+        work_group_scratch::scope in_group { scratch };
+        local_memory_arena::scope in_local { local_memory };
         T_Item index{g.get_nd_range()};
         index.set_local({i,j});
         index.set_global(index.get_local_id() + id_l_r * g.get_id());
@@ -306,71 +837,18 @@ void parallel_for_workitem(const group<Dimensions> &g,
     for (size_t i = 0; i < l_r.get(0); ++i)
       for (size_t j = 0; j < l_r.get(1); ++j)
         for (size_t k = 0; k < l_r.get(2); ++k) {
+          work_group_scratch::scope in_group { scratch };
+          local_memory_arena::scope in_local { local_memory };
           T_Item index{g.get_nd_range()};
           index.set_local({i,j,k});
           index.set_global(index.get_local_id() + id_l_r * g.get_id());
           f(index);
         }
   }
-#elif defined(_OPENMP) && (defined(TRISYCL_NO_BARRIER) && !defined(_MSC_VER))
-  range<Dimensions> l_r = g.get_nd_range().get_local_range();
-  id<Dimensions> id_l_r { l_r };
-
-  if constexpr (Dimensions == 1) {
-  #pragma omp parallel for simd collapse(1)
-    for (size_t i = 0; i < l_r.get(0); ++i) {
-      T_Item index{g.get_nd_range()};
-      index.set_local(i);
-      index.set_global(index.get_local_id() + id_l_r * g.get_id());
-      f(index);
-    }
-  } else if constexpr (Dimensions == 2) {
-  #pragma omp parallel for simd collapse(2)
-    for (size_t i = 0; i < l_r.get(0); ++i) {
-      for (size_t j = 0; j < l_r.get(1); ++j) {
-        T_Item index{g.get_nd_range()};
-        index.set_local({i,j});
-        index.set_global(index.get_local_id() + id_l_r * g.get_id());
-        f(index);
-      }
-    }
-  } else if constexpr (Dimensions == 3) {
-    #pragma omp parallel for simd collapse(3)
-    for (size_t i = 0; i < l_r.get(0); ++i)
-      for (size_t j = 0; j < l_r.get(1); ++j)
-        for (size_t k = 0; k < l_r.get(2); ++k) {
-          T_Item index{g.get_nd_range()};
-          index.set_local({i,j,k});
-          index.set_global(index.get_local_id() + id_l_r * g.get_id());
-          f(index);
-        }
-  }
+#elif defined(TRISYCL_NO_BARRIER)
+  simd_for_workitem<Dimensions, T_Item>(g, f);
 #else
-  // In a sequential execution there is only one index processed at a time
-  T_Item index { g.get_nd_range() };
-  // To iterate on the local work-item
-  id<Dimensions> local;
-
-  // Reconstruct the item from its group and local id
-  auto reconstruct_item = [&] (id<Dimensions> l) {
-    //local.display();
-    //l.display();
-    // Reconstruct the global item
-    index.set_local(local);
-    // \todo Some strength reduction here
-    index.set_global(local + id<Dimensions>(g.get_local_range())*g.get_id());
-    // Call the user kernel at last
-    f(index);
-  };
-
-  // Then iterate on all the work-items of the work-group
-  parallel_for_iterate<Dimensions,
-                       range<Dimensions>,
-                       decltype(reconstruct_item),
-                       id<Dimensions>> {
-    g.get_local_range(),
-    reconstruct_item,
-    local };
+  sequential_for_workitem<Dimensions, T_Item>(g, f);
 #endif
 }
 
@@ -378,6 +856,20 @@ void parallel_for_workitem(const group<Dimensions> &g,
 /** Implement a variation of parallel_for to take into account a
     nd_range<>
 
+    A kernel marked with vendor::trisycl::no_barrier() is executed
+    without the barrier-capable execution of the work-items.
+
+    With \c TRISYCL_WORK_ITEM_FIBERS and OpenMP, the work-groups are
+    distributed among the OpenMP threads, each one executing the
+    work-items of its work-groups as fibers.
+
+    With \c TRISYCL_USE_OPENCL_ND_RANGE, the work-items are the ones
+    of the device.
+
+    \param[in] local_memory_size is the number of bytes of local
+    memory of each work-group, taken from the arena of the thread
+    executing it
+
     \todo Add an OpenMP implementation
 
     \todo Deal with incomplete work-groups
@@ -386,7 +878,16 @@ void parallel_for_workitem(const group<Dimensions> &g,
 */
 template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for(nd_range<Dimensions> r,
-                  ParallelForFunctor f) {
+                  ParallelForFunctor &&f,
+                  std::size_t local_memory_size = 0) {
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+  /* The nd_range is the OpenCL ND-range of the kernel, so the
+     work-item of the device just runs the kernel with the local
+     memory and the barriers of the device */
+  f(spir::make_spir_nd_item<Dimensions>());
+  return;
+#endif
+
   // To iterate on the work-group
   id<Dimensions> group;
   range<Dimensions> group_range = r.get_group_range();
@@ -395,16 +896,36 @@ void parallel_for(nd_range<Dimensions> r,
 
   auto iterate_in_work_group = [&] (id<Dimensions> g) {
     //group.display();
+    local_memory_arena::group_scope in_group { local_memory_size };
 
     // Then iterate on the local work-groups
     trisycl::group<Dimensions> wg {g, r};
-    parallel_for_workitem<Dimensions,
-                          nd_item<Dimensions>,
-                          decltype(f)>(wg, f);
+    if constexpr (vendor::trisycl::is_no_barrier_kernel_v<
+                    std::remove_cvref_t<ParallelForFunctor>>)
+      // No need for the barrier-capable execution
+      simd_for_workitem<Dimensions, nd_item<Dimensions>>(wg, f);
+    else
+      parallel_for_workitem<Dimensions,
+                            nd_item<Dimensions>,
+                            std::remove_reference_t<ParallelForFunctor>>
+        (wg, f);
   };
 
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+  // The work-groups are independent since a barrier only switches fibers
+  parallel_OpenMP_for_iterate<Dimensions,
+                              range<Dimensions>,
+                              decltype(iterate_in_work_group),
+                              id<Dimensions>> { group_range,
+                                                iterate_in_work_group };
+  return;
+#endif
+
 #else
 
+  // The work-groups are executed one after the other in the same memory
+  local_memory_arena::group_scope in_group { local_memory_size };
+
   // In a sequential execution there is only one index processed at a time
   nd_item<Dimensions> index { r };
 
@@ -454,6 +975,22 @@ void parallel_for(nd_range<Dimensions> r,
 template <int Dimensions, typename ParallelForFunctor>
 void parallel_for_workitem_in_group(const group<Dimensions> &g,
                                     ParallelForFunctor f) {
+#if defined(TRISYCL_USE_OPENCL_ND_RANGE)
+  /* Each work-item of the device runs its own work-item of the
+     work-group, followed by the implicit barrier of the loop */
+  f(spir::make_spir_h_item<Dimensions>());
+  spir::barrier(access::fence_space::global_and_local);
+  return;
+#endif
+#if defined(_OPENMP) \
+  && (!defined(TRISYCL_WORK_ITEM_FIBERS) || defined(TRISYCL_NO_BARRIER))
+  /* When the work-groups are already distributed among the OpenMP
+     threads, a thread executes all the work-items of its work-group */
+  if (omp_in_parallel()) {
+    sequential_for_workitem<Dimensions, h_item<Dimensions>>(g, f);
+    return;
+  }
+#endif
   parallel_for_workitem<Dimensions,
                         h_item<Dimensions>,
                         ParallelForFunctor>(g, f);
@@ -7,80 +7,178 @@
     Intel Threading Building Blocks (TBB). This file gets conditionally included
     in "trisycl/parallelism.hpp" if TRISYCL_TBB is defined by the preprocessor.
 
+    It lives in its own namespace next to the OpenMP back-end, so a
+    kernel can use either with vendor::trisycl::use_backend().
+
     jeffamstutz at gmail dot com
 
     This file is distributed under the University of Illinois Open Source
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <mutex>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/detail/perf_counters.hpp"
 #include "triSYCL/group.hpp"
 #include "triSYCL/h_item.hpp"
 #include "triSYCL/id.hpp"
 #include "triSYCL/item.hpp"
 #include "triSYCL/nd_item.hpp"
 #include "triSYCL/nd_range.hpp"
+#include "triSYCL/parallelism/detail/iteration_order.hpp"
+#include "triSYCL/parallelism/detail/local_memory_arena.hpp"
 #include "triSYCL/range.hpp"
+#include "triSYCL/vendor/triSYCL/cost_hint.hpp"
+#include "triSYCL/vendor/triSYCL/no_barrier.hpp"
 
 #include <tbb/blocked_range2d.h>
 #include <tbb/blocked_range3d.h>
 #include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
 
 /** \addtogroup parallelism
     @{
 */
 
-namespace trisycl::detail {
+namespace trisycl::detail::tbb_backend {
 
-static inline auto to_tbb_range(const range<1> &r)
+/** Make a TBB range from a SYCL range, with a grain size along the
+    last dimension
+*/
+static inline auto to_tbb_range(const range<1> &r, std::size_t grain)
 {
-  return tbb::blocked_range<size_t>(0, r[0]);
+  return tbb::blocked_range<size_t>(0, r[0], grain);
 }
 
-static inline auto to_tbb_range(const range<2> &r)
+static inline auto to_tbb_range(const range<2> &r, std::size_t grain)
 {
-  return tbb::blocked_range2d<size_t>(0, r[0], 0, r[1]);
+  return tbb::blocked_range2d<size_t>(0, r[0], 1, 0, r[1], grain);
 }
 
-static inline auto to_tbb_range(const range<3> &r)
+static inline auto to_tbb_range(const range<3> &r, std::size_t grain)
 {
-  return tbb::blocked_range3d<size_t>(0, r[0], 0, r[1], 0, r[2]);
+  return tbb::blocked_range3d<size_t>(0, r[0], 1, 0, r[1], 1,
+                                      0, r[2], grain);
 }
 
-static inline auto to_sycl_id(const tbb::blocked_range<size_t> &in)
+/// Execute a functor on all the ids of a TBB chunk
+template <typename ParallelForFunctor>
+void iterate_chunk(const tbb::blocked_range<size_t> &in,
+                   ParallelForFunctor &f)
 {
-  return make_id(in.begin());
+  for (auto i = in.begin(); i != in.end(); ++i)
+    f(id<1> { i });
 }
 
-static inline auto to_sycl_id(const tbb::blocked_range2d<size_t> &in)
+template <typename ParallelForFunctor>
+void iterate_chunk(const tbb::blocked_range2d<size_t> &in,
+                   ParallelForFunctor &f)
 {
-  const auto cols = in.cols().begin();
-  const auto rows = in.rows().begin();
-  return make_id(rows, cols);
+  for (auto r = in.rows().begin(); r != in.rows().end(); ++r)
+    for (auto c = in.cols().begin(); c != in.cols().end(); ++c)
+      f(id<2> { r, c });
 }
 
-static inline auto to_sycl_id(const tbb::blocked_range3d<size_t> &in)
+template <typename ParallelForFunctor>
+void iterate_chunk(const tbb::blocked_range3d<size_t> &in,
+                   ParallelForFunctor &f)
 {
-  const auto pages = in.pages().begin();
-  const auto cols = in.cols().begin();
-  const auto rows = in.rows().begin();
-  return make_id(rows, cols, pages);
+  for (auto p = in.pages().begin(); p != in.pages().end(); ++p)
+    for (auto r = in.rows().begin(); r != in.rows().end(); ++r)
+      for (auto c = in.cols().begin(); c != in.cols().end(); ++c)
+        f(id<3> { p, r, c });
 }
 
+/** Execute a TBB parallel_for with the partitioner chosen for the
+    queue running the kernel
+*/
+template <typename TBBRange, typename Body>
+void parallel_for_partitioned(const TBBRange &chunks, Body &body,
+                              const partitioning &p)
+{
+  switch (p.partitioner) {
+  case partitioning::kind::affinity_partitioner: {
+    /* Since a functor type comes from a given kernel, this replays the
+       chunk mapping of the previous launch of the kernel. A
+       partitioner cannot be used concurrently, so the concurrent
+       launches use another partitioner */
+    static tbb::affinity_partitioner affinity;
+    static std::mutex in_use;
+    if (std::unique_lock lock { in_use, std::try_to_lock };
+        lock.owns_lock()) {
+      tbb::parallel_for(chunks, body, affinity);
+      return;
+    }
+  }
+    [[fallthrough]];
+  case partitioning::kind::auto_partitioner:
+    tbb::parallel_for(chunks, body, tbb::auto_partitioner {});
+    return;
+  case partitioning::kind::static_partitioner:
+    tbb::parallel_for(chunks, body, tbb::static_partitioner {});
+    return;
+  case partitioning::kind::simple_partitioner:
+    tbb::parallel_for(chunks, body, tbb::simple_partitioner {});
+    return;
+  }
+}
+
+/** Iterate on a range by chunks, according to the partitioning of the
+    queue running the kernel
+
+    \param[in] cost is the estimated cost of a work-item, a kernel too
+    small to be worth splitting being executed by the current thread
+*/
 template <typename Range, typename ParallelForFunctor>
-void parallel_for_iterate(Range r, ParallelForFunctor &f)
+void parallel_for_iterate(Range r, ParallelForFunctor &f,
+                          std::size_t cost = 1)
 {
-  tbb::parallel_for(to_tbb_range(r),
-                    [&](auto idx) { f(to_sycl_id(idx)); },
-                    tbb::simple_partitioner{});
+  auto p = partitioning::current() ? *partitioning::current()
+                                   : partitioning {};
+  // The hardware counters of the kernel, if they are sampled
+  auto counting = perf_counters::current();
+  auto worth = concurrency_governor::is_worth_parallelizing(r.size(), cost);
+  if (ordered_tiles<Range::rank()>::requested()) {
+    // Split the sequence of tiles instead of the iteration space
+    ordered_tiles<Range::rank()> t { r, p.tile, p.iteration };
+    auto tiles = [&](const tbb::blocked_range<std::size_t> &chunk) {
+      perf_counters::scope in_chunk { counting };
+      for (auto i = chunk.begin(); i != chunk.end(); ++i)
+        t.iterate_tile(i, f);
+    };
+    tbb::blocked_range<std::size_t> all { 0, t.tiles.size() };
+    if (!worth) {
+      tiles(all);
+      return;
+    }
+    p.grain_size = 1;
+    parallel_for_partitioned(all, tiles, p);
+    return;
+  }
+  auto chunks = to_tbb_range(r, std::max<std::size_t>(p.grain_size, 1));
+  auto body = [&](const auto &chunk) {
+    perf_counters::scope in_chunk { counting };
+    iterate_chunk(chunk, f);
+  };
+  if (!worth) {
+    body(chunks);
+    return;
+  }
+  parallel_for_partitioned(chunks, body, p);
 }
 
 /** Implementation of a data parallel computation with parallelism
     specified at launch time by a range<>. Kernel index is id or int.
 */
 template <int Dimensions = 1, typename ParallelForFunctor, typename Id>
-void parallel_for(range<Dimensions> r, ParallelForFunctor f, Id)
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f, Id)
 {
-  parallel_for_iterate(r, f);
+  tbb_backend::parallel_for_iterate(r, f, vendor::trisycl::kernel_cost(f));
 }
 
 /** Implementation of a data parallel computation with parallelism
@@ -88,60 +186,83 @@ void parallel_for(range<Dimensions> r, ParallelForFunctor f, Id)
 */
 template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for(range<Dimensions> r,
-                  ParallelForFunctor f,
+                  ParallelForFunctor &&f,
                   item<Dimensions>)
 {
+  const linear_strides<Dimensions> strides{r};
   auto reconstruct_item = [&](id<Dimensions> l) {
-    item<Dimensions> index{r, l};
+    item<Dimensions> index{r, l, {}, strides};
     f(index);
   };
 
-  parallel_for_iterate(r, reconstruct_item);
+  tbb_backend::parallel_for_iterate(r, reconstruct_item,
+                                   vendor::trisycl::kernel_cost(f));
 }
 
 /** Calls the appropriate ternary parallel_for overload based on the
     index type of the kernel function object f
 */
 template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for(range<Dimensions> r, ParallelForFunctor f)
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f)
 {
-  using mf_t = decltype(std::mem_fn(&ParallelForFunctor::operator()));
+  using mf_t = decltype(std::mem_fn(
+    &std::remove_cvref_t<ParallelForFunctor>::operator()));
   using arg_t = typename mf_t::second_argument_type;
-  parallel_for(r, f, arg_t{});
+  tbb_backend::parallel_for(r, f, arg_t{});
 }
 
 /// Implementation of parallel_for with a range<> and an offset
 template <int Dimensions = 1, typename ParallelForFunctor>
 void parallel_for_global_offset(range<Dimensions> global_size,
                                 id<Dimensions> offset,
-                                ParallelForFunctor f)
+                                ParallelForFunctor &&f)
 {
+  const linear_strides<Dimensions> strides{global_size};
   auto reconstruct_item = [&](id<Dimensions> l) {
-    item<Dimensions> index{global_size, l + offset, offset};
+    item<Dimensions> index{global_size, l + offset, offset, strides};
     f(index);
   };
 
-  parallel_for(global_size, reconstruct_item);
+  tbb_backend::parallel_for(global_size,
+                            vendor::trisycl::cost_hint(
+                              vendor::trisycl::kernel_cost(f),
+                              reconstruct_item));
 }
 
-/// Implement the loop on the work-groups
+/** Implement the loop on the work-groups
+
+    \param[in] local_memory_size is the number of bytes of local
+    memory of each work-group, taken from the arena of the thread
+    executing it
+*/
 template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for_workgroup(nd_range<Dimensions> r, ParallelForFunctor f)
+void parallel_for_workgroup(nd_range<Dimensions> r, ParallelForFunctor &&f,
+                            std::size_t local_memory_size = 0)
 {
   auto reconstruct_group = [&](id<Dimensions> l) {
+    local_memory_arena::group_scope in_group{local_memory_size};
     group<Dimensions> group{l, r};
     f(group);
   };
 
-  parallel_for_iterate(r.get_group_range(), reconstruct_group);
+  // A work-group costs as much as its work-items
+  tbb_backend::parallel_for_iterate(r.get_group_range(), reconstruct_group,
+                                    r.get_local_range().size());
 }
 
-/// Implement the loop on the work-items inside a work-group
+/** Implement the loop on the work-items inside a work-group
+
+    The kernel is taken by reference since this is called for each
+    work-group.
+*/
 template <int Dimensions, typename T_Item, typename ParallelForFunctor>
 void parallel_for_workitem(const group<Dimensions> &g,
-                           ParallelForFunctor f)
+                           ParallelForFunctor &f)
 {
+  // The work-items may be stolen by other threads
+  auto local_memory = local_memory_arena::current();
   auto reconstruct_item = [&](id<Dimensions> local) {
+    local_memory_arena::scope in_group{local_memory};
     T_Item index{g.get_nd_range()};
     index.set_local(local);
     index.set_global(local +
@@ -149,35 +270,30 @@ void parallel_for_workitem(const group<Dimensions> &g,
     f(index);
   };
 
-  parallel_for_iterate(g.get_local_range(), reconstruct_item);
+  tbb_backend::parallel_for_iterate(g.get_local_range(), reconstruct_item);
 }
 
 /// Implement a variation of parallel_for to take into account a nd_range<>
 template <int Dimensions = 1, typename ParallelForFunctor>
-void parallel_for(nd_range<Dimensions> r, ParallelForFunctor f)
+void parallel_for(nd_range<Dimensions> r, ParallelForFunctor &&f,
+                  std::size_t local_memory_size = 0)
 {
   auto iterate_in_work_group = [&](id<Dimensions> g) {
+    local_memory_arena::group_scope in_group{local_memory_size};
     trisycl::group<Dimensions> wg{g, r};
-    parallel_for_workitem<Dimensions, nd_item<Dimensions>, decltype(f)>(
-        wg, f);
+    tbb_backend::parallel_for_workitem<
+      Dimensions, nd_item<Dimensions>,
+      std::remove_reference_t<ParallelForFunctor>>(wg, f);
   };
 
-  parallel_for_iterate(r.get_group_range(), iterate_in_work_group);
-}
-
-/// Implement the loop on the work-items inside a work-group
-template <int Dimensions, typename ParallelForFunctor>
-void parallel_for_workitem_in_group(const group<Dimensions> &g,
-                                    ParallelForFunctor f)
-{
-  parallel_for_workitem<Dimensions,
-                        h_item<Dimensions>,
-                        ParallelForFunctor>(g, f);
+  tbb_backend::parallel_for_iterate(r.get_group_range(),
+                                    iterate_in_work_group,
+                                    r.get_local_range().size());
 }
 
 /// @} End the parallelism Doxygen group
 
-} // namespace trisycl::detail
+} // namespace trisycl::detail::tbb_backend
 
 /*
     # Some Emacs stuff:
@@ -0,0 +1,369 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_PARALLELISM_WORK_STEALING_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_PARALLELISM_WORK_STEALING_HPP
+
+/** \file
+
+    Implement the detail of the parallel constructions to launch kernels
+    with some work stealing on the fibers running the SYCL tasks. This
+    file gets conditionally included in "trisycl/parallelism.hpp" if
+    TRISYCL_WORK_STEALING is defined by the preprocessor.
+
+    The iteration space is split recursively in halves. The upper half
+    is launched on a new fiber which the idle threads of the pool steal
+    with the pooled_work_stealing scheduler, while the current fiber
+    goes on with the lower half. So the irregular kernels balance their
+    load, and the kernels and the tasks share the same threads instead
+    of competing with an OpenMP team.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#ifndef TRISYCL_FIBER_TASKS
+#error "TRISYCL_WORK_STEALING requires the tasks to run as fibers with \
+TRISYCL_FIBER_TASKS"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <type_traits>
+
+#include <boost/fiber/fiber.hpp>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/fiber_pool.hpp"
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/detail/perf_counters.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/group.hpp"
+#include "triSYCL/h_item.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/item.hpp"
+#include "triSYCL/nd_item.hpp"
+#include "triSYCL/nd_range.hpp"
+#include "triSYCL/parallelism/detail/flexible_range.hpp"
+#include "triSYCL/parallelism/detail/iteration_order.hpp"
+#include "triSYCL/parallelism/detail/local_memory_arena.hpp"
+#include "triSYCL/range.hpp"
+#include "triSYCL/vendor/triSYCL/cost_hint.hpp"
+#include "triSYCL/vendor/triSYCL/no_barrier.hpp"
+
+/** \addtogroup parallelism
+    @{
+*/
+
+namespace trisycl::detail {
+
+/** Call \p chunk(first, last) on some chunks of at most \p grain
+    elements covering [\p first, \p last)
+
+    The upper half is left to the thieves on a new fiber, posted to
+    the ready queue of the current thread, and the lower half is
+    processed by the current fiber before joining the upper one.
+*/
+template <typename Chunk>
+void split_and_steal(std::size_t first, std::size_t last, std::size_t grain,
+                     Chunk &chunk)
+{
+  if (last - first <= grain) {
+    chunk(first, last);
+    return;
+  }
+  auto middle = first + (last - first)/2;
+  std::exception_ptr upper_exception;
+  boost::fibers::fiber upper { boost::fibers::launch::post, [&, middle] {
+      try {
+        split_and_steal(middle, last, grain, chunk);
+      } catch (...) {
+        upper_exception = std::current_exception();
+      }
+    } };
+  try {
+    split_and_steal(first, middle, grain, chunk);
+  } catch (...) {
+    // The upper half uses this stack frame, so wait for it anyway
+    upper.join();
+    throw;
+  }
+  upper.join();
+  if (upper_exception)
+    std::rethrow_exception(upper_exception);
+}
+
+
+/** Call \p chunk(first, last) on some chunks of [0, \p count) stolen
+    by the threads of the fiber pool
+
+    A kernel is normally executed by a task on a fiber of the pool, so
+    the chunks are launched from there. Otherwise, such as for a
+    kernel executed inline by the submitting thread, the whole loop is
+    handed to the pool of the tasks and waited for.
+*/
+template <typename Chunk>
+void parallel_chunks(std::size_t count, std::size_t grain, Chunk &chunk)
+{
+  if (fiber_pool::current()) {
+    split_and_steal(0, count, grain, chunk);
+    return;
+  }
+  std::promise<void> done;
+  task_executor::default_pool()->submit([&] {
+      try {
+        split_and_steal(0, count, grain, chunk);
+        done.set_value();
+      } catch (...) {
+        done.set_exception(std::current_exception());
+      }
+    });
+  done.get_future().get();
+}
+
+
+/** Get the number of elements of the chunks of a loop on \p count
+    elements, according to the partitioning of the queue running the
+    kernel
+
+    \param[in] minimum is the minimum chunk size asked by the queue,
+    in elements of the loop
+*/
+inline std::size_t chunk_size(std::size_t count, std::size_t minimum,
+                              const partitioning &p)
+{
+  if (p.partitioner == partitioning::kind::simple_partitioner)
+    return std::max<std::size_t>(minimum, 1);
+  std::size_t threads = fiber_pool::current()
+    ? fiber_pool::current()->get_thread_number()
+    : task_executor::default_pool()->get_capacity();
+  // A few chunks per thread to have something to steal, or 1 chunk
+  // per thread with the static partitioning
+  auto chunks = p.partitioner == partitioning::kind::static_partitioner
+    ? threads : 8*threads;
+  return std::max({ std::size_t { 1 }, minimum,
+                    (count + chunks - 1)/chunks });
+}
+
+
+/** Execute a functor on the ids of some rows of a range
+
+    The rows are along the last dimension and are numbered in
+    row-major order, so the innermost loop is contiguous and can be
+    vectorized.
+*/
+template <typename ParallelForFunctor>
+void iterate_rows(const range<1> &, std::size_t first, std::size_t last,
+                  ParallelForFunctor &f)
+{
+  for (auto i = first; i != last; ++i)
+    f(id<1> { i });
+}
+
+template <typename ParallelForFunctor>
+void iterate_rows(const range<2> &r, std::size_t first, std::size_t last,
+                  ParallelForFunctor &f)
+{
+  for (auto row = first; row != last; ++row)
+    for (std::size_t c = 0; c != r[1]; ++c)
+      f(id<2> { row, c });
+}
+
+template <typename ParallelForFunctor>
+void iterate_rows(const range<3> &r, std::size_t first, std::size_t last,
+                  ParallelForFunctor &f)
+{
+  for (auto row = first; row != last; ++row)
+    for (std::size_t c = 0; c != r[2]; ++c)
+      f(id<3> { row/r[1], row%r[1], c });
+}
+
+/** Iterate on a range by stolen chunks of rows, according to the
+    partitioning of the queue running the kernel
+
+    \param[in] cost is the estimated cost of a work-item, a kernel too
+    small to be worth splitting being executed by the current fiber
+*/
+template <typename Range, typename ParallelForFunctor>
+void parallel_for_iterate(Range r, ParallelForFunctor &f,
+                          std::size_t cost = 1)
+{
+  constexpr auto rank = Range::rank();
+  static_assert(rank <= 3, "only up to 3 dimensions are handled");
+  if (r.size() == 0)
+    return;
+  // The partitioning is per thread while the chunks may migrate
+  auto p = partitioning::current() ? *partitioning::current()
+                                   : partitioning {};
+  // The hardware counters of the kernel, if they are sampled
+  auto counting = perf_counters::current();
+  auto worth = concurrency_governor::is_worth_parallelizing(r.size(), cost);
+  if (ordered_tiles<rank>::requested()) {
+    // Split the sequence of tiles instead of the iteration space
+    ordered_tiles<rank> t { r, p.tile, p.iteration };
+    auto tiles = [&] (std::size_t first, std::size_t last) {
+      perf_counters::scope in_chunk { counting };
+      for (auto i = first; i != last; ++i)
+        t.iterate_tile(i, f);
+    };
+    if (!worth) {
+      tiles(0, t.tiles.size());
+      return;
+    }
+    parallel_chunks(t.tiles.size(), chunk_size(t.tiles.size(), 1, p),
+                    tiles);
+    return;
+  }
+  std::size_t row_length = rank == 1 ? 1 : r[rank - 1];
+  auto rows = r.size()/row_length;
+  auto body = [&] (std::size_t first, std::size_t last) {
+    perf_counters::scope in_chunk { counting };
+    iterate_rows(r, first, last, f);
+  };
+  if (!worth) {
+    body(0, rows);
+    return;
+  }
+  // The grain size of the queue is along the last dimension
+  parallel_chunks(rows, chunk_size(rows, p.grain_size/row_length, p), body);
+}
+
+/** Implementation of a data parallel computation with parallelism
+    specified at launch time by a range<>. Kernel index is id or int.
+*/
+template <int Dimensions = 1, typename ParallelForFunctor, typename Id>
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f, Id)
+{
+  parallel_for_iterate(r, f, vendor::trisycl::kernel_cost(f));
+}
+
+/** Implementation of a data parallel computation with parallelism
+    specified at launch time by a range<>. Kernel index is item.
+*/
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for(range<Dimensions> r,
+                  ParallelForFunctor &&f,
+                  item<Dimensions>)
+{
+  const linear_strides<Dimensions> strides{r};
+  auto reconstruct_item = [&](id<Dimensions> l) {
+    item<Dimensions> index{r, l, {}, strides};
+    f(index);
+  };
+
+  parallel_for_iterate(r, reconstruct_item, vendor::trisycl::kernel_cost(f));
+}
+
+/** Calls the appropriate ternary parallel_for overload based on the
+    index type of the kernel function object f
+*/
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for(range<Dimensions> r, ParallelForFunctor &&f)
+{
+  using mf_t = decltype(std::mem_fn(
+    &std::remove_cvref_t<ParallelForFunctor>::operator()));
+  using arg_t = typename mf_t::second_argument_type;
+  parallel_for(r, f, arg_t{});
+}
+
+/// Implementation of parallel_for with a range<> and an offset
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for_global_offset(range<Dimensions> global_size,
+                                id<Dimensions> offset,
+                                ParallelForFunctor &&f)
+{
+  const linear_strides<Dimensions> strides{global_size};
+  auto reconstruct_item = [&](id<Dimensions> l) {
+    item<Dimensions> index{global_size, l + offset, offset, strides};
+    f(index);
+  };
+
+  parallel_for(global_size,
+               vendor::trisycl::cost_hint(vendor::trisycl::kernel_cost(f),
+                                          reconstruct_item));
+}
+
+/** Implement the loop on the work-groups
+
+    \param[in] local_memory_size is the number of bytes of local
+    memory of each work-group, taken from the arena of the thread
+    executing it
+*/
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for_workgroup(nd_range<Dimensions> r, ParallelForFunctor &&f,
+                            std::size_t local_memory_size = 0)
+{
+  auto reconstruct_group = [&](id<Dimensions> l) {
+    local_memory_arena::group_scope in_group{local_memory_size};
+    group<Dimensions> group{l, r};
+    f(group);
+  };
+
+  // A work-group costs as much as its work-items
+  parallel_for_iterate(r.get_group_range(), reconstruct_group,
+                       r.get_local_range().size());
+}
+
+/** Implement the loop on the work-items inside a work-group
+
+    The kernel is taken by reference since this is called for each
+    work-group.
+*/
+template <int Dimensions, typename T_Item, typename ParallelForFunctor>
+void parallel_for_workitem(const group<Dimensions> &g,
+                           ParallelForFunctor &f)
+{
+  // The work-items may be stolen by other threads
+  auto local_memory = local_memory_arena::current();
+  auto reconstruct_item = [&](id<Dimensions> local) {
+    local_memory_arena::scope in_group{local_memory};
+    T_Item index{g.get_nd_range()};
+    index.set_local(local);
+    index.set_global(local +
+                     id<Dimensions>(g.get_local_range()) * g.get_id());
+    f(index);
+  };
+
+  parallel_for_iterate(g.get_local_range(), reconstruct_item);
+}
+
+/// Implement a variation of parallel_for to take into account a nd_range<>
+template <int Dimensions = 1, typename ParallelForFunctor>
+void parallel_for(nd_range<Dimensions> r, ParallelForFunctor &&f,
+                  std::size_t local_memory_size = 0)
+{
+  auto iterate_in_work_group = [&](id<Dimensions> g) {
+    local_memory_arena::group_scope in_group{local_memory_size};
+    trisycl::group<Dimensions> wg{g, r};
+    parallel_for_workitem<Dimensions, nd_item<Dimensions>,
+                          std::remove_reference_t<ParallelForFunctor>>(wg, f);
+  };
+
+  parallel_for_iterate(r.get_group_range(), iterate_in_work_group,
+                       r.get_local_range().size());
+}
+
+/// Implement the loop on the work-items inside a work-group
+template <int Dimensions, typename ParallelForFunctor>
+void parallel_for_workitem_in_group(const group<Dimensions> &g,
+                                    ParallelForFunctor f)
+{
+  parallel_for_workitem<Dimensions,
+                        h_item<Dimensions>,
+                        ParallelForFunctor>(g, f);
+}
+
+/// @} End the parallelism Doxygen group
+
+} // namespace trisycl::detail
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_PARALLELISM_WORK_STEALING_HPP
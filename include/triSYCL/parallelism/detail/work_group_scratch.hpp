@@ -0,0 +1,169 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_GROUP_SCRATCH_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_GROUP_SCRATCH_HPP
+
+/** \file
+
+    The memory shared by the work-items of a work-group to implement
+    the group collectives
+
+    Each work-item writes its contribution into its own slot, waits
+    once for the work-group and then reads the contributions of the
+    others. The collectives use 2 banks of slots in turn: a work-item
+    cannot write again into a bank before all the work-items have gone
+    through the next collective, so after they have read this bank.
+
+    When the work-items are fibers sharing a thread, the first
+    work-item resumed after the barrier computes the result of the
+    collective for the whole work-group, into the bank itself.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/// The scratch memory of the collectives of a work-group
+class work_group_scratch {
+
+public:
+
+  /// The maximum size of the values exchanged by a collective
+  static constexpr std::size_t slot_size = 64;
+
+  /// Whether the work-items of a work-group share the same thread
+  static constexpr bool same_thread =
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+    true;
+#else
+    false;
+#endif
+
+private:
+
+  /// A slot on its own cache line
+  struct alignas(slot_size) slot {
+    std::byte data[slot_size];
+  };
+
+  static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+  /// The number of work-items in the work-group
+  std::size_t size;
+
+  /// The 2 banks of slots, allocated at the first collective
+  std::unique_ptr<slot[]> slots;
+
+  std::once_flag allocated;
+
+  /// The number of collectives entered by all the work-items
+  std::atomic<std::size_t> arrivals = 0;
+
+  /// The collective whose result is in each bank, with fibers
+  std::size_t computed[2] = { none, none };
+
+public:
+
+  /// The contributions of the work-items to a collective
+  struct contributions {
+    slot *bank;
+
+    /** True for the only work-item which has to compute the result
+        into the bank for the other ones
+    */
+    bool first;
+
+    /// Get the value in the slot \p i
+    template <typename T>
+    const T &get(std::size_t i) const {
+      return *std::launder(reinterpret_cast<const T *>(bank[i].data));
+    }
+
+    /// Write a value into the slot \p i
+    template <typename T>
+    void set(std::size_t i, const T &x) const {
+      static_assert(std::is_trivially_copyable_v<T>
+                    && sizeof(T) <= slot_size && alignof(T) <= slot_size,
+                    "a group collective only works on small scalar values");
+      ::new (bank[i].data) T(x);
+    }
+  };
+
+
+  work_group_scratch(std::size_t size) : size { size } {}
+
+
+  /// The scratch memory of the work-group of the current work-item
+  static work_group_scratch *&current() {
+    static thread_local work_group_scratch *s = nullptr;
+    return s;
+  }
+
+
+  /// Make a scratch memory current while a work-item runs on this thread
+  class scope {
+    work_group_scratch *outer;
+
+  public:
+
+    scope(work_group_scratch &s) : outer { current() } {
+      current() = &s;
+    }
+
+    ~scope() { current() = outer; }
+  };
+
+
+  /** Contribute a value to a collective and get all the contributions
+      of the work-group
+
+      \param[in] local is the local linear id of the work-item
+
+      \param[in] barrier waits for all the work-items of the work-group
+  */
+  template <typename T, typename Barrier>
+  contributions share(std::size_t local, const T &x, Barrier &&barrier) {
+    std::call_once(allocated, [&] { slots.reset(new slot[2*size]); });
+    /* All the work-items enter the collectives in the same order, so
+       the count gives the number of the collective */
+    auto collective = arrivals.fetch_add(1, std::memory_order_relaxed)/size;
+    auto b = collective % 2;
+    contributions c { &slots[b*size], false };
+    c.set(local, x);
+    barrier();
+    if constexpr (same_thread)
+      if (computed[b] != collective) {
+        computed[b] = collective;
+        c.first = true;
+      }
+    return c;
+  }
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_GROUP_SCRATCH_HPP
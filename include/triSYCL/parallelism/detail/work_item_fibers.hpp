@@ -0,0 +1,131 @@
+#ifndef TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_ITEM_FIBERS_HPP
+#define TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_ITEM_FIBERS_HPP
+
+/** \file
+
+    Execute the work-items of a work-group as fibers on the current
+    thread, so that a barrier is just a switch to the next work-item
+
+    This is used instead of 1 OpenMP thread per work-item when the
+    macro \c TRISYCL_WORK_ITEM_FIBERS is defined. The work-items are
+    resumed in turn: each one runs up to its next barrier, or up to its
+    end, before the next one is resumed. So when all the work-items
+    have been resumed once, they have all reached the same barrier.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <boost/context/fiber.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+
+/** The stack size in bytes of a work-item executed as a fiber
+
+    It can be increased for kernels with large private arrays.
+*/
+#ifndef TRISYCL_WORK_ITEM_STACK_SIZE
+#define TRISYCL_WORK_ITEM_STACK_SIZE (64*1024)
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/// Run the work-items of a work-group as fibers synchronized by barriers
+struct work_item_fibers {
+
+  /** The context to switch back to the work-group from the work-item
+      running on the current thread, if any
+  */
+  static boost::context::fiber *&work_group() {
+    static thread_local boost::context::fiber *wg = nullptr;
+    return wg;
+  }
+
+
+  /** Execute the work-items of a work-group
+
+      \param[in] n is the number of work-items
+
+      \param[in] work_item is called with the linear id of each work-item
+  */
+  template <typename WorkItem>
+  static void run(std::size_t n, WorkItem &work_item) {
+    /* The stacks are recycled from a work-group to the next one
+       executed by the same thread */
+    static thread_local boost::context::pooled_fixedsize_stack
+      stacks { TRISYCL_WORK_ITEM_STACK_SIZE };
+    std::vector<boost::context::fiber> items;
+    items.reserve(n);
+    std::exception_ptr error;
+    for (std::size_t i = 0; i != n; ++i)
+      items.emplace_back(std::allocator_arg, stacks,
+                         [&, i] (boost::context::fiber &&wg) {
+                           work_group() = &wg;
+                           try {
+                             work_item(i);
+                           } catch (const boost::context::detail::
+                                    forced_unwind &) {
+                             // Used by Boost.Context to unwind a fiber
+                             throw;
+                           } catch (...) {
+                             if (!error)
+                               error = std::current_exception();
+                           }
+                           return std::move(wg);
+                         });
+
+    // In case of a work-group executed from a work-item
+    auto outer = work_group();
+    // Resume all the work-items up to the next barrier until they end
+    for (bool running = true; running;) {
+      running = false;
+      for (auto &item : items)
+        if (item) {
+          item = std::move(item).resume();
+          running = running || item;
+        }
+    }
+    work_group() = outer;
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+
+  /// Wait for the other work-items of the work-group
+  static void barrier() {
+    auto wg = work_group();
+    // Nothing to wait for outside of a work-group
+    if (!wg)
+      return;
+    // Switch to the next work-item
+    *wg = std::move(*wg).resume();
+    // Other work-items have run on this thread in the meantime
+    work_group() = wg;
+  }
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PARALLELISM_DETAIL_WORK_ITEM_FIBERS_HPP
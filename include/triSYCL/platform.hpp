@@ -20,6 +20,7 @@
 #include "triSYCL/info/device.hpp"
 #include "triSYCL/platform/detail/host_platform.hpp"
 #ifdef TRISYCL_OPENCL
+#include "triSYCL/platform/detail/opencl_discovery.hpp"
 #include "triSYCL/platform/detail/opencl_platform.hpp"
 #endif
 #include "triSYCL/platform/detail/platform.hpp"
@@ -118,8 +119,8 @@ public:
     vector_class<platform> platforms { {} };
 
 #ifdef TRISYCL_OPENCL
-    // Then add all the OpenCL platforms
-    for (const auto &d : boost::compute::system::platforms())
+    // Then add the OpenCL platforms, enumerated only once
+    for (const auto &d : detail::opencl_discovery::instance()->get_platforms())
       platforms.emplace_back(d);
 #endif
 
@@ -0,0 +1,128 @@
+#ifndef TRISYCL_SYCL_PLATFORM_DETAIL_OPENCL_DISCOVERY_HPP
+#define TRISYCL_SYCL_PLATFORM_DETAIL_OPENCL_DISCOVERY_HPP
+
+/** \file The enumeration of the OpenCL platforms and devices
+
+    Enumerating the OpenCL platforms goes through all the installed
+    ICDs and may take hundreds of milliseconds, so it is done only once,
+    on the first need, and the platforms and their devices are kept for
+    the platform listing and the device selection.
+
+    The \c TRISYCL_OPENCL_PLATFORMS environment variable can restrict
+    the platforms used to the ones whose name contains one of its
+    comma-separated words, such as "NVIDIA,Intel".
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/compute.hpp>
+
+#include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/singleton.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/// The OpenCL platforms and devices available to the application
+class opencl_discovery : public detail::singleton<opencl_discovery> {
+
+  /// A platform with its devices
+  struct platform_devices {
+    boost::compute::platform platform;
+
+    std::vector<boost::compute::device> devices;
+  };
+
+  std::vector<platform_devices> platforms;
+
+public:
+
+  /** Test whether a platform is allowed by the filter of \c
+      TRISYCL_OPENCL_PLATFORMS
+
+      \param[in] filter is a list of comma-separated words, or nullptr
+      to allow all the platforms
+  */
+  static bool is_selected(const std::string &name, const char *filter) {
+    if (!filter)
+      return true;
+    std::istringstream words { filter };
+    for (std::string w; std::getline(words, w, ',');)
+      if (!w.empty() && name.find(w) != std::string::npos)
+        return true;
+    return false;
+  }
+
+
+  /// Enumerate the platforms and their devices
+  opencl_discovery() {
+    auto filter = std::getenv("TRISYCL_OPENCL_PLATFORMS");
+    std::vector<boost::compute::platform> all;
+    try {
+      all = boost::compute::system::platforms();
+    } catch (const boost::compute::opencl_error &) {
+      // Without any ICD, there is just the host device
+    }
+    for (auto &p : all)
+      if (is_selected(p.name(), filter)) {
+        TRISYCL_DUMP_T("Use OpenCL platform " << p.name());
+        platforms.push_back({ p, p.devices() });
+      }
+  }
+
+
+  /// Get the OpenCL platforms used
+  std::vector<boost::compute::platform> get_platforms() const {
+    std::vector<boost::compute::platform> v;
+    for (auto &p : platforms)
+      v.push_back(p.platform);
+    return v;
+  }
+
+
+  /// Get the devices of all the OpenCL platforms used
+  std::vector<boost::compute::device> get_devices() const {
+    std::vector<boost::compute::device> v;
+    for (auto &p : platforms)
+      v.insert(v.end(), p.devices.begin(), p.devices.end());
+    return v;
+  }
+
+
+  /** Get the devices of an OpenCL platform, enumerated only if it is
+      not among the platforms used
+  */
+  std::vector<boost::compute::device>
+  get_devices(const boost::compute::platform &platform) const {
+    auto p = std::find_if(platforms.begin(), platforms.end(),
+                          [&] (auto &pd) {
+                            return pd.platform.id() == platform.id();
+                          });
+    return p == platforms.end() ? platform.devices() : p->devices;
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_PLATFORM_DETAIL_OPENCL_DISCOVERY_HPP
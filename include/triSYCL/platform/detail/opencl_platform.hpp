@@ -39,9 +39,15 @@ class opencl_platform : public detail::platform {
   /** A cache to always return the same live platform for a given OpenCL
       platform
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
   */
-  static detail::cache<cl_platform_id, detail::opencl_platform> cache;
+  static auto &cache() {
+    static auto c = new detail::cache<cl_platform_id, detail::opencl_platform>;
+    return *c;
+  }
 
 public:
 
@@ -85,8 +91,8 @@ public:
   ///// Get a singleton instance of the opencl_platform
   static std::shared_ptr<opencl_platform>
   instance(const boost::compute::platform &p) {
-    return cache.get_or_register(p.id(),
-                                 [&] { return new opencl_platform { p }; });
+    return cache().get_or_register(p.id(),
+                                   [&] { return new opencl_platform { p }; });
   }
 
 
@@ -110,19 +116,11 @@ public:
 
   /// Unregister from the cache on destruction
   ~opencl_platform() override {
-    cache.remove(p.id());
+    cache().remove(p.id());
   }
 
 };
 
-/* Allocate the cache here but since this is a pure-header library,
-   use a weak symbol so that only one remains when SYCL headers are
-   used in different compilation units of a program
-*/
-TRISYCL_WEAK_ATTRIB_PREFIX
-detail::cache<cl_platform_id, detail::opencl_platform> opencl_platform::cache
-TRISYCL_WEAK_ATTRIB_SUFFIX;
-
 /// @} to end the execution Doxygen group
 
 }
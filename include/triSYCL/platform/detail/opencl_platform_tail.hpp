@@ -30,7 +30,8 @@ vector_class<::trisycl::device> inline
 opencl_platform::get_devices(const device_selector &device_selector) const {
   vector_class<::trisycl::device> devices;
   // Add the desired OpenCL devices
-  for (const auto &d : get_boost_compute().devices()) {
+  for (const auto &d :
+         detail::opencl_discovery::instance()->get_devices(p)) {
     // Get the SYCL device from the Boost Compute device
     ::trisycl::device sycl_dev { d };
     /* Return the devices with the good criterion according to the selector.
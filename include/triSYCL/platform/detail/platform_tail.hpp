@@ -15,7 +15,8 @@ platform::platform(const device_selector &device_selector) {
   platform host_platform = {};
 #ifdef TRISYCL_OPENCL
   if (host_platform.implementation->get_devices(device_selector).empty()) {
-    for (const auto &d : boost::compute::system::platforms()) {
+    for (const auto &d :
+           detail::opencl_discovery::instance()->get_platforms()) {
       auto clplatform = ::trisycl::platform { d };
       auto devices = clplatform.implementation->get_devices(device_selector);
       if (!devices.empty()) {
@@ -0,0 +1,74 @@
+#ifndef TRISYCL_SYCL_PROPERTY_BUFFER_HPP
+#define TRISYCL_SYCL_PROPERTY_BUFFER_HPP
+
+/** \file Properties for buffer objects.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+
+#include "triSYCL/detail/property.hpp"
+
+namespace trisycl::property::buffer {
+
+/** Do not block the destruction of the last buffer object waiting
+    for the kernels using the buffer and for its final write-back
+
+    The runtime keeps the buffer storage alive and the write-back
+    happens once the last kernel using the buffer has ended, so the
+    final data have to outlive the buffer. Use
+    buffer::get_destruction_future() beforehand to wait for it later.
+
+    This is a triSYCL extension.
+*/
+class detach_on_destruction : public detail::property {
+public:
+  detach_on_destruction() {}
+};
+
+
+/** Let the devices work directly in the host memory of the buffer
+    instead of in a copy of it
+
+    The host and the device memories are then a single coherent
+    location and the transfers between them are just some mappings,
+    which is faster on the devices sharing the memory with the host,
+    such as an integrated GPU. On the host device this has no effect.
+*/
+class use_host_ptr : public detail::property {
+public:
+  use_host_ptr() {}
+};
+
+
+/** Pad the rows of a multi-dimensional buffer, along its last
+    dimension, so that walking down a column does not hit always the
+    same few sets of the caches
+
+    Without a pitch, the runtime adds a cache line to the rows whose
+    size is a multiple of 512 bytes and keeps the others dense. An
+    explicit pitch is a number of elements, at least the row length.
+    The padding only applies to a buffer created without host data;
+    the accessors index it transparently and expose the pitch with
+    accessor::get_row_pitch().
+
+    This is a triSYCL extension.
+*/
+class row_pitch : public detail::property {
+  std::size_t pitch = 0;
+public:
+  /// Let the runtime choose the pitch
+  row_pitch() {}
+
+  /// Use rows \p pitch elements apart
+  row_pitch(std::size_t pitch) : pitch { pitch } {}
+
+  /// Get the pitch in elements, or 0 to let the runtime choose it
+  std::size_t get_pitch() const { return pitch; }
+};
+
+}
+
+#endif // TRISYCL_SYCL_PROPERTY_BUFFER_HPP
@@ -8,6 +8,12 @@
     This file is distributed under the University of Illinois Open Source
     License. See LICENSE.TXT for details.
 */
+
+#include <array>
+#include <cstddef>
+
+#include "triSYCL/detail/partitioning.hpp"
+
 namespace trisycl::property::queue {
 
 class enable_profiling : public detail::property {
@@ -15,6 +21,212 @@ public:
   enable_profiling() {}
 };
 
+/** Execute the command groups of the queue one after the other in
+    submission order
+
+    The command groups still track their dependencies through the
+    buffers, so they are ordered with the command groups of other
+    queues using the same buffers, and the host accessors wait for
+    them.
+*/
+class in_order : public detail::property {
+public:
+  in_order() {}
+};
+
+/** Fuse the consecutive 1D parallel_for kernels with the same range
+    and depending only on each other, to execute them chunk by chunk
+    with a single sweep through memory
+
+    This is only correct if a work-item of a kernel uses only the data
+    produced by the same work-item of the previous kernels, such as
+    in a chain of element-wise operations.
+
+    This is a triSYCL extension.
+*/
+class fuse_kernels : public detail::property {
+public:
+  fuse_kernels() {}
+};
+
+/** Run back-to-back in a single dispatch the single_task kernels
+    without any dependency submitted while the first one waits for a
+    worker thread
+
+    The first ready single_task starts a batch, which the next ready
+    single_task kernels join up to \c max_tasks kernels, until the
+    batch starts. They then run one after the other on the same worker
+    thread, so a lot of tiny kernels do not pay each the hand-over to
+    a worker. Each command group still completes on its own, so its
+    event and its consumers do not wait for the whole batch. Since a
+    kernel of the batch waits for the previous ones, a kernel waiting
+    for a later one would deadlock.
+
+    This is a triSYCL extension.
+*/
+class coalesce_tasks : public detail::property {
+  std::size_t max_tasks;
+public:
+  coalesce_tasks(std::size_t max_tasks = 64) : max_tasks { max_tasks } {}
+
+  /// Get the maximum number of kernels run in a single dispatch
+  std::size_t get_max_tasks() const { return max_tasks; }
+};
+
+/** Schedule together the kernels of the queue connected by pipes
+
+    A command group using a pipe is held until the command groups at
+    the other end of all the pipes of the gang are submitted, then
+    they all start at once, so some kernels connected by blocking
+    pipes do not wait for each other forever on a bounded pool of
+    worker threads. With \c TRISYCL_FIBER_TASKS the gang runs as
+    fibers multiplexed on the threads of the pool. A gang which is
+    not complete starts when the queue or one of its tasks is waited
+    for. It has no effect on an in-order queue.
+
+    This is a triSYCL extension.
+*/
+class dataflow : public detail::property {
+public:
+  dataflow() {}
+};
+
+/** Serve the tasks of the queue before the normal-priority ones
+    waiting for a worker thread of the same pool
+
+    This is typically used for latency-critical kernels sharing the
+    worker threads with some batch processing. It has no effect with
+    \c TRISYCL_FIBER_TASKS.
+
+    This is a triSYCL extension.
+*/
+class priority_high : public detail::property {
+public:
+  priority_high() {}
+};
+
+/** Run a command group without pending dependency on the submitting
+    thread when the queue has nothing else to execute, instead of
+    handing it over to a worker thread
+
+    This gives the latency of a synchronous execution to the short
+    requests of a queue mostly waited for right after the submission,
+    while the command groups submitted when the queue is busy still
+    run asynchronously. Since the submission returns only after the
+    end of such a kernel, a kernel waiting for something the submitter
+    does after the submission would deadlock. See also
+    handler::set_latency_critical() for a single command group.
+
+    This is a triSYCL extension.
+*/
+class inline_execution : public detail::property {
+public:
+  inline_execution() {}
+};
+
+/** Choose how the TBB backend splits the iteration space of the
+    kernels into chunks executed by the threads
+
+    The grain size is the minimum number of work-items of a chunk
+    along the last dimension. With the affinity partitioner, the
+    repeated launches of the same kernel reuse the mapping of the
+    chunks to the threads, so the data stay in the same caches.
+
+    With the OpenMP backend, only the affinity partitioner has an
+    effect: the thread executing each static slice of a kernel is
+    pinned on the CPU given by the position of the slice in the
+    iteration space, so all the successive kernels of the queue on the
+    same range, and not only the launches of the same kernel, process
+    the same slices on the same cores.
+
+    This is a triSYCL extension.
+*/
+class partitioner : public detail::property {
+public:
+  using kind = detail::partitioning::kind;
+
+private:
+  detail::partitioning p;
+
+public:
+  partitioner(kind k, std::size_t grain_size = 1) {
+    p.partitioner = k;
+    p.grain_size = grain_size;
+  }
+
+  /// Get the kind of TBB partitioner
+  kind get_kind() const { return p.partitioner; }
+
+  /// Get the minimum number of work-items of a chunk
+  std::size_t get_grain_size() const { return p.grain_size; }
+
+  /// Get the partitioning in the form used by the implementation
+  const detail::partitioning &get_partitioning() const { return p; }
+};
+
+/** Choose the order of execution of the work-items of the 2D and 3D
+    parallel_for kernels on a range
+
+    Except for row_major, the iteration space is cut into tiles which
+    are distributed among the threads in row-major, Morton or Hilbert
+    order, each tile being executed in row-major order. A kernel with
+    N dimensions uses the last N tile extents, 8x8x64 by default.
+
+    This is a triSYCL extension.
+*/
+class iteration_order : public detail::property {
+public:
+  using order = detail::partitioning::order;
+
+private:
+  order o;
+  std::array<std::size_t, 3> tile;
+
+public:
+  iteration_order(order o,
+                  const std::array<std::size_t, 3> &tile =
+                  detail::partitioning {}.tile)
+    : o { o }, tile { tile } {}
+
+  /// Get the order of execution
+  order get_order() const { return o; }
+
+  /// Get the tile extents
+  const std::array<std::size_t, 3> &get_tile() const { return tile; }
+};
+
+/** Run the tasks of the queue on a dedicated pool of worker threads
+    pinned on a NUMA node, with one worker per CPU of the node unless
+    worker_threads is also used
+
+    The OpenMP threads of the kernels run on the same node. It has no
+    effect with \c TRISYCL_FIBER_TASKS or outside of Linux.
+
+    This is a triSYCL extension.
+*/
+class numa_node : public detail::property {
+  unsigned node;
+public:
+  numa_node(unsigned node) : node { node } {}
+
+  /// Get the NUMA node running the tasks of the queue
+  unsigned get_node() const { return node; }
+};
+
+/** Run the tasks of the queue on a dedicated pool of worker threads
+    instead of the pool shared by all the queues
+
+    This is a triSYCL extension.
+*/
+class worker_threads : public detail::property {
+  std::size_t thread_number;
+public:
+  worker_threads(std::size_t thread_number) : thread_number { thread_number } {}
+
+  /// Get the number of worker threads kept alive for the queue
+  std::size_t get_thread_number() const { return thread_number; }
+};
+
 }
 
 #endif // TRISYCL_SYCL_PROPERTY_QUEUE_HPP
@@ -0,0 +1,24 @@
+#ifndef TRISYCL_SYCL_PROPERTY_REDUCTION_HPP
+#define TRISYCL_SYCL_PROPERTY_REDUCTION_HPP
+
+/** \file Properties for reduction objects.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include "triSYCL/detail/property.hpp"
+
+namespace trisycl::property::reduction {
+
+/** Replace the initial value of the reduction variable instead of
+    combining it with the result of the reduction
+*/
+class initialize_to_identity : public detail::property {
+public:
+  initialize_to_identity() {}
+};
+
+}
+
+#endif // TRISYCL_SYCL_PROPERTY_REDUCTION_HPP
@@ -4,7 +4,10 @@
 #include <optional>
 
 #include "triSYCL/detail/all_true.hpp"
+#include "triSYCL/detail/property.hpp"
+#include "triSYCL/property/buffer.hpp"
 #include "triSYCL/property/queue.hpp"
+#include "triSYCL/property/reduction.hpp"
 
 namespace trisycl {
 
@@ -19,7 +22,20 @@ class property_list {
    * and the addproperty methods init the correct one for each known
    * property, this method is recursive to deal with the pack parameter.
    */
+  TRISYCL_PROPERTY_CREATE(buffer, detach_on_destruction);
+  TRISYCL_PROPERTY_CREATE(buffer, row_pitch);
+  TRISYCL_PROPERTY_CREATE(queue, coalesce_tasks);
+  TRISYCL_PROPERTY_CREATE(queue, dataflow);
   TRISYCL_PROPERTY_CREATE(queue, enable_profiling);
+  TRISYCL_PROPERTY_CREATE(queue, fuse_kernels);
+  TRISYCL_PROPERTY_CREATE(queue, in_order);
+  TRISYCL_PROPERTY_CREATE(queue, inline_execution);
+  TRISYCL_PROPERTY_CREATE(queue, iteration_order);
+  TRISYCL_PROPERTY_CREATE(queue, numa_node);
+  TRISYCL_PROPERTY_CREATE(queue, partitioner);
+  TRISYCL_PROPERTY_CREATE(queue, priority_high);
+  TRISYCL_PROPERTY_CREATE(queue, worker_threads);
+  TRISYCL_PROPERTY_CREATE(reduction, initialize_to_identity);
 
 protected:
   template <typename propertyT>
@@ -33,6 +49,7 @@ private:
   template<typename T, typename... propsT,
            typename = std::enable_if_t<detail::all_true<std::is_convertible<propsT, detail::property>::value ...>::value>>
   void addproperty(T first, propsT... next) {
+    addproperty(first);
     addproperty(next...);
   }
 public:
@@ -62,7 +79,20 @@ public:
     return prop_name.value();                                           \
   }
 
+TRISYCL_PROPERTY_HAS_GET(buffer, detach_on_destruction)
+TRISYCL_PROPERTY_HAS_GET(buffer, row_pitch)
+TRISYCL_PROPERTY_HAS_GET(queue, coalesce_tasks)
+TRISYCL_PROPERTY_HAS_GET(queue, dataflow)
 TRISYCL_PROPERTY_HAS_GET(queue, enable_profiling)
+TRISYCL_PROPERTY_HAS_GET(queue, fuse_kernels)
+TRISYCL_PROPERTY_HAS_GET(queue, in_order)
+TRISYCL_PROPERTY_HAS_GET(queue, inline_execution)
+TRISYCL_PROPERTY_HAS_GET(queue, iteration_order)
+TRISYCL_PROPERTY_HAS_GET(queue, numa_node)
+TRISYCL_PROPERTY_HAS_GET(queue, partitioner)
+TRISYCL_PROPERTY_HAS_GET(queue, priority_high)
+TRISYCL_PROPERTY_HAS_GET(queue, worker_threads)
+TRISYCL_PROPERTY_HAS_GET(reduction, initialize_to_identity)
 
 #undef TRISYCL_PROPERTY_CREATE
 #undef TRISYCL_PROPERTY_HAS_GET
@@ -9,7 +9,9 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <cstddef>
 #include <memory>
+#include <ranges>
 
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
@@ -18,10 +20,12 @@
 #include "triSYCL/context.hpp"
 #include "triSYCL/detail/debug.hpp"
 #include "triSYCL/detail/default_classes.hpp"
+#include "triSYCL/detail/placement.hpp"
 #include "triSYCL/detail/unimplemented.hpp"
 #include "triSYCL/detail/property.hpp"
 #include "triSYCL/device.hpp"
 #include "triSYCL/device_selector.hpp"
+#include "triSYCL/event.hpp"
 #include "triSYCL/exception.hpp"
 #include "triSYCL/handler.hpp"
 #include "triSYCL/info/param_traits.hpp"
@@ -29,6 +33,8 @@
 #include "triSYCL/parallelism.hpp"
 #include "triSYCL/property_list.hpp"
 #include "triSYCL/queue/detail/host_queue.hpp"
+#include "triSYCL/task_graph.hpp"
+#include "triSYCL/vendor/triSYCL/persistent_kernel.hpp"
 #ifdef TRISYCL_OPENCL
 #include "triSYCL/queue/detail/opencl_queue.hpp"
 #endif
@@ -130,12 +136,25 @@ public:
         const property_list &propList = {}) : implementation_t {
 #ifdef TRISYCL_OPENCL
     d.is_host()
-      ? std::shared_ptr<detail::queue>{ new detail::host_queue }
-      : detail::opencl_queue::instance(d)
+      ? std::shared_ptr<detail::queue>{ new detail::host_queue { d } }
+      : detail::opencl_queue::instance(
+          d, propList.has_property<property::queue::enable_profiling>())
 #else
-    new detail::host_queue
+    new detail::host_queue { d }
 #endif
-  }, property_list { propList } { }
+  }, property_list { propList } {
+    if (asyncHandler)
+      implementation->set_async_handler(asyncHandler);
+    auto sub_device =
+      std::dynamic_pointer_cast<detail::host_sub_device>(d.implementation);
+    if (sub_device)
+      // Stay on the CPUs of the sub-device, with its workers
+      implementation->set_worker_pool(sub_device->get_worker_pool());
+    apply_properties();
+    if (sub_device)
+      implementation->place_in_order_worker(sub_device->get_placement(),
+                                            sub_device->get_governor());
+  }
 
   /** A queue is created for a SYCL device
 
@@ -167,10 +186,14 @@ public:
     implementation =
 #ifdef TRISYCL_OPENCL
       d.is_host() ? std::shared_ptr<detail::queue>{ new detail::host_queue }
-    : detail::opencl_queue::instance(d);
+    : detail::opencl_queue::instance(
+        d, has_property<property::queue::enable_profiling>());
 #else
     std::shared_ptr<detail::queue>{ new detail::host_queue };
 #endif
+    if (asyncHandler)
+      implementation->set_async_handler(asyncHandler);
+    apply_properties();
   }
 
   /** This constructor chooses a device based on the provided
@@ -285,9 +308,8 @@ public:
       be lost.
   */
   void wait_and_throw() {
-    // \todo Implement the throw part of wait_and_throw
     wait();
-    TRISYCL_UNIMPL;
+    throw_asynchronous();
   }
 
 
@@ -299,7 +321,7 @@ public:
       be lost.
   */
   void throw_asynchronous() {
-    TRISYCL_UNIMPL;
+    implementation->throw_asynchronous();
   }
 
 
@@ -320,7 +342,7 @@ public:
   event submit(Handler_Functor cgf) {
     handler command_group_handler { implementation };
     cgf(command_group_handler);
-    return {};
+    return command_group_handler.get_event();
   }
 
 
@@ -340,6 +362,243 @@ public:
     return submit(cgf);
   }
 
+  /** Submit a range of command group functors at once
+
+      The command groups are built in order, so their dependencies
+      are the same as with some successive submit(), but their tasks
+      are handed over to the workers with a single lock and a single
+      wake-up of the workers at the end, which amortizes the
+      submission cost of a burst of small command groups.
+
+      The command group functors cannot wait for the command groups of
+      the batch, for example with wait() or a host accessor, since
+      they do not start before the end of the batch.
+
+      This is a triSYCL extension.
+
+      \return the events of the command groups, in order
+  */
+  template <std::ranges::input_range CommandGroups>
+  vector_class<event> submit_batch(CommandGroups &&cgfs) {
+    detail::queue::batch b;
+    auto previous = implementation->begin_batch(b);
+    // Hand over the tasks already built even on an exception
+    struct flush {
+      detail::queue &q;
+      detail::queue::batch &b;
+      detail::queue::batch *previous;
+      ~flush() { q.flush_batch(b, previous); }
+    } f { *implementation, b, previous };
+    vector_class<event> events;
+    if constexpr (std::ranges::sized_range<CommandGroups>)
+      events.reserve(std::ranges::size(cgfs));
+    for (auto &&cgf : cgfs)
+      events.push_back(submit(cgf));
+    return events;
+  }
+
+
+  /** Start recording the command groups submitted to this queue
+      into a task_graph instead of executing them
+
+      This is a triSYCL extension.
+  */
+  void begin_recording() {
+    if (implementation->recording)
+      throw trisycl::invalid_object_error("The queue is already recording\n");
+    implementation->recording = std::make_shared<detail::task_graph>();
+  }
+
+
+  /** Stop recording and return the graph of the command groups
+      submitted since begin_recording()
+
+      The dependencies between the command groups are resolved here
+      once for all.
+
+      This is a triSYCL extension.
+  */
+  task_graph end_recording() {
+    if (!implementation->recording)
+      throw trisycl::invalid_object_error("The queue is not recording\n");
+    auto g = std::move(implementation->recording);
+    implementation->recording.reset();
+    g->finalize();
+    return g;
+  }
+
+
+  /** Execute a recorded task_graph without its per command group
+      submission cost
+
+      The graph is replayed as a single command group using all the
+      buffers of the graph, so it is ordered with the other command
+      groups using these buffers, while the command groups inside the
+      graph only wait for each other according to the dependencies
+      resolved at the end of the recording.
+
+      This is a triSYCL extension.
+  */
+  event replay(const task_graph &g) {
+    handler command_group_handler { implementation };
+    auto &t = command_group_handler.task;
+    for (auto &a : g.implementation->accesses)
+      t->add_buffer(a.buffer, a.is_write_mode);
+    t->schedule([g = g.implementation, e = implementation->get_worker_pool()] {
+        g->run(*e);
+      });
+    return command_group_handler.get_event();
+  }
+
+
+  /** Copy \p count bytes from \p src to \p dest once the command
+      groups of some events are complete
+
+      This is a shortcut for a command group with handler::memcpy.
+  */
+  event memcpy(void *dest, const void *src, std::size_t count,
+               const vector_class<event> &dependencies = {}) {
+    return submit([&] (handler &cgh) {
+        cgh.depends_on(dependencies);
+        cgh.memcpy(dest, src, count);
+      });
+  }
+
+
+  /// Copy \p count bytes from \p src to \p dest after an event
+  event memcpy(void *dest, const void *src, std::size_t count,
+               event dependency) {
+    return memcpy(dest, src, count, vector_class<event> { dependency });
+  }
+
+
+  /// Copy \p count elements from \p src to \p dest after some events
+  template <typename T>
+  event copy(const T *src, T *dest, std::size_t count,
+             const vector_class<event> &dependencies = {}) {
+    return memcpy(dest, src, count*sizeof(T), dependencies);
+  }
+
+
+  /** Set \p count bytes from \p ptr to \p value once the command
+      groups of some events are complete
+  */
+  event memset(void *ptr, int value, std::size_t count,
+               const vector_class<event> &dependencies = {}) {
+    return submit([&] (handler &cgh) {
+        cgh.depends_on(dependencies);
+        cgh.memset(ptr, value, count);
+      });
+  }
+
+
+  /// Set \p count elements from \p ptr to \p pattern after some events
+  template <typename T>
+  event fill(void *ptr, const T &pattern, std::size_t count,
+             const vector_class<event> &dependencies = {}) {
+    return submit([&] (handler &cgh) {
+        cgh.depends_on(dependencies);
+        cgh.fill(ptr, pattern, count);
+      });
+  }
+
+
+  /** Move the data of a buffer to the device of the queue ahead of
+      the kernels needing them
+
+      \return the event of the end of the transfer
+  */
+  template <typename T, int Dimensions, typename Allocator>
+  event prefetch(buffer<T, Dimensions, Allocator> &b) {
+    return submit([&] (handler &cgh) { cgh.prefetch(b); });
+  }
+
+
+  /** Run a single task kernel once the command groups of some events
+      are complete
+
+      This is a shortcut for a command group without any accessor,
+      typically with a kernel using some USM pointers.
+  */
+  template <typename KernelName = std::nullptr_t, typename Kernel>
+  event single_task(const vector_class<event> &dependencies, Kernel k) {
+    return submit([&] (handler &cgh) {
+        cgh.depends_on(dependencies);
+        cgh.template single_task<KernelName>(k);
+      });
+  }
+
+
+  /// Run a single task kernel after an event
+  template <typename KernelName = std::nullptr_t, typename Kernel>
+  event single_task(event dependency, Kernel k) {
+    return single_task<KernelName>(vector_class<event> { dependency }, k);
+  }
+
+
+  /// Run a single task kernel
+  template <typename KernelName = std::nullptr_t, typename Kernel>
+  event single_task(Kernel k) {
+    return single_task<KernelName>(vector_class<event> {}, k);
+  }
+
+
+  /** Run a parallel_for kernel once the command groups of some events
+      are complete
+
+      This is a shortcut for a command group without any accessor,
+      typically with a kernel using some USM pointers.
+  */
+  template <typename KernelName = std::nullptr_t, int Dims, typename Kernel>
+  event parallel_for(const range<Dims> &r,
+                     const vector_class<event> &dependencies, Kernel k) {
+    return submit([&] (handler &cgh) {
+        cgh.depends_on(dependencies);
+        cgh.template parallel_for<KernelName>(r, k);
+      });
+  }
+
+
+  /// Run a parallel_for kernel after an event
+  template <typename KernelName = std::nullptr_t, int Dims, typename Kernel>
+  event parallel_for(const range<Dims> &r, event dependency, Kernel k) {
+    return parallel_for<KernelName>(r, vector_class<event> { dependency }, k);
+  }
+
+
+  /// Run a parallel_for kernel
+  template <typename KernelName = std::nullptr_t, int Dims, typename Kernel>
+  event parallel_for(const range<Dims> &r, Kernel k) {
+    return parallel_for<KernelName>(r, vector_class<event> {}, k);
+  }
+
+
+  /** Make a kernel \p k on the range \p r which can be launched many
+      times without a command group, by a team of threads parked
+      between the launches
+
+      The team runs on the CPUs of the device of the queue and takes
+      its threads from the kernels of the device until the persistent
+      kernel is destroyed.
+  */
+  template <typename KernelName = std::nullptr_t, int Dims, typename Kernel>
+  auto make_persistent(const range<Dims> &r, Kernel k) {
+    if (!is_host())
+      throw feature_not_supported {
+        "Persistent kernels are only supported on the host device"
+      };
+    std::shared_ptr<const detail::placement> where;
+    auto *governor = &detail::concurrency_governor::instance();
+    if (auto sub_device = std::dynamic_pointer_cast<detail::host_sub_device>(
+          get_device().implementation)) {
+      where = sub_device->get_placement();
+      governor = sub_device->get_governor().get();
+    }
+    return vendor::trisycl::persistent_kernel<KernelName, Dims, Kernel> {
+      r, std::move(k), *governor, std::move(where) };
+  }
+
+
   /** Check if the queue was constructed with the specified
       property.
   */
@@ -355,6 +614,52 @@ public:
   propertyT get_property() const {
     return property_list::get_property<propertyT>();
   }
+
+private:
+
+  /// Forward to the implementation the properties changing its behavior
+  void apply_properties() {
+    if (has_property<property::queue::in_order>())
+      implementation->set_in_order();
+    if (has_property<property::queue::priority_high>())
+      implementation->set_high_priority();
+    if (has_property<property::queue::inline_execution>())
+      implementation->set_inline_execution();
+    if (has_property<property::queue::fuse_kernels>())
+      implementation->set_fuse_kernels();
+    if (has_property<property::queue::coalesce_tasks>())
+      implementation->set_coalesce_tasks(
+        get_property<property::queue::coalesce_tasks>().get_max_tasks());
+    if (has_property<property::queue::dataflow>())
+      implementation->set_dataflow();
+    if (has_property<property::queue::enable_profiling>())
+      implementation->set_profiling();
+    if (has_property<property::queue::partitioner>()
+        || has_property<property::queue::iteration_order>()) {
+      detail::partitioning p;
+      if (has_property<property::queue::partitioner>())
+        p = get_property<property::queue::partitioner>().get_partitioning();
+      if (has_property<property::queue::iteration_order>()) {
+        auto o = get_property<property::queue::iteration_order>();
+        p.iteration = o.get_order();
+        p.tile = o.get_tile();
+      }
+      implementation->set_partitioning(p);
+    }
+    std::shared_ptr<const detail::placement> where;
+    if (has_property<property::queue::numa_node>())
+      where = std::make_shared<const detail::placement>(
+        detail::placement::from_nodes(
+          { get_property<property::queue::numa_node>().get_node() }));
+    if (has_property<property::queue::worker_threads>() || where) {
+      auto n = has_property<property::queue::worker_threads>()
+        ? get_property<property::queue::worker_threads>().get_thread_number()
+        : where->cpus().size();
+      auto workers = std::make_shared<detail::task_executor>(n);
+      workers->set_placement(std::move(where));
+      implementation->set_worker_pool(std::move(workers));
+    }
+  }
 };
 
 template<>
@@ -371,6 +676,18 @@ template<>
 inline auto queue::get_info<info::queue::reference_count>() const {
   return trisycl::cl_uint {0};
 }
+
+template<>
+inline auto queue::get_info<info::queue::submit_to_start_latency>() const {
+  return vendor::trisycl::latency_histogram {
+    implementation->submit_to_start };
+}
+
+template<>
+inline auto queue::get_info<info::queue::start_to_end_latency>() const {
+  return vendor::trisycl::latency_histogram {
+    implementation->start_to_end };
+}
 /// @} to end the execution Doxygen group
 
 }
@@ -28,6 +28,15 @@ namespace trisycl::detail {
 class host_queue : public detail::queue,
                    detail::debug<host_queue> {
 
+  /// The host device or sub-device the queue is associated with
+  trisycl::device d;
+
+public:
+
+  /// Create a queue on the host device or on a host sub-device \p d
+  host_queue(const trisycl::device &d = {}) : d { d } {}
+
+
 #ifdef TRISYCL_OPENCL
   /** Return the cl_command_queue of the underlying OpenCL queue
 
@@ -60,8 +69,7 @@ class host_queue : public detail::queue,
 
   /// Return the SYCL host device the host queue is associated with
   trisycl::device get_device() const override {
-    // Return the default device which is the host device
-    return {};
+    return d;
   }
 
 
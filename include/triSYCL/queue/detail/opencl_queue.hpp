@@ -26,9 +26,15 @@ class opencl_queue : public detail::queue,
   /** A cache to always return the same alive queue for a given OpenCL
       command queue
 
-      C++11 guaranties the static construction is thread-safe
+      It is built on its first use, thread-safely since C++11, so
+      the programs not using OpenCL do not pay for it at startup.
+      It is never destroyed since some objects may unregister
+      from it during the program exit
   */
-  static detail::cache<cl_command_queue, detail::opencl_queue> cache;
+  static auto &cache() {
+    static auto c = new detail::cache<cl_command_queue, detail::opencl_queue>;
+    return *c;
+  }
 
   /// Return the cl_command_queue of the underlying OpenCL queue
   cl_command_queue get() const override {
@@ -69,42 +75,48 @@ public:
   /// Get a singleton instance of the opencl_queue
   static std::shared_ptr<opencl_queue>
   instance(const boost::compute::command_queue &q) {
-    return cache.get_or_register(q.get(),
-                                 [&] { return new opencl_queue { q }; });
+    return cache().get_or_register(q.get(),
+                                   [&] { return new opencl_queue { q }; });
   }
 
 
-  /** Create a new queue associated to this device
+  /** Create a new queue associated to this device, recording the
+      timestamps of its commands if \p profiling
+
+      The kernels are enqueued with the events they depend on, so the
+      OpenCL queue executes them out of order when the device allows
+      it, and the independent kernels can overlap. The transfers of
+      the buffers use the queues of the context instead.
 
       \todo Check with SYCL committee what is the expected behaviour
       here about the context. Is this a new context everytime, or
       always the same for a given device?
   */
   static std::shared_ptr<detail::queue>
-  instance(const trisycl::device &d) {
+  instance(const trisycl::device &d, bool profiling = false) {
+    auto device = d.get_boost_compute();
+    cl_command_queue_properties properties =
+      profiling ? boost::compute::command_queue::enable_profiling : 0;
+    if (device.get_info<cl_command_queue_properties>(CL_DEVICE_QUEUE_PROPERTIES)
+        & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE)
+      properties |=
+        boost::compute::command_queue::enable_out_of_order_execution;
     return instance (boost::compute::command_queue {
         // For now, create a new context every time
-        boost::compute::context { d.get_boost_compute() },
-        d.get_boost_compute()
+        boost::compute::context { device },
+        device,
+        properties
           });
   }
 
 
   /// Unregister from the cache on destruction
   ~opencl_queue() override {
-    cache.remove(q.get());
+    cache().remove(q.get());
   }
 
 };
 
-/* Allocate the cache here but since this is a pure-header library,
-   use a weak symbol so that only one remains when SYCL headers are
-   used in different compilation units of a program
-*/
-TRISYCL_WEAK_ATTRIB_PREFIX
-detail::cache<cl_command_queue, detail::opencl_queue> opencl_queue::cache
-TRISYCL_WEAK_ATTRIB_SUFFIX;
-
 }
 
 /*
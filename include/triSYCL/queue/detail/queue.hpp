@@ -11,7 +11,13 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #ifdef TRISYCL_OPENCL
 #include <boost/compute.hpp>
@@ -19,10 +25,18 @@
 
 #include "triSYCL/context.hpp"
 #include "triSYCL/device.hpp"
+#include "triSYCL/exception.hpp"
 #include "triSYCL/detail/debug.hpp"
+#include "triSYCL/detail/partitioning.hpp"
+#include "triSYCL/command_group/detail/dataflow_window.hpp"
+#include "triSYCL/command_group/detail/task_graph.hpp"
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/vendor/triSYCL/latency_histogram.hpp"
 
 namespace trisycl::detail {
 
+struct task;
+
 /** Some implementation details about the SYCL queue
  */
 struct queue : detail::debug<detail::queue> {
@@ -30,9 +44,85 @@ struct queue : detail::debug<detail::queue> {
   std::atomic<size_t> running_kernels;
 
   /// To signal when all the kernels have completed
-  std::condition_variable finished;
+  detail::task_condition_variable finished;
   /// To protect the access to the condition variable
-  std::mutex finished_mutex;
+  detail::task_mutex finished_mutex;
+
+  /// The worker threads executing the tasks submitted to this queue
+  std::shared_ptr<detail::task_executor> workers =
+    detail::task_executor::default_pool();
+
+  /** The single worker executing in submission order the tasks of an
+      in-order queue, if any
+  */
+  std::shared_ptr<detail::worker_pool> in_order_worker;
+
+  /// The graph recording the command groups instead of running them, if any
+  std::shared_ptr<detail::task_graph> recording;
+
+  /// Whether the tasks of this queue are served before the normal ones
+  bool high_priority = false;
+
+  /** Whether the tasks ready at their submission run on the
+      submitting thread when the queue is idle
+  */
+  bool inline_when_idle = false;
+
+  /// Whether the consecutive element-wise kernels are fused
+  bool fusion = false;
+
+  /// Whether the command groups record the timestamps of their execution
+  bool profiling = false;
+
+  /** The latencies from the submission to the start of the command
+      groups, covering the dependencies and the scheduling
+  */
+  vendor::trisycl::latency_histogram submit_to_start;
+
+  /// The execution times of the command groups
+  vendor::trisycl::latency_histogram start_to_end;
+
+  /** The latest batch of fused kernels not started yet, to which the
+      next fusable kernel can be appended
+
+      Use a weak pointer since the task owns its queue.
+  */
+  std::weak_ptr<detail::task> fusion_batch;
+
+  /// To protect fusion_batch and the kernels of the batch
+  detail::task_mutex fusion_mutex;
+
+  /** The maximum number of ready single_task kernels run in a single
+      dispatch, or 0 if they are not coalesced
+  */
+  std::size_t coalescing = 0;
+
+  /** The latest batch of coalesced single_task kernels not started
+      yet, which the next ready single_task can join
+
+      Use a weak pointer since the task owns its queue.
+  */
+  std::weak_ptr<detail::task> coalescing_batch;
+
+  /// To protect coalescing_batch and the tasks of the batch
+  detail::task_mutex coalescing_mutex;
+
+  /// How the iteration spaces of the kernels are split into chunks
+  detail::partitioning partition;
+
+  /** The tasks connected by pipes waiting for the rest of their gang,
+      if the kernels connected by pipes are scheduled together
+  */
+  std::unique_ptr<detail::dataflow_window> dataflow;
+
+  /// The user function receiving the asynchronous errors, if any
+  async_handler error_handler;
+
+  /// The exceptions thrown by the kernels and not reported yet
+  exception_list async_errors;
+
+  /// To protect async_errors
+  detail::task_mutex async_errors_mutex;
 
 
   /// Initialize the queue with 0 running kernel
@@ -41,7 +131,10 @@ struct queue : detail::debug<detail::queue> {
   /// Wait for all kernel completion
   void wait_for_kernel_execution() {
     TRISYCL_DUMP_T("Queue waiting for kernel completion");
-    std::unique_lock<std::mutex> ul { finished_mutex };
+    // The held tasks would never complete otherwise
+    flush_dataflow();
+    detail::worker_pool::blocked_scope b;
+    std::unique_lock<detail::task_mutex> ul { finished_mutex };
     finished.wait(ul, [&] {
         // When there is no kernel running in this queue, we are ready to go
         return running_kernels == 0;
@@ -60,7 +153,7 @@ struct queue : detail::debug<detail::queue> {
   /// Signal that a new kernel finished on this queue
   void kernel_end() {
     TRISYCL_DUMP_T("A kernel of the queue ended");
-    std::unique_lock<std::mutex> ul { finished_mutex };
+    std::unique_lock<detail::task_mutex> ul { finished_mutex };
     if (--running_kernels == 0) {
       // Micro-optimization: unlock before the notification
       // https://en.cppreference.com/w/cpp/thread/condition_variable/notify_all
@@ -77,6 +170,289 @@ struct queue : detail::debug<detail::queue> {
   }
 
 
+  /// Set the function receiving the asynchronous errors
+  void set_async_handler(const async_handler &h) {
+    error_handler = h;
+  }
+
+
+  /** Keep the exception \p e thrown by a kernel up to the next
+      throw_asynchronous()
+  */
+  void add_async_error(std::exception_ptr e) {
+    std::lock_guard<detail::task_mutex> lg { async_errors_mutex };
+    async_errors.push_back(std::move(e));
+  }
+
+
+  /** Pass the asynchronous errors to the async_handler, if there are
+      some, or lose them if there is no handler
+  */
+  void throw_asynchronous() {
+    exception_list errors;
+    {
+      std::lock_guard<detail::task_mutex> lg { async_errors_mutex };
+      errors.swap(async_errors);
+    }
+    // Call the user outside of the lock, since it may submit some work
+    if (!errors.empty() && error_handler)
+      error_handler(std::move(errors));
+  }
+
+
+  /// Get the worker pool executing the tasks of this queue
+  auto get_worker_pool() {
+    return workers;
+  }
+
+
+  /** Execute the tasks submitted from now on in submission order
+
+      Since the order is guaranteed, the tasks do not wait through the
+      buffers for the previous tasks of this queue.
+  */
+  void set_in_order() {
+    in_order_worker = std::make_shared<detail::worker_pool>(1, false);
+  }
+
+
+  /** Run the worker of an in-order queue on the placement \p where,
+      sharing the threads of its kernels with the governor \p g
+  */
+  void
+  place_in_order_worker(std::shared_ptr<const detail::placement> where,
+                        std::shared_ptr<detail::concurrency_governor> g) {
+    if (!in_order_worker)
+      return;
+    in_order_worker->set_placement(std::move(where));
+    in_order_worker->set_governor(std::move(g));
+  }
+
+
+  /// Test whether the tasks are executed in submission order
+  bool is_in_order() const {
+    return static_cast<bool>(in_order_worker);
+  }
+
+
+  /** Fuse the consecutive element-wise 1D parallel_for kernels
+      submitted from now on
+  */
+  void set_fuse_kernels() {
+    fusion = true;
+  }
+
+
+  /// Test whether the consecutive element-wise kernels are fused
+  bool fuses_kernels() const {
+    return fusion;
+  }
+
+
+  /** Run back-to-back up to \p max_tasks ready single_task kernels
+      submitted from now on
+  */
+  void set_coalesce_tasks(std::size_t max_tasks) {
+    coalescing = max_tasks;
+  }
+
+
+  /** Get the maximum number of single_task kernels run in a single
+      dispatch, 0 if they are not coalesced
+  */
+  std::size_t coalesces_tasks() const {
+    return coalescing;
+  }
+
+
+  /** Record the timestamps of the execution of the command groups
+      submitted from now on
+  */
+  void set_profiling() {
+    profiling = true;
+  }
+
+
+  /// Test whether the command groups record their timestamps
+  bool is_profiling() const {
+    return profiling;
+  }
+
+
+  /** Schedule together the kernels connected by pipes submitted from
+      now on
+
+      This has no effect on an in-order queue, whose tasks cannot run
+      concurrently anyway.
+  */
+  void set_dataflow() {
+    if (!is_in_order())
+      dataflow = std::make_unique<detail::dataflow_window>();
+  }
+
+
+  /// Test whether the kernels connected by pipes are scheduled together
+  bool is_dataflow() const {
+    return static_cast<bool>(dataflow);
+  }
+
+
+  /// Serve the tasks submitted from now on before the normal-priority ones
+  void set_high_priority() {
+    high_priority = true;
+  }
+
+
+  /// Test whether the tasks are served before the normal-priority ones
+  bool is_high_priority() const {
+    return high_priority;
+  }
+
+
+  /** Run the tasks submitted from now on and ready at their
+      submission on the submitting thread when the queue is idle
+  */
+  void set_inline_execution() {
+    inline_when_idle = true;
+  }
+
+
+  /** Test whether a task ready at its submission runs right now on
+      the submitting thread instead of a worker
+
+      \param[in] latency_critical is true if the task asks for it
+  */
+  bool runs_inline(bool latency_critical) const {
+    // A batch is handed over to the workers at once
+    if (auto b = current_batch(); b && b->owner == this)
+      return false;
+    // Only the task being submitted is not complete
+    bool idle = running_kernels == 1;
+    if (is_in_order())
+      // Do not overtake the previous tasks of the queue
+      return idle && (latency_critical || inline_when_idle);
+    return latency_critical || (inline_when_idle && idle);
+  }
+
+
+  /// Split the iteration spaces of the kernels submitted from now on
+  void set_partitioning(const detail::partitioning &p) {
+    partition = p;
+  }
+
+
+  /// Get how the iteration spaces of the kernels are split into chunks
+  const detail::partitioning &get_partitioning() const {
+    return partition;
+  }
+
+
+  /** The tasks built by a queue::submit_batch() on the current
+      thread, handed to the workers at once at the end of the batch
+  */
+  struct batch {
+    /// The queue whose tasks are batched
+    detail::queue *owner = nullptr;
+
+    /// The executions of the tasks, in submission order
+    std::vector<std::function<void(void)>> work;
+  };
+
+
+  /// Get the batch being built on the current thread, if any
+  static batch *&current_batch() {
+    static thread_local batch *current = nullptr;
+    return current;
+  }
+
+
+  /** Batch the tasks submitted to this queue from the current thread
+      until flush_batch() is called
+
+      \return the previous batch of the thread, to restore it later
+  */
+  batch *begin_batch(batch &b) {
+    b.owner = this;
+    return std::exchange(current_batch(), &b);
+  }
+
+
+  /// Hand over a batch of tasks to the workers and restore \p previous
+  void flush_batch(batch &b, batch *previous) {
+    current_batch() = previous;
+    if (b.work.empty())
+      return;
+    if (in_order_worker)
+      in_order_worker->submit_bulk(std::move(b.work));
+    else
+      workers->submit_bulk(std::move(b.work), high_priority);
+    b.work.clear();
+  }
+
+
+  /** Execute a task on the worker threads of this queue
+
+      \param[in] rank orders the ready tasks waiting for a worker, the
+      highest first, but not the tasks of a batch which keep their
+      submission order
+  */
+  void execute(std::function<void(void)> f, std::uint64_t rank = 0) {
+    if (auto b = current_batch(); b && b->owner == this) {
+      b->work.push_back(std::move(f));
+      return;
+    }
+    dispatch(std::move(f), rank);
+  }
+
+
+  /// Execute a task on the worker threads of this queue, now
+  void dispatch(std::function<void(void)> f, std::uint64_t rank = 0) {
+    if (in_order_worker)
+      in_order_worker->submit(std::move(f));
+    else
+      workers->submit(std::move(f), high_priority, rank);
+  }
+
+
+  /** Execute a task using some pipes on the worker threads of this
+      queue
+
+      In dataflow mode, the task is held until the tasks at the other
+      end of its pipes are submitted too and they all start at once.
+      Otherwise it is not batched, since it may block on a task
+      submitted after it.
+
+      \param[in] ends are the pipes used by the task
+  */
+  template <typename PipeEnds>
+  void execute_connected(std::function<void(void)> f, const PipeEnds &ends) {
+    if (!dataflow) {
+      dispatch(std::move(f));
+      return;
+    }
+    if (auto gang = dataflow->add(std::move(f), ends); !gang.empty())
+      workers->submit_gang(std::move(gang), high_priority);
+  }
+
+
+  /// Start the held tasks connected by pipes, even without their whole gang
+  void flush_dataflow() {
+    if (!dataflow)
+      return;
+    if (auto gang = dataflow->flush(); !gang.empty())
+      workers->submit_gang(std::move(gang), high_priority);
+  }
+
+
+  /** Use a specific worker pool for the tasks submitted from now on
+
+      The tasks already submitted keep running on their former pool.
+  */
+  void set_worker_pool(std::shared_ptr<detail::task_executor> p) {
+    workers = std::move(p);
+  }
+
+
 #ifdef TRISYCL_OPENCL
   /** Return the underlying OpenCL command queue after doing a retain
 
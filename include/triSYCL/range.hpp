@@ -54,7 +54,7 @@ class range
     // Return the product of the sizes in each dimension
     return std::accumulate(this->cbegin(),
                            this->cend(),
-                           1,
+                           std::size_t { 1 },
                            std::multiplies<size_t> {});
   }
 };
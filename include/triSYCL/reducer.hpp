@@ -0,0 +1,116 @@
+#ifndef TRISYCL_SYCL_REDUCER_HPP
+#define TRISYCL_SYCL_REDUCER_HPP
+
+/** \file The SYCL reducer, accumulating the contributions of some
+    work-items to a reduction
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <type_traits>
+
+#include "triSYCL/functional.hpp"
+
+namespace trisycl {
+
+namespace detail {
+
+template <typename T, typename BinaryOperation, typename Target>
+class reduction_variable;
+
+}
+
+/** \addtogroup parallelism Expressing parallelism through kernels
+    @{
+*/
+
+/** The interface of a kernel to a reduction variable
+
+    A reducer accumulates the contributions of the work-items executed
+    by the same thread, so it is only combined with the other partial
+    results once at the end of the kernel.
+*/
+template <typename T, typename BinaryOperation>
+class reducer {
+  /// The partial result
+  T value;
+
+  /// The identity of the operation
+  T identity_value;
+
+  BinaryOperation combiner;
+
+  template <typename, typename, typename>
+  friend class detail::reduction_variable;
+
+  template <template <typename> typename Op>
+  static constexpr bool is = detail::is_operation_v<Op, BinaryOperation, T>;
+
+public:
+
+  using value_type = T;
+  using binary_operation = BinaryOperation;
+
+
+  /// Start a partial result from the identity of the operation
+  reducer(const T &identity, BinaryOperation combiner)
+    : value { identity }, identity_value { identity }, combiner { combiner }
+  {}
+
+
+  /// Combine a contribution into the partial result
+  reducer &combine(const T &partial) {
+    value = combiner(value, partial);
+    return *this;
+  }
+
+
+  /// Get the identity of the operation of the reduction
+  T identity() const {
+    return identity_value;
+  }
+
+
+  /// The operators available for the known operations
+  reducer &operator+=(const T &partial) requires is<plus> {
+    return combine(partial);
+  }
+
+  reducer &operator*=(const T &partial) requires is<multiplies> {
+    return combine(partial);
+  }
+
+  reducer &operator&=(const T &partial) requires is<bit_and> {
+    return combine(partial);
+  }
+
+  reducer &operator|=(const T &partial) requires is<bit_or> {
+    return combine(partial);
+  }
+
+  reducer &operator^=(const T &partial) requires is<bit_xor> {
+    return combine(partial);
+  }
+
+  reducer &operator++() requires (is<plus> && std::is_integral_v<T>) {
+    return combine(1);
+  }
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_REDUCER_HPP
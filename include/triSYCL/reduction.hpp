@@ -0,0 +1,116 @@
+#ifndef TRISYCL_SYCL_REDUCTION_HPP
+#define TRISYCL_SYCL_REDUCTION_HPP
+
+/** \file The SYCL 2020 reductions
+
+    A reduction variable is given to parallel_for before the kernel,
+    which gets a reducer for each of them after its index:
+    \code
+    q.submit([&](handler &cgh) {
+      auto a = input.get_access<access::mode::read>(cgh);
+      cgh.parallel_for(range<1> { N },
+                       reduction(sum, cgh, plus<>()),
+                       reduction(max, cgh, maximum<>()),
+                       [=](id<1> i, auto &s, auto &m) {
+                         s += a[i];
+                         m.combine(a[i]);
+                       });
+    });
+    \endcode
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <type_traits>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/accessor.hpp"
+#include "triSYCL/buffer.hpp"
+#include "triSYCL/functional.hpp"
+#include "triSYCL/handler.hpp"
+#include "triSYCL/property_list.hpp"
+#include "triSYCL/reducer.hpp"
+#include "triSYCL/reduction/detail/reduction.hpp"
+
+namespace trisycl {
+
+/** \addtogroup parallelism Expressing parallelism through kernels
+    @{
+*/
+
+/** Make a reduction into the first element of a buffer
+
+    \param[in] vars is the buffer holding the reduction variable
+
+    \param[in] cgh is the command group handler of the kernel
+
+    \param[in] identity is the identity of \p combiner
+
+    \param[in] combiner is the operation of the reduction
+
+    \param[in] props can ask with
+    property::reduction::initialize_to_identity to ignore the initial
+    value of the variable
+*/
+template <typename T, typename Allocator, typename BinaryOperation>
+auto reduction(buffer<T, 1, Allocator> vars, handler &cgh,
+               const std::type_identity_t<T> &identity,
+               BinaryOperation combiner,
+               const property_list &props = {}) {
+  auto target = vars.template get_access<access::mode::read_write>(cgh);
+  return detail::reduction_variable<T, BinaryOperation, decltype(target)> {
+    target, identity, combiner, props
+  };
+}
+
+
+/// Make a reduction into a buffer with an operation of known identity
+template <typename T, typename Allocator, typename BinaryOperation>
+  requires has_known_identity_v<BinaryOperation, T>
+auto reduction(buffer<T, 1, Allocator> vars, handler &cgh,
+               BinaryOperation combiner, const property_list &props = {}) {
+  return reduction(vars, cgh, known_identity_v<BinaryOperation, T>,
+                   combiner, props);
+}
+
+
+/** Make a reduction into a variable in host memory
+
+    The variable must stay alive until the kernel ends and it is not
+    tracked as a dependency between the kernels.
+*/
+template <typename T, typename BinaryOperation>
+auto reduction(T *var, const std::type_identity_t<T> &identity,
+               BinaryOperation combiner,
+               const property_list &props = {}) {
+  return detail::reduction_variable<T, BinaryOperation, T *> {
+    var, identity, combiner, props
+  };
+}
+
+
+/// Make a reduction into a host variable with an operation of known identity
+template <typename T, typename BinaryOperation>
+  requires has_known_identity_v<BinaryOperation, T>
+auto reduction(T *var, BinaryOperation combiner,
+               const property_list &props = {}) {
+  return reduction(var, known_identity_v<BinaryOperation, T>, combiner,
+                   props);
+}
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_REDUCTION_HPP
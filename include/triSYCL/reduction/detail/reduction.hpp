@@ -0,0 +1,408 @@
+#ifndef TRISYCL_SYCL_REDUCTION_DETAIL_REDUCTION_HPP
+#define TRISYCL_SYCL_REDUCTION_DETAIL_REDUCTION_HPP
+
+/** \file
+
+    Execute the parallel_for kernels with some reductions
+
+    Each thread executing a kernel accumulates into its own reducers,
+    in cache-line-padded slots so the threads do not share any cache
+    line. The partial results are only combined once, by the task
+    thread, when the kernel ends, so there is no atomic operation
+    during the kernel execution.
+
+    With OpenMP, a range kernel is executed by slices like a normal
+    kernel, each thread using several independent reducers along the
+    innermost dimension to hide the latency of the accumulation. The
+    partial results are combined in the thread order, so a reduction
+    on floating-point numbers gives the same result on each run with
+    the same number of threads.
+
+    Otherwise, for an nd_range kernel or with TBB, each thread gets a
+    slot the first time it executes a work-item of the kernel.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "triSYCL/detail/concurrency_governor.hpp"
+#include "triSYCL/detail/placement.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/item.hpp"
+#include "triSYCL/nd_item.hpp"
+#include "triSYCL/nd_range.hpp"
+#include "triSYCL/parallelism.hpp"
+#include "triSYCL/property_list.hpp"
+#include "triSYCL/range.hpp"
+#include "triSYCL/reducer.hpp"
+#include "triSYCL/vendor/triSYCL/cost_hint.hpp"
+#include "triSYCL/vendor/triSYCL/no_barrier.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace trisycl::detail {
+
+/** \addtogroup parallelism
+    @{
+*/
+
+/** A reduction variable, as returned by sycl::reduction()
+
+    \tparam Target is a pointer or a 1-element accessor to the variable
+*/
+template <typename T, typename BinaryOperation, typename Target>
+class reduction_variable : public property_list {
+  /// Where the result goes
+  Target target;
+
+  T identity;
+
+  BinaryOperation combiner;
+
+public:
+
+  using value_type = T;
+  using reducer_type = reducer<T, BinaryOperation>;
+
+
+  reduction_variable(Target target, const T &identity,
+                     BinaryOperation combiner,
+                     const property_list &props)
+    : property_list { props }
+    , target { target }
+    , identity { identity }
+    , combiner { combiner }
+  {}
+
+
+  template <typename propertyT>
+  bool has_property() const {
+    return property_list::has_property<propertyT>();
+  }
+
+
+  template <typename propertyT>
+  propertyT get_property() const {
+    return property_list::get_property<propertyT>();
+  }
+
+
+  /// Get a reducer starting from the identity
+  reducer_type make_reducer() const {
+    return { identity, combiner };
+  }
+
+
+  /// Merge the partial result of a reducer into another one
+  void merge(reducer_type &into, const reducer_type &from) const {
+    into.combine(from.value);
+  }
+
+
+  /// Store the combination of all the partial results
+  void store(const reducer_type &total) const {
+    auto &variable = [&] () -> T & {
+      if constexpr (std::is_pointer_v<Target>)
+        return *target;
+      else
+        return target[0];
+    }();
+    variable = has_property<::trisycl::property::reduction
+                            ::initialize_to_identity>()
+      ? total.value : combiner(variable, total.value);
+  }
+
+};
+
+
+/// Test whether a parallel_for argument is a reduction variable
+template <typename T>
+inline constexpr bool is_reduction_v = false;
+
+template <typename T, typename BinaryOperation, typename Target>
+inline constexpr bool
+is_reduction_v<reduction_variable<T, BinaryOperation, Target>> = true;
+
+
+/// The partial results of the reductions of a kernel
+template <typename... Reductions>
+class reduction_partials {
+
+public:
+
+  /// The reducers of a thread, one per reduction
+  using reducers = std::tuple<typename Reductions::reducer_type...>;
+
+  /// The number of reducers used by a thread along the innermost loop
+  static constexpr std::size_t lanes = 8;
+
+private:
+
+  /// The reducers of a thread, alone on their cache lines
+  struct alignas(64) slot {
+    reducers r;
+  };
+
+  const std::tuple<Reductions...> &reductions;
+
+  /// With stable addresses since the threads keep a pointer to theirs
+  std::deque<slot> slots;
+
+  /// To protect the slots while the threads add theirs
+  std::mutex protect;
+
+  /// A different number for each kernel execution
+  std::uint64_t run;
+
+  static inline std::atomic<std::uint64_t> runs = 0;
+
+public:
+
+  reduction_partials(const std::tuple<Reductions...> &reductions)
+    : reductions { reductions }, run { ++runs } {}
+
+
+  /// Get some reducers starting from the identities
+  reducers make() const {
+    return std::apply([] (auto &... r) {
+                        return reducers { r.make_reducer()... };
+                      }, reductions);
+  }
+
+
+  /// Merge some reducers into some other ones
+  void merge(reducers &into, const reducers &from) const {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (std::get<I>(reductions).merge(std::get<I>(into), std::get<I>(from)),
+       ...);
+    }(std::index_sequence_for<Reductions...> {});
+  }
+
+
+  /// Add the slots for \p n threads which are used in thread order
+  void add_slots(std::size_t n) {
+    for (std::size_t i = 0; i != n; ++i)
+      slots.push_back({ make() });
+  }
+
+
+  /// Get the slot of the thread \p t added with add_slots()
+  reducers &slot_of(std::size_t t) {
+    return slots[t].r;
+  }
+
+
+  /** Get the reducers of the current thread, creating them the first
+      time the thread executes a work-item of the kernel
+  */
+  reducers &local() {
+    static thread_local struct {
+      std::uint64_t run = 0;
+      slot *s = nullptr;
+    } cache;
+    if (cache.run != run) {
+      std::lock_guard lock { protect };
+      slots.push_back({ make() });
+      cache = { run, &slots.back() };
+    }
+    return cache.s->r;
+  }
+
+
+  /// Combine all the partial results and store them into the variables
+  void store() {
+    auto total = make();
+    for (auto &s : slots)
+      merge(total, s.r);
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (std::get<I>(reductions).store(std::get<I>(total)), ...);
+    }(std::index_sequence_for<Reductions...> {});
+  }
+
+};
+
+
+/// Call a kernel with an index and some reducers
+template <typename Kernel, typename Index, typename Reducers>
+void call_with_reducers(Kernel &f, const Index &index, Reducers &r) {
+  std::apply([&] (auto &... reducer) { f(index, reducer...); }, r);
+}
+
+
+/** Execute a kernel with some reductions on a range
+
+    The kernel is called with an id<> or an item<> followed by a
+    reducer per reduction.
+*/
+template <int Dimensions, typename ParallelForFunctor,
+          typename... Reductions>
+void parallel_for_reduce(range<Dimensions> r, ParallelForFunctor f,
+                         const std::tuple<Reductions...> &reductions) {
+  using partials_t = reduction_partials<Reductions...>;
+  partials_t partials { reductions };
+  // Prefer an id<> index since an item<> may be converted to it
+  constexpr bool takes_id =
+    std::is_invocable_v<ParallelForFunctor &, id<Dimensions>,
+                        typename Reductions::reducer_type &...>;
+  auto index_of = [&] (const id<Dimensions> &i) {
+    if constexpr (takes_id)
+      return i;
+    else
+      return item<Dimensions> { r, i };
+  };
+
+#ifdef _OPENMP
+  if constexpr (Dimensions <= 3) {
+    constexpr auto last = Dimensions - 1;
+    const std::size_t inner = r[last];
+    const std::size_t rows = r.size()/(inner ? inner : 1);
+    if (r.size() == 0) {
+      partials.store();
+      return;
+    }
+    constexpr auto lanes = partials_t::lanes;
+    /* Execute the rows [begin, end), or the elements [begin, end) in
+       1D, into some reducers, spreading the work-items of a row over
+       several independent reducers */
+    auto iterate = [&] (std::size_t begin, std::size_t end,
+                        typename partials_t::reducers &result) {
+      auto lane = [&]<std::size_t... K>(std::index_sequence<K...>) {
+        return std::array { (static_cast<void>(K), partials.make())... };
+      }(std::make_index_sequence<lanes> {});
+      // Execute the work-items [from, to) of a row
+      auto iterate_row = [&] (const id<Dimensions> &row, std::size_t from,
+                              std::size_t to) {
+        auto row_index = [&] (std::size_t i) {
+          auto index = row;
+          index[last] = i;
+          return index_of(index);
+        };
+        auto i = from;
+        for (; i + lanes <= to; i += lanes)
+          for (std::size_t k = 0; k != lanes; ++k)
+            call_with_reducers(f, row_index(i + k), lane[k]);
+        for (; i < to; ++i)
+          call_with_reducers(f, row_index(i), lane[0]);
+      };
+      if constexpr (Dimensions == 1)
+        iterate_row(id<1> {}, begin, end);
+      else {
+        id<Dimensions> row;
+        auto rest = begin;
+        for (int d = last - 1; d >= 0; --d) {
+          row[d] = rest % r[d];
+          rest /= r[d];
+        }
+        for (auto l = begin; l < end; ++l) {
+          iterate_row(row, 0, inner);
+          // Move to the next row
+          for (int d = last - 1; d >= 0 && ++row[d] == r[d]; --d)
+            row[d] = 0;
+        }
+      }
+      for (auto &partial : lane)
+        partials.merge(result, partial);
+    };
+    // In 1D there is only one row, so split its elements instead
+    const auto total = Dimensions == 1 ? inner : rows;
+    if (!concurrency_governor::is_worth_parallelizing(
+          r.size(), vendor::trisycl::kernel_cost(f))) {
+      partials.add_slots(1);
+      iterate(0, total, partials.slot_of(0));
+    } else {
+      // Do not oversubscribe the cores with the other running kernels
+      auto share = concurrency_governor::instance().acquire();
+      // The placement of the worker executing the kernel, if any
+      auto where = placement::current();
+      // Upper bound of the team size, the unused slots staying neutral
+      partials.add_slots(share.get_threads());
+#pragma omp parallel num_threads(share.get_threads())
+      {
+        std::size_t t = omp_get_thread_num();
+        std::size_t n = omp_get_num_threads();
+        if (where)
+          where->pin_team_member(t, n);
+        iterate(total*t/n, total*(t + 1)/n, partials.slot_of(t));
+      }
+    }
+    partials.store();
+    return;
+  }
+#endif
+  auto with_reducers = [&] (auto index) {
+    call_with_reducers(f, index, partials.local());
+  };
+  if constexpr (takes_id)
+    parallel_for(r, vendor::trisycl::cost_hint(
+                      vendor::trisycl::kernel_cost(f),
+                      [&] (id<Dimensions> i) { with_reducers(i); }));
+  else
+    parallel_for(r, vendor::trisycl::cost_hint(
+                      vendor::trisycl::kernel_cost(f),
+                      [&] (item<Dimensions> i) { with_reducers(i); }));
+  partials.store();
+}
+
+
+/** Execute a kernel with some reductions on an nd_range
+
+    The kernel is called with an nd_item<> followed by a reducer per
+    reduction.
+
+    \param[in] local_memory_size is the number of bytes of local
+    memory of each work-group
+*/
+template <int Dimensions, typename ParallelForFunctor,
+          typename... Reductions>
+void parallel_for_reduce(nd_range<Dimensions> r, ParallelForFunctor f,
+                         const std::tuple<Reductions...> &reductions,
+                         std::size_t local_memory_size = 0) {
+  reduction_partials<Reductions...> partials { reductions };
+  // The marker has to stay around the kernel seen by the runtime
+  auto &kernel = [&] () -> auto & {
+    if constexpr (vendor::trisycl::is_no_barrier_kernel_v<ParallelForFunctor>)
+      return f.kernel;
+    else
+      return f;
+  }();
+  /* Even when the work-items of a work-group are fibers sharing a
+     thread, they only switch at a barrier, never in the middle of an
+     operation on a reducer */
+  auto with_reducers = [&] (nd_item<Dimensions> index) {
+    call_with_reducers(kernel, index, partials.local());
+  };
+  if constexpr (vendor::trisycl::is_no_barrier_kernel_v<ParallelForFunctor>)
+    parallel_for(r, vendor::trisycl::no_barrier(with_reducers),
+                 local_memory_size);
+  else
+    parallel_for(r, with_reducers, local_memory_size);
+  partials.store();
+}
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_REDUCTION_DETAIL_REDUCTION_HPP
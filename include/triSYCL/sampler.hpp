@@ -0,0 +1,101 @@
+#ifndef TRISYCL_SYCL_SAMPLER_HPP
+#define TRISYCL_SYCL_SAMPLER_HPP
+
+/** \file
+
+    OpenCL SYCL sampler class
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+namespace trisycl {
+
+/** \addtogroup data
+
+    @{
+*/
+
+/// How the coordinates outside of an image are mapped inside it
+enum class addressing_mode : char {
+  mirrored_repeat,
+  repeat,
+  clamp_to_edge,
+  clamp,
+  none
+};
+
+
+/// How a texel is computed from the texels around the coordinates
+enum class filtering_mode : char {
+  nearest,
+  linear
+};
+
+
+/// Whether the coordinates are in [0, 1] or in texels
+enum class coordinate_normalization_mode : char {
+  normalized,
+  unnormalized
+};
+
+
+/** A sampler describes how an image is read with some floating-point
+    coordinates
+
+    It is just a small value type captured by the kernels.
+*/
+class sampler {
+
+  coordinate_normalization_mode normalization;
+
+  addressing_mode addressing;
+
+  filtering_mode filtering;
+
+public:
+
+  constexpr sampler(coordinate_normalization_mode normalization_mode,
+                    addressing_mode addressing_mode,
+                    filtering_mode filtering_mode)
+    : normalization { normalization_mode }
+    , addressing { addressing_mode }
+    , filtering { filtering_mode } {}
+
+
+  constexpr addressing_mode get_addressing_mode() const {
+    return addressing;
+  }
+
+
+  constexpr filtering_mode get_filtering_mode() const {
+    return filtering;
+  }
+
+
+  constexpr coordinate_normalization_mode
+  get_coordinate_normalization_mode() const {
+    return normalization;
+  }
+
+
+  friend constexpr bool operator==(const sampler &,
+                                   const sampler &) = default;
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SAMPLER_HPP
@@ -0,0 +1,70 @@
+#ifndef TRISYCL_SYCL_SPECIALIZATION_ID_HPP
+#define TRISYCL_SYCL_SPECIALIZATION_ID_HPP
+
+/** \file The SYCL specialization_id, declaring a specialization constant
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <utility>
+
+namespace trisycl {
+
+namespace detail {
+
+class specialization_constants;
+
+}
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** Declare a specialization constant of type T, with its default value
+
+    It is declared as a constexpr variable at namespace scope, and its
+    address identifies the constant in the handler and the
+    kernel_handler:
+    \code
+    constexpr specialization_id<int> width { 3 };
+    \endcode
+*/
+template <typename T>
+class specialization_id {
+  /// The value of the constant when the command group does not set it
+  T default_value;
+
+  friend class detail::specialization_constants;
+
+public:
+
+  using value_type = T;
+
+
+  /// Construct the default value from some arguments
+  template <typename... Args>
+  explicit constexpr specialization_id(Args &&... args)
+    : default_value(std::forward<Args>(args)...) {}
+
+
+  /// A specialization constant is only referenced by its address
+  specialization_id(const specialization_id &) = delete;
+  specialization_id(specialization_id &&) = delete;
+  specialization_id &operator=(const specialization_id &) = delete;
+  specialization_id &operator=(specialization_id &&) = delete;
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SPECIALIZATION_ID_HPP
@@ -0,0 +1,171 @@
+#ifndef TRISYCL_SYCL_SUB_GROUP_HPP
+#define TRISYCL_SYCL_SUB_GROUP_HPP
+
+/** \file The SYCL 2020 sub_group
+
+    A work-group is split into sub-groups of TRISYCL_SUB_GROUP_SIZE
+    work-items with consecutive local linear ids, the last sub-group
+    being smaller when the work-group size is not a multiple of it.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <cstddef>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/detail/unimplemented.hpp"
+#include "triSYCL/id.hpp"
+#include "triSYCL/range.hpp"
+
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+#include "triSYCL/parallelism/detail/work_item_fibers.hpp"
+#endif
+
+/** The maximum number of work-items in a sub-group
+
+    By default it is the number of 32-bit lanes of the widest SIMD
+    registers of the target.
+*/
+#ifndef TRISYCL_SUB_GROUP_SIZE
+#if defined(__AVX512F__)
+#define TRISYCL_SUB_GROUP_SIZE 16
+#elif defined(__AVX__)
+#define TRISYCL_SUB_GROUP_SIZE 8
+#else
+#define TRISYCL_SUB_GROUP_SIZE 4
+#endif
+#endif
+
+namespace trisycl {
+
+/** \addtogroup parallelism Expressing parallelism through kernels
+    @{
+*/
+
+/// A sub-group of the work-items of a work-group
+class sub_group {
+
+public:
+
+  using id_type = id<1>;
+  using range_type = range<1>;
+  using linear_id_type = std::size_t;
+  static constexpr int dimensions = 1;
+
+  /// The maximum number of work-items in a sub-group
+  static constexpr std::size_t max_size = TRISYCL_SUB_GROUP_SIZE;
+
+private:
+
+  /// The local linear id of the work-item in its work-group
+  std::size_t work_group_local;
+
+  /// The number of work-items of the work-group
+  std::size_t work_group_size;
+
+public:
+
+  /** Create the sub-group of a work-item
+
+      \todo This should be private since it is only used by nd_item<>
+  */
+  sub_group(std::size_t work_group_local, std::size_t work_group_size)
+    : work_group_local { work_group_local }
+    , work_group_size { work_group_size } {}
+
+
+  /// Return the index of the sub-group in the work-group
+  id_type get_group_id() const { return get_group_linear_id(); }
+
+
+  /// Return the index of the work-item in the sub-group
+  id_type get_local_id() const { return get_local_linear_id(); }
+
+
+  /// Return the number of work-items in this sub-group
+  range_type get_local_range() const { return get_local_linear_range(); }
+
+
+  /// Return the number of sub-groups in the work-group
+  range_type get_group_range() const { return get_group_linear_range(); }
+
+
+  /// Return the maximum number of work-items in any sub-group
+  range_type get_max_local_range() const { return max_size; }
+
+
+  linear_id_type get_group_linear_id() const {
+    return work_group_local/max_size;
+  }
+
+
+  linear_id_type get_local_linear_id() const {
+    return work_group_local % max_size;
+  }
+
+
+  linear_id_type get_group_linear_range() const {
+    return (work_group_size + max_size - 1)/max_size;
+  }
+
+
+  linear_id_type get_local_linear_range() const {
+    return std::min(max_size,
+                    work_group_size - get_group_linear_id()*max_size);
+  }
+
+
+  /// Test whether the work-item is the first one of its sub-group
+  bool leader() const { return get_local_linear_id() == 0; }
+
+
+  /// The local linear id of the work-item in its work-group
+  std::size_t get_work_group_local_linear_id() const {
+    return work_group_local;
+  }
+
+
+  /// The number of work-items in the work-group
+  std::size_t get_work_group_size() const { return work_group_size; }
+
+
+  /** Wait for the other work-items of the sub-group
+
+      Since the work-items of a work-group are not executed by
+      sub-groups, this waits for the whole work-group, so all the
+      sub-groups of a work-group have to reach it.
+  */
+  void barrier(access::fence_space flag =
+               access::fence_space::global_and_local) const {
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+    // Switch to the other work-items of the work-group
+    detail::work_item_fibers::barrier();
+#elif defined(_OPENMP) && !defined(TRISYCL_NO_BARRIER)
+    /* Use OpenMP barrier in the implementation with 1 OpenMP thread per
+       work-item of the work-group */
+#pragma omp barrier
+#else
+    // \todo To be implemented efficiently otherwise
+    TRISYCL_UNIMPL;
+#endif
+  }
+
+};
+
+/// @} End the parallelism Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SUB_GROUP_HPP
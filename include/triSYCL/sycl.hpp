@@ -48,6 +48,8 @@
 #include "triSYCL/accessor.hpp"
 #include "triSYCL/allocator.hpp"
 #include "triSYCL/address_space.hpp"
+#include "triSYCL/atomic_ref.hpp"
+#include "triSYCL/bfloat16.hpp"
 #include "triSYCL/buffer.hpp"
 #include "triSYCL/context.hpp"
 #include "triSYCL/device.hpp"
@@ -56,13 +58,16 @@
 #include "triSYCL/error_handler.hpp"
 #include "triSYCL/event.hpp"
 #include "triSYCL/exception.hpp"
+#include "triSYCL/functional.hpp"
 #include "triSYCL/group.hpp"
+#include "triSYCL/group_algorithm.hpp"
 #include "triSYCL/half.hpp"
 #include "triSYCL/handler.hpp"
 #include "triSYCL/h_item.hpp"
 #include "triSYCL/id.hpp"
 #include "triSYCL/image.hpp"
 #include "triSYCL/item.hpp"
+#include "triSYCL/kernel_handler.hpp"
 #include "triSYCL/math.hpp"
 #include "triSYCL/nd_item.hpp"
 #include "triSYCL/nd_range.hpp"
@@ -73,15 +78,25 @@
 #include "triSYCL/program.hpp"
 #include "triSYCL/queue.hpp"
 #include "triSYCL/range.hpp"
+#include "triSYCL/reducer.hpp"
+#include "triSYCL/reduction.hpp"
+#include "triSYCL/sampler.hpp"
+#include "triSYCL/specialization_id.hpp"
+#if __has_include(<sys/mman.h>) && !defined(TRISYCL_NO_EXTENSIONS)
+#include "triSYCL/sycl_2_2/interprocess_pipe.hpp"
+#endif
 #include "triSYCL/sycl_2_2/pipe.hpp"
 #include "triSYCL/sycl_2_2/pipe_reservation.hpp"
 #include "triSYCL/sycl_2_2/static_pipe.hpp"
+#include "triSYCL/task_graph.hpp"
+#include "triSYCL/usm.hpp"
 #include "triSYCL/vec.hpp"
 
 // Some includes at the end to break some dependencies
 #include "triSYCL/device_selector/detail/device_selector_tail.hpp"
 #include "triSYCL/context/detail/context_tail.hpp"
 #include "triSYCL/device/detail/device_tail.hpp"
+#include "triSYCL/device/detail/host_sub_device_tail.hpp"
 #include "triSYCL/queue/detail/queue_tail.hpp"
 #ifdef TRISYCL_OPENCL
 #include "triSYCL/device/detail/opencl_device_tail.hpp"
@@ -92,8 +107,10 @@
 #include "triSYCL/platform/detail/opencl_platform_tail.hpp"
 #endif
 
+#ifndef TRISYCL_NO_EXTENSIONS
 // Some include files for Xilinx-specific features, such as for FPGA
 #include "triSYCL/vendor/Xilinx/fpga.hpp"
+#endif
 
 // An extension about constexpr host introspection API
 //#include "triSYCL/extension/ce/platform.hpp"
@@ -0,0 +1,142 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_HPP
+#define TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_HPP
+
+/** \file A SYCL 2.2 dataflow pipe connecting kernels of different
+    processes
+
+    This is a triSYCL extension to the now abandoned SYCL 2.2
+    provisional specification.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "triSYCL/access.hpp"
+#include "triSYCL/accessor.hpp"
+#include "triSYCL/handler.hpp"
+#include "triSYCL/sycl_2_2/interprocess_pipe/detail/interprocess_pipe.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/pipe.hpp"
+
+namespace trisycl::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/** A SYCL pipe whose elements go through some POSIX shared memory to
+    the pipe with the same name in another process
+
+    A producer kernel in a process can feed a consumer kernel in
+    another process at memory bandwidth, with the same accessors as a
+    normal pipe:
+    \code
+    // In the producer process
+    sycl_2_2::interprocess_pipe<float> p { "/samples", 1024 };
+    q.submit([&](handler &cgh) {
+      auto out = p.get_access<access::mode::write,
+                              access::target::blocking_pipe>(cgh);
+      cgh.single_task([=] { out << 3.14f; });
+    });
+    // In the consumer process, with the same name and capacity
+    sycl_2_2::interprocess_pipe<float> p { "/samples", 1024 };
+    \endcode
+
+    The elements have to be trivially copyable. A process can only use
+    one side of the pipe, since the elements of a side in flight are
+    not protected against another process. The reservations are not
+    supported and a blocking access polls the pipe after spinning a
+    while, since the other process cannot wake it up.
+
+    The shared-memory object is created by the first process and
+    removed when the last one destroys its pipe.
+*/
+template <typename T>
+class interprocess_pipe
+    /* Use the underlying pipe implementation that can be shared in
+       the SYCL model */
+  : public detail::shared_ptr_implementation<interprocess_pipe<T>,
+                                             detail::sycl_2_2::pipe<T>>,
+    detail::debug<interprocess_pipe<T>> {
+
+  // The type encapsulating the implementation
+  using implementation_t =
+    typename interprocess_pipe::shared_ptr_implementation;
+
+  // Allows the comparison operation to access the implementation
+  friend implementation_t;
+
+public:
+
+  // Make the implementation member directly accessible in this class
+  using implementation_t::implementation;
+
+  /// The STL-like types
+  using value_type = T;
+
+
+  /** Construct a pipe able to store up to capacity T objects in the
+      shared-memory object \p name, such as "/my_pipe"
+  */
+  interprocess_pipe(const std::string &name, std::size_t capacity)
+    /* Keep the real type in the shared pointer to destroy the
+       shared-memory mapping too */
+    : implementation_t { std::shared_ptr<detail::sycl_2_2::pipe<T>> {
+        std::make_shared<detail::sycl_2_2::interprocess_pipe<T>>(
+          name, capacity) } } { }
+
+
+  /** Get an accessor to the pipe with the required mode
+
+      \param Mode is the requested access mode
+
+      \param Target is the type of pipe access required
+
+      \param[in] command_group_handler is the command group handler in
+      which the kernel is to be executed
+  */
+  template <access::mode Mode,
+            access::target Target = access::target::pipe>
+  accessor<value_type, 1, Mode, Target>
+  get_access(handler &command_group_handler) {
+    static_assert(Target == access::target::pipe
+                  || Target == access::target::blocking_pipe,
+                  "get_access(handler) with pipes can only deal with "
+                  "access::pipe or access::blocking_pipe");
+    return { implementation, command_group_handler };
+  }
+
+
+  /** Set the number of times a blocking access spins on the pipe
+      before polling it
+  */
+  void set_spin_budget(std::size_t budget) {
+    implementation->set_spin_budget(budget);
+  }
+
+
+  /// Return the maximum number of elements that can fit in the pipe
+  std::size_t capacity() const {
+    return implementation->capacity();
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_HPP
@@ -0,0 +1,215 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_DETAIL_INTERPROCESS_PIPE_HPP
+#define TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_DETAIL_INTERPROCESS_PIPE_HPP
+
+/** \file The SYCL interprocess_pipe<> details
+
+    The ring of the pipe lives in a POSIX shared-memory object laid out
+    as a header with the indices of the ring, followed by the slots of
+    the elements.
+
+    This is a triSYCL extension to the now abandoned SYCL 2.2
+    provisional specification.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "triSYCL/exception.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/pipe.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/spsc_ring.hpp"
+
+namespace trisycl::detail::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/// A shared-memory object holding the ring of an inter-process pipe
+template <typename T>
+class interprocess_pipe_segment {
+
+  using ring_t = spsc_ring<T>;
+
+  /// The start of the shared-memory object
+  struct header {
+    /// Set by the creator once the header is initialized
+    std::atomic<std::uint32_t> initialized;
+
+    /// The number of processes using the pipe
+    std::atomic<std::uint32_t> attached;
+
+    /// To check that all the processes agree on the pipe
+    std::uint64_t capacity;
+    std::uint64_t element_size;
+
+    typename ring_t::indices indices;
+  };
+
+  static_assert(std::atomic<std::size_t>::is_always_lock_free,
+                "the ring indices have to be lock-free to be shared "
+                "between processes");
+
+  /// The offset of the slots in the shared-memory object
+  static constexpr std::size_t slots_offset =
+    (sizeof(header) + alignof(typename ring_t::slot) - 1)
+    / alignof(typename ring_t::slot) * alignof(typename ring_t::slot);
+
+  /// The name of the shared-memory object
+  std::string name;
+
+  /// The number of bytes mapped
+  std::size_t bytes;
+
+  /// The mapped shared-memory object
+  void *mapping;
+
+  /// Throw an exception explaining the last system error
+  [[noreturn]] static void fail(const std::string &what,
+                                const std::string &name) {
+    throw ::trisycl::runtime_error {
+      what + " \"" + name + "\": " + std::strerror(errno)
+    };
+  }
+
+
+  /// Map the \p fd shared-memory object
+  void map(int fd) {
+    mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                     fd, 0);
+    auto e = errno;
+    ::close(fd);
+    errno = e;
+    if (mapping == MAP_FAILED)
+      fail("Cannot map the pipe", name);
+  }
+
+protected:
+
+  header &get_header() { return *static_cast<header *>(mapping); }
+
+
+  typename ring_t::slot *get_slots() {
+    return reinterpret_cast<typename ring_t::slot *>(
+      static_cast<std::byte *>(mapping) + slots_offset);
+  }
+
+
+  typename ring_t::indices &get_indices() { return get_header().indices; }
+
+public:
+
+  /** Create or open the shared-memory object \p name for a pipe of \p
+      capacity elements
+
+      The first process creates and initializes it, the others wait
+      for its initialization.
+  */
+  interprocess_pipe_segment(const std::string &name, std::size_t capacity)
+    : name { name }
+    , bytes { slots_offset
+              + ring_t::slots_for(capacity)*sizeof(typename ring_t::slot) } {
+    auto fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd >= 0) {
+      if (::ftruncate(fd, bytes) < 0) {
+        auto e = errno;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        errno = e;
+        fail("Cannot size the pipe", name);
+      }
+      map(fd);
+      auto h = new (mapping) header {};
+      h->capacity = capacity;
+      h->element_size = sizeof(T);
+      h->attached = 1;
+      h->initialized.store(1, std::memory_order_release);
+      return;
+    }
+    if (errno != EEXIST)
+      fail("Cannot create the pipe", name);
+    fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0)
+      fail("Cannot open the pipe", name);
+    // Wait for the creator to size the object
+    for (struct ::stat s; ::fstat(fd, &s) == 0 && s.st_size == 0;)
+      std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+    map(fd);
+    auto &h = get_header();
+    while (!h.initialized.load(std::memory_order_acquire))
+      std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+    if (h.capacity != capacity || h.element_size != sizeof(T)) {
+      ::munmap(mapping, bytes);
+      throw ::trisycl::invalid_parameter_error {
+        "The inter-process pipe \"" + name
+        + "\" already exists with another capacity or element type"
+      };
+    }
+    ++h.attached;
+  }
+
+
+  interprocess_pipe_segment(const interprocess_pipe_segment &) = delete;
+
+
+  /// Remove the shared-memory object when the last process detaches
+  ~interprocess_pipe_segment() {
+    if (--get_header().attached == 0)
+      ::shm_unlink(name.c_str());
+    ::munmap(mapping, bytes);
+  }
+
+};
+
+
+/** A pipe whose elements go through some shared memory to a pipe with
+    the same name in another process
+
+    The segment is a base class so it is mapped before the pipe using
+    it and unmapped after.
+*/
+template <typename T>
+class interprocess_pipe : private interprocess_pipe_segment<T>,
+                          public pipe<T> {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "only trivially copyable elements can go through an "
+                "inter-process pipe");
+
+public:
+
+  interprocess_pipe(const std::string &name, std::size_t capacity)
+    : interprocess_pipe_segment<T> { name, capacity }
+    , pipe<T> { capacity, this->get_slots(), this->get_indices() } {}
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_INTERPROCESS_PIPE_DETAIL_INTERPROCESS_PIPE_HPP
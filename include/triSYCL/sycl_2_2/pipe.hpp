@@ -26,6 +26,13 @@ namespace trisycl::sycl_2_2 {
     @{
 */
 
+/// The type of the tag to create a pipe with several readers and writers
+using mpmc_t = detail::sycl_2_2::mpmc_t;
+
+/// Tag to create a pipe with several readers and writers
+inline constexpr mpmc_t mpmc {};
+
+
 /** A SYCL pipe
 
     This is a proposal for the now abandoned SYCL 2.2 provisional specification.
@@ -64,6 +71,20 @@ public:
     : implementation_t { new detail::sycl_2_2::pipe<T> { capacity } } { }
 
 
+  /** Construct a pipe able to store up to capacity T objects, which
+      can be written and read by several kernels at the same time
+
+      This is a triSYCL extension for example for a work distribution
+      queue. The elements go through a lock-free ring where the
+      writers and the readers only contend on the index of their own
+      side, so the throughput scales with the number of kernels. Such a
+      pipe cannot use reservations and the values of a bulk write may
+      be interleaved with the ones of the other writers.
+  */
+  pipe(std::size_t capacity, mpmc_t m)
+    : implementation_t { new detail::sycl_2_2::pipe<T> { capacity, m } } { }
+
+
   /** Get an accessor to the pipe with the required mode
 
       \param Mode is the requested access mode
@@ -85,6 +106,29 @@ public:
   }
 
 
+  /** Set the number of times a blocking access spins on the pipe
+      before parking its task, 0 to park right away
+
+      This is a triSYCL extension to tune the latency of a pipe
+      against the processor time spent waiting.
+  */
+  void set_spin_budget(std::size_t budget) {
+    implementation->set_spin_budget(budget);
+  }
+
+
+#ifdef TRISYCL_PIPE_TELEMETRY
+  /** Get the statistics about the use of the pipe so far
+
+      This is a triSYCL extension only available when the
+      \c TRISYCL_PIPE_TELEMETRY macro is defined.
+  */
+  auto get_statistics() const {
+    return implementation->get_statistics();
+  }
+#endif
+
+
   /// Return the maximum number of elements that can fit in the pipe
   std::size_t capacity() const {
     return implementation->capacity();
@@ -0,0 +1,246 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_MPMC_RING_HPP
+#define TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_MPMC_RING_HPP
+
+/** \file A lock-free bounded ring buffer with multiple producers and
+    multiple consumers
+
+    This is a proposal for the now abandoned SYCL 2.2 provisional specification.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace trisycl::detail::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/** A ring buffer where several threads write and several threads read
+    concurrently without any lock
+
+    This is the bounded queue of Dmitry Vyukov: each slot has a
+    sequence number telling whether it waits for the producer or for
+    the consumer of a given index. A producer or a consumer claims an
+    index with a compare-and-swap on the index of its side, then
+    accesses its slot and publishes it to the other side by updating
+    the sequence number of the slot. So the producers and the consumers
+    only contend on the index of their own side, and never wait for
+    an access in progress on another slot.
+
+    The indices count the elements since the creation of the ring, so
+    the sequence numbers of a slot grow by the capacity at each turn,
+    which does not need to be a power of 2.
+*/
+template <typename T>
+class alignas(64) mpmc_ring {
+
+  /// The storage of an element with the turn of its next access
+  struct slot {
+    /** The index of the next write to the slot, or this index + 1
+        when the element is ready to be read
+    */
+    std::atomic<std::size_t> sequence;
+
+    alignas(T) std::byte storage[sizeof(T)];
+
+    T *get() { return reinterpret_cast<T *>(storage); }
+  };
+
+  /// The maximum number of elements, which is also the number of slots
+  std::size_t max_size;
+
+  /// The elements
+  std::unique_ptr<slot[]> slots;
+
+  /// Where the next producer writes
+  alignas(64) std::atomic<std::size_t> write_index = 0;
+
+  /// Where the next consumer reads
+  alignas(64) std::atomic<std::size_t> read_index = 0;
+
+
+  /// The slot of \p index
+  slot &at(std::size_t index) {
+    return slots[index % max_size];
+  }
+
+
+  /// The signed distance from \p index to the \p sequence of a slot
+  static std::intptr_t lag(std::size_t sequence, std::size_t index) {
+    return static_cast<std::intptr_t>(sequence - index);
+  }
+
+public:
+
+  /// Create a ring able to keep \p capacity elements
+  mpmc_ring(std::size_t capacity)
+    : max_size { capacity }
+    , slots { new slot[capacity] } {
+    for (std::size_t i = 0; i != capacity; ++i)
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+
+  mpmc_ring(const mpmc_ring &) = delete;
+
+
+  /// Destroy the elements still in the ring, once nobody uses it
+  ~mpmc_ring() {
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      for (auto r = read_index.load(); r != write_index.load(); ++r)
+        std::destroy_at(at(r).get());
+  }
+
+
+  /// Return the maximum number of elements that can fit in the ring
+  std::size_t capacity() const {
+    return max_size;
+  }
+
+
+  /** Try to construct a value from \p args
+
+      \return true on success, false if the ring is full, in which
+      case \p args are left untouched
+  */
+  template <typename... Args>
+  bool emplace(Args &&...args) {
+    auto w = write_index.load(std::memory_order_relaxed);
+    for (;;) {
+      auto &s = at(w);
+      auto l = lag(s.sequence.load(std::memory_order_acquire), w);
+      if (l == 0) {
+        // The slot is free for this index, so try to claim it
+        if (write_index.compare_exchange_weak(w, w + 1,
+                                              std::memory_order_relaxed))
+          break;
+      }
+      else if (l < 0)
+        // The consumer of the previous turn has not read the slot yet
+        return false;
+      else
+        // Another producer has claimed this index
+        w = write_index.load(std::memory_order_relaxed);
+    }
+    auto &s = at(w);
+    std::construct_at(s.get(), std::forward<Args>(args)...);
+    // Publish the element to the consumer of this index
+    s.sequence.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+
+  /** Try to read a value
+
+      \return true on success, false if the ring is empty
+  */
+  bool pop(T &value) {
+    auto r = read_index.load(std::memory_order_relaxed);
+    for (;;) {
+      auto &s = at(r);
+      auto l = lag(s.sequence.load(std::memory_order_acquire), r + 1);
+      if (l == 0) {
+        if (read_index.compare_exchange_weak(r, r + 1,
+                                             std::memory_order_relaxed))
+          break;
+      }
+      else if (l < 0)
+        // The producer of this index has not written the slot yet
+        return false;
+      else
+        // Another consumer has claimed this index
+        r = read_index.load(std::memory_order_relaxed);
+    }
+    auto &s = at(r);
+    value = std::move(*s.get());
+    std::destroy_at(s.get());
+    // Give the slot to the producer of the next turn
+    s.sequence.store(r + max_size, std::memory_order_release);
+    return true;
+  }
+
+
+  /** Try to write the \p n values starting at \p first
+
+      Each value is claimed on its own, so the values may be
+      interleaved with the ones of the other producers.
+
+      \return the number of values written, less than \p n when the
+      ring gets full
+  */
+  template <typename InputIterator>
+  std::size_t push(InputIterator first, std::size_t n) {
+    std::size_t done = 0;
+    while (done != n && emplace(*first)) {
+      ++first;
+      ++done;
+    }
+    return done;
+  }
+
+
+  /** Try to read up to \p n values to \p first
+
+      \return the number of values read, less than \p n when the ring
+      gets empty
+  */
+  template <typename OutputIterator>
+  std::size_t pop(OutputIterator first, std::size_t n) {
+    std::size_t done = 0;
+    while (done != n && pop(*first)) {
+      ++first;
+      ++done;
+    }
+    return done;
+  }
+
+
+  /** Get the current number of elements in the ring, including the
+      ones being written or read
+
+      This is obviously a volatile value when the ring is used.
+  */
+  std::size_t size() const {
+    // Read first the index running behind the other one
+    auto r = read_index.load(std::memory_order_acquire);
+    auto w = write_index.load(std::memory_order_acquire);
+    // Some elements may have been read and written in between
+    return std::min(w - r, max_size);
+  }
+
+
+  /// Test if the ring is empty
+  bool empty() const {
+    return size() == 0;
+  }
+
+
+  /// Test if the ring is full
+  bool full() const {
+    return size() == capacity();
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_MPMC_RING_HPP
@@ -12,10 +12,20 @@
     License. See LICENSE.TXT for details.
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <mutex>
 #include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 #ifdef TRISYCL_MAKE_BOOST_CIRCULARBUFFER_THREAD_SAFE
 /* The debug mode of boost/circular_buffer.hpp has a nasty side effect
@@ -30,6 +40,11 @@
 #endif
 #include <boost/circular_buffer.hpp>
 
+#include "triSYCL/detail/task_executor.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/mpmc_ring.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/pipe_telemetry.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/spsc_ring.hpp"
+
 namespace trisycl::detail::sycl_2_2 {
 
 /** \addtogroup old_data Data access and storage in old version of SYCL
@@ -62,10 +77,29 @@ struct reserve_id {
 };
 
 
+/** Tag to create a pipe written and read by several kernels at the
+    same time
+*/
+struct mpmc_t {
+  explicit mpmc_t() = default;
+};
+
+
 /** Implement a pipe object
 
     Use some mutable members so that the pipe object can be changed even
     when the accessors are captured in a lambda.
+
+    Since a pipe has at most one reader accessor and one writer
+    accessor, the elements go through a lock-free ring between the
+    reader and the writer. The reservations need the more general
+    circular buffer protected by a mutex, so the pipe switches to this
+    locked path when the first reservation is made and stays there.
+
+    A pipe created with mpmc_t can have several reader and writer
+    accessors at the same time, so its elements go through a lock-free
+    ring with multiple producers and consumers instead, and it cannot
+    use reservations.
 */
 template <typename T>
 class pipe : public detail::debug<pipe<T>> {
@@ -86,7 +120,7 @@ private:
 
       In case the object is capture in a lambda per copy, make it
       mutable. */
-  mutable std::mutex cb_mutex;
+  mutable detail::task_mutex cb_mutex;
 
   /// The queue of pending write reservations
   std::deque<reserve_id<value_type>> w_rid_q;
@@ -107,31 +141,150 @@ private:
   std::size_t read_reserved_frozen;
 
   /// To signal that a read has been successful
-  std::condition_variable read_done;
+  detail::task_condition_variable read_done;
 
   /// To signal that a write has been successful
-  std::condition_variable write_done;
+  detail::task_condition_variable write_done;
 
   /// To control the debug mode, disabled by default
   bool debug_mode = false;
 
+  /// The elements of the pipe as long as there is no reservation
+  spsc_ring<value_type> ring;
+
+  /// The elements of a pipe with several readers and writers, if any
+  std::unique_ptr<mpmc_ring<value_type>> shared_ring;
+
+  /// Some optional instrumentation, empty by default
+  [[no_unique_address]] pipe_telemetry telemetry;
+
+  /// True when the elements are in cb, accessed with cb_mutex
+  alignas(64) std::atomic<bool> locked_path = false;
+
+  /** True while a work-item writes to the ring
+
+      A kernel usually writes from a single work-item but nothing
+      prevents several ones, so they are serialized without
+      contention in the usual case.
+  */
+  alignas(64) std::atomic<bool> writer_busy = false;
+
+  /// The number of readers waiting for an element in the ring
+  std::atomic<std::size_t> readers_waiting = 0;
+
+  /// True while a work-item reads from the ring
+  alignas(64) std::atomic<bool> reader_busy = false;
+
+  /// The number of writers waiting for some room in the ring
+  std::atomic<std::size_t> writers_waiting = 0;
+
+  /** The number of times a blocking access tests the ring before
+      parking
+
+      There is no point spinning if there is no other core to make
+      the pipe progress meanwhile.
+  */
+  std::size_t spin_budget =
+    std::thread::hardware_concurrency() > 1 ? default_spin_budget : 0;
+
+  /** True when the other side of the ring is in another process,
+      which cannot notify the condition variables of this one
+  */
+  bool interprocess = false;
+
+  /// How long a blocking access on an inter-process pipe sleeps between tests
+  static constexpr auto interprocess_poll_period =
+    std::chrono::microseconds { 50 };
+
 public:
 
+  /// The spin budget of a new pipe on a multicore machine
+  static constexpr std::size_t default_spin_budget = 2000;
+
   /// True when the pipe is currently used for reading
   bool used_for_reading = false;
 
   /// True when the pipe is currently used for writing
   bool used_for_writing = false;
 
-  /// Create a pipe as a circular buffer of the required capacity
-  pipe(std::size_t capacity) : cb { capacity }, read_reserved_frozen { 0 } { }
+  /** Create a pipe of the required capacity
+
+      The circular buffer is only allocated with the first
+      reservation.
+  */
+  pipe(std::size_t capacity)
+    : read_reserved_frozen { 0 }
+    , ring { capacity } { }
+
+
+  /** Create a pipe of the required capacity, with the lock-free ring
+      in some external \p storage of
+      spsc_ring<T>::slots_for(capacity) slots outliving the pipe
+  */
+  pipe(std::size_t capacity, typename spsc_ring<value_type>::slot *storage)
+    : read_reserved_frozen { 0 }
+    , ring { capacity, storage } { }
+
+
+  /** Create a pipe of the required capacity with the lock-free ring
+      in some \p storage and \p indices shared with another process,
+      which runs the other side of the pipe
+
+      Since the elements stay in the shared memory, such a pipe cannot
+      use reservations.
+  */
+  pipe(std::size_t capacity,
+       typename spsc_ring<value_type>::slot *storage,
+       typename spsc_ring<value_type>::indices &indices)
+    : read_reserved_frozen { 0 }
+    , ring { capacity, storage, indices }
+    , interprocess { true } { }
+
+
+  /** Create a pipe of the required capacity which can be used by
+      several reader and writer accessors at the same time
+
+      The spsc_ring is left without storage.
+  */
+  pipe(std::size_t capacity, mpmc_t)
+    : read_reserved_frozen { 0 }
+    , ring { capacity, nullptr }
+    , shared_ring { new mpmc_ring<value_type> { capacity } } { }
+
+
+  /// Test whether the pipe can have several readers and writers
+  bool is_mpmc() const {
+    return static_cast<bool>(shared_ring);
+  }
+
+
+  /** Set the number of times a blocking access spins on the pipe
+      before parking, 0 to park right away
+  */
+  void set_spin_budget(std::size_t budget) {
+    spin_budget = budget;
+  }
+
+
+#ifdef TRISYCL_PIPE_TELEMETRY
+  /// Get the statistics about the use of the pipe so far
+  pipe_statistics get_statistics() const {
+    return telemetry.get_statistics();
+  }
+#endif
+
+
+  /// Display the statistics of the pipe, if enabled
+  ~pipe() {
+    telemetry.dump(this, capacity());
+  }
 
 
   /** Return the maximum number of elements that can fit in the pipe
    */
   std::size_t capacity() const {
     // No lock required since it is fixed and set at construction time
-    return cb.capacity();
+    return ring.capacity();
   }
 
 private:
@@ -185,54 +338,374 @@ private:
   }
 
 
+  /** Report the failure of a non-blocking operation
+
+      Since the kernels typically retry in a loop, yield the task to
+      let another one make the pipe progress, which matters when the
+      tasks are fibers sharing a thread
+
+      \return false
+  */
+  bool try_again_later(std::unique_lock<detail::task_mutex> &ul) {
+    ul.unlock();
+    detail::yield_task();
+    return false;
+  }
+
+
+  /// Get the number of elements in the lock-free ring in use
+  std::size_t ring_size() const {
+    return shared_ring ? shared_ring->size() : ring.size();
+  }
+
+
+  /// Test if the lock-free ring in use is empty
+  bool ring_empty() const {
+    return shared_ring ? shared_ring->empty() : ring.empty();
+  }
+
+
+  /// Test if the lock-free ring in use is full
+  bool ring_full() const {
+    return shared_ring ? shared_ring->full() : ring.full();
+  }
+
+
+  /// Own a side of the ring for a lock-free access
+  class side_lock {
+    std::atomic<bool> &busy;
+
+  public:
+
+    side_lock(std::atomic<bool> &busy) : busy { busy } {
+      while (busy.exchange(true))
+        ;
+    }
+
+    ~side_lock() { busy.store(false, std::memory_order_release); }
+  };
+
+
+  /** Wait on the condition variable \p cv for \p ready to be true or
+      for the pipe to switch to the locked path, after spinning a
+      while
+
+      \p waiting counts the waiters so the other side only takes the
+      lock to notify them when there are some.
+  */
+  template <typename Predicate>
+  void wait_lock_free(std::atomic<std::size_t> &waiting,
+                      detail::task_condition_variable &cv,
+                      Predicate ready) {
+    // The other side is likely to make some progress soon
+    if (detail::spin_wait(spin_budget, [&] {
+          return locked_path.load(std::memory_order_relaxed) || ready(); }))
+      return;
+    if (interprocess) {
+      // Nobody here to notify the progress of the other process
+      detail::worker_pool::blocked_scope b;
+      while (!ready()) {
+        detail::yield_task();
+        std::this_thread::sleep_for(interprocess_poll_period);
+      }
+      return;
+    }
+    waiting.fetch_add(1);
+    // Be seen as waiting before testing the ring
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+      detail::worker_pool::blocked_scope b;
+      std::unique_lock<detail::task_mutex> ul { cb_mutex };
+      cv.wait(ul, [&] { return locked_path || ready(); });
+    }
+    waiting.fetch_sub(1);
+  }
+
+
+  /// Wake up the \p waiting clients of \p cv, if any
+  void wake_up_lock_free(std::atomic<std::size_t> &waiting,
+                         detail::task_condition_variable &cv) {
+    // Test the waiters only after the ring update is visible
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_relaxed)) {
+      /* Take the lock so the notification cannot happen between the
+         test of the ring by the waiter and its sleep */
+      { std::lock_guard<detail::task_mutex> lg { cb_mutex }; }
+      cv.notify_all();
+    }
+  }
+
+
+  /** Wait under the lock \p ul for the pipe to be \p ready for a
+      write, if \p blocking
+
+      \return false if the pipe is not ready and the write is not
+      blocking
+  */
+  template <typename Predicate>
+  bool wait_to_write(std::unique_lock<detail::task_mutex> &ul,
+                     bool blocking,
+                     Predicate ready) {
+    if (ready())
+      return true;
+    telemetry.write_stalled();
+    if (!blocking)
+      return try_again_later(ul);
+    [[maybe_unused]] auto stall = telemetry.write_wait();
+    detail::worker_pool::blocked_scope b;
+    // Wait for a read to change the condition
+    read_done.wait(ul, ready);
+    return true;
+  }
+
+
+  /** Wait under the lock \p ul for the pipe to be \p ready for a
+      read, if \p blocking
+
+      \return false if the pipe is not ready and the read is not
+      blocking
+  */
+  template <typename Predicate>
+  bool wait_to_read(std::unique_lock<detail::task_mutex> &ul,
+                    bool blocking,
+                    Predicate ready) {
+    if (ready())
+      return true;
+    telemetry.read_stalled();
+    if (!blocking)
+      return try_again_later(ul);
+    [[maybe_unused]] auto stall = telemetry.read_wait();
+    detail::worker_pool::blocked_scope b;
+    // Wait for a write to change the condition
+    write_done.wait(ul, ready);
+    return true;
+  }
+
+
+  /** Try to construct a value in the ring
+
+      \return the success of the write, or nothing if the pipe uses
+      the locked path
+  */
+  template <typename... Args>
+  std::optional<bool> emplace_lock_free(bool blocking, Args &&...args) {
+    for (;;) {
+      // The writers of this ring do not need to take turns
+      if (shared_ring) {
+        if (shared_ring->emplace(std::forward<Args>(args)...))
+          break;
+      }
+      else {
+        side_lock sl { writer_busy };
+        if (locked_path)
+          return std::nullopt;
+        // Only consumes the arguments on success
+        if (ring.emplace(std::forward<Args>(args)...))
+          break;
+      }
+      telemetry.write_stalled();
+      if (!blocking) {
+        detail::yield_task();
+        return false;
+      }
+      [[maybe_unused]] auto stall = telemetry.write_wait();
+      wait_lock_free(writers_waiting, read_done, [&] { return !ring_full(); });
+    }
+    telemetry.wrote(1, capacity(), [&] { return ring_size(); });
+    // Notify the clients waiting to read something from the pipe
+    wake_up_lock_free(readers_waiting, write_done);
+    return true;
+  }
+
+
+  /** Try to read a value from the ring
+
+      \return the success of the read, or nothing if the pipe uses
+      the locked path
+  */
+  std::optional<bool> read_lock_free(T &value, bool blocking) {
+    for (;;) {
+      if (shared_ring) {
+        if (shared_ring->pop(value))
+          break;
+      }
+      else {
+        side_lock sl { reader_busy };
+        if (locked_path)
+          return std::nullopt;
+        if (ring.pop(value))
+          break;
+      }
+      telemetry.read_stalled();
+      if (!blocking) {
+        detail::yield_task();
+        return false;
+      }
+      [[maybe_unused]] auto stall = telemetry.read_wait();
+      wait_lock_free(readers_waiting, write_done, [&] { return !ring_empty(); });
+    }
+    telemetry.read(1);
+    // Notify the clients waiting for some room to write in the pipe
+    wake_up_lock_free(writers_waiting, read_done);
+    return true;
+  }
+
+
+  /** Try to write some values to the ring
+
+      \return the number of values written, or nothing if the pipe
+      uses the locked path
+  */
+  std::optional<std::size_t> write_lock_free(std::span<const T> values,
+                                             bool blocking) {
+    std::size_t n;
+    for (;;) {
+      if (shared_ring) {
+        if ((n = shared_ring->push(values.begin(), values.size())))
+          break;
+      }
+      else {
+        side_lock sl { writer_busy };
+        if (locked_path)
+          return std::nullopt;
+        if ((n = ring.push(values.begin(), values.size())))
+          break;
+      }
+      telemetry.write_stalled();
+      if (!blocking) {
+        detail::yield_task();
+        return 0;
+      }
+      [[maybe_unused]] auto stall = telemetry.write_wait();
+      wait_lock_free(writers_waiting, read_done, [&] { return !ring_full(); });
+    }
+    telemetry.wrote(n, capacity(), [&] { return ring_size(); });
+    // A single notification for all the values
+    wake_up_lock_free(readers_waiting, write_done);
+    return n;
+  }
+
+
+  /** Try to read some values from the ring
+
+      \return the number of values read, or nothing if the pipe uses
+      the locked path
+  */
+  std::optional<std::size_t> read_lock_free(std::span<T> values,
+                                            bool blocking) {
+    std::size_t n;
+    for (;;) {
+      if (shared_ring) {
+        if ((n = shared_ring->pop(values.begin(), values.size())))
+          break;
+      }
+      else {
+        side_lock sl { reader_busy };
+        if (locked_path)
+          return std::nullopt;
+        if ((n = ring.pop(values.begin(), values.size())))
+          break;
+      }
+      telemetry.read_stalled();
+      if (!blocking) {
+        detail::yield_task();
+        return 0;
+      }
+      [[maybe_unused]] auto stall = telemetry.read_wait();
+      wait_lock_free(readers_waiting, write_done, [&] { return !ring_empty(); });
+    }
+    telemetry.read(n);
+    // A single notification for all the values
+    wake_up_lock_free(writers_waiting, read_done);
+    return n;
+  }
+
+
+  /** Switch to the locked path for good, moving the elements of the
+      ring to the circular buffer
+
+      This function assumes that the data structure is locked
+  */
+  void use_locked_path() {
+    if (locked_path)
+      return;
+    if (interprocess)
+      throw std::logic_error {
+        "An inter-process pipe cannot be used with reservations." };
+    if (shared_ring)
+      throw std::logic_error {
+        "A pipe with several readers and writers cannot be used with "
+        "reservations." };
+    locked_path = true;
+    cb.set_capacity(capacity());
+    {
+      // Wait for the lock-free accesses in flight
+      side_lock w { writer_busy };
+      side_lock r { reader_busy };
+      value_type value;
+      while (ring.pop(value))
+        cb.push_back(std::move(value));
+    }
+    // The lock-free waiters have to retry on the locked path
+    read_done.notify_all();
+    write_done.notify_all();
+  }
+
+
 public:
 
   /// The size() method used outside needs to lock the datastructure
   std::size_t size_with_lock() const {
-    std::lock_guard<std::mutex> lg { cb_mutex };
-    return size();
+    std::lock_guard<detail::task_mutex> lg { cb_mutex };
+    // Only one of them is used at a time
+    return size() + ring_size();
   }
 
 
   /// The empty() method used outside needs to lock the datastructure
   bool empty_with_lock() const {
-    std::lock_guard<std::mutex> lg { cb_mutex };
-    return empty();
+    std::lock_guard<detail::task_mutex> lg { cb_mutex };
+    return empty() && ring_empty();
   }
 
 
   // The full() method used outside needs to lock the datastructure
   bool full_with_lock() const {
-    std::lock_guard<std::mutex> lg { cb_mutex };
-    return full();
+    std::lock_guard<detail::task_mutex> lg { cb_mutex };
+    return locked_path ? full() : ring_full();
   }
 
 
-  /** Try to write a value to the pipe
-
-      \param[in] value is what we want to write
+  /** Try to construct a value in the pipe from some arguments
 
       \param[in] blocking specify if the call wait for the operation
       to succeed
 
-      \return true on success
+      \param[in] args are forwarded to the constructor of the value,
+      and left untouched on failure
 
-      \todo provide a && version
+      \return true on success
   */
-  bool write(const T &value, bool blocking = false) {
+  template <typename... Args>
+  bool emplace(bool blocking, Args &&...args) {
+    if (auto done = emplace_lock_free(blocking, std::forward<Args>(args)...))
+      return *done;
     // Lock the pipe to avoid being disturbed
-    std::unique_lock<std::mutex> ul { cb_mutex };
-    TRISYCL_DUMP_T("Write pipe full = " << full()
-                   << " value = " << value);
-
-    if (blocking)
-      /* If in blocking mode, wait for the not full condition, that
-         may be changed when a read is done */
-      read_done.wait(ul, [&] { return !full(); });
-    else if (full())
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
+    TRISYCL_DUMP_T("Write pipe full = " << full());
+
+    /* If in blocking mode, wait for the not full condition, that
+       may be changed when a read is done */
+    if (!wait_to_write(ul, blocking, [&] { return !full(); }))
       return false;
 
-    cb.push_back(value);
+    // The circular buffer has no emplace, so at least avoid a copy
+    if constexpr (sizeof...(Args) == 1
+                  && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...))
+      cb.push_back(std::forward<Args>(args)...);
+    else
+      cb.push_back(T(std::forward<Args>(args)...));
+    telemetry.wrote(1, capacity(), [&] { return cb.size(); });
     TRISYCL_DUMP_T("Write pipe front = " << cb.front()
                    << " back = " << cb.back()
                    << " cb.begin() = " << (void *)&*cb.begin()
@@ -249,6 +722,35 @@ public:
   }
 
 
+  /** Try to write a value to the pipe
+
+      \param[in] value is what we want to write
+
+      \param[in] blocking specify if the call wait for the operation
+      to succeed
+
+      \return true on success
+  */
+  bool write(const T &value, bool blocking = false) {
+    return emplace(blocking, value);
+  }
+
+
+  /** Try to move a value to the pipe
+
+      \param[in] value is what we want to write, only moved from on
+      success
+
+      \param[in] blocking specify if the call wait for the operation
+      to succeed
+
+      \return true on success
+  */
+  bool write(T &&value, bool blocking = false) {
+    return emplace(blocking, std::move(value));
+  }
+
+
   /** Try to read a value from the pipe
 
       \param[out] value is the reference to where to store what is
@@ -260,15 +762,15 @@ public:
       \return true on success
   */
   bool read(T &value, bool blocking = false) {
+    if (auto done = read_lock_free(value, blocking))
+      return *done;
     // Lock the pipe to avoid being disturbed
-    std::unique_lock<std::mutex> ul { cb_mutex };
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
     TRISYCL_DUMP_T("Read pipe empty = " << empty());
 
-    if (blocking)
-      /* If in blocking mode, wait for the not empty condition, that
-         may be changed when a write is done */
-      write_done.wait(ul, [&] { return !empty(); });
-    else if (empty())
+    /* If in blocking mode, wait for the not empty condition, that
+       may be changed when a write is done */
+    if (!wait_to_read(ul, blocking, [&] { return !empty(); }))
       return false;
 
     TRISYCL_DUMP_T("Read pipe front = " << cb.front()
@@ -277,14 +779,15 @@ public:
     if (read_reserved_frozen)
       /** If there is a pending reservation, read the next element to
           be read and update the number of reserved elements */
-      value = cb.begin()[read_reserved_frozen++];
+      value = std::move(cb.begin()[read_reserved_frozen++]);
     else {
       /* There is no pending read reservation, so pop the read value
          from the pipe */
-      value = cb.front();
+      value = std::move(cb.front());
       cb.pop_front();
     }
 
+    telemetry.read(1);
     TRISYCL_DUMP_T("Read pipe value = " << value);
     // Micro-optimization: unlock before the notification
     // https://en.cppreference.com/w/cpp/thread/condition_variable/notify_all
@@ -295,6 +798,80 @@ public:
   }
 
 
+  /** Try to write some contiguous values to the pipe with a single
+      synchronization
+
+      \param[in] values are what we want to write
+
+      \param[in] blocking specify if the call wait for at least one
+      value to be written
+
+      \return the number of values written, which is less than the
+      number of values when the pipe gets full, even when blocking
+  */
+  std::size_t write(std::span<const T> values, bool blocking = false) {
+    if (values.empty())
+      // Nothing to wait for
+      return 0;
+    if (auto done = write_lock_free(values, blocking))
+      return *done;
+    // Lock the pipe to avoid being disturbed
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
+    if (!wait_to_write(ul, blocking, [&] { return !full(); }))
+      return 0;
+
+    auto n = std::min(values.size(), cb.capacity() - cb.size());
+    cb.insert(cb.end(), values.begin(), values.begin() + n);
+    telemetry.wrote(n, capacity(), [&] { return cb.size(); });
+    ul.unlock();
+    // A single notification for all the values
+    write_done.notify_all();
+    return n;
+  }
+
+
+  /** Try to read some contiguous values from the pipe with a single
+      synchronization
+
+      \param[out] values is where to store what is read
+
+      \param[in] blocking specify if the call wait for at least one
+      value to be read
+
+      \return the number of values read, which is less than the
+      number of values when the pipe gets empty, even when blocking
+  */
+  std::size_t read(std::span<T> values, bool blocking = false) {
+    if (values.empty())
+      // Nothing to wait for
+      return 0;
+    if (auto done = read_lock_free(values, blocking))
+      return *done;
+    // Lock the pipe to avoid being disturbed
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
+    if (!wait_to_read(ul, blocking, [&] { return !empty(); }))
+      return 0;
+
+    auto n = std::min(values.size(), size());
+    telemetry.read(n);
+    if (read_reserved_frozen) {
+      /* If there is a pending reservation, read the next elements to
+         be read and update the number of reserved elements */
+      std::move(cb.begin() + read_reserved_frozen,
+                cb.begin() + read_reserved_frozen + n, values.begin());
+      read_reserved_frozen += n;
+    }
+    else {
+      std::move(cb.begin(), cb.begin() + n, values.begin());
+      cb.erase_begin(n);
+    }
+    ul.unlock();
+    // A single notification for all the values
+    read_done.notify_all();
+    return n;
+  }
+
+
   /** Compute the amount of elements blocked by read reservations, not yet
       committed
 
@@ -343,7 +920,9 @@ public:
                     rid_iterator &rid,
                     bool blocking = false)  {
     // Lock the pipe to avoid being disturbed
-    std::unique_lock<std::mutex> ul { cb_mutex };
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
+    // The reservations point into the circular buffer
+    use_locked_path();
 
     TRISYCL_DUMP_T("Before read reservation cb.size() = " << cb.size()
                    << " size() = " << size());
@@ -351,14 +930,12 @@ public:
       // Empty reservation requested, so nothing to do
       return false;
 
-    if (blocking)
-      /* If in blocking mode, wait for enough elements to read in the
-         pipe for the reservation. This condition can change when a
-         write is done */
-      write_done.wait(ul, [&] { return s <= size(); });
-    else if (s > size())
-      // Not enough elements to read in the pipe for the reservation
+    /* If in blocking mode, wait for enough elements to read in the
+       pipe for the reservation. This condition can change when a
+       write is done */
+    if (!wait_to_read(ul, blocking, [&] { return s <= size(); }))
       return false;
+    telemetry.read(s);
 
     // Compute the location of the first element of the reservation
     auto first = cb.begin() + read_reserved_frozen;
@@ -391,7 +968,9 @@ public:
                      rid_iterator &rid,
                      bool blocking = false)  {
     // Lock the pipe to avoid being disturbed
-    std::unique_lock<std::mutex> ul { cb_mutex };
+    std::unique_lock<detail::task_mutex> ul { cb_mutex };
+    // The reservations point into the circular buffer
+    use_locked_path();
 
     TRISYCL_DUMP_T("Before write reservation cb.size() = " << cb.size()
                    << " size() = " << size());
@@ -399,13 +978,11 @@ public:
       // Empty reservation requested, so nothing to do
       return false;
 
-    if (blocking)
-      /* If in blocking mode, wait for enough room in the pipe, that
-         may be changed when a read is done. Do not use a difference
-         here because it is only about unsigned values */
-      read_done.wait(ul, [&] { return cb.size() + s <= capacity(); });
-    else if (cb.size() + s > capacity())
-      // Not enough room in the pipe for the reservation
+    /* If in blocking mode, wait for enough room in the pipe, that
+       may be changed when a read is done. Do not use a difference
+       here because it is only about unsigned values */
+    if (!wait_to_write(ul, blocking,
+                       [&] { return cb.size() + s <= capacity(); }))
       return false;
 
     /* If there is enough room in the pipe, just create default values
@@ -418,6 +995,7 @@ public:
     /* Add a description of the reservation at the end of the
        reservation queue */
     w_rid_q.emplace_back(first, s);
+    telemetry.wrote(s, capacity(), [&] { return cb.size(); });
     // Return the iterator to the last reservation descriptor
     rid = w_rid_q.end() - 1;
     TRISYCL_DUMP_T("After reservation cb.size() = " << cb.size()
@@ -430,37 +1008,33 @@ public:
       reservation queue
   */
   void move_read_reservation_forward() {
-    // Lock the pipe to avoid nuisance
-    std::unique_lock<std::mutex> lock { cb_mutex };
-
-    for (;;) {
-      if (r_rid_q.empty())
-        // No pending reservation, so nothing to do
-        break;
-      if (!r_rid_q.front().ready)
-        /* If the first reservation is not ready to be released, stop
-           because it is blocking all the following in the queue
-           anyway */
-        break;
-      // Remove the reservation to be released from the queue
-      r_rid_q.pop_front();
+    {
+      // Lock the pipe to avoid nuisance
+      std::lock_guard<detail::task_mutex> lg { cb_mutex };
+
+      if (r_rid_q.empty() || !r_rid_q.front().ready)
+        /* No reservation ready to be released, since the first one
+           is blocking all the following in the queue anyway */
+        return;
+      // Remove all the reservations ready to be released from the queue
+      do
+        r_rid_q.pop_front();
+      while (!r_rid_q.empty() && r_rid_q.front().ready);
       std::size_t n_to_pop;
       if (r_rid_q.empty())
         // If it was the last one, remove all the reservation
         n_to_pop = read_reserved_frozen;
       else
         // Else remove everything up to the next reservation
-        n_to_pop =  r_rid_q.front().start - cb.begin();
+        n_to_pop = r_rid_q.front().start - cb.begin();
       // No longer take into account these reserved slots
       read_reserved_frozen -= n_to_pop;
-      // Release the elements from the FIFO
-      while (n_to_pop--)
-        cb.pop_front();
-      // Notify the clients waiting for some room to write in the pipe
-      read_done.notify_all();
-      /* ...and process the next reservation to see if it is ready to
-         be released too */
+      /* Release the elements from the FIFO at once, which only moves
+         the head of the circular buffer for the scalar types */
+      cb.erase_begin(n_to_pop);
     }
+    // Notify the clients waiting for some room to write in the pipe
+    read_done.notify_all();
   }
 
 
@@ -468,27 +1042,23 @@ public:
       reservation queue
   */
   void move_write_reservation_forward() {
-    // Lock the pipe to avoid nuisance
-    std::lock_guard<std::mutex> lg { cb_mutex };
-
-    for (;;) {
-      if (w_rid_q.empty())
-        // No pending reservation, so nothing to do
-        break;
-      // Get the first reservation
-      const auto &rid = w_rid_q.front();
-      if (!rid.ready)
-        /* If the reservation is not ready to be released, stop
-           because it is blocking all the following in the queue
-           anyway */
-        break;
-      // Remove the reservation to be released from the queue
-      w_rid_q.pop_front();
-      // Notify the clients waiting to read something from the pipe
-      write_done.notify_all();
-      /* ...and process the next reservation to see if it is ready to
-         be released too */
+    {
+      // Lock the pipe to avoid nuisance
+      std::lock_guard<detail::task_mutex> lg { cb_mutex };
+
+      if (w_rid_q.empty() || !w_rid_q.front().ready)
+        /* No reservation ready to be released, since the first one
+           is blocking all the following in the queue anyway */
+        return;
+      /* Remove all the reservations ready to be released from the
+         queue, which makes their elements readable since they are
+         no longer counted by reserved_for_writing() */
+      do
+        w_rid_q.pop_front();
+      while (!w_rid_q.empty() && w_rid_q.front().ready);
     }
+    // Notify the clients waiting to read something from the pipe
+    write_done.notify_all();
   }
 
 };
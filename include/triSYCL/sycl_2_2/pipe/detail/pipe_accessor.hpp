@@ -14,7 +14,9 @@
 
 #include <cstddef>
 #include <memory>
+#include <span>
 #include <type_traits>
+#include <utility>
 
 #include "triSYCL/access.hpp"
 #include "triSYCL/detail/debug.hpp"
@@ -34,6 +36,14 @@ template <typename T,
           access::target Target>
 class accessor;
 
+/** Register the use of a pipe by a command group, for writing if \p
+    is_write
+
+    Defined in handler.hpp to avoid complicated type recursion.
+*/
+inline void add_pipe_to_task(handler &command_group_handler,
+                             const void *pipe, bool is_write);
+
 namespace sycl_2_2 {
 
 /** \addtogroup old_data Data access and storage in old version of SYCL
@@ -89,7 +99,10 @@ public:
     : implementation { p } {
     //    TRISYCL_DUMP_T("Create a kernel pipe accessor write = "
     //                 << is_write_access());
-    // Verify that the pipe is not already used in the requested mode
+    /* Verify that the pipe is not already used in the requested mode,
+       unless it accepts several readers and writers */
+    if (implementation->is_mpmc())
+      return;
     if (mode == access::mode::write)
       if (implementation->used_for_writing)
         /// \todo Use pipe_exception instead
@@ -106,11 +119,15 @@ public:
 
   /** Construct a pipe accessor from an existing pipe
 
-      For now the handler is not used.
+      The pipe is registered in the task of the command group, to
+      schedule it along with the tasks at the other end of the pipe.
   */
   pipe_accessor(const std::shared_ptr<detail::sycl_2_2::pipe<T>> &p,
                 handler &command_group_handler)
-    : pipe_accessor(p) {}
+    : pipe_accessor(p) {
+    detail::add_pipe_to_task(command_group_handler, implementation.get(),
+                             mode == access::mode::write);
+  }
 
 
   pipe_accessor() = default;
@@ -184,8 +201,6 @@ public:
       \return this so we can apply a sequence of write for example
       (but do not do this on a non blocking pipe...)
 
-      \todo provide a && version
-
       This function is const so it can work when the accessor is
       passed by copy in the [=] kernel lambda, which is not mutable by
       default
@@ -200,6 +215,58 @@ public:
   }
 
 
+  /** Try to move a value to the pipe
+
+      \param[in] value is what we want to write, only moved from on
+      success so a non-blocking write can be retried with it
+
+      \return this so we can apply a sequence of write
+  */
+  const pipe_accessor &write(value_type &&value) const {
+    static_assert(mode == access::mode::write,
+                  "'.write(value_type &&value)' method on a pipe accessor"
+                  " is only possible with write access mode");
+    ok = implementation->write(std::move(value), blocking);
+    return *this;
+  }
+
+
+  /** Try to construct a value in the pipe from some arguments
+
+      \param[in] args are forwarded to the constructor of the value
+
+      \return this so we can apply a sequence of write
+  */
+  template <typename... Args>
+  const pipe_accessor &emplace(Args &&...args) const {
+    static_assert(mode == access::mode::write,
+                  "'.emplace(Args &&...args)' method on a pipe accessor"
+                  " is only possible with write access mode");
+    ok = implementation->emplace(blocking, std::forward<Args>(args)...);
+    return *this;
+  }
+
+
+  /** Try to write some contiguous values to the pipe with a single
+      synchronization
+
+      \param[in] values are what we want to write
+
+      \return the number of values written, which may be less than
+      the number of values when the pipe gets full, even on a blocking
+      pipe. The success status of the accessor is true if some values
+      have been written
+  */
+  std::size_t write(std::span<const value_type> values) const {
+    static_assert(mode == access::mode::write,
+                  "'.write(std::span<const value_type> values)' method on a"
+                  " pipe accessor is only possible with write access mode");
+    auto n = implementation->write(values, blocking);
+    ok = n != 0;
+    return n;
+  }
+
+
   /** Some syntactic sugar to use \code a << v \endcode instead of
       \code a.write(v) \endcode */
   const pipe_accessor &operator<<(const value_type &value) const {
@@ -211,6 +278,15 @@ public:
   }
 
 
+  /// Some syntactic sugar to use \code a << std::move(v) \endcode
+  const pipe_accessor &operator<<(value_type &&value) const {
+    static_assert(mode == access::mode::write,
+                  "'<<' operator on a pipe accessor is only possible"
+                  " with write access mode");
+    return write(std::move(value));
+  }
+
+
   /** Try to read a value from the pipe
 
       \param[out] value is the reference to where to store what is
@@ -233,6 +309,26 @@ public:
   }
 
 
+  /** Try to read some contiguous values from the pipe with a single
+      synchronization
+
+      \param[out] values is where to store what is read
+
+      \return the number of values read, which may be less than the
+      number of values when the pipe gets empty, even on a blocking
+      pipe. The success status of the accessor is true if some values
+      have been read
+  */
+  std::size_t read(std::span<value_type> values) const {
+    static_assert(mode == access::mode::read,
+                  "'.read(std::span<value_type> values)' method on a pipe"
+                  " accessor is only possible with read access mode");
+    auto n = implementation->read(values, blocking);
+    ok = n != 0;
+    return n;
+  }
+
+
   /** Read a value from a blocking pipe
 
       \return the read value directly, since it cannot fail on
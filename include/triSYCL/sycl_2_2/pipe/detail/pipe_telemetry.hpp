@@ -0,0 +1,234 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_PIPE_TELEMETRY_HPP
+#define TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_PIPE_TELEMETRY_HPP
+
+/** \file Some optional instrumentation of the pipes
+
+    Define the \c TRISYCL_PIPE_TELEMETRY macro to count the elements
+    going through each pipe, the time its producers and consumers are
+    blocked and a sampled histogram of its occupancy, to find the
+    bottleneck of a pipeline of kernels. Otherwise all this compiles
+    to nothing.
+
+    The statistics can be queried with \c get_statistics() on a pipe
+    and are displayed on \c std::clog when a pipe used by some kernels
+    is destroyed, which is at the program exit for a static_pipe:
+    \code
+    cl::sycl::sycl_2_2::pipe<int> p { 16 };
+    // ...
+    auto s = p.get_statistics();
+    std::cout << s.write_stall_time.count() << " ns blocked on full pipe"
+              << std::endl;
+    \endcode
+
+    This is a proposal for the now abandoned SYCL 2.2 provisional specification.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef TRISYCL_PIPE_TELEMETRY
+#include <atomic>
+#include <iostream>
+#endif
+
+namespace trisycl::detail::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/// Some statistics about the use of a pipe
+struct pipe_statistics {
+  /// The number of occupancy buckets, the last one for a full pipe
+  static constexpr std::size_t buckets = 9;
+
+  /// Number of elements written
+  std::uint64_t written;
+
+  /// Number of elements read
+  std::uint64_t read;
+
+  /// Number of writes finding the pipe full
+  std::uint64_t write_stalls;
+
+  /// Number of reads finding the pipe empty
+  std::uint64_t read_stalls;
+
+  /// Time spent by the blocking writes waiting for some room
+  std::chrono::nanoseconds write_stall_time;
+
+  /// Time spent by the blocking reads waiting for some elements
+  std::chrono::nanoseconds read_stall_time;
+
+  /** Number of samples of the occupancy, by eighth of the capacity
+
+      The occupancy is sampled once every sample_period elements written.
+  */
+  std::array<std::uint64_t, buckets> occupancy;
+};
+
+
+#ifdef TRISYCL_PIPE_TELEMETRY
+
+/// The instrumentation of a pipe
+class pipe_telemetry {
+
+public:
+
+  /// The number of elements written between 2 samples of the occupancy
+  static constexpr std::uint64_t sample_period = 64;
+
+private:
+
+  using clock = std::chrono::steady_clock;
+
+  /// The counters of a side of the pipe, on their own cache line
+  struct alignas(64) side {
+    std::atomic<std::uint64_t> transferred = 0;
+    std::atomic<std::uint64_t> stalls = 0;
+    std::atomic<std::int64_t> stall_ns = 0;
+  };
+
+  side writer;
+
+  side reader;
+
+  /// Updated by the writers only
+  alignas(64) std::array<std::atomic<std::uint64_t>,
+                         pipe_statistics::buckets> occupancy {};
+
+
+  /// Measure a blocking wait of a side for the lifetime of this object
+  class stall_timer {
+    side &s;
+    clock::time_point start = clock::now();
+
+  public:
+
+    stall_timer(side &s) : s { s } {}
+
+    ~stall_timer() {
+      s.stall_ns.fetch_add((clock::now() - start)
+                           / std::chrono::nanoseconds { 1 },
+                           std::memory_order_relaxed);
+    }
+  };
+
+public:
+
+  /** Count \p n elements written
+
+      \param[in] size gives the current number of elements in the
+      pipe of capacity \p capacity, only called when sampling
+  */
+  template <typename Size>
+  void wrote(std::size_t n, std::size_t capacity, Size size) {
+    auto before = writer.transferred.fetch_add(n, std::memory_order_relaxed);
+    // Sample when crossing a multiple of the period
+    if (before/sample_period != (before + n)/sample_period) {
+      auto b = capacity ? size()*(pipe_statistics::buckets - 1)/capacity
+                        : pipe_statistics::buckets - 1;
+      occupancy[b].fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+
+  /// Count \p n elements read
+  void read(std::size_t n) {
+    reader.transferred.fetch_add(n, std::memory_order_relaxed);
+  }
+
+
+  /// Count a write finding the pipe full
+  void write_stalled() {
+    writer.stalls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  /// Count a read finding the pipe empty
+  void read_stalled() {
+    reader.stalls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  /// Measure the time a blocking write waits, while the result lives
+  stall_timer write_wait() { return { writer }; }
+
+
+  /// Measure the time a blocking read waits, while the result lives
+  stall_timer read_wait() { return { reader }; }
+
+
+  /// Get the statistics so far
+  pipe_statistics get_statistics() const {
+    pipe_statistics s {
+      writer.transferred.load(std::memory_order_relaxed),
+      reader.transferred.load(std::memory_order_relaxed),
+      writer.stalls.load(std::memory_order_relaxed),
+      reader.stalls.load(std::memory_order_relaxed),
+      std::chrono::nanoseconds {
+        writer.stall_ns.load(std::memory_order_relaxed) },
+      std::chrono::nanoseconds {
+        reader.stall_ns.load(std::memory_order_relaxed) },
+      {} };
+    for (std::size_t i = 0; i != s.occupancy.size(); ++i)
+      s.occupancy[i] = occupancy[i].load(std::memory_order_relaxed);
+    return s;
+  }
+
+
+  /// Display the statistics of the pipe \p p of capacity \p capacity
+  void dump(const void *p, std::size_t capacity) const {
+    auto s = get_statistics();
+    if (s.written == 0 && s.read == 0)
+      // Not worth mentioning a pipe never used
+      return;
+    std::clog << "Pipe " << p << " of capacity " << capacity
+              << ": written " << s.written
+              << ", read " << s.read
+              << ", full " << s.write_stalls << " times, blocked "
+              << s.write_stall_time.count() << " ns"
+              << ", empty " << s.read_stalls << " times, blocked "
+              << s.read_stall_time.count() << " ns"
+              << ", occupancy by eighth:";
+    for (auto o : s.occupancy)
+      std::clog << ' ' << o;
+    std::clog << std::endl;
+  }
+
+};
+
+#else
+
+/// The instrumentation of a pipe, compiled out
+struct pipe_telemetry {
+  template <typename Size>
+  void wrote(std::size_t, std::size_t, Size) {}
+  void read(std::size_t) {}
+  void write_stalled() {}
+  void read_stalled() {}
+  int write_wait() { return 0; }
+  int read_wait() { return 0; }
+  void dump(const void *, std::size_t) const {}
+};
+
+#endif
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_PIPE_TELEMETRY_HPP
@@ -0,0 +1,295 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_SPSC_RING_HPP
+#define TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_SPSC_RING_HPP
+
+/** \file A lock-free ring buffer with a single producer and a single
+    consumer
+
+    This is a proposal for the now abandoned SYCL 2.2 provisional specification.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace trisycl::detail::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/** A ring buffer where one thread writes and one thread reads
+    concurrently without any lock
+
+    The indices of each side are on their own cache line and each side
+    keeps the copy of the index of the other side read last time, so a
+    side only reads the cache line of the other one when the ring looks
+    full or empty. The indices and the slots can be provided from
+    outside, for example in some memory shared between processes.
+
+    The indices count the elements since the creation of the ring and
+    the number of slots is a power of 2, so a slot is found by masking
+    an index and all the slots can be used.
+
+    The free slots are not initialized, so the elements are
+    constructed in place by the producer and moved out by the
+    consumer.
+*/
+template <typename T>
+class alignas(64) spsc_ring {
+
+public:
+
+  /// The storage of an element
+  struct slot {
+    alignas(T) std::byte storage[sizeof(T)];
+
+    T *get() { return reinterpret_cast<T *>(storage); }
+  };
+
+
+  /// The indices shared by the producer and the consumer
+  struct indices {
+    /// Where the producer writes the next element
+    alignas(64) std::atomic<std::size_t> write_index = 0;
+
+    /// Where the consumer reads the next element
+    alignas(64) std::atomic<std::size_t> read_index = 0;
+  };
+
+
+  /// The number of slots needed for \p capacity elements
+  static constexpr std::size_t slots_for(std::size_t capacity) {
+    return std::bit_ceil(capacity);
+  }
+
+private:
+
+  /// The maximum number of elements
+  std::size_t max_size;
+
+  /// To get the slot of an index
+  std::size_t mask;
+
+  /// The elements, if allocated by the ring
+  std::unique_ptr<slot[]> owned_storage;
+
+  /// The elements
+  slot *storage;
+
+  /// The indices, if owned by the ring
+  indices owned_indices;
+
+  /// The indices
+  indices &shared;
+
+  /// The read_index last seen by the producer
+  alignas(64) std::size_t cached_read_index = 0;
+
+  /// The write_index last seen by the consumer
+  alignas(64) std::size_t cached_write_index = 0;
+
+
+  /// The slot of \p index
+  T *at(std::size_t index) {
+    return storage[index & mask].get();
+  }
+
+public:
+
+  /// Create a ring able to keep \p capacity elements
+  spsc_ring(std::size_t capacity)
+    : max_size { capacity }
+    , mask { slots_for(capacity) - 1 }
+    , owned_storage { new slot[slots_for(capacity)] }
+    , storage { owned_storage.get() }
+    , shared { owned_indices } {}
+
+
+  /** Create a ring able to keep \p capacity elements in some
+      external \p storage of slots_for(capacity) slots, which has to
+      outlive the ring
+  */
+  spsc_ring(std::size_t capacity, slot *storage)
+    : max_size { capacity }
+    , mask { slots_for(capacity) - 1 }
+    , storage { storage }
+    , shared { owned_indices } {}
+
+
+  /** Create a ring able to keep \p capacity elements in some
+      external \p storage of slots_for(capacity) slots with some
+      external indices \p shared, which have to outlive the ring
+
+      The ring can start with some elements left by a previous user
+      of the storage and the indices.
+  */
+  spsc_ring(std::size_t capacity, slot *storage, indices &shared)
+    : max_size { capacity }
+    , mask { slots_for(capacity) - 1 }
+    , storage { storage }
+    , shared { shared } {
+    cached_read_index = shared.read_index.load(std::memory_order_acquire);
+    cached_write_index = shared.write_index.load(std::memory_order_acquire);
+  }
+
+
+  spsc_ring(const spsc_ring &) = delete;
+
+
+  /** Destroy the elements still in the ring
+
+      There is nothing to do for trivially destructible elements,
+      which may still be used by another ring with the same external
+      storage.
+  */
+  ~spsc_ring() {
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      for (auto r = shared.read_index.load();
+           r != shared.write_index.load();
+           ++r)
+        std::destroy_at(at(r));
+  }
+
+
+  /// Return the maximum number of elements that can fit in the ring
+  std::size_t capacity() const {
+    return max_size;
+  }
+
+
+  /** Try to construct a value from \p args, only from the producer
+
+      \return true on success, false if the ring is full, in which
+      case \p args are left untouched
+  */
+  template <typename... Args>
+  bool emplace(Args &&...args) {
+    auto w = shared.write_index.load(std::memory_order_relaxed);
+    if (w - cached_read_index == max_size) {
+      // Looks full, so refresh the view of the consumer
+      cached_read_index = shared.read_index.load(std::memory_order_acquire);
+      if (w - cached_read_index == max_size)
+        return false;
+    }
+    std::construct_at(at(w), std::forward<Args>(args)...);
+    // Publish the element to the consumer
+    shared.write_index.store(w + 1, std::memory_order_release);
+    return true;
+  }
+
+
+  /** Try to read a value, only from the consumer
+
+      \return true on success, false if the ring is empty
+  */
+  bool pop(T &value) {
+    auto r = shared.read_index.load(std::memory_order_relaxed);
+    if (r == cached_write_index) {
+      // Looks empty, so refresh the view of the producer
+      cached_write_index = shared.write_index.load(std::memory_order_acquire);
+      if (r == cached_write_index)
+        return false;
+    }
+    value = std::move(*at(r));
+    std::destroy_at(at(r));
+    // Give the slot back to the producer
+    shared.read_index.store(r + 1, std::memory_order_release);
+    return true;
+  }
+
+
+  /** Try to write the \p n values starting at \p first, only from
+      the producer
+
+      The values are copied in at most 2 contiguous runs and published
+      to the consumer at once.
+
+      \return the number of values written, less than \p n when the
+      ring gets full
+  */
+  template <typename InputIterator>
+  std::size_t push(InputIterator first, std::size_t n) {
+    auto w = shared.write_index.load(std::memory_order_relaxed);
+    if (max_size - (w - cached_read_index) < n)
+      // Looks too full, so refresh the view of the consumer
+      cached_read_index = shared.read_index.load(std::memory_order_acquire);
+    n = std::min(n, max_size - (w - cached_read_index));
+    // Up to the end of the storage, then from its start
+    auto run = std::min(n, mask + 1 - (w & mask));
+    std::uninitialized_copy_n(first, run, at(w));
+    std::uninitialized_copy_n(std::next(first, run), n - run, at(0));
+    shared.write_index.store(w + n, std::memory_order_release);
+    return n;
+  }
+
+
+  /** Try to read up to \p n values to \p first, only from the
+      consumer
+
+      \return the number of values read, less than \p n when the ring
+      gets empty
+  */
+  template <typename OutputIterator>
+  std::size_t pop(OutputIterator first, std::size_t n) {
+    auto r = shared.read_index.load(std::memory_order_relaxed);
+    if (cached_write_index - r < n)
+      // Looks too empty, so refresh the view of the producer
+      cached_write_index = shared.write_index.load(std::memory_order_acquire);
+    n = std::min(n, cached_write_index - r);
+    auto run = std::min(n, mask + 1 - (r & mask));
+    first = std::move(at(r), at(r) + run, first);
+    std::move(at(0), at(0) + n - run, first);
+    std::destroy_n(at(r), run);
+    std::destroy_n(at(0), n - run);
+    shared.read_index.store(r + n, std::memory_order_release);
+    return n;
+  }
+
+
+  /** Get the current number of elements in the ring
+
+      This is obviously a volatile value when the other side is
+      running.
+  */
+  std::size_t size() const {
+    // Read first the index running behind the other one
+    auto r = shared.read_index.load(std::memory_order_acquire);
+    auto w = shared.write_index.load(std::memory_order_acquire);
+    return w - r;
+  }
+
+
+  /// Test if the ring is empty
+  bool empty() const {
+    return size() == 0;
+  }
+
+
+  /// Test if the ring is full
+  bool full() const {
+    return size() == capacity();
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_PIPE_DETAIL_SPSC_RING_HPP
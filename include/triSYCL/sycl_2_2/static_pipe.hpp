@@ -20,6 +20,7 @@
 #include "triSYCL/accessor.hpp"
 #include "triSYCL/handler.hpp"
 #include "triSYCL/sycl_2_2/pipe/detail/pipe.hpp"
+#include "triSYCL/sycl_2_2/static_pipe/detail/static_pipe.hpp"
 
 namespace trisycl::sycl_2_2 {
 
@@ -47,12 +48,20 @@ namespace trisycl::sycl_2_2 {
     OpenCL program(s) with program-scoped pipes when a SYCL
     static-scoped pipe is used. These details are implementation
     defined.
+
+    On the host, the pipe implementation is kept inline with its
+    elements, so a static pipe does not use the heap, and the
+    accessors refer to it without owning it. Thus a static_pipe
+    cannot be copied and has to outlive the kernels using it, as
+    expected from a static-scoped object.
 */
 template <typename T, std::size_t Capacity>
 class static_pipe
+    // Constructed first since the implementation below points to it
+  : private detail::sycl_2_2::static_pipe_holder<T, Capacity>,
     /* Use the underlying pipe implementation that can be shared in
        the SYCL model */
-  : public detail::shared_ptr_implementation<static_pipe<T, Capacity>,
+    public detail::shared_ptr_implementation<static_pipe<T, Capacity>,
                                              detail::sycl_2_2::pipe<T>>,
     detail::debug<static_pipe<T, Capacity>> {
 
@@ -73,7 +82,13 @@ public:
 
   /// Construct a static-scoped pipe able to store up to Capacity T objects
   static_pipe()
-    : implementation_t { new detail::sycl_2_2::pipe<T> { Capacity } } { }
+    /* Alias an empty shared pointer, which neither owns the
+       implementation nor allocates a control block */
+    : implementation_t { std::shared_ptr<detail::sycl_2_2::pipe<T>> {
+        std::shared_ptr<void> {}, &this->inline_implementation } } { }
+
+
+  static_pipe(const static_pipe &) = delete;
 
 
   /** Get an accessor to the pipe with the required mode
@@ -116,6 +131,29 @@ public:
   }
 
 
+  /** Set the number of times a blocking access spins on the pipe
+      before parking its task, 0 to park right away
+
+      This is a triSYCL extension to tune the latency of a pipe
+      against the processor time spent waiting.
+  */
+  void set_spin_budget(std::size_t budget) {
+    implementation->set_spin_budget(budget);
+  }
+
+
+#ifdef TRISYCL_PIPE_TELEMETRY
+  /** Get the statistics about the use of the pipe so far
+
+      This is a triSYCL extension only available when the
+      \c TRISYCL_PIPE_TELEMETRY macro is defined.
+  */
+  auto get_statistics() const {
+    return implementation->get_statistics();
+  }
+#endif
+
+
   /** Return the maximum number of elements that can fit in the pipe
 
       This is a constexpr since the capacity is in the type.
@@ -0,0 +1,69 @@
+#ifndef TRISYCL_SYCL_SYCL_2_2_STATIC_PIPE_DETAIL_STATIC_PIPE_HPP
+#define TRISYCL_SYCL_SYCL_2_2_STATIC_PIPE_DETAIL_STATIC_PIPE_HPP
+
+/** \file The SYCL static_pipe<> details
+
+    This is a proposal for the now abandoned SYCL 2.2 provisional specification.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <array>
+#include <cstddef>
+
+#include "triSYCL/sycl_2_2/pipe/detail/pipe.hpp"
+#include "triSYCL/sycl_2_2/pipe/detail/spsc_ring.hpp"
+
+namespace trisycl::detail::sycl_2_2 {
+
+/** \addtogroup old_data Data access and storage in old version of SYCL
+    @{
+*/
+
+/// The inline storage of the elements of a static pipe
+template <typename T, std::size_t Capacity>
+struct static_pipe_slots {
+  std::array<typename spsc_ring<T>::slot,
+             spsc_ring<T>::slots_for(Capacity)> slots;
+};
+
+
+/** A pipe with a capacity known at compile time, keeping its elements
+    inline instead of on the heap
+
+    The storage is a base class so it is constructed before the pipe
+    using it.
+*/
+template <typename T, std::size_t Capacity>
+class static_pipe : private static_pipe_slots<T, Capacity>,
+                    public pipe<T> {
+
+public:
+
+  static_pipe() : pipe<T> { Capacity, this->slots.data() } {}
+
+};
+
+
+/** Hold a static pipe so it is constructed before the parts of the
+    user-facing static pipe referring to it
+*/
+template <typename T, std::size_t Capacity>
+struct static_pipe_holder {
+  static_pipe<T, Capacity> inline_implementation;
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_SYCL_2_2_STATIC_PIPE_DETAIL_STATIC_PIPE_HPP
@@ -0,0 +1,92 @@
+#ifndef TRISYCL_SYCL_TASK_GRAPH_HPP
+#define TRISYCL_SYCL_TASK_GRAPH_HPP
+
+/** \file A graph of recorded command groups
+
+    This is a triSYCL extension to pay the command group construction
+    and the dependency discovery only once for a sequence of command
+    groups submitted many times.
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <memory>
+
+#include "triSYCL/command_group/detail/task_graph.hpp"
+
+namespace trisycl {
+
+/** \addtogroup execution Platforms, contexts, devices and queues
+    @{
+*/
+
+/** An immutable graph of command groups recorded from a queue, to be
+    replayed with queue::replay()
+
+    This is a triSYCL extension.
+
+    The graph keeps the buffers it uses alive, so it has to be
+    destroyed before the buffers to avoid blocking their destructor.
+    The temporary buffers whose lifetimes do not overlap during the
+    recording share the same storage.
+*/
+class task_graph {
+
+public:
+
+  /// The recorded graph, shared by the copies of this object
+  std::shared_ptr<detail::task_graph> implementation;
+
+
+  /// An empty graph
+  task_graph() : implementation { std::make_shared<detail::task_graph>() } {}
+
+
+  /// Build a graph from a recording
+  task_graph(std::shared_ptr<detail::task_graph> g)
+    : implementation { std::move(g) } {}
+
+
+  /// Get the number of command groups with a kernel in the graph
+  std::size_t size() const {
+    return implementation->nodes.size();
+  }
+
+
+  /** Get the number of bytes of the temporary buffers of the graph
+
+      A buffer without initial data whose storage is first needed by
+      a recorded command group is a temporary of the graph. Once the
+      user no longer holds it, for example at the end of the scope
+      declaring it during the recording, its storage can be reused by
+      the temporaries of the next command groups.
+  */
+  std::size_t temporary_bytes() const {
+    return implementation->storage->requested_bytes();
+  }
+
+
+  /// Get the number of bytes of storage shared by the temporaries
+  std::size_t temporary_storage_bytes() const {
+    return implementation->storage->allocated_bytes();
+  }
+
+};
+
+/// @} End the execution Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_TASK_GRAPH_HPP
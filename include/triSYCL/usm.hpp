@@ -0,0 +1,247 @@
+#ifndef TRISYCL_SYCL_USM_HPP
+#define TRISYCL_SYCL_USM_HPP
+
+/** \file The SYCL 2020 unified shared memory
+
+    The USM allocations are plain pointers usable directly by the
+    kernels, without any buffer or accessor. Since they are not
+    tracked, the command groups using them are ordered with the events
+    returned by the submissions:
+    \code
+    auto a = malloc_shared<float>(n, q);
+    auto init = q.parallel_for(range<1> { n }, [=] (id<1> i) {
+        a[i[0]] = i[0];
+      });
+    q.parallel_for(range<1> { n }, init, [=] (id<1> i) { a[i[0]] *= 2; })
+     .wait();
+    free(a, q);
+    \endcode
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+#include "triSYCL/context.hpp"
+#include "triSYCL/device.hpp"
+#include "triSYCL/queue.hpp"
+#include "triSYCL/usm/detail/usm.hpp"
+
+namespace trisycl {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** Allocate \p num_bytes bytes of a kind of USM for a device of a
+    context
+
+    \return nullptr if the memory cannot be allocated
+*/
+inline void *malloc(std::size_t num_bytes, const device &dev,
+                    const context &ctx, usm::alloc kind) {
+  return detail::usm_allocations::instance().allocate(num_bytes, dev, ctx,
+                                                      kind);
+}
+
+
+/// Allocate \p num_bytes bytes of a kind of USM for the device of a queue
+inline void *malloc(std::size_t num_bytes, const queue &q, usm::alloc kind) {
+  return malloc(num_bytes, q.get_device(), q.get_context(), kind);
+}
+
+
+/// Allocate \p count elements of a kind of USM for a device of a context
+template <typename T>
+T *malloc(std::size_t count, const device &dev, const context &ctx,
+          usm::alloc kind) {
+  if (count > std::numeric_limits<std::size_t>::max()/sizeof(T))
+    return nullptr;
+  return static_cast<T *>(malloc(count*sizeof(T), dev, ctx, kind));
+}
+
+
+/// Allocate \p count elements of a kind of USM for the device of a queue
+template <typename T>
+T *malloc(std::size_t count, const queue &q, usm::alloc kind) {
+  return malloc<T>(count, q.get_device(), q.get_context(), kind);
+}
+
+
+/// Allocate \p num_bytes bytes of device memory
+inline void *malloc_device(std::size_t num_bytes, const device &dev,
+                           const context &ctx) {
+  return malloc(num_bytes, dev, ctx, usm::alloc::device);
+}
+
+
+/// Allocate \p num_bytes bytes of memory of the device of a queue
+inline void *malloc_device(std::size_t num_bytes, const queue &q) {
+  return malloc(num_bytes, q, usm::alloc::device);
+}
+
+
+/// Allocate \p count elements of device memory
+template <typename T>
+T *malloc_device(std::size_t count, const device &dev, const context &ctx) {
+  return malloc<T>(count, dev, ctx, usm::alloc::device);
+}
+
+
+/// Allocate \p count elements of memory of the device of a queue
+template <typename T>
+T *malloc_device(std::size_t count, const queue &q) {
+  return malloc<T>(count, q, usm::alloc::device);
+}
+
+
+/// Allocate \p num_bytes bytes of host memory accessible by the devices
+inline void *malloc_host(std::size_t num_bytes, const context &ctx) {
+  return malloc(num_bytes, device {}, ctx, usm::alloc::host);
+}
+
+
+/// Allocate \p num_bytes bytes of host memory accessible by a queue
+inline void *malloc_host(std::size_t num_bytes, const queue &q) {
+  return malloc_host(num_bytes, q.get_context());
+}
+
+
+/// Allocate \p count elements of host memory accessible by the devices
+template <typename T>
+T *malloc_host(std::size_t count, const context &ctx) {
+  return malloc<T>(count, device {}, ctx, usm::alloc::host);
+}
+
+
+/// Allocate \p count elements of host memory accessible by a queue
+template <typename T>
+T *malloc_host(std::size_t count, const queue &q) {
+  return malloc_host<T>(count, q.get_context());
+}
+
+
+/// Allocate \p num_bytes bytes of memory shared by the host and a device
+inline void *malloc_shared(std::size_t num_bytes, const device &dev,
+                           const context &ctx) {
+  return malloc(num_bytes, dev, ctx, usm::alloc::shared);
+}
+
+
+/** Allocate \p num_bytes bytes of memory shared by the host and the
+    device of a queue
+*/
+inline void *malloc_shared(std::size_t num_bytes, const queue &q) {
+  return malloc(num_bytes, q, usm::alloc::shared);
+}
+
+
+/// Allocate \p count elements of memory shared by the host and a device
+template <typename T>
+T *malloc_shared(std::size_t count, const device &dev, const context &ctx) {
+  return malloc<T>(count, dev, ctx, usm::alloc::shared);
+}
+
+
+/** Allocate \p count elements of memory shared by the host and the
+    device of a queue
+*/
+template <typename T>
+T *malloc_shared(std::size_t count, const queue &q) {
+  return malloc<T>(count, q, usm::alloc::shared);
+}
+
+
+/// Release a USM allocation of a context
+inline void free(void *ptr, const context &ctx) {
+  detail::usm_allocations::instance().deallocate(ptr);
+}
+
+
+/// Release a USM allocation of the context of a queue
+inline void free(void *ptr, const queue &q) {
+  free(ptr, q.get_context());
+}
+
+
+/** Get the kind of the USM allocation of a context containing \p ptr
+
+    \return usm::alloc::unknown if it is not such an allocation
+*/
+inline usm::alloc get_pointer_type(const void *ptr, const context &ctx) {
+  return detail::usm_allocations::instance().get_kind(ptr, ctx);
+}
+
+
+/** An allocator of USM, to use host or shared allocations in the
+    standard containers
+*/
+template <typename T, usm::alloc AllocKind>
+class usm_allocator {
+  static_assert(AllocKind != usm::alloc::device,
+                "the device allocations are not accessible by the host, "
+                "so they cannot be used by the containers");
+
+  template <typename U, usm::alloc K> friend class usm_allocator;
+
+  context ctx;
+
+  device dev;
+
+public:
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = usm_allocator<U, AllocKind>;
+  };
+
+  usm_allocator(const context &ctx, const device &dev)
+    : ctx { ctx }, dev { dev } {}
+
+  usm_allocator(const queue &q)
+    : ctx { q.get_context() }, dev { q.get_device() } {}
+
+  template <typename U>
+  usm_allocator(const usm_allocator<U, AllocKind> &other) noexcept
+    : ctx { other.ctx }, dev { other.dev } {}
+
+
+  T *allocate(std::size_t n) {
+    auto p = malloc<T>(n, dev, ctx, AllocKind);
+    if (!p)
+      throw std::bad_alloc {};
+    return p;
+  }
+
+
+  void deallocate(T *p, std::size_t) {
+    free(p, ctx);
+  }
+
+
+  template <typename U>
+  bool operator==(const usm_allocator<U, AllocKind> &other) const {
+    return ctx == other.ctx && dev == other.dev;
+  }
+};
+
+/// @} End the data Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_USM_HPP
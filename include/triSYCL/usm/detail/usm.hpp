@@ -0,0 +1,203 @@
+#ifndef TRISYCL_SYCL_USM_DETAIL_USM_HPP
+#define TRISYCL_SYCL_USM_DETAIL_USM_HPP
+
+/** \file The bookkeeping behind the unified shared memory allocations
+
+    Ronan at Keryell point FR
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <optional>
+
+#ifdef TRISYCL_OPENCL
+#include <boost/compute.hpp>
+#endif
+
+#include "triSYCL/context.hpp"
+#include "triSYCL/device.hpp"
+#include "triSYCL/exception.hpp"
+#include "triSYCL/vendor/triSYCL/buffer_pool.hpp"
+
+namespace trisycl {
+
+namespace usm {
+
+/// The kinds of unified shared memory allocations
+enum class alloc {
+  /// Host memory accessible by the devices
+  host,
+  /// Device memory not accessible by the host
+  device,
+  /// Memory accessible by the host and the device, migrated as needed
+  shared,
+  /// Not a USM allocation
+  unknown
+};
+
+}
+
+namespace detail {
+
+/** \addtogroup data Data access and storage in SYCL
+    @{
+*/
+
+/** Keep track of the USM allocations, to free them and to tell their
+    kind
+
+    On the host device all the kinds of allocation are some aligned
+    memory given by the buffer pool, so they are recycled when the
+    pool is enabled. On an OpenCL device, the device and shared
+    allocations use the shared virtual memory of OpenCL 2.0.
+*/
+class usm_allocations {
+
+  /// An allocation starting at some address
+  struct allocation {
+    std::size_t size;
+    usm::alloc kind;
+    ::trisycl::context ctx;
+    /// Whether the memory is some OpenCL shared virtual memory
+    bool svm;
+  };
+
+  /// To protect the allocations
+  mutable std::mutex m;
+
+  /// The allocations by increasing address
+  std::map<std::uintptr_t, allocation> allocations;
+
+
+  usm_allocations() = default;
+
+
+  /// Find the allocation containing the address \p p, if any
+  std::optional<allocation> find(const void *p) const {
+    auto a = reinterpret_cast<std::uintptr_t>(p);
+    std::lock_guard lg { m };
+    auto i = allocations.upper_bound(a);
+    if (i == allocations.begin())
+      return {};
+    --i;
+    if (a >= i->first + i->second.size)
+      return {};
+    return i->second;
+  }
+
+
+#ifdef TRISYCL_OPENCL
+  /// Allocate some shared virtual memory of an OpenCL device
+  static void *svm_allocate(std::size_t size, const ::trisycl::device &dev,
+                            const ::trisycl::context &ctx,
+                            usm::alloc kind) {
+#ifdef BOOST_COMPUTE_CL_VERSION_2_0
+    cl_svm_mem_flags flags = CL_MEM_READ_WRITE;
+    // Avoid the explicit migrations when the device is coherent with the host
+    if (kind == usm::alloc::shared
+        && (dev.get_boost_compute().get_info<cl_device_svm_capabilities>(
+              CL_DEVICE_SVM_CAPABILITIES) & CL_DEVICE_SVM_FINE_GRAIN_BUFFER))
+      flags |= CL_MEM_SVM_FINE_GRAIN_BUFFER;
+    return clSVMAlloc(ctx.get_boost_compute().get(), flags, size,
+                      vendor::trisycl::buffer_pool::alignment);
+#else
+    throw feature_not_supported { "The USM allocations on an OpenCL device "
+                                  "need the shared virtual memory of "
+                                  "OpenCL 2.0" };
+#endif
+  }
+#endif
+
+public:
+
+  /// Get the allocations of the whole runtime
+  static usm_allocations &instance() {
+    static usm_allocations a;
+    return a;
+  }
+
+
+  /** Allocate \p size bytes of a kind of memory for a device of a
+      context
+
+      \return nullptr if the memory cannot be allocated
+  */
+  void *allocate(std::size_t size, const ::trisycl::device &dev,
+                 const ::trisycl::context &ctx,
+                 usm::alloc kind) {
+    if (size == 0 || kind == usm::alloc::unknown)
+      return nullptr;
+    void *p = nullptr;
+    bool svm = false;
+#ifdef TRISYCL_OPENCL
+    if (!dev.is_host() && kind != usm::alloc::host) {
+      p = svm_allocate(size, dev, ctx, kind);
+      svm = true;
+    }
+    else
+#endif
+      try {
+        p = vendor::trisycl::buffer_pool::instance().allocate(size);
+      } catch (const std::bad_alloc &) {}
+    if (p) {
+      std::lock_guard lg { m };
+      allocations.insert({ reinterpret_cast<std::uintptr_t>(p),
+                           { size, kind, ctx, svm } });
+    }
+    return p;
+  }
+
+
+  /// Release the memory given by allocate()
+  void deallocate(void *p) {
+    if (!p)
+      return;
+    allocation a;
+    {
+      std::lock_guard lg { m };
+      auto i = allocations.find(reinterpret_cast<std::uintptr_t>(p));
+      if (i == allocations.end())
+        throw invalid_parameter_error { "Freeing a pointer which is not "
+                                        "a USM allocation" };
+      a = std::move(i->second);
+      allocations.erase(i);
+    }
+#if defined(TRISYCL_OPENCL) && defined(BOOST_COMPUTE_CL_VERSION_2_0)
+    if (a.svm) {
+      clSVMFree(a.ctx.get_boost_compute().get(), p);
+      return;
+    }
+#endif
+    vendor::trisycl::buffer_pool::instance().deallocate(p, a.size);
+  }
+
+
+  /// Get the kind of the allocation of context \p ctx containing \p p
+  usm::alloc get_kind(const void *p, const ::trisycl::context &ctx) const {
+    if (auto a = find(p); a && a->ctx == ctx)
+      return a->kind;
+    return usm::alloc::unknown;
+  }
+
+};
+
+/// @} End the data Doxygen group
+
+}
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_USM_DETAIL_USM_HPP
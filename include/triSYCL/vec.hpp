@@ -14,6 +14,8 @@
 #include <tuple>
 #include <utility>
 
+#include "triSYCL/bfloat16.hpp"
+#include "triSYCL/half.hpp"
 #include "triSYCL/rounding_mode.hpp"
 #include "triSYCL/detail/alignment_helper.hpp"
 #include "triSYCL/vec/detail/vec.hpp"
@@ -73,27 +75,24 @@ namespace trisycl {
     return (*this)[0x##x];                            \
   }
 
-#define TRISYCL_GEN_SWIZ2(str,idx0,idx1)              \
-  const __swizzled_vec__<DataType, 2> str() const {   \
-     return base_vec::swizzle(idx0, idx1);            \
-  }                                                   \
-  __swizzled_vec__<DataType, 2> str() {               \
-    return base_vec::swizzle(idx0, idx1);             \
+/** Define the swizzle str of the size elements of indexes given
+    after, as a copy on a const vec or as an assignable swizzle
+    writing in place otherwise
+*/
+#define TRISYCL_GEN_SWIZ(str, size, ...)                       \
+  const __swizzled_vec__<DataType, size> str() const {         \
+    return base_vec::template swizzle<__VA_ARGS__>();          \
+  }                                                            \
+                                                               \
+  detail::swizzled_vec<base_vec, __VA_ARGS__> str() {          \
+    return { *this };                                          \
   }
+#define TRISYCL_GEN_SWIZ2(str,idx0,idx1)              \
+  TRISYCL_GEN_SWIZ(str, 2, idx0, idx1)
 #define TRISYCL_GEN_SWIZ3(str,idx0,idx1,idx2)         \
-  const __swizzled_vec__<DataType, 3> str() const {   \
-    return base_vec::swizzle(idx0, idx1, idx2);       \
-  }                                                   \
-  __swizzled_vec__<DataType, 3> str() {               \
-    return base_vec::swizzle(idx0, idx1, idx2);       \
-  }
+  TRISYCL_GEN_SWIZ(str, 3, idx0, idx1, idx2)
 #define TRISYCL_GEN_SWIZ4(str,idx0,idx1,idx2,idx3)    \
-  const __swizzled_vec__<DataType, 4> str() const {   \
-    return base_vec::swizzle(idx0, idx1, idx2, idx3); \
-  }                                                   \
-  __swizzled_vec__<DataType, 4> str() {               \
-    return base_vec::swizzle(idx0, idx1, idx2, idx3); \
-  }
+  TRISYCL_GEN_SWIZ(str, 4, idx0, idx1, idx2, idx3)
 
 template<typename DataType>
 class alignas(detail::alignment_v<::trisycl::vec<DataType, 1>>)
@@ -159,37 +158,10 @@ public:
   TRISYCL_DECLARE_S(0);
   TRISYCL_DECLARE_S(1);
 
-  const __swizzled_vec__<DataType, 1> lo() const {
-    return base_vec::swizzle(elem::s0);
-  }
-
-  __swizzled_vec__<DataType, 1> lo() {
-    return base_vec::swizzle(elem::s0);
-  }
-
-  const __swizzled_vec__<DataType, 1> hi() const {
-    return base_vec::swizzle(elem::s1);
-  }
-
-  __swizzled_vec__<DataType, 1> hi() {
-    return base_vec::swizzle(elem::s1);
-  }
-
-  const __swizzled_vec__<DataType, 1> odd() const {
-    return base_vec::swizzle(elem::s1);
-  }
-
-  __swizzled_vec__<DataType, 1> odd() {
-    return base_vec::swizzle(elem::s1);
-  }
-
-  const __swizzled_vec__<DataType, 1> even() const {
-    return base_vec::swizzle(elem::s0);
-  }
-
-  __swizzled_vec__<DataType, 1> even() {
-    return base_vec::swizzle(elem::s0);
-  }
+  TRISYCL_GEN_SWIZ(lo, 1, elem::s0)
+  TRISYCL_GEN_SWIZ(hi, 1, elem::s1)
+  TRISYCL_GEN_SWIZ(odd, 1, elem::s1)
+  TRISYCL_GEN_SWIZ(even, 1, elem::s0)
 #include "triSYCL/vec/detail/swiz2.hpp"
 };
 
@@ -237,37 +209,10 @@ public:
   TRISYCL_DECLARE_S(1);
   TRISYCL_DECLARE_S(2);
 
-  const __swizzled_vec__<DataType, 2> lo() const {
-    return base_vec::swizzle(elem::s0, elem::s1);
-  }
-
-  __swizzled_vec__<DataType, 2> lo()  {
-    return base_vec::swizzle(elem::s0, elem::s1);
-  }
-
-  const __swizzled_vec__<DataType, 2> hi() const {
-    return base_vec::swizzle(elem::s2, elem::s2);
-  }
-
-  __swizzled_vec__<DataType, 2> hi() {
-    return base_vec::swizzle(elem::s2, elem::s2);
-  }
-
-  const __swizzled_vec__<DataType, 2> odd() const {
-    return base_vec::swizzle(elem::s1, elem::s1);
-  }
-
-  __swizzled_vec__<DataType, 2> odd() {
-    return base_vec::swizzle(elem::s1, elem::s1);
-  }
-
-  const __swizzled_vec__<DataType, 2> even() const {
-    return base_vec::swizzle(elem::s0, elem::s2);
-  }
-
-  __swizzled_vec__<DataType, 2> even() {
-    return base_vec::swizzle(elem::s0, elem::s2);
-  }
+  TRISYCL_GEN_SWIZ(lo, 2, elem::s0, elem::s1)
+  TRISYCL_GEN_SWIZ(hi, 2, elem::s2, elem::s2)
+  TRISYCL_GEN_SWIZ(odd, 2, elem::s1, elem::s1)
+  TRISYCL_GEN_SWIZ(even, 2, elem::s0, elem::s2)
 #include "triSYCL/vec/detail/swiz3.hpp"
 };
 
@@ -366,45 +311,14 @@ public:
   TRISYCL_DECLARE_S(2);
   TRISYCL_DECLARE_S(3);
 
-  const __swizzled_vec__<DataType, 2> lo() const {
-    return base_vec::swizzle(elem::s0, elem::s1);
-  }
-
-  __swizzled_vec__<DataType, 2> lo()  {
-    return base_vec::swizzle(elem::s0, elem::s1);
-  }
-
-  const __swizzled_vec__<DataType, 2> hi() const {
-    return base_vec::swizzle(elem::s2, elem::s3);
-  }
-
-  __swizzled_vec__<DataType, 2> hi() {
-    return base_vec::swizzle(elem::s2, elem::s3);
-  }
-
-  const __swizzled_vec__<DataType, 2> odd() const {
-    return base_vec::swizzle(elem::s1, elem::s3);
-  }
-
-  __swizzled_vec__<DataType, 2> odd() {
-    return base_vec::swizzle(elem::s1, elem::s3);
-  }
-
-  const __swizzled_vec__<DataType, 2> even() const {
-    return base_vec::swizzle(elem::s0, elem::s2);
-  }
-
-  __swizzled_vec__<DataType, 2> even() {
-    return base_vec::swizzle(elem::s0, elem::s2);
-  }
+  TRISYCL_GEN_SWIZ(lo, 2, elem::s0, elem::s1)
+  TRISYCL_GEN_SWIZ(hi, 2, elem::s2, elem::s3)
+  TRISYCL_GEN_SWIZ(odd, 2, elem::s1, elem::s3)
+  TRISYCL_GEN_SWIZ(even, 2, elem::s0, elem::s2)
 #include "triSYCL/vec/detail/swiz4.hpp"
 #include "triSYCL/vec/detail/swiz_rgba.hpp"
 };
 
-#undef TRISYCL_GEN_SWIZ2
-#undef TRISYCL_GEN_SWIZ3
-#undef TRISYCL_GEN_SWIZ4
-
 template<typename DataType>
 class alignas(detail::alignment_v<::trisycl::vec<DataType, 8>>)
   vec<DataType, 8> : public detail::vec<DataType, 8> {
@@ -425,37 +339,10 @@ public:
   TRISYCL_DECLARE_S(7);
   TRISYCL_DECLARE_S(8);
 
-  const __swizzled_vec__<DataType, 4> lo() const {
-    return base_vec::swizzle(elem::s0, elem::s1, elem::s2, elem::s3);
-  }
-
-  __swizzled_vec__<DataType, 4> lo() {
-    return base_vec::swizzle(elem::s0, elem::s1, elem::s2, elem::s3);
-  }
-
-  const __swizzled_vec__<DataType, 4> hi() const {
-    return base_vec::swizzle(elem::s4, elem::s5, elem::s6, elem::s7);
-  }
-
-  __swizzled_vec__<DataType, 4> hi() {
-    return base_vec::swizzle(elem::s4, elem::s5, elem::s6, elem::s7);
-  }
-
-  const __swizzled_vec__<DataType, 4> odd() const {
-    return base_vec::swizzle(elem::s1, elem::s3, elem::s5, elem::s7);
-  }
-
-  __swizzled_vec__<DataType, 4> odd() {
-    return base_vec::swizzle(elem::s1, elem::s3, elem::s5, elem::s7);
-  }
-
-  const __swizzled_vec__<DataType, 4> even() const {
-    return base_vec::swizzle(elem::s0, elem::s2, elem::s4, elem::s6);
-  }
-
-  __swizzled_vec__<DataType, 4> even() {
-    return base_vec::swizzle(elem::s0, elem::s2, elem::s4, elem::s6);
-  }
+  TRISYCL_GEN_SWIZ(lo, 4, elem::s0, elem::s1, elem::s2, elem::s3)
+  TRISYCL_GEN_SWIZ(hi, 4, elem::s4, elem::s5, elem::s6, elem::s7)
+  TRISYCL_GEN_SWIZ(odd, 4, elem::s1, elem::s3, elem::s5, elem::s7)
+  TRISYCL_GEN_SWIZ(even, 4, elem::s0, elem::s2, elem::s4, elem::s6)
 };
 
 
@@ -486,49 +373,21 @@ public:
   TRISYCL_DECLARE_S(E);
   TRISYCL_DECLARE_S(F);
 
-  const __swizzled_vec__<DataType, 8> lo() const {
-    return base_vec::swizzle(elem::s0, elem::s1, elem::s2, elem::s3, elem::s4,
-                             elem::s5, elem::s6, elem::s7);
-  }
-
-  __swizzled_vec__<DataType, 8> lo() {
-    return base_vec::swizzle(elem::s0, elem::s1, elem::s2, elem::s3, elem::s4,
-                             elem::s5, elem::s6, elem::s7);
-  }
-
-  const __swizzled_vec__<DataType, 8> hi() const {
-    return base_vec::swizzle(elem::s8, elem::s9, elem::sA, elem::sB, elem::sC,
-                             elem::sD, elem::sE, elem::sF);
-  }
-
-  __swizzled_vec__<DataType, 8> hi() {
-    return base_vec::swizzle(elem::s8, elem::s9, elem::sA, elem::sB, elem::sC,
-                             elem::sD, elem::sE, elem::sF);
-  }
-
-  const __swizzled_vec__<DataType, 8> odd() const {
-    return base_vec::swizzle(elem::s1, elem::s3, elem::s5, elem::s7, elem::s9,
-                             elem::sB, elem::sD, elem::sF);
-  }
-
-  __swizzled_vec__<DataType, 8> odd() {
-    return base_vec::swizzle(elem::s1, elem::s3, elem::s5, elem::s7, elem::s9,
-                             elem::sB, elem::sD, elem::sF);
-  }
-
-  const __swizzled_vec__<DataType, 8> even() const {
-    return base_vec::swizzle(elem::s0, elem::s2, elem::s4, elem::s6, elem::s8,
-                             elem::sA, elem::sC, elem::sE);
-  }
-
-  __swizzled_vec__<DataType, 8> even() {
-    return base_vec::swizzle(elem::s0, elem::s2, elem::s4, elem::s6, elem::s8,
-                             elem::sA, elem::sC, elem::sE);
-  }
-
+  TRISYCL_GEN_SWIZ(lo, 8, elem::s0, elem::s1, elem::s2, elem::s3,
+                   elem::s4, elem::s5, elem::s6, elem::s7)
+  TRISYCL_GEN_SWIZ(hi, 8, elem::s8, elem::s9, elem::sA, elem::sB,
+                   elem::sC, elem::sD, elem::sE, elem::sF)
+  TRISYCL_GEN_SWIZ(odd, 8, elem::s1, elem::s3, elem::s5, elem::s7,
+                   elem::s9, elem::sB, elem::sD, elem::sF)
+  TRISYCL_GEN_SWIZ(even, 8, elem::s0, elem::s2, elem::s4, elem::s6,
+                   elem::s8, elem::sA, elem::sC, elem::sE)
 };
 
 #undef TRISYCL_DECLARE_S
+#undef TRISYCL_GEN_SWIZ
+#undef TRISYCL_GEN_SWIZ2
+#undef TRISYCL_GEN_SWIZ3
+#undef TRISYCL_GEN_SWIZ4
 
   /** A macro to define type alias, such as for type=uchar, size=4 and
       actual_type=unsigned char, uchar4 is equivalent to vec<unsigned char, 4>
@@ -554,6 +413,8 @@ public:
   TRISYCL_DEFINE_VEC_TYPE(uint, unsigned int)
   TRISYCL_DEFINE_VEC_TYPE(long, long int)
   TRISYCL_DEFINE_VEC_TYPE(ulong, unsigned long int)
+  TRISYCL_DEFINE_VEC_TYPE(half, half)
+  TRISYCL_DEFINE_VEC_TYPE(bfloat16, bfloat16)
   TRISYCL_DEFINE_VEC_TYPE(float, float)
   TRISYCL_DEFINE_VEC_TYPE(double, double)
 
@@ -0,0 +1,247 @@
+#ifndef TRISYCL_SYCL_VEC_DETAIL_CONVERT_HPP
+#define TRISYCL_SYCL_VEC_DETAIL_CONVERT_HPP
+
+/** \file
+
+    Implement the vec conversions with a rounding mode and an optional
+    saturation
+
+    When both vec have a native vector type, the elements are converted
+    at once with __builtin_convertvector, which gives the SIMD
+    conversion instructions. The rounding toward an integer is done
+    before, with additions of 2^23 or 2^52 which are exact except for
+    the rounding to the nearest even integer. Otherwise, and for the
+    rounding modes of a floating-point conversion other than rte, each
+    element is converted with the current floating-point environment
+    being the default one.
+
+    This file is distributed under the University of Illinois Open Source
+    License. See LICENSE.TXT for details.
+*/
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "triSYCL/bfloat16.hpp"
+#include "triSYCL/detail/native_vector.hpp"
+#include "triSYCL/half.hpp"
+#include "triSYCL/rounding_mode.hpp"
+#include "triSYCL/vendor/triSYCL/half_conversion.hpp"
+
+namespace trisycl::detail {
+
+/** \addtogroup vector Vector types in SYCL
+    @{
+*/
+
+/// Test for a 16-bit floating-point type, half or bfloat16
+template <typename T>
+inline constexpr bool is_float16_v =
+  std::is_same_v<T, half> || std::is_same_v<T, bfloat16>;
+
+
+/// Test for a floating-point type, including half and bfloat16
+template <typename T>
+inline constexpr bool is_floating_v =
+  std::is_floating_point_v<T> || is_float16_v<T>;
+
+
+/// The rounding mode used by a conversion to To
+template <typename To, rounding_mode Mode>
+inline constexpr rounding_mode actual_rounding_mode =
+  Mode != rounding_mode::automatic ? Mode
+  : std::is_integral_v<To> ? rounding_mode::rtz : rounding_mode::rte;
+
+
+/// The next floating-point number after x, upward or downward
+template <typename T>
+T next_after(T x, bool up) {
+  if constexpr (is_float16_v<T>) {
+    std::uint16_t bits = x.get_bits();
+    if ((bits & 0x7fff) == 0)
+      return T::from_bits(up ? 0x0001 : 0x8001);
+    // The magnitude increases when going away from zero
+    return T::from_bits(up == !(bits & 0x8000) ? bits + 1 : bits - 1);
+  } else
+    return std::nextafter(x, up ? std::numeric_limits<T>::infinity()
+                                : -std::numeric_limits<T>::infinity());
+}
+
+
+/** Compare 2 integers of any type as mathematical values, as
+    std::cmp_less which does not accept the char types
+*/
+template <typename A, typename B>
+constexpr bool integer_less(A a, B b) {
+  if constexpr (std::is_signed_v<A> == std::is_signed_v<B>)
+    return a < b;
+  else if constexpr (std::is_signed_v<A>)
+    return a < 0 || std::make_unsigned_t<A>(a) < b;
+  else
+    return b >= 0 && a < std::make_unsigned_t<B>(b);
+}
+
+
+/// Convert an element with a rounding mode and an optional saturation
+template <typename To, rounding_mode Mode, bool Saturate, typename From>
+To convert_element(From x) {
+  constexpr auto mode = actual_rounding_mode<To, Mode>;
+  using limits = std::numeric_limits<To>;
+  if constexpr (std::is_integral_v<To> && is_floating_v<From>) {
+    using F = std::conditional_t<is_float16_v<From>, float, From>;
+    F f = x;
+    if constexpr (mode == rounding_mode::rte)
+      f = std::nearbyint(f);
+    else if constexpr (mode == rounding_mode::rtz)
+      f = std::trunc(f);
+    else if constexpr (mode == rounding_mode::rtp)
+      f = std::ceil(f);
+    else
+      f = std::floor(f);
+    if constexpr (Saturate) {
+      if (f != f)
+        return 0;
+      if (f <= static_cast<F>(limits::lowest()))
+        return limits::lowest();
+      // The maximum may be rounded up to a power of 2, out of range
+      if (f >= static_cast<F>(limits::max()))
+        return limits::max();
+    }
+    return static_cast<To>(f);
+  } else if constexpr (std::is_integral_v<To>) {
+    if constexpr (Saturate && std::is_integral_v<From>) {
+      if (integer_less(x, limits::lowest()))
+        return limits::lowest();
+      if (integer_less(limits::max(), x))
+        return limits::max();
+    }
+    return static_cast<To>(x);
+  } else {
+    // Round to the nearest, then step back when on the wrong side
+    To r = static_cast<To>(x);
+    if constexpr (mode != rounding_mode::rte && !std::is_same_v<From, To>) {
+      auto exact = static_cast<long double>(x);
+      auto rounded = static_cast<long double>(r);
+      if (mode == rounding_mode::rtz ? std::abs(rounded) > std::abs(exact)
+          : mode == rounding_mode::rtp ? rounded < exact
+          : rounded > exact)
+        r = next_after(r, rounded < exact);
+    }
+    return r;
+  }
+}
+
+#if defined(__GNUC__) && !defined(TRISYCL_NO_NATIVE_VEC)
+
+/** Round the elements of a native vector of float or double to an
+    integer value
+
+    Adding 2^23 or 2^52 rounds to the nearest even integer the numbers
+    below it in magnitude, while the larger ones are already integers.
+    The truncation is left to the conversion instruction.
+*/
+template <rounding_mode Mode, typename Native>
+Native round_to_integer(Native x) {
+  if constexpr (Mode == rounding_mode::rtz)
+    return x;
+  else {
+    using T = std::remove_cvref_t<decltype(x[0])>;
+    constexpr T big = 1/std::numeric_limits<T>::epsilon();
+    Native r = x >= 0 ? (x + big) - big : (x - big) + big;
+    if constexpr (Mode == rounding_mode::rtp)
+      r = r < x ? r + 1 : r;
+    else if constexpr (Mode == rounding_mode::rtn)
+      r = r > x ? r - 1 : r;
+    // Keep the large numbers, the infinities and NaN
+    return (x < 0 ? -x : x) < big ? r : x;
+  }
+}
+
+#endif
+
+/** Convert the NumElements elements of a vec
+
+    \param[in] elements points to the elements to convert
+
+    \param Saturate clamps the results of a conversion to an integer
+    type to its range, with NaN giving 0
+*/
+template <typename To, rounding_mode Mode, bool Saturate, typename From,
+          int NumElements>
+::trisycl::vec<To, NumElements> convert(const From *elements) {
+  constexpr auto mode = actual_rounding_mode<To, Mode>;
+  ::trisycl::vec<To, NumElements> result;
+#if defined(__GNUC__) && !defined(TRISYCL_NO_NATIVE_VEC)
+  using source = native_vector<::trisycl::vec<From, NumElements>>;
+  using target = native_vector<::trisycl::vec<To, NumElements>>;
+  if constexpr (source::value && target::value) {
+    using limits = std::numeric_limits<To>;
+    using target_type = typename target::type;
+    auto x = source::load(elements);
+    if constexpr (std::is_integral_v<To> && std::is_floating_point_v<From>) {
+      auto r = round_to_integer<mode>(x);
+      if constexpr (Saturate) {
+        constexpr From lowest = limits::lowest();
+        // Possibly rounded up to a power of 2, out of range
+        constexpr From max = limits::max();
+        using mask = decltype(target_type {} < target_type {});
+        auto over = __builtin_convertvector(r >= max, mask);
+        // Replace the values out of range and NaN before the conversion
+        r = r < lowest ? lowest : r;
+        r = (r >= max) | (r != r) ? 0 : r;
+        auto n = __builtin_convertvector(r, target_type);
+        target::store(over ? limits::max() : n, result.data());
+      } else
+        target::store(__builtin_convertvector(r, target_type), result.data());
+      return result;
+    } else if constexpr (std::is_integral_v<To>) {
+      if constexpr (Saturate) {
+        // The range of To within the range of From
+        using from_limits = std::numeric_limits<From>;
+        constexpr From lowest =
+          integer_less(limits::lowest(), from_limits::lowest())
+          ? from_limits::lowest() : From(limits::lowest());
+        constexpr From max =
+          integer_less(from_limits::max(), limits::max())
+          ? from_limits::max() : From(limits::max());
+        x = x < lowest ? lowest : x;
+        x = x > max ? max : x;
+      }
+      target::store(__builtin_convertvector(x, target_type), result.data());
+      return result;
+    } else if constexpr (mode == rounding_mode::rte
+                         || sizeof(To) > sizeof(From)) {
+      // The exact conversions and the ones rounding to the nearest even
+      target::store(__builtin_convertvector(x, target_type), result.data());
+      return result;
+    }
+  }
+#endif
+  if constexpr (std::is_same_v<From, float> && is_float16_v<To>
+                && mode == rounding_mode::rte) {
+    vendor::trisycl::convert(elements, result.data(), NumElements);
+    return result;
+  } else if constexpr (is_float16_v<From> && std::is_same_v<To, float>) {
+    vendor::trisycl::convert(elements, result.data(), NumElements);
+    return result;
+  }
+  for (int i = 0; i != NumElements; ++i)
+    result[i] = convert_element<To, Mode, Saturate>(elements[i]);
+  return result;
+}
+
+/// @} End the vector Doxygen group
+
+}
+
+/*
+    # Some Emacs stuff:
+    ### Local Variables:
+    ### ispell-local-dictionary: "american"
+    ### eval: (flyspell-prog-mode)
+    ### End:
+*/
+
+#endif // TRISYCL_SYCL_VEC_DETAIL_CONVERT_HPP
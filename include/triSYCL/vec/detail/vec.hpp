@@ -1,8 +1,11 @@
 #ifndef TRISYCL_SYCL_VEC_DETAIL_VEC_HPP
 #define TRISYCL_SYCL_VEC_DETAIL_VEC_HPP
 
+#include <concepts>
+#include <cstddef>
 #include <cstring>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 /** \file
@@ -16,9 +19,12 @@
     License. See LICENSE.TXT for details.
 */
 
+#include "triSYCL/address_space.hpp"
 #include "triSYCL/rounding_mode.hpp"
 #include "triSYCL/detail/alignment_helper.hpp"
 #include "triSYCL/detail/array_tuple_helpers.hpp"
+#include "triSYCL/detail/native_vector.hpp"
+#include "triSYCL/vec/detail/convert.hpp"
 
 namespace trisycl {
 
@@ -33,8 +39,8 @@ namespace trisycl::detail {
 template <typename, int>
 class vec;
 
-template <typename DataType, int numElements>
-using __swizzled_base_vec__ = vec<DataType, numElements>;
+template <typename, int...>
+class swizzled_vec;
 
 /// Small SYCL vector class
 template <typename DataType, int NumElements>
@@ -92,6 +98,14 @@ private:
   }
 
 
+  /// A swizzle is flattened as the vec of its elements
+  template <typename V, typename Vec, int... Indexes>
+  static auto flatten(const swizzled_vec<Vec, Indexes...> &i) {
+    return flatten<V>(static_cast<const ::trisycl::vec<
+                        typename Vec::element_type, sizeof...(Indexes)> &>(i));
+  }
+
+
   /** If we do not have a vector, just forward it as a tuple up to the
       final initialization.
 
@@ -160,17 +174,6 @@ private:
         std::make_index_sequence<std::tuple_size<decltype(xTuple)>::value>());
   }
 
-protected:
-
-  /// Apply a swizzle operation from swizzleIndexes parameters
-  template<typename... Ts>
-  __swizzled_base_vec__<DataType, sizeof...(Ts)>
-  swizzle(Ts... swizzleIndexes) const {
-    // Construct a new vector from an elemental swizzle of each element
-    return __swizzled_base_vec__<DataType, sizeof...(Ts)> {
-      (*this)[swizzleIndexes]... };
-  }
-
 public:
 
   /// Return the number of elements in the vector
@@ -187,16 +190,31 @@ public:
   }
 
 
-  template<typename convertT, rounding_mode roundingMode>
-  vec<convertT, NumElements> convert() const {
-    vec<convertT, NumElements> result;
+  /** Convert each element to convertT with a rounding mode
 
-    assert(result.get_count() == this->get_count());
-    for (int n = 0; n < NumElements; n++) {
-      result[n] = (*this)[n];
-    }
-    return result;
-  };
+      With a native vector type for both vec, it uses the SIMD
+      conversion instructions.
+  */
+  template <typename convertT,
+            rounding_mode roundingMode = rounding_mode::automatic>
+  ::trisycl::vec<convertT, NumElements> convert() const {
+    return detail::convert<convertT, roundingMode, false, DataType,
+                           NumElements>(this->data());
+  }
+
+
+  /** Convert each element to convertT with a rounding mode, clamping
+      the integer results to the range of convertT as the
+      convert_<type>_sat functions of OpenCL
+
+      \todo Add to the specification
+  */
+  template <typename convertT,
+            rounding_mode roundingMode = rounding_mode::automatic>
+  ::trisycl::vec<convertT, NumElements> convert_sat() const {
+    return detail::convert<convertT, roundingMode, true, DataType,
+                           NumElements>(this->data());
+  }
 
 
   template<typename asT> asT as() const {
@@ -207,11 +225,81 @@ public:
   };
 
 
-  // Swizzle methods (see notes)
+  /** Load the NumElements elements starting at ptr + offset*NumElements
+
+      The copy of the elements is a single vector move when the vec
+      fits in a SIMD register, whatever the alignment of ptr.
+  */
+  template <typename T, access::address_space AS>
+    requires std::same_as<std::remove_const_t<T>, DataType>
+  void load(std::size_t offset, ::trisycl::multi_ptr<T*, AS> ptr) {
+    std::memcpy(this->data(), static_cast<T*>(ptr) + offset*NumElements,
+                NumElements*sizeof(DataType));
+  }
+
+
+  /// Load some elements from an accessor, starting at its element
+  /// offset*NumElements
+  template <typename Accessor>
+    requires requires (const Accessor &a) {
+      { a.get_pointer() } -> std::convertible_to<const DataType*>;
+    }
+  void load(std::size_t offset, const Accessor &a) {
+    std::memcpy(this->data(), a.get_pointer() + offset*NumElements,
+                NumElements*sizeof(DataType));
+  }
+
+
+  /// Store the NumElements elements starting at ptr + offset*NumElements
+  template <access::address_space AS>
+  void store(std::size_t offset,
+             ::trisycl::multi_ptr<DataType*, AS> ptr) const {
+    std::memcpy(static_cast<DataType*>(ptr) + offset*NumElements,
+                this->data(), NumElements*sizeof(DataType));
+  }
+
+
+  /// Store the elements to an accessor, starting at its element
+  /// offset*NumElements
+  template <typename Accessor>
+    requires requires (const Accessor &a) {
+      { a.get_pointer() } -> std::convertible_to<DataType*>;
+    }
+  void store(std::size_t offset, const Accessor &a) const {
+    std::memcpy(a.get_pointer() + offset*NumElements, this->data(),
+                NumElements*sizeof(DataType));
+  }
+
+
+  /** Swizzle methods (see notes)
+
+      With a native vector type for both the vec and the result, the
+      indexes known at compile time make a single shuffle instruction
+      of the SIMD registers. Otherwise the elements are copied one by
+      one.
+  */
   template <int... swizzleIndexs>
   __swizzled_vec__<DataType, sizeof...(swizzleIndexs)> swizzle() const {
-    return static_cast<__swizzled_vec__<DataType, sizeof...(swizzleIndexs)>>(
-        swizzle(swizzleIndexs...));
+    using result_type = __swizzled_vec__<DataType, sizeof...(swizzleIndexs)>;
+    static_assert(((0 <= swizzleIndexs && swizzleIndexs < NumElements) && ...),
+                  "A swizzle index is out of the vector");
+#if defined(__GNUC__)
+    using source = native_vector<::trisycl::vec<DataType, NumElements>>;
+    using target = native_vector<result_type>;
+    if constexpr (source::value && target::value) {
+      auto v = source::load(this->data());
+      result_type result;
+      // The native vector of a vec of 3 has a 4th element, left undefined
+      if constexpr (sizeof...(swizzleIndexs) == 3)
+        target::store(__builtin_shufflevector(v, v, swizzleIndexs..., -1),
+                      result.data());
+      else
+        target::store(__builtin_shufflevector(v, v, swizzleIndexs...),
+                      result.data());
+      return result;
+    } else
+#endif
+      return result_type { (*this)[swizzleIndexs]... };
   }
 
 
@@ -250,6 +338,110 @@ public:
 };
 
 
+/** A swizzle of a non-const vec, which writes in place to the
+    original elements when it is assigned
+
+    It reads as a vec with a copy of the selected elements. When some
+    elements are repeated, the last one is written.
+
+    \param Vec is the detail::vec type of the original vector
+*/
+template <typename Vec, int... Indexes>
+class swizzled_vec
+  : public ::trisycl::vec<typename Vec::element_type, sizeof...(Indexes)> {
+  using vec_type =
+    ::trisycl::vec<typename Vec::element_type, sizeof...(Indexes)>;
+
+  /// The vector the elements come from
+  Vec &source;
+
+
+  /// The lane of the swizzle giving each lane of the source, if any
+  static constexpr int lane(std::size_t source_lane) {
+    int swizzle_lane = 0;
+    int result = -1;
+    ((Indexes == int(source_lane) ? result = swizzle_lane++
+                                  : swizzle_lane++), ...);
+    return result;
+  }
+
+
+  /// Test whether the swizzle writes each element of the source once
+  static constexpr bool is_permutation() {
+    if (sizeof...(Indexes) != Vec::dimension)
+      return false;
+    for (std::size_t i = 0; i != Vec::dimension; ++i)
+      if (lane(i) < 0)
+        return false;
+    return true;
+  }
+
+public:
+
+  swizzled_vec(Vec &source)
+    : vec_type { source.template swizzle<Indexes...>() }
+    , source { source } {}
+
+
+  swizzled_vec(const swizzled_vec &) = default;
+
+
+  /// Write the elements of v to the selected elements of the source
+  swizzled_vec &operator=(const vec_type &v) {
+    vec_type::operator=(v);
+#if defined(__GNUC__)
+    using native = native_vector<vec_type>;
+    if constexpr (is_permutation() && native::value) {
+      // Write all the elements with the inverse shuffle
+      auto n = native::load(v.data());
+      [&]<std::size_t... Lanes>(std::index_sequence<Lanes...>) {
+        native::store(__builtin_shufflevector(n, n, lane(Lanes)...),
+                      source.data());
+      }(std::make_index_sequence<sizeof(n)/sizeof(n[0])>{});
+    } else
+#endif
+    {
+      int i = 0;
+      ((source[Indexes] = v[i++]), ...);
+    }
+    return *this;
+  }
+
+
+  swizzled_vec &operator=(const swizzled_vec &v) {
+    return *this = static_cast<const vec_type &>(v);
+  }
+
+
+  /// Write a value to all the selected elements of the source
+  swizzled_vec &operator=(const typename Vec::element_type &v) {
+    return *this = vec_type(v);
+  }
+
+
+#define TRISYCL_SWIZZLED_ASSIGNMENT_OP(op)                              \
+  template <typename T>                                                 \
+  swizzled_vec &operator op(const T &rhs) {                             \
+    vec_type result = *this;                                            \
+    result op rhs;                                                      \
+    return *this = result;                                              \
+  }
+
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(+=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(-=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(*=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(/=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(%=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(&=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(|=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(^=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(<<=)
+  TRISYCL_SWIZZLED_ASSIGNMENT_OP(>>=)
+
+#undef TRISYCL_SWIZZLED_ASSIGNMENT_OP
+
+};
+
 };
 
 #endif
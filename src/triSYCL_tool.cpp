@@ -1,38 +1,159 @@
 #include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
+#ifdef TRISYCL_TOOL_ZSTD
+#include <zstd.h>
+#endif
+
 namespace po = boost::program_options;
 
+/** The ways to put a kernel binary into a C++ file
+
+    Emitting each byte as a C++ literal works with any compiler but a
+    multi-hundred-megabyte FPGA bitstream takes ages to compile, while
+    the \c .incbin assembler directive and the C23 \c #embed directive
+    let the compiler copy the file directly into the read-only data of
+    the object file.
+*/
+enum class embedding { bytes, incbin, embed };
+
+
+/// Read all the bytes of a file
+std::vector<char> read_file(std::istream &input_file) {
+  return { std::istreambuf_iterator<char> { input_file },
+           std::istreambuf_iterator<char> {} };
+}
+
+
+/// Escape a string to put it between double quotes in C or assembly
+std::string escape(const std::string &s) {
+  std::string escaped;
+  for (auto c : s) {
+    if (c == '"' || c == '\\')
+      escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+
+/// Compress some bytes with zstd
+std::vector<char> compress(const std::vector<char> &data, int level) {
+#ifdef TRISYCL_TOOL_ZSTD
+  std::vector<char> compressed(ZSTD_compressBound(data.size()));
+  auto size = ZSTD_compress(compressed.data(), compressed.size(),
+                            data.data(), data.size(), level);
+  if (ZSTD_isError(size))
+    throw std::runtime_error { std::string { "zstd compression failed: " }
+                               + ZSTD_getErrorName(size) };
+  compressed.resize(size);
+  return compressed;
+#else
+  throw std::runtime_error {
+    "triSYCL_tool was built without zstd for --compress"
+  };
+#endif
+}
+
+
+/** Put a kernel binary into a C++ file constructing a
+    drt::code::program
+
+    \param[in] binary is the binary to put in the C++ file with the
+    bytes embedding
+
+    \param[in] binary_file_name is the file with the binary, used by
+    the other embeddings
+
+    \param[in] compressed tells whether the binary is compressed with
+    zstd, so the C++ file provides the decompressor called when the
+    program is built
+*/
 void
-put_file_into_source(std::istream &input_file,
+put_file_into_source(const std::vector<char> &binary,
+                     const std::string &binary_file_name,
+                     embedding e,
+                     bool compressed,
                      std::ostream &output_file) {
   output_file << R"(#include "trisycl.hpp"
-
+)";
+  if (compressed)
+    output_file << R"(
+#include <zstd.h>
+)";
+  output_file << R"(
 namespace {
-
+)";
+  if (compressed)
+    output_file << R"(
+std::vector<unsigned char> decompress(const unsigned char *data,
+                                      std::size_t size) {
+  std::vector<unsigned char> d(ZSTD_getFrameContentSize(data, size));
+  if (ZSTD_isError(ZSTD_decompress(d.data(), d.size(), data, size)))
+    throw trisycl::runtime_error { "Cannot decompress the kernel binary" };
+  return d;
+}
+)";
+  // The embedded file is found from anywhere the C++ file is compiled
+  auto path = std::filesystem::absolute(binary_file_name).string();
+  switch (e) {
+  case embedding::bytes:
+    output_file << R"(
 const char binary[] = {
 )";
+    for (std::size_t i = 0; i != binary.size(); ++i) {
+      output_file << "'\\x" << std::hex << std::setw(2) << std::setfill('0')
+                  << static_cast<unsigned int>(
+                       static_cast<unsigned char>(binary[i]))
+                  << "'"
+                  // Keep the lines short for the editors and the compilers
+                  << (i % 16 == 15 ? ",\n" : ", ");
+    }
+    output_file << R"(
+};
 
-  for (;;) {
-    char c;
-    input_file.get(c);
-    if (!input_file)
-      break;
-    output_file << "'\\x" << std::hex << std::setw(2) << std::setfill('0')
-                << static_cast<unsigned int>(static_cast<unsigned char>(c))
-                << "', ";
-  }
-  output_file << R"(
+const auto binary_size = sizeof(binary);
+)";
+    break;
+  case embedding::incbin:
+    /* The labels are not global, so they do not clash with the ones
+       of the other programs */
+    output_file << R"(
+extern "C" const char trisycl_binary[], trisycl_binary_end[];
+
+asm(".pushsection .rodata\n"
+    ".balign 16\n"
+    "trisycl_binary:\n"
+    ".incbin \")" << escape(escape(path)) << R"(\"\n"
+    "trisycl_binary_end:\n"
+    ".popsection\n");
+
+const auto binary = trisycl_binary;
+const std::size_t binary_size = trisycl_binary_end - trisycl_binary;
+)";
+    break;
+  case embedding::embed:
+    output_file << R"(
+const char binary[] = {
+#embed ")" << escape(path) << R"("
 };
 
-trisycl::drt::code::program p { sizeof(binary), binary };
+const auto binary_size = sizeof(binary);
+)";
+    break;
+  }
+  output_file << R"(
+trisycl::drt::code::program p { binary_size, binary, true)"
+              << (compressed ? ", decompress" : "") << R"( };
 
 }
 )";
@@ -41,6 +162,8 @@ trisycl::drt::code::program p { sizeof(binary), binary };
 int main(int argc, char *argv[]) {
 
   std::string output_file_name;
+  std::string embedding_name;
+  int level;
 
   // The description title when displaying the help
   po::options_description desc {
@@ -53,8 +176,16 @@ int main(int argc, char *argv[]) {
     ("source-in", po::value<std::string>(),
      R"(Take a file and put it into a C++ file to construct a kernel::code
  when compiled)")
+    ("embed", po::value<std::string>(&embedding_name)->default_value("bytes"),
+     R"(how --source-in puts the file into the C++ file: "bytes" as C++
+ literals, "incbin" with the .incbin assembler directive or "embed" with
+ the C23 #embed directive, the 2 latter being much faster to compile)")
+    ("compress", po::value<int>(&level)->implicit_value(19),
+     R"(compress the file with zstd at the given level, to be decompressed
+ when the program is built, the other embeddings than "bytes" needing
+ --output to write the compressed file next to it)")
     ("output,o", po::value<std::string>(&output_file_name),
-     "specify the relay id (0--3)");
+     "specify the output file");
 
   // Where to get the option results
   po::variables_map vm;
@@ -68,15 +199,62 @@ int main(int argc, char *argv[]) {
   }
 
   if (vm.count("source-in")) {
-    std::ifstream input_file { vm["source-in"].as<std::string>() };
-    if (!input_file.is_open()) {
-      std::cerr << "Failed to open \"" << vm["source-in"].as<std::string>()
+    auto input_file_name = vm["source-in"].as<std::string>();
+    embedding e;
+    if (embedding_name == "bytes")
+      e = embedding::bytes;
+    else if (embedding_name == "incbin")
+      e = embedding::incbin;
+    else if (embedding_name == "embed")
+      e = embedding::embed;
+    else {
+      std::cerr << "Unknown embedding \"" << embedding_name
+                << "\" for --embed" << std::endl;
+      exit(-1);
+    }
+    auto compressed = vm.count("compress") != 0;
+    std::vector<char> binary;
+    // The bytes embedding and the compression need the content
+    if (e == embedding::bytes || compressed) {
+      std::ifstream input_file { input_file_name, std::ios::binary };
+      if (!input_file.is_open()) {
+        std::cerr << "Failed to open \"" << input_file_name
+                  << "\" for --source-in" << std::endl;
+        exit(-1);
+      }
+      input_file.exceptions(std::ifstream::badbit);
+      binary = read_file(input_file);
+    }
+    else if (!std::filesystem::exists(input_file_name)) {
+      std::cerr << "Failed to open \"" << input_file_name
                 << "\" for --source-in" << std::endl;
       exit(-1);
     }
-    input_file.exceptions(std::ifstream::badbit);
+    if (compressed) {
+      try {
+        binary = compress(binary, level);
+      } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+        exit(-1);
+      }
+      if (e != embedding::bytes) {
+        // The file embedded is the compressed one
+        if (output_file_name.empty()) {
+          std::cerr << "--compress with --embed " << embedding_name
+                    << " needs --output" << std::endl;
+          exit(-1);
+        }
+        input_file_name = output_file_name + ".zst";
+        std::ofstream compressed_file { input_file_name, std::ios::binary };
+        if (!compressed_file.write(binary.data(), binary.size())) {
+          std::cerr << "Failed to write \"" << input_file_name << '"'
+                    << std::endl;
+          exit(-1);
+        }
+      }
+    }
     if (output_file_name.empty())
-      put_file_into_source(input_file, std::cout);
+      put_file_into_source(binary, input_file_name, e, compressed, std::cout);
     else {
       std::ofstream output_file { output_file_name };
       if (!output_file.is_open()) {
@@ -85,7 +263,8 @@ int main(int argc, char *argv[]) {
         exit(-1);
       }
       output_file.exceptions(std::ifstream::badbit);
-      put_file_into_source(input_file, output_file);
+      put_file_into_source(binary, input_file_name, e, compressed,
+                           output_file);
     }
     return 0;
   }
@@ -0,0 +1,50 @@
+/* RUN: %{execute}%s
+
+   Check the lightweight views of the accessors used in the kernels
+*/
+#include <CL/sycl.hpp>
+
+#include <type_traits>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 10;
+constexpr std::size_t m = 20;
+
+TEST_CASE("indexing the views in kernels", "[accessor]") {
+  queue q;
+  buffer<int, 2> a { range<2> { n, m } };
+  buffer<int, 2> b { range<2> { n, m } };
+  q.submit([&](handler &cgh) {
+      auto v = a.get_access<access::mode::discard_write>(cgh).get_view();
+      STATIC_REQUIRE(std::is_trivially_copyable_v<decltype(v)>);
+      cgh.parallel_for(range<2> { n, m }, [=](id<2> i) {
+          v[i] = i[0]*m + i[1];
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto in = a.get_access<access::mode::read>(cgh).get_view();
+      auto out = b.get_access<access::mode::discard_write>(cgh).get_view();
+      STATIC_REQUIRE(std::is_same_v<decltype(in[0][0]), const int&>);
+      cgh.parallel_for(range<2> { n, m }, [=](item<2> i) {
+          out[i.get_id(0)][i.get_id(1)] = 2*in[i] + in[i.get_id(0), 0];
+        });
+    });
+  auto r = b.get_access<access::mode::read>();
+  auto v = r.get_view();
+  REQUIRE(v.get_range() == range<2> { n, m });
+  REQUIRE(v.get_count() == n*m);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < m; ++j)
+      REQUIRE(v[i, j] == int(2*(i*m + j) + i*m));
+  // The sub-view of a row iterates on its elements
+  int sum = 0;
+  for (auto e : v[1])
+    sum += e;
+  int expected = 0;
+  for (std::size_t j = 0; j < m; ++j)
+    expected += r[1][j];
+  REQUIRE(sum == expected);
+}
@@ -0,0 +1,53 @@
+/* RUN: %{execute}%s
+
+   Check that the accessors are contiguous ranges usable with the
+   standard algorithms
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+
+using read_write_accessor =
+  accessor<int, 1, access::mode::read_write, access::target::global_buffer>;
+using host_accessor_type =
+  accessor<int, 2, access::mode::read, access::target::host_buffer>;
+
+TEST_CASE("accessors are contiguous ranges", "[accessor]") {
+  STATIC_REQUIRE(std::contiguous_iterator<read_write_accessor::iterator>);
+  STATIC_REQUIRE(std::ranges::contiguous_range<read_write_accessor>);
+  STATIC_REQUIRE(std::ranges::sized_range<read_write_accessor>);
+  STATIC_REQUIRE(std::ranges::contiguous_range<host_accessor_type>);
+}
+
+TEST_CASE("standard algorithms on accessors", "[accessor]") {
+  queue q;
+  buffer<int> a { n };
+  {
+    auto h = a.get_access<access::mode::discard_write>();
+    std::iota(h.begin(), h.end(), 0);
+  }
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto in = a.get_access<access::mode::read>(cgh);
+      auto out = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] {
+          std::span<int> s { out };
+          std::ranges::transform(in, s.begin(), [](int x) { return 2*x; });
+        });
+    });
+  auto h = b.get_access<access::mode::read>();
+  REQUIRE(h.size() == n);
+  REQUIRE(!h.empty());
+  REQUIRE(std::ranges::data(h) == h.get_pointer());
+  REQUIRE(std::reduce(h.begin(), h.end()) == int(n*(n - 1)));
+}
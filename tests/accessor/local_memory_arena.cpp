@@ -0,0 +1,96 @@
+/* RUN: %{execute}%s
+
+   Test the local accessors of work-groups running concurrently, each
+   one with its own local memory
+*/
+#define TRISYCL_WORK_ITEM_FIBERS
+
+#include <CL/sycl.hpp>
+
+#include <barrier>
+#include <cstdint>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 64;
+constexpr std::size_t group_size = 32;
+constexpr std::size_t n = groups*group_size;
+
+TEST_CASE("several local accessors in concurrent work-groups",
+          "[local_memory_arena]") {
+  queue q;
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      accessor<char, 1, access::mode::read_write, access::target::local>
+        tags { group_size, cgh };
+      accessor<int, 2, access::mode::read_write, access::target::local>
+        table { range<2> { 2, group_size }, cgh };
+      cgh.parallel_for<class several>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          auto l = i.get_local_id(0);
+          auto g = i.get_group(0);
+          tags[l] = 'a' + g%26;
+          table[0][l] = g;
+          table[id<2> { 1, l }] = l;
+          i.barrier(access::fence_space::local_space);
+          // Read what the mirror work-item has written in each accessor
+          auto m = group_size - 1 - l;
+          a[i.get_global_id(0)] =
+            1000*table[0][m] + table[1][m] + (tags[m] == 'a' + g%26);
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == int(1000*(i/group_size) + group_size - 1
+                        - i%group_size + 1));
+}
+
+TEST_CASE("aligned local memory", "[local_memory_arena]") {
+  queue q;
+  buffer<bool> aligned { groups };
+  q.submit([&](handler &cgh) {
+      auto a = aligned.get_access<access::mode::discard_write>(cgh);
+      accessor<char, 1, access::mode::read_write, access::target::local>
+        c { 3, cgh };
+      accessor<double, 1, access::mode::read_write, access::target::local>
+        d { group_size, cgh };
+      cgh.parallel_for_work_group<class alignment>(
+        nd_range<1> { n, group_size },
+        [=](group<1> g) {
+          auto p = reinterpret_cast<std::uintptr_t>(&d[0]);
+          a[g.get_id(0)] = p % 64 == 0
+            && p != reinterpret_cast<std::uintptr_t>(&c[0]);
+        });
+    });
+  auto a = aligned.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < groups; ++g)
+    REQUIRE(a[g]);
+}
+
+TEST_CASE("local memory of concurrent threads", "[local_memory_arena]") {
+  using arena = ::trisycl::detail::local_memory_arena;
+  constexpr std::size_t size = 100;
+  std::uintptr_t bases[2];
+  // Keep both threads in their work-group until both have their memory
+  std::barrier both { 2 };
+  auto run = [&] (int t) {
+    arena::group_scope in_group { size };
+    bases[t] = reinterpret_cast<std::uintptr_t>(arena::current());
+    both.arrive_and_wait();
+  };
+  std::thread t0 { run, 0 };
+  std::thread t1 { run, 1 };
+  t0.join();
+  t1.join();
+  for (auto b : bases)
+    REQUIRE(b % arena::alignment == 0);
+  auto distance = bases[0] > bases[1] ? bases[0] - bases[1]
+                                      : bases[1] - bases[0];
+  // No pair of cache lines holds the local memories of both threads
+  REQUIRE(distance >= arena::align(size) + arena::guard);
+}
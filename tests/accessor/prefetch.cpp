@@ -0,0 +1,45 @@
+/* RUN: %{execute}%s
+
+   Check that prefetching through an accessor or a multi_ptr is only a
+   hint not changing the results
+*/
+#include <CL/sycl.hpp>
+
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+
+TEST_CASE("prefetch ahead of a stencil", "[accessor]") {
+  queue q;
+  buffer<int, 2> a { range<2> { n, 3 } };
+  {
+    auto h = a.get_access<access::mode::discard_write>();
+    std::iota(h.begin(), h.end(), 0);
+  }
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto in = a.get_access<access::mode::read>(cgh);
+      auto out = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=] (id<1> i) {
+          // Prefetch the next row, even past the end of the buffer
+          in.prefetch(id<2> { i[0], 0 }, 6);
+          out[i] = in[i[0]][0] + in[i[0]][1] + in[i[0]][2];
+        });
+    });
+  auto h = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(h[i] == int(9*i + 3));
+}
+
+TEST_CASE("prefetch through a multi_ptr", "[accessor]") {
+  float data[100] {};
+  multi_ptr<float *, access::address_space::global_space> p { data };
+  p.prefetch(100);
+  // An empty prefetch does not touch the memory
+  p.prefetch(0);
+  REQUIRE(data[99] == 0);
+}
@@ -0,0 +1,150 @@
+/* RUN: %{execute}%s
+
+   Exercise the triSYCL sycl::vendor::trisycl::algorithm extension
+*/
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/algorithm.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace algo = ::trisycl::vendor::trisycl::algorithm;
+
+// Enough elements to have several blocks
+constexpr std::size_t n = 100003;
+
+std::vector<int> random_ints() {
+  std::mt19937 g;
+  std::uniform_int_distribution<int> d { -1000000, 1000000 };
+  std::vector<int> v(n);
+  for (auto &e : v)
+    e = d(g);
+  return v;
+}
+
+template <typename T>
+std::vector<T> content(buffer<T> b) {
+  auto a = b.template get_access<access::mode::read>();
+  return { a.begin(), a.end() };
+}
+
+TEST_CASE("scans", "[algorithm]") {
+  auto v = random_ints();
+  queue q;
+  buffer<int> in { v.begin(), v.end() };
+  buffer<int> inclusive { n };
+  buffer<int> exclusive { n };
+  algo::inclusive_scan(q, in, inclusive);
+  algo::exclusive_scan(q, in, exclusive, 42);
+  std::vector<int> expected(n);
+  std::inclusive_scan(v.begin(), v.end(), expected.begin());
+  REQUIRE(content(inclusive) == expected);
+  std::exclusive_scan(v.begin(), v.end(), expected.begin(), 42);
+  REQUIRE(content(exclusive) == expected);
+  // In place with another operation
+  algo::inclusive_scan(q, in, in, maximum<>());
+  std::inclusive_scan(v.begin(), v.end(), expected.begin(),
+                      maximum<>());
+  REQUIRE(content(in) == expected);
+  // Nothing to scan
+  buffer<int> empty { 0 };
+  algo::exclusive_scan(q, empty, empty, 0);
+  REQUIRE(content(empty).empty());
+}
+
+TEST_CASE("reductions", "[algorithm]") {
+  auto v = random_ints();
+  queue q;
+  buffer<int> in { v.begin(), v.end() };
+  auto sum = algo::reduce(q, in, 3);
+  auto max = algo::reduce(q, in, -2000000, maximum<>());
+  auto squares = algo::transform_reduce(q, in, 0.0, std::plus<> {},
+                                        [](int x) { return double(x)*x; });
+  REQUIRE(sum.get_access<access::mode::read>()[0]
+          == std::accumulate(v.begin(), v.end(), 3));
+  REQUIRE(max.get_access<access::mode::read>()[0]
+          == *std::max_element(v.begin(), v.end()));
+  double expected = 0;
+  for (auto e : v)
+    expected += double(e)*e;
+  REQUIRE(std::abs(squares.get_access<access::mode::read>()[0] - expected)
+          <= 1e-9*expected);
+}
+
+TEST_CASE("sorts", "[algorithm]") {
+  auto v = random_ints();
+  queue q;
+  buffer<int> ints { v.begin(), v.end() };
+  std::vector<float> f(v.begin(), v.end());
+  for (auto &e : f)
+    e /= 7;
+  buffer<float> floats { f.begin(), f.end() };
+  buffer<int> decreasing { v.begin(), v.end() };
+  std::vector<unsigned char> c(v.begin(), v.end());
+  buffer<unsigned char> chars { c.begin(), c.end() };
+  // Radix sorts
+  algo::sort(q, ints);
+  algo::sort(q, floats);
+  algo::sort(q, chars);
+  // Merge sort
+  algo::sort(q, decreasing, std::greater<> {});
+  std::sort(v.begin(), v.end());
+  REQUIRE(content(ints) == v);
+  std::sort(f.begin(), f.end());
+  REQUIRE(content(floats) == f);
+  std::sort(c.begin(), c.end());
+  REQUIRE(content(chars) == c);
+  std::reverse(v.begin(), v.end());
+  REQUIRE(content(decreasing) == v);
+}
+
+TEST_CASE("copy_if", "[algorithm]") {
+  auto v = random_ints();
+  queue q;
+  buffer<int> in { v.begin(), v.end() };
+  buffer<int> out { n };
+  buffer<int> small { 10 };
+  auto positive = [](int x) { return x > 0; };
+  auto count = algo::copy_if(q, in, out, positive);
+  auto truncated = algo::copy_if(q, in, small, positive);
+  std::vector<int> expected;
+  std::copy_if(v.begin(), v.end(), std::back_inserter(expected), positive);
+  REQUIRE(count.get_access<access::mode::read>()[0] == expected.size());
+  auto selected = content(out);
+  selected.resize(expected.size());
+  REQUIRE(selected == expected);
+  REQUIRE(truncated.get_access<access::mode::read>()[0] == expected.size());
+  expected.resize(10);
+  REQUIRE(content(small) == expected);
+}
+
+TEST_CASE("equal, hash and minmax", "[algorithm]") {
+  auto v = random_ints();
+  queue q;
+  buffer<int> a { v.begin(), v.end() };
+  buffer<int> b { v.begin(), v.end() };
+  auto w = v;
+  w[n - 1] += 1;
+  buffer<int> c { w.begin(), w.end() };
+  buffer<int> shorter { v.begin(), v.end() - 1 };
+  REQUIRE(algo::equal(q, a, b).get_access<access::mode::read>()[0]);
+  REQUIRE(!algo::equal(q, a, c).get_access<access::mode::read>()[0]);
+  REQUIRE(!algo::equal(q, a, shorter).get_access<access::mode::read>()[0]);
+  auto h = [&](auto &buf) {
+    // Small blocks to hash several of them in parallel
+    return algo::hash(q, buf, 4096)
+      .template get_access<access::mode::read>()[0];
+  };
+  REQUIRE(h(a) == h(b));
+  REQUIRE(h(a) != h(c));
+  REQUIRE(h(a) != h(shorter));
+  auto [min, max] = std::minmax_element(v.begin(), v.end());
+  auto m = content(algo::minmax(q, a));
+  REQUIRE(m == std::vector<int> { *min, *max });
+}
@@ -0,0 +1,71 @@
+/* RUN: %{execute}%s
+
+   Exercise the dense linear algebra of the triSYCL extensions
+*/
+#include <array>
+#include <random>
+#include <vector>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/blas.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace blas = ::trisycl::vendor::trisycl::blas;
+
+template <typename T>
+std::vector<T> content(buffer<T> &b) {
+  auto a = b.template get_access<access::mode::read>();
+  return { a.begin(), a.end() };
+}
+
+// Small integers keep the sums exact in any order
+std::vector<double> random_matrix(std::size_t size) {
+  static std::mt19937 g;
+  std::vector<double> v(size);
+  for (auto &e : v)
+    e = static_cast<int>(g()%7) - 3;
+  return v;
+}
+
+TEST_CASE("dense linear algebra", "[blas]") {
+  queue q;
+  // Some sizes which are not multiples of the tiles, then some which are
+  for (auto [m, n, k] : { std::array<std::size_t, 3> { 131, 277, 301 },
+                          { 64, 256, 256 }, { 5, 3, 0 } }) {
+    auto a = random_matrix(m*k);
+    auto b = random_matrix(k*n);
+    auto c = random_matrix(m*n);
+    auto expected = c;
+    for (std::size_t i = 0; i != m; ++i)
+      for (std::size_t j = 0; j != n; ++j) {
+        double sum = 0;
+        for (std::size_t p = 0; p != k; ++p)
+          sum += a[i*k + p]*b[p*n + j];
+        expected[i*n + j] = 2*sum + 3*c[i*n + j];
+      }
+    buffer<double> ba { a.begin(), a.end() };
+    buffer<double> bb { b.begin(), b.end() };
+    buffer<double> bc { c.begin(), c.end() };
+    blas::gemm(q, m, n, k, 2.0, ba, bb, 3.0, bc);
+    REQUIRE(content(bc) == expected);
+
+    // The product of A by its first column of B
+    std::vector<double> x(k), y(m);
+    for (std::size_t p = 0; p != k; ++p)
+      x[p] = b[p*n];
+    for (std::size_t i = 0; i != m; ++i)
+      for (std::size_t p = 0; p != k; ++p)
+        y[i] += a[i*k + p]*x[p];
+    buffer<double> bx { x.begin(), x.end() };
+    buffer<double> by { range<1> { m } };
+    blas::gemv(q, m, k, 1.0, ba, bx, 0.0, by);
+    REQUIRE(content(by) == y);
+
+    // y - y is 0
+    buffer<double> bz { y.begin(), y.end() };
+    blas::axpy(q, -1.0, by, bz);
+    REQUIRE(content(bz) == std::vector<double>(m));
+  }
+}
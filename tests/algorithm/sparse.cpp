@@ -0,0 +1,79 @@
+/* RUN: %{execute}%s
+
+   Exercise the sparse matrices of the triSYCL extensions
+*/
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/sparse.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace sparse = ::trisycl::vendor::trisycl::sparse;
+
+constexpr std::size_t m = 1003;
+constexpr std::size_t n = 700;
+constexpr std::size_t k = 3;
+
+template <typename T>
+std::vector<T> content(buffer<T> &b) {
+  auto a = b.template get_access<access::mode::read>();
+  return { a.begin(), a.end() };
+}
+
+TEST_CASE("sparse matrix products", "[sparse]") {
+  std::mt19937 g;
+  // Mostly short rows with some long ones to unbalance the work
+  std::vector<std::size_t> offsets { 0 };
+  std::vector<std::uint32_t> columns;
+  std::vector<double> values;
+  std::vector<double> dense(m*n);
+  for (std::size_t r = 0; r != m; ++r) {
+    auto length = r%97 == 0 ? n/2 : g()%8;
+    for (std::size_t c = 0; c != n; ++c)
+      if (g()%n < length) {
+        // Small integers keep the sums exact in any order
+        double v = static_cast<int>(g()%9) - 4;
+        columns.push_back(c);
+        values.push_back(v);
+        dense[r*n + c] = v;
+      }
+    offsets.push_back(values.size());
+  }
+  std::vector<double> x(n*k);
+  for (auto &e : x)
+    e = static_cast<int>(g()%7) - 3;
+  std::vector<double> expected(m), expected_mm(m*k);
+  for (std::size_t r = 0; r != m; ++r)
+    for (std::size_t c = 0; c != n; ++c) {
+      expected[r] += dense[r*n + c]*x[c];
+      for (std::size_t j = 0; j != k; ++j)
+        expected_mm[r*k + j] += dense[r*n + c]*x[c*k + j];
+    }
+
+  queue q;
+  sparse::csr_matrix<double> a { m, n, offsets, columns, values };
+  REQUIRE(a.get_nnz() == values.size());
+  buffer<double> xv { x.begin(), x.begin() + n };
+
+  buffer<double> y { range<1> { m } };
+  sparse::spmv(q, a, xv, y);
+  REQUIRE(content(y) == expected);
+
+  // SELL-C-sigma with a y accumulated
+  sparse::sell_matrix<double, 4> s { a, 64 };
+  std::vector<double> ones(m, 1);
+  buffer<double> z { ones.begin(), ones.end() };
+  sparse::spmv(q, s, xv, z, 2.0, 3.0);
+  auto r = content(z);
+  for (std::size_t i = 0; i != m; ++i)
+    REQUIRE(r[i] == 2*expected[i] + 3);
+
+  buffer<double> xm { x.begin(), x.end() };
+  buffer<double> ym { range<1> { m*k } };
+  sparse::spmm(q, a, xm, ym, k);
+  REQUIRE(content(ym) == expected_mm);
+}
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <array>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <type_traits>
 
@@ -77,3 +78,32 @@ TEST_CASE("partition_array works on normal host code", "[partition_array]") {
   H = toC;
   TRISYCL_CHECK(H, xilinx::partition::type::complete, ({5, 6, 7, 8}));
 }
+
+
+TEST_CASE("multidimensional partition_array", "[partition_array]") {
+  // A 4x8 matrix with its columns in 2 physical memories
+  xilinx::partition_array<Type, 4, xilinx::partition::cyclic<2, 2>, 8> M;
+  REQUIRE(M.rank == 2);
+  REQUIRE(M.size() == 32);
+  std::iota(M.begin(), M.end(), 0);
+  for (int i = 0; i != 4; ++i)
+    for (int j = 0; j != 8; ++j) {
+      REQUIRE(M(i, j) == i*8 + j);
+      REQUIRE(M[i*8 + j] == i*8 + j);
+    }
+  // On the CPU the first memory holds the even columns, as on the FPGA
+  for (int i = 0; i != 4; ++i)
+    for (int j = 0; j != 4; ++j)
+      REQUIRE(M.elems[i*4 + j] == i*8 + 2*j);
+
+  // The same layout as a 1-D array cyclically partitioned
+  xilinx::partition_array<Type, 5, xilinx::partition::cyclic<2>> C =
+    { 0, 1, 2, 3, 4 };
+  REQUIRE(std::equal(C.elems, C.elems + 3, std::array { 0, 2, 4 }.begin()));
+
+  // All the dimensions partitioned by blocks of 2x2 elements
+  xilinx::partition_array<Type, 4, xilinx::partition::block<2, 0>, 6> B;
+  std::iota(B.begin(), B.end(), 0);
+  REQUIRE(std::equal(B.elems, B.elems + 4, std::array { 0, 1, 6, 7 }.begin()));
+  REQUIRE(B(3, 5) == 23);
+}
@@ -0,0 +1,45 @@
+/* RUN: %{execute}%s
+
+   Check the accessors in atomic mode with a histogram
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <type_traits>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 10001;
+constexpr int bins = 16;
+
+TEST_CASE("parallel histogram", "[atomic]") {
+  queue q;
+  buffer<int> histogram { bins };
+  buffer<int, 2> extrema { range<2> { 1, 2 } };
+  {
+    auto h = histogram.get_access<access::mode::discard_write>();
+    std::fill(h.begin(), h.end(), 0);
+    auto e = extrema.get_access<access::mode::discard_write>();
+    e[0][0] = n;
+    e[0][1] = 0;
+  }
+  q.submit([&](handler &cgh) {
+      auto h = histogram.get_access<access::mode::atomic>(cgh);
+      auto e = extrema.get_access<access::mode::atomic>(cgh);
+      STATIC_REQUIRE(std::is_same_v<decltype(h[0]),
+                                    decltype(h)::atomic_reference>);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          h[i[0] % bins].fetch_add(1);
+          e[0, 0].fetch_min(i[0]);
+          e[id<2> { 0, 1 }].fetch_max(i[0]);
+        });
+    });
+  auto h = histogram.get_access<access::mode::read>();
+  for (int b = 0; b < bins; ++b)
+    REQUIRE(h[b] == n/bins + (b < n % bins));
+  auto e = extrema.get_access<access::mode::read>();
+  REQUIRE(e[0][0] == 0);
+  REQUIRE(e[0][1] == n - 1);
+}
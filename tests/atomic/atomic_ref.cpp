@@ -0,0 +1,59 @@
+/* RUN: %{execute}%s
+
+   Check the atomic references
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+template <typename T>
+using relaxed_ref = atomic_ref<T, memory_order::relaxed, memory_scope::device>;
+
+TEST_CASE("atomic operations", "[atomic]") {
+  int i = 5;
+  relaxed_ref<int> r { i };
+  REQUIRE(r.fetch_add(3) == 5);
+  REQUIRE(r.fetch_sub(1) == 8);
+  REQUIRE(r.fetch_min(10) == 7);
+  REQUIRE(r.load() == 7);
+  REQUIRE(r.fetch_min(2) == 7);
+  REQUIRE(r.fetch_max(9, memory_order::acq_rel) == 2);
+  REQUIRE(r.fetch_or(6) == 9);
+  REQUIRE(r.fetch_and(3) == 15);
+  REQUIRE(r.fetch_xor(1) == 3);
+  REQUIRE(r.exchange(40) == 2);
+  int expected = 41;
+  REQUIRE(!r.compare_exchange_strong(expected, 0));
+  REQUIRE(expected == 40);
+  REQUIRE(r.compare_exchange_strong(expected, 41, memory_order::acq_rel,
+                                    memory_order::acquire));
+  REQUIRE(++r == 42);
+  r = 1;
+  r += 2;
+  REQUIRE(i == 3);
+
+  float f = 1.5f;
+  atomic_ref<float, memory_order::seq_cst, memory_scope::system> rf { f };
+  REQUIRE(rf.fetch_add(1) == 1.5f);
+  REQUIRE(rf.fetch_max(0) == 2.5f);
+  REQUIRE(f == 2.5f);
+}
+
+TEST_CASE("concurrent atomic updates in a kernel", "[atomic]") {
+  constexpr int n = 10000;
+  queue q;
+  auto sum = malloc_shared<long>(1, q);
+  auto low = malloc_shared<int>(1, q);
+  *sum = 0;
+  *low = n;
+  q.parallel_for(range<1> { n }, [=](id<1> i) {
+      relaxed_ref<long> { *sum } += i[0];
+      relaxed_ref<int> { *low }.fetch_min(n - 1 - i[0]);
+    }).wait();
+  REQUIRE(*sum == long(n)*(n - 1)/2);
+  REQUIRE(*low == 0);
+  free(sum, q);
+  free(low, q);
+}
@@ -0,0 +1,178 @@
+/* The cost of the work-group barriers and of the local memory with
+   various work-group sizes
+
+   Each kernel is run with work-groups of 16 to 1024 work-items and
+   reports its time per work-group. The barriers of nd_item are
+   executed with 1 OpenMP thread per work-item, or with 1 fiber per
+   work-item when compiled with TRISYCL_WORK_ITEM_FIBERS, as done by
+   the benchmarks_barriers_fibers target, to compare both engines.
+*/
+#include <CL/sycl.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_result.hpp"
+
+using namespace cl::sycl;
+
+using Type = float;
+
+/// The engine executing the work-items of an nd_range
+constexpr auto engine =
+#if defined(TRISYCL_WORK_ITEM_FIBERS) && !defined(TRISYCL_NO_BARRIER)
+  "fibers";
+#elif defined(_OPENMP)
+  "OpenMP";
+#else
+  "serial";
+#endif
+
+/// The number of timed runs of each kernel, after a warm-up run
+constexpr int samples = 5;
+
+
+/** Time a kernel and report its mean time per work-group
+
+    \param[in] run submits the kernel and waits for it
+*/
+template <typename Run>
+void report(const std::string &name, std::size_t group_size,
+            std::size_t groups, Run run) {
+  using clk = std::chrono::steady_clock;
+  run();
+  auto start = clk::now();
+  for (int s = 0; s != samples; ++s)
+    run();
+  std::chrono::duration<double, std::micro> d = clk::now() - start;
+  auto per_group = d.count()/samples/groups;
+  std::cout << std::setw(8) << engine << std::setw(26) << name
+            << std::setw(6) << group_size << " work-items"
+            << std::fixed << std::setprecision(3)
+            << std::setw(12) << per_group << " us/work-group" << std::endl;
+  benchmark_result(std::string { engine } + " " + name + " "
+                   + std::to_string(group_size) + " work-items",
+                   per_group, "us/work-group", false);
+}
+
+
+/// A tree reduction in local memory with a barrier at each level
+void benchmark_reduction(queue &q, std::size_t group_size) {
+  constexpr std::size_t n = 1 << 16;
+  buffer<Type> in { n }, sums { n/group_size };
+  report("local reduction", group_size, n/group_size, [&] {
+      q.submit([&] (handler &cgh) {
+          auto a_in = in.get_access<access::mode::read>(cgh);
+          auto a_sums = sums.get_access<access::mode::discard_write>(cgh);
+          accessor<Type, 1, access::mode::read_write, access::target::local>
+            scratch { group_size, cgh };
+          cgh.parallel_for<class local_reduction>(
+            nd_range<1> { n, group_size },
+            [=] (nd_item<1> i) {
+              auto l = i.get_local_id(0);
+              scratch[l] = a_in[i.get_global_id()];
+              for (auto stride = group_size/2; stride > 0; stride /= 2) {
+                i.barrier(access::fence_space::local_space);
+                if (l < stride)
+                  scratch[l] += scratch[l + stride];
+              }
+              if (l == 0)
+                a_sums[i.get_group(0)] = scratch[0];
+            });
+        });
+      q.wait();
+    });
+}
+
+
+/** A matrix multiplication with square tiles of tile*tile work-items
+    cached in local memory between some barriers
+*/
+void benchmark_tiled_matmul(queue &q, std::size_t tile) {
+  constexpr std::size_t n = 256;
+  buffer<Type, 2> a { range<2> { n, n } }, b { range<2> { n, n } },
+    c { range<2> { n, n } };
+  report("tiled matmul", tile*tile, n/tile*n/tile, [&] {
+      q.submit([&] (handler &cgh) {
+          auto a_a = a.get_access<access::mode::read>(cgh);
+          auto a_b = b.get_access<access::mode::read>(cgh);
+          auto a_c = c.get_access<access::mode::discard_write>(cgh);
+          accessor<Type, 2, access::mode::read_write, access::target::local>
+            t_a { range<2> { tile, tile }, cgh },
+            t_b { range<2> { tile, tile }, cgh };
+          cgh.parallel_for<class tiled_matmul>(
+            nd_range<2> { { n, n }, { tile, tile } },
+            [=] (nd_item<2> i) {
+              auto row = i.get_global_id(0);
+              auto col = i.get_global_id(1);
+              auto l_row = i.get_local_id(0);
+              auto l_col = i.get_local_id(1);
+              Type sum = 0;
+              for (std::size_t k = 0; k < n; k += tile) {
+                t_a[l_row][l_col] = a_a[row][k + l_col];
+                t_b[l_row][l_col] = a_b[k + l_row][col];
+                i.barrier(access::fence_space::local_space);
+                for (std::size_t kk = 0; kk != tile; ++kk)
+                  sum += t_a[l_row][kk]*t_b[kk][l_col];
+                i.barrier(access::fence_space::local_space);
+              }
+              a_c[row][col] = sum;
+            });
+        });
+      q.wait();
+    });
+}
+
+
+/** A convolution with its coefficients cached in local memory, in the
+    style of tests/accessor/local_accessor_hierarchical_convolution.cpp
+*/
+void benchmark_convolution(queue &q, std::size_t group_size) {
+  constexpr std::size_t n = 1 << 16;
+  constexpr std::size_t taps = 3;
+  buffer<Type> in { n + taps - 1 }, coefficients { taps }, out { n };
+  report("hierarchical convolution", group_size, n/group_size, [&] {
+      q.submit([&] (handler &cgh) {
+          auto a_in = in.get_access<access::mode::read>(cgh);
+          auto a_coefficients =
+            coefficients.get_access<access::mode::read>(cgh);
+          auto a_out = out.get_access<access::mode::discard_write>(cgh);
+          accessor<Type, 1, access::mode::read_write, access::target::local>
+            cache { taps, cgh };
+          cgh.parallel_for_work_group<class hierarchical_convolution>(
+            range<1> { n/group_size }, range<1> { group_size },
+            [=] (group<1> g) {
+              g.parallel_for_work_item([&] (h_item<1> i) {
+                  if (i.get_local_id(0) < taps)
+                    cache[i.get_local_id(0)] =
+                      a_coefficients[i.get_local_id(0)];
+                });
+              // An implicit barrier happens here
+              g.parallel_for_work_item([&] (h_item<1> i) {
+                  Type sum = 0;
+                  for (std::size_t j = 0; j != taps; ++j)
+                    sum += a_in[i.get_global_id(0) + j]*cache[j];
+                  a_out[i.get_global_id()] = sum;
+                });
+            });
+        });
+      q.wait();
+    });
+}
+
+
+TEST_CASE("barriers and local memory", "[benchmark]") {
+  queue q;
+  for (std::size_t group_size = 16; group_size <= 1024; group_size *= 2)
+    benchmark_reduction(q, group_size);
+  // Work-groups of 16, 64, 256 and 1024 work-items
+  for (std::size_t tile = 4; tile <= 32; tile *= 2)
+    benchmark_tiled_matmul(q, tile);
+  for (std::size_t group_size = 16; group_size <= 1024; group_size *= 2)
+    benchmark_convolution(q, group_size);
+}
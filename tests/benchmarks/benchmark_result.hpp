@@ -0,0 +1,30 @@
+#ifndef TRISYCL_TESTS_BENCHMARKS_BENCHMARK_RESULT_HPP
+#define TRISYCL_TESTS_BENCHMARKS_BENCHMARK_RESULT_HPP
+
+/* Print a benchmark result as a JSON line, collected by regression.py
+   to compare the runs against a baseline
+*/
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+/** Print the \p value of a metric
+
+    \param[in] higher_is_better tells in which direction a change is a
+    regression
+*/
+inline void benchmark_result(const std::string &name, double value,
+                             const std::string &unit,
+                             bool higher_is_better) {
+  // Not affected by the formatting of the human-readable output
+  std::ostringstream line;
+  line.precision(std::numeric_limits<double>::max_digits10);
+  line << "{\"benchmark\": \"" << name << "\", \"value\": " << value
+       << ", \"unit\": \"" << unit << "\", \"higher_is_better\": "
+       << (higher_is_better ? "true" : "false") << "}";
+  std::cout << line.str() << std::endl;
+}
+
+#endif // TRISYCL_TESTS_BENCHMARKS_BENCHMARK_RESULT_HPP
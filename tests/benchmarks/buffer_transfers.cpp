@@ -0,0 +1,156 @@
+/* The data transfers keeping the buffers coherent between the host
+   and some OpenCL devices
+
+   Each access pattern reports the bytes moved in each direction, the
+   transfers avoided since a context had already the most recent data,
+   and the end-to-end time, as accounted by
+   vendor::trisycl::data_transfers.
+*/
+#include <boost/compute.hpp>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/data_transfers.hpp>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_result.hpp"
+
+using namespace cl::sycl;
+
+using accounting = vendor::trisycl::data_transfers;
+
+/// The number of elements of the buffers
+constexpr std::size_t n = 1 << 22;
+
+/// The number of repetitions of each access pattern
+constexpr int iterations = 16;
+
+
+/// Build an OpenCL kernel incrementing the elements of a buffer
+kernel increment(const boost::compute::context &ctx) {
+  auto program = boost::compute::program::create_with_source(R"(
+    __kernel void increment(__global float *a) {
+      a[get_global_id(0)] += 1;
+    }
+    )", ctx);
+  program.build();
+  return boost::compute::kernel { program, "increment" };
+}
+
+
+/// Build an OpenCL kernel reading a buffer and writing another one
+kernel copy(const boost::compute::context &ctx) {
+  auto program = boost::compute::program::create_with_source(R"(
+    __kernel void copy(const __global float *a, __global float *b) {
+      b[get_global_id(0)] = a[get_global_id(0)];
+    }
+    )", ctx);
+  program.build();
+  return boost::compute::kernel { program, "copy" };
+}
+
+
+/** Run an access pattern and report its transfers in the contexts of
+    the queues and its end-to-end time
+*/
+template <typename Pattern>
+void report(const std::string &name, std::initializer_list<queue *> queues,
+            Pattern pattern) {
+  auto &d = accounting::instance();
+  d.reset();
+  auto start = std::chrono::steady_clock::now();
+  pattern();
+  for (auto q : queues)
+    q->wait();
+  std::chrono::duration<double, std::milli> time =
+    std::chrono::steady_clock::now() - start;
+  accounting::statistics total;
+  for (auto q : queues) {
+    auto s = d.get_statistics(q->get_context());
+    total.host_to_device.bytes += s.host_to_device.bytes;
+    total.device_to_host.bytes += s.device_to_host.bytes;
+    total.device_to_device.bytes += s.device_to_device.bytes;
+    total.avoided += s.avoided;
+    total.avoided_bytes += s.avoided_bytes;
+  }
+  std::cout << std::left << std::setw(24) << name << std::right
+            << " host->device " << std::setw(10)
+            << total.host_to_device.bytes
+            << " B, device->host " << std::setw(10)
+            << total.device_to_host.bytes
+            << " B, device->device " << std::setw(10)
+            << total.device_to_device.bytes
+            << " B, avoided " << total.avoided << " ("
+            << total.avoided_bytes << " B), "
+            << std::fixed << std::setprecision(2) << time.count() << " ms"
+            << std::endl;
+  benchmark_result(name + " bytes transferred",
+                   total.host_to_device.bytes + total.device_to_host.bytes
+                   + total.device_to_device.bytes, "B", false);
+  benchmark_result(name + " time", time.count(), "ms", false);
+}
+
+
+TEST_CASE("buffer transfers on OpenCL devices", "[benchmark]") {
+  auto device = boost::compute::system::default_device();
+  // 2 contexts on the default device to have some migrations
+  boost::compute::context ctx1 { device }, ctx2 { device };
+  queue q1 { boost::compute::command_queue { ctx1, device } };
+  queue q2 { boost::compute::command_queue { ctx2, device } };
+  auto increment1 = increment(ctx1);
+  auto increment2 = increment(ctx2);
+  auto copy1 = copy(ctx1);
+
+  buffer<float> a { n }, b { n };
+  // Start from some data on the host
+  a.get_access<access::mode::discard_write>()[0] = 0;
+
+  report("read-only reuse", { &q1 }, [&] {
+      for (int i = 0; i != iterations; ++i)
+        q1.submit([&] (handler &cgh) {
+            cgh.set_args(a.get_access<access::mode::read>(cgh),
+                         b.get_access<access::mode::discard_write>(cgh));
+            cgh.parallel_for(n, copy1);
+          });
+    });
+
+  report("host-device ping-pong", { &q1 }, [&] {
+      for (int i = 0; i != iterations; ++i) {
+        q1.submit([&] (handler &cgh) {
+            cgh.set_args(a.get_access<access::mode::read_write>(cgh));
+            cgh.parallel_for(n, increment1);
+          });
+        a.get_access<access::mode::read_write>()[0] += 1;
+      }
+    });
+
+  report("discard_write", { &q1 }, [&] {
+      for (int i = 0; i != iterations; ++i) {
+        q1.submit([&] (handler &cgh) {
+            cgh.set_args(a.get_access<access::mode::read>(cgh),
+                         b.get_access<access::mode::discard_write>(cgh));
+            cgh.parallel_for(n, copy1);
+          });
+        // The host overwrites the whole buffer without reading it back
+        b.get_access<access::mode::discard_write>()[0] = 0;
+      }
+    });
+
+  report("device-device migration", { &q1, &q2 }, [&] {
+      for (int i = 0; i != iterations; ++i) {
+        q1.submit([&] (handler &cgh) {
+            cgh.set_args(a.get_access<access::mode::read_write>(cgh));
+            cgh.parallel_for(n, increment1);
+          });
+        q2.submit([&] (handler &cgh) {
+            cgh.set_args(a.get_access<access::mode::read_write>(cgh));
+            cgh.parallel_for(n, increment2);
+          });
+      }
+    });
+}
@@ -0,0 +1,97 @@
+#! /usr/bin/env python3
+"""Measure the time to parse the triSYCL headers
+
+Each case is a translation unit including only some headers, compiled
+with -fsyntax-only --repetitions times by the compiler given after
+"--" with its options, typically the include directories and the
+definitions of a triSYCL target. The median time of each case is
+printed as a JSON line, like the ones of benchmark_result(), so the
+header parse cost can be tracked over the changes.
+
+With Clang, --time-trace DIRECTORY also keeps the -ftime-trace report
+of each case, to see in chrome://tracing or https://ui.perfetto.dev
+which headers and templates cost the most.
+
+Typical use:
+
+  compile_time.py -- g++ -std=c++23 -Iinclude -I... -DTRISYCL_OPENCL
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+# The cases as name: (source, extra compiler options)
+CASES = {
+    "CL/sycl.hpp": ("#include <CL/sycl.hpp>\n", []),
+    "CL/sycl.hpp without extensions": (
+        "#include <CL/sycl.hpp>\n", ["-DTRISYCL_NO_EXTENSIONS"]),
+    "sycl/sycl.hpp": ("#include <sycl/sycl.hpp>\n", []),
+    # The main third-party dependencies alone, to see what remains of
+    # the cost of triSYCL itself
+    "mdspan": ("#include <experimental/mdspan>\n", []),
+    "range-v3 used parts": ("#include <range/v3/algorithm/copy.hpp>\n"
+                            "#include <range/v3/range/conversion.hpp>\n"
+                            "#include <range/v3/view/iota.hpp>\n"
+                            "#include <range/v3/view/transform.hpp>\n", []),
+    "Boost.Fiber used parts": ("#include <boost/fiber/buffered_channel.hpp>\n"
+                               "#include <boost/fiber/mutex.hpp>\n"
+                               "#include <boost/fiber/operations.hpp>\n", []),
+}
+
+
+def compile_time(compiler, source, options, trace):
+    """Return the time in s to parse a source"""
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, "case.cpp")
+        with open(path, "w") as f:
+            f.write(source)
+        command = compiler + options + ["-fsyntax-only", path]
+        if trace:
+            command += ["-ftime-trace"]
+        start = time.perf_counter()
+        subprocess.run(command, check=True, cwd=directory)
+        elapsed = time.perf_counter() - start
+        if trace:
+            # Clang puts the report next to the output, so in the
+            # current directory with -fsyntax-only
+            for name in os.listdir(directory):
+                if name.endswith(".json"):
+                    shutil.copy(os.path.join(directory, name), trace)
+        return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--repetitions", type=int, default=5,
+                        help="the number of compilations of each case")
+    parser.add_argument("--time-trace", metavar="DIRECTORY",
+                        help="keep the Clang -ftime-trace reports there")
+    parser.add_argument("compiler", nargs="+",
+                        help="the compiler and its options, after --")
+    args = parser.parse_args()
+
+    for name, (source, options) in CASES.items():
+        trace = None
+        if args.time_trace:
+            trace = os.path.join(args.time_trace,
+                                 name.replace("/", "_").replace(" ", "_")
+                                 + ".json")
+        times = [compile_time(args.compiler, source, options, trace)
+                 for _ in range(args.repetitions)]
+        median = statistics.median(times)
+        print("{:<36}{:8.3f} s".format(name, median), file=sys.stderr)
+        print(json.dumps({ "benchmark": "parse " + name, "value": median,
+                           "unit": "s", "higher_is_better": False }))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,176 @@
+/* The scalability of the runtime when several application threads
+   submit some kernels at the same time
+
+   The number of submitting threads goes from 1 to twice the number of
+   cores, submitting into a single shared queue or into one queue per
+   thread, with private or shared buffers, to see where the locks of
+   the runtime, such as the ones of the queues and of the buffers,
+   stop scaling. Each configuration reports the submit throughput and
+   some percentiles of the time spent in a submit. With OpenCL, the
+   lookup of the triSYCL objects wrapping the OpenCL ones is measured
+   too.
+*/
+#ifdef TRISYCL_OPENCL
+#include <boost/compute.hpp>
+#endif
+
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_result.hpp"
+
+using namespace cl::sycl;
+
+using clk = std::chrono::steady_clock;
+
+/// The number of submits by each thread
+constexpr int submits = 1000;
+
+
+/// Display the throughput and the latency percentiles of a configuration
+void report(const std::string &name, unsigned threads, clk::duration total,
+            std::vector<double> latencies) {
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&] (double p) {
+    return latencies[static_cast<std::size_t>(p*(latencies.size() - 1))];
+  };
+  auto seconds = std::chrono::duration<double> { total }.count();
+  auto full_name = name + " " + std::to_string(threads) + " threads";
+  std::cout << std::left << std::setw(40) << full_name << std::right
+            << std::fixed << std::setprecision(0)
+            << std::setw(10) << latencies.size()/seconds << " op/s"
+            << "  latency ns p50 " << percentile(.5)
+            << " p99 " << percentile(.99)
+            << " max " << latencies.back() << std::endl;
+  benchmark_result(full_name + " throughput", latencies.size()/seconds,
+                   "op/s", true);
+  benchmark_result(full_name + " p99 latency", percentile(.99), "ns",
+                   false);
+}
+
+
+/** Run some threads at the same time and report their throughput and
+    latency
+
+    \param[in] submit is called with the thread number and does the
+    operation to time, typically a submit
+
+    \param[in] finish is called at the end to wait for the kernels
+*/
+template <typename Submit, typename Finish>
+void run(const std::string &name, unsigned threads, Submit submit,
+         Finish finish) {
+  std::vector<std::vector<double>> latencies(threads);
+  std::barrier start_line { static_cast<std::ptrdiff_t>(threads) + 1 };
+  std::vector<std::thread> submitters;
+  for (unsigned t = 0; t != threads; ++t)
+    submitters.emplace_back([&, t] {
+        latencies[t].reserve(submits);
+        start_line.arrive_and_wait();
+        for (int i = 0; i != submits; ++i) {
+          auto start = clk::now();
+          submit(t);
+          latencies[t].push_back(std::chrono::duration<double, std::nano>
+                                 { clk::now() - start }.count());
+        }
+      });
+  // Start the clock when all the threads are ready
+  start_line.arrive_and_wait();
+  auto start = clk::now();
+  for (auto &s : submitters)
+    s.join();
+  finish();
+  auto total = clk::now() - start;
+  std::vector<double> all;
+  for (auto &l : latencies)
+    all.insert(all.end(), l.begin(), l.end());
+  report(name, threads, total, std::move(all));
+}
+
+
+/// Submit a kernel writing into a buffer
+void write_kernel(queue &q, buffer<int> &b) {
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task<class write_kernel>([=] { a[0] = 1; });
+    });
+}
+
+
+/// Submit a kernel reading a buffer
+void read_kernel(queue &q, buffer<int> &b) {
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::read>(cgh);
+      cgh.single_task<class read_kernel>([=] { static_cast<void>(a[0]); });
+    });
+}
+
+
+TEST_CASE("concurrent submitters", "[benchmark]") {
+  auto cores = std::max(1U, std::thread::hardware_concurrency());
+  std::vector<unsigned> thread_numbers;
+  for (unsigned t = 1; t < 2*cores; t *= 2)
+    thread_numbers.push_back(t);
+  thread_numbers.push_back(2*cores);
+
+  for (auto threads : thread_numbers) {
+    // Contention on the queue only
+    {
+      queue q;
+      // Not a vector of copies, which would share the same buffer
+      std::vector<buffer<int>> b;
+      for (unsigned t = 0; t != threads; ++t)
+        b.push_back(buffer<int> { 1 });
+      run("shared queue", threads,
+          [&] (unsigned t) { write_kernel(q, b[t]); },
+          [&] { q.wait(); });
+    }
+    // No contention in the application
+    {
+      std::vector<queue> q;
+      std::vector<buffer<int>> b;
+      for (unsigned t = 0; t != threads; ++t) {
+        q.push_back(queue {});
+        b.push_back(buffer<int> { 1 });
+      }
+      run("queue per thread", threads,
+          [&] (unsigned t) { write_kernel(q[t], b[t]); },
+          [&] { for (auto &e : q) e.wait(); });
+    }
+    // Contention on the buffer only, with readers not depending on
+    // each other
+    {
+      std::vector<queue> q;
+      for (unsigned t = 0; t != threads; ++t)
+        q.push_back(queue {});
+      buffer<int> b { 1 };
+      run("shared read buffer", threads,
+          [&] (unsigned t) { read_kernel(q[t], b); },
+          [&] { for (auto &e : q) e.wait(); });
+    }
+#ifdef TRISYCL_OPENCL
+    // Contention on the caches mapping the OpenCL objects to the
+    // triSYCL ones
+    {
+      auto cq = boost::compute::system::default_queue();
+      run("OpenCL queue lookup", threads,
+          [&] (unsigned) {
+            queue q { cq };
+            static_cast<void>(q.get_context());
+          },
+          [] {});
+    }
+#endif
+  }
+}
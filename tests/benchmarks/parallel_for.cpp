@@ -0,0 +1,199 @@
+/* The memory bandwidth reached by some usual kernels launched through
+   the various forms of parallel_for
+
+   The backend is the one triSYCL is configured with, so build the
+   benchmark with TRISYCL_OPENMP, TRISYCL_TBB and TRISYCL_WORK_STEALING
+   on or off to compare the serial, OpenMP, TBB and work-stealing
+   backends.
+*/
+#include <CL/sycl.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_result.hpp"
+
+using namespace cl::sycl;
+
+using Type = float;
+
+/// The backend executing the kernels
+constexpr auto backend =
+#if defined(TRISYCL_WORK_STEALING)
+  "work stealing";
+#elif defined(TRISYCL_TBB)
+  "TBB";
+#elif defined(_OPENMP)
+  "OpenMP";
+#else
+  "serial";
+#endif
+
+/// The forms of parallel_for to compare
+enum class form { range, item, nd_range, hierarchical };
+
+const char *form_names[] = { "range", "item", "nd_range", "hierarchical" };
+
+
+/// The work-group size used by the forms needing one
+template <int Dims>
+range<Dims> local_size() {
+  if constexpr (Dims == 1)
+    return { 256 };
+  else if constexpr (Dims == 2)
+    return { 16, 16 };
+  else
+    return { 8, 8, 8 };
+}
+
+
+/** Launch a kernel taking only the global id of its work-items with
+    some form of parallel_for
+*/
+template <form Form, int Dims, typename Kernel>
+void parallel_for_with(handler &cgh, range<Dims> r, Kernel k) {
+  if constexpr (Form == form::range)
+    cgh.parallel_for(r, [=] (id<Dims> i) { k(i); });
+  else if constexpr (Form == form::item)
+    cgh.parallel_for(r, [=] (item<Dims> i) { k(i.get_id()); });
+  else if constexpr (Form == form::nd_range)
+    cgh.parallel_for(nd_range<Dims> { r, local_size<Dims>() },
+                     [=] (nd_item<Dims> i) { k(i.get_global_id()); });
+  else
+    cgh.parallel_for_work_group(r/local_size<Dims>(), local_size<Dims>(),
+                                [=] (group<Dims> g) {
+        g.parallel_for_work_item([&] (h_item<Dims> i) {
+            k(i.get_global_id());
+          });
+      });
+}
+
+
+/** Time a kernel over some samples and report its bandwidth with the
+    95% confidence interval of the mean
+
+    \param[in] bytes is the number of bytes read and written by a run
+
+    \param[in] run submits the kernel and waits for it
+*/
+template <typename Run>
+void report(const std::string &name, form f, double bytes, Run run) {
+  using clk = std::chrono::steady_clock;
+  constexpr int samples = 20;
+  // Warm up the caches, the threads and the buffers
+  run();
+  std::vector<double> bandwidths;
+  for (int s = 0; s != samples; ++s) {
+    auto start = clk::now();
+    run();
+    std::chrono::duration<double> d = clk::now() - start;
+    bandwidths.push_back(bytes/d.count()/1e9);
+  }
+  double mean = 0;
+  for (auto b : bandwidths)
+    mean += b;
+  mean /= samples;
+  double variance = 0;
+  for (auto b : bandwidths)
+    variance += (b - mean)*(b - mean);
+  variance /= samples - 1;
+  // The Student t value for 19 degrees of freedom
+  auto half_width = 2.093*std::sqrt(variance/samples);
+  std::cout << std::setw(8) << backend << std::setw(10) << name
+            << std::setw(14) << form_names[static_cast<int>(f)]
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << mean << " GB/s +/- " << half_width
+            << std::endl;
+  benchmark_result(std::string { backend } + " " + name + " "
+                   + form_names[static_cast<int>(f)], mean, "GB/s", true);
+}
+
+
+/// Benchmark the kernels with one form of parallel_for
+template <form Form>
+void benchmark(queue &q) {
+  constexpr std::size_t n1 = 1 << 22;
+  buffer<Type> a { n1 }, b { n1 }, c { n1 };
+
+  report("copy", Form, 2.*n1*sizeof(Type), [&] {
+      q.submit([&] (handler &cgh) {
+          auto a_a = a.get_access<access::mode::discard_write>(cgh);
+          auto a_b = b.get_access<access::mode::read>(cgh);
+          parallel_for_with<Form>(cgh, range<1> { n1 },
+                                  [=] (id<1> i) { a_a[i] = a_b[i]; });
+        });
+      q.wait();
+    });
+
+  report("triad", Form, 3.*n1*sizeof(Type), [&] {
+      q.submit([&] (handler &cgh) {
+          auto a_a = a.get_access<access::mode::discard_write>(cgh);
+          auto a_b = b.get_access<access::mode::read>(cgh);
+          auto a_c = c.get_access<access::mode::read>(cgh);
+          parallel_for_with<Form>(cgh, range<1> { n1 }, [=] (id<1> i) {
+              a_a[i] = a_b[i] + 3*a_c[i];
+            });
+        });
+      q.wait();
+    });
+
+  constexpr std::size_t n2 = 2048;
+  buffer<Type, 2> in2 { range<2> { n2, n2 } }, out2 { range<2> { n2, n2 } };
+
+  report("stencil2d", Form, 2.*n2*n2*sizeof(Type), [&] {
+      q.submit([&] (handler &cgh) {
+          auto in = in2.get_access<access::mode::read>(cgh);
+          auto out = out2.get_access<access::mode::discard_write>(cgh);
+          parallel_for_with<Form>(cgh, range<2> { n2, n2 }, [=] (id<2> i) {
+              if (i[0] == 0 || i[0] == n2 - 1 || i[1] == 0 || i[1] == n2 - 1)
+                out[i] = in[i];
+              else
+                out[i] = (4*in[i] + in[i - id<2> { 1, 0 }]
+                          + in[i + id<2> { 1, 0 }] + in[i - id<2> { 0, 1 }]
+                          + in[i + id<2> { 0, 1 }])/8;
+            });
+        });
+      q.wait();
+    });
+
+  constexpr std::size_t n3 = 128;
+  buffer<Type, 3> in3 { range<3> { n3, n3, n3 } },
+    out3 { range<3> { n3, n3, n3 } };
+
+  report("stencil3d", Form, 2.*n3*n3*n3*sizeof(Type), [&] {
+      q.submit([&] (handler &cgh) {
+          auto in = in3.get_access<access::mode::read>(cgh);
+          auto out = out3.get_access<access::mode::discard_write>(cgh);
+          parallel_for_with<Form>(cgh, range<3> { n3, n3, n3 },
+                                  [=] (id<3> i) {
+              if (i[0] == 0 || i[0] == n3 - 1 || i[1] == 0 || i[1] == n3 - 1
+                  || i[2] == 0 || i[2] == n3 - 1)
+                out[i] = in[i];
+              else
+                out[i] = (6*in[i]
+                          + in[i - id<3> { 1, 0, 0 }]
+                          + in[i + id<3> { 1, 0, 0 }]
+                          + in[i - id<3> { 0, 1, 0 }]
+                          + in[i + id<3> { 0, 1, 0 }]
+                          + in[i - id<3> { 0, 0, 1 }]
+                          + in[i + id<3> { 0, 0, 1 }])/12;
+            });
+        });
+      q.wait();
+    });
+}
+
+
+TEST_CASE("parallel_for bandwidth", "[benchmark]") {
+  queue q;
+  benchmark<form::range>(q);
+  benchmark<form::item>(q);
+  benchmark<form::nd_range>(q);
+  benchmark<form::hierarchical>(q);
+}
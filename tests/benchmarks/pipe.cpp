@@ -0,0 +1,239 @@
+/* The throughput and the latency of the SYCL 2.2 pipes, derived from
+   the producer-consumer tests of tests/sycl_2_2_pipe
+
+   Each configuration streams some elements from a producer kernel to
+   a consumer kernel, possibly through some forwarding kernels, and
+   reports the elements/s, the bytes/s and some percentiles of the
+   time spent by an element between its write and its read. The
+   throughput of a pipe shared by several producer and consumer
+   kernels is measured too.
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "benchmark_result.hpp"
+
+using namespace cl::sycl;
+
+using clk = std::chrono::steady_clock;
+
+/// The number of elements streamed by each configuration
+constexpr std::size_t n = 1 << 16;
+
+/// An element of Bytes bytes
+template <std::size_t Bytes>
+struct element {
+  std::array<std::byte, Bytes> payload;
+};
+
+
+/// Display the throughput and the latency percentiles of a run
+void report(const std::string &name, std::size_t element_size,
+            clk::duration total,
+            const std::vector<clk::time_point> &sent,
+            const std::vector<clk::time_point> &received) {
+  std::vector<double> latencies;
+  for (std::size_t i = 0; i != n; ++i)
+    latencies.push_back(std::chrono::duration<double, std::nano>
+                        { received[i] - sent[i] }.count());
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&] (double p) {
+    return latencies[static_cast<std::size_t>(p*(n - 1))];
+  };
+  auto seconds = std::chrono::duration<double> { total }.count();
+  std::cout << std::left << std::setw(44) << name << std::right
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << n/seconds/1e6 << " Melt/s"
+            << std::setw(10) << n*element_size/seconds/1e6 << " MB/s"
+            << std::setprecision(0)
+            << "  latency ns p50 " << percentile(.5)
+            << " p90 " << percentile(.9)
+            << " p99 " << percentile(.99)
+            << " max " << latencies.back() << std::endl;
+  benchmark_result(name + " throughput", n/seconds, "element/s", true);
+  benchmark_result(name + " p50 latency", percentile(.5), "ns", false);
+}
+
+
+/** Stream the elements through a chain of pipes, with a kernel
+    forwarding the elements between 2 consecutive pipes
+
+    \param[in] chunk is the number of elements written and read per
+    reservation, or 0 to access the elements one by one
+*/
+template <access::target Target, typename Pipe>
+void run(const std::string &name, std::vector<Pipe *> pipes,
+         std::size_t chunk = 0) {
+  using T = typename Pipe::value_type;
+  std::vector<clk::time_point> sent(n), received(n);
+  auto s = sent.data();
+  auto r = received.data();
+  auto start = clk::now();
+  {
+    queue q;
+    q.submit([&] (handler &cgh) {
+        auto out = pipes.front()->template
+          get_access<access::mode::write, Target>(cgh);
+        cgh.single_task([=] {
+            T e {};
+            if (chunk)
+              for (std::size_t i = 0; i != n; i += chunk) {
+                for (;;) {
+                  auto reservation = out.reserve(chunk);
+                  if (reservation) {
+                    for (auto &x : reservation)
+                      x = e;
+                    break;
+                  }
+                }
+                // The reservation is committed here
+                std::fill(s + i, s + i + chunk, clk::now());
+              }
+            else
+              for (std::size_t i = 0; i != n; ++i) {
+                while (!out.write(e))
+                  ;
+                s[i] = clk::now();
+              }
+          });
+      });
+    for (std::size_t p = 1; p != pipes.size(); ++p)
+      q.submit([&] (handler &cgh) {
+          auto in = pipes[p - 1]->template
+            get_access<access::mode::read, Target>(cgh);
+          auto out = pipes[p]->template
+            get_access<access::mode::write, Target>(cgh);
+          cgh.single_task([=] {
+              for (std::size_t i = 0; i != n; ++i) {
+                T e;
+                while (!in.read(e))
+                  ;
+                while (!out.write(e))
+                  ;
+              }
+            });
+        });
+    q.submit([&] (handler &cgh) {
+        auto in = pipes.back()->template
+          get_access<access::mode::read, Target>(cgh);
+        cgh.single_task([=] {
+            if (chunk)
+              for (std::size_t i = 0; i != n; i += chunk) {
+                for (;;) {
+                  auto reservation = in.reserve(chunk);
+                  if (reservation) {
+                    T e;
+                    for (auto &x : reservation)
+                      e = x;
+                    break;
+                  }
+                }
+                std::fill(r + i, r + i + chunk, clk::now());
+              }
+            else
+              for (std::size_t i = 0; i != n; ++i) {
+                T e;
+                while (!in.read(e))
+                  ;
+                r[i] = clk::now();
+              }
+          });
+      });
+    /* The tasks keep the queue alive, so its destruction would not
+       wait for the kernels */
+    q.wait();
+  }
+  report(name, sizeof(T), clk::now() - start, sent, received);
+}
+
+
+/// Benchmark the pipes of some elements of Bytes bytes
+template <std::size_t Bytes>
+void benchmark_element() {
+  using T = element<Bytes>;
+  auto size = std::to_string(Bytes) + "B";
+  for (std::size_t capacity : { 1, 16, 256 }) {
+    auto suffix = " " + size + " capacity " + std::to_string(capacity);
+    sycl_2_2::pipe<T> p { capacity };
+    run<access::target::pipe>("pipe" + suffix, std::vector { &p });
+    run<access::target::blocking_pipe>("blocking pipe" + suffix,
+                                       std::vector { &p });
+    // A chain of 4 kernels connected by 3 pipes
+    sycl_2_2::pipe<T> p2 { capacity }, p3 { capacity };
+    run<access::target::pipe>("3-pipe chain" + suffix,
+                              std::vector { &p, &p2, &p3 });
+    run<access::target::blocking_pipe>("blocking 3-pipe chain" + suffix,
+                                       std::vector { &p, &p2, &p3 });
+  }
+  // Reservations need some room for the chunks
+  sycl_2_2::pipe<T> p { 256 };
+  run<access::target::pipe>("reservations of 16 " + size
+                            + " capacity 256", std::vector { &p }, 16);
+  run<access::target::blocking_pipe>("blocking reservations of 16 " + size
+                                     + " capacity 256",
+                                     std::vector { &p }, 16);
+  static sycl_2_2::static_pipe<T, 16> sp;
+  run<access::target::pipe>("static pipe " + size + " capacity 16",
+                            std::vector { &sp });
+}
+
+
+/** Stream the elements from \p k producer kernels to \p k consumer
+    kernels sharing a pipe, and report the throughput
+*/
+void run_mpmc(std::size_t k) {
+  sycl_2_2::pipe<int> p { 256, sycl_2_2::mpmc };
+  auto start = clk::now();
+  {
+    queue q;
+    for (std::size_t i = 0; i != k; ++i) {
+      q.submit([&] (handler &cgh) {
+          auto out = p.get_access<access::mode::write,
+                                  access::target::blocking_pipe>(cgh);
+          cgh.single_task([=] {
+              for (std::size_t e = 0; e != n/k; ++e)
+                out.write(static_cast<int>(e));
+            });
+        });
+      q.submit([&] (handler &cgh) {
+          auto in = p.get_access<access::mode::read,
+                                 access::target::blocking_pipe>(cgh);
+          cgh.single_task([=] {
+              for (std::size_t e = 0; e != n/k; ++e)
+                in.read();
+            });
+        });
+    }
+    q.wait();
+  }
+  auto seconds = std::chrono::duration<double> { clk::now() - start }.count();
+  auto name = "mpmc pipe " + std::to_string(k) + " producers and consumers";
+  std::cout << std::left << std::setw(44) << name << std::right
+            << std::fixed << std::setprecision(2)
+            << std::setw(10) << n/k*k/seconds/1e6 << " Melt/s" << std::endl;
+  benchmark_result(name + " throughput", n/k*k/seconds, "element/s", true);
+}
+
+
+TEST_CASE("pipe throughput and latency", "[benchmark]") {
+  benchmark_element<4>();
+  benchmark_element<64>();
+  benchmark_element<256>();
+}
+
+
+TEST_CASE("pipe throughput with several producers and consumers",
+          "[benchmark]") {
+  for (std::size_t k : { 1, 2, 4, 8 })
+    run_mpmc(k);
+}
@@ -0,0 +1,152 @@
+#! /usr/bin/env python3
+"""Run the benchmarks several times and compare them against a baseline
+
+Each benchmark executable is run --repetitions times. The results
+are:
+
+- the JSON lines printed by benchmark_result() on the standard output;
+
+- the mean times of the Catch2 BENCHMARK, read from its XML report.
+
+The median and the median absolute deviation (MAD) of each metric over
+the repetitions are written to --output. With --baseline, a metric is
+a regression when its median is worse than the baseline median by more
+than both --threshold (relative) and --mad-factor times the larger
+MAD, scaled to a standard deviation. Then the regressed benchmarks are
+listed and the exit status is 1. A missing baseline is recorded from
+the current results.
+
+Typical use:
+
+  regression.py --output baseline.json benchmarks_runtime ...
+  # After some changes
+  regression.py --baseline baseline.json benchmarks_runtime ...
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import xml.etree.ElementTree as ElementTree
+
+# To scale a MAD to the standard deviation of a normal distribution
+MAD_TO_SIGMA = 1.4826
+
+
+def run(executable):
+    """Run a benchmark executable once and return its results as a
+    dictionary of name: (value, unit, higher_is_better)"""
+    results = {}
+    with tempfile.TemporaryDirectory() as directory:
+        report = os.path.join(directory, "report.xml")
+        # The XML report goes into a file so the standard output only
+        # has the output of the benchmarks
+        output = subprocess.run([executable, "--reporter", "xml",
+                                 "--out", report],
+                                stdout=subprocess.PIPE, text=True,
+                                check=True).stdout
+        for line in output.splitlines():
+            if line.startswith('{"benchmark"'):
+                r = json.loads(line)
+                results[r["benchmark"]] = (r["value"], r["unit"],
+                                           r["higher_is_better"])
+        # Not written by the benchmarks not based on Catch2
+        if not os.path.exists(report):
+            return results
+        for b in ElementTree.parse(report).iter("BenchmarkResults"):
+            mean = b.find("mean")
+            results[b.get("name")] = (float(mean.get("value")), "ns",
+                                      False)
+    return results
+
+
+def measure(executables, repetitions):
+    """Run all the benchmarks and summarize each metric with its median
+    and its MAD over the repetitions"""
+    samples = {}
+    for executable in executables:
+        for _ in range(repetitions):
+            for name, (value, unit, higher) in run(executable).items():
+                s = samples.setdefault(name, { "unit": unit,
+                                               "higher_is_better": higher,
+                                               "values": [] })
+                s["values"].append(value)
+    summary = {}
+    for name, s in samples.items():
+        median = statistics.median(s["values"])
+        mad = statistics.median(abs(v - median) for v in s["values"])
+        summary[name] = { "median": median, "mad": mad, "unit": s["unit"],
+                          "higher_is_better": s["higher_is_better"] }
+    return summary
+
+
+def compare(baseline, current, threshold, mad_factor):
+    """Return the description of the regressions of current against
+    baseline"""
+    regressions = []
+    for name, c in sorted(current.items()):
+        b = baseline.get(name)
+        if b is None:
+            continue
+        # Positive when the metric got worse
+        loss = (b["median"] - c["median"] if c["higher_is_better"]
+                else c["median"] - b["median"])
+        noise = mad_factor*MAD_TO_SIGMA*max(b["mad"], c["mad"])
+        if loss > threshold*abs(b["median"]) and loss > noise:
+            regressions.append(
+                "{}: {:.6g} {} instead of {:.6g} {} ({:+.1f}%)".format(
+                    name, c["median"], c["unit"], b["median"], b["unit"],
+                    100*(c["median"] - b["median"])/b["median"]
+                    if b["median"] else float("inf")))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("executables", nargs="+",
+                        help="the benchmark executables to run")
+    parser.add_argument("--repetitions", type=int, default=5,
+                        help="the number of runs of each benchmark")
+    parser.add_argument("--output", help="the JSON file for the results")
+    parser.add_argument("--baseline",
+                        help="the JSON results to compare against")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="the relative loss tolerated")
+    parser.add_argument("--mad-factor", type=float, default=3,
+                        help="the loss tolerated in standard deviations")
+    args = parser.parse_args()
+
+    current = measure(args.executables, args.repetitions)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+    if not args.baseline:
+        return 0
+    if not os.path.exists(args.baseline):
+        with open(args.baseline, "w") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+        print("Recorded the baseline " + args.baseline)
+        return 0
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    missing = sorted(set(baseline) - set(current))
+    for name in missing:
+        print("Not run anymore: " + name)
+    regressions = compare(baseline, current, args.threshold,
+                          args.mad_factor)
+    if regressions:
+        print("{} benchmark(s) regressed against {}:".format(
+            len(regressions), args.baseline))
+        for r in regressions:
+            print("  " + r)
+        return 1
+    print("No regression among {} benchmark(s)".format(len(current)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,142 @@
+/* Some micro-benchmarks of the runtime itself, to track its overhead
+
+   Catch2 reports the mean time of each benchmark with its confidence
+   interval, estimated by bootstrapping the samples.
+*/
+#include <CL/sycl.hpp>
+
+#include <array>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+/// The number of kernels in a chain of dependent kernels
+constexpr int chain_length = 16;
+
+/// The number of kernels between the fan-out and the fan-in
+constexpr int fan = 8;
+
+/// The number of independent kernels of a burst
+constexpr int burst = 256;
+
+TEST_CASE("runtime overhead", "[benchmark]") {
+  queue q;
+  buffer<int> b { 1 };
+
+  BENCHMARK_ADVANCED("submit of an empty kernel")
+    (Catch::Benchmark::Chronometer meter) {
+    meter.measure([&] {
+        q.submit([&] (handler &cgh) {
+            cgh.single_task<class empty>([] {});
+          });
+      });
+    // Do not let the kernels pile up across the samples
+    q.wait();
+  };
+
+  BENCHMARK("submit and wait of an empty kernel") {
+    q.submit([&] (handler &cgh) {
+        cgh.single_task<class empty_wait>([] {});
+      });
+    q.wait();
+  };
+
+  BENCHMARK("submit and wait of a latency-critical empty kernel") {
+    q.submit([&] (handler &cgh) {
+        cgh.set_latency_critical();
+        cgh.single_task<class empty_inline>([] {});
+      });
+    q.wait();
+  };
+
+  BENCHMARK("chain of " + std::to_string(chain_length)
+            + " dependent kernels") {
+    // Each kernel depends on the previous one through the buffer
+    for (int i = 0; i != chain_length; ++i)
+      q.submit([&] (handler &cgh) {
+          auto a = b.get_access<access::mode::read_write>(cgh);
+          cgh.single_task<class chain>([=] { ++a[0]; });
+        });
+    q.wait();
+  };
+
+  std::array<buffer<int>, fan> fanned {
+    buffer<int> { 1 }, buffer<int> { 1 }, buffer<int> { 1 },
+    buffer<int> { 1 }, buffer<int> { 1 }, buffer<int> { 1 },
+    buffer<int> { 1 }, buffer<int> { 1 }
+  };
+
+  BENCHMARK("fan-out to " + std::to_string(fan) + " kernels and fan-in") {
+    q.submit([&] (handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        cgh.single_task<class fan_out>([=] { a[0] = 1; });
+      });
+    // These kernels only depend on the first one
+    for (auto &f : fanned)
+      q.submit([&] (handler &cgh) {
+          auto a = b.get_access<access::mode::read>(cgh);
+          auto a_f = f.get_access<access::mode::discard_write>(cgh);
+          cgh.single_task<class fanned_out>([=] { a_f[0] = a[0]; });
+        });
+    // And this one depends on all of them
+    q.submit([&] (handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        std::array<accessor<int, 1, access::mode::read>, fan> a_f {
+          fanned[0].get_access<access::mode::read>(cgh),
+          fanned[1].get_access<access::mode::read>(cgh),
+          fanned[2].get_access<access::mode::read>(cgh),
+          fanned[3].get_access<access::mode::read>(cgh),
+          fanned[4].get_access<access::mode::read>(cgh),
+          fanned[5].get_access<access::mode::read>(cgh),
+          fanned[6].get_access<access::mode::read>(cgh),
+          fanned[7].get_access<access::mode::read>(cgh)
+        };
+        cgh.single_task<class fan_in>([=] {
+            a[0] = 0;
+            for (auto &f : a_f)
+              a[0] += f[0];
+          });
+      });
+    q.wait();
+  };
+
+  std::vector<buffer<int>> independent;
+  for (int i = 0; i != burst; ++i)
+    independent.push_back(buffer<int> { 1 });
+  std::vector<std::function<void(handler &)>> burst_cgfs;
+  for (auto &ib : independent)
+    burst_cgfs.push_back([&] (handler &cgh) {
+        auto a = ib.get_access<access::mode::discard_write>(cgh);
+        cgh.single_task<class burst_kernel>([=] { a[0] = 1; });
+      });
+
+  BENCHMARK("burst of " + std::to_string(burst)
+            + " independent kernels with submit") {
+    for (auto &cgf : burst_cgfs)
+      q.submit(cgf);
+    q.wait();
+  };
+
+  BENCHMARK("burst of " + std::to_string(burst)
+            + " independent kernels with submit_batch") {
+    q.submit_batch(burst_cgfs);
+    q.wait();
+  };
+
+  BENCHMARK("host accessor creation and destruction") {
+    auto a = b.get_access<access::mode::read>();
+    return a[0];
+  };
+
+  std::vector<float> large(std::size_t { 1 } << 24, 1);
+  BENCHMARK("buffer of " + std::to_string(large.size())
+            + " floats built from iterators") {
+    buffer<float> l { large.begin(), large.end() };
+    return l.get_count();
+  };
+}
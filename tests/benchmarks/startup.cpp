@@ -0,0 +1,100 @@
+/* The startup time of a short-lived process using triSYCL
+
+   The benchmark spawns itself several times and measures the wall
+   time until the child process exits, either right at the start of
+   main(), so only the loading and the static initialization of the
+   program are measured, or after the completion of its first kernel,
+   which also measures the lazy initialization of the runtime
+   singletons. It only works on Linux.
+
+   The other arguments, such as the Catch2 ones given by
+   regression.py, are ignored.
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "benchmark_result.hpp"
+
+extern char **environ;
+
+using namespace cl::sycl;
+
+/// The number of spawned processes for each measurement
+constexpr int samples = 20;
+
+
+/// What a child process does before exiting
+int child(const std::string &what) {
+  if (what == "main")
+    return 0;
+  queue q;
+  buffer<int> b { 1 };
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task<class first_kernel>([=] { a[0] = 42; });
+    });
+  if (what == "first host accessor")
+    return b.get_access<access::mode::read>()[0] != 42;
+  q.wait();
+  return 0;
+}
+
+
+/** Spawn the children and report the median time until they exit
+
+    \param[in] name is the argv[0] of the children
+*/
+void measure(const char *name, const std::string &what) {
+  // The executable itself, even when not run from its path
+  constexpr char self[] = "/proc/self/exe";
+  std::vector<double> times;
+  for (int s = 0; s != samples; ++s) {
+    std::string child_argument = "--startup-child=" + what;
+    char *argv[] = { const_cast<char *>(name), child_argument.data(),
+                     nullptr };
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid;
+    if (posix_spawn(&pid, self, nullptr, nullptr, argv, environ) != 0) {
+      std::cerr << "Cannot spawn " << self << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    std::chrono::duration<double, std::milli> d =
+      std::chrono::steady_clock::now() - start;
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      std::cerr << "The " << what << " child failed" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    times.push_back(d.count());
+  }
+  std::sort(times.begin(), times.end());
+  auto median = times[samples/2];
+  std::cout << std::left << std::setw(36) << "startup until " + what
+            << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << median << " ms" << std::endl;
+  benchmark_result("startup until " + what, median, "ms", false);
+}
+
+
+int main(int argc, char *argv[]) {
+  constexpr char option[] = "--startup-child=";
+  for (int i = 1; i < argc; ++i)
+    if (std::strncmp(argv[i], option, sizeof(option) - 1) == 0)
+      return child(argv[i] + sizeof(option) - 1);
+  measure(argv[0], "main");
+  measure(argv[0], "first kernel");
+  measure(argv[0], "first host accessor");
+  return 0;
+}
@@ -0,0 +1,106 @@
+/* RUN: %{execute}%s
+
+   Check that the buffers allocate their memory with their Allocator
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+// The number of elements currently allocated by the counting_allocator
+std::size_t allocated = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T> {
+  template <typename U>
+  struct rebind {
+    using other = counting_allocator<U>;
+  };
+
+  counting_allocator() = default;
+
+  template <typename U>
+  counting_allocator(const counting_allocator<U> &) {}
+
+  T *allocate(std::size_t n) {
+    allocated += n;
+    return std::allocator<T>::allocate(n);
+  }
+
+  void deallocate(T *p, std::size_t n) {
+    allocated -= n;
+    std::allocator<T>::deallocate(p, n);
+  }
+};
+
+TEST_CASE("user-provided allocator", "[buffer]") {
+  {
+    buffer<int, 1, counting_allocator<int>> b { 100 };
+    // The host memory is only allocated for the first access
+    REQUIRE(allocated == 0);
+    auto a = b.get_access<access::mode::discard_write>();
+    REQUIRE(allocated == 100);
+    a[99] = 3;
+  }
+  REQUIRE(allocated == 0);
+  const std::vector<int> v(10, 42);
+  {
+    buffer<int, 1, counting_allocator<int>> b { v.data(), v.size() };
+    REQUIRE(allocated == 0);
+    // The copy-on-write uses the allocator too
+    auto a = b.get_access<access::mode::read_write>();
+    REQUIRE(allocated == 10);
+    REQUIRE(a[9] == 42);
+  }
+  REQUIRE(allocated == 0);
+}
+
+TEST_CASE("lazy allocation of the buffers", "[buffer]") {
+  {
+    // A buffer never accessed does not allocate anything
+    buffer<int, 1, counting_allocator<int>> unused { 1000 };
+    buffer<int, 1, counting_allocator<int>> b { 10 };
+    queue q;
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        // The kernel runs on the host, so it uses the host memory
+        REQUIRE(allocated == 10);
+        cgh.single_task<class lazy_write>([=] { a[3] = 7; });
+      });
+    REQUIRE(b.get_access<access::mode::read>()[3] == 7);
+    REQUIRE(allocated == 10);
+    // A sub-buffer uses the memory of its parent
+    buffer<int, 1, counting_allocator<int>> s { unused, 10, 5 };
+    REQUIRE(allocated == 1010);
+  }
+}
+
+TEST_CASE("aligned allocator", "[buffer]") {
+  buffer<char, 1, vendor::trisycl::aligned_allocator<char>> b { 3 };
+  auto a = b.get_access<access::mode::discard_write>();
+  REQUIRE(reinterpret_cast<std::uintptr_t>(&a[0]) % 64 == 0);
+  buffer<float, 1, vendor::trisycl::aligned_allocator<float, 256>> c { 3 };
+  REQUIRE(reinterpret_cast<std::uintptr_t>(
+            &c.get_access<access::mode::discard_write>()[0]) % 256 == 0);
+}
+
+TEST_CASE("huge page allocator", "[buffer]") {
+  constexpr std::size_t n = 3 << 20;
+  queue q;
+  buffer<int, 1, vendor::trisycl::huge_page_allocator<int>> b { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class huge_page_fill>(range<1> { n },
+                                             [=](id<1> i) { a[i] = i[0]; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  REQUIRE(reinterpret_cast<std::uintptr_t>(&a[0]) % (2 << 20) == 0);
+  for (std::size_t i = 0; i < n; i += 4093)
+    REQUIRE(a[i] == int(i));
+}
@@ -0,0 +1,80 @@
+/* RUN: %{execute}%s
+
+   Check the copy-on-write of the buffers created from constant host data
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1 << 20;
+
+TEST_CASE("large copy-on-write", "[buffer]") {
+  std::vector<int> v(n);
+  for (std::size_t i = 0; i < n; ++i)
+    v[i] = i;
+  const auto &table = v;
+  buffer<int> b { table.data(), n };
+  queue q;
+  // Patch a few elements only
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class patch>(range<1> { n/1024 },
+                                    [=](id<1> i) { a[i[0]*1024] *= -1; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i) {
+    REQUIRE(a[i] == (i % 1024 ? int(i) : -int(i)));
+    // The host data are left unchanged
+    REQUIRE(v[i] == int(i));
+  }
+  REQUIRE(&a[0] != v.data());
+}
+
+TEST_CASE("copy-on-write in discard mode", "[buffer]") {
+  const std::vector<int> v(100, 3);
+  buffer<int> b { v.data(), v.size() };
+  {
+    auto a = b.get_access<access::mode::discard_write>();
+    REQUIRE(&a[0] != v.data());
+    a[0] = 1;
+  }
+  REQUIRE(b.get_access<access::mode::read>()[0] == 1);
+  REQUIRE(v[0] == 3);
+}
+
+TEST_CASE("copy-on-write in partial discard mode", "[buffer]") {
+  std::vector<int> v(1000);
+  for (std::size_t i = 0; i < v.size(); ++i)
+    v[i] = i;
+  const auto &table = v;
+  buffer<int> b { table.data(), v.size() };
+  {
+    // Only the elements of the sub-buffer are discarded
+    buffer<int> s { b, id<1> { 100 }, range<1> { 10 } };
+    auto a = s.get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i < 10; ++i)
+      a[i] = -1;
+  }
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    REQUIRE(a[i] == (i >= 100 && i < 110 ? -1 : int(i)));
+    REQUIRE(v[i] == int(i));
+  }
+}
+
+TEST_CASE("large buffer built from iterators", "[buffer]") {
+  std::vector<int> v(n);
+  for (std::size_t i = 0; i < n; ++i)
+    v[i] = i;
+  buffer<int> b { v.begin(), v.end() };
+  REQUIRE(b.get_count() == n);
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == int(i));
+  REQUIRE(&a[0] != v.data());
+}
@@ -0,0 +1,73 @@
+/* RUN: %{execute}%s
+
+   Check that the buffers detached on destruction do not wait for their
+   kernels and write back their data later
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 1000;
+
+TEST_CASE("buffer detached on destruction", "[buffer]") {
+  std::vector<int> in(n, 1);
+  std::vector<int> out(n, 0);
+  std::atomic<bool> go = false;
+  std::atomic<bool> waited = false;
+  std::shared_future<void> done;
+  queue q;
+  {
+    buffer<int> b { in.data(), range<1> { n },
+                    { property::buffer::detach_on_destruction {} } };
+    REQUIRE(b.has_property<property::buffer::detach_on_destruction>());
+    b.set_final_data(out.begin());
+    done = b.get_destruction_future();
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task<class wait_for_go>([=, &go, &waited] {
+            // Wait for the host to go on after the buffer destruction
+            auto start = std::chrono::steady_clock::now();
+            while (!go && std::chrono::steady_clock::now() - start
+                          < std::chrono::seconds { 10 })
+              std::this_thread::yield();
+            waited = go.load();
+            for (int i = 0; i < n; ++i)
+              a[i] += i;
+          });
+      });
+  }
+  // The buffer destruction has not waited for the kernel
+  go = true;
+  done.wait();
+  REQUIRE(waited);
+  for (int i = 0; i < n; ++i)
+    REQUIRE(out[i] == i + 1);
+}
+
+TEST_CASE("destruction future of a blocking buffer", "[buffer]") {
+  std::vector<int> v(n, 1);
+  std::shared_future<void> done;
+  {
+    buffer<int> b { v.data(), range<1> { n } };
+    REQUIRE(!b.has_property<property::buffer::detach_on_destruction>());
+    done = b.get_destruction_future();
+    queue {}.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::write>(cgh);
+        cgh.parallel_for<class set>(range<1> { n },
+                                    [=](id<1> i) { a[i] = 2; });
+      });
+  }
+  // The buffer destruction has already waited for the write-back
+  REQUIRE(done.wait_for(std::chrono::seconds { 0 })
+          == std::future_status::ready);
+  for (auto e : v)
+    REQUIRE(e == 2);
+}
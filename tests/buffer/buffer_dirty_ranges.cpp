@@ -0,0 +1,91 @@
+/* RUN: %{execute}%s
+
+   Check that only the written parts of the buffers are written back
+*/
+#include <CL/sycl.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int sentinel = -1;
+
+TEST_CASE("merge the written intervals", "[buffer]") {
+  ::trisycl::detail::dirty_ranges d;
+  REQUIRE(d.empty());
+  d.add(10, 20);
+  d.add(30, 40);
+  d.add(0, 5);
+  REQUIRE(d.get().size() == 3);
+  // Adjacent to the first interval and overlapping the second one
+  d.add(5, 12);
+  d.add(35, 50);
+  REQUIRE(d.get() == decltype(d.get()) { { 0, 20 }, { 30, 50 } });
+  REQUIRE(d.count() == 40);
+  // Covering everything
+  d.add(15, 31);
+  REQUIRE(d.get() == decltype(d.get()) { { 0, 50 } });
+  d.clear();
+  REQUIRE(d.empty());
+}
+
+TEST_CASE("only write back the range of an accessor", "[buffer]") {
+  const std::vector<int> in(100, 1);
+  std::vector<int> out(100, sentinel);
+  {
+    buffer<int> b { in.data(), in.size() };
+    b.set_final_data(out.begin());
+    queue q;
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh, range<1> { 20 },
+                                                        id<1> { 40 });
+        cgh.parallel_for<class window>(range<1> { 20 },
+                                       [=](id<1> i) { a[i[0] + 40] = 2; });
+      });
+  }
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(out[i] == (i >= 40 && i < 60 ? 2 : sentinel));
+}
+
+TEST_CASE("only write back the part of a sub-buffer", "[buffer]") {
+  const std::vector<int> in(100, 1);
+  std::vector<int> out(100, sentinel);
+  {
+    buffer<int> b { in.data(), in.size() };
+    b.set_final_data(out.begin());
+    buffer<int> s { b, id<1> { 10 }, range<1> { 5 } };
+    auto a = s.get_access<access::mode::write>();
+    for (int i = 0; i < 5; ++i)
+      a[i] = 3;
+  }
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(out[i] == (i >= 10 && i < 15 ? 3 : sentinel));
+}
+
+TEST_CASE("write back the elements marked as written", "[buffer]") {
+  const std::vector<int> in(16, 1);
+  std::vector<int> out(16, sentinel);
+  {
+    buffer<int, 2> b { in.data(), range<2> { 4, 4 } };
+    b.set_final_data(out.begin());
+    // Row 1, columns 1 and 2
+    b.mark_as_written(range<2> { 1, 2 }, id<2> { 1, 1 });
+  }
+  for (int i = 0; i < 16; ++i)
+    REQUIRE(out[i] == (i == 5 || i == 6 ? 1 : sentinel));
+}
+
+TEST_CASE("write back everything once marked as written", "[buffer]") {
+  const std::vector<int> in(10, 1);
+  std::vector<int> out(10, sentinel);
+  {
+    buffer<int> b { in.data(), in.size() };
+    b.set_final_data(out.begin());
+    b.get_access<access::mode::write>(range<1> { 2 });
+    b.mark_as_written();
+  }
+  for (auto e : out)
+    REQUIRE(e == 1);
+}
@@ -0,0 +1,91 @@
+/* RUN: %{execute}%s
+
+   Check the explicit memory commands of the handler on some accessors
+*/
+#include <CL/sycl.hpp>
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+// Large enough to use the parallel copies
+constexpr int n = 1 << 19;
+
+TEST_CASE("copy between the host and some accessors", "[buffer]") {
+  queue q;
+  std::vector<int> in(n), out(n);
+  std::iota(in.begin(), in.end(), 0);
+  buffer<int> a { n }, b { n };
+  q.submit([&](handler &cgh) {
+      cgh.copy(in.data(), a.get_access<access::mode::discard_write>(cgh));
+    });
+  q.submit([&](handler &cgh) {
+      cgh.copy(a.get_access<access::mode::read>(cgh),
+               b.get_access<access::mode::discard_write>(cgh));
+    });
+  q.submit([&](handler &cgh) {
+      cgh.copy(b.get_access<access::mode::read>(cgh), out.data());
+    });
+  q.wait();
+  REQUIRE(out == in);
+
+  auto shared = std::make_shared<std::vector<int>>(n);
+  q.submit([&](handler &cgh) {
+      cgh.copy(a.get_access<access::mode::read>(cgh),
+               std::shared_ptr<int> { shared, shared->data() });
+    });
+  q.wait();
+  REQUIRE(*shared == in);
+}
+
+TEST_CASE("fill an accessor", "[buffer]") {
+  queue q;
+  buffer<double> b { n };
+  q.submit([&](handler &cgh) {
+      cgh.fill(b.get_access<access::mode::discard_write>(cgh), 2.5);
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] += i[0]; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (int i = 0; i < n; ++i)
+    REQUIRE(a[i] == 2.5 + i);
+}
+
+TEST_CASE("update_host is ordered with the kernels", "[buffer]") {
+  queue q;
+  std::vector<int> v(n);
+  {
+    buffer<int> b { v.data(), n };
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] = i[0]; });
+      });
+    q.submit([&](handler &cgh) {
+        cgh.update_host(b.get_access<access::mode::read>(cgh));
+      });
+    q.wait();
+  }
+  for (int i = 0; i < n; ++i)
+    REQUIRE(v[i] == i);
+}
+
+TEST_CASE("copy into a smaller accessor", "[buffer]") {
+  queue q;
+  buffer<int> a { 10 }, b { 5 };
+  q.submit([&](handler &cgh) {
+      cgh.fill(a.get_access<access::mode::discard_write>(cgh), 7);
+    });
+  q.submit([&](handler &cgh) {
+      cgh.copy(a.get_access<access::mode::read>(cgh),
+               b.get_access<access::mode::discard_write>(cgh));
+    });
+  auto r = b.get_access<access::mode::read>();
+  for (int i = 0; i < 5; ++i)
+    REQUIRE(r[i] == 7);
+}
@@ -0,0 +1,74 @@
+/* RUN: %{execute}%s
+
+   Check the recycling of the buffer memory by the buffer pool
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using pool = vendor::trisycl::buffer_pool;
+
+TEST_CASE("size classes", "[buffer_pool]") {
+  REQUIRE(pool::size_class(1) == pool::min_class);
+  REQUIRE(pool::size_class(4096) == 4096);
+  REQUIRE(pool::size_class(4097) == 5120);
+  REQUIRE(pool::size_class(7000) == 7168);
+}
+
+TEST_CASE("recycling of temporary buffers", "[buffer_pool]") {
+  auto &p = pool::instance();
+  p.set_capacity(16 << 20);
+  REQUIRE(p.is_enabled());
+  auto before = p.get_statistics();
+  float *first;
+  {
+    buffer<float, 2> b { range<2> { 256, 256 } };
+    first = b.get_access<access::mode::discard_write>().get_pointer();
+  }
+  for (int i = 0; i < 10; ++i) {
+    buffer<float, 2> b { range<2> { 256, 256 } };
+    // The same memory is used again and again
+    REQUIRE(b.get_access<access::mode::discard_write>().get_pointer()
+            == first);
+  }
+  auto after = p.get_statistics();
+  REQUIRE(after.misses == before.misses + 1);
+  REQUIRE(after.hits == before.hits + 10);
+  REQUIRE(after.retained_bytes == before.retained_bytes + 256*256*4);
+  p.trim();
+  REQUIRE(p.get_statistics().retained_bytes == 0);
+}
+
+TEST_CASE("capacity of the buffer pool", "[buffer_pool]") {
+  auto &p = pool::instance();
+  p.set_capacity(1 << 20);
+  {
+    buffer<char> small { 500 << 10 };
+    // Destroyed before small
+    buffer<char> medium { 600 << 10 };
+    // Too large to be retained at all
+    buffer<char, 1, vendor::trisycl::pooled_allocator<char>> large {
+      2 << 20
+    };
+    // Allocate the memory of the buffers
+    small.get_access<access::mode::discard_write>();
+    medium.get_access<access::mode::discard_write>();
+    large.get_access<access::mode::discard_write>();
+  }
+  // The oldest released buffer has been given back
+  REQUIRE(p.get_statistics().retained_bytes == pool::size_class(500 << 10));
+  p.set_capacity(0);
+  REQUIRE(!p.is_enabled());
+  REQUIRE(p.get_statistics().retained_bytes == 0);
+  auto before = p.get_statistics();
+  {
+    buffer<char> b { 100 };
+    b.get_access<access::mode::discard_write>();
+  }
+  // The default allocator does not use a disabled pool
+  REQUIRE(p.get_statistics().misses == before.misses);
+}
@@ -0,0 +1,51 @@
+/* RUN: %{execute}%s
+
+   Check the prefetch of a buffer ahead of the kernels using it
+*/
+#include <CL/sycl.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 100;
+
+TEST_CASE("prefetch is ordered with the kernels using the buffer",
+          "[buffer]") {
+  queue q;
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] = i[0]; });
+    });
+  auto e = q.prefetch(b);
+  buffer<int> c { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read>(cgh);
+      auto r = c.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { r[i] = 2*a[i]; });
+    });
+  e.wait();
+  REQUIRE(e.get_info<info::event::command_execution_status>()
+          == info::event_command_status::complete);
+  auto r = c.get_access<access::mode::read>();
+  for (int i = 0; i < n; ++i)
+    REQUIRE(r[i] == 2*i);
+}
+
+TEST_CASE("prefetch inside a command group", "[buffer]") {
+  queue q;
+  std::vector<int> v(n, 3);
+  {
+    buffer<int> b { v.data(), n };
+    q.submit([&](handler &cgh) { cgh.prefetch(b); });
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] += 1; });
+      });
+  }
+  for (auto e : v)
+    REQUIRE(e == 4);
+}
@@ -0,0 +1,78 @@
+/* RUN: %{execute}%s
+
+   Test the read after write, write after read and write after write
+   dependencies between the kernels using a buffer
+*/
+
+#include <CL/sycl.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+using namespace std::chrono_literals;
+
+TEST_CASE("readers run concurrently", "[buffer]") {
+  constexpr int readers = 4;
+  queue q;
+  buffer<int> b { 1 };
+  // Not a buffer, since writing it would serialize the readers
+  std::array<std::atomic<bool>, readers> met {};
+  std::atomic<int> arrived = 0;
+
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 42; });
+    });
+  for (int r = 0; r < readers; ++r)
+    q.submit([&, r](handler &cgh) {
+        auto a = b.get_access<access::mode::read>(cgh);
+        cgh.single_task([=, &arrived, &met] {
+            // Each reader waits for all the others to be running
+            ++arrived;
+            auto deadline = std::chrono::steady_clock::now() + 10s;
+            while (arrived < readers
+                   && std::chrono::steady_clock::now() < deadline)
+              std::this_thread::yield();
+            met[r] = arrived == readers && a[0] == 42;
+          });
+      });
+  q.wait();
+  for (auto &m : met)
+    REQUIRE(m);
+}
+
+TEST_CASE("a writer waits for the previous readers", "[buffer]") {
+  queue q;
+  buffer<int> b { 1 };
+  buffer<int> seen { 2 };
+
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 1; });
+    });
+  for (int r = 0; r < 2; ++r)
+    q.submit([&, r](handler &cgh) {
+        auto a = b.get_access<access::mode::read>(cgh);
+        auto s = seen.get_access<access::mode::write>(cgh);
+        cgh.single_task([=] {
+            // Give a chance to an unsynchronized writer to run first
+            std::this_thread::sleep_for(50ms);
+            s[r] = a[0];
+          });
+      });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::write>(cgh);
+      cgh.single_task([=] { a[0] = 2; });
+    });
+
+  auto s = seen.get_access<access::mode::read>();
+  REQUIRE(s[0] == 1);
+  REQUIRE(s[1] == 1);
+  auto a = b.get_access<access::mode::read>();
+  REQUIRE(a[0] == 2);
+}
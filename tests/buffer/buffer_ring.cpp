@@ -0,0 +1,47 @@
+/* RUN: %{execute}%s
+
+   Iterate a stencil on the generations of a ring of buffers
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/buffer_ring.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+constexpr int iterations = 10;
+
+TEST_CASE("buffer ring generations", "[buffer_ring]") {
+  std::vector<int> data(n);
+  data[n/2] = 1 << 20;
+  vendor::trisycl::buffer_ring<int, 1, 3> ring { data.data(), range<1> { n } };
+  queue q;
+  for (int i = 0; i != iterations; ++i) {
+    ring.advance();
+    q.submit([&](handler &cgh) {
+        auto in = ring.get_access<access::mode::read>(cgh, 1);
+        auto out = ring.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+            auto left = i[0] ? in[i[0] - 1] : 0;
+            auto right = i[0] + 1 != n ? in[i[0] + 1] : 0;
+            out[i] = (left + 2*in[i] + right)/4;
+          });
+      });
+    // The same stencil on the host
+    auto previous = data;
+    for (std::size_t j = 0; j != n; ++j)
+      data[j] = ((j ? previous[j - 1] : 0) + 2*previous[j]
+                 + (j + 1 != n ? previous[j + 1] : 0))/4;
+  }
+  REQUIRE(ring.get_generation() == iterations);
+  auto a = ring.get_access<access::mode::read>();
+  for (std::size_t j = 0; j != n; ++j)
+    REQUIRE(a[j] == data[j]);
+  // The previous generation is still there, unlike the one before
+  REQUIRE(&ring.previous(1) != &ring.current());
+  REQUIRE_THROWS_AS(ring[3], invalid_parameter_error);
+}
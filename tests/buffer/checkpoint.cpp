@@ -0,0 +1,108 @@
+/* RUN: %{execute}%s
+
+   Checkpoint some buffers asynchronously and restore them
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "triSYCL/vendor/triSYCL/checkpoint.hpp"
+
+using namespace cl::sycl;
+using namespace cl::sycl::vendor::trisycl;
+
+constexpr std::size_t rows = 30;
+constexpr std::size_t columns = 20;
+
+
+TEST_CASE("checkpoint to a file and restore", "[checkpoint]") {
+  // A unique file, created by mkstemp() to avoid any race on its name
+  std::string path = (std::filesystem::temp_directory_path()
+                      / "trisycl_checkpoint_XXXXXX").string();
+  auto fd = ::mkstemp(path.data());
+  REQUIRE(fd >= 0);
+  ::close(fd);
+  queue q;
+  buffer<float, 2> b { range<2> { rows, columns } };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(a.get_range(), [=](id<2> i) {
+          a[i] = i[0]*columns + i[1];
+        });
+    });
+  auto saved = checkpoint(q, b, path);
+  // The next kernels do not wait for the file
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(a.get_range(), [=](item<2> i) {
+          a[i] = -a[i];
+        });
+    });
+  saved.wait();
+  {
+    auto r = restore<float, 2>(path);
+    REQUIRE(r.get_range() == range<2> { rows, columns });
+    auto a = r.get_access<access::mode::read_write>();
+    for (std::size_t i = 0; i != rows; ++i)
+      for (std::size_t j = 0; j != columns; ++j) {
+        REQUIRE(a[i][j] == i*columns + j);
+        // The modifications do not change the checkpoint
+        a[i][j] = 0;
+      }
+  }
+  auto r = restore<const float, 2>(path);
+  REQUIRE(r.get_access<access::mode::read>()[1][2] == columns + 2);
+  REQUIRE(b.get_access<access::mode::read>()[1][2] == -float(columns + 2));
+  REQUIRE_THROWS(restore<double, 2>(path));
+  REQUIRE_THROWS(restore<float, 1>(path));
+  std::remove(path.c_str());
+}
+
+
+TEST_CASE("checkpoint to memory", "[checkpoint]") {
+  queue q;
+  buffer<int> b { range<1> { rows } };
+  b.get_access<access::mode::discard_write>()[3] = 42;
+  std::vector<std::byte> region(checkpoint_bytes<int>(b.get_range()));
+  checkpoint(q, b, region).wait();
+  checkpoint_header h;
+  std::memcpy(&h, region.data(), sizeof(h));
+  REQUIRE(h.dimensions == 1);
+  REQUIRE(h.range[0] == rows);
+  int e;
+  std::memcpy(&e, region.data() + sizeof(h) + 3*sizeof(int), sizeof(e));
+  REQUIRE(e == 42);
+  std::vector<std::byte> too_small(sizeof(h));
+  REQUIRE_THROWS(checkpoint(q, b, too_small));
+}
+
+
+TEST_CASE("checkpoint of padded rows", "[checkpoint]") {
+  queue q;
+  buffer<int, 2> b { range<2> { rows, columns },
+                     property::buffer::row_pitch { columns + 3 } };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(a.get_range(), [=](id<2> i) {
+          a[i] = i[0]*columns + i[1];
+        });
+    });
+  std::vector<std::byte> region(checkpoint_bytes<int>(b.get_range()));
+  checkpoint(q, b, region).wait();
+  // The checkpoint has only the elements, without the padding
+  std::vector<int> e(rows*columns);
+  std::memcpy(e.data(), region.data() + sizeof(checkpoint_header),
+              e.size()*sizeof(int));
+  for (std::size_t i = 0; i != e.size(); ++i)
+    REQUIRE(e[i] == int(i));
+}
@@ -0,0 +1,67 @@
+/* RUN: %{execute}%s
+
+   Check the tracking of the contexts holding the most recent data of
+   a buffer
+*/
+#include <CL/sycl.hpp>
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using directory = ::trisycl::detail::coherence_directory<int, std::string>;
+using state = directory::state;
+
+constexpr int host = 0;
+constexpr int gpu = 1;
+constexpr int fpga = 2;
+
+TEST_CASE("the MSI states of the contexts", "[buffer]") {
+  directory d;
+  REQUIRE(!d.any_fresh());
+  d.share(host);
+  REQUIRE(d.get_state(host) == state::modified);
+  // Reading on the GPU shares the data
+  d.set_copy(gpu, "gpu");
+  d.share(gpu);
+  REQUIRE(d.get_state(host) == state::shared);
+  REQUIRE(d.get_state(gpu) == state::shared);
+  REQUIRE(*d.find_fresh([] (int c) { return c != host; }) == gpu);
+  // Writing on the GPU invalidates the host
+  d.own(gpu);
+  REQUIRE(d.is_only_fresh(gpu));
+  REQUIRE(!d.is_fresh(host));
+  REQUIRE(!d.find_fresh([] (int c) { return c == host; }));
+  // The copy survives the state changes
+  REQUIRE(d.copy(gpu) == "gpu");
+  REQUIRE(d.has_copies());
+  REQUIRE(!d.has_copy(fpga));
+  // Back on the host before evicting the GPU copy
+  d.share(host);
+  d.forget(gpu);
+  REQUIRE(d.is_only_fresh(host));
+  REQUIRE(!d.has_copies());
+}
+
+TEST_CASE("the valid parts of a stale copy", "[buffer]") {
+  directory d;
+  d.share(host);
+  d.set_copy(gpu, "gpu");
+  REQUIRE(!d.is_valid(gpu, 0, 10));
+  d.validate(gpu, 0, 10, 100);
+  d.validate(gpu, 50, 60, 100);
+  REQUIRE(d.is_valid(gpu, 2, 8));
+  REQUIRE(!d.is_valid(gpu, 5, 15));
+  REQUIRE(!d.is_fresh(gpu));
+  // Touching intervals are merged
+  d.validate(gpu, 10, 50, 100);
+  REQUIRE(d.is_valid(gpu, 5, 55));
+  // A write elsewhere invalidates the parts
+  d.own(host);
+  REQUIRE(!d.is_valid(gpu, 5, 55));
+  // Validating everything makes the copy fresh
+  d.validate(gpu, 0, 60, 100);
+  d.validate(gpu, 40, 100, 100);
+  REQUIRE(d.get_state(gpu) == state::shared);
+  REQUIRE(d.get_state(host) == state::shared);
+}
@@ -0,0 +1,53 @@
+/* RUN: %{execute}%s
+
+   Check the accounting of the data transfers of the buffers
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/data_transfers.hpp>
+
+#include <chrono>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using accounting = vendor::trisycl::data_transfers;
+
+TEST_CASE("accounting of the transfers per context and per buffer",
+          "[data_transfers]") {
+  auto &d = accounting::instance();
+  d.reset();
+  context ctx;
+  int owners[2];
+  using namespace std::chrono_literals;
+  d.record(accounting::direction::host_to_device, ctx, &owners[0], 100, 2us);
+  d.record(accounting::direction::host_to_device, ctx, &owners[1], 50, 1us);
+  d.record(accounting::direction::device_to_host, ctx, &owners[0], 10, 1us);
+  d.avoided(ctx, &owners[1], 50);
+  auto s = d.get_statistics(ctx);
+  REQUIRE(s.host_to_device.count == 2);
+  REQUIRE(s.host_to_device.bytes == 150);
+  REQUIRE(s.host_to_device.time == 3us);
+  REQUIRE(s.device_to_host.count == 1);
+  REQUIRE(s.device_to_host.bytes == 10);
+  REQUIRE(s.device_to_device.count == 0);
+  REQUIRE(s.avoided == 1);
+  REQUIRE(s.avoided_bytes == 50);
+  // The transfers of a destroyed buffer still count in its context
+  d.forget(&owners[0]);
+  REQUIRE(d.get_statistics(ctx).host_to_device.bytes == 150);
+  d.reset();
+  REQUIRE(d.get_statistics(ctx).host_to_device.count == 0);
+}
+
+TEST_CASE("no transfer for a buffer used on the host", "[data_transfers]") {
+  auto &d = accounting::instance();
+  d.reset();
+  buffer<int> b { 10 };
+  b.get_access<access::mode::write>()[0] = 42;
+  REQUIRE(b.get_access<access::mode::read>()[0] == 42);
+  auto s = d.get_buffer_statistics(b);
+  REQUIRE(s.host_to_device.count + s.device_to_host.count
+          + s.device_to_device.count == 0);
+  REQUIRE(s.avoided == 0);
+}
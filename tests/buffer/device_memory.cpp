@@ -0,0 +1,58 @@
+/* RUN: %{execute}%s
+
+   Check the accounting of the device memory and the eviction of the
+   least recently used allocations beyond the budget
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/device_memory.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using accounting = vendor::trisycl::device_memory;
+
+TEST_CASE("eviction of the least recently used allocations",
+          "[device_memory]") {
+  auto &d = accounting::instance();
+  context ctx;
+  int owners[4];
+  std::vector<int> evicted;
+  auto evictor = [&] (int i, bool evictable) {
+    return [&, i, evictable] {
+      if (!evictable)
+        return false;
+      evicted.push_back(i);
+      d.released(ctx, &owners[i]);
+      return true;
+    };
+  };
+  d.set_budget(300);
+  REQUIRE(d.reserve(ctx, 100, &owners[0]));
+  d.allocated(ctx, &owners[0], 100, evictor(0, true));
+  REQUIRE(d.reserve(ctx, 100, &owners[1]));
+  d.allocated(ctx, &owners[1], 100, evictor(1, false));
+  REQUIRE(d.reserve(ctx, 100, &owners[2]));
+  d.allocated(ctx, &owners[2], 100, evictor(2, true));
+  REQUIRE(d.get_statistics(ctx).allocated_bytes == 300);
+  // Owner 0 is now more recently used than owner 2
+  d.used(ctx, &owners[0]);
+  // Owner 1 is in use, so owner 2 is evicted
+  REQUIRE(d.reserve(ctx, 100, &owners[3]));
+  d.allocated(ctx, &owners[3], 100, evictor(3, true));
+  REQUIRE(evicted == std::vector { 2 });
+  auto s = d.get_statistics(ctx);
+  REQUIRE(s.allocated_bytes == 300);
+  REQUIRE(s.peak_bytes == 300);
+  REQUIRE(s.evictions == 1);
+  REQUIRE(s.evicted_bytes == 100);
+  // Nothing else can be evicted to make room for this one
+  REQUIRE(!d.reserve(ctx, 250, &owners[2]));
+  for (auto &o : owners)
+    d.released(ctx, &o);
+  REQUIRE(d.get_statistics(ctx).allocated_bytes == 0);
+  d.set_budget(0);
+  REQUIRE(d.reserve(ctx, 1 << 30, &owners[0]));
+}
@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Test a Jacobi-style stencil on some buffers distributed over the
+   MPI ranks, run with mpirun to use several ranks
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/distributed.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t M = 37;
+constexpr std::size_t N = 11;
+constexpr int iterations = 5;
+
+
+/// The initial value of an element
+float initial(std::size_t i, std::size_t j) {
+  return (i*(j + 2) + 10.f)/N;
+}
+
+
+TEST_CASE("distributed Jacobi stencil", "[distributed]") {
+  // The reference computed on the whole iteration space
+  std::vector<float> a(M*N), b(M*N);
+  for (std::size_t i = 0; i != M; ++i)
+    for (std::size_t j = 0; j != N; ++j)
+      a[i*N + j] = b[i*N + j] = initial(i, j);
+  for (int k = 0; k != iterations; ++k) {
+    for (std::size_t i = 1; i != M - 1; ++i)
+      for (std::size_t j = 1; j != N - 1; ++j)
+        b[i*N + j] = (a[i*N + j] + a[(i - 1)*N + j] + a[(i + 1)*N + j]
+                      + a[i*N + j - 1] + a[i*N + j + 1])/5;
+    std::swap(a, b);
+  }
+
+  vendor::trisycl::distribution<2> d { range<2> { M, N }, 1 };
+  vendor::trisycl::distributed_buffer<float, 2> da { d }, db { d };
+  for (auto *x : { &da, &db }) {
+    auto acc = x->get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i != d.get_local_range()[0]; ++i)
+      for (std::size_t j = 0; j != N; ++j)
+        acc[i][j] = initial(d.get_global_id({ i, j })[0], j);
+  }
+  queue q;
+  for (int k = 0; k != iterations; ++k) {
+    q.submit([&] (handler &cgh) {
+        auto in = da.get_access<access::mode::read>(cgh);
+        auto out = db.get_access<access::mode::write>(cgh);
+        d.parallel_for<class distributed_jacobi>(cgh,
+                                                 range<2> { M - 2, N - 2 },
+                                                 id<2> { 1, 1 },
+                                                 [=] (item<2> it) {
+            id<2> i = it.get_id();
+            id<2> down { 1, 0 };
+            id<2> right { 0, 1 };
+            out[i] = (in[i] + in[i - down] + in[i + down]
+                      + in[i - right] + in[i + right])/5;
+          });
+      });
+    std::swap(da, db);
+  }
+  auto acc = da.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != d.get_range()[0]; ++i) {
+    auto local = i + d.get_halo()[0];
+    auto global = i + d.get_offset()[0];
+    for (std::size_t j = 0; j != N; ++j)
+      REQUIRE(acc[local][j] == a[global*N + j]);
+  }
+}
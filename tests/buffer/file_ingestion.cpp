@@ -0,0 +1,116 @@
+/* RUN: %{execute}%s
+
+   Read some files into buffers by chunks overlapping the kernels
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "triSYCL/vendor/triSYCL/file_ingestion.hpp"
+
+using namespace cl::sycl;
+namespace vt = cl::sycl::vendor::trisycl;
+
+constexpr std::size_t n = 10000;
+
+/// Create a file with a header of 16 bytes and the integers from 0 to n - 1
+std::string make_file() {
+  // A unique file, created by mkstemp() to avoid any race on its name
+  std::string path = (std::filesystem::temp_directory_path()
+                      / "trisycl_file_ingestion_XXXXXX").string();
+  auto fd = ::mkstemp(path.data());
+  REQUIRE(fd >= 0);
+  ::close(fd);
+  std::vector<int> v(n + 4, -1);
+  for (std::size_t i = 0; i < n; ++i)
+    v[i + 4] = i;
+  std::ofstream { path, std::ios::binary }
+    .write(reinterpret_cast<const char *>(v.data()), v.size()*sizeof(int));
+  return path;
+}
+
+TEST_CASE("kernels on the chunks already read", "[file_ingestion]") {
+  auto path = make_file();
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  constexpr std::size_t chunk = 1024;
+  queue q { property::queue::worker_threads { 4 } };
+  buffer<int> in { n }, out { n };
+  auto events = vt::read_from_file(q, in, fd, 16, chunk);
+  REQUIRE(events.size() == (n + chunk - 1)/chunk);
+  for (std::size_t first = 0; first < n; first += chunk)
+    q.submit([&](handler &cgh) {
+        auto part = std::min(chunk, n - first);
+        auto i = in.get_access<access::mode::read>(cgh, range<1> { part },
+                                                   id<1> { first });
+        auto o = out.get_access<access::mode::discard_write>(
+          cgh, range<1> { part }, id<1> { first });
+        cgh.parallel_for<class chunk_double>(range<1> { part },
+                                             id<1> { first },
+                                             [=](item<1> w) {
+            o[w] = 2*i[w];
+          });
+      });
+  auto o = out.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(o[i] == int(2*i));
+  ::close(fd);
+  std::remove(path.c_str());
+}
+
+TEST_CASE("read a part of a buffer in a command group", "[file_ingestion]") {
+  auto path = make_file();
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  buffer<int> b { n };
+  queue q;
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write,
+                            access::target::host_task>(cgh);
+      cgh.fill(a, 7);
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::write,
+                            access::target::host_task>(cgh, range<1> { 10 },
+                                                       id<1> { 100 });
+      cgh.read_from_file(a, fd, 16);
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == (i >= 100 && i < 110 ? int(i) : 7));
+  ::close(fd);
+  std::remove(path.c_str());
+}
+
+TEST_CASE("a file too short is an asynchronous error", "[file_ingestion]") {
+  auto path = make_file();
+  auto fd = ::open(path.c_str(), O_RDONLY);
+  REQUIRE(fd >= 0);
+  int errors = 0;
+  queue q { [&](exception_list l) {
+      for (auto &e : l)
+        try {
+          std::rethrow_exception(e);
+        } catch (runtime_error &) {
+          ++errors;
+        }
+    } };
+  buffer<int> b { n + 1 };
+  vt::read_from_file(q, b, fd, 16);
+  q.wait_and_throw();
+  REQUIRE(errors == 1);
+  ::close(fd);
+  std::remove(path.c_str());
+}
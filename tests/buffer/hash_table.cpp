@@ -0,0 +1,56 @@
+/* RUN: %{execute}%s
+
+   Look up a hash table stored in a buffer from a kernel
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/hash_table.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 10000;
+
+TEST_CASE("hash table lookups", "[hash_table]") {
+  std::mt19937 g;
+  std::unordered_map<std::uint32_t, float> m;
+  std::vector<std::uint32_t> keys(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    keys[i] = g();
+    // Only the even keys are in the table
+    if (i%2 == 0)
+      m[keys[i]] = i;
+  }
+  vendor::trisycl::hash_table<std::uint32_t, float> t { m };
+  REQUIRE(t.size() == m.size());
+
+  buffer<std::uint32_t> k { keys.begin(), keys.end() };
+  buffer<float> result { range<1> { n } };
+  queue q;
+  q.submit([&](handler &cgh) {
+      auto w = t.get_access(cgh);
+      auto ak = k.get_access<access::mode::read>(cgh);
+      auto r = result.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          auto v = w.find(ak[i]);
+          r[i] = v ? *v : -1;
+        });
+    });
+  auto r = result.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(r[i] == (m.count(keys[i]) ? m[keys[i]] : -1));
+
+  // The first of the duplicate keys is kept
+  vendor::trisycl::hash_table<int, int> d { { 1, 2 }, { 1, 3 }, { 4, 5 } };
+  auto h = d.get_access();
+  REQUIRE(d.size() == 2);
+  REQUIRE(*h.find(1) == 2);
+  REQUIRE(h.count(4) == 1);
+  REQUIRE(!h.contains(3));
+}
@@ -0,0 +1,64 @@
+/* RUN: %{execute}%s
+
+   Check the host accessors obtained without blocking the caller
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+using namespace std::chrono_literals;
+
+/// Submit a kernel writing 42 into \p b once \p go is true
+void write_when(queue &q, buffer<int> &b, std::atomic<bool> &go) {
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=, &go] {
+          while (!go)
+            std::this_thread::yield();
+          a[0] = 42;
+        });
+    });
+}
+
+
+TEST_CASE("host accessor future", "[buffer]") {
+  queue q;
+  buffer<int> b { 1 };
+  std::atomic<bool> go = false;
+  write_when(q, b, go);
+  auto f = b.get_host_access_async<access::mode::read>();
+  // The kernel is still running
+  REQUIRE(f.wait_for(10ms) == std::future_status::timeout);
+  go = true;
+  REQUIRE(f.get()[0] == 42);
+}
+
+
+TEST_CASE("host accessor continuation", "[buffer]") {
+  queue q;
+  buffer<int> b { 1 };
+  std::atomic<bool> go = false;
+  write_when(q, b, go);
+  std::promise<int> result;
+  b.get_host_access_async<access::mode::read_write>([&](auto a) {
+      auto previous = a[0];
+      a[0] = 3;
+      result.set_value(previous);
+    });
+  go = true;
+  REQUIRE(result.get_future().get() == 42);
+  REQUIRE(b.get_access<access::mode::read>()[0] == 3);
+}
+
+
+TEST_CASE("host accessor of an idle buffer", "[buffer]") {
+  buffer<int> b { 1 };
+  b.get_access<access::mode::discard_write>()[0] = 7;
+  REQUIRE(b.get_host_access_async<access::mode::read>().get()[0] == 7);
+}
@@ -0,0 +1,102 @@
+/* RUN: %{execute}%s
+
+   Use some memory-mapped files as buffer storage
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "triSYCL/vendor/triSYCL/mapped_file.hpp"
+
+using namespace cl::sycl;
+using namespace cl::sycl::vendor::trisycl;
+
+constexpr std::size_t n = 10000;
+
+/// Create a file with the integers from 0 to n - 1
+std::string make_file() {
+  // A unique file, created by mkstemp() to avoid any race on its name
+  std::string path = (std::filesystem::temp_directory_path()
+                      / "trisycl_mapped_file_XXXXXX").string();
+  auto fd = ::mkstemp(path.data());
+  REQUIRE(fd >= 0);
+  ::close(fd);
+  std::vector<int> v(n);
+  for (std::size_t i = 0; i < n; ++i)
+    v[i] = i;
+  std::ofstream { path, std::ios::binary }
+    .write(reinterpret_cast<const char *>(v.data()), n*sizeof(int));
+  return path;
+}
+
+/// Read the integer at position i in a file
+int read_file(const std::string &path, std::size_t i) {
+  int x;
+  std::ifstream f { path, std::ios::binary };
+  f.seekg(i*sizeof(int));
+  f.read(reinterpret_cast<char *>(&x), sizeof(int));
+  return x;
+}
+
+TEST_CASE("read-only mapped file", "[mapped_file]") {
+  auto path = make_file();
+  {
+    mapped_file<const int> f { path };
+    REQUIRE(f.size() == n);
+    auto in = f.get_buffer();
+    buffer<int> out { n };
+    queue q;
+    q.submit([&](handler &cgh) {
+        auto i = in.get_access<access::mode::read>(cgh);
+        auto o = out.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class mapped_read>(range<1> { n },
+                                            [=](id<1> x) { o[x] = 2*i[x]; });
+      });
+    auto o = out.get_access<access::mode::read>();
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE(o[i] == 2*int(i));
+    // A 2D view of the beginning of the file
+    auto b = f.get_buffer(range<2> { 10, 100 });
+    REQUIRE(b.get_count() == 1000);
+    REQUIRE_THROWS_AS(f.get_buffer(range<2> { 100, 1000 }),
+                      invalid_parameter_error);
+  }
+  std::remove(path.c_str());
+}
+
+TEST_CASE("writable mapped files", "[mapped_file]") {
+  auto path = make_file();
+  for (auto mode : { file_mapping::copy_on_write, file_mapping::shared }) {
+    {
+      mapped_file<int> f { path, mode, file_access::random };
+      auto b = f.get_buffer();
+      queue q;
+      q.submit([&](handler &cgh) {
+          auto a = b.get_access<access::mode::read_write>(cgh);
+          cgh.parallel_for<class mapped_write>(range<1> { n },
+                                               [=](id<1> x) { a[x] += 1; });
+        });
+      // The buffer sees its modifications in both cases
+      REQUIRE(b.get_access<access::mode::read>()[n - 1] == int(n));
+    }
+    // But only a shared mapping writes them to the file
+    REQUIRE(read_file(path, n - 1)
+            == int(n - 1) + (mode == file_mapping::shared));
+  }
+  std::remove(path.c_str());
+}
+
+TEST_CASE("missing mapped file", "[mapped_file]") {
+  REQUIRE_THROWS_AS(mapped_file<const int> { "/nonexistent/file" },
+                    runtime_error);
+}
@@ -0,0 +1,96 @@
+/* RUN: %{execute}%s
+
+   Pad the rows of some 2D buffers to avoid the cache aliasing of the
+   columns
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t rows = 64;
+constexpr std::size_t columns = 1024;
+
+TEST_CASE("automatic row pitch", "[padded_rows]") {
+  queue q;
+  buffer<float, 2> a { range<2> { rows, columns },
+                       property::buffer::row_pitch {} };
+  buffer<float, 2> b { range<2> { rows, 1000 },
+                       property::buffer::row_pitch {} };
+  q.submit([&](handler &cgh) {
+      auto w = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(a.get_range(), [=] (id<2> i) {
+          w[i] = i[0]*columns + i[1];
+        });
+    });
+  // 4 KiB rows get one more cache line, the others stay dense
+  auto ha = a.get_access<access::mode::read>();
+  REQUIRE(ha.get_row_pitch() == columns + 16);
+  REQUIRE(b.get_access<access::mode::read>().get_row_pitch() == 1000);
+  REQUIRE(ha.get_count() == rows*columns);
+  // The range of the accessor goes through the padding too
+  REQUIRE(ha.size() == std::size_t(ha.end() - ha.begin()));
+  REQUIRE(ha.size() == rows*(columns + 16));
+  for (std::size_t i = 0; i < rows; ++i)
+    for (std::size_t j = 0; j < columns; ++j)
+      REQUIRE(ha[i][j] == i*columns + j);
+  auto v = ha.get_view();
+  REQUIRE(v[id<2> { 3, 5 }] == 3*columns + 5);
+  REQUIRE(v[3][5] == 3*columns + 5);
+}
+
+
+TEST_CASE("explicit row pitch and copies", "[padded_rows]") {
+  queue q;
+  constexpr std::size_t pitch = columns + 7;
+  buffer<int, 2> a { range<2> { rows, columns },
+                     property::buffer::row_pitch { pitch } };
+  std::vector<int> in(rows*columns), out(rows*columns);
+  for (std::size_t i = 0; i < in.size(); ++i)
+    in[i] = i;
+  q.submit([&](handler &cgh) {
+      auto w = a.get_access<access::mode::discard_write>(cgh);
+      cgh.copy(in.data(), w);
+    });
+  q.submit([&](handler &cgh) {
+      auto rw = a.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(a.get_range(), [=] (id<2> i) { rw[i] += 1; });
+    });
+  q.submit([&](handler &cgh) {
+      auto r = a.get_access<access::mode::read>(cgh);
+      cgh.copy(r, out.data());
+    }).wait();
+  for (std::size_t i = 0; i < out.size(); ++i)
+    REQUIRE(out[i] == in[i] + 1);
+  auto h = a.get_access<access::mode::read>();
+  REQUIRE(h.get_row_pitch() == pitch);
+  REQUIRE(h.get_pointer()[pitch] == columns + 1);
+  REQUIRE_THROWS_AS((buffer<int, 2> { range<2> { rows, columns },
+                                      property::buffer::row_pitch { 8 } }),
+                    invalid_object_error);
+}
+
+
+TEST_CASE("write-back of padded rows", "[padded_rows]") {
+  std::vector<int> out(rows*columns);
+  {
+    buffer<int, 2> a { range<2> { rows, columns },
+                       property::buffer::row_pitch {} };
+    a.set_final_data(out.data());
+    queue {}.submit([&](handler &cgh) {
+        auto w = a.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(a.get_range(), [=] (id<2> i) {
+            w[i] = i[0]*columns + i[1];
+          });
+      });
+    REQUIRE_THROWS_AS((buffer<int, 2> { a, id<2> { 0, 0 },
+                                        range<2> { 2, columns } }),
+                      invalid_object_error);
+  }
+  for (std::size_t i = 0; i < out.size(); ++i)
+    REQUIRE(out[i] == i);
+}
@@ -0,0 +1,116 @@
+/* RUN: %{execute}%s
+
+   Check the accessors to some parts of a buffer
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 100;
+
+/// Wait up to 10 s for a flag and return whether it has been set
+bool wait_for(const std::atomic<bool> &flag) {
+  auto start = std::chrono::steady_clock::now();
+  while (!flag && std::chrono::steady_clock::now() - start
+                  < std::chrono::seconds { 10 })
+    std::this_thread::yield();
+  return flag;
+}
+
+TEST_CASE("writers of disjoint parts run concurrently", "[buffer]") {
+  queue q { property::queue::worker_threads { 2 } };
+  buffer<int> b { n };
+  std::atomic<bool> first_started = false;
+  std::atomic<bool> second_started = false;
+  std::atomic<bool> overlapped = false;
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh,
+                                                          range<1> { n/2 });
+      cgh.single_task<class first_half>([=, &first_started,
+                                         &second_started] {
+          first_started = true;
+          wait_for(second_started);
+          for (int i = 0; i < n/2; ++i)
+            a[i] = 1;
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh,
+                                                          range<1> { n/2 },
+                                                          id<1> { n/2 });
+      cgh.single_task<class second_half>([=, &first_started,
+                                          &second_started, &overlapped] {
+          second_started = true;
+          overlapped = wait_for(first_started);
+          for (int i = n/2; i < n; ++i)
+            a[i] = 2;
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  REQUIRE(overlapped);
+  for (int i = 0; i < n; ++i)
+    REQUIRE(a[i] == (i < n/2 ? 1 : 2));
+}
+
+TEST_CASE("overlapping parts are accessed in order", "[buffer]") {
+  queue q { property::queue::worker_threads { 2 } };
+  buffer<int> b { n };
+  {
+    auto a = b.get_access<access::mode::discard_write>();
+    for (int i = 0; i < n; ++i)
+      a[i] = 0;
+  }
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh, range<1> { 60 });
+      cgh.single_task<class slow_writer>([=] {
+          std::this_thread::sleep_for(std::chrono::milliseconds { 50 });
+          for (int i = 0; i < 60; ++i)
+            a[i] = 1;
+        });
+    });
+  // Read after write on [50, 60)
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh, range<1> { 50 },
+                                                      id<1> { 50 });
+      cgh.single_task<class reader>([=] {
+          for (int i = 50; i < n; ++i)
+            a[i] += 10;
+        });
+    });
+  // Write after read and write on everything
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class whole>(range<1> { n },
+                                    [=](id<1> i) { a[i] *= 2; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (int i = 0; i < n; ++i)
+    REQUIRE(a[i] == 2*(i < 50 ? 1 : i < 60 ? 11 : 10));
+}
+
+TEST_CASE("ranged access in 2 dimensions", "[buffer]") {
+  buffer<int, 2> b { range<2> { 4, 8 } };
+  {
+    auto a = b.get_access<access::mode::discard_write>();
+    for (int i = 0; i < 32; ++i)
+      a.get_pointer()[i] = 0;
+  }
+  queue {}.submit([&](handler &cgh) {
+      // Rows 1 and 2
+      auto a = b.get_access<access::mode::write>(cgh, range<2> { 2, 8 },
+                                                 id<2> { 1, 0 });
+      cgh.single_task<class rows>([=] {
+          for (int i = 8; i < 24; ++i)
+            a.get_pointer()[i] = 1;
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (int i = 0; i < 32; ++i)
+    REQUIRE(a.get_pointer()[i] == (i >= 8 && i < 24));
+}
@@ -0,0 +1,94 @@
+/* RUN: %{execute}%s
+
+   Test the reinterpreted views of the storage of a buffer
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 64;
+
+TEST_CASE("a view shares the storage of its buffer", "[reinterpret]") {
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), 0);
+  {
+    buffer<int> b { v.data(), n };
+    auto rows = b.reinterpret<int, 2>(range<2> { n/4, 4 });
+    REQUIRE(rows.get_range() == range<2> { n/4, 4 });
+    auto bytes = b.reinterpret<std::uint8_t>();
+    REQUIRE(bytes.get_count() == n*sizeof(int));
+    queue q;
+    q.submit([&](handler &cgh) {
+        auto a = rows.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for<class reinterpret_rows>(
+          range<2> { n/4, 4 }, [=](id<2> i) { a[i] += 1000*i[1]; });
+      });
+    // The host accessor on the buffer waits for the kernel on the view
+    auto a = b.get_access<access::mode::read>();
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE(a[i] == int(i + 1000*(i % 4)));
+  }
+  // Writing through the view is written back by the buffer
+  REQUIRE(v[n - 1] == int(n - 1 + 3000));
+}
+
+TEST_CASE("views of the same storage depend on each other",
+          "[reinterpret]") {
+  buffer<float> b { n };
+  auto words = b.reinterpret<std::uint32_t>();
+  queue q;
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class reinterpret_fill>(range<1> { n },
+                                               [=](id<1> i) { a[i] = -1; });
+    });
+  // Clear the sign bits, after the previous kernel
+  q.submit([&](handler &cgh) {
+      auto a = words.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class reinterpret_abs>(range<1> { n }, [=](id<1> i) {
+          a[i] &= 0x7fffffff;
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == 1);
+}
+
+TEST_CASE("view of a sub-buffer", "[reinterpret]") {
+  buffer<std::uint16_t> b { n };
+  {
+    auto a = b.get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i < n; ++i)
+      a[i] = i;
+  }
+  buffer<std::uint16_t> high { b, n/2, n/2 };
+  auto pairs = high.reinterpret<std::uint32_t>();
+  REQUIRE(pairs.get_count() == n/4);
+  {
+    auto a = pairs.get_access<access::mode::write>();
+    a[0] = 0;
+  }
+  auto a = b.get_access<access::mode::read>();
+  REQUIRE(a[n/2 - 1] == n/2 - 1);
+  REQUIRE(a[n/2] == 0);
+  REQUIRE(a[n/2 + 1] == 0);
+  REQUIRE(a[n/2 + 2] == n/2 + 2);
+}
+
+TEST_CASE("invalid views", "[reinterpret]") {
+  buffer<int> b { n };
+  REQUIRE_THROWS_AS((b.reinterpret<int, 2>(range<2> { n, 2 })),
+                    invalid_object_error);
+  buffer<char> chars { 7 };
+  REQUIRE_THROWS_AS(chars.reinterpret<short>(), invalid_object_error);
+  buffer<char> s { chars, 1, 4 };
+  // Not aligned for an int
+  REQUIRE_THROWS_AS(s.reinterpret<int>(), invalid_object_error);
+}
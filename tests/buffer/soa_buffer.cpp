@@ -0,0 +1,58 @@
+/* RUN: %{execute}%s
+
+   Use a buffer of structures laid out as a structure of arrays
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/soa_buffer.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+struct particle {
+  float x, y, z;
+  int tag;
+};
+
+constexpr std::size_t n = 1000;
+
+using particles = vendor::trisycl::soa_buffer<particle, 1, &particle::x,
+                                              &particle::y, &particle::z,
+                                              &particle::tag>;
+
+TEST_CASE("structure of arrays", "[soa_buffer]") {
+  std::vector<particle> aos(n);
+  for (std::size_t i = 0; i != n; ++i)
+    aos[i] = { 1.f*i, 2.f*i, 0, static_cast<int>(i) };
+  particles p { aos.data(), range<1> { n } };
+  queue q;
+  // A kernel written for an array of structures
+  q.submit([&](handler &cgh) {
+      auto a = p.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          particle e = a[i];
+          e.z = e.x + e.y;
+          a[i] = e;
+          a[i].get<&particle::tag>() += 1;
+        });
+    });
+  // A kernel touching only one field, on contiguous memory
+  q.submit([&](handler &cgh) {
+      auto x = p.field<&particle::x>()
+        .get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { x[i] *= 2; });
+    });
+  p.copy_to(aos.data());
+  for (std::size_t i = 0; i != n; ++i) {
+    REQUIRE(aos[i].x == 2.f*i);
+    REQUIRE(aos[i].y == 2.f*i);
+    REQUIRE(aos[i].z == 3.f*i);
+    REQUIRE(aos[i].tag == static_cast<int>(i) + 1);
+  }
+  // The fields are contiguous
+  auto a = p.get_access<access::mode::read>();
+  REQUIRE(&a.field<&particle::y>()[1] == &a.field<&particle::y>()[0] + 1);
+}
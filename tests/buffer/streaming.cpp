@@ -0,0 +1,64 @@
+/* RUN: %{execute}%s
+
+   Check the streaming of some kernels by chunks over host data
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/streaming.hpp>
+
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using vendor::trisycl::stream_chunk;
+using vendor::trisycl::streaming;
+
+TEST_CASE("1D stencil with a halo", "[streaming]") {
+  constexpr std::size_t n = 100;
+  std::vector<int> input(n), output(n);
+  for (std::size_t i = 0; i != n; ++i)
+    input[i] = i*i;
+  // Some chunks not dividing the range, with only 2 in flight
+  streaming s { queue {}, 7, 1, 2 };
+  const int *in_data = input.data();
+  s.parallel_for(range<1> { n },
+                 [&](handler &cgh, stream_chunk<1> &c) {
+                   auto in = c.get_access<access::mode::read>(cgh, in_data);
+                   auto out = c.get_access<access::mode::discard_write>(
+                     cgh, output.data());
+                   cgh.parallel_for(c.get_range(),
+                                    [=, o = c.get_offset(), h = c.get_halo()]
+                                    (id<1> i) {
+                     // The global index and the index in the input
+                     auto g = i[0] + o[0];
+                     auto j = i[0] + h[0];
+                     auto left = g == 0 ? 0 : in[j - 1];
+                     auto right = g == n - 1 ? 0 : in[j + 1];
+                     out[i] = left + in[j] + right;
+                   });
+                 });
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(output[i] == (i == 0 ? 0 : input[i - 1]) + input[i]
+            + (i == n - 1 ? 0 : input[i + 1]));
+}
+
+TEST_CASE("2D element-wise kernel in place", "[streaming]") {
+  constexpr std::size_t rows = 50;
+  constexpr std::size_t columns = 30;
+  std::vector<float> data(rows*columns);
+  for (std::size_t i = 0; i != data.size(); ++i)
+    data[i] = i;
+  streaming s { queue {}, 8 };
+  s.parallel_for(range<2> { rows, columns },
+                 [&](handler &cgh, stream_chunk<2> &c) {
+                   auto a = c.get_access<access::mode::read_write>(
+                     cgh, data.data());
+                   cgh.parallel_for(c.get_range(), [=](id<2> i) {
+                       a[i] = 2*a[i] + 1;
+                     });
+                 });
+  for (std::size_t i = 0; i != data.size(); ++i)
+    REQUIRE(data[i] == 2*float(i) + 1);
+}
@@ -0,0 +1,93 @@
+/* RUN: %{execute}%s
+
+   Test the sub-buffers aliasing the storage of their parent buffer
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 64;
+
+TEST_CASE("sub-buffers alias their parent", "[sub_buffer]") {
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), 0);
+  {
+    buffer<int> b { v.data(), n };
+    buffer<int> low { b, 0, n/2 };
+    buffer<int> high { b, n/2, n/2 };
+    REQUIRE(!b.is_sub_buffer());
+    REQUIRE(low.is_sub_buffer());
+    REQUIRE(high.get_count() == n/2);
+    queue q;
+    // Kernels on disjoint sub-buffers do not depend on each other
+    for (auto *s : { &low, &high })
+      q.submit([&](handler &cgh) {
+          auto a = s->get_access<access::mode::read_write>(cgh);
+          cgh.parallel_for<class sub_buffer_increment>(
+            range<1> { n/2 }, [=](id<1> i) { a[i] += 1000; });
+        });
+    // The parent buffer waits for all its sub-buffers
+    auto a = b.get_access<access::mode::read>();
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE(a[i] == int(i) + 1000);
+    // And the sub-buffers see the data of their parent
+    auto h = high.get_access<access::mode::read>();
+    REQUIRE(h[0] == int(n/2) + 1000);
+  }
+  REQUIRE(v[n - 1] == int(n - 1) + 1000);
+}
+
+TEST_CASE("sub-buffer after a kernel on the parent", "[sub_buffer]") {
+  buffer<int> b { n };
+  buffer<int> middle { b, 8, 16 };
+  queue q;
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class parent_fill>(range<1> { n },
+                                          [=](id<1> i) { a[i] = i[0]; });
+    });
+  // This kernel has to wait for the previous one on the parent
+  q.submit([&](handler &cgh) {
+      auto a = middle.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class sub_buffer_double>(range<1> { 16 },
+                                                [=](id<1> i) { a[i] *= 2; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == int(i >= 8 && i < 24 ? 2*i : i));
+}
+
+TEST_CASE("2D sub-buffers of full rows", "[sub_buffer]") {
+  buffer<int, 2> b { range<2> { 8, 4 } };
+  {
+    auto a = b.get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i < b.get_count(); ++i)
+      a.get_pointer()[i] = i;
+  }
+  buffer<int, 2> rows { b, id<2> { 2, 0 }, range<2> { 3, 4 } };
+  REQUIRE(rows.get_count() == 12);
+  auto a = rows.get_access<access::mode::read>();
+  // The rows are contiguous in the storage of the parent
+  REQUIRE(a.get_pointer()[0] == 8);
+  REQUIRE(a.get_pointer()[11] == 19);
+  // Part of a single row is also contiguous
+  buffer<int, 2> part { b, id<2> { 5, 1 }, range<2> { 1, 2 } };
+  REQUIRE(part.get_access<access::mode::read>().get_pointer()[1] == 22);
+}
+
+TEST_CASE("invalid sub-buffers", "[sub_buffer]") {
+  buffer<int> b { n };
+  REQUIRE_THROWS_AS((buffer<int> { b, n/2, n }), invalid_object_error);
+  buffer<int> s { b, 0, n/2 };
+  REQUIRE_THROWS_AS((buffer<int> { s, 0, 1 }), invalid_object_error);
+  buffer<int, 2> b2 { range<2> { 8, 4 } };
+  // Not full rows, so not contiguous
+  REQUIRE_THROWS_AS((buffer<int, 2> { b2, id<2> { 0, 1 }, range<2> { 2, 2 } }),
+                    invalid_object_error);
+}
@@ -0,0 +1,46 @@
+/* RUN: %{execute}%s
+
+   A dataflow region with stages connected by some FIFOs, running
+   concurrently in emulation as on the FPGA
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int N = 10000;
+constexpr int ALPHA = 3;
+
+using Type = int;
+
+TEST_CASE("dataflow stages connected by streams", "[FPGA]") {
+  buffer<Type> a { N };
+
+  queue {}.submit([&] (handler &cgh) {
+      auto a_a = a.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task<class dataflow_stream>([=] {
+          // The FIFOs are much smaller than the data, so the stages
+          // cannot run one after another
+          vendor::xilinx::stream<Type, 4> in;
+          vendor::xilinx::stream<Type> out;
+          vendor::xilinx::dataflow(
+            [&] {
+              for (int i = 0; i < N; ++i)
+                in << i;
+            },
+            [&] {
+              for (int i = 0; i < N; ++i)
+                out.write(in.read()*ALPHA);
+            },
+            [&] {
+              for (int i = 0; i < N; ++i)
+                out >> a_a[i];
+            });
+        });
+    });
+
+  auto a_a = a.get_access<access::mode::read>();
+  for (int i = 0; i < N; ++i)
+    REQUIRE(a_a[i] == i*ALPHA);
+}
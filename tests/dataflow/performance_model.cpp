@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   Estimate the cycles of an FPGA-style kernel from its decorations
+*/
+#define TRISYCL_XILINX_PERFORMANCE_MODEL
+
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int N = 64;
+
+TEST_CASE("performance model of the pipelined loops", "[FPGA]") {
+  auto &model = vendor::xilinx::performance_model::instance();
+  model.reset();
+  model.set_pipeline_depth(8);
+
+  queue {}.submit([&] (handler &cgh) {
+      cgh.single_task<class modeled>([=] {
+          vendor::xilinx::partition_array<int, N> a;
+          vendor::xilinx::partition_array<int, N,
+                                          vendor::xilinx::partition::cyclic<4>>
+            b;
+          // 4 accesses to the same memory, with only 2 ports
+          for (int i = 0; i < N/4; ++i)
+            vendor::xilinx::pipeline([&] {
+                a[4*i] = a[4*i + 1] + a[4*i + 2] + a[4*i + 3];
+              });
+          // The same accesses in 4 different memories
+          for (int i = 0; i < N/4; ++i)
+            vendor::xilinx::pipeline([&] {
+                b[4*i] = b[4*i + 1] + b[4*i + 2] + b[4*i + 3];
+              });
+        });
+    }).wait();
+
+  auto estimates = model.get_estimates();
+  REQUIRE(estimates.size() == 1);
+  auto &k = estimates[0];
+  REQUIRE(k.launches == 1);
+  REQUIRE(k.loops.size() == 2);
+  // The loop on the unpartitioned array is the longest
+  REQUIRE(k.loops[0].achieved_ii == 2);
+  REQUIRE(k.loops[0].target_ii == 1);
+  REQUIRE(k.loops[0].cycles == 2*N/4 + 7);
+  REQUIRE(k.loops[1].achieved_ii == 1);
+  REQUIRE(k.loops[1].cycles == N/4 + 7);
+  REQUIRE(k.cycles == k.loops[0].cycles + k.loops[1].cycles);
+  model.reset();
+}
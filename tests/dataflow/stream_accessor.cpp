@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   A streaming kernel reading and writing its accessors only in order,
+   through some dataflow stages
+*/
+#include <CL/sycl.hpp>
+
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int N = 10000;
+constexpr int ALPHA = 3;
+
+using Type = int;
+
+TEST_CASE("stream accessors", "[FPGA]") {
+  buffer<Type> a { N };
+  buffer<Type> b { N };
+  {
+    auto a_a = a.get_access<access::mode::discard_write>();
+    std::iota(a_a.begin(), a_a.end(), 0);
+  }
+
+  queue {}.submit([&] (handler &cgh) {
+      auto a_a = a.get_access<access::mode::read>(cgh);
+      auto a_b = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task<class stream_accessor>([=] {
+          vendor::xilinx::stream_accessor<const Type> in { a_a };
+          vendor::xilinx::stream_accessor out { a_b };
+          vendor::xilinx::stream<Type> s;
+          vendor::xilinx::dataflow(
+            [&] {
+              while (!in.empty())
+                s << in.read()*ALPHA;
+            },
+            [&] {
+              while (!out.empty()) {
+                Type v;
+                s >> v;
+                out << v;
+              }
+            });
+        });
+    });
+
+  auto a_b = b.get_access<access::mode::read>();
+  for (int i = 0; i < N; ++i)
+    REQUIRE(a_b[i] == i*ALPHA);
+}
@@ -0,0 +1,56 @@
+/* RUN: %{execute}%s
+
+   Test the cache of the objects wrapping the OpenCL ones
+*/
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/detail/cache.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("concurrent lookups create a value only once", "[cache]") {
+  trisycl::detail::cache<const void *, int> c;
+  std::vector<int> keys(64);
+  std::atomic<int> created = 0;
+  // Keep the values alive so they stay in the cache
+  std::vector<std::shared_ptr<int>> values(keys.size());
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 8; ++t)
+    threads.emplace_back([&, t] {
+        for (int r = 0; r != 1000; ++r)
+          for (std::size_t k = 0; k != keys.size(); ++k) {
+            auto v = c.get_or_register(&keys[k], [&] {
+                ++created;
+                return new int { static_cast<int>(k) };
+              });
+            REQUIRE(*v == static_cast<int>(k));
+            if (t == 0 && r == 0)
+              values[k] = v;
+          }
+      });
+  for (auto &t : threads)
+    t.join();
+  REQUIRE(created == static_cast<int>(keys.size()));
+}
+
+
+TEST_CASE("an expired or removed value is created again", "[cache]") {
+  trisycl::detail::cache<int, int> c;
+  int created = 0;
+  auto create = [&] { return new int { ++created }; };
+  {
+    auto v = c.get_or_register(1, create);
+    REQUIRE(*c.get_or_register(1, create) == 1);
+  }
+  // The value has expired and is replaced
+  auto v = c.get_or_register(1, create);
+  REQUIRE(*v == 2);
+  REQUIRE(*c.get_or_register(1, create) == 2);
+  c.remove(1);
+  REQUIRE(*c.get_or_register(1, create) == 3);
+}
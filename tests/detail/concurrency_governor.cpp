@@ -0,0 +1,55 @@
+/* RUN: %{execute}%s
+
+   Test the sharing of the threads among the concurrent kernels
+*/
+
+#include <optional>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using trisycl::detail::concurrency_governor;
+
+TEST_CASE("the budget is shared by the running kernels",
+          "[concurrency_governor]") {
+  concurrency_governor g { 8 };
+  REQUIRE(g.get_budget() == 8);
+  std::optional<concurrency_governor::share> first { g.acquire() };
+  // Alone, a kernel uses all the threads
+  REQUIRE(first->get_threads() == 8);
+  {
+    // Nothing is left but a kernel always progresses
+    auto second = g.acquire();
+    REQUIRE(second.get_threads() == 1);
+    first.reset();
+    // Half of the budget for 2 kernels
+    auto third = g.acquire();
+    REQUIRE(third.get_threads() == 4);
+    auto fourth = g.acquire();
+    REQUIRE(fourth.get_threads() == 2);
+  }
+  // Everything has been given back
+  REQUIRE(g.acquire().get_threads() == 8);
+}
+
+TEST_CASE("concurrent kernels with the global governor",
+          "[concurrency_governor]") {
+  REQUIRE(concurrency_governor::instance().get_budget() >= 1);
+  constexpr std::size_t n = 1000;
+  trisycl::queue q;
+  trisycl::buffer<int> b[4] = { { n }, { n }, { n }, { n } };
+  for (int k = 0; k < 4; ++k)
+    q.submit([&](trisycl::handler &cgh) {
+        auto a = b[k].get_access<trisycl::access::mode::discard_write>(cgh);
+        cgh.parallel_for(trisycl::range<1> { n }, [=](trisycl::id<1> i) {
+            a[i] = k*i[0];
+          });
+      });
+  for (int k = 0; k < 4; ++k) {
+    auto a = b[k].get_access<trisycl::access::mode::read>();
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE(a[i] == int(k*i));
+  }
+}
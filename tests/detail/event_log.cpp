@@ -0,0 +1,51 @@
+/* RUN: %{execute}%s
+
+   Test the binary event log behind TRISYCL_DUMP_T()
+*/
+#define TRISYCL_EVENT_LOG
+#include "triSYCL/detail/debug.hpp"
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl::detail;
+
+TEST_CASE("events of several threads", "[event_log]") {
+  std::ostringstream out;
+  auto saved = std::clog.rdbuf(out.rdbuf());
+  int i = 42;
+  auto p = std::make_shared<int>(3);
+  TRISYCL_DUMP_T("Event with " << i << " and " << p << " in " << 2.5
+                 << " and a dropped " << 7);
+  std::thread { [] { TRISYCL_DUMP_T("Event from another thread"); } }.join();
+  event_log::instance().flush();
+  std::clog.rdbuf(saved);
+  auto log = out.str();
+  std::ostringstream pointer;
+  pointer << static_cast<const void *>(p.get());
+  REQUIRE(log.find("\"Event with \" << i << \" and \" << p")
+          != std::string::npos);
+  REQUIRE(log.find("[42, " + pointer.str() + ", 2.5]\n")
+          != std::string::npos);
+  REQUIRE(log.find("\"Event from another thread\"\n") != std::string::npos);
+  REQUIRE(log.find(" thread 1 ") != std::string::npos);
+}
+
+TEST_CASE("lost events are reported", "[event_log]") {
+  std::ostringstream out;
+  auto saved = std::clog.rdbuf(out.rdbuf());
+  // Far more events than the ring can hold before being decoded
+  std::thread { [] {
+      for (int i = 0; i != 100000; ++i)
+        TRISYCL_DUMP_T("Event " << i);
+    } }.join();
+  event_log::instance().flush();
+  std::clog.rdbuf(saved);
+  auto log = out.str();
+  REQUIRE(log.find("[99999]\n") != std::string::npos);
+}
@@ -6,6 +6,8 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 /// Test explicitly a feature of triSYCL, so include the triSYCL header
 #include "triSYCL/detail/fiber_pool.hpp"
@@ -97,3 +99,52 @@ TEST_CASE("fiber_pool", "[detail]") {
                       true);
         }
 }
+
+
+TEST_CASE("fiber_pool submissions", "[detail]") {
+  using trisycl::detail::fiber_pool;
+  for (auto scheduler : { fiber_pool::sched::round_robin,
+                          fiber_pool::sched::shared_work,
+                          fiber_pool::sched::work_stealing }) {
+    fiber_pool fp { 2, scheduler, false };
+    constexpr int n = 100;
+    // Several threads submit at the same time
+    std::vector<std::thread> producers;
+    std::vector<fiber_pool::future<int>> futures[3];
+    for (auto &fs : futures)
+      producers.emplace_back([&] {
+          for (int i = 0; i != n; ++i)
+            fs.push_back(fp.submit([i] { return i; }));
+        });
+    for (auto &p : producers)
+      p.join();
+    for (auto &fs : futures)
+      for (int i = 0; i != n; ++i)
+        REQUIRE(fs[i].get() == i);
+
+    // A fiber of the pool starts its children on its own thread
+    auto parent = fp.submit([&] {
+        auto children = fp.submit_n(n, [] (std::size_t i) {
+            boost::this_fiber::yield();
+            return 2*i;
+          });
+        std::size_t sum = 0;
+        for (auto &c : children)
+          sum += c.get();
+        return sum;
+      });
+    REQUIRE(parent.get() == n*(n - 1));
+
+    // Some detached children are waited for by join()
+    std::atomic<int> done = 0;
+    fp.submit([&] {
+        for (int i = 0; i != n; ++i)
+          fp.submit([&] {
+              boost::this_fiber::yield();
+              ++done;
+            });
+      });
+    fp.join();
+    REQUIRE(done == n);
+  }
+}
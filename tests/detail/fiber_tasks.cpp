@@ -0,0 +1,83 @@
+/* RUN: %{execute}%s
+
+   Test the execution of the SYCL tasks as fibers
+*/
+
+/// Run each task on a fiber instead of on its own thread
+#define TRISYCL_FIBER_TASKS
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("blocking pipe pipeline on 1 thread", "[fiber_tasks]") {
+  // More stages than threads, all blocked on each other at some point
+  constexpr int stages = 20;
+  constexpr int n = 100;
+  trisycl::queue q { trisycl::property::queue::worker_threads { 1 } };
+  REQUIRE(q.implementation->get_worker_pool()->get_capacity() == 1);
+
+  std::vector<trisycl::sycl_2_2::pipe<int>> pipes;
+  for (int i = 0; i <= stages; ++i)
+    pipes.emplace_back(1);
+  trisycl::buffer<int> result { n };
+
+  // Submit the consumer first so it blocks before anything is produced
+  q.submit([&](trisycl::handler &cgh) {
+      auto in = pipes[stages].get_access<trisycl::access::mode::read,
+                                         trisycl::access::target::blocking_pipe>
+        (cgh);
+      auto r = result.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.single_task([=] {
+          for (int i = 0; i < n; ++i)
+            r[i] = in.read();
+        });
+    });
+  for (int s = stages - 1; s >= 0; --s)
+    q.submit([&](trisycl::handler &cgh) {
+        auto in = pipes[s].get_access<trisycl::access::mode::read,
+                                      trisycl::access::target::blocking_pipe>
+          (cgh);
+        auto out = pipes[s + 1].get_access<trisycl::access::mode::write,
+                                           trisycl::access::target::blocking_pipe>
+          (cgh);
+        cgh.single_task([=] {
+            for (int i = 0; i < n; ++i)
+              out.write(in.read() + 1);
+          });
+      });
+  q.submit([&](trisycl::handler &cgh) {
+      auto out = pipes[0].get_access<trisycl::access::mode::write,
+                                     trisycl::access::target::blocking_pipe>
+        (cgh);
+      cgh.single_task([=] {
+          for (int i = 0; i < n; ++i)
+            out.write(i);
+        });
+    });
+  q.wait();
+
+  auto r = result.get_access<trisycl::access::mode::read>();
+  for (int i = 0; i < n; ++i)
+    REQUIRE(r[i] == i + stages);
+}
+
+TEST_CASE("dependent kernels waiting on fibers", "[fiber_tasks]") {
+  trisycl::queue q { trisycl::property::queue::worker_threads { 2 } };
+  trisycl::buffer<int> b { 1 };
+  {
+    auto a = b.get_access<trisycl::access::mode::discard_write>();
+    a[0] = 0;
+  }
+  // A long dependency chain where each task waits for its producer
+  for (int i = 0; i < 100; ++i)
+    q.submit([&](trisycl::handler &cgh) {
+        auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+        cgh.single_task([=] { ++a[0]; });
+      });
+  auto a = b.get_access<trisycl::access::mode::read>();
+  REQUIRE(a[0] == 100);
+}
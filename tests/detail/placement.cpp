@@ -0,0 +1,60 @@
+/* RUN: %{execute}%s
+
+   Test the placement of the threads and of the memory on NUMA nodes
+*/
+
+#include <vector>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using trisycl::detail::placement;
+
+TEST_CASE("parse the Linux lists", "[placement]") {
+  REQUIRE(placement::parse_list("0-3,8,10-11\n")
+          == std::vector<unsigned> { 0, 1, 2, 3, 8, 10, 11 });
+  REQUIRE(placement::parse_list("5") == std::vector<unsigned> { 5 });
+  REQUIRE(placement::parse_list("").empty());
+  REQUIRE(placement::parse_list("x").empty());
+}
+
+TEST_CASE("slices are mapped to the nodes in order", "[placement]") {
+  placement p { { { 0, 1 }, { 2, 3 } } };
+  REQUIRE(p.cpus() == std::vector<unsigned> { 0, 1, 2, 3 });
+  REQUIRE(p.node_of(0, 8) == 0);
+  REQUIRE(p.node_of(3, 8) == 0);
+  REQUIRE(p.node_of(4, 8) == 1);
+  REQUIRE(p.node_of(7, 8) == 1);
+  // With fewer threads than nodes
+  REQUIRE(p.node_of(0, 1) == 0);
+}
+
+#ifdef __linux__
+TEST_CASE("first touch and a queue on a NUMA node", "[placement]") {
+  // There is always a node 0 on Linux
+  auto p = placement::from_nodes({ 0 });
+  REQUIRE(p.nodes.size() == 1);
+  std::vector<char> memory(4*placement::first_touch_threshold, 1);
+  p.first_touch(memory.data(), memory.size());
+  REQUIRE(memory[0] == 0);
+  REQUIRE(memory[placement::page_size] == 0);
+  REQUIRE(memory[1] == 1);
+
+  trisycl::queue q { trisycl::property::queue::numa_node { 0 } };
+  REQUIRE(q.get_property<trisycl::property::queue::numa_node>().get_node()
+          == 0);
+  constexpr std::size_t n = 1000;
+  trisycl::buffer<int> b { n };
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<1> { n }, [=](trisycl::id<1> i) {
+          a[i] = i[0];
+        });
+    });
+  auto a = b.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == int(i));
+}
+#endif
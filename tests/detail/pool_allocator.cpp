@@ -0,0 +1,82 @@
+/* RUN: %{execute}%s
+
+   Test the pool_allocator recycling the memory of the tasks
+*/
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using trisycl::detail::pool_allocator;
+
+// Use a type specific to this test to have its own free-list
+struct payload {
+  std::array<double, 5> data;
+};
+
+TEST_CASE("a released object is recycled", "[pool_allocator]") {
+  pool_allocator<payload> a;
+  auto p = a.allocate(1);
+  a.deallocate(p, 1);
+  auto q = a.allocate(1);
+  REQUIRE(q == p);
+  // Several objects at once are not pooled but still work
+  auto array = a.allocate(3);
+  REQUIRE(array != q);
+  a.deallocate(array, 3);
+  a.deallocate(q, 1);
+}
+
+TEST_CASE("allocate_shared recycles its control block", "[pool_allocator]") {
+  void *first;
+  {
+    auto s = std::allocate_shared<payload>(pool_allocator<payload> {});
+    first = s.get();
+  }
+  auto s = std::allocate_shared<payload>(pool_allocator<payload> {});
+  REQUIRE(s.get() == first);
+}
+
+TEST_CASE("concurrent allocations and releases", "[pool_allocator]") {
+  // Catch2 assertions are not thread-safe
+  std::atomic<bool> corrupted = false;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&] {
+        pool_allocator<payload> a;
+        for (int i = 0; i < 10000; ++i) {
+          std::array<payload *, 8> p;
+          for (auto &e : p) {
+            e = a.allocate(1);
+            e->data[0] = i;
+          }
+          for (auto e : p) {
+            if (e->data[0] != i)
+              corrupted = true;
+            a.deallocate(e, 1);
+          }
+        }
+      });
+  for (auto &t : threads)
+    t.join();
+  REQUIRE(!corrupted);
+}
+
+TEST_CASE("a chain of tasks using recycled memory", "[pool_allocator]") {
+  trisycl::queue q;
+  int v = 0;
+  trisycl::buffer<int> b { &v, 1 };
+  for (int i = 0; i < 100; ++i)
+    q.submit([&](trisycl::handler &cgh) {
+        auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+        cgh.single_task([=] { ++a[0]; });
+      });
+  REQUIRE(b.get_access<trisycl::access::mode::read>()[0] == 100);
+}
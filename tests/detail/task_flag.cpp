@@ -0,0 +1,54 @@
+/* RUN: %{execute}%s
+
+   Test the flag and the counter the tasks wait on
+*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("the waiters of a flag see the data set before it", "[task_flag]") {
+  for (int r = 0; r != 100; ++r) {
+    trisycl::detail::task_flag f;
+    int data = 0;
+    std::atomic<int> seen = 0;
+    std::vector<std::thread> waiters;
+    for (int i = 0; i != 4; ++i)
+      waiters.emplace_back([&] {
+          f.wait();
+          if (data == 42)
+            ++seen;
+        });
+    REQUIRE(!f.is_set());
+    data = 42;
+    f.set();
+    for (auto &w : waiters)
+      w.join();
+    REQUIRE(f.is_set());
+    REQUIRE(seen == 4);
+  }
+}
+
+
+TEST_CASE("a counter is waited for until it reaches 0", "[task_counter]") {
+  for (int r = 0; r != 100; ++r) {
+    trisycl::detail::task_counter c;
+    // Nothing to wait for
+    c.wait_for_zero();
+    for (int i = 0; i != 8; ++i)
+      c.increment();
+    REQUIRE(c.load() == 8);
+    std::vector<std::thread> users;
+    for (int i = 0; i != 8; ++i)
+      users.emplace_back([&] { c.decrement(); });
+    c.wait_for_zero();
+    REQUIRE(c.load() == 0);
+    for (auto &u : users)
+      u.join();
+  }
+}
@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   Test the recording of the execution timeline in Chrome trace format
+*/
+#define TRISYCL_TIMELINE
+#include "triSYCL/detail/timeline.hpp"
+#include "triSYCL/vendor/triSYCL/profile.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl::detail;
+
+// A kernel name which is only declared
+class some_kernel;
+
+TEST_CASE("spans of several threads", "[timeline]") {
+  {
+    TRISYCL_TIMELINE_SCOPE("task", "main \"quoted\"");
+    std::thread { [] {
+        TRISYCL_TIMELINE_SCOPE("kernel", timeline::type_name<some_kernel>());
+      } }.join();
+  }
+  std::ostringstream o;
+  timeline::instance().write(o);
+  auto json = o.str();
+  REQUIRE(json.find("\"traceEvents\":[") != std::string::npos);
+  REQUIRE(json.find("\"name\":\"main \\\"quoted\\\"\",\"cat\":\"task\","
+                    "\"ph\":\"X\"") != std::string::npos);
+  REQUIRE(json.find("some_kernel*\",\"cat\":\"kernel\"") != std::string::npos);
+  // Each thread has its own track
+  REQUIRE(json.find("\"ph\":\"X\",\"pid\":1,\"tid\":0") != std::string::npos);
+  REQUIRE(json.find("\"ph\":\"X\",\"pid\":1,\"tid\":1") != std::string::npos);
+  REQUIRE(json.find("\"ts\":-") == std::string::npos);
+}
+
+TEST_CASE("phases of the user code", "[timeline]") {
+  {
+    trisycl::vendor::trisycl::profile::scope compute { "compute" };
+    trisycl::vendor::trisycl::profile::scope store { "store", "stencil" };
+  }
+  std::ostringstream o;
+  timeline::instance().write(o);
+  auto json = o.str();
+  REQUIRE(json.find("\"name\":\"compute\",\"cat\":\"user\"")
+          != std::string::npos);
+  REQUIRE(json.find("\"name\":\"store\",\"cat\":\"stencil\"")
+          != std::string::npos);
+}
@@ -0,0 +1,241 @@
+/* RUN: %{execute}%s
+
+   Test the worker_pool executing the SYCL tasks
+*/
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("all the submitted work is executed", "[worker_pool]") {
+  std::atomic<int> counter = 0;
+  {
+    trisycl::detail::worker_pool wp { 2 };
+    REQUIRE(wp.get_capacity() == 2);
+    for (int i = 0; i < 1000; ++i)
+      wp.submit([&] { ++counter; });
+    // The destructor waits for the work to be done
+  }
+  REQUIRE(counter == 1000);
+}
+
+TEST_CASE("work blocking on each other does not dead-lock", "[worker_pool]") {
+  /* Even with 1 worker, a consumer waiting for a later producer has
+     to run, with an extra worker started by the watchdog */
+  trisycl::detail::worker_pool wp { 1 };
+  std::promise<int> p;
+  std::promise<int> result;
+  wp.submit([&] { result.set_value(p.get_future().get() + 1); });
+  wp.submit([&] { p.set_value(41); });
+  REQUIRE(result.get_future().get() == 42);
+}
+
+TEST_CASE("a blocked worker is replaced", "[worker_pool]") {
+  trisycl::detail::worker_pool wp { 1 };
+  std::promise<int> p;
+  std::promise<int> result;
+  wp.submit([&] {
+    trisycl::detail::worker_pool::blocked_scope b;
+    result.set_value(p.get_future().get() + 1);
+  });
+  wp.submit([&] { p.set_value(41); });
+  // Far less than the watchdog period
+  auto f = result.get_future();
+  REQUIRE(f.wait_for(50ms) == std::future_status::ready);
+  REQUIRE(f.get() == 42);
+}
+
+TEST_CASE("the workers running at the same time are bounded",
+          "[worker_pool]") {
+  std::atomic<int> running = 0;
+  std::atomic<int> max_running = 0;
+  {
+    trisycl::detail::worker_pool wp { 2 };
+    for (int i = 0; i < 20; ++i)
+      wp.submit([&] {
+        auto r = ++running;
+        for (auto m = max_running.load(); m < r
+               && !max_running.compare_exchange_weak(m, r);)
+          ;
+        std::this_thread::sleep_for(1ms);
+        --running;
+      });
+  }
+  REQUIRE(max_running <= 2);
+}
+
+TEST_CASE("queue with dedicated worker threads", "[worker_pool]") {
+  trisycl::queue q { trisycl::property::queue::worker_threads { 3 } };
+  REQUIRE(q.has_property<trisycl::property::queue::worker_threads>());
+  REQUIRE(q.get_property<trisycl::property::queue::worker_threads>()
+          .get_thread_number() == 3);
+  REQUIRE(q.implementation->get_worker_pool()->get_capacity() == 3);
+  REQUIRE(q.implementation->get_worker_pool()
+          != trisycl::detail::task_executor::default_pool());
+
+  trisycl::buffer<int> b { 100 };
+  for (int i = 0; i < 100; ++i)
+    q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+      cgh.single_task([=] { a[i] = i; });
+    });
+  q.wait();
+  auto a = b.get_access<trisycl::access::mode::read>();
+  for (int i = 0; i < 100; ++i)
+    REQUIRE(a[i] == i);
+}
+
+TEST_CASE("high-priority work is served first", "[worker_pool]") {
+  std::vector<int> order;
+  {
+    // With a single worker, the work waits while the worker is busy
+    trisycl::detail::worker_pool wp { 1, false };
+    std::promise<void> go;
+    wp.submit([f = go.get_future().share()] { f.wait(); });
+    wp.submit([&] { order.push_back(1); });
+    wp.submit([&] { order.push_back(2); });
+    wp.submit([&] { order.push_back(0); }, true);
+    go.set_value();
+  }
+  REQUIRE(order == std::vector { 0, 1, 2 });
+}
+
+TEST_CASE("a high-priority queue overtakes the work of a busy pool",
+          "[worker_pool]") {
+  // Even elastic, a pool at capacity does not start a worker per work
+  auto wp = std::make_shared<trisycl::detail::task_executor>(1);
+  trisycl::queue normal;
+  trisycl::queue urgent { trisycl::property::queue::priority_high {} };
+  normal.implementation->set_worker_pool(wp);
+  urgent.implementation->set_worker_pool(wp);
+  std::mutex m;
+  std::vector<int> order;
+  auto record = [&] (int i) {
+    std::lock_guard lg { m };
+    order.push_back(i);
+  };
+  std::promise<void> go;
+  normal.submit([&](trisycl::handler &cgh) {
+      cgh.single_task([f = go.get_future().share()] { f.wait(); });
+    });
+  for (int i = 1; i <= 3; ++i)
+    normal.submit([&](trisycl::handler &cgh) {
+        cgh.single_task([&, i] { record(i); });
+      });
+  // Give a chance to a spare worker to run the normal work first
+  std::this_thread::sleep_for(50ms);
+  urgent.submit([&](trisycl::handler &cgh) {
+      cgh.single_task([&] { record(0); });
+    });
+  go.set_value();
+  normal.wait();
+  urgent.wait();
+  REQUIRE(order == std::vector { 0, 1, 2, 3 });
+}
+
+TEST_CASE("higher-ranked work is served first", "[worker_pool]") {
+  std::vector<int> order;
+  {
+    trisycl::detail::worker_pool wp { 1, false };
+    std::promise<void> go;
+    wp.submit([f = go.get_future().share()] { f.wait(); });
+    wp.submit([&] { order.push_back(3); });
+    wp.submit([&] { order.push_back(1); }, false, 10);
+    wp.submit([&] { order.push_back(4); });
+    wp.submit([&] { order.push_back(2); }, false, 5);
+    wp.submit([&] { order.push_back(0); }, true);
+    go.set_value();
+  }
+  // The same ranks are served in submission order
+  REQUIRE(order == std::vector { 0, 1, 2, 3, 4 });
+}
+
+TEST_CASE("the critical path overtakes the leaves on a busy pool",
+          "[worker_pool]") {
+  trisycl::queue q { trisycl::property::queue::worker_threads { 1 } };
+  trisycl::buffer<int> chain { 1 };
+  std::mutex m;
+  std::vector<int> order;
+  auto record = [&] (int i) {
+    std::lock_guard lg { m };
+    order.push_back(i);
+  };
+  std::promise<void> go;
+  // Keep the only worker busy while the task graph is built
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = chain.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.single_task([=, f = go.get_future().share()] {
+          f.wait();
+          a[0] = 0;
+        });
+    });
+  // Some independent leaves, ready first
+  for (int i = 10; i < 13; ++i)
+    q.submit([&](trisycl::handler &cgh) {
+        cgh.single_task([&, i] { record(i); });
+      });
+  // A chain of 3 tasks waiting for the busy one
+  for (int i = 1; i <= 3; ++i)
+    q.submit([&](trisycl::handler &cgh) {
+        auto a = chain.get_access<trisycl::access::mode::read_write>(cgh);
+        cgh.single_task([=, &record] {
+            record(i);
+            a[0] += i;
+          });
+      });
+  // Give a chance to a spare worker to run the leaves first
+  std::this_thread::sleep_for(50ms);
+  go.set_value();
+  q.wait();
+  // The head of the chain is served before the leaves
+  REQUIRE(order.size() == 6);
+  REQUIRE(order[0] == 1);
+  REQUIRE(chain.get_access<trisycl::access::mode::read>()[0] == 6);
+}
+
+TEST_CASE("high-priority queue", "[worker_pool]") {
+  trisycl::queue q { trisycl::property::queue::priority_high {} };
+  REQUIRE(q.has_property<trisycl::property::queue::priority_high>());
+  REQUIRE(q.implementation->is_high_priority());
+  int v = 0;
+  {
+    trisycl::buffer<int> b { &v, 1 };
+    q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::write>(cgh);
+      cgh.single_task([=] { a[0] = 42; });
+    });
+  }
+  REQUIRE(v == 42);
+}
+
+TEST_CASE("a gang runs at the same time even on a bounded pool",
+          "[worker_pool]") {
+  constexpr int gang_size = 4;
+  std::atomic<int> arrived = 0;
+  {
+    /* Each work waits for all the others, which dead-locks if they
+       are not running at the same time */
+    trisycl::detail::worker_pool wp { 1, false };
+    std::vector<std::function<void(void)>> gang;
+    for (int i = 0; i < gang_size; ++i)
+      gang.push_back([&] {
+        ++arrived;
+        while (arrived != gang_size)
+          std::this_thread::yield();
+      });
+    wp.submit_gang(std::move(gang));
+  }
+  REQUIRE(arrived == gang_size);
+}
@@ -0,0 +1,73 @@
+/* RUN: %{execute}%s
+
+   Partition the host device into some sub-devices owning some CPUs
+*/
+#include <algorithm>
+#include <vector>
+
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("partition the host device by counts", "[device]") {
+  device host;
+  auto n = host.get_info<info::device::partition_max_sub_devices>();
+  REQUIRE(n >= 1);
+  auto subs =
+    host.create_sub_devices<info::partition_property::partition_by_counts>(
+      std::vector<size_t> { 1 });
+  REQUIRE(subs.size() == 1);
+  auto &s = subs[0];
+  REQUIRE(s.is_host());
+  REQUIRE(s.get_info<info::device::max_compute_units>() == 1);
+  REQUIRE(s.get_info<info::device::parent_device>() == host);
+  REQUIRE(s.get_info<info::device::partition_type_property>()
+          == info::partition_property::partition_by_counts);
+  // More compute units than the device has
+  REQUIRE_THROWS_AS(
+    host.create_sub_devices<info::partition_property::partition_by_counts>(
+      std::vector<size_t> { n, 1 }),
+    invalid_parameter_error);
+}
+
+TEST_CASE("partition the host device equally", "[device]") {
+  device host;
+  auto n = host.get_info<info::device::partition_max_sub_devices>();
+  auto subs =
+    host.create_sub_devices<info::partition_property::partition_equally>(1);
+  REQUIRE(subs.size() == n);
+  // The sub-devices can be partitioned further
+  auto subsub = subs[0].create_sub_devices<
+    info::partition_property::partition_equally>(1);
+  REQUIRE(subsub.size() == 1);
+  REQUIRE(subsub[0].get_info<info::device::parent_device>() == subs[0]);
+}
+
+TEST_CASE("kernels on a sub-device", "[device]") {
+  auto s = device {}.create_sub_devices<
+    info::partition_property::partition_equally>(1)[0];
+  for (auto props : { property_list {},
+                      property_list { property::queue::in_order {} } }) {
+    queue q { s, props };
+    REQUIRE(q.get_device() == s);
+    std::vector<int> v(1000);
+    {
+      buffer<int> b { v.data(), range<1> { v.size() } };
+      q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<1> { v.size() }, [=] (id<1> i) {
+          a[i] = i[0];
+        });
+      });
+      q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] { a[0] = 42; });
+      });
+    }
+    REQUIRE(v[0] == 42);
+    REQUIRE(std::all_of(v.begin() + 1, v.end(),
+                        [&, i = 1] (int x) mutable { return x == i++; }));
+  }
+}
@@ -0,0 +1,51 @@
+#include <CL/sycl.hpp>
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+/*
+  The aim of this test is to check that a tiled kernel on an nd_range
+  gets its ids from the OpenCL built-ins, shares its tile in the local
+  memory of the device and synchronizes it with nd_item::barrier()
+*/
+using namespace cl::sycl;
+
+constexpr size_t N = 256;
+constexpr size_t tile_size = 16;
+
+TEST_CASE("parallel_for_nd_range_local", "[old device compiler]") {
+  queue my_queue{default_selector{}};
+
+  buffer<unsigned int> a{N};
+  buffer<unsigned int> b{N};
+  {
+    auto acc = a.get_access<access::mode::discard_write>();
+    std::iota(acc.begin(), acc.end(), 0);
+  }
+
+  my_queue.submit([&](handler &cgh) {
+    auto in = a.get_access<access::mode::read>(cgh);
+    auto out = b.get_access<access::mode::discard_write>(cgh);
+    accessor<unsigned int, 1, access::mode::read_write, access::target::local>
+      tile { tile_size, cgh };
+
+    // Reverse each tile of the input through the local memory
+    cgh.parallel_for<class reverse_tiles>(nd_range<1> { N, tile_size },
+        [d_in = drt::accessor<decltype(in)>{in},
+         d_out = drt::accessor<decltype(out)>{out},
+         tile](nd_item<1> i) {
+          auto l = i.get_local_id(0);
+          tile[l] = d_in[i.get_global_id(0)];
+          i.barrier(access::fence_space::local_space);
+          d_out[i.get_global_id(0)] = tile[tile_size - 1 - l]
+            + i.get_group(0)*N;
+        });
+  });
+
+  auto acc_r = b.get_access<access::mode::read>();
+  for (size_t i = 0; i < N; ++i) {
+    auto group = i/tile_size;
+    REQUIRE(acc_r[i] == group*tile_size + tile_size - 1 - i%tile_size
+                        + group*N);
+  }
+}
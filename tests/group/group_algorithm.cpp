@@ -0,0 +1,127 @@
+/* RUN: %{execute}%s
+
+   Test the group collectives and the joint algorithms
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 8;
+constexpr std::size_t group_size = 32;
+constexpr std::size_t n = groups*group_size;
+
+TEST_CASE("collectives in an nd_range kernel", "[group_algorithm]") {
+  queue q;
+  buffer<int> sum { n };
+  buffer<int> max { n };
+  buffer<int> broadcast { n };
+  buffer<int> inclusive { n };
+  buffer<int> exclusive { n };
+  buffer<long> with_init { n };
+  q.submit([&](handler &cgh) {
+      auto s = sum.get_access<access::mode::discard_write>(cgh);
+      auto m = max.get_access<access::mode::discard_write>(cgh);
+      auto b = broadcast.get_access<access::mode::discard_write>(cgh);
+      auto in = inclusive.get_access<access::mode::discard_write>(cgh);
+      auto ex = exclusive.get_access<access::mode::discard_write>(cgh);
+      auto w = with_init.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class collectives>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          int g = i.get_global_id(0);
+          int l = i.get_local_id(0);
+          // Several collectives in a row reuse the scratch memory
+          s[g] = reduce_over_group(i, l, plus<>());
+          m[g] = reduce_over_group(i, g, maximum<>());
+          b[g] = group_broadcast(i, g, group_size - 1);
+          in[g] = inclusive_scan_over_group(i, l, plus<>());
+          ex[g] = exclusive_scan_over_group(i, 2, plus<>());
+          w[g] = reduce_over_group(i, 1, 100L, plus<>())
+            + inclusive_scan_over_group(i, 1, plus<>(), 1000L)
+            + exclusive_scan_over_group(i, 1, 10000L, plus<>());
+        });
+    });
+  auto s = sum.get_access<access::mode::read>();
+  auto m = max.get_access<access::mode::read>();
+  auto b = broadcast.get_access<access::mode::read>();
+  auto in = inclusive.get_access<access::mode::read>();
+  auto ex = exclusive.get_access<access::mode::read>();
+  auto w = with_init.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < n; ++g) {
+    int l = g % group_size;
+    int last = g - l + group_size - 1;
+    REQUIRE(s[g] == int(group_size*(group_size - 1)/2));
+    REQUIRE(m[g] == last);
+    REQUIRE(b[g] == last);
+    REQUIRE(in[g] == l*(l + 1)/2);
+    REQUIRE(ex[g] == 2*l);
+    REQUIRE(w[g] == long(100 + group_size + 1000 + l + 1 + 10000 + l));
+  }
+}
+
+TEST_CASE("collectives in a 2D nd_range kernel", "[group_algorithm]") {
+  queue q;
+  buffer<int> result { 8*12 };
+  q.submit([&](handler &cgh) {
+      auto r = result.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class collectives_2d>(
+        nd_range<2> { { 8, 12 }, { 4, 3 } },
+        [=](nd_item<2> i) {
+          auto first = group_broadcast(i, int(i.get_global_linear_id()),
+                                       id<2> { 1, 2 });
+          r[i.get_global_linear_id()] = first
+            + exclusive_scan_over_group(i, 1, plus<>());
+        });
+    });
+  auto r = result.get_access<access::mode::read>();
+  for (std::size_t x = 0; x < 8; ++x)
+    for (std::size_t y = 0; y < 12; ++y) {
+      // The linear ids have the dimension 0 varying fastest
+      auto broadcaster = x/4*4 + 1 + (y/3*3 + 2)*8;
+      auto local = x%4 + y%3*4;
+      REQUIRE(r[x + y*8] == int(broadcaster + local));
+    }
+}
+
+TEST_CASE("joint algorithms in a hierarchical kernel", "[group_algorithm]") {
+  queue q;
+  buffer<int> data { n };
+  buffer<int> inclusive { n };
+  buffer<int> exclusive { n };
+  buffer<int> sums { groups };
+  q.submit([&](handler &cgh) {
+      auto d = data.get_access<access::mode::discard_read_write>(cgh);
+      auto in = inclusive.get_access<access::mode::discard_write>(cgh);
+      auto ex = exclusive.get_access<access::mode::discard_write>(cgh);
+      auto s = sums.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for_work_group<class joint>(
+        nd_range<1> { n, group_size },
+        [=](group<1> g) {
+          g.parallel_for_work_item([=](h_item<1> i) {
+            d[i.get_global_id()] = i.get_local_id(0);
+          });
+          auto first = &d[g.get_id(0)*group_size];
+          auto last = first + group_size;
+          s[g.get_id(0)] = joint_reduce(g, first, last, plus<>())
+            + joint_reduce(g, first, last, 1, maximum<>());
+          joint_inclusive_scan(g, first, last, &in[g.get_id(0)*group_size],
+                               plus<>());
+          joint_exclusive_scan(g, first, last, &ex[g.get_id(0)*group_size],
+                               plus<>());
+        });
+    });
+  auto s = sums.get_access<access::mode::read>();
+  auto in = inclusive.get_access<access::mode::read>();
+  auto ex = exclusive.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < groups; ++g)
+    REQUIRE(s[g] == int(group_size*(group_size - 1)/2 + group_size - 1));
+  for (std::size_t i = 0; i < n; ++i) {
+    int l = i % group_size;
+    REQUIRE(in[i] == l*(l + 1)/2);
+    REQUIRE(ex[i] == l*(l - 1)/2);
+  }
+}
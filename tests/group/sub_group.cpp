@@ -0,0 +1,76 @@
+/* RUN: %{execute}%s
+
+   Test the sub-groups and their collectives
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 4;
+// Not a multiple of the sub-group size to have a smaller last sub-group
+constexpr std::size_t group_size = 30;
+constexpr std::size_t n = groups*group_size;
+constexpr std::size_t w = sub_group::max_size;
+
+TEST_CASE("sub-group ids", "[sub_group]") {
+  sub_group sg { 2*w + 1, 2*w + 3 };
+  REQUIRE(sg.get_group_linear_id() == 2);
+  REQUIRE(sg.get_local_linear_id() == 1);
+  REQUIRE(sg.get_local_linear_range() == 3);
+  REQUIRE(sg.get_group_linear_range() == 3);
+  REQUIRE(sg.get_max_local_range()[0] == w);
+  REQUIRE(!sg.leader());
+  REQUIRE(sub_group { w, 2*w }.get_local_range()[0] == w);
+}
+
+TEST_CASE("sub-group collectives", "[sub_group]") {
+  queue q;
+  buffer<int> sum { n };
+  buffer<int> scan { n };
+  buffer<int> shuffles { n };
+  buffer<int> votes { n };
+  q.submit([&](handler &cgh) {
+      auto s = sum.get_access<access::mode::discard_write>(cgh);
+      auto sc = scan.get_access<access::mode::discard_write>(cgh);
+      auto sh = shuffles.get_access<access::mode::discard_write>(cgh);
+      auto v = votes.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class sub_group_collectives>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          auto sg = i.get_sub_group();
+          int g = i.get_global_id(0);
+          int lane = sg.get_local_linear_id();
+          s[g] = reduce_over_group(sg, lane, plus<>());
+          sc[g] = exclusive_scan_over_group(sg, 1, plus<>());
+          sh[g] = group_broadcast(sg, g)
+            + 1000*(shift_group_left(sg, lane) - lane)
+            + 100000*permute_group_by_xor(sg, lane, 1)
+            + 10000000*select_from_group(sg, lane, sg.get_local_range()[0]
+                                         - 1);
+          v[g] = any_of_group(sg, lane == 1)
+            + 2*all_of_group(sg, lane < 3)
+            + 4*none_of_group(sg, lane > int(w));
+        });
+    });
+  auto s = sum.get_access<access::mode::read>();
+  auto sc = scan.get_access<access::mode::read>();
+  auto sh = shuffles.get_access<access::mode::read>();
+  auto v = votes.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < n; ++g) {
+    int local = g % group_size;
+    int lane = local % w;
+    int size = std::min(w, group_size - local/w*w);
+    INFO("work-item " << g);
+    REQUIRE(s[g] == size*(size - 1)/2);
+    REQUIRE(sc[g] == lane);
+    int left = lane + 1 < size;
+    int xored = (lane ^ 1) < size ? lane ^ 1 : lane;
+    REQUIRE(sh[g] == int(g - lane) + 1000*left + 100000*xored
+                     + 10000000*(size - 1));
+    REQUIRE(v[g] == (size > 1) + 2*(size <= 3) + 4);
+  }
+}
@@ -0,0 +1,83 @@
+/* RUN: %{execute}%s
+
+   Exercise the images with their tiled storage and the samplers
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+// Not a multiple of the tile size, to have some partial tiles
+constexpr std::size_t width = 37;
+constexpr std::size_t height = 21;
+
+TEST_CASE("3x3 box blur of a 2D image", "[image]") {
+  std::vector<float> input(width*height*4), output(width*height*4);
+  for (std::size_t y = 0; y != height; ++y)
+    for (std::size_t x = 0; x != width; ++x)
+      input[(y*width + x)*4] = x + y*width;
+  {
+    image<2> in { input.data(), image_channel_order::rgba,
+                  image_channel_type::fp32, range<2> { width, height } };
+    image<2> out { output.data(), image_channel_order::rgba,
+                   image_channel_type::fp32, range<2> { width, height } };
+    queue q;
+    q.submit([&] (handler &cgh) {
+        auto a_in = in.get_access<float4, access::mode::read>(cgh);
+        auto a_out = out.get_access<float4, access::mode::discard_write>(cgh);
+        sampler edge { coordinate_normalization_mode::unnormalized,
+                       addressing_mode::clamp_to_edge,
+                       filtering_mode::nearest };
+        cgh.parallel_for<class box_blur>(range<2> { width, height },
+                                         [=] (id<2> i) {
+            float4 sum { 0.f };
+            for (int dy = -1; dy <= 1; ++dy)
+              for (int dx = -1; dx <= 1; ++dx)
+                sum += a_in.read(float2 { float(i[0]) + dx + .5f,
+                                          float(i[1]) + dy + .5f }, edge);
+            a_out.write(int2 { int(i[0]), int(i[1]) }, sum/9.f);
+          });
+      });
+  }
+  for (std::size_t y = 0; y != height; ++y)
+    for (std::size_t x = 0; x != width; ++x) {
+      float expected = 0;
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx) {
+          auto cx = std::clamp<long>(x + dx, 0, width - 1);
+          auto cy = std::clamp<long>(y + dy, 0, height - 1);
+          expected += input[(cy*width + cx)*4];
+        }
+      REQUIRE(std::abs(output[(y*width + x)*4] - expected/9) < 1e-3f);
+    }
+}
+
+
+TEST_CASE("sampled reads of a 1D image", "[image]") {
+  std::vector<unsigned char> texels { 0, 100, 200, 250 };
+  image<1> i { static_cast<const void *>(texels.data()),
+               image_channel_order::r, image_channel_type::unorm_int8,
+               range<1> { texels.size() } };
+  auto a = i.get_access<float4, access::mode::read>();
+  // The missing channels read as 0 except alpha as 1
+  REQUIRE(a.read(1)[0] == 100/255.f);
+  REQUIRE(a.read(1)[1] == 0);
+  REQUIRE(a.read(1)[3] == 1);
+  sampler border { coordinate_normalization_mode::unnormalized,
+                   addressing_mode::clamp, filtering_mode::nearest };
+  // Outside, the border is opaque black since there is no alpha channel
+  REQUIRE(a.read(-1.f, border)[0] == 0);
+  REQUIRE(a.read(-1.f, border)[3] == 1);
+  sampler linear { coordinate_normalization_mode::normalized,
+                   addressing_mode::repeat, filtering_mode::linear };
+  // Between the centers of the texels 1 and 2
+  REQUIRE(std::abs(a.read(.5f, linear)[0] - 150/255.f) < 1e-6f);
+  // Wrapped around between the last and the first texels
+  REQUIRE(std::abs(a.read(1.f, linear)[0] - 125/255.f) < 1e-6f);
+}
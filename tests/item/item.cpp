@@ -16,6 +16,8 @@
    CHECK: 0
    CHECK: 1
    CHECK: 0
+   CHECK: 3
+   CHECK: 341
 */
 #include <CL/sycl.hpp>
 #include <iostream>
@@ -53,5 +55,11 @@ int main() {
 
   item<1, false> ino { 7, 3 };
   item<1, true>(ino).get_offset().display();
+  std::cout << ino.get_linear_id() << std::endl;
+
+  // With the strides computed once for all the items of a range
+  detail::linear_strides<3> strides { range<3> { 10, 11, 12 } };
+  item<3> is { { 10, 11, 12 }, { 2, 3, 6 }, { 1, 2, 3 }, strides };
+  std::cout << is.get_linear_id() << std::endl;
   return 0;
 }
@@ -10,6 +10,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <string>
 
 // SYCL
 #include <CL/sycl.hpp>
@@ -74,6 +75,8 @@ int es = PAPI_NULL; //event set
 #define ERR_MAX 1.0e-06
 
 
+// The name of the variant, from the program name
+std::string VARIANT = "jacobi";
 size_t NB_ITER = CONST_NB_ITER;
 size_t M = WG_MULT0*J_CL_DEVICE_CONST_WORK_GROUP_SIZE0+JACOBI_DELTA;
 size_t N = WG_MULT1*J_CL_DEVICE_CONST_WORK_GROUP_SIZE1+JACOBI_DELTA;
@@ -181,7 +184,17 @@ inline void stop_papi_stencil(struct counters& timer){}
 
 #endif
 
-inline void end_measure(struct counters& timer)
+/* Display the timings and a machine-readable summary line in JSON
+
+   The computation time is the time since the end of the
+   initialization. The GFLOP/s use flops_per_point operations per
+   inner point and iteration, and the effective bandwidth counts each
+   element as read and written once by the stencil and once by the copy
+   at each iteration.
+*/
+inline void end_measure(struct counters& timer,
+                        double flops_per_point = 5,
+                        size_t element_size = sizeof(float))
 {
     timer.end = counters::clock_type::now();
     counters::duration_type tot_time = std::chrono::duration_cast<counters::duration_type>(timer.end - timer.start);
@@ -192,6 +205,20 @@ inline void end_measure(struct counters& timer)
     std::cout << "Copy................time (ms) : " << timer.copy_time.count() << std::endl;
     std::cout << "Subtotal............time (ms) : " << (timer.init_time + timer.load_time + timer.stencil_time + timer.copy_time).count() << std::endl;
     std::cout << "Total (with instr.) time (ms) : " << tot_time.count() << std::endl;
+
+    std::chrono::duration<double> compute_time = timer.end - timer.end_init;
+    double points = double(M - 2)*(N - 2)*NB_ITER;
+    std::cout << "{\"variant\": \"" << VARIANT
+              << "\", \"iterations\": " << NB_ITER
+              << ", \"size\": [" << M << ", " << N
+              << "], \"tile\": [" << J_CL_DEVICE_MAX_WORK_GROUP_SIZE0
+              << ", " << J_CL_DEVICE_MAX_WORK_GROUP_SIZE1
+              << "], \"time_s\": " << compute_time.count()
+              << ", \"gflops\": "
+              << flops_per_point*points/compute_time.count()/1e9
+              << ", \"gbytes_per_s\": "
+              << 4*element_size*points/compute_time.count()/1e9
+              << "}" << std::endl;
 #if USE_PAPI
   if (nb_papi_event > 0) {
     std::cout << "Loading counters" << std::endl;;
@@ -251,6 +278,9 @@ void read_args(int argc, char **argv)
 #endif
 #endif
 
+  VARIANT = argv[0];
+  VARIANT = VARIANT.substr(VARIANT.find_last_of('/') + 1);
+
   if (argc >= 4) {
     using boost::lexical_cast;
     using boost::bad_lexical_cast;
@@ -89,7 +89,8 @@ int main(int argc, char **argv) {
   auto end_op = counters::clock_type::now();
   timer.stencil_time = std::chrono::duration_cast<counters::duration_type>(end_op - begin_op);
   // loading time is not watched
-  end_measure(timer);
+  // A complex stencil point is 5 complex products and 4 complex sums
+  end_measure(timer, 5*6 + 4*2, sizeof(Complex));
 
   return 0;
 }
@@ -0,0 +1,28 @@
+#! /bin/sh
+#
+# Run the Jacobi variants over some tile sizes and collect their JSON
+# summary lines, one per run, to compare them or track regressions.
+#
+# Usage: sweep-tiles.sh BUILD_DIR [ITERATIONS [SIZE0 [SIZE1]]]
+#
+# The problem sizes include the 2 ghost cells, so use a multiple of the
+# tile sizes plus 2.
+
+build_dir=${1:?Usage: $0 BUILD_DIR [ITERATIONS [SIZE0 [SIZE1]]]}
+iterations=${2:-10}
+size0=${3:-1026}
+size1=${4:-$size0}
+
+for variant in jacobi2d jacobi2d-tile jacobi2d-st-fxd jacobi2d-st-var \
+               jacobi2d-st-gen-var jacobi2d-st-cplx-var; do
+  # The executable built by CMake or by the Makefile
+  for exe in "$build_dir/jacobi_$variant" "$build_dir/$variant"; do
+    if [ -x "$exe" ]; then
+      for tile in 4 8 16 32; do
+        "$exe" "$iterations" "$size0" "$size1" "$tile" "$tile" \
+          | grep '^{"variant"'
+      done
+      break
+    fi
+  done
+done
@@ -0,0 +1,136 @@
+/* RUN: %{execute}%s
+
+   Check the statistics accumulated for each kernel
+*/
+#include <CL/sycl.hpp>
+
+#include <sstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using statistics = vendor::trisycl::kernel_statistics;
+
+/* Declare the kernel names at namespace scope, since a class declared
+   in the kernel lambda would be another type than the one named in
+   the test body */
+class fill;
+class sum;
+class ignored;
+class counted;
+class triad;
+
+TEST_CASE("statistics of named kernels", "[kernel_statistics]") {
+  auto &s = statistics::instance();
+  s.set_enabled(true);
+  s.reset();
+  queue q;
+  buffer<int> b { 1000 };
+  for (int i = 0; i != 3; ++i)
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class fill>(range<1> { 1000 },
+                                     [=] (id<1> i) { a[i] = i[0]; });
+      });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.single_task<class sum>([=] {
+          for (int i = 1; i != 1000; ++i)
+            a[0] += a[i];
+        });
+    });
+  q.wait();
+  s.set_enabled(false);
+
+  auto fill = s.get_statistics<class fill>();
+  REQUIRE(fill.launches == 3);
+  REQUIRE(fill.work_items == 3000);
+  REQUIRE(fill.min <= fill.mean());
+  REQUIRE(fill.mean() <= fill.max);
+  REQUIRE(fill.total.count() > 0);
+  REQUIRE(fill.work_items_per_second() > 0);
+  auto sum = s.get_statistics<class sum>();
+  REQUIRE(sum.launches == 1);
+  REQUIRE(sum.work_items == 1);
+  REQUIRE(s.get_statistics().size() == 2);
+
+  std::ostringstream json;
+  s.write_json(json);
+  REQUIRE(json.str().find("\"launches\":3,") != std::string::npos);
+  std::ostringstream table;
+  s.write_table(table);
+  REQUIRE(table.str().find(fill.name) != std::string::npos);
+}
+
+TEST_CASE("no statistics when disabled", "[kernel_statistics]") {
+  auto &s = statistics::instance();
+  s.reset();
+  queue q;
+  q.submit([&](handler &cgh) { cgh.single_task<class ignored>([] {}); });
+  q.wait();
+  REQUIRE(s.get_statistics<class ignored>().launches == 0);
+}
+
+TEST_CASE("hardware counters of kernels", "[kernel_statistics]") {
+  auto &s = statistics::instance();
+  s.set_enabled(true);
+  // The counters may not be allowed by the system configuration
+  auto available = s.set_counting(true);
+  s.reset();
+  queue q;
+  buffer<double> b { 100000 };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class counted>(range<1> { 100000 },
+                                      [=] (id<1> i) { a[i] = i[0]*0.5; });
+    });
+  q.wait();
+  s.set_counting(false);
+  s.set_enabled(false);
+
+  auto counted = s.get_statistics<class counted>();
+  REQUIRE(counted.launches == 1);
+  if (available) {
+    REQUIRE(counted.counters.cycles > 0);
+    REQUIRE(counted.counters.instructions > 0);
+    REQUIRE(counted.instructions_per_cycle() > 0);
+  }
+  else
+    REQUIRE(counted.counters.cycles == 0);
+  std::ostringstream json;
+  s.write_json(json);
+  REQUIRE(json.str().find("\"cycles\":") != std::string::npos);
+}
+
+TEST_CASE("roofline of kernels", "[kernel_statistics]") {
+  auto &s = statistics::instance();
+  s.set_enabled(true);
+  s.reset();
+  s.set_flops_per_work_item<triad>(2);
+  constexpr std::size_t n = 1000;
+  queue q;
+  buffer<float> a { n }, b { n }, c { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      auto kb = b.get_access<access::mode::read>(cgh);
+      auto kc = c.get_access<access::mode::read>(cgh);
+      cgh.parallel_for<triad>(range<1> { n }, [=] (id<1> i) {
+          ka[i] = kb[i] + 3*kc[i];
+        });
+    });
+  q.wait();
+  s.set_enabled(false);
+
+  auto t = s.get_statistics<triad>();
+  // The 3 arrays are accessed once each
+  REQUIRE(t.bytes == 3*n*sizeof(float));
+  REQUIRE(t.flops_per_work_item == 2);
+  REQUIRE(t.arithmetic_intensity() == 2.0*n/(3*n*sizeof(float)));
+  REQUIRE(t.flops_per_second() > 0);
+  std::ostringstream roofline;
+  // Some peaks with a high floating-point rate, to be memory bound
+  s.write_roofline(roofline, { 1e10, 1e13 });
+  REQUIRE(roofline.str().find("memory") != std::string::npos);
+}
@@ -0,0 +1,47 @@
+/* RUN: %{execute}%s
+
+   Launch an OpenCL kernel with an explicit work-group size and offset
+*/
+#include <boost/compute.hpp>
+
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr size_t N = 64;
+constexpr size_t L = 16;
+
+TEST_CASE("kernel with an nd_range", "[OpenCL interoperability]") {
+  // Construct the queue from the default OpenCL one
+  queue q { boost::compute::system::default_queue() };
+
+  buffer<int> ids { N };
+  buffer<int> local_sizes { N };
+
+  // Record the global ids and the work-group sizes of the work-items
+  auto program = boost::compute::program::create_with_source(R"(
+    __kernel void describe(__global int *ids, __global int *local_sizes) {
+      ids[get_global_id(0) - get_global_offset(0)] = get_global_id(0);
+      local_sizes[get_global_id(0) - get_global_offset(0)] =
+        get_local_size(0);
+    }
+    )", boost::compute::system::default_context());
+  program.build();
+  kernel k { boost::compute::kernel { program, "describe" } };
+
+  q.submit([&](handler &cgh) {
+      cgh.set_args(ids.get_access<access::mode::discard_write>(cgh),
+                   local_sizes.get_access<access::mode::discard_write>(cgh));
+      cgh.parallel_for(nd_range<1> { range<1> { N }, range<1> { L },
+                                     id<1> { 100 } }, k);
+    });
+
+  auto i = ids.get_access<access::mode::read>();
+  auto l = local_sizes.get_access<access::mode::read>();
+  for (size_t e = 0; e != N; ++e) {
+    REQUIRE(i[e] == static_cast<int>(e + 100));
+    REQUIRE(l[e] == static_cast<int>(L));
+  }
+}
@@ -0,0 +1,99 @@
+/* RUN: %{execute}%s
+
+   Test the choice of the partitioning of the host kernels by the
+   autotuning
+*/
+#include <CL/sycl.hpp>
+#include "triSYCL/kernel/detail/partitioning_tuner.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+using ::trisycl::detail::partitioning;
+using ::trisycl::detail::partitioning_tuner;
+
+/// The database of this test, created before the tuner is used
+static const std::string database = [] {
+  auto f = std::filesystem::temp_directory_path()
+    / "trisycl_partitioning_tuner_test.txt";
+  std::filesystem::remove(f);
+  setenv("TRISYCL_AUTOTUNE", "1", 1);
+  setenv("TRISYCL_AUTOTUNE_FILE", f.c_str(), 1);
+  return f.string();
+}();
+
+TEST_CASE("candidate partitionings", "[partitioning_tuner]") {
+  partitioning base;
+  auto c1 = partitioning_tuner::candidates(base, range<1> { 1 << 20 });
+  // The partitioning of the queue comes first
+  REQUIRE(c1.size() > 1);
+  CHECK(c1[0].scheduling == base.scheduling);
+  CHECK(c1[0].grain_size == base.grain_size);
+  // The 2D kernels try also another iteration order
+  auto c2 = partitioning_tuner::candidates(base, range<2> { 512, 512 });
+  REQUIRE(c2.size() == c1.size() + 1);
+  CHECK(c2.back().iteration == partitioning::order::tiled);
+}
+
+
+TEST_CASE("tuning of a kernel", "[partitioning_tuner]") {
+  REQUIRE(partitioning_tuner::is_exploring());
+  auto &t = partitioning_tuner::instance();
+  range<1> r { 1000 };
+  auto key = partitioning_tuner::key("kernel\ttuned", r);
+  CHECK(key.find('\t') == std::string::npos);
+  auto candidates = [&] { return partitioning_tuner::candidates({}, r); };
+  auto n = candidates().size();
+  // Each candidate is tried twice, the last one being the fastest
+  for (std::size_t i = 0; i != n*partitioning_tuner::trials; ++i) {
+    CHECK(!t.get_winner(key));
+    auto c = t.choose(key, candidates);
+    REQUIRE(c);
+    REQUIRE(c->trial == static_cast<int>(i%n));
+    t.record(key, *c, c->trial == int(n - 1) ? 1.0 : 2.0 + i);
+  }
+  auto winner = t.get_winner(key);
+  REQUIRE(winner);
+  CHECK(winner->scheduling == candidates().back().scheduling);
+  CHECK(winner->grain_size == candidates().back().grain_size);
+  auto c = t.choose(key, candidates);
+  REQUIRE(c);
+  CHECK(c->trial == -1);
+  // The winner is kept in the database for the next runs
+  std::ifstream in { database };
+  std::string line;
+  bool found = false;
+  while (std::getline(in, line))
+    found |= line.starts_with(key + "\tpartitioning ");
+  CHECK(found);
+}
+
+
+TEST_CASE("tuning of a parallel_for", "[partitioning_tuner]") {
+  constexpr std::size_t n = 64;
+  queue q;
+  buffer<int, 2> a { { n, n } };
+  auto key = partitioning_tuner::key(
+    ::trisycl::vendor::trisycl::kernel_statistics::name<class tuned>(),
+    range<2> { n, n });
+  // Enough launches to try all the candidates with correct results
+  for (int launch = 0; launch != 20; ++launch) {
+    q.submit([&](handler &cgh) {
+        auto ka = a.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for<class tuned>(range<2> { n, n }, [=](item<2> i) {
+            ka[i] = launch + i[0]*n + i[1];
+          });
+      });
+    auto ha = a.get_access<access::mode::read>();
+    for (std::size_t i = 0; i != n; ++i)
+      for (std::size_t j = 0; j != n; ++j)
+        REQUIRE(ha[i][j] == int(launch + i*n + j));
+  }
+  CHECK(partitioning_tuner::instance().get_winner(key));
+}
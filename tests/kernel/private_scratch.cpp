@@ -0,0 +1,57 @@
+/* RUN: %{execute}%s
+
+   Use some temporary arrays in the work-items
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/private_scratch.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+
+TEST_CASE("median of a neighborhood of varying size", "[kernel]") {
+  buffer<int> median { n };
+  queue {}.submit([&](handler &cgh) {
+      auto m = median.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          vendor::trisycl::private_scratch<int> a { 2*i[0] + 1 };
+          // Some nested scratch is released before the outer one
+          {
+            vendor::trisycl::private_scratch<double> b { 1 << 14 };
+            b[0] = 1;
+          }
+          for (std::size_t j = 0; j != a.size(); ++j)
+            a[j] = a.size() - j;
+          std::sort(a.begin(), a.end());
+          m[i] = a[a.size()/2];
+        });
+    });
+  auto m = median.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(m[i] == int(i + 1));
+}
+
+TEST_CASE("inline scratch", "[kernel]") {
+  vendor::trisycl::private_scratch<int, 8> a { 5 };
+  std::fill(a.begin(), a.end(), 3);
+  REQUIRE(a.size() == 5);
+  REQUIRE(a[4] == 3);
+}
+
+TEST_CASE("the arena memory is reused", "[kernel]") {
+  int *first;
+  {
+    vendor::trisycl::private_scratch<int> a { 10 };
+    first = a.data();
+  }
+  vendor::trisycl::private_scratch<int> b { 10 };
+  REQUIRE(b.data() == first);
+  // A big scratch does not fit in the first chunk
+  vendor::trisycl::private_scratch<char> c { 1 << 20 };
+  REQUIRE(c.size() == 1 << 20);
+}
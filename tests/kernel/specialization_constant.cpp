@@ -0,0 +1,60 @@
+/* RUN: %{execute}%s
+
+   Check the specialization constants and their selection of some
+   code compiled for their value
+*/
+#include <CL/sycl.hpp>
+
+#include <type_traits>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "triSYCL/vendor/triSYCL/specialize.hpp"
+
+using namespace cl::sycl;
+
+constexpr specialization_id<int> width { 3 };
+constexpr specialization_id<float> scale { 2.f };
+
+TEST_CASE("default and set values", "[specialization constant]") {
+  queue q;
+  buffer<float> b { 4 };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      REQUIRE(cgh.get_specialization_constant<width>() == 3);
+      cgh.set_specialization_constant<width>(5);
+      REQUIRE(cgh.get_specialization_constant<width>() == 5);
+      cgh.single_task([=] (kernel_handler h) {
+          a[0] = h.get_specialization_constant<width>();
+          a[1] = h.get_specialization_constant<scale>();
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.set_specialization_constant<scale>(0.5f);
+      cgh.parallel_for(range<1> { 2 }, [=] (item<1> i, kernel_handler h) {
+          a[i[0] + 2] = h.get_specialization_constant<scale>()*(i[0] + 1);
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  REQUIRE(a[0] == 5);
+  REQUIRE(a[1] == 2);
+  REQUIRE(a[2] == 0.5f);
+  REQUIRE(a[3] == 1);
+}
+
+
+TEST_CASE("code compiled for the value", "[specialization constant]") {
+  kernel_handler h;
+  auto is_constant = [] (auto w) {
+    return std::is_same_v<decltype(w), std::integral_constant<int, 3>>;
+  };
+  REQUIRE(vendor::trisycl::specialize<width, 1, 3>(h, is_constant));
+  REQUIRE(!vendor::trisycl::specialize<width, 1, 2>(h, is_constant));
+  REQUIRE(vendor::trisycl::specialize<width, 1, 3>(h, [] (auto w) {
+        return w*w;
+      }) == 9);
+  REQUIRE(vendor::trisycl::specialize<width>(h, [] (int w) {
+        return w + 1;
+      }) == 4);
+}
@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   Test the choice of the local work sizes by the autotuning
+*/
+#include "triSYCL/kernel/detail/work_group_tuner.hpp"
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using trisycl::detail::work_group_tuner;
+
+TEST_CASE("candidate local sizes", "[work_group_tuner]") {
+  std::size_t global[] = { 96, 64 };
+  auto c = work_group_tuner::candidates(2, global, 32, 256);
+  // The driver choice, then 32, 64, 128 and 256 work-items
+  REQUIRE(c.size() == 5);
+  CHECK(c[0] == work_group_tuner::sizes { 0, 0, 0 });
+  CHECK(c[1] == work_group_tuner::sizes { 32, 1, 1 });
+  CHECK(c[2] == work_group_tuner::sizes { 32, 2, 1 });
+  CHECK(c[4] == work_group_tuner::sizes { 32, 8, 1 });
+  for (auto &l : c)
+    if (l[0])
+      CHECK(global[0] % l[0] == 0);
+  // A prime global size can only be split by the driver
+  std::size_t prime[] = { 97 };
+  CHECK(work_group_tuner::candidates(1, prime, 32, 256).size() == 1);
+}
+
+
+TEST_CASE("tuning of a kernel", "[work_group_tuner]") {
+  auto &t = work_group_tuner::instance();
+  std::size_t global[] = { 1024 };
+  auto key = work_group_tuner::key("kernel\ttuned", "a device", 1, global);
+  CHECK(key.find('\t') == std::string::npos);
+  auto candidates = [&] {
+    return work_group_tuner::candidates(1, global, 64, 128);
+  };
+  // Each of the 3 candidates is tried twice, the 64 one being faster
+  for (std::size_t i = 0; i != 3*work_group_tuner::trials; ++i) {
+    CHECK(!t.get_winner(key));
+    auto c = t.choose(key, candidates);
+    REQUIRE(c.trial == static_cast<int>(i%3));
+    t.record(key, c, c.local[0] == 64 ? 1.0 : 2.0 + i);
+  }
+  auto winner = t.get_winner(key);
+  REQUIRE(winner);
+  CHECK(*winner == work_group_tuner::sizes { 64, 1, 1 });
+  auto c = t.choose(key, candidates);
+  CHECK(c.trial == -1);
+  CHECK(c.local == *winner);
+}
@@ -0,0 +1,57 @@
+/* RUN: %{execute}%s
+
+   Exercise the triSYCL sycl::vendor::trisycl::batch extension
+*/
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/batch_math.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace batch = ::trisycl::vendor::trisycl::batch;
+
+// Enough elements to have several blocks and a tail in the last one
+constexpr std::size_t n = 100003;
+
+/// Test whether a is close to b within a few float ulp
+bool close(float a, float b) {
+  return std::abs(a - b) <= 8*std::numeric_limits<float>::epsilon()
+    *std::max(std::abs(b), std::numeric_limits<float>::min());
+}
+
+TEST_CASE("fused affine and exp", "[math]") {
+  std::vector<float> v(n);
+  for (std::size_t i = 0; i != n; ++i)
+    v[i] = float(i)/n*20 - 10;
+  queue q;
+  buffer<float> in { v.begin(), v.end() };
+  buffer<float> out { n };
+  batch::transform(q, in, out, batch::affine(0.5f, -1.0f), batch::exp);
+  auto a = out.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(close(a[i], std::exp(v[i]*0.5f - 1)));
+}
+
+TEST_CASE("in place", "[math]") {
+  std::vector<double> v(n);
+  for (std::size_t i = 0; i != n; ++i)
+    v[i] = i + 1;
+  queue q;
+  buffer<double> b { v.begin(), v.end() };
+  batch::transform(q, b, b, batch::log2, batch::sqrt);
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(a[i] == std::sqrt(std::log2(v[i])));
+}
+
+TEST_CASE("on pointers", "[math]") {
+  std::vector<float> v(37, 0.25f), r(37);
+  batch::transform(v.data(), r.data(), v.size(), batch::sin);
+  for (auto e : r)
+    REQUIRE(close(e, std::sin(0.25f)));
+}
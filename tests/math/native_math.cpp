@@ -0,0 +1,51 @@
+/* RUN: %{execute}%s
+
+  Test the fast native:: and half_precision:: math functions
+
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <sycl/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+/// Check a result within a relative error
+inline bool close(double result, double reference, double error) {
+  return std::abs(result - reference) <= error*std::abs(reference);
+}
+
+TEST_CASE("native scalar functions", "[math]") {
+  REQUIRE(close(sycl::native::exp(1.0f), std::exp(1.0), 1e-6));
+  REQUIRE(close(sycl::native::exp10(2.0f), 100, 1e-5));
+  REQUIRE(close(sycl::native::powr(2.0f, 10.0f), 1024, 1e-5));
+  REQUIRE(close(sycl::native::rsqrt(4.0f), 0.5, 1e-6));
+  REQUIRE(sycl::native::recip(4.0) == 0.25);
+  REQUIRE(sycl::native::divide(1.0f, 4.0f) == 0.25f);
+  REQUIRE(close(sycl::half_precision::log(2.0f), std::log(2.0), 1e-3));
+}
+
+TEST_CASE("native vector functions", "[math]") {
+  sycl::float4 x { 0.25f, 1.0f, 4.0f, 1e-40f };
+  auto r = sycl::native::rsqrt(x);
+  for (int i = 0; i < 4; ++i)
+    REQUIRE(close(r[i], 1/std::sqrt(double(x[i])), 1e-5));
+  sycl::float4 special { 0.0f, -1.0f, std::numeric_limits<float>::infinity(),
+                         std::numeric_limits<float>::quiet_NaN() };
+  auto s = sycl::native::rsqrt(special);
+  REQUIRE(s[0] == std::numeric_limits<float>::infinity());
+  REQUIRE(std::isnan(s[1]));
+  REQUIRE(s[2] == 0);
+  REQUIRE(std::isnan(s[3]));
+
+  auto p = sycl::half_precision::powr(sycl::float3 { 2.0f, 9.0f, 1.0f },
+                                      sycl::float3 { 10.0f, 0.5f, 3.0f });
+  REQUIRE(close(p[0], 1024, 1e-3));
+  REQUIRE(close(p[1], 3, 1e-3));
+  REQUIRE(close(p[2], 1, 1e-3));
+  auto e = sycl::native::exp10(sycl::double2 { 1.0, 2.0 });
+  REQUIRE(close(e[1], 100, 1e-12));
+  auto q = sycl::half_precision::recip(sycl::float2 { 2.0f, 4.0f });
+  REQUIRE(q[1] == 0.25f);
+}
@@ -0,0 +1,47 @@
+/* RUN: %{execute}%s
+
+  Test the element-wise select of vectors, which uses the native vector
+  types when available
+
+*/
+
+#include <sycl/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE("select on the most significant bit", "[math]") {
+  sycl::vec<float, 4> a { 1, 2, 3, 4 };
+  sycl::vec<float, 4> b { 5, 6, 7, 8 };
+  auto r = sycl::select(a, b, sycl::vec<int, 4> { -1, 0, -1, 0 });
+  REQUIRE(r[0] == 5);
+  REQUIRE(r[1] == 2);
+  REQUIRE(r[2] == 7);
+  REQUIRE(r[3] == 4);
+
+  // Unsigned masks and a vec of 3 with its padding element
+  sycl::vec<int, 3> x { 1, 2, 3 };
+  sycl::vec<int, 3> y { 4, 5, 6 };
+  auto s = sycl::select(x, y,
+                        sycl::vec<unsigned int, 3> { 0x80000000u, 1u,
+                                                     0xffffffffu });
+  REQUIRE(s[0] == 4);
+  REQUIRE(s[1] == 2);
+  REQUIRE(s[2] == 6);
+
+  REQUIRE(sycl::select(1, 2, true) == 2);
+  REQUIRE(sycl::select(1, 2, 0) == 1);
+}
+
+TEST_CASE("comparisons give 0 or 1", "[math]") {
+  sycl::vec<float, 4> a { 1, 2, 3, 4 };
+  auto c = a < sycl::vec<float, 4> { 4, 3, 2, 1 };
+  REQUIRE(c[0] == 1);
+  REQUIRE(c[1] == 1);
+  REQUIRE(c[2] == 0);
+  REQUIRE(c[3] == 0);
+  sycl::vec<int, 3> i { 7, 8, 9 };
+  auto d = i / sycl::vec<int, 3> { 2, 3, 4 };
+  REQUIRE(d[0] == 3);
+  REQUIRE(d[1] == 2);
+  REQUIRE(d[2] == 2);
+}
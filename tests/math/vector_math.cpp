@@ -133,3 +133,54 @@ TEST_CASE("vector operations", "[math]") {
 
   do_check_sign();
 }
+
+/// Get the error in ulp of a float result compared to a double reference
+inline double ulp_error(float result, double reference) {
+  auto r = static_cast<float>(reference);
+  if (std::isinf(r))
+    return result == r ? 0 : std::numeric_limits<double>::infinity();
+  return std::abs(result - reference)
+    / std::ldexp(1.0, std::max(std::ilogb(r), -126) - 23);
+}
+
+TEST_CASE("vectorized transcendental functions", "[math]") {
+  double exp_error = 0, log_error = 0, sin_error = 0, cos_error = 0;
+  for (int i = 0; i < 100000; ++i) {
+    // Sweep some arguments in [-100, 100] with all the fractional bits
+    sycl::float8 x;
+    for (int e = 0; e < 8; ++e)
+      x[e] = (i*8 + e - 400000)/4000.0f + e/7.0f;
+    auto exp = sycl::exp(x);
+    auto log = sycl::log(sycl::fabs(x));
+    auto sin = sycl::sin(x*80);
+    auto cos = sycl::cos(x*80);
+    for (int e = 0; e < 8; ++e) {
+      double d = x[e];
+      double d80 = x[e]*80;
+      exp_error = std::max(exp_error, ulp_error(exp[e], std::exp(d)));
+      if (d != 0)
+        log_error = std::max(log_error,
+                             ulp_error(log[e], std::log(std::abs(d))));
+      sin_error = std::max(sin_error, ulp_error(sin[e], std::sin(d80)));
+      cos_error = std::max(cos_error, ulp_error(cos[e], std::cos(d80)));
+    }
+  }
+  // The SYCL bounds for float
+  REQUIRE(exp_error <= 3);
+  REQUIRE(log_error <= 3);
+  REQUIRE(sin_error <= 4);
+  REQUIRE(cos_error <= 4);
+
+  sycl::float4 special { 0.0f, -1.0f, std::numeric_limits<float>::infinity(),
+                         std::numeric_limits<float>::quiet_NaN() };
+  auto log = sycl::log(special);
+  REQUIRE(log[0] == -std::numeric_limits<float>::infinity());
+  REQUIRE(std::isnan(log[1]));
+  REQUIRE(log[2] == std::numeric_limits<float>::infinity());
+  REQUIRE(std::isnan(log[3]));
+  auto exp = sycl::exp(special);
+  REQUIRE(exp[0] == 1);
+  REQUIRE(exp[2] == std::numeric_limits<float>::infinity());
+  REQUIRE(std::isnan(exp[3]));
+  REQUIRE(std::signbit(sycl::sin(sycl::float2 { -0.0f })[0]));
+}
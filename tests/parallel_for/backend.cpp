@@ -0,0 +1,85 @@
+/* RUN: %{execute}%s
+
+   Test the choice of the parallelism back-end of each kernel
+*/
+
+#include <type_traits>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace vt = trisycl::vendor::trisycl;
+
+/// Run some kernels on all the kinds of ranges with the back-end \p Backend
+template <typename Backend>
+void run_kernels() {
+  constexpr std::size_t n = 8;
+  trisycl::queue q;
+  trisycl::buffer<int, 2> b { { n, n } };
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<2> { n, n },
+                       vt::use_backend<Backend>([=] (trisycl::item<2> i) {
+                         a[i] = i[0]*n + i[1];
+                       }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+      cgh.parallel_for(trisycl::range<2> { n/2, n }, trisycl::id<2> { n/2, 0 },
+                       vt::use_backend<Backend>([=] (trisycl::item<2> i) {
+                         a[i] += 1000;
+                       }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+      cgh.parallel_for(trisycl::nd_range<2> { { n, n }, { 2, 4 } },
+                       vt::use_backend<Backend>([=] (trisycl::nd_item<2> i) {
+                         a[i.get_global_id()] *= 2;
+                       }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::read_write>(cgh);
+      cgh.parallel_for_work_group(trisycl::nd_range<2> { { n, n }, { 4, 2 } },
+                                  vt::use_backend<Backend>(
+                                    [=] (trisycl::group<2> g) {
+                                      g.parallel_for_work_item(
+                                        [&] (trisycl::h_item<2> i) {
+                                          a[i.get_global_id()] += 1;
+                                        });
+                                    }));
+    });
+  auto a = b.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    for (std::size_t j = 0; j != n; ++j)
+      REQUIRE(a[i][j] == int(2*(i*n + j + (i >= n/2 ? 1000 : 0)) + 1));
+}
+
+TEST_CASE("tag the kernels with a back-end", "[backend]") {
+  auto k = [] (trisycl::id<1>) {};
+  using tagged =
+    decltype(vt::use_backend<vt::backend::build_default>(k));
+  REQUIRE(vt::is_backend_kernel_v<tagged>);
+  REQUIRE(!vt::is_backend_kernel_v<decltype(k)>);
+  REQUIRE(std::is_same_v<vt::kernel_backend_t<decltype(k)>,
+                         vt::backend::build_default>);
+  REQUIRE(std::is_same_v<vt::kernel_backend_t<tagged>,
+                         vt::backend::build_default>);
+}
+
+TEST_CASE("kernels on the default back-end", "[backend]") {
+  run_kernels<vt::backend::build_default>();
+}
+
+#if !defined(TRISYCL_WORK_STEALING)
+TEST_CASE("kernels on the OpenMP back-end", "[backend]") {
+  run_kernels<vt::backend::openmp>();
+}
+#endif
+
+#if defined(TRISYCL_TBB)
+TEST_CASE("kernels on the TBB back-end", "[backend]") {
+  run_kernels<vt::backend::tbb>();
+}
+#endif
@@ -0,0 +1,98 @@
+/* RUN: %{execute}%s
+
+   Test the serial execution of the small kernels and the cost hint
+*/
+
+#include <mutex>
+#include <set>
+#include <thread>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using trisycl::detail::concurrency_governor;
+
+TEST_CASE("the threshold takes the cost into account", "[cost_hint]") {
+  auto t = concurrency_governor::serial_threshold();
+  if (t > 1) {
+    REQUIRE(!concurrency_governor::is_worth_parallelizing(t - 1));
+    REQUIRE(concurrency_governor::is_worth_parallelizing(t/2, 2));
+    REQUIRE(!concurrency_governor::is_worth_parallelizing(t/2 - 1, 2));
+  }
+  REQUIRE(concurrency_governor::is_worth_parallelizing(t));
+  REQUIRE(concurrency_governor::is_worth_parallelizing(1, t));
+  // Free work-items are never worth a parallel team
+  REQUIRE(!concurrency_governor::is_worth_parallelizing(t, 0));
+  auto k = trisycl::vendor::trisycl::cost_hint(42, [](trisycl::id<1>) {});
+  REQUIRE(trisycl::vendor::trisycl::kernel_cost(k) == 42);
+  REQUIRE(trisycl::vendor::trisycl::kernel_cost([](trisycl::id<1>) {}) == 1);
+}
+
+TEST_CASE("a small kernel is executed by a single thread", "[cost_hint]") {
+  auto t = concurrency_governor::serial_threshold();
+  if (t < 2)
+    return;
+  const std::size_t n = t - 1;
+  trisycl::queue q;
+  trisycl::buffer<int> b { n };
+  std::mutex m;
+  std::set<std::thread::id> threads;
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<1> { n }, [=, &m, &threads]
+                       (trisycl::id<1> i) {
+          a[i] = i[0];
+          std::lock_guard lock { m };
+          threads.insert(std::this_thread::get_id());
+        });
+    });
+  auto a = b.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == int(i));
+  REQUIRE(threads.size() == 1);
+}
+
+TEST_CASE("kernels with a cost hint", "[cost_hint]") {
+  constexpr std::size_t n = 64;
+  trisycl::queue q;
+  trisycl::buffer<int> b1 { n };
+  trisycl::buffer<int> b2 { n*n };
+  trisycl::buffer<int> b3 { 2*n };
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b1.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<1> { n },
+                       trisycl::vendor::trisycl::cost_hint(
+                         1000,
+                         [=](trisycl::id<1> i) { a[i] = 3*i[0]; }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b2.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<2> { n, n },
+                       trisycl::vendor::trisycl::cost_hint(
+                         1000,
+                         [=](trisycl::item<2> i) {
+                           a[i[0]*n + i[1]] = 1000*i[0] + i[1];
+                         }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b3.get_access<trisycl::access::mode::write>(cgh);
+      cgh.parallel_for(trisycl::range<1> { n }, trisycl::id<1> { n },
+                       trisycl::vendor::trisycl::cost_hint(
+                         1000,
+                         [=](trisycl::item<1> i) {
+                           a[i.get_id()] = i.get_id(0);
+                         }));
+    });
+  auto a1 = b1.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a1[i] == int(3*i));
+  auto a2 = b2.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < n; ++j)
+      REQUIRE(a2[i*n + j] == int(1000*i + j));
+  auto a3 = b3.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = n; i < 2*n; ++i)
+    REQUIRE(a3[i] == int(i));
+}
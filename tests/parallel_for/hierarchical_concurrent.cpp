@@ -0,0 +1,59 @@
+/* RUN: %{execute}%s
+
+   Test the execution of many work-groups, which may run concurrently,
+   with and without some local memory
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 64;
+constexpr std::size_t group_size = 32;
+
+TEST_CASE("independent work-groups", "[hierarchical]") {
+  queue q;
+  buffer<int> b { groups*group_size };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for_work_group<class independent>(
+        nd_range<1> { groups*group_size, group_size },
+        [=](group<1> g) {
+          // Some private memory of the work-group
+          int base = 1000*g.get_id(0);
+          g.parallel_for_work_item([&](h_item<1> i) {
+              a[i.get_global_id()] = base + i.get_local_id(0);
+            });
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < groups*group_size; ++i)
+    REQUIRE(a[i] == int(1000*(i/group_size) + i%group_size));
+}
+
+TEST_CASE("work-groups sharing some local memory", "[hierarchical]") {
+  queue q;
+  buffer<int> b { groups*group_size };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      accessor<int, 1, access::mode::read_write, access::target::local>
+        cache { group_size, cgh };
+      cgh.parallel_for_work_group<class local_memory>(
+        nd_range<1> { groups*group_size, group_size },
+        [=](group<1> g) {
+          g.parallel_for_work_item([&](h_item<1> i) {
+              cache[i.get_local_id()] = g.get_id(0);
+            });
+          // Reverse the cache content to use the data of other work-items
+          g.parallel_for_work_item([&](h_item<1> i) {
+              a[i.get_global_id()] =
+                cache[group_size - 1 - i.get_local_id(0)]
+                + i.get_local_id(0);
+            });
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < groups*group_size; ++i)
+    REQUIRE(a[i] == int(i/group_size + i%group_size));
+}
@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Hierarchical kernels with a flexible range of logical work-items in
+   each work-group, such as a ragged workload
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 8;
+constexpr std::size_t local_size = 4;
+constexpr std::size_t width = 3*groups;
+
+TEST_CASE("ragged work-groups with a flexible range", "[parallel_for]") {
+  queue q;
+  buffer<int, 2> physical { range<2> { groups, width } };
+  buffer<int, 2> visits { range<2> { groups, width } };
+  q.submit([&](handler &cgh) {
+      auto p = physical.get_access<access::mode::discard_write>(cgh);
+      auto v = visits.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for_work_group(nd_range<1> { range<1> { groups*local_size },
+                                                range<1> { local_size } },
+                                  [=] (group<1> g) {
+        auto row = g.get_id(0);
+        for (std::size_t i = 0; i != width; ++i)
+          v[row][i] = 0;
+        // Each work-group has its own amount of work
+        g.parallel_for_work_item(range<1> { 3*row + 1 }, [=] (h_item<1> i) {
+            auto l = i.get_logical_local_id(0);
+            ++v[row][l];
+            p[row][l] = i.get_physical_local_id(0);
+            REQUIRE(i.get_logical_local_range() == range<1> { 3*row + 1 });
+            REQUIRE(i.get_physical_local_range() == range<1> { local_size });
+            REQUIRE(i.get_global_id(0) == row*local_size + l%local_size);
+          });
+      });
+    });
+  auto p = physical.get_access<access::mode::read>();
+  auto v = visits.get_access<access::mode::read>();
+  for (std::size_t g = 0; g != groups; ++g)
+    for (std::size_t i = 0; i != width; ++i) {
+      REQUIRE(v[g][i] == (i < 3*g + 1));
+      if (i < 3*g + 1)
+        REQUIRE(p[g][i] == static_cast<int>(i%local_size));
+    }
+}
+
+TEST_CASE("2D flexible range", "[parallel_for]") {
+  queue q;
+  buffer<int, 2> visits { range<2> { 5, 7 } };
+  q.submit([&](handler &cgh) {
+      auto v = visits.get_access<access::mode::discard_write>(cgh);
+      // A single work-group
+      cgh.parallel_for_work_group(nd_range<2> { range<2> { 2, 3 },
+                                                range<2> { 2, 3 } },
+                                  [=] (group<2> g) {
+        g.parallel_for_work_item([=] (h_item<2> i) {
+            // Without a flexible range, logical and physical are the same
+            REQUIRE(i.get_logical_local_id() == i.get_physical_local_id());
+          });
+        g.parallel_for_work_item(range<2> { 5, 7 }, [=] (h_item<2> i) {
+            auto l = i.get_logical_local_id();
+            v[l] = 10*l[0] + l[1];
+            REQUIRE(i.get_physical_local_id()
+                    == id<2> { l[0]%2, l[1]%3 });
+          });
+      });
+    });
+  auto v = visits.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != 5; ++i)
+    for (std::size_t j = 0; j != 7; ++j)
+      REQUIRE(v[i][j] == static_cast<int>(10*i + j));
+}
@@ -0,0 +1,98 @@
+/* RUN: %{execute}%s
+
+   Test the kernels with independent work-items, executed as SIMD
+   loops, and the linear ids of the items advanced by the loops
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace vt = ::trisycl::vendor::trisycl;
+
+TEST_CASE("1D kernel with independent work-items", "[independent]") {
+  constexpr std::size_t n = 1003;
+  std::vector<float> va(n), vb(n), vc(n);
+  for (std::size_t i = 0; i != n; ++i) {
+    va[i] = i;
+    vb[i] = 2*i;
+  }
+  {
+    buffer<float> a { va.data(), n }, b { vb.data(), n }, c { vc.data(), n };
+    queue {}.submit([&] (handler &cgh) {
+        auto ka = a.get_access<access::mode::read>(cgh);
+        auto kb = b.get_access<access::mode::read>(cgh);
+        auto kc = c.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<1> { n }, vt::independent([=] (id<1> i) {
+              kc[i] = ka[i] + kb[i];
+            }));
+      });
+  }
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(vc[i] == 3*i);
+}
+
+
+TEST_CASE("dependent work-items are not vectorized", "[independent]") {
+  constexpr std::size_t n = 1000;
+  std::atomic<std::size_t> sum = 0;
+  queue q;
+  q.submit([&] (handler &cgh) {
+      cgh.parallel_for(range<2> { 10, n/10 }, [&] (id<2> i) {
+          sum += i[1];
+        });
+    });
+  q.wait();
+  REQUIRE(sum == 10*(n/10)*(n/10 - 1)/2);
+}
+
+
+TEST_CASE("linear ids of the items", "[independent]") {
+  constexpr std::size_t x = 3, y = 4, z = 5;
+  const range<3> r { x, y, z };
+  buffer<int, 3> ok { r };
+  buffer<int, 3> ok_with_offset { r };
+  queue q;
+  q.submit([&] (handler &cgh) {
+      auto a = ok.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(r, vt::independent([=] (item<3> i) {
+            a[i] = i.get_linear_id()
+              == ::trisycl::detail::linear_id(r, i.get_id());
+          }));
+    });
+  q.submit([&] (handler &cgh) {
+      auto a = ok_with_offset.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(r, id<3> { 1, 2, 3 }, [=] (item<3> i) {
+          a[i.get_id() - i.get_offset()] =
+            i.get_linear_id()
+            == ::trisycl::detail::linear_id(r, i.get_id(), i.get_offset());
+        });
+    });
+  auto a = ok.get_access<access::mode::read>();
+  auto b = ok_with_offset.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != x; ++i)
+    for (std::size_t j = 0; j != y; ++j)
+      for (std::size_t k = 0; k != z; ++k) {
+        REQUIRE(a[i][j][k]);
+        REQUIRE(b[i][j][k]);
+      }
+}
+
+
+TEST_CASE("independent kernel traits", "[independent]") {
+  auto k = [] (id<1>) {};
+  using independent = decltype(vt::independent(k));
+  STATIC_REQUIRE(vt::is_independent_kernel_v<independent>);
+  STATIC_REQUIRE(!vt::is_independent_kernel_v<decltype(k)>);
+  STATIC_REQUIRE(vt::is_independent_kernel_v<
+                   decltype(vt::cost_hint(10, vt::independent(k)))>);
+  STATIC_REQUIRE(vt::is_independent_kernel_v<
+                   decltype(vt::index32(vt::independent(k)))>);
+  STATIC_REQUIRE(vt::is_index32_kernel_v<
+                   decltype(vt::independent(vt::index32(k)))>);
+  REQUIRE(vt::kernel_cost(vt::independent(vt::cost_hint(10, k))) == 10);
+}
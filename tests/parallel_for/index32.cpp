@@ -0,0 +1,78 @@
+/* RUN: %{execute}%s
+
+   Test the kernels whose work-items are counted with 32 bits
+*/
+
+#include <cstdint>
+#include <type_traits>
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace vt = trisycl::vendor::trisycl;
+
+TEST_CASE("mark the kernels as index32", "[index32]") {
+  auto k = [] (trisycl::id<2>) {};
+  auto k32 = vt::index32(k);
+  REQUIRE(vt::is_index32_kernel_v<decltype(k32)>);
+  REQUIRE(!vt::is_index32_kernel_v<decltype(k)>);
+  REQUIRE(std::is_same_v<vt::work_item_index_t<decltype(k32)>,
+                         std::uint32_t>);
+  REQUIRE(std::is_same_v<vt::work_item_index_t<decltype(k)>, std::size_t>);
+  // The marker is seen through the other kernel wrappers
+  auto costed = vt::cost_hint(10, k32);
+  REQUIRE(vt::is_index32_kernel_v<decltype(costed)>);
+  REQUIRE(vt::is_index32_kernel_v<
+            decltype(vt::use_backend<vt::backend::build_default>(k32))>);
+  REQUIRE(vt::kernel_cost(vt::index32(costed)) == 10);
+}
+
+TEST_CASE("index32 kernels on some ranges", "[index32]") {
+  constexpr std::size_t n = 7, m = 9, p = 5;
+  trisycl::queue q;
+  trisycl::buffer<int> b1 { n*m*p };
+  trisycl::buffer<int, 2> b2 { { n, m } };
+  trisycl::buffer<int, 3> b3 { { n, m, p } };
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b1.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<1> { n*m*p },
+                       vt::index32([=] (trisycl::id<1> i) { a[i] = i[0]; }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b2.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<2> { n, m },
+                       vt::index32([=] (trisycl::item<2> i) {
+                         a[i] = i[0]*m + i[1];
+                       }));
+    });
+  q.submit([&](trisycl::handler &cgh) {
+      auto a = b3.get_access<trisycl::access::mode::discard_write>(cgh);
+      cgh.parallel_for(trisycl::range<3> { n, m, p },
+                       vt::use_backend<vt::backend::build_default>(
+                         vt::cost_hint(2, vt::index32(
+                           [=] (trisycl::id<3> i) {
+                             a[i] = (i[0]*m + i[1])*p + i[2];
+                           }))));
+    });
+  auto a1 = b1.get_access<trisycl::access::mode::read>();
+  auto a2 = b2.get_access<trisycl::access::mode::read>();
+  auto a3 = b3.get_access<trisycl::access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t j = 0; j < m; ++j) {
+      REQUIRE(a2[i][j] == int(i*m + j));
+      for (std::size_t k = 0; k < p; ++k) {
+        REQUIRE(a1[(i*m + j)*p + k] == int((i*m + j)*p + k));
+        REQUIRE(a3[i][j][k] == int((i*m + j)*p + k));
+      }
+    }
+}
+
+TEST_CASE("an index32 kernel on a too large range", "[index32]") {
+  trisycl::queue q;
+  REQUIRE_THROWS_AS(q.submit([&](trisycl::handler &cgh) {
+      cgh.parallel_for(trisycl::range<2> { 1 << 17, 1 << 17 },
+                       vt::index32([=] (trisycl::id<2>) {}));
+    }), trisycl::invalid_parameter_error);
+}
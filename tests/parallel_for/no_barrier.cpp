@@ -0,0 +1,51 @@
+/* RUN: %{execute}%s
+
+   Test the nd_range kernels marked as not using any barrier, mixed
+   with a kernel using barriers in the same translation unit
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1024;
+constexpr std::size_t group_size = 16;
+
+TEST_CASE("barrier-free and barrier kernels", "[no_barrier]") {
+  auto k = vendor::trisycl::no_barrier([] (nd_item<1>) {});
+  STATIC_REQUIRE(vendor::trisycl::is_no_barrier_kernel_v<decltype(k)>);
+  STATIC_REQUIRE(!vendor::trisycl::is_no_barrier_kernel_v<int>);
+
+  queue q;
+  buffer<int> a { n };
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class flat>(
+        nd_range<1> { n, group_size },
+        vendor::trisycl::no_barrier([=](nd_item<1> i) {
+            ka[i.get_global_id()] = i.get_global_id(0) + i.get_local_id(0);
+          }));
+    });
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::read_write>(cgh);
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class with_barrier>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          auto g = i.get_global_id(0);
+          auto mirror = g - 2*i.get_local_id(0) + group_size - 1;
+          auto v = ka[mirror];
+          i.barrier();
+          // Everybody has read before any write
+          ka[g] = 0;
+          kb[g] = v;
+        });
+    });
+  auto kb = b.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < n; ++g) {
+    auto mirror = g - 2*(g%group_size) + group_size - 1;
+    REQUIRE(kb[g] == int(mirror + mirror%group_size));
+  }
+}
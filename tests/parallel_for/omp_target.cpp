@@ -0,0 +1,49 @@
+/* RUN: %{execute}%s
+
+   Test the parallel_for offloaded to an OpenMP device with
+   TRISYCL_OMP_TARGET
+*/
+#include <CL/sycl.hpp>
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1 << 12;
+
+TEST_CASE("saxpy and a 3D kernel on the device", "[omp_target]") {
+  queue q;
+  buffer<float> x { n }, y { n };
+  buffer<int, 3> c { range<3> { 8, 16, 32 } };
+  {
+    auto a_x = x.get_access<access::mode::discard_write>();
+    auto a_y = y.get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i != n; ++i) {
+      a_x[i] = i;
+      a_y[i] = 1;
+    }
+  }
+  q.submit([&](handler &cgh) {
+      auto a_x = x.get_access<access::mode::read>(cgh);
+      auto a_y = y.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for<class saxpy>(range<1> { n }, [=](id<1> i) {
+          a_y[i] += 2*a_x[i];
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto a_c = c.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class linear_ids>(a_c.get_range(), [=](id<3> i) {
+          a_c[i] = (i[0]*16 + i[1])*32 + i[2];
+        });
+    });
+  auto a_y = y.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(a_y[i] == 1 + 2*float(i));
+  auto a_c = c.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != 8; ++i)
+    for (std::size_t j = 0; j != 16; ++j)
+      for (std::size_t k = 0; k != 32; ++k)
+        REQUIRE(a_c[i][j][k] == int((i*16 + j)*32 + k));
+}
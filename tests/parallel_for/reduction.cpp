@@ -0,0 +1,202 @@
+/* RUN: %{execute}%s
+
+   Test the reductions of the parallel_for kernels
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 100000;
+
+TEST_CASE("known identities", "[reduction]") {
+  STATIC_REQUIRE(known_identity_v<plus<>, int> == 0);
+  STATIC_REQUIRE(known_identity_v<multiplies<int>, int> == 1);
+  STATIC_REQUIRE(known_identity_v<bit_and<>, std::uint8_t> == 0xff);
+  STATIC_REQUIRE(known_identity_v<maximum<>, int>
+                 == std::numeric_limits<int>::lowest());
+  STATIC_REQUIRE(known_identity_v<minimum<float>, float>
+                 == std::numeric_limits<float>::infinity());
+  STATIC_REQUIRE(known_identity_v<logical_or<>, bool> == false);
+  STATIC_REQUIRE(has_known_identity_v<bit_or<>, int>);
+  STATIC_REQUIRE(!has_known_identity_v<bit_or<>, float>);
+  STATIC_REQUIRE(!has_known_identity_v<std::minus<>, int>);
+}
+
+TEST_CASE("a 1D reduction is spread over the threads", "[reduction]") {
+  // The threads which executed some work-items, as a bit mask
+  std::atomic<std::uint64_t> threads = 0;
+  // The size of the team executing the kernel
+  std::atomic<int> team = 1;
+  buffer<long> sum { 1 };
+  queue q;
+  // Give to the kernels of the queue a team even on a single core
+  auto pool = std::make_shared<::trisycl::detail::task_executor>(1);
+  pool->set_governor(
+    std::make_shared<::trisycl::detail::concurrency_governor>(4));
+  q.implementation->set_worker_pool(pool);
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(range<1> { n },
+                       reduction(sum, cgh, plus<>(),
+                                 property::reduction::initialize_to_identity {}),
+                       [&](id<1> i, auto &s) {
+#ifdef _OPENMP
+                         threads |= std::uint64_t { 1 }
+                           << omp_get_thread_num() % 64;
+                         team = omp_get_num_threads();
+#else
+                         threads |= 1;
+#endif
+                         s += i[0];
+                       });
+    });
+  REQUIRE(sum.get_access<access::mode::read>()[0] == long(n)*(n - 1)/2);
+  // Each thread of the team executed some work-items into its own slot
+  REQUIRE(std::popcount(threads.load()) == std::min(team.load(), 64));
+#if defined(_OPENMP) && !defined(TRISYCL_FIBER_TASKS)
+  REQUIRE(team == 4);
+#endif
+}
+
+TEST_CASE("several reductions on a range", "[reduction]") {
+  std::vector<int> v(n);
+  std::iota(v.begin(), v.end(), -17);
+  queue q;
+  buffer<int> input { v.data(), n };
+  buffer<long> sum { 1 };
+  buffer<int> max { 1 };
+  buffer<int> min { 1 };
+  buffer<int> bits { 1 };
+  sum.get_access<access::mode::write>()[0] = 42;
+  min.get_access<access::mode::write>()[0] = 0;
+  q.submit([&](handler &cgh) {
+      auto a = input.get_access<access::mode::read>(cgh);
+      cgh.parallel_for(range<1> { n },
+                       reduction(sum, cgh, plus<>()),
+                       reduction(max, cgh, maximum<>(),
+                                 property::reduction::initialize_to_identity {}),
+                       reduction(min, cgh, 1000, minimum<>()),
+                       reduction(bits, cgh, bit_or<>(),
+                                 property::reduction::initialize_to_identity {}),
+                       [=](id<1> i, auto &s, auto &mx, auto &mn, auto &b) {
+                         s += a[i];
+                         mx.combine(a[i]);
+                         mn.combine(a[i]);
+                         b |= 1 << (i[0] % 20);
+                       });
+    });
+  long expected = 42;
+  for (auto e : v)
+    expected += e;
+  REQUIRE(sum.get_access<access::mode::read>()[0] == expected);
+  REQUIRE(max.get_access<access::mode::read>()[0] == v.back());
+  // Combined with the initial value
+  REQUIRE(min.get_access<access::mode::read>()[0] == -17);
+  REQUIRE(bits.get_access<access::mode::read>()[0] == (1 << 20) - 1);
+}
+
+TEST_CASE("reductions on 2D ranges and into host variables",
+          "[reduction]") {
+  queue q;
+  int count = 0;
+  double product = 1;
+  std::uint64_t parity = 0;
+  constexpr std::size_t rows = 37;
+  constexpr std::size_t cols = 1001;
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(range<2> { rows, cols },
+                       reduction(&count, plus<>()),
+                       reduction(&parity, bit_xor<>()),
+                       [=](item<2> i, auto &c, auto &p) {
+                         ++c;
+                         p ^= i.get_id(0)*cols + i.get_id(1);
+                       });
+    });
+  // A tiny kernel executed by the task thread
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(10, reduction(&product, 1.0, multiplies<>()),
+                       [=](id<1> i, auto &p) { p *= i[0] + 1.0; });
+    });
+  q.wait();
+  REQUIRE(count == int(rows*cols));
+  std::uint64_t expected = 0;
+  for (std::size_t i = 0; i < rows*cols; ++i)
+    expected ^= i;
+  REQUIRE(parity == expected);
+  REQUIRE(product == 3628800);
+}
+
+TEST_CASE("reductions with a custom operation and an empty range",
+          "[reduction]") {
+  queue q;
+  struct extent {
+    int low, high;
+  };
+  extent e { 5, 5 };
+  int untouched = 7;
+  auto hull = [](extent x, extent y) {
+    return extent { std::min(x.low, y.low), std::max(x.high, y.high) };
+  };
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(range<1> { n },
+                       reduction(&e, extent { 1 << 30, -(1 << 30) }, hull),
+                       [=](id<1> i, auto &h) {
+                         int x = int(i[0]) - 1000;
+                         h.combine(extent { x, x });
+                       });
+    });
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(range<1> { 0 }, reduction(&untouched, plus<>()),
+                       [=](id<1>, auto &u) { u += 1; });
+    });
+  q.wait();
+  REQUIRE(e.low == -1000);
+  REQUIRE(e.high == int(n) - 1000 - 1);
+  REQUIRE(untouched == 7);
+}
+
+TEST_CASE("reductions on nd_ranges", "[reduction]") {
+  constexpr std::size_t group_size = 16;
+  constexpr std::size_t m = 1024;
+  queue q;
+  buffer<std::size_t> sum { 1 };
+  std::size_t flat = 0;
+  int max = 0;
+  q.submit([&](handler &cgh) {
+      auto t = vendor::trisycl::no_barrier(
+        [=](nd_item<1> i, auto &s, auto &mx) {
+          s += i.get_global_id(0);
+          mx.combine(int(i.get_local_id(0)));
+        });
+      cgh.parallel_for(nd_range<1> { m, group_size },
+                       reduction(&flat, plus<>()),
+                       reduction(&max, maximum<>()), t);
+    });
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(nd_range<1> { m, group_size },
+                       reduction(sum, cgh, plus<>(),
+                                 property::reduction::initialize_to_identity {}),
+                       [=](nd_item<1> i, auto &s) {
+                         s += i.get_global_id(0);
+                         i.barrier();
+                         s += 1;
+                       });
+    });
+  REQUIRE(sum.get_access<access::mode::read>()[0] == m*(m - 1)/2 + m);
+  q.wait();
+  REQUIRE(flat == m*(m - 1)/2);
+  REQUIRE(max == int(group_size - 1));
+}
@@ -0,0 +1,81 @@
+/* RUN: %{execute}%s
+
+   Test the OpenMP schedule and team size asked for a kernel
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+
+/// The ragged rows of a sparse matrix, longer at the end
+int row_sum(std::size_t i) {
+  int sum = 0;
+  for (std::size_t j = 0; j <= i; ++j)
+    sum += j % 5;
+  return sum;
+}
+
+
+TEST_CASE("ragged rows with a dynamic schedule", "[schedule]") {
+  queue q;
+  for (auto s : { handler::schedule::static_schedule,
+                  handler::schedule::dynamic_schedule,
+                  handler::schedule::guided_schedule }) {
+    buffer<int> a { n };
+    buffer<int, 2> b { range<2> { n/10, 10 } };
+    q.submit([&](handler &cgh) {
+        auto ka = a.get_access<access::mode::discard_write>(cgh);
+        cgh.set_schedule(s, 7);
+        cgh.parallel_for<class ragged_1d>(range<1> { n }, [=](id<1> i) {
+            ka[i] = row_sum(i[0]);
+          });
+      });
+    q.submit([&](handler &cgh) {
+        auto kb = b.get_access<access::mode::discard_write>(cgh);
+        cgh.set_schedule(s);
+        cgh.parallel_for<class ragged_2d>(kb.get_range(), [=](item<2> i) {
+            kb[i] = row_sum(i[0]*10 + i[1]);
+          });
+      });
+    auto ka = a.get_access<access::mode::read>();
+    auto kb = b.get_access<access::mode::read>();
+    for (std::size_t i = 0; i != n; ++i) {
+      REQUIRE(ka[i] == row_sum(i));
+      REQUIRE(kb[i/10][i%10] == row_sum(i));
+    }
+  }
+}
+
+
+TEST_CASE("team size of a kernel", "[schedule]") {
+  queue q;
+  buffer<int> threads { 1 };
+  q.submit([&](handler &cgh) {
+      auto kt = threads.get_access<access::mode::discard_write>(cgh);
+      cgh.set_team_size(2);
+      cgh.parallel_for<class team>(range<1> { n },
+                                   vendor::trisycl::cost_hint(
+                                     1000,
+                                     [=](id<1> i) {
+                                       if (i[0] == 0)
+#ifdef _OPENMP
+                                         kt[0] = omp_get_num_threads();
+#else
+                                         kt[0] = 1;
+#endif
+                                     }));
+    });
+  auto kt = threads.get_access<access::mode::read>();
+  REQUIRE(kt[0] >= 1);
+  REQUIRE(kt[0] <= 2);
+}
@@ -0,0 +1,91 @@
+/* RUN: %{execute}%s
+
+   Exercise the kernels on some vec of consecutive work-items
+*/
+#include <vector>
+
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/simd.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace vt = ::trisycl::vendor::trisycl;
+
+// Not a multiple of the SIMD width, to have some inactive lanes
+constexpr std::size_t n = 1003;
+
+TEST_CASE("1D kernel on some vec", "[simd]") {
+  std::vector<float> va(n), vb(n), vc(n, -1);
+  for (std::size_t i = 0; i != n; ++i) {
+    va[i] = i;
+    vb[i] = 2*i;
+  }
+  {
+    buffer<float> a { va.data(), n }, b { vb.data(), n }, c { vc.data(), n };
+    queue q;
+    q.submit([&] (handler &cgh) {
+        auto ka = a.get_access<access::mode::read>(cgh);
+        auto kb = b.get_access<access::mode::read>(cgh);
+        auto kc = c.get_access<access::mode::write>(cgh);
+        vt::parallel_for_simd<8>(cgh, range<1> { n }, [=] (auto s) {
+            auto x = s.load(ka);
+            s.store(kc, x*x + s.load(kb));
+          });
+      });
+  }
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(vc[i] == float(i)*i + 2*i);
+}
+
+TEST_CASE("2D kernel with masks", "[simd]") {
+  constexpr std::size_t rows = 5, cols = 10;
+  buffer<int, 2> b { range<2> { rows, cols } };
+  queue q;
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      vt::parallel_for_simd<4>(cgh, range<2> { rows, cols }, [=] (auto s) {
+          s.store(a, s.get_ids() + int(s.get_id()[0]*cols));
+        });
+    });
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      vt::parallel_for_simd<4>(cgh, range<2> { rows, cols }, [=] (auto s) {
+          // Negate only the odd columns
+          auto odd = s.get_ids() & 1;
+          s.store(a, -s.load(a, odd), odd);
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != rows; ++i)
+    for (std::size_t j = 0; j != cols; ++j)
+      REQUIRE(a[i][j] == int(j % 2 ? -(i*cols + j) : i*cols + j));
+}
+
+TEST_CASE("simd_item lanes", "[simd]") {
+  vt::simd_item<1, 8> s { range<1> { 13 }, id<1> { 8 } };
+  REQUIRE(s.get_active_lanes() == 5);
+  REQUIRE(!s.is_full());
+  REQUIRE(s.get_id(3) == id<1> { 11 });
+  auto m = s.get_mask();
+  for (int l = 0; l != 8; ++l)
+    REQUIRE(m[l] == (l < 5 ? -1 : 0));
+  auto ids = s.get_ids<long>();
+  REQUIRE(ids[7] == 15);
+}
+
+TEST_CASE("kernel on a chosen back-end", "[simd]") {
+  buffer<int> b { n };
+  queue q;
+  q.submit([&] (handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      vt::parallel_for_simd<16>(cgh, range<1> { n },
+                                vt::use_backend<vt::backend::build_default>(
+                                  [=] (auto s) {
+                                    s.store(a, s.get_ids()*3);
+                                  }));
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(a[i] == int(3*i));
+}
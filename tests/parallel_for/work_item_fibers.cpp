@@ -0,0 +1,97 @@
+/* RUN: %{execute}%s
+
+   Test the barriers with the work-items executed as fibers
+*/
+#define TRISYCL_WORK_ITEM_FIBERS
+
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t groups = 16;
+constexpr std::size_t group_size = 256;
+constexpr std::size_t n = groups*group_size;
+
+TEST_CASE("exchange through global memory", "[work_item_fibers]") {
+  queue q;
+  buffer<int> a { n };
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_read_write>(cgh);
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class global_exchange>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          auto g = i.get_global_id(0);
+          ka[g] = g;
+          i.barrier();
+          // Read what the mirror work-item of the work-group has written
+          auto l = i.get_local_id(0);
+          kb[g] = ka[g - l + group_size - 1 - l];
+        });
+    });
+  auto kb = b.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < n; ++g)
+    REQUIRE(kb[g] == int(g/group_size*group_size
+                         + group_size - 1 - g%group_size));
+}
+
+TEST_CASE("reduction in local memory", "[work_item_fibers]") {
+  queue q;
+  buffer<int> sums { groups };
+  q.submit([&](handler &cgh) {
+      auto s = sums.get_access<access::mode::discard_write>(cgh);
+      accessor<int, 1, access::mode::read_write, access::target::local>
+        scratch { group_size, cgh };
+      cgh.parallel_for<class local_reduction>(
+        nd_range<1> { n, group_size },
+        [=](nd_item<1> i) {
+          auto l = i.get_local_id(0);
+          scratch[l] = i.get_global_id(0);
+          // A tree reduction with a barrier at each level
+          for (auto stride = group_size/2; stride > 0; stride /= 2) {
+            i.barrier(access::fence_space::local_space);
+            if (l < stride)
+              scratch[l] += scratch[l + stride];
+          }
+          if (l == 0)
+            s[i.get_group(0)] = scratch[0];
+        });
+    });
+  auto s = sums.get_access<access::mode::read>();
+  for (std::size_t g = 0; g < groups; ++g) {
+    // The sum of g*group_size ... (g + 1)*group_size - 1
+    auto first = g*group_size;
+    REQUIRE(s[g] == int(group_size*first + group_size*(group_size - 1)/2));
+  }
+}
+
+TEST_CASE("2D work-groups", "[work_item_fibers]") {
+  queue q;
+  buffer<int> a { n };
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_read_write>(cgh);
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class exchange_2d>(
+        nd_range<2> { { 64, 64 }, { 16, 16 } },
+        [=](nd_item<2> i) {
+          auto linear = i.get_global_id(0)*64 + i.get_global_id(1);
+          ka[linear] = linear;
+          i.barrier();
+          // Read the transposed element inside the work-group
+          auto x = i.get_global_id(0) - i.get_local_id(0) + i.get_local_id(1);
+          auto y = i.get_global_id(1) - i.get_local_id(1) + i.get_local_id(0);
+          kb[linear] = ka[x*64 + y];
+        });
+    });
+  auto kb = b.get_access<access::mode::read>();
+  for (std::size_t x = 0; x < 64; ++x)
+    for (std::size_t y = 0; y < 64; ++y) {
+      auto tx = x - x%16 + y%16;
+      auto ty = y - y%16 + x%16;
+      REQUIRE(kb[x*64 + y] == int(tx*64 + ty));
+    }
+}
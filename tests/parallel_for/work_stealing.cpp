@@ -0,0 +1,93 @@
+/* RUN: %{execute}%s
+
+   Test the parallel_for executed with work stealing on the task fibers
+*/
+
+/// Run each task on a fiber and steal the chunks of the kernels
+#define TRISYCL_FIBER_TASKS
+#define TRISYCL_WORK_STEALING
+
+/// Test explicitly a feature of triSYCL, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+constexpr std::size_t n = 300;
+
+/// An irregular kernel, whose work-items do more work at the end
+int triangle(std::size_t i) {
+  int sum = 0;
+  for (std::size_t j = 0; j <= i; ++j)
+    sum += j % 7;
+  return sum;
+}
+
+
+template <typename Queue>
+void check_triangles(Queue &q) {
+  buffer<int> a { n };
+  buffer<int, 2> b { range<2> { n/10, 10 } };
+  buffer<int, 3> c { range<3> { n/20, 4, 5 } };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class triangle_1d>(range<1> { n }, [=](id<1> i) {
+          ka[i] = triangle(i[0]);
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class triangle_2d>(kb.get_range(), [=](item<2> i) {
+          kb[i] = triangle(i[0]*10 + i[1]);
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto kc = c.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for<class triangle_3d>(kc.get_range(), [=](item<3> i) {
+          kc[i] = triangle(i[0]*20 + i[1]*5 + i[2]);
+        });
+    });
+  auto ka = a.get_access<access::mode::read>();
+  auto kb = b.get_access<access::mode::read>();
+  auto kc = c.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i) {
+    REQUIRE(ka[i] == triangle(i));
+    REQUIRE(kb[i/10][i%10] == triangle(i));
+    REQUIRE(kc[i/20][i/5%4][i%5] == triangle(i));
+  }
+}
+
+
+TEST_CASE("irregular kernels from the task fibers", "[work_stealing]") {
+  queue q;
+  check_triangles(q);
+}
+
+
+TEST_CASE("irregular kernels from the submitting thread", "[work_stealing]") {
+  // The kernels are executed outside of the pool of the fibers
+  queue q { property::queue::inline_execution {} };
+  check_triangles(q);
+}
+
+
+TEST_CASE("work-groups stolen with their work-items", "[work_stealing]") {
+  queue q;
+  buffer<int> a { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for_work_group<class groups>(
+        range<1> { n/30 }, range<1> { 30 },
+        [=](group<1> g) {
+          g.parallel_for_work_item([&](h_item<1> i) {
+              ka[i.get_global_id()] = triangle(i.get_global_id(0));
+            });
+        });
+    });
+  auto ka = a.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(ka[i] == triangle(i));
+}
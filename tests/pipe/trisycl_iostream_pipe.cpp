@@ -2,6 +2,7 @@
    CHECK: salut !
    CHECK-NEXT: hello 42
    CHECK-NEXT: from inside the kernel... it works too!
+   CHECK-NEXT: [3,5] tagged with the work-item id
 
    Test the triSYCL iostream pipe extension
 */
@@ -26,6 +27,8 @@ int main() {
     cgh.single_task<cout_test>([=] {
       ts::pipe::cout::write("from inside the kernel...");
       ts::pipe::cout::stream() << " it works too!" << std::endl;
+      ts::pipe::cout::stream(sycl::id<2> { 3, 5 })
+        << "tagged with the work-item id" << std::endl;
     });
   });
   q.wait();
@@ -0,0 +1,40 @@
+/* RUN: %{execute}%s
+
+   Report the exceptions thrown by the kernels to the async_handler
+*/
+#include <CL/sycl.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("kernel exceptions go to the async_handler", "[queue]") {
+  std::vector<std::string> errors;
+  queue q { [&](exception_list l) {
+      for (auto &e : l)
+        try {
+          std::rethrow_exception(e);
+        } catch (std::exception &error) {
+          errors.push_back(error.what());
+        }
+    } };
+  buffer<int> b { range<1> { 1 } };
+  q.submit([&](handler &cgh) {
+      cgh.single_task([] { throw std::runtime_error { "kernel failure" }; });
+    });
+  // The tasks depending on the failed one still run
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 42; });
+    });
+  q.wait_and_throw();
+  REQUIRE(errors == std::vector<std::string> { "kernel failure" });
+  REQUIRE(b.get_access<access::mode::read>()[0] == 42);
+  // The errors are reported only once
+  q.wait_and_throw();
+  REQUIRE(errors.size() == 1);
+}
@@ -0,0 +1,58 @@
+/* RUN: %{execute}%s
+
+   Test the coalescing of tiny single_task kernels
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+TEST_CASE("ready single_task kernels run back-to-back", "[queue]") {
+  constexpr int n = 10;
+  queue q { property_list { property::queue::coalesce_tasks { 4 },
+                           property::queue::worker_threads { 1 } } };
+  REQUIRE(q.implementation->coalesces_tasks() == 4);
+  // Hold the only worker so the next kernels are submitted before they run
+  std::atomic<bool> go = false;
+  q.submit([&](handler &cgh) {
+      cgh.parallel_for(range<1> { 1 }, [&](id<1>) {
+          while (!go) {
+            // Do not starve the pool when the tasks are fibers
+            detail::yield_task();
+            std::this_thread::yield();
+          }
+        });
+    });
+  std::vector<int> order;
+  std::vector<event> events;
+  for (int i = 0; i != n; ++i)
+    events.push_back(q.submit([&, i](handler &cgh) {
+        cgh.single_task([&, i] { order.push_back(i); });
+      }));
+  buffer<int> b { 1 };
+  q.submit([&](handler &cgh) {
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { kb[0] = 42; });
+    });
+  // Depending on the previous kernel, it cannot join its batch
+  q.submit([&](handler &cgh) {
+      auto kb = b.get_access<access::mode::read_write>(cgh);
+      cgh.single_task([=] { ++kb[0]; });
+    });
+  go = true;
+  // Each command group completes on its own
+  for (auto &e : events)
+    e.wait();
+  q.wait();
+  REQUIRE(order.size() == n);
+  for (int i = 0; i != n; ++i)
+    REQUIRE(order[i] == i);
+  REQUIRE(b.get_access<access::mode::read>()[0] == 43);
+}
@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   Check that the consumers of a task are submitted at its completion
+   instead of waiting for it on some threads
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int consumers = 200;
+
+TEST_CASE("many consumers of a blocked producer", "[queue]") {
+  queue q;
+  buffer<int> in { 1 };
+  std::vector<buffer<int>> out;
+  for (int i = 0; i != consumers; ++i)
+    out.push_back(buffer<int> { 1 });
+  std::atomic<bool> go = false;
+  q.submit([&](handler &cgh) {
+      auto a = in.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=, &go] {
+          while (!go)
+            std::this_thread::yield();
+          a[0] = 42;
+        });
+    });
+  for (int i = 0; i != consumers; ++i)
+    q.submit([&](handler &cgh) {
+        auto a_in = in.get_access<access::mode::read>(cgh);
+        auto a_out = out[i].get_access<access::mode::discard_write>(cgh);
+        cgh.single_task([=] { a_out[0] = a_in[0] + i; });
+      });
+#ifdef __linux__
+  // The consumers waiting for the producer do not hold a thread each
+  auto threads = std::distance(std::filesystem::directory_iterator
+                               { "/proc/self/task" },
+                               std::filesystem::directory_iterator {});
+  REQUIRE(threads < consumers);
+#endif
+  go = true;
+  q.wait();
+  for (int i = 0; i != consumers; ++i)
+    REQUIRE(out[i].get_access<access::mode::read>()[0] == 42 + i);
+}
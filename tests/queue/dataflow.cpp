@@ -0,0 +1,82 @@
+/* RUN: %{execute}%s
+
+   Test the scheduling together of the kernels connected by pipes
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <atomic>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+// Number of values sent through the pipeline
+constexpr int N = 10000;
+
+TEST_CASE("pipeline of kernels connected by blocking pipes", "[dataflow]") {
+  buffer<int> result { 1 };
+  {
+    queue q { property::queue::dataflow {} };
+    REQUIRE(q.has_property<property::queue::dataflow>());
+    REQUIRE(q.implementation->is_dataflow());
+
+    sycl_2_2::pipe<int> a { 4 };
+    sycl_2_2::pipe<int> b { 4 };
+    std::atomic<bool> started = false;
+
+    // Submit the consumer first, so it is held until the whole gang is known
+    q.submit([&](handler &cgh) {
+        auto in = b.get_access<access::mode::read,
+                               access::target::blocking_pipe>(cgh);
+        auto r = result.get_access<access::mode::discard_write>(cgh);
+        cgh.single_task([=, &started] {
+            started = true;
+            int sum = 0;
+            for (int i = 0; i != N; ++i)
+              sum += in.read();
+            r[0] = sum;
+          });
+      });
+
+    q.submit([&](handler &cgh) {
+        auto in = a.get_access<access::mode::read,
+                               access::target::blocking_pipe>(cgh);
+        auto out = b.get_access<access::mode::write,
+                                access::target::blocking_pipe>(cgh);
+        cgh.single_task([=] {
+            for (int i = 0; i != N; ++i)
+              out << 2*in.read();
+          });
+      });
+    // The pipe a has no writer yet
+    REQUIRE(!started);
+
+    q.submit([&](handler &cgh) {
+        auto out = a.get_access<access::mode::write,
+                                access::target::blocking_pipe>(cgh);
+        cgh.single_task([=] {
+            for (int i = 0; i != N; ++i)
+              out << 1;
+          });
+      });
+  }
+  REQUIRE(result.get_access<access::mode::read>()[0] == 2*N);
+}
+
+TEST_CASE("incomplete gang started on wait", "[dataflow]") {
+  queue q { property::queue::dataflow {} };
+  sycl_2_2::pipe<int> p { 4 };
+  std::atomic<bool> done = false;
+  q.submit([&](handler &cgh) {
+      auto out = p.get_access<access::mode::write>(cgh);
+      cgh.single_task([=, &done] {
+          out << 42;
+          done = static_cast<bool>(out);
+        });
+    });
+  // There is no reader, but waiting starts the writer anyway
+  q.wait();
+  REQUIRE(done);
+}
@@ -0,0 +1,64 @@
+/* RUN: %{execute}%s
+
+   Test the events returned by the command group submissions
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("wait for a single kernel", "[event]") {
+  queue q;
+  std::atomic<bool> go = false;
+  std::atomic<bool> started = false;
+  // A kernel held until the end of the test
+  auto slow = q.submit([&](handler &cgh) {
+      cgh.single_task([&] {
+          started = true;
+          while (!go) {
+            // Do not starve the pool when the tasks are fibers
+            ::trisycl::detail::yield_task();
+            std::this_thread::yield();
+          }
+        });
+    });
+  int v = 0;
+  auto fast = q.submit([&](handler &cgh) {
+      cgh.single_task([&] { v = 42; });
+    });
+  // Only wait for the second kernel while the first one is still running
+  fast.wait();
+  REQUIRE(v == 42);
+  REQUIRE(fast.get_info<info::event::command_execution_status>()
+          == info::event_command_status::complete);
+  while (!started)
+    std::this_thread::yield();
+  REQUIRE(slow.get_info<info::event::command_execution_status>()
+          == info::event_command_status::running);
+
+  // A kernel depending on the held one is not started yet
+  auto next = q.submit([&](handler &cgh) {
+      cgh.depends_on(slow);
+      cgh.single_task([&] { v = 7; });
+    });
+  REQUIRE(next.get_info<info::event::command_execution_status>()
+          == info::event_command_status::submitted);
+  REQUIRE(v == 42);
+  go = true;
+  next.wait();
+  REQUIRE(v == 7);
+  REQUIRE(slow.get_info<info::event::command_execution_status>()
+          == info::event_command_status::complete);
+}
+
+TEST_CASE("event of an empty command group", "[event]") {
+  queue q;
+  auto e = q.submit([&](handler &) {});
+  e.wait();
+  REQUIRE(e.get_info<info::event::command_execution_status>()
+          == info::event_command_status::complete);
+}
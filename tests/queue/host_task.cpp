@@ -0,0 +1,73 @@
+/* RUN: %{execute}%s
+
+   Check the host tasks ordered with the kernels by their accessors
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 100;
+
+TEST_CASE("host task between some kernels", "[queue]") {
+  queue q;
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] = i[0]; });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write,
+                            access::target::host_task>(cgh);
+      cgh.host_task([=] {
+          for (int i = 0; i < n; ++i)
+            a[i] *= 2;
+        });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] += 1; });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (int i = 0; i < n; ++i)
+    REQUIRE(a[i] == 2*i + 1);
+}
+
+TEST_CASE("host task without accessor", "[queue]") {
+  queue q;
+  std::atomic<bool> done = false;
+  auto e = q.submit([&](handler &cgh) {
+      cgh.host_task([&] { done = true; });
+    });
+  e.wait();
+  REQUIRE(done);
+}
+
+TEST_CASE("independent host tasks overlap with a kernel", "[queue]") {
+  queue q;
+  std::vector<int> v(n);
+  buffer<int> kernel_data { n };
+  {
+    buffer<int> host_data { v.data(), n };
+    q.submit([&](handler &cgh) {
+        auto a = kernel_data.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i] = 1; });
+      });
+    q.submit([&](handler &cgh) {
+        auto a = host_data.get_access<access::mode::discard_write,
+                                      access::target::host_task>(cgh);
+        cgh.host_task([=] {
+            for (int i = 0; i < n; ++i)
+              a[i] = 3;
+          });
+      });
+  }
+  for (auto e : v)
+    REQUIRE(e == 3);
+  auto a = kernel_data.get_access<access::mode::read>();
+  REQUIRE(a[0] == 1);
+}
@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Test the in-order queue property
+*/
+#include <CL/sycl.hpp>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+using namespace std::chrono_literals;
+
+TEST_CASE("in-order execution without any buffer", "[in_order]") {
+  queue q { property::queue::in_order {} };
+  REQUIRE(q.has_property<property::queue::in_order>());
+  REQUIRE(q.implementation->is_in_order());
+
+  std::vector<int> order;
+  for (int i = 0; i < 200; ++i)
+    q.submit([&](handler &cgh) {
+        cgh.single_task([&, i] { order.push_back(i); });
+      });
+  q.wait();
+  REQUIRE(order.size() == 200);
+  for (int i = 0; i < 200; ++i)
+    REQUIRE(order[i] == i);
+}
+
+TEST_CASE("in-order chain of dependent kernels", "[in_order]") {
+  queue q { property::queue::in_order {} };
+  buffer<int> b { 1 };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 0; });
+    });
+  for (int i = 0; i < 100; ++i)
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] { a[0] = 2*a[0] % 1001 + i; });
+      });
+  int expected = 0;
+  for (int i = 0; i < 100; ++i)
+    expected = 2*expected % 1001 + i;
+  // The host accessor still waits for the kernels
+  REQUIRE(b.get_access<access::mode::read>()[0] == expected);
+}
+
+TEST_CASE("in-order queue sharing a buffer with another queue",
+          "[in_order]") {
+  queue in { property::queue::in_order {} };
+  queue out;
+  int init = 0;
+  buffer<int> b { &init, 1 };
+  for (int i = 0; i < 20; ++i) {
+    // The other queue has to wait for the in-order writer, and back
+    in.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] {
+            std::this_thread::sleep_for(1ms);
+            a[0] = 2*a[0] + 1;
+          });
+      });
+    out.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] { a[0] = a[0] % 1001; });
+      });
+  }
+  int expected = 0;
+  for (int i = 0; i < 20; ++i)
+    expected = (2*expected + 1) % 1001;
+  REQUIRE(b.get_access<access::mode::read>()[0] == expected);
+}
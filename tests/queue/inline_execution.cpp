@@ -0,0 +1,65 @@
+/* RUN: %{execute}%s
+
+   Check the command groups run on the submitting thread
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+/// Submit a kernel recording the thread running it
+void record_thread(queue &q, std::thread::id &id,
+                   bool latency_critical = false) {
+  q.submit([&](handler &cgh) {
+      if (latency_critical)
+        cgh.set_latency_critical();
+      cgh.single_task([&] { id = std::this_thread::get_id(); });
+    });
+}
+
+
+TEST_CASE("latency-critical command group", "[queue]") {
+  queue q;
+  std::thread::id id;
+  record_thread(q, id, true);
+  // The kernel is already done
+  REQUIRE(id == std::this_thread::get_id());
+  q.wait();
+}
+
+
+TEST_CASE("inline execution on an idle queue", "[queue]") {
+  queue q { property::queue::inline_execution {} };
+  std::thread::id id;
+  record_thread(q, id);
+  REQUIRE(id == std::this_thread::get_id());
+
+  // Make the queue busy with a command group waiting for another queue
+  queue producer;
+  buffer<int> b { 1 };
+  std::atomic<bool> go = false;
+  producer.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=, &go] {
+          while (!go)
+            std::this_thread::yield();
+          a[0] = 42;
+        });
+    });
+  std::thread::id consumer_id, busy_id;
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read>(cgh);
+      cgh.single_task([=, &consumer_id] {
+          consumer_id = std::this_thread::get_id();
+        });
+    });
+  record_thread(q, busy_id);
+  go = true;
+  q.wait();
+  REQUIRE(consumer_id != std::this_thread::get_id());
+  REQUIRE(busy_id != std::this_thread::get_id());
+}
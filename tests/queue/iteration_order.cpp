@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Test the tiled and space-filling-curve iteration orders
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <cstdlib>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+using order = property::queue::iteration_order::order;
+
+/// The Manhattan distance between 2 tiles
+template <int Dimensions>
+std::size_t distance(const id<Dimensions> &a, const id<Dimensions> &b) {
+  std::size_t d = 0;
+  for (int i = 0; i != Dimensions; ++i)
+    d += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+  return d;
+}
+
+TEST_CASE("curves", "[iteration_order]") {
+  detail::ordered_tiles<2> m { { 4, 4 }, { 1, 1, 1 }, order::morton };
+  REQUIRE(m.tiles.size() == 16);
+  REQUIRE(m.tiles[0] == id<2> { 0, 0 });
+  REQUIRE(m.tiles[1] == id<2> { 0, 1 });
+  REQUIRE(m.tiles[2] == id<2> { 1, 0 });
+  REQUIRE(m.tiles[3] == id<2> { 1, 1 });
+  REQUIRE(m.tiles[4] == id<2> { 0, 2 });
+
+  // Consecutive tiles along a Hilbert curve are neighbors
+  detail::ordered_tiles<2> h2 { { 16, 16 }, { 1, 1, 1 }, order::hilbert };
+  REQUIRE(h2.tiles.size() == 256);
+  for (std::size_t i = 1; i < h2.tiles.size(); ++i)
+    REQUIRE(distance(h2.tiles[i - 1], h2.tiles[i]) == 1);
+  detail::ordered_tiles<3> h3 { { 8, 8, 8 }, { 1, 1, 1 }, order::hilbert };
+  REQUIRE(h3.tiles.size() == 512);
+  for (std::size_t i = 1; i < h3.tiles.size(); ++i)
+    REQUIRE(distance(h3.tiles[i - 1], h3.tiles[i]) == 1);
+
+  // Partial tiles at the border
+  detail::ordered_tiles<2> t { { 10, 100 }, { 0, 4, 64 }, order::tiled };
+  REQUIRE(t.tiles.size() == 3*2);
+  REQUIRE(t.tiles[1] == id<2> { 0, 1 });
+}
+
+TEST_CASE("each work-item is executed once", "[iteration_order]") {
+  for (auto o : { order::row_major, order::tiled,
+                  order::morton, order::hilbert }) {
+    queue q { property::queue::iteration_order { o, { 3, 5, 7 } } };
+    REQUIRE(q.get_property<property::queue::iteration_order>().get_order()
+            == o);
+    constexpr std::size_t n = 23*37*11;
+    buffer<int> b { n };
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::discard_write>(cgh);
+        cgh.parallel_for(range<2> { 23, 37*11 },
+                         [=](id<2> i) { a[i[0]*37*11 + i[1]] = 1; });
+      });
+    q.submit([&](handler &cgh) {
+        auto a = b.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for(range<3> { 23, 37, 11 },
+                         [=](item<3> i) {
+                           a[(i[0]*37 + i[1])*11 + i[2]] += 10;
+                         });
+      });
+    auto a = b.get_access<access::mode::read>();
+    for (std::size_t i = 0; i < n; ++i)
+      REQUIRE(a[i] == 11);
+  }
+}
@@ -0,0 +1,98 @@
+/* RUN: %{execute}%s
+
+   Test the fusion of consecutive element-wise kernels
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+TEST_CASE("fusion of a scale, add and clamp chain", "[kernel_fusion]") {
+  constexpr std::size_t n = 10*detail::fused_kernels::chunk_size + 7;
+  queue q { property::queue::fuse_kernels {} };
+  REQUIRE(q.has_property<property::queue::fuse_kernels>());
+  REQUIRE(q.implementation->fuses_kernels());
+
+  buffer<int> a { n };
+  buffer<int> b { n };
+  // Hold the first kernel so the next ones are submitted before it runs
+  std::atomic<bool> go = false;
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=, &go] {
+          while (!go) {
+            // Do not starve the pool when the tasks are fibers
+            detail::yield_task();
+            std::this_thread::yield();
+          }
+          for (std::size_t i = 0; i < n; ++i)
+            ka[i] = i;
+        });
+    });
+
+  std::atomic<bool> last_scaled = false;
+  std::atomic<bool> first_added_after_last_scaled = true;
+  // a *= 2
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=, &last_scaled](id<1> i) {
+          ka[i] *= 2;
+          if (i[0] == n - 1)
+            last_scaled = true;
+        });
+    });
+  // b = a + 3
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::read>(cgh);
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=, &last_scaled,
+                                        &first_added_after_last_scaled]
+                       (item<1> i) {
+          kb[i] = ka[i] + 3;
+          if (i[0] == 0)
+            first_added_after_last_scaled = last_scaled.load();
+        });
+    });
+  // b = min(b, 1000)
+  q.submit([&](handler &cgh) {
+      auto kb = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          kb[i] = std::min(kb[i], 1000);
+        });
+    });
+  go = true;
+
+  auto hb = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(hb[i] == std::min(int(2*i + 3), 1000));
+  // The second kernel ran on the first chunk before the first kernel ended
+  REQUIRE(!first_added_after_last_scaled);
+}
+
+TEST_CASE("kernels with different ranges are not fused", "[kernel_fusion]") {
+  constexpr std::size_t n = 100;
+  queue q { property::queue::fuse_kernels {} };
+  buffer<int> a { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { ka[i] = i[0]; });
+    });
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::read_write>(cgh);
+      // Each work-item uses the results of other work-items
+      cgh.parallel_for(range<1> { n/2 }, [=](id<1> i) {
+          ka[i] += ka[n - 1 - i[0]];
+        });
+    });
+  q.wait();
+  auto ha = a.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(ha[i] == int(i < n/2 ? n - 1 : i));
+}
@@ -0,0 +1,55 @@
+/* RUN: %{execute}%s
+
+   Check the latency histograms of the queues
+*/
+#include <CL/sycl.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using histogram = vendor::trisycl::latency_histogram;
+
+TEST_CASE("percentiles within the histogram precision",
+          "[latency_histogram]") {
+  histogram h;
+  REQUIRE(h.percentile(0.5).count() == 0);
+  // The latencies from 1 to 1000 us
+  for (int i = 1; i <= 1000; ++i)
+    h.record(std::chrono::microseconds { i });
+  REQUIRE(h.count() == 1000);
+  REQUIRE(h.min() == std::chrono::microseconds { 1 });
+  REQUIRE(h.max() == std::chrono::microseconds { 1000 });
+  auto p99 = h.percentile(0.99).count();
+  REQUIRE(p99 >= 990'000);
+  REQUIRE(p99 <= 990'000*1.03);
+  REQUIRE(h.percentile(1) == h.max());
+  // A copy is a snapshot
+  auto s = h;
+  h.reset();
+  REQUIRE(h.count() == 0);
+  REQUIRE(s.count() == 1000);
+}
+
+TEST_CASE("latencies of the command groups of a queue",
+          "[latency_histogram]") {
+  queue q;
+  for (int i = 0; i != 20; ++i)
+    q.submit([&](handler &cgh) {
+        cgh.single_task([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds { 1 });
+          });
+      });
+  q.wait();
+  auto start = q.get_info<info::queue::submit_to_start_latency>();
+  auto duration = q.get_info<info::queue::start_to_end_latency>();
+  REQUIRE(start.count() == 20);
+  REQUIRE(duration.count() == 20);
+  // Each kernel sleeps for 1 ms
+  REQUIRE(duration.min() >= std::chrono::milliseconds { 1 });
+  REQUIRE(duration.percentile(0.5) <= duration.percentile(0.99));
+  REQUIRE(duration.percentile(0.99) <= duration.max());
+}
@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Test that a memoized kernel is skipped on unchanged inputs
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 100;
+
+/// Count the executions of the kernel
+std::atomic<int> executions = 0;
+
+
+/// Scale the input into the output, memoized on the factor
+void scale(queue &q, buffer<int> &in, buffer<int> &out, int factor) {
+  q.submit([&](handler &cgh) {
+      auto a = in.get_access<access::mode::read>(cgh);
+      auto b = out.get_access<access::mode::discard_write>(cgh);
+      cgh.memoize(factor);
+      cgh.parallel_for<class scaling>(range<1> { n }, [=](id<1> i) {
+          if (i[0] == 0)
+            ++executions;
+          b[i] = factor*a[i];
+        });
+    });
+  q.wait();
+}
+
+
+TEST_CASE("memoized kernel", "[memoize]") {
+  queue q;
+  buffer<int> in { n };
+  buffer<int> out { n };
+  {
+    auto a = in.get_access<access::mode::discard_write>();
+    for (std::size_t i = 0; i != n; ++i)
+      a[i] = i;
+  }
+  auto check = [&] (int factor) {
+    auto b = out.get_access<access::mode::read>();
+    for (std::size_t i = 0; i != n; ++i)
+      REQUIRE(b[i] == factor*static_cast<int>(i));
+  };
+  scale(q, in, out, 2);
+  REQUIRE(executions == 1);
+  // Reading the output does not invalidate it
+  check(2);
+  scale(q, in, out, 2);
+  REQUIRE(executions == 1);
+  check(2);
+  // Another scalar runs the kernel again
+  scale(q, in, out, 3);
+  REQUIRE(executions == 2);
+  check(3);
+  // Back to the first scalar, whose output has been overwritten
+  scale(q, in, out, 2);
+  REQUIRE(executions == 3);
+  // Writing the input runs the kernel again
+  in.get_access<access::mode::write>()[0] = 1;
+  scale(q, in, out, 2);
+  REQUIRE(executions == 4);
+  scale(q, in, out, 2);
+  REQUIRE(executions == 4);
+  // Writing the output runs the kernel again
+  out.get_access<access::mode::write>()[0] = 42;
+  scale(q, in, out, 2);
+  REQUIRE(executions == 5);
+  REQUIRE(out.get_access<access::mode::read>()[0] == 2);
+}
@@ -0,0 +1,52 @@
+/* RUN: %{execute}%s
+
+   Check the splitting of a parallel_for across several queues
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/multi_device.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+using multi_device = vendor::trisycl::multi_device;
+
+TEST_CASE("slices proportional to the throughputs", "[multi_device]") {
+  // Evenly while some throughputs are unknown
+  auto even = multi_device::split(1000, { 0, 0, 0 }, 64);
+  REQUIRE(even.size() == 3);
+  REQUIRE(even[0] == std::pair<std::size_t, std::size_t> { 0, 320 });
+  REQUIRE(even[1] == std::pair<std::size_t, std::size_t> { 320, 320 });
+  REQUIRE(even[2] == std::pair<std::size_t, std::size_t> { 640, 360 });
+  // The last slice takes the remainder
+  auto weighted = multi_device::split(1000, { 1, 3 });
+  REQUIRE(weighted[0].second == 250);
+  REQUIRE(weighted[1].second == 750);
+}
+
+TEST_CASE("parallel_for across several queues", "[multi_device]") {
+  constexpr std::size_t N = 1000;
+  buffer<int, 2> b { range<2> { N, 4 } };
+  multi_device md { { queue {}, queue {} } };
+  for (int launch = 0; launch != 3; ++launch) {
+    auto e = md.parallel_for(b.get_range(),
+                             [&] (handler &cgh, range<2> r, id<2> o) {
+        auto a = b.get_access<access::mode::discard_write>(cgh, r, o);
+        cgh.parallel_for(r, o, [=] (item<2> i) {
+            a[i] = i[0]*4 + i[1] + launch;
+          });
+      });
+    e.wait();
+    REQUIRE(e.get_info<info::event::command_execution_status>()
+            == info::event_command_status::complete);
+  }
+  // Both queues have been measured
+  for (auto t : md.get_throughputs())
+    REQUIRE(t > 0);
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i != N; ++i)
+    for (std::size_t j = 0; j != 4; ++j)
+      REQUIRE(a[i][j] == static_cast<int>(i*4 + j + 2));
+}
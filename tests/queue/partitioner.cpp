@@ -0,0 +1,85 @@
+/* RUN: %{execute}%s
+
+   Test the partitioner queue property
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace trisycl;
+
+using kind = property::queue::partitioner::kind;
+
+/// Check each work-item of a 1D, 2D and 3D kernel is executed once
+void check_kernels(queue &q) {
+  constexpr std::size_t n = 1000;
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { a[i[0]] = 1; });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<2> { 10, 100 },
+                       [=](id<2> i) { a[i[0]*100 + i[1]] += 10; });
+    });
+  q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.parallel_for(range<3> { 5, 10, 20 },
+                       [=](id<3> i) {
+                         a[(i[0]*10 + i[1])*20 + i[2]] += 100;
+                       });
+    });
+  auto a = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == 111);
+}
+
+TEST_CASE("partitioner property", "[partitioner]") {
+  queue q { property::queue::partitioner { kind::static_partitioner, 64 } };
+  REQUIRE(q.has_property<property::queue::partitioner>());
+  auto p = q.get_property<property::queue::partitioner>();
+  REQUIRE(p.get_kind() == kind::static_partitioner);
+  REQUIRE(p.get_grain_size() == 64);
+  REQUIRE(q.implementation->get_partitioning().grain_size == 64);
+  check_kernels(q);
+}
+
+TEST_CASE("all the partitioners", "[partitioner]") {
+  for (auto k : { kind::auto_partitioner, kind::affinity_partitioner,
+                  kind::static_partitioner, kind::simple_partitioner }) {
+    queue q { property::queue::partitioner { k, 16 } };
+    // Launch several times for the affinity partitioner replay
+    for (int i = 0; i < 3; ++i)
+      check_kernels(q);
+  }
+  // The default for a queue without the property
+  queue q;
+  check_kernels(q);
+}
+
+#if defined(__linux__) && defined(_OPENMP) && !defined(TRISYCL_TBB) \
+  && !defined(TRISYCL_WORK_STEALING)
+TEST_CASE("OpenMP slices kept on the same CPUs", "[partitioner]") {
+  constexpr std::size_t n = 1 << 16;
+  queue q { property::queue::partitioner { kind::affinity_partitioner } };
+  // The CPU running each work-item of 2 different kernels
+  std::vector<int> first(n), second(n);
+  for (auto cpus : { first.data(), second.data() })
+    q.submit([&](handler &cgh) {
+        cgh.parallel_for(range<1> { n },
+                         vendor::trisycl::cost_hint(1000, [=](id<1> i) {
+                             cpus[i[0]] = sched_getcpu();
+                           }));
+      }).wait();
+  REQUIRE(first == second);
+}
+#endif
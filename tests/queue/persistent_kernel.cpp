@@ -0,0 +1,53 @@
+/* RUN: %{execute}%s
+
+   Launch many times a kernel executed by a parked team of threads
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("persistent kernel launched many times", "[queue]") {
+  queue q;
+  constexpr std::size_t n = 1000;
+  std::vector<int> v(n);
+  auto p = v.data();
+  auto k = q.make_persistent<class increment>(range<1> { n },
+                                              [=] (id<1> i) { ++p[i[0]]; });
+  REQUIRE(k.get_range() == range<1> { n });
+  REQUIRE(k.get_team_size() >= 1);
+  for (int i = 0; i != 100; ++i)
+    k.launch();
+  REQUIRE(std::all_of(v.begin(), v.end(), [] (int x) { return x == 100; }));
+}
+
+TEST_CASE("persistent kernel on a 2D range with items", "[queue]") {
+  queue q;
+  std::vector<std::size_t> v(7*5);
+  auto p = v.data();
+  auto k = q.make_persistent(range<2> { 7, 5 }, [=] (item<2> i) {
+      p[i.get_linear_id()] += i.get_linear_id();
+    });
+  k();
+  k();
+  for (std::size_t i = 0; i != v.size(); ++i)
+    REQUIRE(v[i] == 2*i);
+}
+
+TEST_CASE("persistent kernel exceptions", "[queue]") {
+  queue q;
+  bool fail = true;
+  auto k = q.make_persistent(range<1> { 100 }, [&] (id<1> i) {
+      if (fail && i[0] == 42)
+        throw std::runtime_error { "failed" };
+    });
+  REQUIRE_THROWS_AS(k.launch(), std::runtime_error);
+  // The team is still usable after a failure
+  fail = false;
+  REQUIRE_NOTHROW(k.launch());
+}
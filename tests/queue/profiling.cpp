@@ -0,0 +1,39 @@
+/* RUN: %{execute}%s
+
+   Test the profiling information of the command group events
+*/
+#include <CL/sycl.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("timestamps of a kernel", "[profiling]") {
+  queue q { property::queue::enable_profiling {} };
+  REQUIRE(q.has_property<property::queue::enable_profiling>());
+  auto e = q.submit([&](handler &cgh) {
+      cgh.single_task([] {
+          std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+        });
+    });
+  auto submit = e.get_profiling_info<info::event_profiling::command_submit>();
+  auto start = e.get_profiling_info<info::event_profiling::command_start>();
+  auto end = e.get_profiling_info<info::event_profiling::command_end>();
+  REQUIRE(submit != 0);
+  REQUIRE(submit <= start);
+  // The kernel sleeps for 10 ms
+  REQUIRE(end - start >= 10'000'000);
+}
+
+TEST_CASE("no profiling without the property", "[profiling]") {
+  queue q;
+  auto e = q.submit([&](handler &cgh) {
+      cgh.single_task([] {});
+    });
+  REQUIRE_THROWS_AS(
+    e.get_profiling_info<info::event_profiling::command_start>(),
+    invalid_object_error);
+}
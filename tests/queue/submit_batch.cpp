@@ -0,0 +1,75 @@
+/* RUN: %{execute}%s
+
+   Check the command groups submitted as a batch
+*/
+#include <CL/sycl.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 1000;
+
+TEST_CASE("batch of independent and dependent command groups", "[queue]") {
+  queue q;
+  std::vector<buffer<int>> independent;
+  for (int i = 0; i != n; ++i)
+    independent.push_back(buffer<int> { 1 });
+  buffer<int> chain { 1 };
+  std::vector<std::function<void(handler &)>> cgfs;
+  cgfs.push_back([&](handler &cgh) {
+      auto a = chain.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 0; });
+    });
+  for (int i = 0; i != n; ++i) {
+    cgfs.push_back([&, i](handler &cgh) {
+        auto a = independent[i].get_access<access::mode::discard_write>(cgh);
+        cgh.single_task([=] { a[0] = i; });
+      });
+    // A chain of dependent command groups inside the batch
+    cgfs.push_back([&](handler &cgh) {
+        auto a = chain.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] { ++a[0]; });
+      });
+  }
+  auto events = q.submit_batch(cgfs);
+  REQUIRE(events.size() == cgfs.size());
+  events.back().wait();
+  REQUIRE(chain.get_access<access::mode::read>()[0] == n);
+  for (int i = 0; i != n; ++i)
+    REQUIRE(independent[i].get_access<access::mode::read>()[0] == i);
+}
+
+TEST_CASE("batch on an in-order queue", "[queue]") {
+  queue q { property::queue::in_order {} };
+  std::vector<int> order;
+  std::vector<std::function<void(handler &)>> cgfs;
+  for (int i = 0; i != 100; ++i)
+    cgfs.push_back([&, i](handler &cgh) {
+        cgh.single_task([&, i] { order.push_back(i); });
+      });
+  q.submit_batch(cgfs);
+  q.wait();
+  REQUIRE(order.size() == 100);
+  for (int i = 0; i != 100; ++i)
+    REQUIRE(order[i] == i);
+}
+
+TEST_CASE("the command groups built before an exception still run",
+          "[queue]") {
+  queue q;
+  buffer<int> b { 1 };
+  std::vector<std::function<void(handler &)>> cgfs {
+    [&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task([=] { a[0] = 42; });
+    },
+    [](handler &) { throw std::runtime_error { "bad command group" }; }
+  };
+  REQUIRE_THROWS_AS(q.submit_batch(cgfs), std::runtime_error);
+  REQUIRE(b.get_access<access::mode::read>()[0] == 42);
+}
@@ -0,0 +1,157 @@
+/* RUN: %{execute}%s
+
+   Test the recording and the replay of command groups
+*/
+
+/// Test explicitly a triSYCL extension, so include the triSYCL header
+#include "triSYCL/sycl.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace trisycl;
+
+TEST_CASE("replay a recorded timestep", "[task_graph]") {
+  constexpr std::size_t n = 100;
+  queue q;
+  buffer<int> a { n };
+  buffer<int> b { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      auto kb = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+          ka[i] = i[0];
+          kb[i] = 0;
+        });
+    });
+
+  {
+    q.begin_recording();
+    // a += 1
+    q.submit([&](handler &cgh) {
+        auto ka = a.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) { ka[i] += 1; });
+      });
+    // b += a, which has to wait for the previous one
+    q.submit([&](handler &cgh) {
+        auto ka = a.get_access<access::mode::read>(cgh);
+        auto kb = b.get_access<access::mode::read_write>(cgh);
+        cgh.parallel_for(range<1> { n }, [=](id<1> i) { kb[i] += ka[i]; });
+      });
+    // A command group without kernel is not part of the graph
+    q.submit([&](handler &cgh) {});
+    auto g = q.end_recording();
+    REQUIRE(g.size() == 2);
+
+    // Nothing was run during the recording
+    {
+      auto ha = a.get_access<access::mode::read>();
+      REQUIRE(ha[3] == 3);
+    }
+
+    for (int step = 0; step < 10; ++step)
+      q.replay(g);
+    // A normal submission has to wait for the replays
+    q.submit([&](handler &cgh) {
+        auto kb = b.get_access<access::mode::read_write>(cgh);
+        cgh.single_task([=] { kb[0] = -kb[0]; });
+      });
+    q.wait();
+    // Destroy the graph before the buffers it uses
+  }
+
+  auto ha = a.get_access<access::mode::read>();
+  auto hb = b.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i) {
+    REQUIRE(ha[i] == int(i + 10));
+    // b is the sum of (i + 1) ... (i + 10), that is 10 i + 55
+    REQUIRE(hb[i] == (i == 0 ? -55 : int(10 * i + 55)));
+  }
+}
+
+TEST_CASE("independent nodes and misuse", "[task_graph]") {
+  queue q;
+  REQUIRE_THROWS_AS(q.end_recording(), invalid_object_error);
+  buffer<int> a { 1 };
+  buffer<int> b { 1 };
+  {
+    q.begin_recording();
+    REQUIRE_THROWS_AS(q.begin_recording(), invalid_object_error);
+    for (auto *buf : { &a, &b })
+      q.submit([&](handler &cgh) {
+          auto k = buf->get_access<access::mode::discard_write>(cgh);
+          cgh.single_task([=] { k[0] = 42; });
+        });
+    auto g = q.end_recording();
+    REQUIRE(g.size() == 2);
+    REQUIRE(g.implementation->nodes[0]->predecessors == 0);
+    REQUIRE(g.implementation->nodes[1]->predecessors == 0);
+    q.replay(g);
+    q.wait();
+  }
+  REQUIRE(a.get_access<access::mode::read>()[0] == 42);
+  REQUIRE(b.get_access<access::mode::read>()[0] == 42);
+}
+
+TEST_CASE("temporaries sharing their storage", "[task_graph]") {
+  constexpr std::size_t n = 1000;
+  queue q;
+  buffer<int> a { n };
+  q.submit([&](handler &cgh) {
+      auto ka = a.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { ka[i] = i[0]; });
+    });
+  {
+    q.begin_recording();
+    for (int stage = 0; stage < 4; ++stage) {
+      // A temporary no longer used at the end of its scope
+      buffer<int> t { n };
+      q.submit([&](handler &cgh) {
+          auto ka = a.get_access<access::mode::read>(cgh);
+          auto kt = t.get_access<access::mode::discard_write>(cgh);
+          cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+              kt[i] = ka[i] + 1;
+            });
+        });
+      q.submit([&](handler &cgh) {
+          auto ka = a.get_access<access::mode::discard_write>(cgh);
+          auto kt = t.get_access<access::mode::read>(cgh);
+          cgh.parallel_for(range<1> { n }, [=](id<1> i) {
+              ka[i] = 2*kt[i];
+            });
+        });
+    }
+    auto g = q.end_recording();
+    REQUIRE(g.size() == 8);
+    // The 4 temporaries use the same storage one after the other
+    REQUIRE(g.temporary_bytes() == 4*g.temporary_storage_bytes());
+    REQUIRE(g.temporary_storage_bytes() >= n*sizeof(int));
+    q.replay(g);
+    q.wait();
+  }
+  auto ha = a.get_access<access::mode::read>();
+  for (std::size_t i = 0; i < n; ++i)
+    // 4 times x -> 2 (x + 1)
+    REQUIRE(ha[i] == int(16*i + 30));
+}
+
+TEST_CASE("temporaries alive at the same time", "[task_graph]") {
+  queue q;
+  buffer<int> a { 1 };
+  buffer<int> b { 1 };
+  {
+    q.begin_recording();
+    for (auto *buf : { &a, &b })
+      q.submit([&](handler &cgh) {
+          auto k = buf->get_access<access::mode::discard_write>(cgh);
+          cgh.single_task([=] { k[0] = 42; });
+        });
+    auto g = q.end_recording();
+    // The user still holds both buffers, so they cannot share storage
+    REQUIRE(g.temporary_bytes() == g.temporary_storage_bytes());
+    REQUIRE(g.temporary_storage_bytes() > 0);
+    q.replay(g);
+    q.wait();
+  }
+  REQUIRE(a.get_access<access::mode::read>()[0] == 42);
+  REQUIRE(b.get_access<access::mode::read>()[0] == 42);
+}
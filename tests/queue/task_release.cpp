@@ -0,0 +1,61 @@
+/* RUN: %{execute}%s
+
+   Check that the completed tasks are released, even when an event
+   of a later task is kept
+*/
+#include <CL/sycl.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int n = 1000;
+
+/// Increment the content of a buffer
+event increment(queue &q, buffer<int> &b) {
+  return q.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::read_write>(cgh);
+      cgh.single_task([=] { ++a[0]; });
+    });
+}
+
+
+TEST_CASE("completed tasks are released", "[queue]") {
+  auto live = detail::task::live_count();
+  queue q;
+  buffer<int> b { 1 };
+  b.get_access<access::mode::discard_write>()[0] = 0;
+
+  SECTION("without events") {
+    for (int i = 0; i != n; ++i)
+      increment(q, b);
+    q.wait();
+    REQUIRE(detail::task::live_count() == live);
+  }
+
+  SECTION("with the event of the last task of a chain") {
+    event last;
+    for (int i = 0; i != n; ++i)
+      last = increment(q, b);
+    last.wait();
+    q.wait();
+    // The event keeps its task, but not the producers of the task
+    REQUIRE(detail::task::live_count() == live + 1);
+    last = {};
+    REQUIRE(detail::task::live_count() == live);
+  }
+
+  SECTION("with all the events") {
+    std::vector<event> events;
+    for (int i = 0; i != n; ++i)
+      events.push_back(increment(q, b));
+    q.wait();
+    REQUIRE(detail::task::live_count() == live + n);
+    events.clear();
+    REQUIRE(detail::task::live_count() == live);
+  }
+
+  REQUIRE(b.get_access<access::mode::read>()[0] == n);
+}
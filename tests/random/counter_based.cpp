@@ -0,0 +1,81 @@
+/* RUN: %{execute}%s
+
+   Exercise the counter-based generators of the
+   sycl::vendor::trisycl::random extension
+*/
+#include <CL/sycl.hpp>
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include <triSYCL/vendor/triSYCL/random/philox.hpp>
+#include <triSYCL/vendor/triSYCL/random/threefry.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace r = cl::sycl::vendor::trisycl::random;
+
+using words = std::array<std::uint32_t, 4>;
+
+TEST_CASE("known answers", "[random]") {
+  // From the known-answer tests of the Random123 library
+  REQUIRE(r::philox4x32<>::apply({ 0, 0, 0, 0 }, { 0, 0 })
+          == words { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 });
+  REQUIRE(r::philox4x32<>::apply({ 0x243f6a88, 0x85a308d3,
+                                   0x13198a2e, 0x03707344 },
+                                 { 0xa4093822, 0x299f31d0 })
+          == words { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 });
+  REQUIRE(r::threefry4x32<>::apply({ 0, 0, 0, 0 }, { 0, 0, 0, 0 })
+          == words { 0x9c6ca96a, 0xe17eae66, 0xfc10ecd4, 0x5256a7d8 });
+  REQUIRE(r::threefry4x32<>::apply({ 0x243f6a88, 0x85a308d3,
+                                     0x13198a2e, 0x03707344 },
+                                   { 0xa4093822, 0x299f31d0,
+                                     0x082efa98, 0xec4e6c89 })
+          == words { 0x59cd1dbb, 0xb8879579, 0x86b5d00c, 0xac8b6d84 });
+}
+
+
+TEST_CASE("streams", "[random]") {
+  r::philox4x32_10 a { 42, 7 };
+  r::philox4x32_10 b { 42, 7 };
+  r::philox4x32_10 other_stream { 42, 8 };
+  r::philox4x32_10 other_seed { 43, 7 };
+  REQUIRE(a[0] != other_stream[0]);
+  REQUIRE(a[0] != other_seed[0]);
+  REQUIRE(a() == a[0][0]);
+  for (int i = 1; i != 9; ++i)
+    a();
+  b.discard(9);
+  REQUIRE(a == b);
+  REQUIRE(a.position() == 9);
+  REQUIRE(a() == a[2][1]);
+
+  // Usable as any random number engine
+  std::uniform_int_distribution<int> dist { 0, 9 };
+  r::threefry4x32_20 t { 1 };
+  for (int i = 0; i != 100; ++i) {
+    auto v = dist(t);
+    REQUIRE(v >= 0);
+    REQUIRE(v <= 9);
+  }
+}
+
+
+TEST_CASE("a stream per work-item", "[random]") {
+  constexpr std::size_t n = 1000;
+  buffer<std::uint32_t> b { n };
+  queue {}.submit([&](handler &cgh) {
+      auto a = b.get_access<access::mode::discard_write>(cgh);
+      cgh.parallel_for(range<1> { n }, [=] (item<1> i) {
+          r::philox4x32_10 rng { 2023, i.get_linear_id() };
+          rng.discard(5);
+          a[i] = rng();
+        });
+    });
+  auto a = b.get_access<access::mode::read>();
+  // The same values whatever the threads executing the work-items
+  for (std::size_t i = 0; i != n; ++i)
+    REQUIRE(a[i] == r::philox4x32_10 { 2023, i }[1][1]);
+}
@@ -0,0 +1,73 @@
+/* RUN: %{execute}%s
+
+   Exercise the bulk random fill of the
+   sycl::vendor::trisycl::random extension
+*/
+#include <CL/sycl.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <triSYCL/vendor/triSYCL/random/fill.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+namespace r = cl::sycl::vendor::trisycl::random;
+
+/// The mean and the variance of some numbers
+template <typename T>
+std::pair<double, double> moments(const std::vector<T> &v) {
+  double mean = 0;
+  for (auto x : v)
+    mean += x;
+  mean /= v.size();
+  double variance = 0;
+  for (auto x : v)
+    variance += (x - mean)*(x - mean);
+  return { mean, variance/v.size() };
+}
+
+
+TEST_CASE("distributions", "[random]") {
+  constexpr std::size_t n = 1'000'003;
+  std::vector<float> u(n);
+  r::fill(u.data(), n, r::uniform { 2.f, 4.f }, 42);
+  REQUIRE(*std::min_element(u.begin(), u.end()) >= 2);
+  REQUIRE(*std::max_element(u.begin(), u.end()) < 4);
+  auto [ u_mean, u_variance ] = moments(u);
+  REQUIRE(std::abs(u_mean - 3) < 0.01);
+  REQUIRE(std::abs(u_variance - 1./3) < 0.01);
+
+  std::vector<double> g(n);
+  r::fill(g.data(), n, r::normal { 1., 2. }, 42);
+  auto [ g_mean, g_variance ] = moments(g);
+  REQUIRE(std::abs(g_mean - 1) < 0.01);
+  REQUIRE(std::abs(g_variance - 4) < 0.05);
+
+  std::vector<float> e(n);
+  r::fill(e.data(), n, r::exponential { 2.f }, 42);
+  REQUIRE(*std::min_element(e.begin(), e.end()) > 0);
+  auto [ e_mean, e_variance ] = moments(e);
+  REQUIRE(std::abs(e_mean - 0.5) < 0.01);
+  REQUIRE(std::abs(e_variance - 0.25) < 0.01);
+}
+
+
+TEST_CASE("reproducible fill of a buffer", "[random]") {
+  constexpr std::size_t n = 100;
+  queue q;
+  buffer<double> b { n };
+  r::fill(q, b, r::uniform<double> {}, 7);
+  std::vector<double> shorter(40);
+  r::fill(shorter.data(), shorter.size(), r::uniform<double> {}, 7);
+  auto a = b.get_access<access::mode::read>();
+  // An element does not depend on the number of elements
+  for (std::size_t i = 0; i != shorter.size(); ++i)
+    REQUIRE(a[i] == shorter[i]);
+  // The element 3 comes from the 2 first words of the counter 3
+  auto w = r::philox4x32_10 { 7 }[3];
+  REQUIRE(a[3] == ((std::uint64_t { w[0] } << 21 | w[1] >> 11)*0x1p-53));
+}
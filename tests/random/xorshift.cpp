@@ -52,3 +52,28 @@ TEST_CASE("xorshift", "[random]") {
   for (int n = 0; n < 10; ++n)
         std::cout << rdist(rng32) << '\n';
 }
+
+
+TEST_CASE("xorshift jump ahead", "[random]") {
+  r::xorshift<64> rng64;
+  auto stepped = rng64;
+  for (int i = 0; i != 1000; ++i)
+    stepped();
+  rng64.discard(1000);
+  REQUIRE(rng64.state == stepped.state);
+
+  r::xorshift<128> rng128;
+  auto stepped128 = rng128;
+  for (int i = 0; i != 1000; ++i)
+    stepped128();
+  rng128.discard(1000);
+  REQUIRE(rng128.state == stepped128.state);
+
+  // split() returns the current sequence and jumps 2^32 values after
+  r::xorshift<64> a;
+  auto b = a;
+  auto first = a.split();
+  REQUIRE(first.state == b.state);
+  b.discard(1ULL << 32);
+  REQUIRE(a.state == b.state);
+}
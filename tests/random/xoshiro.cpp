@@ -0,0 +1,67 @@
+/* RUN: %{execute}%s
+
+   Exercise the xoshiro generators of the
+   sycl::vendor::trisycl::random extension
+*/
+#include <random>
+
+#include <triSYCL/vendor/triSYCL/random/xoshiro.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+namespace r = trisycl::vendor::trisycl::random;
+
+TEST_CASE("xoshiro256**", "[random]") {
+  r::xoshiro256starstar rng;
+  rng.state = { 1, 2, 3, 4 };
+  // rotl(2*5, 7)*9
+  REQUIRE(rng() == 11520);
+  REQUIRE(rng.state == r::xoshiro256starstar::value_type {
+      7, 0, 262146, 211106232532992 });
+
+  r::xoshiro256starstar a { 42 };
+  auto stepped = a;
+  for (int i = 0; i != 1000; ++i)
+    stepped();
+  a.discard(1000);
+  REQUIRE(a.state == stepped.state);
+
+  // The jump polynomial gives the same state as 2^128 steps
+  r::xoshiro256starstar b { 42 };
+  auto expected = b.state;
+  r::detail::jump_ahead<r::xoshiro256starstar::value_type> jump {
+    r::xoshiro256starstar::next, 1, 128 };
+  auto first = b.split();
+  REQUIRE(first.state == expected);
+  REQUIRE(b.state == jump(expected));
+}
+
+
+TEST_CASE("xoroshiro128+", "[random]") {
+  r::xoroshiro128plus rng;
+  rng.state = { 1, 2 };
+  REQUIRE(rng() == 3);
+
+  r::xoroshiro128plus a { 42 };
+  auto stepped = a;
+  for (int i = 0; i != 1000; ++i)
+    stepped();
+  a.discard(1000);
+  REQUIRE(a.state == stepped.state);
+
+  // The jump polynomial gives the same state as 2^64 steps
+  r::xoroshiro128plus b { 42 };
+  auto expected = b.state;
+  b.split();
+  REQUIRE(b.state == r::detail::advance(r::detail::advance(
+      expected, r::xoroshiro128plus::next, 1ULL << 63),
+    r::xoroshiro128plus::next, 1ULL << 63));
+
+  // Usable as any random number engine
+  std::uniform_real_distribution<double> dist { 0, 1 };
+  for (int i = 0; i != 100; ++i) {
+    auto v = dist(b);
+    REQUIRE(v >= 0);
+    REQUIRE(v < 1);
+  }
+}
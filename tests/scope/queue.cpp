@@ -127,3 +127,52 @@ TEST_CASE("queue", "[scope]") {
   for (int i = 0; i < (int) b.get_count(); ++i)
     REQUIRE(i + 1 == output.read());
 }
+
+
+TEST_CASE("resident scope storage", "[scope]") {
+
+  // Some constant tables to upload only once on the device
+  struct device_tables {
+    int square[size];
+    device_tables() {
+      for (int i = 0; i < size; ++i)
+        square[i] = i*i;
+    }
+  };
+
+  // Some queue-local counter
+  struct queue_counter {
+    int launches = 0;
+  };
+
+  vendor::trisycl::scope::device<device_tables> d;
+  vendor::trisycl::scope::queue<decltype(d), queue_counter> q1 { d };
+  vendor::trisycl::scope::queue<decltype(d), queue_counter> q2 { d };
+
+  // The queues share the storage of their device but not their own
+  REQUIRE(&q1.device_scope() == &q2.device_scope());
+  REQUIRE(&q1.queue_scope() != &q2.queue_scope());
+
+  buffer<int> b { size };
+  for (int k = 0; k < 3; ++k) {
+    q1.submit([&] (auto &cgh) {
+        auto ab = b.get_access<access::mode::discard_write>(cgh);
+        cgh.template parallel_for<class use_tables>(range<1> { size },
+                                                    [=] (id<1> i, auto &kh) {
+            ab[i] = kh.device_scope().square[i[0]];
+          });
+      });
+    q1.submit([&] (auto &cgh) {
+        cgh.template single_task<class count>([=] (auto &kh) {
+            ++kh.queue_scope().launches;
+          });
+      });
+    q1.wait();
+  }
+
+  REQUIRE(q1.queue_scope().launches == 3);
+  REQUIRE(q2.queue_scope().launches == 0);
+  auto ab = b.get_access<access::mode::read>();
+  for (int i = 0; i < size; ++i)
+    REQUIRE(ab[i] == i*i);
+}
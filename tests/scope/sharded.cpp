@@ -0,0 +1,72 @@
+/* RUN: %{execute}%s
+
+   Accumulate in some scope storage replicated per worker thread
+*/
+#include <CL/sycl.hpp>
+
+#include "triSYCL/vendor/triSYCL/scope.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr int size = 1000;
+
+TEST_CASE("sharded value from threads", "[scope]") {
+  vendor::trisycl::scope::sharded<long> s;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t)
+    threads.emplace_back([&, t] {
+        for (int i = 0; i < size; ++i)
+          s.local() += t;
+      });
+  for (auto &t : threads)
+    t.join();
+  REQUIRE(s.get() == 0);
+  REQUIRE(s.synchronize() == 28*size);
+  // The replicas are reset by the synchronization
+  REQUIRE(s.synchronize() == 28*size);
+}
+
+
+TEST_CASE("sharded maximum", "[scope]") {
+  auto max = [] (int a, int b) { return a < b ? b : a; };
+  vendor::trisycl::scope::sharded<int, decltype(max)> s { -1, max };
+  std::thread { [&] { s.local() = max(s.local(), 5); } }.join();
+  s.local() = max(s.local(), 3);
+  REQUIRE(s.synchronize() == 5);
+}
+
+
+TEST_CASE("sharded device scope", "[scope]") {
+
+  struct device_storage {
+    vendor::trisycl::scope::sharded<long> sum;
+    vendor::trisycl::scope::sharded<int> count;
+
+    void synchronize() {
+      sum.synchronize();
+      count.synchronize();
+    }
+  };
+
+  auto q = vendor::trisycl::scope::queue {
+    vendor::trisycl::scope::device<device_storage> {} };
+
+  for (int k = 0; k < 2; ++k)
+    q.submit([&] (auto &cgh) {
+        cgh.template parallel_for<class accumulate>(range<1> { size },
+                                                    [=] (id<1> i, auto &kh) {
+            kh.device_scope().sum.local() += i[0];
+            ++kh.device_scope().count.local();
+          });
+      });
+  // Combine the replicas of the workers
+  q.wait();
+
+  REQUIRE(q.device_scope().sum.get() == 2L*size*(size - 1)/2);
+  REQUIRE(q.device_scope().count.get() == 2*size);
+}
@@ -0,0 +1,58 @@
+/* RUN: %{execute}%s
+
+   Stream records through a pipe with bulk reads and writes
+*/
+#include <CL/sycl.hpp>
+
+#include <array>
+#include <span>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of records sent
+constexpr int N = 1000;
+
+// Number of values in a record
+constexpr int R = 64;
+
+TEST_CASE("bulk producer-consumer kernels", "[SYCL 2.2 pipe]") {
+  cl::sycl::buffer<int> errors { 1 };
+  {
+    // Not a multiple of the record size to get some partial transfers
+    cl::sycl::sycl_2_2::pipe<int> p { 3*R/2 };
+    cl::sycl::queue q;
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class producer>([=] {
+            std::array<int, R> record;
+            for (int r = 0; r != N; ++r) {
+              for (int i = 0; i != R; ++i)
+                record[i] = r*R + i;
+              // A blocking write may only write a part of the record
+              for (std::span<const int> s { record }; !s.empty();)
+                s = s.subspan(kp.write(s));
+            }
+          });
+      });
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::pipe>(cgh);
+        auto e = errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task<class consumer>([=] {
+            e[0] = 0;
+            std::array<int, R> record;
+            for (int r = 0; r != N; ++r) {
+              // Try to read from the pipe up to a full record
+              for (std::span<int> s { record }; !s.empty();)
+                s = s.subspan(kp.read(s));
+              for (int i = 0; i != R; ++i)
+                e[0] += record[i] != r*R + i;
+            }
+          });
+      });
+  }
+  REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+}
@@ -0,0 +1,65 @@
+/* RUN: %{execute}%s
+
+   Stream some elements from a producer kernel in a child process to a
+   consumer kernel in the parent process through an inter-process pipe
+*/
+#include <CL/sycl.hpp>
+
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of values sent
+constexpr int N = 100000;
+
+TEST_CASE("producer and consumer kernels in 2 processes",
+          "[SYCL 2.2 pipe]") {
+  // A name unique to this run
+  auto name = "/trisycl_interprocess_pipe_" + std::to_string(::getpid());
+  // Fork before any thread is started by the runtime
+  auto child = ::fork();
+  REQUIRE(child >= 0);
+  if (child == 0) {
+    {
+      cl::sycl::sycl_2_2::interprocess_pipe<int> p { name, 16 };
+      cl::sycl::queue q;
+      q.submit([&](cl::sycl::handler &cgh) {
+          auto kp = p.get_access<cl::sycl::access::mode::write,
+                                 cl::sycl::access::target::blocking_pipe>(cgh);
+          cgh.single_task<class producer>([=] {
+              for (int i = 0; i != N; ++i)
+                kp << i;
+            });
+        });
+      // Wait for the producer before the child exits
+      q.wait();
+    }
+    // Do not run the test framework in the child
+    ::_exit(0);
+  }
+
+  cl::sycl::buffer<int> errors { 1 };
+  {
+    cl::sycl::sycl_2_2::interprocess_pipe<int> p { name, 16 };
+    REQUIRE(p.capacity() == 16);
+    cl::sycl::queue q;
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        auto e = errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task<class consumer>([=] {
+            e[0] = 0;
+            for (int i = 0; i != N; ++i)
+              e[0] += kp.read() != i;
+          });
+      });
+  }
+  int status;
+  REQUIRE(::waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+  REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+}
@@ -0,0 +1,121 @@
+/* RUN: %{execute}%s
+
+   Stream many elements through the lock-free path of a pipe, then
+   switch to the locked path with some reservations in the middle of
+   the stream
+*/
+#include <CL/sycl.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of values sent in each test
+constexpr int N = 100000;
+
+// Number of values written with a reservation
+constexpr int R = 10;
+
+TEST_CASE("lock-free producer-consumer kernels", "[SYCL 2.2 pipe]") {
+  cl::sycl::buffer<int> errors { 1 };
+  {
+    // A small pipe to exercise the full and empty cases
+    cl::sycl::sycl_2_2::pipe<int> p { 7 };
+    cl::sycl::queue q;
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class producer>([=] {
+            for (int i = 0; i != N; ++i)
+              kp << i;
+          });
+      });
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::pipe>(cgh);
+        auto e = errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task<class consumer>([=] {
+            e[0] = 0;
+            for (int i = 0; i != N; ++i) {
+              int v;
+              // Try to read from the pipe up to success
+              while (!(kp.read(v)))
+                ;
+              e[0] += v != i;
+            }
+          });
+      });
+  }
+  REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+}
+
+TEST_CASE("blocking accesses parking with or without spinning",
+          "[SYCL 2.2 pipe]") {
+  for (std::size_t budget : { 0, 100000 }) {
+    cl::sycl::buffer<int> errors { 1 };
+    {
+      cl::sycl::sycl_2_2::pipe<int> p { 3 };
+      p.set_spin_budget(budget);
+      cl::sycl::queue q;
+
+      q.submit([&](cl::sycl::handler &cgh) {
+          auto kp = p.get_access<cl::sycl::access::mode::write,
+                                 cl::sycl::access::target::blocking_pipe>(cgh);
+          cgh.single_task<class spinning_producer>([=] {
+              for (int i = 0; i != N; ++i)
+                kp << i;
+            });
+        });
+
+      q.submit([&](cl::sycl::handler &cgh) {
+          auto kp = p.get_access<cl::sycl::access::mode::read,
+                                 cl::sycl::access::target::blocking_pipe>(cgh);
+          auto e =
+            errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+          cgh.single_task<class spinning_consumer>([=] {
+              e[0] = 0;
+              for (int i = 0; i != N; ++i)
+                e[0] += kp.read() != i;
+            });
+        });
+    }
+    REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+  }
+}
+
+TEST_CASE("switch from the lock-free path to the reservations",
+          "[SYCL 2.2 pipe]") {
+  cl::sycl::buffer<int> errors { 1 };
+  {
+    cl::sycl::sycl_2_2::pipe<int> p { 2*R + 3 };
+    cl::sycl::queue q;
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class switching_producer>([=] {
+            // Some elements are still in the ring when reserving
+            for (int i = 0; i != N/2; ++i)
+              kp << i;
+            for (int i = N/2; i != N/2 + R; ++i) {
+              auto r = kp.reserve(1);
+              r[0] = i;
+            }
+            for (int i = N/2 + R; i != N; ++i)
+              kp << i;
+          });
+      });
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        auto e = errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task<class switching_consumer>([=] {
+            e[0] = 0;
+            for (int i = 0; i != N; ++i)
+              e[0] += kp.read() != i;
+          });
+      });
+  }
+  REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+}
@@ -0,0 +1,48 @@
+/* RUN: %{execute}%s
+
+   Move some move-only values through a pipe, constructing them in
+   place or moving them in
+*/
+#include <CL/sycl.hpp>
+
+#include <memory>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of values sent
+constexpr int N = 1000;
+
+TEST_CASE("move-only values through a pipe", "[SYCL 2.2 pipe]") {
+  cl::sycl::buffer<int> errors { 1 };
+  {
+    cl::sycl::sycl_2_2::pipe<std::unique_ptr<int>> p { 5 };
+    cl::sycl::queue q;
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class producer>([=] {
+            for (int i = 0; i != N; ++i)
+              if (i % 2)
+                kp << std::make_unique<int>(i);
+              else
+                // Construct the std::unique_ptr in the pipe
+                kp.emplace(new int { i });
+          });
+      });
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        auto e = errors.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task<class consumer>([=] {
+            e[0] = 0;
+            for (int i = 0; i != N; ++i) {
+              auto v = kp.read();
+              e[0] += !v || *v != i;
+            }
+          });
+      });
+  }
+  REQUIRE(errors.get_access<cl::sycl::access::mode::read>()[0] == 0);
+}
@@ -0,0 +1,139 @@
+/* RUN: %{execute}%s
+
+   Stream some elements from several producer kernels to several
+   consumer kernels through a single pipe
+*/
+#include <CL/sycl.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of values sent by each producer
+constexpr int N = 20000;
+
+// Number of producers and of consumers
+constexpr int K = 4;
+
+TEST_CASE("multiple producer and consumer kernels", "[SYCL 2.2 pipe]") {
+  // Count how many times each value is received
+  cl::sycl::buffer<int> received { K*N };
+  {
+    // A small pipe to exercise the full and empty cases
+    cl::sycl::sycl_2_2::pipe<int> p { 5, cl::sycl::sycl_2_2::mpmc };
+    cl::sycl::queue q;
+
+    for (int k = 0; k != K; ++k) {
+      q.submit([&](cl::sycl::handler &cgh) {
+          auto kp = p.get_access<cl::sycl::access::mode::write,
+                                 cl::sycl::access::target::blocking_pipe>(cgh);
+          cgh.single_task([=] {
+              for (int i = 0; i != N; ++i)
+                kp << k*N + i;
+            });
+        });
+      q.submit([&](cl::sycl::handler &cgh) {
+          auto kp = p.get_access<cl::sycl::access::mode::read,
+                                 cl::sycl::access::target::pipe>(cgh);
+          auto r = received.get_access<cl::sycl::access::mode::atomic>(cgh);
+          cgh.single_task([=] {
+              // Each consumer reads as many values as a producer writes
+              for (int i = 0; i != N; ++i) {
+                int v;
+                while (!kp.read(v))
+                  ;
+                r[v].fetch_add(1);
+              }
+            });
+        });
+    }
+  }
+  auto r = received.get_access<cl::sycl::access::mode::read>();
+  int errors = 0;
+  for (int i = 0; i != K*N; ++i)
+    errors += r[i] != 1;
+  REQUIRE(errors == 0);
+}
+
+TEST_CASE("ring with multiple producers and consumers", "[SYCL 2.2 pipe]") {
+  cl::sycl::detail::sycl_2_2::mpmc_ring<int> ring { 3 };
+  REQUIRE(ring.empty());
+  int values[] = { 1, 2, 3, 4 };
+  REQUIRE(ring.push(values, 4) == 3);
+  REQUIRE(ring.full());
+  REQUIRE(!ring.emplace(5));
+  int v;
+  REQUIRE(ring.pop(v));
+  REQUIRE(v == 1);
+  // Wrap around the storage
+  REQUIRE(ring.emplace(5));
+  int out[4];
+  REQUIRE(ring.pop(out, 4) == 3);
+  REQUIRE(out[0] == 2);
+  REQUIRE(out[2] == 5);
+  REQUIRE(!ring.pop(v));
+
+  // Some threads hammering a ring
+  cl::sycl::detail::sycl_2_2::mpmc_ring<int> shared { 8 };
+  std::vector<std::atomic<int>> seen(K*N);
+  std::vector<std::thread> threads;
+  for (int k = 0; k != K; ++k) {
+    threads.emplace_back([&, k] {
+        for (int i = 0; i != N; ++i)
+          while (!shared.emplace(k*N + i))
+            std::this_thread::yield();
+      });
+    threads.emplace_back([&] {
+        for (int i = 0; i != N; ++i) {
+          int x;
+          while (!shared.pop(x))
+            std::this_thread::yield();
+          seen[x]++;
+        }
+      });
+  }
+  for (auto &t : threads)
+    t.join();
+  int errors = 0;
+  for (auto &s : seen)
+    errors += s != 1;
+  REQUIRE(errors == 0);
+  REQUIRE(shared.empty());
+}
+
+TEST_CASE("no reservation with several producers and consumers",
+          "[SYCL 2.2 pipe]") {
+  cl::sycl::buffer<int> result { 1 };
+  {
+    cl::sycl::sycl_2_2::pipe<int> p { 8, cl::sycl::sycl_2_2::mpmc };
+    cl::sycl::queue q;
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::pipe>(cgh);
+        // Several accessors to the same side are fine
+        auto kp2 = p.get_access<cl::sycl::access::mode::write,
+                                cl::sycl::access::target::pipe>(cgh);
+        cgh.single_task([=] {
+            kp2.write(1);
+            try {
+              kp.reserve(2);
+            } catch (std::logic_error &) {
+              kp.write(2);
+            }
+          });
+      });
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        auto r = result.get_access<cl::sycl::access::mode::discard_write>(cgh);
+        cgh.single_task([=] {
+            r[0] = kp.read();
+            r[0] += kp.read();
+          });
+      });
+  }
+  REQUIRE(result.get_access<cl::sycl::access::mode::read>()[0] == 3);
+}
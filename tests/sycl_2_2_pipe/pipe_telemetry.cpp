@@ -0,0 +1,49 @@
+/* RUN: %{execute}%s
+
+   Query the statistics of a pipe between a producer and a consumer
+*/
+#define TRISYCL_PIPE_TELEMETRY
+
+#include <CL/sycl.hpp>
+
+#include <cstdint>
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+// Number of values sent
+constexpr int N = 10000;
+
+TEST_CASE("pipe statistics", "[SYCL 2.2 pipe]") {
+  cl::sycl::sycl_2_2::pipe<int> p { 8 };
+  {
+    cl::sycl::queue q;
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::write,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class producer>([=] {
+            for (int i = 0; i != N; ++i)
+              kp << i;
+          });
+      });
+
+    q.submit([&](cl::sycl::handler &cgh) {
+        auto kp = p.get_access<cl::sycl::access::mode::read,
+                               cl::sycl::access::target::blocking_pipe>(cgh);
+        cgh.single_task<class consumer>([=] {
+            for (int i = 0; i != N; ++i)
+              kp.read();
+          });
+      });
+    // The queue destruction does not wait for the kernels
+    q.wait();
+  }
+  auto s = p.get_statistics();
+  REQUIRE(s.written == N);
+  REQUIRE(s.read == N);
+  // The occupancy is sampled once per period of elements written
+  REQUIRE(std::accumulate(s.occupancy.begin(), s.occupancy.end(),
+                          std::uint64_t {})
+          == N/trisycl::detail::sycl_2_2::pipe_telemetry::sample_period);
+}
@@ -0,0 +1,37 @@
+/* RUN: %{execute}%s
+
+   Chain some kernels through pipes with the pipeline extension
+*/
+#include <CL/sycl.hpp>
+#include <triSYCL/vendor/triSYCL/pipeline.hpp>
+
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t N = 10000;
+
+TEST_CASE("pipeline of 3 stages", "[pipeline]") {
+  std::vector<int> v(N);
+  std::iota(v.begin(), v.end(), 0);
+  buffer<int> input { v.begin(), v.end() };
+  buffer<double> output { range<1> { N } };
+  queue q;
+  // Small pipes to exercise the stalls
+  auto p = vendor::trisycl::pipeline { q, 2 }
+    .stage([] (int x) { return 2*x; })
+    .stage([] (int x) { return x + 0.5; })
+    .stage([] (double x) { return 2*x; });
+  // Run it several times, maybe with some other capacities
+  for (int run = 0; run != 3; ++run) {
+    p.run(input, output);
+    auto o = output.get_access<access::mode::read>();
+    for (std::size_t i = 0; i != N; ++i)
+      REQUIRE(o[i] == 4*i + 1);
+    REQUIRE(p.get_capacity(0) >= 2);
+    REQUIRE(p.get_capacity(1) <= p.max_capacity);
+  }
+}
@@ -0,0 +1,80 @@
+/* RUN: %{execute}%s
+
+   Test the unified shared memory allocations and the events ordering
+   the kernels using them
+*/
+#include <CL/sycl.hpp>
+
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+constexpr std::size_t n = 1000;
+
+TEST_CASE("allocation kinds", "[usm]") {
+  queue q;
+  auto d = malloc_device<int>(n, q);
+  auto h = malloc_host<int>(n, q);
+  auto s = malloc_shared<int>(n, q);
+  REQUIRE(d);
+  REQUIRE(h);
+  REQUIRE(s);
+  auto ctx = q.get_context();
+  REQUIRE(get_pointer_type(d, ctx) == usm::alloc::device);
+  REQUIRE(get_pointer_type(h + n/2, ctx) == usm::alloc::host);
+  REQUIRE(get_pointer_type(s + n - 1, ctx) == usm::alloc::shared);
+  int i = 0;
+  REQUIRE(get_pointer_type(&i, ctx) == usm::alloc::unknown);
+  free(d, q);
+  free(h, q);
+  free(s, ctx);
+  REQUIRE(get_pointer_type(s, ctx) == usm::alloc::unknown);
+}
+
+TEST_CASE("kernels ordered by events", "[usm]") {
+  queue q;
+  auto a = malloc_shared<int>(n, q);
+  auto b = malloc_device<int>(n, q);
+  auto fill = q.fill(a, 1, n);
+  auto init = q.parallel_for(range<1> { n }, fill, [=](id<1> i) {
+      a[i[0]] += i[0];
+    });
+  auto copy = q.copy(a, b, n, { init });
+  auto twice = q.submit([&](handler &cgh) {
+      cgh.depends_on(copy);
+      cgh.parallel_for(range<1> { n }, [=](id<1> i) { b[i[0]] *= 2; });
+    });
+  q.memcpy(a, b, n*sizeof(int), twice).wait();
+  for (std::size_t i = 0; i < n; ++i)
+    REQUIRE(a[i] == 2*(1 + int(i)));
+  q.memset(b, 0, n*sizeof(int)).wait();
+  q.single_task([=] { a[0] = b[n - 1]; });
+  q.wait();
+  REQUIRE(a[0] == 0);
+  free(a, q);
+  free(b, q);
+}
+
+TEST_CASE("events of an in-order queue", "[usm]") {
+  queue q { property::queue::in_order {} };
+  auto a = malloc_host<int>(1, q);
+  auto e = q.single_task([=] { *a = 42; });
+  e.wait();
+  REQUIRE(e.get_info<info::event::command_execution_status>()
+          == info::event_command_status::complete);
+  REQUIRE(*a == 42);
+  free(a, q);
+}
+
+TEST_CASE("containers with a USM allocator", "[usm]") {
+  queue q;
+  std::vector<int, usm_allocator<int, usm::alloc::shared>> v { q };
+  v.resize(n, 3);
+  q.parallel_for(range<1> { n }, [p = v.data()](id<1> i) {
+      p[i[0]] += 1;
+    }).wait();
+  for (auto e : v)
+    REQUIRE(e == 4);
+}
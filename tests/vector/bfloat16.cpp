@@ -0,0 +1,94 @@
+/* RUN: %{execute}%s
+
+   Test the bfloat16 type, its vectors, the bulk conversions and the
+   widening multiply-accumulate
+*/
+#include <CL/sycl.hpp>
+#include "triSYCL/vendor/triSYCL/half_conversion.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("bfloat16 arithmetic", "[vector]") {
+  bfloat16 a = 1.5f;
+  bfloat16 b = 2;
+  REQUIRE(a*b + a == 4.5f);
+  REQUIRE(a < b);
+  REQUIRE(-a == -1.5f);
+  // Rounding to the nearest even bfloat16
+  REQUIRE(float(bfloat16 { 257.0f }) == 256);
+  REQUIRE(float(bfloat16 { 259.0f }) == 260);
+  REQUIRE(float(bfloat16 { 1e30f }) == 0x1.94p+99f);
+  REQUIRE(std::isinf(float(bfloat16 { 0x1.ffp+127f })));
+  auto nan = std::numeric_limits<float>::quiet_NaN();
+  REQUIRE(std::isnan(float(bfloat16 { nan })));
+  REQUIRE(std::numeric_limits<bfloat16>::max() == 0x1.fep+127f);
+  REQUIRE(std::numeric_limits<bfloat16>::epsilon() == 0x1p-7f);
+  static_assert(sizeof(bfloat16) == 2);
+  static_assert(std::is_same_v<decltype(a + b), bfloat16>);
+  static_assert(std::is_same_v<decltype(a + 1), bfloat16>);
+  static_assert(std::is_same_v<decltype(a + 1.0f), float>);
+}
+
+TEST_CASE("bfloat16 software conversions", "[vector]") {
+  // Compare the software version with the one used by bfloat16
+  for (std::uint32_t i = 0; i < 0xffff0000; i += 0x10001) {
+    float f;
+    std::memcpy(&f, &i, sizeof(f));
+    if (!std::isnan(f))
+      REQUIRE(detail::float_to_bfloat16_bits(f)
+              == bfloat16 { f }.get_bits());
+  }
+}
+
+TEST_CASE("bfloat16 vectors", "[vector]") {
+  bfloat164 v { 1.0f, 2.0f, 3.0f, 4.0f };
+  auto w = v*v + v;
+  REQUIRE(w[3] == 20);
+  REQUIRE(sizeof(bfloat163) == 4*sizeof(bfloat16));
+  REQUIRE(sizeof(bfloat1616) == 16*sizeof(bfloat16));
+  auto f = v.convert<float>();
+  REQUIRE(f[2] == 3.0f);
+}
+
+TEST_CASE("bfloat16 bulk conversions", "[vector]") {
+  const std::size_t n = 1003;
+  std::vector<float> f(n);
+  for (std::size_t i = 0; i < n; ++i)
+    f[i] = std::sin(i*0.37f)*1000;
+  std::vector<bfloat16> h(n);
+  std::vector<float> g(n);
+  vendor::trisycl::convert(f.data(), h.data(), n);
+  vendor::trisycl::convert(h.data(), g.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    REQUIRE(h[i].get_bits() == bfloat16 { f[i] }.get_bits());
+    REQUIRE(g[i] == float(h[i]));
+  }
+}
+
+TEST_CASE("widening multiply-accumulate", "[vector]") {
+  // The product is not rounded to the 8 bits of a bfloat16
+  bfloat16 a = 1.0078125f;
+  REQUIRE(mad_widen(a, a, 0.0f) == 1.0078125f*1.0078125f);
+  REQUIRE(mad_widen(half { 1.5f }, half { 2 }, 1.0f) == 4.0f);
+  bfloat164 v { 1.0f, 2.0f, 3.0f, 4.0f };
+  float4 c { 1.0f, 1.0f, 1.0f, 1.0f };
+  auto m = mad_widen(v, v, c);
+  static_assert(std::is_same_v<decltype(m), float4>);
+  REQUIRE(m[3] == 17);
+  REQUIRE(dot_widen(v, v) == 30);
+  bfloat1616 x, y;
+  float expected = 0.5f;
+  for (int i = 0; i < 16; ++i) {
+    x[i] = i + 1;
+    y[i] = 0.25f*i;
+    expected += float(x[i])*float(y[i]);
+  }
+  REQUIRE(dot_widen(x, y, 0.5f) == expected);
+}
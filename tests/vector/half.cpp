@@ -0,0 +1,72 @@
+/* RUN: %{execute}%s
+
+   Test the half type, its vectors and the bulk conversions
+*/
+#include <CL/sycl.hpp>
+#include "triSYCL/vendor/triSYCL/half_conversion.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("half arithmetic", "[vector]") {
+  half a = 1.5f;
+  half b = 2;
+  REQUIRE(a*b + a == 4.5f);
+  REQUIRE(a < b);
+  REQUIRE(b > a);
+  REQUIRE(-a == -1.5f);
+  // Rounding to the nearest even half
+  REQUIRE(float(half { 0.1f }) == 0.0999755859375f);
+  REQUIRE(float(half { 2049.0f }) == 2048);
+  REQUIRE(std::isinf(float(half { 65520.0f })));
+  REQUIRE(std::numeric_limits<half>::max() == 65504.0f);
+  REQUIRE(std::numeric_limits<half>::denorm_min() == 0x1p-24f);
+  static_assert(sizeof(half) == 2);
+  static_assert(std::is_same_v<decltype(a + b), half>);
+  static_assert(std::is_same_v<decltype(a + 1), half>);
+  static_assert(std::is_same_v<decltype(a + 1.0f), float>);
+}
+
+TEST_CASE("software conversions", "[vector]") {
+  // Compare the software version with the one used by half
+  for (std::uint32_t i = 0; i < 0xffff0000; i += 0x10001) {
+    float f;
+    std::memcpy(&f, &i, sizeof(f));
+    if (!std::isnan(f))
+      REQUIRE(detail::float_to_half_bits(f) == half { f }.get_bits());
+  }
+  for (std::uint32_t i = 0; i < 0x10000; ++i) {
+    auto h = half::from_bits(i);
+    if (!std::isnan(float(h)))
+      REQUIRE(detail::half_bits_to_float(i) == float(h));
+  }
+}
+
+TEST_CASE("half vectors", "[vector]") {
+  half4 v { 1.0f, 2.0f, 3.0f, 4.0f };
+  auto w = v*v + v;
+  REQUIRE(w[3] == 20);
+  REQUIRE(sizeof(half3) == 4*sizeof(half));
+  REQUIRE(sizeof(half16) == 16*sizeof(half));
+}
+
+TEST_CASE("bulk conversions", "[vector]") {
+  const std::size_t n = 1003;
+  std::vector<float> f(n);
+  for (std::size_t i = 0; i < n; ++i)
+    f[i] = std::sin(i*0.37f)*1000;
+  std::vector<half> h(n);
+  std::vector<float> g(n);
+  vendor::trisycl::convert(f.data(), h.data(), n);
+  vendor::trisycl::convert(h.data(), g.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    REQUIRE(h[i].get_bits() == half { f[i] }.get_bits());
+    REQUIRE(g[i] == float(h[i]));
+  }
+}
@@ -0,0 +1,69 @@
+/* RUN: %{execute}%s
+
+   Test the vec<> load and store member functions
+*/
+#include <CL/sycl.hpp>
+#include "triSYCL/vendor/triSYCL/nontemporal_store.hpp"
+
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+TEST_CASE("load and store through multi_ptr", "[vector]") {
+  std::vector<float> data(12);
+  std::iota(data.begin(), data.end(), 0);
+
+  vec<float, 4> v;
+  v.load(1, global_ptr<float> { data.data() });
+  REQUIRE(v.x() == 4);
+  REQUIRE(v.y() == 5);
+  REQUIRE(v.z() == 6);
+  REQUIRE(v.w() == 7);
+
+  /* a vec of 3 reads only 3 elements at 3 times the offset */
+  vec<float, 3> v3;
+  v3.load(3, private_ptr<const float> { data.data() });
+  REQUIRE(v3.x() == 9);
+  REQUIRE(v3.y() == 10);
+  REQUIRE(v3.z() == 11);
+
+  v.store(2, local_ptr<float> { data.data() });
+  REQUIRE(data[8] == 4);
+  REQUIRE(data[11] == 7);
+
+  v3.store(0, global_ptr<float> { data.data() });
+  REQUIRE(data[0] == 9);
+  REQUIRE(data[2] == 11);
+  REQUIRE(data[3] == 3);
+}
+
+TEST_CASE("load and store through an accessor", "[vector]") {
+  buffer<int> b { 8 };
+  {
+    auto a = b.get_access<access::mode::read_write>();
+    vec<int, 4> { 1, 2, 3, 4 }.store(1, a);
+    vec<int, 4> v;
+    v.load(1, a);
+    REQUIRE(v == vec<int, 4> { 1, 2, 3, 4 });
+  }
+}
+
+TEST_CASE("non-temporal store", "[vector]") {
+  alignas(64) float out[32] = {};
+  for (std::size_t i = 0; i != 8; ++i)
+    vendor::trisycl::store_nontemporal(vec<float, 4> { 1, 2, 3, float(i) },
+                                       i, global_ptr<float> { out });
+  /* unaligned, with a normal store instead */
+  vendor::trisycl::store_nontemporal(vec<float, 8> { 7 }, 1,
+                                     global_ptr<float> { out + 1 });
+  vendor::trisycl::nontemporal_fence();
+  REQUIRE(out[0] == 1);
+  REQUIRE(out[4*5 + 3] == 5);
+  REQUIRE(out[8] == 1);
+  REQUIRE(out[9] == 7);
+  REQUIRE(out[16] == 7);
+  REQUIRE(out[17] == 2);
+}
@@ -4,7 +4,9 @@
 */
 #include <CL/sycl.hpp>
 
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -32,3 +34,59 @@ TEST_CASE("array access", "[vector]") {
   REQUIRE(v2[6] == -2);
   REQUIRE(v2[7] == -4);
 }
+
+TEST_CASE("conversion rounding modes", "[vector]") {
+  vec<float, 8> v = { -2.5f, -1.5f, -0.5f, 0.5f, 1.5f, 2.5f, 2.7f, -2.7f };
+
+  auto rte = v.convert<int, rounding_mode::rte>();
+  REQUIRE(rte == vec<int, 8> { -2, -2, 0, 0, 2, 2, 3, -3 });
+  auto rtz = v.convert<int, rounding_mode::rtz>();
+  REQUIRE(rtz == vec<int, 8> { -2, -1, 0, 0, 1, 2, 2, -2 });
+  auto rtp = v.convert<int, rounding_mode::rtp>();
+  REQUIRE(rtp == vec<int, 8> { -2, -1, 0, 1, 2, 3, 3, -2 });
+  auto rtn = v.convert<int, rounding_mode::rtn>();
+  REQUIRE(rtn == vec<int, 8> { -3, -2, -1, 0, 1, 2, 2, -3 });
+
+  /* a float is rounded to the nearest even by default */
+  vec<double, 4> d = { 1 + 0x1p-30, -1 - 0x1p-30, 0x1p-200, 1e300 };
+  auto f = d.convert<float>();
+  REQUIRE(f == vec<float, 4> { 1, -1, 0, INFINITY });
+  f = d.convert<float, rounding_mode::rtp>();
+  REQUIRE(f.x() == 1 + 0x1p-23f);
+  REQUIRE(f.y() == -1);
+  REQUIRE(f.z() == 0x1p-149f);
+  REQUIRE(f.w() == INFINITY);
+  f = d.convert<float, rounding_mode::rtz>();
+  REQUIRE(f.y() == -1);
+  REQUIRE(f.w() == std::numeric_limits<float>::max());
+
+  /* to half */
+  auto h = vec<float, 4> { 1, 1 + 0x1p-11f, 65520, 1e-8f }.convert<half>();
+  REQUIRE(h.x() == 1);
+  REQUIRE(h.y() == 1);
+  REQUIRE(h.z() == INFINITY);
+  REQUIRE(h.w() == 0);
+  h = vec<float, 4> { 1, 1 + 0x1p-11f, 65520, 1e-8f }
+    .convert<half, rounding_mode::rtp>();
+  REQUIRE(h.y() == 1 + 0x1p-10f);
+  REQUIRE(h.z() == INFINITY);
+  REQUIRE(h.w() == 0x1p-24f);
+}
+
+TEST_CASE("saturating conversions", "[vector]") {
+  vec<float, 4> v = { 1e10f, -1e10f, NAN, 126.6f };
+  REQUIRE(v.convert_sat<int>() == vec<int, 4> { 2147483647, -2147483647 - 1,
+                                                0, 126 });
+  REQUIRE(v.convert_sat<signed char, rounding_mode::rte>()
+          == vec<signed char, 4> { 127, -128, 0, 127 });
+  REQUIRE(v.convert_sat<unsigned short>()
+          == vec<unsigned short, 4> { 65535, 0, 0, 126 });
+
+  vec<int, 4> i = { 300, -300, -1, 255 };
+  REQUIRE(i.convert_sat<unsigned char>()
+          == vec<unsigned char, 4> { 255, 0, 0, 255 });
+  REQUIRE(i.convert_sat<short>() == vec<short, 4> { 300, -300, -1, 255 });
+  vec<unsigned int, 4> u = { 0xffffffff, 1, 0x80000000, 0x7fffffff };
+  REQUIRE(u.convert_sat<int>() == vec<int, 4> { 0x7fffffff, 1, 0x7fffffff,
+                                                 0x7fffffff });
+}
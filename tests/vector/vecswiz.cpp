@@ -55,3 +55,46 @@ TEST_CASE("swizzles", "[vector]") {
   REQUIRE(v2.z() == 6);
   REQUIRE(v2.w() == 4);
 }
+
+TEST_CASE("swizzle assignment", "[vector]") {
+  vec<int, 4> v = { 1, 2, 3, 4 };
+
+  /* the selected elements are written in place */
+  v.wzyx() = vec<int, 4> { 5, 6, 7, 8 };
+  REQUIRE(v.x() == 8);
+  REQUIRE(v.y() == 7);
+  REQUIRE(v.z() == 6);
+  REQUIRE(v.w() == 5);
+
+  v.lo() = v.hi();
+  REQUIRE(v.x() == 6);
+  REQUIRE(v.y() == 5);
+
+  v.odd() = 0;
+  REQUIRE(v.y() == 0);
+  REQUIRE(v.w() == 0);
+
+  v.even() += vec<int, 2> { 10, 20 };
+  REQUIRE(v.x() == 16);
+  REQUIRE(v.z() == 26);
+
+  /* a swizzle reads as a vec */
+  vec<int, 3> v3 = v.xyz() + 1;
+  REQUIRE(v3.x() == 17);
+  REQUIRE(v3.y() == 1);
+  REQUIRE(v3.z() == 27);
+
+  vec<float, 3> f = { 1, 2, 3 };
+  f.zxy() = vec<float, 3> { 4, 5, 6 };
+  REQUIRE(f.x() == 5);
+  REQUIRE(f.y() == 6);
+  REQUIRE(f.z() == 4);
+
+  /* on a const vec, a swizzle is a copy */
+  const vec<float, 8> c = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  vec<float, 4> e = c.even();
+  REQUIRE(e.x() == 0);
+  REQUIRE(e.y() == 2);
+  REQUIRE(e.z() == 4);
+  REQUIRE(e.w() == 6);
+}
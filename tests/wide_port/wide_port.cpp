@@ -0,0 +1,60 @@
+/* RUN: %{execute}%s
+
+   Copy some data through 512-bit wide memory ports, by words and by
+   bursts
+*/
+#include <CL/sycl.hpp>
+
+#include <numeric>
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace cl::sycl;
+
+// Not a multiple of the 16 int of a word, to test the partial word
+constexpr int N = 1000;
+
+using Type = int;
+
+TEST_CASE("wide memory ports", "[FPGA]") {
+  buffer<Type> in { N };
+  buffer<Type> by_word { N };
+  buffer<Type> by_burst { N };
+  {
+    auto a = in.get_access<access::mode::discard_write>();
+    std::iota(a.begin(), a.end(), 0);
+  }
+
+  queue {}.submit([&] (handler &cgh) {
+      auto a_in = in.get_access<access::mode::read>(cgh);
+      auto a_word = by_word.get_access<access::mode::discard_write>(cgh);
+      auto a_burst = by_burst.get_access<access::mode::discard_write>(cgh);
+      cgh.single_task<class wide_copy>([=] {
+          vendor::xilinx::wide_port<const Type> p_in { a_in };
+          vendor::xilinx::wide_port p_word { a_word };
+          vendor::xilinx::wide_port p_burst { a_burst };
+          static_assert(decltype(p_word)::word_size == 16);
+          static_assert(sizeof(decltype(p_word)::word_type) == 64);
+          static_assert(alignof(decltype(p_word)::word_type) == 64);
+          for (std::size_t w = 0; w != p_in.size(); ++w) {
+            auto word = p_in.read(w);
+            for (std::size_t i = 0; i != word.size; ++i)
+              word[i] *= 2;
+            p_word.write(w, word);
+          }
+          Type local[128];
+          for (std::size_t first = 0; first < N; first += 128) {
+            auto n = std::min<std::size_t>(128, N - first);
+            p_in.burst_read(first, n, local);
+            p_burst.burst_write(first, n, local);
+          }
+        });
+    });
+
+  auto a_word = by_word.get_access<access::mode::read>();
+  auto a_burst = by_burst.get_access<access::mode::read>();
+  for (int i = 0; i != N; ++i) {
+    REQUIRE(a_word[i] == 2*i);
+    REQUIRE(a_burst[i] == i);
+  }
+}